@@ -288,6 +288,7 @@ def envoy_dependencies(path = "@envoy_deps//", skip_targets = []):
     _com_github_tencent_rapidjson()
     _com_google_googletest()
     _com_google_protobuf()
+    _com_googlesource_code_re2()
 
     # Used for bundling gcovr into a relocatable .par file.
     _repository_impl("subpar")
@@ -575,6 +576,14 @@ def _com_github_google_jwt_verify():
         actual = "@com_github_google_jwt_verify//:jwt_verify_lib",
     )
 
+def _com_googlesource_code_re2():
+    _repository_impl("com_googlesource_code_re2")
+
+    native.bind(
+        name = "re2",
+        actual = "@com_googlesource_code_re2//:re2",
+    )
+
 def _apply_dep_blacklist(ctxt, recipes):
     newlist = []
     skip_list = dict()
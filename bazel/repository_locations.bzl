@@ -160,6 +160,11 @@ REPOSITORY_LOCATIONS = dict(
         # - https://github.com/google/protobuf/commit/fa252ec2a54acb24ddc87d48fed1ecfd458445fd
         urls = ["https://github.com/protocolbuffers/protobuf/archive/fa252ec2a54acb24ddc87d48fed1ecfd458445fd.tar.gz"],
     ),
+    com_googlesource_code_re2 = dict(
+        sha256 = "38bc0426ee15b5ed67957017fd18201965df0721327be13f60496f2b356e3e01",
+        strip_prefix = "re2-2019-08-01",
+        urls = ["https://github.com/google/re2/archive/2019-08-01.tar.gz"],
+    ),
     grpc_httpjson_transcoding = dict(
         sha256 = "9765764644d74af9a9654f7fb90cf2bc7228014664668719a589a4677967ca09",
         strip_prefix = "grpc-httpjson-transcoding-05a15e4ecd0244a981fdf0348a76658def62fa9c",
@@ -123,6 +123,16 @@ public:
    * @see man 2 socket
    */
   virtual SysCallIntResult socket(int domain, int type, int protocol) PURE;
+
+  /**
+   * @see man 2 accept4. The accepted socket is non-blocking and close-on-exec.
+   */
+  virtual SysCallIntResult accept(int sockfd, sockaddr* addr, socklen_t* addrlen) PURE;
+
+  /**
+   * @see man 2 listen
+   */
+  virtual SysCallIntResult listen(int sockfd, int backlog) PURE;
 };
 
 typedef std::unique_ptr<OsSysCalls> OsSysCallsPtr;
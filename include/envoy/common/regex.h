@@ -0,0 +1,37 @@
+#pragma once
+
+#include <memory>
+
+#include "envoy/common/pure.h"
+
+#include "absl/strings/string_view.h"
+
+namespace Envoy {
+namespace Regex {
+
+/**
+ * A compiled regular expression. Implementations are immutable once compiled and are safe to use
+ * concurrently from multiple threads.
+ */
+class CompiledMatcher {
+public:
+  virtual ~CompiledMatcher() {}
+
+  /**
+   * @param value supplies the value to match.
+   * @return bool true if the entire value matches the regular expression.
+   */
+  virtual bool match(absl::string_view value) const PURE;
+
+  /**
+   * @param value supplies the value to search.
+   * @return bool true if any substring of value matches the regular expression.
+   */
+  virtual bool search(absl::string_view value) const PURE;
+};
+
+typedef std::unique_ptr<const CompiledMatcher> CompiledMatcherPtr;
+typedef std::shared_ptr<const CompiledMatcher> CompiledMatcherSharedPtr;
+
+} // namespace Regex
+} // namespace Envoy
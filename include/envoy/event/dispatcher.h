@@ -8,6 +8,7 @@
 
 #include "envoy/common/time.h"
 #include "envoy/event/file_event.h"
+#include "envoy/event/io_uring.h"
 #include "envoy/event/signal.h"
 #include "envoy/event/timer.h"
 #include "envoy/filesystem/filesystem.h"
@@ -17,10 +18,34 @@
 #include "envoy/network/listen_socket.h"
 #include "envoy/network/listener.h"
 #include "envoy/network/transport_socket.h"
+#include "envoy/stats/scope.h"
+#include "envoy/stats/stats_macros.h"
 
 namespace Envoy {
 namespace Event {
 
+/**
+ * All dispatcher stats. @see stats_macros.h
+ */
+// clang-format off
+#define ALL_DISPATCHER_STATS(COUNTER, HISTOGRAM)                                                   \
+  COUNTER  (file_event_time_us)                                                                    \
+  COUNTER  (post_time_us)                                                                          \
+  COUNTER  (timer_time_us)                                                                         \
+  HISTOGRAM(loop_duration_us)                                                                      \
+  HISTOGRAM(loop_events)                                                                           \
+  HISTOGRAM(post_queue_depth)                                                                      \
+  HISTOGRAM(post_wait_us)                                                                          \
+  HISTOGRAM(timer_lag_us)
+// clang-format on
+
+/**
+ * Struct definition for all dispatcher stats. @see stats_macros.h
+ */
+struct DispatcherStats {
+  ALL_DISPATCHER_STATS(GENERATE_COUNTER_STRUCT, GENERATE_HISTOGRAM_STRUCT)
+};
+
 /**
  * Callback invoked when a dispatcher post() runs.
  */
@@ -43,6 +68,15 @@ public:
    */
   virtual void clearDeferredDeleteList() PURE;
 
+  /**
+   * Start recording how busy the event loop is: how long each iteration takes and how many events
+   * it handles, the time spent in each type of event, how long posted callbacks wait and how late
+   * timers fire. This must be called before the dispatcher runs or is posted to from other threads.
+   * @param scope supplies the scope to create the stats in.
+   * @param prefix supplies the prefix of the stats, to which "dispatcher." is appended.
+   */
+  virtual void initializeStats(Stats::Scope& scope, const std::string& prefix) PURE;
+
   /**
    * Create a server connection.
    * @param socket supplies an open file descriptor and connection metadata to use for the
@@ -69,6 +103,18 @@ public:
                          Network::TransportSocketPtr&& transport_socket,
                          const Network::ConnectionSocket::OptionsSharedPtr& options) PURE;
 
+  /**
+   * Create a client connection on a socket which is already connected, e.g. one released by a
+   * client connection on another dispatcher. The connection raises a connected event once it is
+   * connected, as if connect() had completed.
+   * @param socket supplies the connected socket. Takes ownership of the socket.
+   * @param transport_socket supplies a transport socket to be used by the connection.
+   * @return Network::ClientConnectionPtr a client connection that is owned by the caller.
+   */
+  virtual Network::ClientConnectionPtr
+  adoptClientConnection(Network::ConnectionSocketPtr&& socket,
+                        Network::TransportSocketPtr&& transport_socket) PURE;
+
   /**
    * Create an async DNS resolver. The resolver should only be used on the thread that runs this
    * dispatcher.
@@ -103,11 +149,14 @@ public:
    * @param bind_to_port controls whether the listener binds to a transport port or not.
    * @param hand_off_restored_destination_connections controls whether the listener searches for
    *        another listener after restoring the destination address of a new connection.
+   * @param max_accepts_per_wakeup supplies the maximum number of connections to accept each time
+   *        the socket becomes readable, or 0 to accept every pending connection.
    * @return Network::ListenerPtr a new listener that is owned by the caller.
    */
   virtual Network::ListenerPtr createListener(Network::Socket& socket,
                                               Network::ListenerCallbacks& cb, bool bind_to_port,
-                                              bool hand_off_restored_destination_connections) PURE;
+                                              bool hand_off_restored_destination_connections,
+                                              uint32_t max_accepts_per_wakeup) PURE;
 
   /**
    * Allocate a timer. @see Timer for docs on how to use the timer.
@@ -115,6 +164,13 @@ public:
    */
   virtual Event::TimerPtr createTimer(TimerCb cb) PURE;
 
+  /**
+   * Allocate a timer with the given resolution. @see Timer for docs on how to use the timer.
+   * @param cb supplies the callback to invoke when the timer fires.
+   * @param resolution supplies how precisely the timer must fire.
+   */
+  virtual Event::TimerPtr createTimer(TimerCb cb, TimerResolution resolution) PURE;
+
   /**
    * Submit an item for deferred delete. @see DeferredDeletable.
    */
@@ -156,6 +212,12 @@ public:
    * @return the watermark buffer factory for this dispatcher.
    */
   virtual Buffer::WatermarkFactory& getWatermarkFactory() PURE;
+
+  /**
+   * @return IoUring* the io_uring through which sockets may be read and written on this
+   *         dispatcher's thread, or nullptr if the dispatcher only has readiness notifications.
+   */
+  virtual IoUring* ioUring() PURE;
 };
 
 typedef std::unique_ptr<Dispatcher> DispatcherPtr;
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <sys/socket.h>
+
+#include <cstdint>
+#include <memory>
+
+#include "envoy/common/pure.h"
+
+namespace Envoy {
+namespace Event {
+
+/**
+ * An operation submitted to an io_uring, which is told the result once the kernel completes it.
+ */
+class IoUringRequest {
+public:
+  virtual ~IoUringRequest() {}
+
+  /**
+   * Called on the dispatcher's thread when the operation completes. The request is destroyed once
+   * this returns.
+   * @param result supplies the result of the operation: what the equivalent system call would
+   *        return on success, or the negated errno on failure.
+   */
+  virtual void onCompletion(int32_t result) PURE;
+};
+
+typedef std::unique_ptr<IoUringRequest> IoUringRequestPtr;
+
+/**
+ * A dispatcher's io_uring, through which sockets are read and written by submitting operations
+ * and being told when they complete, rather than by being told when the socket is ready.
+ *
+ * Operations queued while the dispatcher handles events are submitted to the kernel together, with
+ * a single system call. The ring owns each request, and the memory the operation reads from or
+ * writes to must stay valid, until the request's onCompletion() has been called.
+ */
+class IoUring {
+public:
+  virtual ~IoUring() {}
+
+  /**
+   * Receive from a socket. The operation completes once there is something to receive, unlike
+   * recv() on a non-blocking socket.
+   * @param fd supplies the socket.
+   * @param buffer supplies the memory to receive into.
+   * @param length supplies the size of buffer.
+   * @param request supplies the request to complete.
+   * @return IoUringRequest& the request, which may be passed to cancel().
+   */
+  virtual IoUringRequest& recv(int fd, void* buffer, uint32_t length,
+                               IoUringRequestPtr&& request) PURE;
+
+  /**
+   * Send on a socket, gathering the data like sendmsg().
+   * @param fd supplies the socket.
+   * @param message supplies the message to send.
+   * @param request supplies the request to complete.
+   * @return IoUringRequest& the request, which may be passed to cancel().
+   */
+  virtual IoUringRequest& sendmsg(int fd, const msghdr& message, IoUringRequestPtr&& request) PURE;
+
+  /**
+   * Cancel a request which has not completed yet. The request still completes, with -ECANCELED if
+   * the operation had not started.
+   * @param request supplies the request to cancel.
+   */
+  virtual void cancel(IoUringRequest& request) PURE;
+
+  /**
+   * Hand the queued operations to the kernel now, rather than once the dispatcher gets to the
+   * ring. The kernel looks fds up when it is handed an operation, so this must be done before
+   * closing an fd which queued operations refer to.
+   */
+  virtual void submit() PURE;
+};
+
+} // namespace Event
+} // namespace Envoy
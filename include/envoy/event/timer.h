@@ -18,6 +18,22 @@ namespace Event {
  */
 typedef std::function<void()> TimerCb;
 
+/**
+ * How precisely a timer fires.
+ */
+enum class TimerResolution {
+  // The timer fires as soon as the event loop finds it has expired.
+  Precise,
+  // The timer may fire up to CoarseTimerResolution after it expires. Coarse timers are much cheaper
+  // to enable and disable, which suits timeouts that are usually disabled before they fire.
+  Coarse
+};
+
+/**
+ * The slack allowed to coarse timers.
+ */
+constexpr std::chrono::milliseconds CoarseTimerResolution{10};
+
 /**
  * An abstract timer event. Free the timer to unregister any pending timeouts.
  */
@@ -225,6 +225,18 @@ struct Http2Settings {
   bool allow_connect_{DEFAULT_ALLOW_CONNECT};
   bool allow_metadata_{DEFAULT_ALLOW_METADATA};
 
+  // How an upstream connection pool picks the connection for a new stream.
+  enum class ConnectionSelection {
+    // The connection with the fewest active streams.
+    LeastActiveStreams,
+    // The connection with the most connection-level flow-control window left to send into.
+    MostSendWindow,
+  };
+
+  // The number of connections an upstream connection pool keeps open to each host.
+  uint32_t connections_per_host_{DEFAULT_CONNECTIONS_PER_HOST};
+  ConnectionSelection connection_selection_{ConnectionSelection::LeastActiveStreams};
+
   // disable HPACK compression
   static const uint32_t MIN_HPACK_TABLE_SIZE = 0;
   // initial value from HTTP/2 spec, same as NGHTTP2_DEFAULT_HEADER_TABLE_SIZE from nghttp2
@@ -261,6 +273,8 @@ struct Http2Settings {
   static const bool DEFAULT_ALLOW_CONNECT = false;
   // By default Envoy does not allow METADATA support.
   static const bool DEFAULT_ALLOW_METADATA = false;
+  // By default all streams to a host share one connection.
+  static const uint32_t DEFAULT_CONNECTIONS_PER_HOST = 1;
 };
 
 /**
@@ -362,6 +376,13 @@ public:
    * @return StreamEncoder& supplies the encoder to write the request into.
    */
   virtual StreamEncoder& newStream(StreamDecoder& response_decoder) PURE;
+
+  /**
+   * @return uint64_t the number of bytes the connection can send before the peer has to grant it
+   *         more connection-level flow-control window. This is the maximum value for protocols
+   *         without connection-level flow control.
+   */
+  virtual uint64_t sendWindow() PURE;
 };
 
 typedef std::unique_ptr<ClientConnection> ClientConnectionPtr;
@@ -95,6 +95,15 @@ public:
    */
   virtual void drainConnections() PURE;
 
+  /**
+   * Open connections ahead of the streams that will use them, for example to a host which has not
+   * received any traffic yet. Connections are not opened beyond the cluster's connection circuit
+   * breaker, nor while the pool is draining.
+   * @param connections supplies the number of connections the pool should have, counting those
+   *                    it already has.
+   */
+  virtual void preconnect(uint32_t connections) PURE;
+
   /**
    * Create a new stream on the pool.
    * @param response_decoder supplies the decoder events to fire when the response is
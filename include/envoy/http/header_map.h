@@ -51,6 +51,32 @@ struct LowerCaseStringHash {
  */
 typedef std::unordered_set<LowerCaseString, LowerCaseStringHash> LowerCaseStrUnorderedSet;
 
+/**
+ * A header name whose hash and ID have been worked out ahead of time, typically when configuration
+ * is loaded, so that looking it up in a header map compares integers rather than strings. These
+ * are created by Http::HeaderNameRegistry, which gives each distinct name the same ID for the life
+ * of the process. Names which the registry did not keep have ID 0, and are compared by name.
+ */
+class InternedHeaderName {
+public:
+  InternedHeaderName(const LowerCaseString& name, uint64_t hash, uint32_t id)
+      : name_(name), hash_(hash), id_(id) {}
+
+  const LowerCaseString& name() const { return name_; }
+  uint64_t hash() const { return hash_; }
+  uint32_t id() const { return id_; }
+
+  bool operator==(const InternedHeaderName& rhs) const {
+    return id_ == rhs.id_ && (id_ != 0 || name_ == rhs.name_);
+  }
+  bool operator!=(const InternedHeaderName& rhs) const { return !(*this == rhs); }
+
+private:
+  LowerCaseString name_;
+  uint64_t hash_;
+  uint32_t id_;
+};
+
 /**
  * This is a string implementation for use in header processing. It is heavily optimized for
  * performance. It supports 3 different types of storage and can switch between them:
@@ -365,6 +391,13 @@ public:
    */
   virtual void addReferenceKey(const LowerCaseString& key, const std::string& value) PURE;
 
+  /**
+   * Add a header with a reference key to the map, as addReferenceKey() above.
+   * @param key specifies the name of the header to add; it WILL NOT be copied.
+   * @param value specifies the value of the header to add; it WILL be copied.
+   */
+  virtual void addReferenceKey(const InternedHeaderName& key, const std::string& value) PURE;
+
   /**
    * Add a header by copying both the header key and the value.
    *
@@ -415,6 +448,13 @@ public:
    */
   virtual void setReferenceKey(const LowerCaseString& key, const std::string& value) PURE;
 
+  /**
+   * Set a header with a reference key in the map, as setReferenceKey() above.
+   * @param key specifies the name of the header to set; it WILL NOT be copied.
+   * @param value specifies the value of the header to set; it WILL be copied.
+   */
+  virtual void setReferenceKey(const InternedHeaderName& key, const std::string& value) PURE;
+
   /**
    * @return uint64_t the approximate size of the header map in bytes.
    */
@@ -428,6 +468,14 @@ public:
   virtual const HeaderEntry* get(const LowerCaseString& key) const PURE;
   virtual HeaderEntry* get(const LowerCaseString& key) PURE;
 
+  /**
+   * Get a header by interned key, which is faster than by LowerCaseString.
+   * @param key supplies the header key.
+   * @return the header entry if it exists otherwise nullptr.
+   */
+  virtual const HeaderEntry* get(const InternedHeaderName& key) const PURE;
+  virtual HeaderEntry* get(const InternedHeaderName& key) PURE;
+
   // aliases to make iterate() and iterateReverse() callbacks easier to read
   enum class Iterate { Continue, Break };
 
@@ -471,6 +519,12 @@ public:
    */
   virtual void remove(const LowerCaseString& key) PURE;
 
+  /**
+   * Remove all instances of a header by interned key.
+   * @param key supplies the header key to remove.
+   */
+  virtual void remove(const InternedHeaderName& key) PURE;
+
   /**
    * Remove all instances of headers where the key begins with the supplied prefix.
    * @param prefix supplies the prefix to match header keys against.
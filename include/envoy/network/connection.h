@@ -291,6 +291,16 @@ public:
    * registered via addConnectionCallbacks().
    */
   virtual void connect() PURE;
+
+  /**
+   * Hand the connected socket over to the caller, e.g. to continue the connection on another
+   * dispatcher, and close this connection without closing the socket. The connection must be open
+   * and idle, with nothing left to write, and must not keep transport state such as a TLS session.
+   * The close is reported as a local close via the event callback.
+   * @return ConnectionSocketPtr the socket, or nullptr if it could not be handed over, in which
+   *         case the connection is closed anyway.
+   */
+  virtual ConnectionSocketPtr releaseSocket() PURE;
 };
 
 typedef std::unique_ptr<ClientConnection> ClientConnectionPtr;
@@ -5,6 +5,7 @@
 #include <string>
 
 #include "envoy/common/exception.h"
+#include "envoy/common/token_bucket.h"
 #include "envoy/network/connection.h"
 #include "envoy/network/listen_socket.h"
 #include "envoy/stats/scope.h"
@@ -37,6 +38,13 @@ public:
    */
   virtual Socket& socket() PURE;
 
+  /**
+   * @param worker_index supplies the index of a worker.
+   * @return Socket& the listen socket the worker should accept connections from. This is socket()
+   *         unless the listener has a socket per worker.
+   */
+  virtual Socket& workerSocket(uint32_t worker_index) PURE;
+
   /**
    * @return bool specifies whether the listener should actually listen on the port.
    *         A listener that doesn't listen on a port can only receive connections
@@ -58,6 +66,18 @@ public:
    */
   virtual uint32_t perConnectionBufferLimitBytes() PURE;
 
+  /**
+   * @return uint32_t the maximum number of connections to accept each time the listen socket
+   *         becomes readable, or 0 to accept every pending connection.
+   */
+  virtual uint32_t maxAcceptsPerWakeup() const PURE;
+
+  /**
+   * @return TokenBucket* the limiter that each accepted connection must take a token from, or
+   *         nullptr if the rate of new connections is not limited. It is shared by all workers.
+   */
+  virtual TokenBucket* connectionRateLimiter() PURE;
+
   /**
    * @return Stats::Scope& the stats scope to use for all listener specific stats.
    */
@@ -2,6 +2,7 @@
 
 #include "envoy/buffer/buffer.h"
 #include "envoy/common/pure.h"
+#include "envoy/event/io_uring.h"
 #include "envoy/ssl/connection.h"
 
 namespace Envoy {
@@ -67,6 +68,18 @@ public:
    */
   virtual void setReadBufferReady() PURE;
 
+  /**
+   * Mark write buffer ready to write in the event loop. This is used by a transport socket whose
+   * writes complete after doWrite() returns, to write the rest of the buffer once they have.
+   */
+  virtual void setWriteBufferReady() PURE;
+
+  /**
+   * @return Event::IoUring* the io_uring which the transport socket may read and write through,
+   *         or nullptr if it must read and write the fd itself.
+   */
+  virtual Event::IoUring* ioUring() PURE;
+
   /**
    * Raise a connection event to the connection. This can be used by a secure socket (e.g. TLS)
    * to raise a connected event when handshake is done.
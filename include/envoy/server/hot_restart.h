@@ -41,9 +41,11 @@ public:
    * Retrieve a listening socket on the specified address from the parent process. The socket will
    * be duplicated across process boundaries.
    * @param address supplies the address of the socket to duplicate, e.g. tcp://127.0.0.1:5000.
-   * @return int the fd or -1 if there is no bound listen port in the parent.
+   * @param worker_index supplies the index of the worker whose socket to duplicate, for listeners
+   *        with a socket per worker. For other listeners, only index 0 has a socket.
+   * @return int the fd or -1 if there is no bound listen port for the worker in the parent.
    */
-  virtual int duplicateParentListenSocket(const std::string& address) PURE;
+  virtual int duplicateParentListenSocket(const std::string& address, uint32_t worker_index) PURE;
 
   /**
    * Retrieve stats from our parent process.
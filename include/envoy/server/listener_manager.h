@@ -46,11 +46,25 @@ public:
    * @param address supplies the socket's address.
    * @param options to be set on the created socket just before calling 'bind()'.
    * @param bind_to_port supplies whether to actually bind the socket.
+   * @param worker_index supplies the index of the worker the socket is for. This is 0 unless the
+   *        listener has a socket per worker.
    * @return Network::SocketSharedPtr an initialized and potentially bound socket.
    */
   virtual Network::SocketSharedPtr
   createListenSocket(Network::Address::InstanceConstSharedPtr address,
-                     const Network::Socket::OptionsSharedPtr& options, bool bind_to_port) PURE;
+                     const Network::Socket::OptionsSharedPtr& options, bool bind_to_port,
+                     uint32_t worker_index) PURE;
+
+  /**
+   * Check whether the parent process has a listen socket for a worker. This is used to find out
+   * whether a parent with more workers has listen sockets that no worker of this process would
+   * accept connections from.
+   * @param address supplies the socket's address.
+   * @param worker_index supplies the index of the worker the socket is for.
+   * @return bool true if the parent has a listen socket for the worker.
+   */
+  virtual bool hasParentListenSocket(Network::Address::InstanceConstSharedPtr address,
+                                     uint32_t worker_index) PURE;
 
   /**
    * Creates a list of filter factories.
@@ -176,6 +176,30 @@ public:
    * @return bool indicating whether mutex tracing functionality has been enabled.
    */
   virtual bool mutexTracingEnabled() const PURE;
+
+  /**
+   * @return bool indicating whether buffers use the libevent evbuffer implementation instead of
+   *         the native slice implementation.
+   */
+  virtual bool libeventBuffersEnabled() const PURE;
+
+  /**
+   * @return bool indicating whether header maps keep their entries in a std::list instead of in
+   *         contiguous blocks.
+   */
+  virtual bool listHeaderMapsEnabled() const PURE;
+
+  /**
+   * @return bool indicating whether HTTP/1 connections are parsed with the SIMD parser instead of
+   *         http_parser.
+   */
+  virtual bool simdHttp1ParserEnabled() const PURE;
+
+  /**
+   * @return bool indicating whether sockets are read and written through io_uring, where the kernel
+   *         supports it, instead of when libevent reports them ready.
+   */
+  virtual bool ioUringEnabled() const PURE;
 };
 
 } // namespace Server
@@ -10,6 +10,7 @@
 
 #include "envoy/common/pure.h"
 #include "envoy/stats/stats.h"
+#include "envoy/stats/symbol_table.h"
 #include "envoy/stats/tag.h"
 
 #include "absl/strings/string_view.h"
@@ -52,6 +53,12 @@ public:
    */
   virtual bool requiresBoundedStatNameSize() const PURE;
 
+  /**
+   * @return SymbolTable& the symbol table in which the names of the stats made by this allocator
+   *     are encoded. Stores keying stats by StatName must encode names they look up in this table.
+   */
+  virtual SymbolTable& symbolTable() PURE;
+
   // TODO(jmarantz): create a parallel mechanism to instantiate histograms. At
   // the moment, histograms don't fit the same pattern of counters and gaugaes
   // as they are not actually created in the context of a stats allocator.
@@ -6,6 +6,7 @@
 #include <vector>
 
 #include "envoy/common/pure.h"
+#include "envoy/stats/symbol_table.h"
 
 #include "absl/strings/string_view.h"
 
@@ -25,24 +26,19 @@ public:
    * as streaming out the name to a stats sink or admin request, or comparing
    * against it in a test. Independent of the evolution of the data
    * representation for the name, this method will be available. For storing the
-   * name as a map key, however, nameCStr() is a better choice, albeit one that
-   * might change in the future to return a symbolized representation of the
-   * elaborated string.
+   * name as a map key, however, statName() is a better choice.
    */
   virtual std::string name() const PURE;
 
   /**
-   * Returns the full name of the Metric as a nul-terminated string. The
-   * intention is use this as a hash-map key, so that the stat name storage
-   * is not duplicated in every map. You cannot use name() above for this,
-   * as it returns a std::string by value, as not all stat implementations
-   * containe the name as a std::string.
-   *
-   * Note that in the future, the plan is to replace this method with one that
-   * returns a reference to a symbolized representation of the elaborated string
-   * (see source/common/stats/symbol_table_impl.h).
+   * Returns the full name of the Metric as a symbolized StatName (see
+   * source/common/stats/symbol_table_impl.h). The intention is to use this as a
+   * hash-map key, so that the stat name storage is not duplicated in every map.
+   * The returned StatName references storage owned by the Metric, and is valid
+   * for the Metric's lifetime. Metrics which are not held by a store, such as
+   * null stats, return an empty StatName.
    */
-  virtual const char* nameCStr() const PURE;
+  virtual StatName statName() const PURE;
 
   /**
    * Returns a vector of configurable tags to identify this Metric.
@@ -74,6 +74,14 @@ public:
    */
   virtual void setStatsMatcher(StatsMatcherPtr&& stats_matcher) PURE;
 
+  /**
+   * Choose how histograms created after this call record values.
+   * @param sharded true to count values in per-thread shards of fixed buckets, which avoids
+   *        locking and thread local lookups when recording, or false to record into thread local
+   *        circllhist histograms.
+   */
+  virtual void setShardedHistograms(bool sharded) PURE;
+
   /**
    * Initialize the store for threading. This will be called once after all worker threads have
    * been initialized. At this point the store can initialize itself for multi-threaded operation.
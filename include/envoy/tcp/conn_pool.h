@@ -191,6 +191,15 @@ public:
    */
   virtual void drainConnections() PURE;
 
+  /**
+   * Open connections ahead of the requests that will use them, for example to a host which has not
+   * received any traffic yet. Connections are not opened beyond the cluster's connection circuit
+   * breaker, nor while the pool is draining.
+   * @param connections supplies the number of connections the pool should have, counting those
+   *                    it already has.
+   */
+  virtual void preconnect(uint32_t connections) PURE;
+
   /**
    * Create a new connection on the pool.
    * @param cb supplies the callbacks to invoke when the connection is ready or has failed. The
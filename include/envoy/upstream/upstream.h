@@ -10,6 +10,7 @@
 
 #include "envoy/api/v2/core/base.pb.h"
 #include "envoy/common/callback.h"
+#include "envoy/common/time.h"
 #include "envoy/config/typed_metadata.h"
 #include "envoy/http/codec.h"
 #include "envoy/network/connection.h"
@@ -28,6 +29,45 @@
 namespace Envoy {
 namespace Upstream {
 
+/**
+ * Sockets of idle connections to a host which the connection pool of one worker parked so that
+ * the connection pool of any worker can take them. Until it is taken or closed, a parked socket
+ * counts as an active connection of the host and of its cluster, and against the cluster's
+ * connection circuit breaker. All methods are thread safe.
+ */
+class ParkedConnections {
+public:
+  virtual ~ParkedConnections() {}
+
+  /**
+   * Park the socket of an idle connection.
+   * @param socket supplies the connected socket. It is left with the caller if there is no room.
+   * @param priority supplies the priority of the connection pool which parks the socket, whose
+   *        connection circuit breaker counts it.
+   * @param now supplies the current time, from which the socket's idle timeout runs.
+   * @return bool whether the socket was parked.
+   */
+  virtual bool park(Network::ConnectionSocketPtr& socket, ResourcePriority priority,
+                    MonotonicTime now) PURE;
+
+  /**
+   * Take the socket which has been parked the longest. Sockets which reached their idle timeout
+   * are closed instead.
+   * @param other_worker is set to whether the socket was parked by another thread.
+   * @param now supplies the current time.
+   * @return Network::ConnectionSocketPtr the socket, or nullptr if there is none.
+   */
+  virtual Network::ConnectionSocketPtr take(bool& other_worker, MonotonicTime now) PURE;
+
+  /**
+   * Close the sockets which reached their idle timeout.
+   * @param now supplies the current time.
+   * @return absl::optional<std::chrono::milliseconds> the time until the next socket reaches its
+   *         idle timeout, or nullopt if no socket is parked.
+   */
+  virtual absl::optional<std::chrono::milliseconds> closeIdle(MonotonicTime now) PURE;
+};
+
 /**
  * An upstream host.
  */
@@ -83,6 +123,12 @@ public:
   virtual CreateConnectionData
   createHealthCheckConnection(Event::Dispatcher& dispatcher) const PURE;
 
+  /**
+   * @return ParkedConnections* the idle connections to this host which connection pools share
+   *         between workers, or nullptr if the cluster does not share idle connections.
+   */
+  virtual ParkedConnections* parkedConnections() const PURE;
+
   /**
    * @return host specific gauges.
    */
@@ -350,8 +396,14 @@ public:
   COUNTER  (upstream_cx_idle_timeout)                                                              \
   COUNTER  (upstream_cx_connect_attempts_exceeded)                                                 \
   COUNTER  (upstream_cx_overflow)                                                                  \
+  COUNTER  (upstream_cx_preconnect)                                                                \
+  COUNTER  (upstream_cx_idle_parked)                                                               \
+  GAUGE    (upstream_cx_parked_active)                                                             \
+  COUNTER  (upstream_cx_idle_taken)                                                                \
+  COUNTER  (upstream_cx_cross_worker_handoff)                                                      \
   HISTOGRAM(upstream_cx_connect_ms)                                                                \
   HISTOGRAM(upstream_cx_length_ms)                                                                 \
+  HISTOGRAM(upstream_cx_http2_active_streams)                                                      \
   COUNTER  (upstream_cx_destroy)                                                                   \
   COUNTER  (upstream_cx_destroy_local)                                                             \
   COUNTER  (upstream_cx_destroy_remote)                                                            \
@@ -632,6 +684,29 @@ public:
    */
   virtual bool drainConnectionsOnHostRemoval() const PURE;
 
+  /**
+   * @return float the number of connections connection pools keep open to their host for each
+   *         request they expect to be in flight. A ratio of 1 or less disables preconnecting.
+   */
+  virtual float perUpstreamPreconnectRatio() const PURE;
+
+  /**
+   * @return uint32_t the number of connections to start opening to each host as soon as it is
+   *         added to the cluster.
+   */
+  virtual uint32_t warmConnections() const PURE;
+
+  /**
+   * @return uint32_t the number of idle connections to each host which connection pools park for
+   *         any worker to take. 0 disables sharing idle connections between workers.
+   */
+  virtual uint32_t maxParkedConnectionsPerHost() const PURE;
+
+  /**
+   * @return std::chrono::milliseconds how long a parked connection is kept before it is closed.
+   */
+  virtual std::chrono::milliseconds parkedConnectionIdleTimeout() const PURE;
+
 protected:
   /**
    * Invoked by extensionProtocolOptionsTyped.
@@ -8,6 +8,7 @@
 #include "common/common/fmt.h"
 #include "common/common/utility.h"
 #include "common/config/metadata.h"
+#include "common/http/header_name_registry.h"
 #include "common/http/utility.h"
 #include "common/stream_info/utility.h"
 
@@ -372,12 +373,15 @@ std::string PlainStringFormatter::format(const Http::HeaderMap&, const Http::Hea
 HeaderFormatter::HeaderFormatter(const std::string& main_header,
                                  const std::string& alternative_header,
                                  absl::optional<size_t> max_length)
-    : main_header_(main_header), alternative_header_(alternative_header), max_length_(max_length) {}
+    : main_header_(Http::HeaderNameRegistry::intern(Http::LowerCaseString(main_header))),
+      alternative_header_(
+          Http::HeaderNameRegistry::intern(Http::LowerCaseString(alternative_header))),
+      max_length_(max_length) {}
 
 std::string HeaderFormatter::format(const Http::HeaderMap& headers) const {
   const Http::HeaderEntry* header = headers.get(main_header_);
 
-  if (!header && !alternative_header_.get().empty()) {
+  if (!header && !alternative_header_.name().get().empty()) {
     header = headers.get(alternative_header_);
   }
 
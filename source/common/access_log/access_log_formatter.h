@@ -7,6 +7,7 @@
 
 #include "envoy/access_log/access_log.h"
 #include "envoy/common/time.h"
+#include "envoy/http/header_map.h"
 #include "envoy/stream_info/stream_info.h"
 
 #include "common/common/utility.h"
@@ -142,8 +143,8 @@ public:
   std::string format(const Http::HeaderMap& headers) const;
 
 private:
-  Http::LowerCaseString main_header_;
-  Http::LowerCaseString alternative_header_;
+  const Http::InternedHeaderName main_header_;
+  const Http::InternedHeaderName alternative_header_;
   absl::optional<size_t> max_length_;
 };
 
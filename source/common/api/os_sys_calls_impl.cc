@@ -91,5 +91,30 @@ SysCallIntResult OsSysCallsImpl::socket(int domain, int type, int protocol) {
   return {rc, errno};
 }
 
+SysCallIntResult OsSysCallsImpl::accept(int sockfd, sockaddr* addr, socklen_t* addrlen) {
+#if defined(SOCK_NONBLOCK) && defined(SOCK_CLOEXEC)
+  const int rc = ::accept4(sockfd, addr, addrlen, SOCK_NONBLOCK | SOCK_CLOEXEC);
+  return {rc, errno};
+#else
+  // Without accept4(), the flags are set on the new socket separately.
+  const int rc = ::accept(sockfd, addr, addrlen);
+  if (rc == -1) {
+    return {rc, errno};
+  }
+  if (::fcntl(rc, F_SETFL, ::fcntl(rc, F_GETFL, 0) | O_NONBLOCK) == -1 ||
+      ::fcntl(rc, F_SETFD, FD_CLOEXEC) == -1) {
+    const int error = errno;
+    ::close(rc);
+    return {-1, error};
+  }
+  return {rc, 0};
+#endif
+}
+
+SysCallIntResult OsSysCallsImpl::listen(int sockfd, int backlog) {
+  const int rc = ::listen(sockfd, backlog);
+  return {rc, errno};
+}
+
 } // namespace Api
 } // namespace Envoy
@@ -29,6 +29,8 @@ public:
   SysCallIntResult getsockopt(int sockfd, int level, int optname, void* optval,
                               socklen_t* optlen) override;
   SysCallIntResult socket(int domain, int type, int protocol) override;
+  SysCallIntResult accept(int sockfd, sockaddr* addr, socklen_t* addrlen) override;
+  SysCallIntResult listen(int sockfd, int backlog) override;
 };
 
 typedef ThreadSafeSingleton<OsSysCallsImpl> OsSysCallsSingleton;
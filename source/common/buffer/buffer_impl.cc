@@ -1,6 +1,7 @@
 #include "common/buffer/buffer_impl.h"
 
 #include <cstdint>
+#include <cstring>
 #include <string>
 
 #include "common/api/os_sys_calls_impl.h"
@@ -13,26 +14,124 @@ namespace Envoy {
 namespace Buffer {
 
 // RawSlice is the same structure as evbuffer_iovec. This was put into place to avoid leaking
-// libevent into most code since we will likely replace evbuffer with our own implementation at
-// some point. However, we can avoid a bunch of copies since the structure is the same.
+// libevent into most code. The evbuffer implementation can avoid a bunch of copies since the
+// structure is the same.
 static_assert(sizeof(RawSlice) == sizeof(evbuffer_iovec), "RawSlice != evbuffer_iovec");
 static_assert(offsetof(RawSlice, mem_) == offsetof(evbuffer_iovec, iov_base),
               "RawSlice != evbuffer_iovec");
 static_assert(offsetof(RawSlice, len_) == offsetof(evbuffer_iovec, iov_len),
               "RawSlice != evbuffer_iovec");
 
-void OwnedImpl::add(const void* data, uint64_t size) { evbuffer_add(buffer_.get(), data, size); }
+bool OwnedImpl::use_old_impl_ = false;
+constexpr uint64_t OwnedImpl::CopyThreshold;
+constexpr uint64_t OwnedImpl::MaxWriteSlices;
 
-void OwnedImpl::addBufferFragment(BufferFragment& fragment) {
-  evbuffer_add_reference(
-      buffer_.get(), fragment.data(), fragment.size(),
-      [](const void*, size_t, void* arg) { static_cast<BufferFragment*>(arg)->done(); }, &fragment);
+uint64_t Slice::append(const void* data, uint64_t size) {
+  const uint64_t copy_size = std::min(size, reservableSize());
+  if (copy_size != 0) {
+    memcpy(base_ + reservable_, data, copy_size);
+    reservable_ += copy_size;
+  }
+  return copy_size;
+}
+
+uint64_t Slice::prepend(const void* data, uint64_t size) {
+  if (!writable_) {
+    return 0;
+  }
+  const uint8_t* src = static_cast<const uint8_t*>(data);
+  uint64_t copy_size;
+  if (dataSize() == 0) {
+    // There is nothing in the slice, so put the data at the very end in case the caller later
+    // prepends more data in front of it.
+    copy_size = std::min(size, capacity_);
+    reservable_ = capacity_;
+    data_ = capacity_ - copy_size;
+  } else {
+    copy_size = std::min(size, data_);
+    data_ -= copy_size;
+  }
+  if (copy_size != 0) {
+    memcpy(base_ + data_, src + size - copy_size, copy_size);
+  }
+  return copy_size;
+}
+
+void OwnedImpl::addImpl(const void* data, uint64_t size) {
+  const uint8_t* src = static_cast<const uint8_t*>(data);
+  bool new_slice_needed = slices_.empty();
+  while (size != 0) {
+    if (new_slice_needed) {
+      slices_.emplace_back(OwnedSlice::create(size));
+    }
+    const uint64_t copy_size = slices_.back()->append(src, size);
+    src += copy_size;
+    size -= copy_size;
+    length_ += copy_size;
+    new_slice_needed = true;
+  }
+}
+
+void OwnedImpl::drainImpl(uint64_t size) {
+  ASSERT(size <= length_);
+  while (size != 0) {
+    ASSERT(!slices_.empty());
+    const uint64_t slice_size = slices_.front()->dataSize();
+    if (slice_size <= size) {
+      slices_.pop_front();
+      length_ -= slice_size;
+      size -= slice_size;
+    } else {
+      slices_.front()->drain(size);
+      length_ -= size;
+      size = 0;
+    }
+  }
+  // Don't leave empty slices at the front, where they would have to be skipped by every reader.
+  // An empty slice at the back may hold a reservation and is kept for reuse.
+  while (slices_.size() > 1 && slices_.front()->dataSize() == 0) {
+    slices_.pop_front();
+  }
+}
+
+void OwnedImpl::moveSlice(OwnedImpl& other) {
+  SlicePtr& slice = other.slices_.front();
+  const uint64_t slice_size = slice->dataSize();
+  if (slice_size != 0) {
+    if (slice_size > CopyThreshold || slices_.empty() ||
+        slices_.back()->reservableSize() < slice_size) {
+      slices_.emplace_back(std::move(slice));
+    } else {
+      slices_.back()->append(slice->data(), slice_size);
+    }
+    length_ += slice_size;
+    other.length_ -= slice_size;
+  }
+  other.slices_.pop_front();
+}
+
+void OwnedImpl::add(const void* data, uint64_t size) {
+  if (old_impl_) {
+    evbuffer_add(buffer_.get(), data, size);
+  } else {
+    addImpl(data, size);
+  }
 }
 
-void OwnedImpl::add(const std::string& data) {
-  evbuffer_add(buffer_.get(), data.c_str(), data.size());
+void OwnedImpl::addBufferFragment(BufferFragment& fragment) {
+  if (old_impl_) {
+    evbuffer_add_reference(
+        buffer_.get(), fragment.data(), fragment.size(),
+        [](const void*, size_t, void* arg) { static_cast<BufferFragment*>(arg)->done(); },
+        &fragment);
+  } else {
+    length_ += fragment.size();
+    slices_.emplace_back(std::make_unique<UnownedSlice>(fragment));
+  }
 }
 
+void OwnedImpl::add(const std::string& data) { add(data.data(), data.size()); }
+
 void OwnedImpl::add(const Instance& data) {
   uint64_t num_slices = data.getRawSlices(nullptr, 0);
   STACK_ARRAY(slices, RawSlice, num_slices);
@@ -43,68 +142,212 @@ void OwnedImpl::add(const Instance& data) {
 }
 
 void OwnedImpl::prepend(absl::string_view data) {
-  evbuffer_prepend(buffer_.get(), data.data(), data.size());
+  if (old_impl_) {
+    evbuffer_prepend(buffer_.get(), data.data(), data.size());
+    return;
+  }
+
+  uint64_t size = data.size();
+  bool new_slice_needed = slices_.empty();
+  while (size != 0) {
+    if (new_slice_needed) {
+      slices_.emplace_front(OwnedSlice::create(size));
+    }
+    // Slice::prepend() copies the trailing bytes that fit, so the remainder is always a prefix.
+    const uint64_t copy_size = slices_.front()->prepend(data.data(), size);
+    size -= copy_size;
+    length_ += copy_size;
+    new_slice_needed = true;
+  }
 }
 
 void OwnedImpl::prepend(Instance& data) {
-  int rc =
-      evbuffer_prepend_buffer(buffer_.get(), static_cast<LibEventInstance&>(data).buffer().get());
-  ASSERT(rc == 0);
+  ASSERT(&data != this);
+  // See move() below for why we do the static cast.
+  OwnedImpl& other = static_cast<OwnedImpl&>(data);
+  ASSERT(other.old_impl_ == old_impl_);
+  if (old_impl_) {
+    int rc = evbuffer_prepend_buffer(buffer_.get(), other.buffer().get());
+    ASSERT(rc == 0);
+  } else {
+    while (!other.slices_.empty()) {
+      const uint64_t slice_size = other.slices_.back()->dataSize();
+      if (slice_size != 0) {
+        length_ += slice_size;
+        slices_.emplace_front(std::move(other.slices_.back()));
+      }
+      other.slices_.pop_back();
+      other.length_ -= slice_size;
+    }
+  }
   ASSERT(data.length() == 0);
-  static_cast<LibEventInstance&>(data).postProcess();
+  other.postProcess();
 }
 
 void OwnedImpl::commit(RawSlice* iovecs, uint64_t num_iovecs) {
-  int rc =
-      evbuffer_commit_space(buffer_.get(), reinterpret_cast<evbuffer_iovec*>(iovecs), num_iovecs);
-  ASSERT(rc == 0);
+  if (old_impl_) {
+    int rc =
+        evbuffer_commit_space(buffer_.get(), reinterpret_cast<evbuffer_iovec*>(iovecs), num_iovecs);
+    ASSERT(rc == 0);
+    return;
+  }
+
+  if (num_iovecs == 0 || slices_.empty()) {
+    return;
+  }
+  // Reservations are made from the slices following the last slice with any data, so start
+  // matching the iovecs there. Out of order commits aren't supported.
+  size_t slice_index = slices_.size() - 1;
+  while (slice_index > 0 && slices_[slice_index]->dataSize() == 0) {
+    slice_index--;
+  }
+  uint64_t num_iovecs_committed = 0;
+  for (; slice_index < slices_.size() && num_iovecs_committed < num_iovecs; slice_index++) {
+    if (slices_[slice_index]->commit(iovecs[num_iovecs_committed])) {
+      length_ += iovecs[num_iovecs_committed].len_;
+      num_iovecs_committed++;
+    }
+  }
+  ASSERT(num_iovecs_committed == num_iovecs);
 }
 
 void OwnedImpl::copyOut(size_t start, uint64_t size, void* data) const {
   ASSERT(start + size <= length());
 
-  evbuffer_ptr start_ptr;
-  int rc = evbuffer_ptr_set(buffer_.get(), &start_ptr, start, EVBUFFER_PTR_SET);
-  ASSERT(rc != -1);
+  if (old_impl_) {
+    evbuffer_ptr start_ptr;
+    int rc = evbuffer_ptr_set(buffer_.get(), &start_ptr, start, EVBUFFER_PTR_SET);
+    ASSERT(rc != -1);
+
+    ev_ssize_t copied = evbuffer_copyout_from(buffer_.get(), &start_ptr, data, size);
+    ASSERT(static_cast<uint64_t>(copied) == size);
+    return;
+  }
 
-  ev_ssize_t copied = evbuffer_copyout_from(buffer_.get(), &start_ptr, data, size);
-  ASSERT(static_cast<uint64_t>(copied) == size);
+  uint8_t* dest = static_cast<uint8_t*>(data);
+  for (const SlicePtr& slice : slices_) {
+    if (size == 0) {
+      break;
+    }
+    const uint64_t slice_size = slice->dataSize();
+    if (start >= slice_size) {
+      start -= slice_size;
+      continue;
+    }
+    const uint64_t copy_size = std::min(slice_size - start, size);
+    memcpy(dest, slice->data() + start, copy_size);
+    dest += copy_size;
+    size -= copy_size;
+    start = 0;
+  }
+  ASSERT(size == 0);
 }
 
 void OwnedImpl::drain(uint64_t size) {
   ASSERT(size <= length());
-  int rc = evbuffer_drain(buffer_.get(), size);
-  ASSERT(rc == 0);
+  if (old_impl_) {
+    int rc = evbuffer_drain(buffer_.get(), size);
+    ASSERT(rc == 0);
+  } else {
+    drainImpl(size);
+  }
 }
 
 uint64_t OwnedImpl::getRawSlices(RawSlice* out, uint64_t out_size) const {
-  return evbuffer_peek(buffer_.get(), -1, nullptr, reinterpret_cast<evbuffer_iovec*>(out),
-                       out_size);
+  if (old_impl_) {
+    return evbuffer_peek(buffer_.get(), -1, nullptr, reinterpret_cast<evbuffer_iovec*>(out),
+                         out_size);
+  }
+
+  uint64_t num_slices = 0;
+  for (const SlicePtr& slice : slices_) {
+    if (slice->dataSize() == 0) {
+      continue;
+    }
+    if (num_slices < out_size) {
+      out[num_slices].mem_ = const_cast<uint8_t*>(slice->data());
+      out[num_slices].len_ = slice->dataSize();
+    }
+    num_slices++;
+  }
+  return num_slices;
 }
 
-uint64_t OwnedImpl::length() const { return evbuffer_get_length(buffer_.get()); }
+uint64_t OwnedImpl::length() const {
+  return old_impl_ ? evbuffer_get_length(buffer_.get()) : length_;
+}
 
 void* OwnedImpl::linearize(uint32_t size) {
   ASSERT(size <= length());
-  return evbuffer_pullup(buffer_.get(), size);
+  if (old_impl_) {
+    return evbuffer_pullup(buffer_.get(), size);
+  }
+
+  if (size == 0) {
+    return nullptr;
+  }
+  // drainImpl() never leaves an empty slice in front of data, but a failed read can.
+  while (slices_.front()->dataSize() == 0) {
+    slices_.pop_front();
+  }
+  if (slices_.front()->dataSize() >= size) {
+    // The data is already contiguous, so there is nothing to copy.
+    return slices_.front()->data();
+  }
+
+  SlicePtr slice = OwnedSlice::create(size);
+  Slice::Reservation reservation = slice->reserve(size);
+  copyOut(0, size, reservation.mem_);
+  slice->commit(reservation);
+  drainImpl(size);
+  slices_.emplace_front(std::move(slice));
+  length_ += size;
+  return slices_.front()->data();
 }
 
 void OwnedImpl::move(Instance& rhs) {
+  ASSERT(&rhs != this);
   // We do the static cast here because in practice we only have one buffer implementation right
-  // now and this is safe. Using the evbuffer move routines require having access to both evbuffers.
-  // This is a reasonable compromise in a high performance path where we want to maintain an
-  // abstraction in case we get rid of evbuffer later.
-  int rc = evbuffer_add_buffer(buffer_.get(), static_cast<LibEventInstance&>(rhs).buffer().get());
-  ASSERT(rc == 0);
-  static_cast<LibEventInstance&>(rhs).postProcess();
+  // now and this is safe. Moving slices or evbuffer chains requires access to the internals of
+  // both buffers. This is a reasonable compromise in a high performance path where we want to
+  // maintain an abstraction.
+  OwnedImpl& other = static_cast<OwnedImpl&>(rhs);
+  ASSERT(other.old_impl_ == old_impl_);
+  if (old_impl_) {
+    int rc = evbuffer_add_buffer(buffer_.get(), other.buffer().get());
+    ASSERT(rc == 0);
+  } else {
+    while (!other.slices_.empty()) {
+      moveSlice(other);
+    }
+  }
+  other.postProcess();
 }
 
 void OwnedImpl::move(Instance& rhs, uint64_t length) {
+  ASSERT(&rhs != this);
   // See move() above for why we do the static cast.
-  int rc = evbuffer_remove_buffer(static_cast<LibEventInstance&>(rhs).buffer().get(), buffer_.get(),
-                                  length);
-  ASSERT(static_cast<uint64_t>(rc) == length);
-  static_cast<LibEventInstance&>(rhs).postProcess();
+  OwnedImpl& other = static_cast<OwnedImpl&>(rhs);
+  ASSERT(other.old_impl_ == old_impl_);
+  if (old_impl_) {
+    int rc = evbuffer_remove_buffer(other.buffer().get(), buffer_.get(), length);
+    ASSERT(static_cast<uint64_t>(rc) == length);
+  } else {
+    ASSERT(length <= other.length_);
+    while (length != 0 && !other.slices_.empty()) {
+      const uint64_t slice_size = other.slices_.front()->dataSize();
+      if (slice_size <= length) {
+        moveSlice(other);
+        length -= slice_size;
+      } else {
+        // Only part of this slice is wanted, so copy that part and leave the rest behind.
+        addImpl(other.slices_.front()->data(), length);
+        other.drainImpl(length);
+        length = 0;
+      }
+    }
+  }
+  other.postProcess();
 }
 
 Api::SysCallIntResult OwnedImpl::read(int fd, uint64_t max_length) {
@@ -148,27 +391,126 @@ Api::SysCallIntResult OwnedImpl::read(int fd, uint64_t max_length) {
 }
 
 uint64_t OwnedImpl::reserve(uint64_t length, RawSlice* iovecs, uint64_t num_iovecs) {
-  uint64_t ret = evbuffer_reserve_space(buffer_.get(), length,
-                                        reinterpret_cast<evbuffer_iovec*>(iovecs), num_iovecs);
-  ASSERT(ret >= 1);
-  return ret;
+  if (old_impl_) {
+    uint64_t ret = evbuffer_reserve_space(buffer_.get(), length,
+                                          reinterpret_cast<evbuffer_iovec*>(iovecs), num_iovecs);
+    ASSERT(ret >= 1);
+    return ret;
+  }
+
+  if (num_iovecs == 0 || length == 0) {
+    return 0;
+  }
+  // Reservations can use the space after the last slice with any data, and any empty slices that
+  // follow it.
+  size_t slice_index = slices_.size();
+  while (slice_index > 0 && slices_[slice_index - 1]->dataSize() == 0) {
+    slice_index--;
+  }
+  if (slice_index > 0) {
+    slice_index--;
+  }
+
+  uint64_t num_iovecs_used = 0;
+  uint64_t bytes_remaining = length;
+  for (; slice_index < slices_.size() && bytes_remaining != 0; slice_index++) {
+    const uint64_t reservable_size = slices_[slice_index]->reservableSize();
+    if (reservable_size == 0) {
+      continue;
+    }
+    if (num_iovecs_used + 1 == num_iovecs && reservable_size < bytes_remaining) {
+      // Keep the last iovec for a new slice which can hold the rest of the reservation.
+      break;
+    }
+    iovecs[num_iovecs_used] = slices_[slice_index]->reserve(bytes_remaining);
+    bytes_remaining -= iovecs[num_iovecs_used].len_;
+    num_iovecs_used++;
+  }
+  if (bytes_remaining != 0) {
+    slices_.emplace_back(OwnedSlice::create(bytes_remaining));
+    iovecs[num_iovecs_used] = slices_.back()->reserve(bytes_remaining);
+    bytes_remaining -= iovecs[num_iovecs_used].len_;
+    num_iovecs_used++;
+  }
+  ASSERT(num_iovecs_used <= num_iovecs);
+  ASSERT(bytes_remaining == 0);
+  return num_iovecs_used;
 }
 
 ssize_t OwnedImpl::search(const void* data, uint64_t size, size_t start) const {
-  evbuffer_ptr start_ptr;
-  if (-1 == evbuffer_ptr_set(buffer_.get(), &start_ptr, start, EVBUFFER_PTR_SET)) {
-    return -1;
+  if (old_impl_) {
+    evbuffer_ptr start_ptr;
+    if (-1 == evbuffer_ptr_set(buffer_.get(), &start_ptr, start, EVBUFFER_PTR_SET)) {
+      return -1;
+    }
+
+    evbuffer_ptr result_ptr =
+        evbuffer_search(buffer_.get(), static_cast<const char*>(data), size, &start_ptr);
+    return result_ptr.pos;
   }
 
-  evbuffer_ptr result_ptr =
-      evbuffer_search(buffer_.get(), static_cast<const char*>(data), size, &start_ptr);
-  return result_ptr.pos;
+  if (start > length_) {
+    return -1;
+  }
+  if (size == 0) {
+    return start;
+  }
+  // This is the same naive scan used by evbuffer_search(): find the first byte of the needle with
+  // memchr() and then compare the rest, which may span several slices.
+  const uint8_t* needle = static_cast<const uint8_t*>(data);
+  ssize_t offset = 0;
+  for (size_t slice_index = 0; slice_index < slices_.size(); slice_index++) {
+    const Slice& slice = *slices_[slice_index];
+    const uint64_t slice_size = slice.dataSize();
+    if (start >= slice_size) {
+      start -= slice_size;
+      offset += slice_size;
+      continue;
+    }
+    const uint8_t* slice_start = slice.data();
+    const uint8_t* slice_end = slice_start + slice_size;
+    const uint8_t* haystack = slice_start + start;
+    while (haystack < slice_end) {
+      const uint8_t* first_byte_match =
+          static_cast<const uint8_t*>(memchr(haystack, needle[0], slice_end - haystack));
+      if (first_byte_match == nullptr) {
+        break;
+      }
+      uint64_t i = 1;
+      size_t match_index = slice_index;
+      const uint8_t* match_next = first_byte_match + 1;
+      const uint8_t* match_end = slice_end;
+      while (i < size) {
+        if (match_next == match_end) {
+          if (++match_index == slices_.size()) {
+            break;
+          }
+          match_next = slices_[match_index]->data();
+          match_end = match_next + slices_[match_index]->dataSize();
+          continue;
+        }
+        if (*match_next++ != needle[i]) {
+          break;
+        }
+        i++;
+      }
+      if (i == size) {
+        return offset + (first_byte_match - slice_start);
+      }
+      haystack = first_byte_match + 1;
+    }
+    start = 0;
+    offset += slice_size;
+  }
+  return -1;
 }
 
 Api::SysCallIntResult OwnedImpl::write(int fd) {
-  constexpr uint64_t MaxSlices = 16;
-  RawSlice slices[MaxSlices];
-  const uint64_t num_slices = std::min(getRawSlices(slices, MaxSlices), MaxSlices);
+  // Gather as many slices as a single writev() takes, so that a buffer built from many fragments,
+  // such as an HTTP/1 header block followed by the body, is written with one system call.
+  const uint64_t num_slices = std::min(getRawSlices(nullptr, 0), MaxWriteSlices);
+  STACK_ARRAY(slices, RawSlice, num_slices);
+  getRawSlices(slices.begin(), num_slices);
   STACK_ARRAY(iov, iovec, num_slices);
   uint64_t num_slices_to_write = 0;
   for (uint64_t i = 0; i < num_slices; i++) {
@@ -189,7 +531,11 @@ Api::SysCallIntResult OwnedImpl::write(int fd) {
   return {static_cast<int>(result.rc_), result.errno_};
 }
 
-OwnedImpl::OwnedImpl() : buffer_(evbuffer_new()) {}
+OwnedImpl::OwnedImpl() : old_impl_(use_old_impl_) {
+  if (old_impl_) {
+    buffer_.reset(evbuffer_new());
+  }
+}
 
 OwnedImpl::OwnedImpl(const std::string& data) : OwnedImpl() { add(data); }
 
@@ -1,10 +1,16 @@
 #pragma once
 
+#include <algorithm>
+#include <climits>
 #include <cstdint>
+#include <deque>
+#include <memory>
 #include <string>
 
 #include "envoy/buffer/buffer.h"
 
+#include "common/buffer/slice_allocator.h"
+#include "common/common/assert.h"
 #include "common/common/non_copyable.h"
 #include "common/event/libevent.h"
 
@@ -46,19 +52,184 @@ private:
   const std::function<void(const void*, size_t, const BufferFragmentImpl*)> releasor_;
 };
 
+/**
+ * A contiguous region of memory which holds a portion of a buffer's content. The memory is split
+ * into three sections:
+ *
+ *   |<- drained ->|<-- data -->|<-- reservable -->|
+ *   0           data_     reservable_         capacity_
+ *
+ * Data is removed from the front of the data section by drain(), and new data is added at the
+ * front of the reservable section by append() or by reserve() followed by commit(). Drained space
+ * at the start of the slice can be reused by prepend().
+ */
+class Slice {
+public:
+  typedef RawSlice Reservation;
+
+  virtual ~Slice() {}
+
+  /**
+   * @return a pointer to the start of the data in the slice.
+   */
+  const uint8_t* data() const { return base_ + data_; }
+  uint8_t* data() { return base_ + data_; }
+
+  /**
+   * @return the number of bytes of data in the slice.
+   */
+  uint64_t dataSize() const { return reservable_ - data_; }
+
+  /**
+   * Remove data from the start of the slice.
+   * @param size supplies the number of bytes to remove. It must not exceed dataSize().
+   */
+  void drain(uint64_t size) {
+    ASSERT(data_ + size <= reservable_);
+    data_ += size;
+    if (data_ == reservable_ && writable_) {
+      // The slice is now empty, so rewind it to make all of its memory reservable again.
+      data_ = reservable_ = 0;
+    }
+  }
+
+  /**
+   * @return the number of bytes that can be appended to the slice.
+   */
+  uint64_t reservableSize() const { return writable_ ? capacity_ - reservable_ : 0; }
+
+  /**
+   * Reserve space at the end of the data section. The space does not become part of the data
+   * until it is committed. Any change to the slice invalidates an uncommitted reservation.
+   * @param size supplies the number of bytes to reserve.
+   * @return the reservation, which may be shorter than size (or empty) if the slice does not have
+   *         enough reservable space.
+   */
+  Reservation reserve(uint64_t size) {
+    size = std::min(size, reservableSize());
+    if (size == 0) {
+      return {nullptr, 0};
+    }
+    return {base_ + reservable_, static_cast<size_t>(size)};
+  }
+
+  /**
+   * Commit all or part of a reservation made with reserve().
+   * @param reservation supplies the reservation, with len_ set to the number of bytes to commit.
+   * @return true if the reservation belongs to this slice and was committed.
+   */
+  bool commit(const Reservation& reservation) {
+    if (static_cast<const uint8_t*>(reservation.mem_) != base_ + reservable_ ||
+        reservation.len_ > reservableSize()) {
+      return false;
+    }
+    reservable_ += reservation.len_;
+    return true;
+  }
+
+  /**
+   * Copy as much of the supplied data as will fit to the end of the slice.
+   * @param data supplies the data to copy.
+   * @param size supplies the size of the data.
+   * @return the number of bytes copied.
+   */
+  uint64_t append(const void* data, uint64_t size);
+
+  /**
+   * Copy as much of the supplied data as will fit in front of the data in the slice. If the data
+   * does not fit, its trailing bytes are copied so that the caller can prepend the remainder to
+   * another slice.
+   * @param data supplies the data to copy.
+   * @param size supplies the size of the data.
+   * @return the number of bytes copied.
+   */
+  uint64_t prepend(const void* data, uint64_t size);
+
+protected:
+  Slice(uint64_t data, uint64_t reservable, uint64_t capacity, bool writable)
+      : data_(data), reservable_(reservable), capacity_(capacity), writable_(writable) {}
+
+  uint8_t* base_{nullptr};
+  uint64_t data_;
+  uint64_t reservable_;
+  const uint64_t capacity_;
+  // False for slices which reference memory owned by someone else, which must never be modified.
+  const bool writable_;
+};
+
+typedef std::unique_ptr<Slice> SlicePtr;
+
+/**
+ * A slice which owns its memory. The slice object and its memory are allocated together by the
+ * SliceAllocator, and the capacity is rounded up to a size class so that freed slices can be
+ * reused.
+ */
+class OwnedSlice : public Slice {
+public:
+  /**
+   * Create an empty slice.
+   * @param capacity supplies the minimum capacity of the slice.
+   */
+  static SlicePtr create(uint64_t capacity) {
+    const uint64_t slice_capacity = SliceAllocator::capacityFor(capacity);
+    return SlicePtr(new (slice_capacity) OwnedSlice(slice_capacity));
+  }
+
+  /**
+   * Create a slice holding a copy of the supplied data.
+   * @param data supplies the data to copy.
+   * @param size supplies the size of the data.
+   */
+  static SlicePtr create(const void* data, uint64_t size) {
+    SlicePtr slice = create(size);
+    slice->append(data, size);
+    return slice;
+  }
+
+  static void* operator new(size_t object_size, size_t data_size) {
+    return SliceAllocator::allocate(object_size, data_size);
+  }
+  static void operator delete(void* address) { SliceAllocator::free(address); }
+
+private:
+  OwnedSlice(uint64_t capacity) : Slice(0, 0, capacity, true) { base_ = storage_; }
+
+  uint8_t storage_[];
+};
+
+/**
+ * A slice which references the memory of a BufferFragment without copying it. The fragment is
+ * released when the slice is destroyed.
+ */
+class UnownedSlice : public Slice {
+public:
+  UnownedSlice(BufferFragment& fragment)
+      : Slice(0, fragment.size(), fragment.size(), false), fragment_(fragment) {
+    base_ = static_cast<uint8_t*>(const_cast<void*>(fragment.data()));
+  }
+
+  ~UnownedSlice() override { fragment_.done(); }
+
+private:
+  BufferFragment& fragment_;
+};
+
 class LibEventInstance : public Instance {
 public:
-  // Allows access into the underlying buffer for move() optimizations.
+  // Allows access into the underlying buffer for move() optimizations. Only valid for buffers
+  // which use the evbuffer implementation.
   virtual Event::Libevent::BufferPtr& buffer() PURE;
   // Called after accessing the memory in buffer() directly to allow any post-processing.
   virtual void postProcess() PURE;
 };
 
 /**
- * Wraps an allocated and owned evbuffer.
+ * A buffer which owns its content. By default the content is held in a deque of slices. The
+ * original implementation, which wraps an evbuffer, can be selected with useOldImpl() so that the
+ * two can be compared. The choice is made when each buffer is constructed.
  *
- * Note that due to the internals of move() accessing buffer(), OwnedImpl is not
- * compatible with non-LibEventInstance buffers.
+ * Note that due to the internals of move() and prepend(), OwnedImpl is not compatible with
+ * buffers of other types, or with an OwnedImpl using the other implementation.
  */
 class OwnedImpl : public LibEventInstance {
 public:
@@ -91,8 +262,40 @@ public:
 
   Event::Libevent::BufferPtr& buffer() override { return buffer_; }
 
+  /**
+   * Select the implementation used by buffers constructed after this call. This is intended to be
+   * called once at startup, before any buffers are shared between components.
+   * @param use_old_impl supplies whether to use the evbuffer implementation.
+   */
+  static void useOldImpl(bool use_old_impl) { use_old_impl_ = use_old_impl; }
+
+  /**
+   * @return whether this buffer uses the evbuffer implementation.
+   */
+  bool usesOldImpl() const { return old_impl_; }
+
+  // Slices of at most this many bytes are copied, rather than moved, into the free space at the
+  // end of the destination by move(). This keeps the number of slices, and so the number of
+  // iovecs needed to write the buffer, down when many small buffers are moved into one.
+  static constexpr uint64_t CopyThreshold = 512;
+
+  // The most slices that write() passes to a single writev() call.
+  static constexpr uint64_t MaxWriteSlices = IOV_MAX;
+
 private:
+  void addImpl(const void* data, uint64_t size);
+  void drainImpl(uint64_t size);
+  void moveSlice(OwnedImpl& other);
+
+  static bool use_old_impl_;
+
+  // Not const, so that buffers can still be move assigned.
+  bool old_impl_;
+  // Used only by the evbuffer implementation.
   Event::Libevent::BufferPtr buffer_;
+  // Used only by the slice implementation.
+  std::deque<SlicePtr> slices_;
+  uint64_t length_{0};
 };
 
 } // namespace Buffer
@@ -0,0 +1,216 @@
+#include "common/buffer/slice_allocator.h"
+
+#include <algorithm>
+#include <list>
+#include <new>
+
+#include "common/common/assert.h"
+#include "common/common/lock_guard.h"
+#include "common/common/thread.h"
+
+namespace Envoy {
+namespace Buffer {
+
+namespace {
+
+// Every live allocator, so that totals can be computed. The lock is only taken when a thread's
+// allocator is created or destroyed, and when totals are read.
+struct Registry {
+  Thread::MutexBasicLockable mutex_;
+  std::list<const SliceAllocator*> allocators_;
+  // Counts left behind by allocators of threads which have exited. Their slices may still be in
+  // use by other threads, and are accounted here when freed.
+  std::atomic<int64_t> exited_bytes_in_use_{0};
+};
+
+Registry& registry() {
+  // Never destroyed, since slices can be freed during static destruction.
+  static Registry* registry = new Registry();
+  return *registry;
+}
+
+// Set while the calling thread's allocator exists. These are trivially destructible, so they can
+// still be read by thread_local destructors which run after the allocator has been destroyed.
+thread_local SliceAllocator* current_allocator = nullptr;
+thread_local bool allocator_destroyed = false;
+
+void addRelaxed(std::atomic<int64_t>& value, int64_t amount) {
+  value.store(value.load(std::memory_order_relaxed) + amount, std::memory_order_relaxed);
+}
+
+} // namespace
+
+constexpr uint64_t SliceAllocator::SmallCapacity;
+constexpr uint64_t SliceAllocator::LargeCapacity;
+constexpr uint32_t SliceAllocator::MaxPooledSmall;
+constexpr uint32_t SliceAllocator::MaxPooledLarge;
+
+SliceAllocator::SliceAllocator() {
+  Registry& r = registry();
+  Thread::LockGuard lock(r.mutex_);
+  r.allocators_.push_back(this);
+}
+
+SliceAllocator::~SliceAllocator() {
+  for (Pool* pool : {&small_pool_, &large_pool_}) {
+    while (pool->head_ != nullptr) {
+      ChunkHeader* header = pool->head_;
+      pool->head_ = nextFree(header);
+      ::operator delete(header);
+    }
+  }
+  current_allocator = nullptr;
+  allocator_destroyed = true;
+
+  Registry& r = registry();
+  Thread::LockGuard lock(r.mutex_);
+  r.allocators_.remove(this);
+  r.exited_bytes_in_use_ += bytes_in_use_.load(std::memory_order_relaxed);
+}
+
+uint64_t SliceAllocator::capacityFor(uint64_t capacity) {
+  if (capacity <= SmallCapacity) {
+    return SmallCapacity;
+  }
+  if (capacity <= LargeCapacity) {
+    return LargeCapacity;
+  }
+  return (capacity + LargeCapacity - 1) / LargeCapacity * LargeCapacity;
+}
+
+SliceAllocator& SliceAllocator::threadLocal() {
+  static thread_local SliceAllocator allocator;
+  current_allocator = &allocator;
+  return allocator;
+}
+
+void* SliceAllocator::allocate(uint64_t header_size, uint64_t capacity) {
+  const uint64_t size = sizeof(ChunkHeader) + header_size + capacity;
+  if (current_allocator != nullptr) {
+    return current_allocator->allocateChunk(size, capacity);
+  }
+  if (!allocator_destroyed) {
+    return threadLocal().allocateChunk(size, capacity);
+  }
+  // This thread's allocator is gone, which only happens while the thread is exiting.
+  ChunkHeader* header = static_cast<ChunkHeader*>(::operator new(size));
+  header->size_ = size;
+  header->capacity_ = capacity;
+  registry().exited_bytes_in_use_ += size;
+  return header + 1;
+}
+
+void SliceAllocator::free(void* memory) {
+  ChunkHeader* header = static_cast<ChunkHeader*>(memory) - 1;
+  if (current_allocator != nullptr) {
+    current_allocator->freeChunk(header);
+  } else if (!allocator_destroyed) {
+    threadLocal().freeChunk(header);
+  } else {
+    registry().exited_bytes_in_use_ -= header->size_;
+    ::operator delete(header);
+  }
+}
+
+SliceAllocator::ChunkHeader*& SliceAllocator::nextFree(ChunkHeader* header) {
+  // A pooled chunk keeps its header, so that allocateChunk() can check its size, and links to the
+  // next pooled chunk from the start of its payload.
+  return *reinterpret_cast<ChunkHeader**>(header + 1);
+}
+
+void* SliceAllocator::allocateChunk(uint64_t size, uint64_t capacity) {
+  Pool* pool = poolFor(capacity);
+  ChunkHeader* header;
+  if (pool != nullptr && pool->head_ != nullptr && pool->head_->size_ == size) {
+    header = pool->head_;
+    pool->head_ = nextFree(header);
+    pool->size_--;
+    addPooled(-static_cast<int64_t>(size));
+  } else {
+    header = static_cast<ChunkHeader*>(::operator new(size));
+  }
+  header->size_ = size;
+  header->capacity_ = capacity;
+  addInUse(1, size);
+  return header + 1;
+}
+
+void SliceAllocator::freeChunk(ChunkHeader* header) {
+  const uint64_t size = header->size_;
+  addInUse(-1, -static_cast<int64_t>(size));
+  Pool* pool = poolFor(header->capacity_);
+  if (pool != nullptr && pool->size_ < pool->max_size_) {
+    nextFree(header) = pool->head_;
+    pool->head_ = header;
+    pool->size_++;
+    addPooled(size);
+    slices_returned_++;
+  } else {
+    ::operator delete(header);
+  }
+}
+
+SliceAllocator::Pool* SliceAllocator::poolFor(uint64_t capacity) {
+  switch (capacity) {
+  case SmallCapacity:
+    return &small_pool_;
+  case LargeCapacity:
+    return &large_pool_;
+  default:
+    return nullptr;
+  }
+}
+
+void SliceAllocator::addInUse(int64_t slices, int64_t bytes) {
+  addRelaxed(slices_in_use_, slices);
+  addRelaxed(bytes_in_use_, bytes);
+}
+
+void SliceAllocator::addPooled(int64_t bytes) { addRelaxed(bytes_pooled_, bytes); }
+
+void SliceAllocator::setStats(SliceAllocatorStats* stats) {
+  publishStats();
+  stats_ = stats;
+  // Slices returned before the stats were set are not counted.
+  slices_returned_published_ = slices_returned_;
+  publishStats();
+}
+
+void SliceAllocator::publishStats() {
+  if (stats_ == nullptr) {
+    return;
+  }
+  if (slices_returned_ != slices_returned_published_) {
+    stats_->slices_returned_.add(slices_returned_ - slices_returned_published_);
+    slices_returned_published_ = slices_returned_;
+  }
+  // Slices freed by this thread may have been allocated by another one, so the counts can go
+  // negative for a thread. Gauges are unsigned, so clamp them.
+  stats_->slices_in_use_.set(std::max<int64_t>(slicesInUse(), 0));
+  stats_->bytes_in_use_.set(std::max<int64_t>(bytes_in_use_.load(std::memory_order_relaxed), 0));
+  stats_->slices_pooled_.set(slicesPooled());
+  stats_->bytes_pooled_.set(bytes_pooled_.load(std::memory_order_relaxed));
+}
+
+uint64_t SliceAllocator::totalBytesInUse() {
+  Registry& r = registry();
+  Thread::LockGuard lock(r.mutex_);
+  int64_t total = r.exited_bytes_in_use_;
+  for (const SliceAllocator* allocator : r.allocators_) {
+    total += allocator->bytes_in_use_.load(std::memory_order_relaxed);
+  }
+  return std::max<int64_t>(total, 0);
+}
+
+uint64_t SliceAllocator::totalBytesPooled() {
+  Registry& r = registry();
+  Thread::LockGuard lock(r.mutex_);
+  int64_t total = 0;
+  for (const SliceAllocator* allocator : r.allocators_) {
+    total += allocator->bytes_pooled_.load(std::memory_order_relaxed);
+  }
+  return total;
+}
+
+} // namespace Buffer
+} // namespace Envoy
@@ -0,0 +1,157 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+#include "envoy/stats/stats_macros.h"
+
+namespace Envoy {
+namespace Buffer {
+
+/**
+ * All slice allocator stats. @see stats_macros.h
+ */
+// clang-format off
+#define ALL_SLICE_ALLOCATOR_STATS(COUNTER, GAUGE)                                                  \
+  COUNTER(slices_returned)                                                                         \
+  GAUGE  (slices_in_use)                                                                           \
+  GAUGE  (slices_pooled)                                                                           \
+  GAUGE  (bytes_in_use)                                                                            \
+  GAUGE  (bytes_pooled)
+// clang-format on
+
+/**
+ * Struct definition for all slice allocator stats. @see stats_macros.h
+ */
+struct SliceAllocatorStats {
+  ALL_SLICE_ALLOCATOR_STATS(GENERATE_COUNTER_STRUCT, GENERATE_GAUGE_STRUCT)
+};
+
+/**
+ * Allocates the memory for buffer slices. Each thread has its own allocator, which keeps freed
+ * slices of the common capacities in free lists and hands them out again without going back to
+ * malloc. No locks are taken when allocating or freeing.
+ *
+ * A slice may be freed by a different thread than the one that allocated it, in which case it is
+ * pooled and accounted for by the freeing thread. Per-thread counts can therefore drift, but the
+ * total across all threads is exact.
+ *
+ * Allocating and freeing only update plain per-thread counts. They are published to stats by
+ * publishStats(), which the owning thread calls periodically.
+ */
+class SliceAllocator {
+public:
+  // Capacities which are pooled. Capacities are rounded up to one of these, or to a multiple of
+  // the larger one, by capacityFor().
+  static constexpr uint64_t SmallCapacity = 4096;
+  static constexpr uint64_t LargeCapacity = 16384;
+  // The number of freed slices of each capacity that a thread keeps for reuse. Slices freed beyond
+  // this go back to malloc.
+  static constexpr uint32_t MaxPooledSmall = 256;
+  static constexpr uint32_t MaxPooledLarge = 64;
+
+  ~SliceAllocator();
+
+  /**
+   * @param capacity supplies the number of bytes a slice must be able to hold.
+   * @return the capacity that a slice holding capacity bytes should have.
+   */
+  static uint64_t capacityFor(uint64_t capacity);
+
+  /**
+   * Allocate memory for a slice.
+   * @param header_size supplies the size of the slice object, which is placed at the start of
+   *        the memory.
+   * @param capacity supplies the slice capacity, as returned by capacityFor(). It follows the
+   *        slice object.
+   * @return the memory, which must be released with free().
+   */
+  static void* allocate(uint64_t header_size, uint64_t capacity);
+
+  /**
+   * Release memory returned by allocate(). This may be called from any thread.
+   * @param memory supplies the memory.
+   */
+  static void free(void* memory);
+
+  /**
+   * @return SliceAllocator& the allocator for the calling thread.
+   */
+  static SliceAllocator& threadLocal();
+
+  /**
+   * Set the stats which publishStats() updates with this allocator's counts. The current counts
+   * are published to the previous and the new stats.
+   * @param stats supplies the stats, or nullptr to stop publishing. The stats must remain valid
+   *        until this is called again with nullptr, or the thread exits.
+   */
+  void setStats(SliceAllocatorStats* stats);
+
+  /**
+   * Update the stats set by setStats() with this allocator's current counts. Must be called by the
+   * owning thread.
+   */
+  void publishStats();
+
+  /**
+   * @return uint64_t the number of bytes of slice memory, including slice objects, which is in use
+   *         across all threads. Pooled memory is not included.
+   */
+  static uint64_t totalBytesInUse();
+
+  /**
+   * @return uint64_t the number of bytes of slice memory held in the free lists of all threads.
+   */
+  static uint64_t totalBytesPooled();
+
+  /**
+   * @return int64_t the number of slices allocated, less the number freed, by this thread.
+   */
+  int64_t slicesInUse() const { return slices_in_use_.load(std::memory_order_relaxed); }
+
+  /**
+   * @return uint32_t the number of slices in this thread's free lists.
+   */
+  uint32_t slicesPooled() const { return small_pool_.size_ + large_pool_.size_; }
+
+private:
+  // Every chunk starts with this header, which records how it was allocated so that free() can
+  // find the pool it belongs to. It is padded to keep the slice object aligned for any type.
+  struct alignas(alignof(std::max_align_t)) ChunkHeader {
+    // The size of the whole chunk, including this header.
+    uint64_t size_;
+    // The slice capacity requested from allocate().
+    uint64_t capacity_;
+  };
+
+  struct Pool {
+    ChunkHeader* head_;
+    uint32_t size_;
+    const uint32_t max_size_;
+  };
+
+  SliceAllocator();
+
+  void* allocateChunk(uint64_t size, uint64_t capacity);
+  void freeChunk(ChunkHeader* header);
+  static ChunkHeader*& nextFree(ChunkHeader* header);
+  Pool* poolFor(uint64_t capacity);
+  void addInUse(int64_t slices, int64_t bytes);
+  void addPooled(int64_t bytes);
+
+  Pool small_pool_{nullptr, 0, MaxPooledSmall};
+  Pool large_pool_{nullptr, 0, MaxPooledLarge};
+  SliceAllocatorStats* stats_{};
+  // Slices kept for reuse by free(), and how many of those have been added to the stats counter.
+  uint64_t slices_returned_{};
+  uint64_t slices_returned_published_{};
+  // These are only written by the owning thread, but are read by other threads to compute totals,
+  // so they are atomic. Updates are a relaxed load and store rather than a locked add.
+  std::atomic<int64_t> slices_in_use_{0};
+  std::atomic<int64_t> bytes_in_use_{0};
+  std::atomic<int64_t> bytes_pooled_{0};
+};
+
+} // namespace Buffer
+} // namespace Envoy
@@ -20,6 +20,11 @@ void WatermarkBuffer::add(const Instance& data) {
   checkHighWatermark();
 }
 
+void WatermarkBuffer::addBufferFragment(BufferFragment& fragment) {
+  OwnedImpl::addBufferFragment(fragment);
+  checkHighWatermark();
+}
+
 void WatermarkBuffer::prepend(absl::string_view data) {
   OwnedImpl::prepend(data);
   checkHighWatermark();
@@ -0,0 +1,37 @@
+#include "common/common/arena.h"
+
+#include <algorithm>
+
+namespace Envoy {
+
+constexpr uint64_t Arena::HeapBlockSize;
+
+Arena::~Arena() {
+  while (heap_blocks_list_ != nullptr) {
+    HeapBlock* block = heap_blocks_list_;
+    heap_blocks_list_ = block->next_;
+    ::operator delete(block);
+  }
+}
+
+void* Arena::allocateSlow(size_t size) {
+  // Allocations larger than a block get a block of their own, and the current block carries on
+  // being used for smaller ones.
+  const bool dedicated = size > HeapBlockSize;
+  const size_t block_size = std::max<size_t>(size, HeapBlockSize);
+  HeapBlock* block = static_cast<HeapBlock*>(::operator new(sizeof(HeapBlock) + block_size));
+  block->next_ = heap_blocks_list_;
+  heap_blocks_list_ = block;
+  heap_blocks_++;
+  allocations_++;
+  bytes_allocated_ += size;
+
+  char* memory = reinterpret_cast<char*>(block + 1);
+  if (!dedicated) {
+    next_ = memory + size;
+    end_ = memory + block_size;
+  }
+  return memory;
+}
+
+} // namespace Envoy
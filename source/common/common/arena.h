@@ -0,0 +1,152 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <utility>
+
+#include "common/common/assert.h"
+#include "common/common/non_copyable.h"
+
+namespace Envoy {
+
+/**
+ * A bump allocator for objects which share a lifetime, such as the state of one HTTP stream.
+ * Allocation advances a pointer through a block of memory, and nothing is freed until the arena is
+ * destroyed, when all of its blocks are released at once. When a block is used up, a new one is
+ * allocated from the heap.
+ *
+ * Objects carved from an arena must be destroyed before it. ArenaPtr and ArenaAllocator run
+ * destructors without freeing memory, so that owning pointers and containers can use the arena.
+ * An arena must only be used by one thread.
+ */
+class Arena : NonCopyable {
+public:
+  // The size of the blocks allocated from the heap once the initial block is used up. Larger
+  // allocations get a block of their own.
+  static constexpr uint64_t HeapBlockSize = 4096;
+
+  Arena() : Arena(nullptr, 0) {}
+  ~Arena();
+
+  /**
+   * Allocate memory, which stays valid until the arena is destroyed.
+   * @param size supplies the number of bytes.
+   * @param alignment supplies the required alignment, which must be a power of two no greater
+   *        than alignof(std::max_align_t).
+   * @return void* the memory.
+   */
+  void* allocate(size_t size, size_t alignment) {
+    ASSERT(alignment <= alignof(std::max_align_t) && (alignment & (alignment - 1)) == 0);
+    const uintptr_t start = (reinterpret_cast<uintptr_t>(next_) + alignment - 1) & ~(alignment - 1);
+    if (start + size > reinterpret_cast<uintptr_t>(end_) || next_ == nullptr) {
+      return allocateSlow(size);
+    }
+    next_ = reinterpret_cast<char*>(start + size);
+    allocations_++;
+    bytes_allocated_ += size;
+    return reinterpret_cast<void*>(start);
+  }
+
+  /**
+   * @return uint64_t the number of allocations made from the arena.
+   */
+  uint64_t allocations() const { return allocations_; }
+
+  /**
+   * @return uint64_t the number of bytes allocated from the arena, not including alignment padding.
+   */
+  uint64_t bytesAllocated() const { return bytes_allocated_; }
+
+  /**
+   * @return uint64_t the number of blocks the arena has allocated from the heap.
+   */
+  uint64_t heapBlocks() const { return heap_blocks_; }
+
+protected:
+  /**
+   * @param initial supplies memory to allocate from before going to the heap, which must outlive
+   *        the arena and be aligned to alignof(std::max_align_t). It may be nullptr.
+   * @param initial_size supplies the size of the initial memory.
+   */
+  Arena(void* initial, size_t initial_size)
+      : next_(static_cast<char*>(initial)), end_(next_ + initial_size) {}
+
+private:
+  // Heap blocks are linked through this header, which is padded to keep the memory following it
+  // aligned for any type.
+  struct alignas(alignof(std::max_align_t)) HeapBlock {
+    HeapBlock* next_;
+  };
+
+  void* allocateSlow(size_t size);
+
+  char* next_;
+  char* end_;
+  HeapBlock* heap_blocks_list_{};
+  uint64_t allocations_{};
+  uint64_t bytes_allocated_{};
+  uint64_t heap_blocks_{};
+};
+
+/**
+ * An arena which starts out allocating from storage inside itself, so that small uses of the arena
+ * need no heap allocation at all.
+ */
+template <size_t InlineSize> class InlineArena : public Arena {
+public:
+  InlineArena() : Arena(storage_, InlineSize) {}
+
+private:
+  alignas(alignof(std::max_align_t)) char storage_[InlineSize];
+};
+
+/**
+ * Deleter for objects constructed in an arena, which destroys the object but leaves its memory to
+ * be released with the arena.
+ */
+struct ArenaDeleter {
+  template <class T> void operator()(T* object) const { object->~T(); }
+};
+
+template <class T> using ArenaPtr = std::unique_ptr<T, ArenaDeleter>;
+
+/**
+ * Construct an object in an arena.
+ * @param arena supplies the arena.
+ * @param args supplies the constructor arguments.
+ * @return ArenaPtr<T> the object, which must be destroyed before the arena.
+ */
+template <class T, class... Args> ArenaPtr<T> makeArenaPtr(Arena& arena, Args&&... args) {
+  return ArenaPtr<T>(new (arena.allocate(sizeof(T), alignof(T))) T(std::forward<Args>(args)...));
+}
+
+/**
+ * Standard allocator which allocates from an arena, for containers whose lifetime is bounded by the
+ * arena's. Deallocation is a no-op.
+ */
+template <class T> class ArenaAllocator {
+public:
+  typedef T value_type;
+
+  explicit ArenaAllocator(Arena& arena) : arena_(&arena) {}
+  template <class U> ArenaAllocator(const ArenaAllocator<U>& other) : arena_(other.arena_) {}
+
+  T* allocate(size_t n) { return static_cast<T*>(arena_->allocate(n * sizeof(T), alignof(T))); }
+  void deallocate(T*, size_t) {}
+
+  template <class U> bool operator==(const ArenaAllocator<U>& other) const {
+    return arena_ == other.arena_;
+  }
+  template <class U> bool operator!=(const ArenaAllocator<U>& other) const {
+    return arena_ != other.arena_;
+  }
+
+private:
+  template <class U> friend class ArenaAllocator;
+
+  Arena* arena_;
+};
+
+} // namespace Envoy
@@ -0,0 +1,229 @@
+#pragma once
+
+#include <cstddef>
+#include <iterator>
+#include <memory>
+
+#include "common/common/assert.h"
+#include "common/common/non_copyable.h"
+
+namespace Envoy {
+
+template <class T> class IntrusiveList;
+
+/**
+ * Mixin class which embeds the links of an IntrusiveList in the object itself. It has the same
+ * interface as LinkedObject, but linking, unlinking and moving the object between lists allocate
+ * nothing, and walking a list reads the objects directly instead of list nodes which point to
+ * them. An object can only be in one list at a time.
+ */
+template <class T> class IntrusiveListItem {
+public:
+  typedef IntrusiveList<T> ListType;
+  typedef std::unique_ptr<T> PtrType;
+
+  /**
+   * @return whether the object is currently inserted into a list.
+   */
+  bool inserted() const { return list_ != nullptr; }
+
+  /**
+   * Move a linked item to the front of another list.
+   * @param list1 supplies the list the item is in.
+   * @param list2 supplies the list to move the item to.
+   */
+  void moveBetweenLists(ListType& list1, ListType& list2) {
+    ASSERT(list_ == &list1);
+    list1.unlink(*this);
+    list2.link(*this, list2.sentinel_.next_);
+  }
+
+  /**
+   * Move an item into a linked list at the front.
+   * @param item supplies the item to move in.
+   * @param list supplies the list to move the item into.
+   */
+  void moveIntoList(PtrType&& item, ListType& list) {
+    ASSERT(!inserted() && item.get() == this);
+    list.link(*item.release(), list.sentinel_.next_);
+  }
+
+  /**
+   * Move an item into a linked list at the back.
+   * @param item supplies the item to move in.
+   * @param list supplies the list to move the item into.
+   */
+  void moveIntoListBack(PtrType&& item, ListType& list) {
+    ASSERT(!inserted() && item.get() == this);
+    list.link(*item.release(), &list.sentinel_);
+  }
+
+  /**
+   * Remove this item from a list.
+   * @param list supplies the list to remove from. This item should be in this list.
+   * @return PtrType the item, which the list no longer owns.
+   */
+  PtrType removeFromList(ListType& list) {
+    ASSERT(list_ == &list);
+    list.unlink(*this);
+    return PtrType(static_cast<T*>(this));
+  }
+
+protected:
+  IntrusiveListItem() = default;
+  // Copies of an item are not in any list.
+  IntrusiveListItem(const IntrusiveListItem&) {}
+  IntrusiveListItem& operator=(const IntrusiveListItem&) { return *this; }
+  ~IntrusiveListItem() { ASSERT(!inserted()); }
+
+private:
+  friend class IntrusiveList<T>;
+
+  IntrusiveListItem* prev_{};
+  IntrusiveListItem* next_{};
+  ListType* list_{};
+};
+
+/**
+ * A doubly linked list of objects which embed their links by deriving from IntrusiveListItem. The
+ * list owns the objects in it, and deletes any which are left when it is destroyed. It has the
+ * subset of the std::list<std::unique_ptr<T>> interface used with LinkedObject, except that
+ * elements are reached as T* rather than as std::unique_ptr<T>&. All operations are O(1), except
+ * moving a list, which updates the owner of each of its items.
+ */
+template <class T> class IntrusiveList : NonCopyable {
+public:
+  typedef IntrusiveListItem<T> Item;
+
+  template <class ValueType, class ItemType> class IteratorBase {
+  public:
+    typedef std::bidirectional_iterator_tag iterator_category;
+    typedef ValueType value_type;
+    typedef std::ptrdiff_t difference_type;
+    typedef const ValueType* pointer;
+    typedef ValueType reference;
+
+    explicit IteratorBase(ItemType* item) : item_(item) {}
+
+    ValueType operator*() const { return static_cast<ValueType>(item_); }
+    ValueType operator->() const { return static_cast<ValueType>(item_); }
+    IteratorBase& operator++() {
+      item_ = item_->next_;
+      return *this;
+    }
+    IteratorBase operator++(int) {
+      IteratorBase previous = *this;
+      item_ = item_->next_;
+      return previous;
+    }
+    IteratorBase& operator--() {
+      item_ = item_->prev_;
+      return *this;
+    }
+    IteratorBase operator--(int) {
+      IteratorBase previous = *this;
+      item_ = item_->prev_;
+      return previous;
+    }
+    bool operator==(const IteratorBase& rhs) const { return item_ == rhs.item_; }
+    bool operator!=(const IteratorBase& rhs) const { return item_ != rhs.item_; }
+
+  private:
+    ItemType* item_;
+  };
+
+  // Iterators stay valid while other items are unlinked, so an item can be removed from the list
+  // after the iterator pointing to it has been advanced.
+  typedef IteratorBase<T*, Item> iterator;
+  typedef IteratorBase<const T*, const Item> const_iterator;
+
+  IntrusiveList() { sentinel_.prev_ = sentinel_.next_ = &sentinel_; }
+  IntrusiveList(IntrusiveList&& other) : IntrusiveList() { takeItems(other); }
+  IntrusiveList& operator=(IntrusiveList&& other) {
+    if (this != &other) {
+      clear();
+      takeItems(other);
+    }
+    return *this;
+  }
+  ~IntrusiveList() { clear(); }
+
+  iterator begin() { return iterator(sentinel_.next_); }
+  iterator end() { return iterator(&sentinel_); }
+  const_iterator begin() const { return const_iterator(sentinel_.next_); }
+  const_iterator end() const { return const_iterator(&sentinel_); }
+
+  bool empty() const { return size_ == 0; }
+  size_t size() const { return size_; }
+
+  T* front() {
+    ASSERT(!empty());
+    return static_cast<T*>(sentinel_.next_);
+  }
+  T* back() {
+    ASSERT(!empty());
+    return static_cast<T*>(sentinel_.prev_);
+  }
+
+  /**
+   * Remove and delete the item at the front of the list.
+   */
+  void pop_front() { front()->removeFromList(*this); }
+
+  /**
+   * Remove and delete the item at the back of the list.
+   */
+  void pop_back() { back()->removeFromList(*this); }
+
+  /**
+   * Remove and delete every item in the list.
+   */
+  void clear() {
+    while (!empty()) {
+      pop_front();
+    }
+  }
+
+private:
+  friend class IntrusiveListItem<T>;
+
+  // The sentinel is never a T, so it is only reached through end().
+  struct Sentinel : public Item {};
+
+  void link(Item& item, Item* next) {
+    item.prev_ = next->prev_;
+    item.next_ = next;
+    item.list_ = this;
+    next->prev_->next_ = &item;
+    next->prev_ = &item;
+    size_++;
+  }
+
+  void unlink(Item& item) {
+    item.prev_->next_ = item.next_;
+    item.next_->prev_ = item.prev_;
+    item.prev_ = item.next_ = nullptr;
+    item.list_ = nullptr;
+    size_--;
+  }
+
+  void takeItems(IntrusiveList& other) {
+    if (other.empty()) {
+      return;
+    }
+    sentinel_.next_ = other.sentinel_.next_;
+    sentinel_.prev_ = other.sentinel_.prev_;
+    sentinel_.next_->prev_ = sentinel_.prev_->next_ = &sentinel_;
+    size_ = other.size_;
+    for (Item* item = sentinel_.next_; item != &sentinel_; item = item->next_) {
+      item->list_ = this;
+    }
+    other.sentinel_.prev_ = other.sentinel_.next_ = &other.sentinel_;
+    other.size_ = 0;
+  }
+
+  Sentinel sentinel_;
+  size_t size_{};
+};
+
+} // namespace Envoy
@@ -0,0 +1,97 @@
+#include "common/common/regex.h"
+
+#include <algorithm>
+#include <atomic>
+
+#include "envoy/common/exception.h"
+
+#include "common/common/assert.h"
+#include "common/common/fmt.h"
+
+namespace Envoy {
+namespace Regex {
+namespace {
+
+re2::RE2::Options regexOptions() {
+  re2::RE2::Options options;
+  // Errors are reported through EnvoyException instead.
+  options.set_log_errors(false);
+  return options;
+}
+
+re2::StringPiece toStringPiece(absl::string_view value) {
+  return re2::StringPiece(value.data(), value.size());
+}
+
+std::atomic<uint32_t> configured_max_program_size{Utility::DefaultMaxProgramSize};
+
+} // namespace
+
+CompiledGoogleReMatcher::CompiledGoogleReMatcher(const std::string& regex,
+                                                 uint32_t max_program_size)
+    : regex_(regex, regexOptions()) {
+  if (!regex_.ok()) {
+    throw EnvoyException(fmt::format("Invalid regex '{}': {}", regex, regex_.error()));
+  }
+
+  const int program_size = regex_.ProgramSize();
+  if (program_size < 0 || static_cast<uint32_t>(program_size) > max_program_size) {
+    throw EnvoyException(fmt::format("Regex '{}' is too complex: program size {} exceeds {}", regex,
+                                     program_size, max_program_size));
+  }
+}
+
+bool CompiledGoogleReMatcher::match(absl::string_view value) const {
+  return re2::RE2::FullMatch(toStringPiece(value), regex_);
+}
+
+bool CompiledGoogleReMatcher::search(absl::string_view value) const {
+  return re2::RE2::PartialMatch(toStringPiece(value), regex_);
+}
+
+GoogleReSet::GoogleReSet() : set_(regexOptions(), re2::RE2::ANCHOR_BOTH) {}
+
+uint32_t GoogleReSet::add(const std::string& regex) {
+  std::string error;
+  const int index = set_.Add(toStringPiece(regex), &error);
+  if (index < 0) {
+    throw EnvoyException(fmt::format("Invalid regex '{}': {}", regex, error));
+  }
+  ASSERT(static_cast<uint32_t>(index) == size_);
+  return size_++;
+}
+
+void GoogleReSet::compile() {
+  if (!set_.Compile()) {
+    throw EnvoyException(fmt::format("Unable to compile set of {} regexes", size_));
+  }
+}
+
+bool GoogleReSet::match(absl::string_view value, std::vector<int>& matches) const {
+  matches.clear();
+  re2::RE2::Set::ErrorInfo error_info;
+  if (!set_.Match(toStringPiece(value), &matches, &error_info)) {
+    return error_info.kind == re2::RE2::Set::kNoError;
+  }
+  std::sort(matches.begin(), matches.end());
+  return true;
+}
+
+CompiledMatcherPtr Utility::parseRegex(const std::string& regex) {
+  return parseRegex(regex, maxProgramSize());
+}
+
+CompiledMatcherPtr Utility::parseRegex(const std::string& regex, uint32_t max_program_size) {
+  return std::make_unique<const CompiledGoogleReMatcher>(regex, max_program_size);
+}
+
+void Utility::setMaxProgramSize(uint32_t max_program_size) {
+  configured_max_program_size.store(max_program_size, std::memory_order_relaxed);
+}
+
+uint32_t Utility::maxProgramSize() {
+  return configured_max_program_size.load(std::memory_order_relaxed);
+}
+
+} // namespace Regex
+} // namespace Envoy
@@ -0,0 +1,119 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "envoy/common/regex.h"
+
+#include "re2/re2.h"
+#include "re2/set.h"
+
+namespace Envoy {
+namespace Regex {
+
+/**
+ * CompiledMatcher backed by RE2. RE2 compiles to an automaton and never backtracks, so matching
+ * time is linear in the size of the input regardless of the pattern.
+ */
+class CompiledGoogleReMatcher : public CompiledMatcher {
+public:
+  /**
+   * @param regex supplies the regular expression in RE2 syntax.
+   * @param max_program_size supplies the largest compiled program size that is accepted.
+   * @throw EnvoyException if the regex is invalid or its program size exceeds max_program_size.
+   */
+  CompiledGoogleReMatcher(const std::string& regex, uint32_t max_program_size);
+
+  // Regex::CompiledMatcher
+  bool match(absl::string_view value) const override;
+  bool search(absl::string_view value) const override;
+
+private:
+  const re2::RE2 regex_;
+};
+
+/**
+ * A set of regular expressions compiled by RE2 into a single automaton, so that a value can be
+ * matched against every regex in the set in one pass over the value.
+ */
+class GoogleReSet {
+public:
+  GoogleReSet();
+
+  /**
+   * Add a regex to the set. Must not be called after compile().
+   * @param regex supplies the regular expression in RE2 syntax.
+   * @return uint32_t the index of the regex within the set.
+   * @throw EnvoyException if the regex is invalid.
+   */
+  uint32_t add(const std::string& regex);
+
+  /**
+   * Compile the set. Must be called once after all regexes have been added and before match().
+   * @throw EnvoyException if the set can't be compiled.
+   */
+  void compile();
+
+  /**
+   * Find every regex in the set which matches the entire value.
+   * @param value supplies the value to match.
+   * @param matches supplies the vector that receives the indices of the matching regexes in
+   *        increasing order.
+   * @return bool false if the set couldn't be evaluated within its memory budget. In that case the
+   *         contents of matches are unspecified and the caller must match the regexes individually.
+   */
+  bool match(absl::string_view value, std::vector<int>& matches) const;
+
+  /**
+   * @return uint32_t the number of regexes in the set.
+   */
+  uint32_t size() const { return size_; }
+
+private:
+  re2::RE2::Set set_;
+  uint32_t size_{};
+};
+
+/**
+ * Utilities for constructing compiled regular expressions.
+ */
+class Utility {
+public:
+  // RE2's program size is a rough measure of the cost of evaluating a regex. Patterns from
+  // configuration which compile to larger programs than the limit are rejected. The default is
+  // generous enough for ordinary route patterns such as "(GET|POST|PUT)/[a-zA-Z0-9_]{1,32}".
+  static const uint32_t DefaultMaxProgramSize = 1000;
+
+  /**
+   * Compile a regular expression, limited to the program size set by setMaxProgramSize().
+   * @param regex supplies the regular expression in RE2 syntax.
+   * @return CompiledMatcherPtr the compiled regular expression.
+   * @throw EnvoyException if the regex is invalid or too complex.
+   */
+  static CompiledMatcherPtr parseRegex(const std::string& regex);
+
+  /**
+   * Compile a regular expression.
+   * @param regex supplies the regular expression in RE2 syntax.
+   * @param max_program_size supplies the largest compiled program size that is accepted.
+   * @return CompiledMatcherPtr the compiled regular expression.
+   * @throw EnvoyException if the regex is invalid or too complex.
+   */
+  static CompiledMatcherPtr parseRegex(const std::string& regex, uint32_t max_program_size);
+
+  /**
+   * Set the largest program size accepted by parseRegex(). This is configured from the bootstrap
+   * before any configuration is loaded.
+   * @param max_program_size supplies the largest compiled program size that is accepted.
+   */
+  static void setMaxProgramSize(uint32_t max_program_size);
+
+  /**
+   * @return uint32_t the largest program size accepted by parseRegex().
+   */
+  static uint32_t maxProgramSize();
+};
+
+} // namespace Regex
+} // namespace Envoy
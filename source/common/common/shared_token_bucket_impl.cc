@@ -0,0 +1,56 @@
+#include "common/common/shared_token_bucket_impl.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <limits>
+
+namespace Envoy {
+namespace {
+
+// Keeps sums of times well away from overflow, even for buckets which take centuries to fill.
+constexpr double MaxIntervalNs = static_cast<double>(std::numeric_limits<int64_t>::max() / 4);
+
+int64_t clampNs(double ns) { return static_cast<int64_t>(std::min(ns, MaxIntervalNs)); }
+
+} // namespace
+
+SharedTokenBucketImpl::SharedTokenBucketImpl(uint64_t max_tokens, TimeSource& time_source,
+                                             double fill_rate)
+    : time_source_(time_source),
+      token_interval_ns_(std::max<int64_t>(clampNs(1e9 / std::abs(fill_rate)), 1)),
+      capacity_ns_(clampNs(static_cast<double>(max_tokens) * token_interval_ns_)),
+      full_at_ns_(nowNs()) {}
+
+bool SharedTokenBucketImpl::consume(uint64_t tokens) {
+  const int64_t now = nowNs();
+  const int64_t cost = clampNs(static_cast<double>(tokens) * token_interval_ns_);
+  int64_t full_at = full_at_ns_.load(std::memory_order_relaxed);
+  while (true) {
+    const int64_t new_full_at = std::max(full_at, now) + cost;
+    if (new_full_at - now > capacity_ns_) {
+      return false;
+    }
+    if (full_at_ns_.compare_exchange_weak(full_at, new_full_at, std::memory_order_relaxed)) {
+      return true;
+    }
+  }
+}
+
+uint64_t SharedTokenBucketImpl::nextTokenAvailableMs() {
+  const int64_t now = nowNs();
+  const int64_t wait_ns =
+      full_at_ns_.load(std::memory_order_relaxed) + token_interval_ns_ - capacity_ns_ - now;
+  if (wait_ns <= 0) {
+    return 0;
+  }
+  return (wait_ns + 999999) / 1000000;
+}
+
+int64_t SharedTokenBucketImpl::nowNs() const {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             time_source_.monotonicTime().time_since_epoch())
+      .count();
+}
+
+} // namespace Envoy
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+#include "envoy/common/time.h"
+#include "envoy/common/token_bucket.h"
+
+namespace Envoy {
+
+/**
+ * A token bucket which can be shared by multiple threads without a lock. Rather than counting
+ * tokens, it keeps the time at which the bucket will be full again, which a consumer advances with
+ * a single compare and swap. This is the generic cell rate algorithm, which behaves like a bucket
+ * that is refilled continuously at the fill rate.
+ */
+class SharedTokenBucketImpl : public TokenBucket {
+public:
+  /**
+   * @see TokenBucketImpl.
+   */
+  SharedTokenBucketImpl(uint64_t max_tokens, TimeSource& time_source, double fill_rate = 1);
+
+  bool consume(uint64_t tokens = 1) override;
+
+  uint64_t nextTokenAvailableMs() override;
+
+private:
+  int64_t nowNs() const;
+
+  TimeSource& time_source_;
+  // The time it takes to fill in one token.
+  const int64_t token_interval_ns_;
+  // The time it takes to fill the whole bucket.
+  const int64_t capacity_ns_;
+  // The time at which the bucket will be full, if nothing more is consumed. An earlier time means
+  // the bucket is full.
+  std::atomic<int64_t> full_at_ns_;
+};
+
+} // namespace Envoy
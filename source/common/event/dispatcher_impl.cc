@@ -10,8 +10,8 @@
 #include "envoy/network/listener.h"
 
 #include "common/buffer/buffer_impl.h"
-#include "common/common/lock_guard.h"
 #include "common/event/file_event_impl.h"
+#include "common/event/loop_stats.h"
 #include "common/event/signal_impl.h"
 #include "common/filesystem/watcher_impl.h"
 #include "common/network/connection_impl.h"
@@ -23,6 +23,16 @@
 namespace Envoy {
 namespace Event {
 
+namespace {
+
+// The operations each dispatcher may queue between two submissions to its ring. More are submitted
+// early rather than failing.
+constexpr uint32_t IoUringEntries = 256;
+
+} // namespace
+
+bool DispatcherImpl::use_io_uring_ = false;
+
 DispatcherImpl::DispatcherImpl(TimeSystem& time_system)
     : DispatcherImpl(time_system, Buffer::WatermarkFactoryPtr{new Buffer::WatermarkBufferFactory}) {
   // The dispatcher won't work as expected if libevent hasn't been configured to use threads.
@@ -31,15 +41,44 @@ DispatcherImpl::DispatcherImpl(TimeSystem& time_system)
 
 DispatcherImpl::DispatcherImpl(TimeSystem& time_system, Buffer::WatermarkFactoryPtr&& factory)
     : time_system_(time_system), buffer_factory_(std::move(factory)), base_(event_base_new()),
-      scheduler_(time_system_.createScheduler(base_)),
+      scheduler_(time_system_.createScheduler(base_)), timed_scheduler_(*this),
+      timer_wheel_(time_system_, timed_scheduler_, CoarseTimerResolution),
       deferred_delete_timer_(createTimer([this]() -> void { clearDeferredDeleteList(); })),
-      post_timer_(createTimer([this]() -> void { runPostCallbacks(); })),
+      post_timer_(scheduler_->createTimer([this]() -> void {
+        LoopStats::EventScope scope(loop_stats_.get(), LoopStats::EventType::Post);
+        runPostCallbacks();
+      })),
       current_to_delete_(&to_delete_1_) {
   RELEASE_ASSERT(Libevent::Global::initialized(), "");
+  if (use_io_uring_) {
+    io_uring_ = IoUringImpl::create(*this, IoUringEntries);
+    if (io_uring_ == nullptr) {
+      ENVOY_LOG(warn, "io_uring could not be set up, sockets are read and written with libevent");
+    }
+  }
 }
 
 DispatcherImpl::~DispatcherImpl() {}
 
+bool DispatcherImpl::useIoUring(bool use_io_uring) {
+  use_io_uring_ = use_io_uring && IoUringImpl::isSupported();
+  if (use_io_uring && !use_io_uring_) {
+    ENVOY_LOG(warn, "io_uring is not supported by the kernel, sockets are read and written with "
+                    "libevent");
+  }
+  return use_io_uring_;
+}
+
+void DispatcherImpl::initializeStats(Stats::Scope& scope, const std::string& prefix) {
+  const std::string stats_prefix = prefix + "dispatcher.";
+  loop_stats_ = std::make_unique<LoopStats>(
+      time_system_,
+      DispatcherStats{ALL_DISPATCHER_STATS(POOL_COUNTER_PREFIX(scope, stats_prefix),
+                                           POOL_HISTOGRAM_PREFIX(scope, stats_prefix))});
+  timer_wheel_.setLagCallback(
+      [this](MonotonicTime::duration lag) -> void { loop_stats_->onTimerLag(lag); });
+}
+
 void DispatcherImpl::clearDeferredDeleteList() {
   ASSERT(isThreadSafe());
   std::vector<DeferredDeletablePtr>* to_delete = current_to_delete_;
@@ -90,6 +129,14 @@ DispatcherImpl::createClientConnection(Network::Address::InstanceConstSharedPtr
                                                          std::move(transport_socket), options);
 }
 
+Network::ClientConnectionPtr
+DispatcherImpl::adoptClientConnection(Network::ConnectionSocketPtr&& socket,
+                                      Network::TransportSocketPtr&& transport_socket) {
+  ASSERT(isThreadSafe());
+  return std::make_unique<Network::ClientConnectionImpl>(*this, std::move(socket),
+                                                         std::move(transport_socket));
+}
+
 Network::DnsResolverSharedPtr DispatcherImpl::createDnsResolver(
     const std::vector<Network::Address::InstanceConstSharedPtr>& resolvers) {
   ASSERT(isThreadSafe());
@@ -99,7 +146,13 @@ Network::DnsResolverSharedPtr DispatcherImpl::createDnsResolver(
 FileEventPtr DispatcherImpl::createFileEvent(int fd, FileReadyCb cb, FileTriggerType trigger,
                                              uint32_t events) {
   ASSERT(isThreadSafe());
-  return FileEventPtr{new FileEventImpl(*this, fd, cb, trigger, events)};
+  return FileEventPtr{new FileEventImpl(
+      *this, fd,
+      [this, cb](uint32_t events) -> void {
+        LoopStats::EventScope scope(loop_stats_.get(), LoopStats::EventType::FileEvent);
+        cb(events);
+      },
+      trigger, events)};
 }
 
 Filesystem::WatcherPtr DispatcherImpl::createFilesystemWatcher() {
@@ -109,15 +162,25 @@ Filesystem::WatcherPtr DispatcherImpl::createFilesystemWatcher() {
 
 Network::ListenerPtr
 DispatcherImpl::createListener(Network::Socket& socket, Network::ListenerCallbacks& cb,
-                               bool bind_to_port, bool hand_off_restored_destination_connections) {
+                               bool bind_to_port, bool hand_off_restored_destination_connections,
+                               uint32_t max_accepts_per_wakeup) {
   ASSERT(isThreadSafe());
   return Network::ListenerPtr{new Network::ListenerImpl(*this, socket, cb, bind_to_port,
-                                                        hand_off_restored_destination_connections)};
+                                                        hand_off_restored_destination_connections,
+                                                        max_accepts_per_wakeup)};
 }
 
 TimerPtr DispatcherImpl::createTimer(TimerCb cb) {
   ASSERT(isThreadSafe());
-  return scheduler_->createTimer(cb);
+  return timed_scheduler_.createTimer(cb);
+}
+
+TimerPtr DispatcherImpl::createTimer(TimerCb cb, TimerResolution resolution) {
+  ASSERT(isThreadSafe());
+  if (resolution == TimerResolution::Coarse) {
+    return timer_wheel_.createTimer(cb);
+  }
+  return timed_scheduler_.createTimer(cb);
 }
 
 void DispatcherImpl::deferredDelete(DeferredDeletablePtr&& to_delete) {
@@ -137,14 +200,10 @@ SignalEventPtr DispatcherImpl::listenForSignal(int signal_num, SignalCb cb) {
 }
 
 void DispatcherImpl::post(std::function<void()> callback) {
-  bool do_post;
-  {
-    Thread::LockGuard lock(post_lock_);
-    do_post = post_callbacks_.empty();
-    post_callbacks_.push_back(callback);
-  }
-
-  if (do_post) {
+  if (post_callbacks_.push(std::move(callback))) {
+    if (loop_stats_ != nullptr) {
+      loop_stats_->onPostQueued();
+    }
     post_timer_->enableTimer(std::chrono::milliseconds(0));
   }
 }
@@ -158,29 +217,45 @@ void DispatcherImpl::run(RunType type) {
   // event_base_once() before some other event, the other event might get called first.
   runPostCallbacks();
 
-  event_base_loop(base_.get(), type == RunType::NonBlock ? EVLOOP_NONBLOCK : 0);
-}
+  if (loop_stats_ == nullptr) {
+    event_base_loop(base_.get(), type == RunType::NonBlock ? EVLOOP_NONBLOCK : 0);
+    return;
+  }
 
-void DispatcherImpl::runPostCallbacks() {
+  // Run the loop an iteration at a time, so that each iteration can be recorded. This stops in the
+  // same cases as a single blocking event_base_loop(): on exit() and once there are no events.
+  if (type == RunType::NonBlock) {
+    event_base_loop(base_.get(), EVLOOP_NONBLOCK);
+    loop_stats_->onIterationEnd();
+    return;
+  }
   while (true) {
-    // It is important that this declaration is inside the body of the loop so that the callback is
-    // destructed while post_lock_ is not held. If callback is declared outside the loop and reused
-    // for each iteration, the previous iteration's callback is destructed when callback is
-    // re-assigned, which happens while holding the lock. This can lead to a deadlock (via
-    // recursive mutex acquisition) if destroying the callback runs a destructor, which through some
-    // callstack calls post() on this dispatcher.
-    std::function<void()> callback;
-    {
-      Thread::LockGuard lock(post_lock_);
-      if (post_callbacks_.empty()) {
-        return;
-      }
-      callback = post_callbacks_.front();
-      post_callbacks_.pop_front();
+    const int result = event_base_loop(base_.get(), EVLOOP_ONCE);
+    loop_stats_->onIterationEnd();
+    if (result != 0 || event_base_got_exit(base_.get()) || event_base_got_break(base_.get())) {
+      return;
     }
-    callback();
   }
 }
 
+void DispatcherImpl::runPostCallbacks() {
+  if (loop_stats_ == nullptr) {
+    post_callbacks_.runAll();
+    return;
+  }
+  loop_stats_->onPostRun();
+  const uint64_t run = post_callbacks_.runAll();
+  if (run > 0) {
+    loop_stats_->stats().post_queue_depth_.recordValue(run);
+  }
+}
+
+TimerPtr DispatcherImpl::TimedScheduler::createTimer(const TimerCb& cb) {
+  return dispatcher_.scheduler_->createTimer([this, cb]() -> void {
+    LoopStats::EventScope scope(dispatcher_.loop_stats_.get(), LoopStats::EventType::Timer);
+    cb();
+  });
+}
+
 } // namespace Event
 } // namespace Envoy
@@ -2,7 +2,8 @@
 
 #include <cstdint>
 #include <functional>
-#include <list>
+#include <memory>
+#include <string>
 #include <vector>
 
 #include "envoy/common/time.h"
@@ -12,7 +13,11 @@
 
 #include "common/common/logger.h"
 #include "common/common/thread.h"
+#include "common/event/io_uring_impl.h"
 #include "common/event/libevent.h"
+#include "common/event/loop_stats.h"
+#include "common/event/post_queue.h"
+#include "common/event/timer_wheel.h"
 
 namespace Envoy {
 namespace Event {
@@ -31,9 +36,18 @@ public:
    */
   event_base& base() { return *base_; }
 
+  /**
+   * Select whether dispatchers constructed from now on read and write sockets through an io_uring.
+   * Nothing changes if the kernel does not support it, or a dispatcher fails to set its ring up.
+   * @param use_io_uring supplies whether to use io_uring.
+   * @return bool whether io_uring is used.
+   */
+  static bool useIoUring(bool use_io_uring);
+
   // Event::Dispatcher
   TimeSystem& timeSystem() override { return time_system_; }
   void clearDeferredDeleteList() override;
+  void initializeStats(Stats::Scope& scope, const std::string& prefix) override;
   Network::ConnectionPtr
   createServerConnection(Network::ConnectionSocketPtr&& socket,
                          Network::TransportSocketPtr&& transport_socket) override;
@@ -42,6 +56,9 @@ public:
                          Network::Address::InstanceConstSharedPtr source_address,
                          Network::TransportSocketPtr&& transport_socket,
                          const Network::ConnectionSocket::OptionsSharedPtr& options) override;
+  Network::ClientConnectionPtr
+  adoptClientConnection(Network::ConnectionSocketPtr&& socket,
+                        Network::TransportSocketPtr&& transport_socket) override;
   Network::DnsResolverSharedPtr createDnsResolver(
       const std::vector<Network::Address::InstanceConstSharedPtr>& resolvers) override;
   FileEventPtr createFileEvent(int fd, FileReadyCb cb, FileTriggerType trigger,
@@ -49,16 +66,31 @@ public:
   Filesystem::WatcherPtr createFilesystemWatcher() override;
   Network::ListenerPtr createListener(Network::Socket& socket, Network::ListenerCallbacks& cb,
                                       bool bind_to_port,
-                                      bool hand_off_restored_destination_connections) override;
+                                      bool hand_off_restored_destination_connections,
+                                      uint32_t max_accepts_per_wakeup) override;
   TimerPtr createTimer(TimerCb cb) override;
+  TimerPtr createTimer(TimerCb cb, TimerResolution resolution) override;
   void deferredDelete(DeferredDeletablePtr&& to_delete) override;
   void exit() override;
   SignalEventPtr listenForSignal(int signal_num, SignalCb cb) override;
   void post(std::function<void()> callback) override;
   void run(RunType type) override;
   Buffer::WatermarkFactory& getWatermarkFactory() override { return *buffer_factory_; }
+  IoUring* ioUring() override { return io_uring_.get(); }
 
 private:
+  // Creates timers whose callbacks are timed once the loop stats are initialized.
+  class TimedScheduler : public Scheduler {
+  public:
+    explicit TimedScheduler(DispatcherImpl& dispatcher) : dispatcher_(dispatcher) {}
+
+    // Event::Scheduler
+    TimerPtr createTimer(const TimerCb& cb) override;
+
+  private:
+    DispatcherImpl& dispatcher_;
+  };
+
   void runPostCallbacks();
 
   // Validate that an operation is thread safe, i.e. it's invoked on the same thread that the
@@ -73,14 +105,21 @@ private:
   Buffer::WatermarkFactoryPtr buffer_factory_;
   Libevent::BasePtr base_;
   SchedulerPtr scheduler_;
+  TimedScheduler timed_scheduler_;
+  TimerWheel timer_wheel_;
+  // Declared ahead of the deferred delete lists, so that connections waiting to be deleted are
+  // destroyed while their ring is still there.
+  IoUringImplPtr io_uring_;
   TimerPtr deferred_delete_timer_;
   TimerPtr post_timer_;
   std::vector<DeferredDeletablePtr> to_delete_1_;
   std::vector<DeferredDeletablePtr> to_delete_2_;
   std::vector<DeferredDeletablePtr>* current_to_delete_;
-  Thread::MutexBasicLockable post_lock_;
-  std::list<std::function<void()>> post_callbacks_ GUARDED_BY(post_lock_);
+  PostQueue post_callbacks_;
   bool deferred_deleting_{};
+  std::unique_ptr<LoopStats> loop_stats_;
+
+  static bool use_io_uring_;
 };
 
 } // namespace Event
@@ -0,0 +1,333 @@
+#include "common/event/io_uring_impl.h"
+
+#include <sys/eventfd.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <vector>
+
+#include "common/common/assert.h"
+#include "common/common/fmt.h"
+
+namespace Envoy {
+namespace Event {
+
+#ifdef ENVOY_IO_URING
+
+namespace {
+
+// Completions must be queued rather than dropped when the completion ring is full, and receiving
+// must wait for data by polling the socket rather than by blocking a kernel worker thread.
+constexpr uint32_t RequiredFeatures = IORING_FEAT_NODROP | IORING_FEAT_FAST_POLL;
+
+// Completions may pile up while the dispatcher is busy, so the completion ring is larger than the
+// submission ring.
+constexpr uint32_t CompletionsPerEntry = 8;
+
+int ioUringSetup(uint32_t entries, io_uring_params& params) {
+  return syscall(__NR_io_uring_setup, entries, &params);
+}
+
+int ioUringEnter(int ring_fd, uint32_t to_submit, uint32_t min_complete, uint32_t flags) {
+  return syscall(__NR_io_uring_enter, ring_fd, to_submit, min_complete, flags, nullptr, 0);
+}
+
+int ioUringRegister(int ring_fd, uint32_t opcode, const void* arg, uint32_t nr_args) {
+  return syscall(__NR_io_uring_register, ring_fd, opcode, arg, nr_args);
+}
+
+// The fields the kernel moves are read with acquire ordering, so that the entries it wrote before
+// moving them are seen, and the ones the ring moves are written with release ordering, so that the
+// kernel sees the entries written before them.
+uint32_t loadAcquire(const uint32_t* field) { return __atomic_load_n(field, __ATOMIC_ACQUIRE); }
+void storeRelease(uint32_t* field, uint32_t value) {
+  __atomic_store_n(field, value, __ATOMIC_RELEASE);
+}
+
+} // namespace
+
+bool IoUringImpl::isSupported() {
+  static const bool supported = []() {
+    io_uring_params params;
+    memset(&params, 0, sizeof(params));
+    const int ring_fd = ioUringSetup(2, params);
+    if (ring_fd == -1) {
+      return false;
+    }
+    ::close(ring_fd);
+    return (params.features & RequiredFeatures) == RequiredFeatures;
+  }();
+  return supported;
+}
+
+IoUringImplPtr IoUringImpl::create(Dispatcher& dispatcher, uint32_t entries) {
+  io_uring_params params;
+  memset(&params, 0, sizeof(params));
+  params.flags = IORING_SETUP_CQSIZE;
+  params.cq_entries = entries * CompletionsPerEntry;
+  const int ring_fd = ioUringSetup(entries, params);
+  if (ring_fd == -1) {
+    ENVOY_LOG(warn, "io_uring setup failed: {}", strerror(errno));
+    return nullptr;
+  }
+
+  IoUringImplPtr ring(new IoUringImpl(ring_fd, params));
+  if ((params.features & RequiredFeatures) != RequiredFeatures) {
+    ENVOY_LOG(warn, "io_uring lacks required features: {:#x}", params.features);
+    return nullptr;
+  }
+  if (!ring->mapRings(params) || !ring->watchCompletions(dispatcher)) {
+    return nullptr;
+  }
+  return ring;
+}
+
+IoUringImpl::IoUringImpl(int ring_fd, const io_uring_params& params)
+    : ring_fd_(ring_fd), sq_entries_(params.sq_entries) {}
+
+IoUringImpl::~IoUringImpl() {
+  if (file_event_ != nullptr) {
+    // The kernel may still use the memory of the requests which have not completed, so they are
+    // cancelled and waited for rather than dropped.
+    std::vector<IoUringRequest*> pending;
+    for (const auto& request : requests_) {
+      pending.push_back(request.first);
+    }
+    for (IoUringRequest* request : pending) {
+      cancel(*request);
+    }
+    while (!requests_.empty()) {
+      enter(true);
+      reap();
+    }
+    file_event_.reset();
+  }
+
+  if (sqes_ != nullptr) {
+    ::munmap(sqes_, sqes_size_);
+  }
+  if (cq_ring_ != nullptr && cq_ring_ != sq_ring_) {
+    ::munmap(cq_ring_, cq_ring_size_);
+  }
+  if (sq_ring_ != nullptr) {
+    ::munmap(sq_ring_, sq_ring_size_);
+  }
+  if (event_fd_ != -1) {
+    ::close(event_fd_);
+  }
+  ::close(ring_fd_);
+}
+
+bool IoUringImpl::mapRings(const io_uring_params& params) {
+  sq_ring_size_ = params.sq_off.array + params.sq_entries * sizeof(uint32_t);
+  cq_ring_size_ = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+  const bool single_mmap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+  if (single_mmap) {
+    sq_ring_size_ = cq_ring_size_ = std::max(sq_ring_size_, cq_ring_size_);
+  }
+
+  void* sq_ring = ::mmap(nullptr, sq_ring_size_, PROT_READ | PROT_WRITE,
+                         MAP_SHARED | MAP_POPULATE, ring_fd_, IORING_OFF_SQ_RING);
+  if (sq_ring == MAP_FAILED) {
+    ENVOY_LOG(warn, "io_uring submission ring mmap failed: {}", strerror(errno));
+    return false;
+  }
+  sq_ring_ = sq_ring;
+
+  if (single_mmap) {
+    cq_ring_ = sq_ring_;
+  } else {
+    void* cq_ring = ::mmap(nullptr, cq_ring_size_, PROT_READ | PROT_WRITE,
+                           MAP_SHARED | MAP_POPULATE, ring_fd_, IORING_OFF_CQ_RING);
+    if (cq_ring == MAP_FAILED) {
+      ENVOY_LOG(warn, "io_uring completion ring mmap failed: {}", strerror(errno));
+      return false;
+    }
+    cq_ring_ = cq_ring;
+  }
+
+  sqes_size_ = params.sq_entries * sizeof(io_uring_sqe);
+  void* sqes = ::mmap(nullptr, sqes_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                      ring_fd_, IORING_OFF_SQES);
+  if (sqes == MAP_FAILED) {
+    ENVOY_LOG(warn, "io_uring submission entries mmap failed: {}", strerror(errno));
+    return false;
+  }
+  sqes_ = static_cast<io_uring_sqe*>(sqes);
+
+  char* sq = static_cast<char*>(sq_ring_);
+  sq_head_ = reinterpret_cast<uint32_t*>(sq + params.sq_off.head);
+  sq_tail_ = reinterpret_cast<uint32_t*>(sq + params.sq_off.tail);
+  sq_flags_ = reinterpret_cast<uint32_t*>(sq + params.sq_off.flags);
+  sq_array_ = reinterpret_cast<uint32_t*>(sq + params.sq_off.array);
+  sq_mask_ = *reinterpret_cast<uint32_t*>(sq + params.sq_off.ring_mask);
+  char* cq = static_cast<char*>(cq_ring_);
+  cq_head_ = reinterpret_cast<uint32_t*>(cq + params.cq_off.head);
+  cq_tail_ = reinterpret_cast<uint32_t*>(cq + params.cq_off.tail);
+  cqes_ = reinterpret_cast<io_uring_cqe*>(cq + params.cq_off.cqes);
+  cq_mask_ = *reinterpret_cast<uint32_t*>(cq + params.cq_off.ring_mask);
+  return true;
+}
+
+bool IoUringImpl::watchCompletions(Dispatcher& dispatcher) {
+  event_fd_ = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+  if (event_fd_ == -1 || ioUringRegister(ring_fd_, IORING_REGISTER_EVENTFD, &event_fd_, 1) == -1) {
+    ENVOY_LOG(warn, "io_uring eventfd registration failed: {}", strerror(errno));
+    return false;
+  }
+
+  // The eventfd is never read. It is edge triggered, so each time the kernel signals it for new
+  // completions is reported, whatever its count.
+  file_event_ = dispatcher.createFileEvent(
+      event_fd_, [this](uint32_t) -> void { onEvent(); }, FileTriggerType::Edge,
+      FileReadyType::Read);
+  return true;
+}
+
+IoUringRequest& IoUringImpl::recv(int fd, void* buffer, uint32_t length,
+                                  IoUringRequestPtr&& request) {
+  io_uring_sqe& entry = nextEntry();
+  entry.opcode = IORING_OP_RECV;
+  entry.fd = fd;
+  entry.addr = reinterpret_cast<uint64_t>(buffer);
+  entry.len = length;
+  return queue(entry, std::move(request));
+}
+
+IoUringRequest& IoUringImpl::sendmsg(int fd, const msghdr& message, IoUringRequestPtr&& request) {
+  io_uring_sqe& entry = nextEntry();
+  entry.opcode = IORING_OP_SENDMSG;
+  entry.fd = fd;
+  entry.addr = reinterpret_cast<uint64_t>(&message);
+  entry.len = 1;
+  // Kernels which can keep sending until the whole message is sent do so, rather than completing
+  // with a partial send when the socket buffer fills up.
+  entry.msg_flags = MSG_NOSIGNAL | MSG_WAITALL;
+  return queue(entry, std::move(request));
+}
+
+void IoUringImpl::cancel(IoUringRequest& request) {
+  ASSERT(requests_.count(&request) == 1);
+  io_uring_sqe& entry = nextEntry();
+  entry.opcode = IORING_OP_ASYNC_CANCEL;
+  entry.addr = reinterpret_cast<uint64_t>(&request);
+  // The cancellation's own completion is skipped by reap().
+  entry.user_data = 0;
+  push();
+}
+
+io_uring_sqe& IoUringImpl::nextEntry() {
+  if (*sq_tail_ - loadAcquire(sq_head_) == sq_entries_) {
+    enter(false);
+  }
+  const uint32_t index = *sq_tail_ & sq_mask_;
+  io_uring_sqe& entry = sqes_[index];
+  memset(&entry, 0, sizeof(entry));
+  sq_array_[index] = index;
+  return entry;
+}
+
+IoUringRequest& IoUringImpl::queue(io_uring_sqe& entry, IoUringRequestPtr&& request) {
+  IoUringRequest& queued = *request;
+  entry.user_data = reinterpret_cast<uint64_t>(&queued);
+  requests_.emplace(&queued, std::move(request));
+  push();
+  return queued;
+}
+
+void IoUringImpl::push() {
+  storeRelease(sq_tail_, *sq_tail_ + 1);
+  // The first entry queued since the last submission schedules the ring's event, which submits
+  // everything queued by the events handled before it.
+  if (to_submit_++ == 0) {
+    file_event_->activate(FileReadyType::Read);
+  }
+}
+
+void IoUringImpl::enter(bool wait) {
+  while (to_submit_ > 0 || wait) {
+    const int rc = ioUringEnter(ring_fd_, to_submit_, wait ? 1 : 0,
+                                wait ? IORING_ENTER_GETEVENTS : 0);
+    if (rc == -1) {
+      if (errno == EINTR) {
+        continue;
+      }
+      // The kernel takes no more entries while it holds completions which did not fit in the
+      // completion ring, until some of the ring's are reaped.
+      RELEASE_ASSERT(errno == EBUSY || errno == EAGAIN,
+                     fmt::format("io_uring_enter failed: {}", strerror(errno)));
+      reap();
+      continue;
+    }
+    to_submit_ -= rc;
+    wait = false;
+  }
+}
+
+void IoUringImpl::submit() { enter(false); }
+
+void IoUringImpl::onEvent() {
+  enter(false);
+  reap();
+#ifdef IORING_SQ_CQ_OVERFLOW
+  // Completions which did not fit in the completion ring are only moved into it by entering the
+  // kernel.
+  while (loadAcquire(sq_flags_) & IORING_SQ_CQ_OVERFLOW) {
+    ioUringEnter(ring_fd_, 0, 0, IORING_ENTER_GETEVENTS);
+    reap();
+  }
+#endif
+}
+
+void IoUringImpl::reap() {
+  // The head is re-read for each completion, as a completion callback may queue entries, which
+  // reaps when the kernel is holding completions back.
+  while (true) {
+    const uint32_t head = *cq_head_;
+    if (head == loadAcquire(cq_tail_)) {
+      break;
+    }
+    const io_uring_cqe& completion = cqes_[head & cq_mask_];
+    IoUringRequest* key = reinterpret_cast<IoUringRequest*>(completion.user_data);
+    const int32_t result = completion.res;
+    storeRelease(cq_head_, head + 1);
+    if (key == nullptr) {
+      continue;
+    }
+
+    auto it = requests_.find(key);
+    ASSERT(it != requests_.end());
+    IoUringRequestPtr request = std::move(it->second);
+    requests_.erase(it);
+    request->onCompletion(result);
+  }
+}
+
+#else
+
+bool IoUringImpl::isSupported() { return false; }
+
+IoUringImplPtr IoUringImpl::create(Dispatcher&, uint32_t) { return nullptr; }
+
+IoUringImpl::~IoUringImpl() {}
+
+IoUringRequest& IoUringImpl::recv(int, void*, uint32_t, IoUringRequestPtr&&) {
+  NOT_REACHED_GCOVR_EXCL_LINE;
+}
+
+IoUringRequest& IoUringImpl::sendmsg(int, const msghdr&, IoUringRequestPtr&&) {
+  NOT_REACHED_GCOVR_EXCL_LINE;
+}
+
+void IoUringImpl::cancel(IoUringRequest&) { NOT_REACHED_GCOVR_EXCL_LINE; }
+
+void IoUringImpl::submit() { NOT_REACHED_GCOVR_EXCL_LINE; }
+
+#endif
+
+} // namespace Event
+} // namespace Envoy
@@ -0,0 +1,128 @@
+#pragma once
+
+#include <sys/socket.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+
+#include "envoy/event/dispatcher.h"
+#include "envoy/event/file_event.h"
+#include "envoy/event/io_uring.h"
+
+#include "common/common/logger.h"
+#include "common/common/non_copyable.h"
+
+// The ring needs the kernel's io_uring definitions, from the release (5.7) which added the poll
+// that receiving waits with.
+#if defined(__linux__) && defined(__has_include)
+#if __has_include(<linux/io_uring.h>)
+#include <linux/io_uring.h>
+#ifdef IORING_FEAT_FAST_POLL
+#define ENVOY_IO_URING 1
+#endif
+#endif
+#endif
+
+namespace Envoy {
+namespace Event {
+
+class IoUringImpl;
+typedef std::unique_ptr<IoUringImpl> IoUringImplPtr;
+
+/**
+ * io_uring set up with the system calls directly. Submissions and completions are exchanged with
+ * the kernel through rings shared with it: operations are written to the submission ring, and
+ * handed to the kernel by a single io_uring_enter() when the dispatcher gets to the ring's event,
+ * after the events which were already active. The kernel signals an eventfd watched by the
+ * dispatcher when it posts completions, so they are handled like any other event and nothing in
+ * the dispatcher has to wait on the ring itself.
+ *
+ * Only the data path of plaintext sockets goes through the ring so far. Accepts, connects and
+ * timers are still driven by libevent, and raw_buffer_socket_speed_test only compares the two
+ * backends on loopback round trips. Moving accepts and timers to the ring, and benchmarking the
+ * echo and HTTP integration fixtures on both backends, are separate follow-up work.
+ */
+class IoUringImpl : public IoUring, NonCopyable, Logger::Loggable<Logger::Id::main> {
+public:
+  /**
+   * @return bool whether the kernel has io_uring with everything the ring uses. The check is done
+   *         once, by setting up a small ring.
+   */
+  static bool isSupported();
+
+  /**
+   * Set up a ring for a dispatcher.
+   * @param dispatcher supplies the dispatcher which handles the ring's completions.
+   * @param entries supplies the number of operations which may be queued between submissions.
+   * @return IoUringImplPtr the ring, or nullptr if it could not be set up.
+   */
+  static IoUringImplPtr create(Dispatcher& dispatcher, uint32_t entries);
+
+  // Cancels the requests which have not completed, and waits for them to complete.
+  ~IoUringImpl();
+
+  // Event::IoUring
+  IoUringRequest& recv(int fd, void* buffer, uint32_t length,
+                       IoUringRequestPtr&& request) override;
+  IoUringRequest& sendmsg(int fd, const msghdr& message, IoUringRequestPtr&& request) override;
+  void cancel(IoUringRequest& request) override;
+  void submit() override;
+
+  /**
+   * @return uint64_t the number of requests which have not completed.
+   */
+  uint64_t pendingRequests() const { return requests_.size(); }
+
+private:
+#ifdef ENVOY_IO_URING
+  IoUringImpl(int ring_fd, const io_uring_params& params);
+
+  bool mapRings(const io_uring_params& params);
+  bool watchCompletions(Dispatcher& dispatcher);
+  // Returns the next free entry of the submission ring, handing the queued ones to the kernel if
+  // the ring is full.
+  io_uring_sqe& nextEntry();
+  IoUringRequest& queue(io_uring_sqe& entry, IoUringRequestPtr&& request);
+  // Makes the entry written last visible to the kernel, to be handed to it by the next submission.
+  void push();
+  // Hands the queued entries to the kernel, optionally waiting for a completion.
+  void enter(bool wait);
+  void onEvent();
+  void reap();
+
+  const int ring_fd_;
+  int event_fd_{-1};
+  FileEventPtr file_event_;
+
+  void* sq_ring_{};
+  size_t sq_ring_size_{};
+  void* cq_ring_{};
+  size_t cq_ring_size_{};
+  io_uring_sqe* sqes_{};
+  size_t sqes_size_{};
+
+  // The fields of the rings shared with the kernel. The kernel moves the head of the submission
+  // ring and the tail of the completion ring, and the ring moves the others.
+  uint32_t* sq_head_{};
+  uint32_t* sq_tail_{};
+  uint32_t* sq_flags_{};
+  uint32_t* sq_array_{};
+  uint32_t sq_mask_{};
+  uint32_t sq_entries_{};
+  uint32_t* cq_head_{};
+  uint32_t* cq_tail_{};
+  io_uring_cqe* cqes_{};
+  uint32_t cq_mask_{};
+
+  // Entries queued but not handed to the kernel yet.
+  uint32_t to_submit_{};
+#endif
+
+  // The requests which have not completed, by the address the kernel passes back on completion.
+  std::unordered_map<IoUringRequest*, IoUringRequestPtr> requests_;
+};
+
+} // namespace Event
+} // namespace Envoy
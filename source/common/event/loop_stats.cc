@@ -0,0 +1,80 @@
+#include "common/event/loop_stats.h"
+
+#include <algorithm>
+#include <chrono>
+
+namespace Envoy {
+namespace Event {
+
+namespace {
+
+uint64_t toMicroseconds(MonotonicTime::duration duration) {
+  return std::max<int64_t>(
+      std::chrono::duration_cast<std::chrono::microseconds>(duration).count(), 0);
+}
+
+} // namespace
+
+LoopStats::LoopStats(TimeSource& time_source, const DispatcherStats& stats)
+    : time_source_(time_source), stats_(stats) {}
+
+void LoopStats::beforeEvent() {
+  if (!in_iteration_) {
+    in_iteration_ = true;
+    iteration_start_ = last_event_end_ = time_source_.monotonicTime();
+  }
+}
+
+void LoopStats::afterEvent(EventType type) {
+  if (!in_iteration_) {
+    // The iteration was ended by a nested run of the loop.
+    return;
+  }
+  const MonotonicTime now = time_source_.monotonicTime();
+  event_time_[static_cast<size_t>(type)] += now - last_event_end_;
+  last_event_end_ = now;
+  iteration_events_++;
+}
+
+void LoopStats::onIterationEnd() {
+  if (!in_iteration_) {
+    return;
+  }
+  in_iteration_ = false;
+  stats_.loop_duration_us_.recordValue(toMicroseconds(last_event_end_ - iteration_start_));
+  stats_.loop_events_.recordValue(iteration_events_);
+  iteration_events_ = 0;
+
+  Stats::Counter* counters[] = {&stats_.file_event_time_us_, &stats_.post_time_us_,
+                                &stats_.timer_time_us_};
+  for (size_t i = 0; i < event_time_.size(); i++) {
+    const std::chrono::microseconds us =
+        std::chrono::duration_cast<std::chrono::microseconds>(event_time_[i]);
+    if (us.count() > 0) {
+      counters[i]->add(us.count());
+      event_time_[i] -= us;
+    }
+  }
+}
+
+void LoopStats::onPostQueued() {
+  // 0 is kept for an empty queue, which shifts a clock reading of exactly 0 by a tick.
+  post_queued_.store(
+      std::max<MonotonicTime::rep>(time_source_.monotonicTime().time_since_epoch().count(), 1),
+      std::memory_order_relaxed);
+}
+
+void LoopStats::onPostRun() {
+  const MonotonicTime::rep queued = post_queued_.exchange(0, std::memory_order_relaxed);
+  if (queued != 0) {
+    stats_.post_wait_us_.recordValue(toMicroseconds(
+        time_source_.monotonicTime() - MonotonicTime(MonotonicTime::duration(queued))));
+  }
+}
+
+void LoopStats::onTimerLag(MonotonicTime::duration lag) {
+  stats_.timer_lag_us_.recordValue(toMicroseconds(lag));
+}
+
+} // namespace Event
+} // namespace Envoy
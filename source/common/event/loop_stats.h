@@ -0,0 +1,97 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+#include "envoy/common/time.h"
+#include "envoy/event/dispatcher.h"
+
+#include "common/common/non_copyable.h"
+
+namespace Envoy {
+namespace Event {
+
+/**
+ * Records how busy a dispatcher's event loop is. An iteration of the loop is timed from the start
+ * of the first event callback it runs to the end of the last one, so waiting for events is left
+ * out. To read the clock only once per event, each callback is timed from the end of the one
+ * before it, which accounts libevent's own work between two callbacks to the second, along with
+ * any callback which does not go through the dispatcher, like an evconnlistener's accepts.
+ *
+ * The time spent in each type of event is summed over an iteration and added to its counter when
+ * the iteration ends, carrying what is left below a microsecond over to the next one.
+ */
+class LoopStats : NonCopyable {
+public:
+  enum class EventType { FileEvent, Post, Timer };
+
+  /**
+   * Times the callback of an event for as long as it is in scope.
+   */
+  class EventScope {
+  public:
+    /**
+     * @param loop_stats supplies the stats to record the event in, or nullptr to not record it.
+     * @param type supplies the type of the event.
+     */
+    EventScope(LoopStats* loop_stats, EventType type) : loop_stats_(loop_stats), type_(type) {
+      if (loop_stats_ != nullptr) {
+        loop_stats_->beforeEvent();
+      }
+    }
+    ~EventScope() {
+      if (loop_stats_ != nullptr) {
+        loop_stats_->afterEvent(type_);
+      }
+    }
+
+  private:
+    LoopStats* const loop_stats_;
+    const EventType type_;
+  };
+
+  LoopStats(TimeSource& time_source, const DispatcherStats& stats);
+
+  /**
+   * Record the iteration of the loop which just ended, if it ran any events.
+   */
+  void onIterationEnd();
+
+  /**
+   * Note that a callback was posted to an empty post queue. This is safe cross thread.
+   */
+  void onPostQueued();
+
+  /**
+   * Record how long the post queue waited to be run, by the callback which woke the dispatcher up.
+   */
+  void onPostRun();
+
+  /**
+   * Record how late timers fired.
+   * @param lag supplies the time between when the timers were due and when they fired.
+   */
+  void onTimerLag(MonotonicTime::duration lag);
+
+  DispatcherStats& stats() { return stats_; }
+
+private:
+  void beforeEvent();
+  void afterEvent(EventType type);
+
+  TimeSource& time_source_;
+  DispatcherStats stats_;
+  bool in_iteration_{};
+  MonotonicTime iteration_start_;
+  MonotonicTime last_event_end_;
+  uint64_t iteration_events_{};
+  std::array<MonotonicTime::duration, 3> event_time_{};
+  // When a callback was posted to the empty queue, as a count of the monotonic clock, or 0 if the
+  // queue has been run since.
+  std::atomic<MonotonicTime::rep> post_queued_{};
+};
+
+} // namespace Event
+} // namespace Envoy
@@ -0,0 +1,102 @@
+#include "common/event/post_queue.h"
+
+namespace Envoy {
+namespace Event {
+
+PostQueue::NodeCache::~NodeCache() { deleteNodes(head_); }
+
+PostQueue::~PostQueue() {
+  // Callbacks which never ran are dropped.
+  deleteNodes(head_.load(std::memory_order_acquire));
+  deleteNodes(free_nodes_.load(std::memory_order_acquire));
+}
+
+bool PostQueue::push(PostCb&& callback) {
+  Node* node = allocateNode();
+  node->callback_ = std::move(callback);
+  Node* head = head_.load(std::memory_order_relaxed);
+  do {
+    node->next_ = head;
+  } while (!head_.compare_exchange_weak(head, node, std::memory_order_release,
+                                        std::memory_order_relaxed));
+  return head == nullptr;
+}
+
+uint64_t PostQueue::runAll() {
+  uint64_t run = 0;
+  // Callbacks may post more callbacks, which are run by the next iteration.
+  while (Node* node = head_.exchange(nullptr, std::memory_order_acquire)) {
+    // The newest callback is at the top of the stack, so reverse it to run them in order.
+    Node* first = nullptr;
+    while (node != nullptr) {
+      Node* next = node->next_;
+      node->next_ = first;
+      first = node;
+      node = next;
+    }
+
+    Node* last = nullptr;
+    uint32_t count = 0;
+    for (node = first; node != nullptr; node = node->next_) {
+      node->callback_();
+      // Destroy the callback before the next one runs, so that what it captured is released in
+      // order.
+      node->callback_ = nullptr;
+      last = node;
+      count++;
+    }
+    recycleNodes(first, last, count);
+    run += count;
+  }
+  return run;
+}
+
+PostQueue::NodeCache& PostQueue::nodeCache() {
+  static thread_local NodeCache cache;
+  return cache;
+}
+
+void PostQueue::deleteNodes(Node* node) {
+  while (node != nullptr) {
+    Node* next = node->next_;
+    delete node;
+    node = next;
+  }
+}
+
+PostQueue::Node* PostQueue::allocateNode() {
+  Node*& cached = nodeCache().head_;
+  if (cached == nullptr) {
+    // Only the consumer adds nodes, and producers take all of them at once, so taking them can
+    // not see a node which was taken and added back in the meantime.
+    cached = free_nodes_.exchange(nullptr, std::memory_order_acquire);
+    if (cached != nullptr) {
+      free_node_count_.store(0, std::memory_order_relaxed);
+    }
+  }
+
+  if (cached == nullptr) {
+    return new Node();
+  }
+  Node* node = cached;
+  cached = node->next_;
+  node->next_ = nullptr;
+  return node;
+}
+
+void PostQueue::recycleNodes(Node* first, Node* last, uint32_t count) {
+  if (free_node_count_.load(std::memory_order_relaxed) >= MaxFreeNodes) {
+    deleteNodes(first);
+    return;
+  }
+
+  free_node_count_.fetch_add(count, std::memory_order_relaxed);
+  Node* head = free_nodes_.load(std::memory_order_relaxed);
+  do {
+    last->next_ = head;
+  } while (!free_nodes_.compare_exchange_weak(head, first, std::memory_order_release,
+                                              std::memory_order_relaxed));
+}
+
+} // namespace Event
+} // namespace Envoy
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+#include "envoy/event/dispatcher.h"
+
+#include "common/common/non_copyable.h"
+
+namespace Envoy {
+namespace Event {
+
+/**
+ * Queue of callbacks posted to a dispatcher from any thread, and run on the dispatcher's thread.
+ * Producers push onto a lock free stack, and the consumer takes everything pushed so far with a
+ * single exchange, so neither side waits for the other however many callbacks are in flight.
+ *
+ * Nodes which have run are recycled rather than freed: the consumer hands them back to the queue,
+ * and a producer which runs out of nodes takes all of them at once into a cache for its thread.
+ * The callback is moved into the node, so posting a callable small enough for the inline storage
+ * of PostCb does not allocate once nodes are being recycled.
+ */
+class PostQueue : NonCopyable {
+public:
+  ~PostQueue();
+
+  /**
+   * Add a callback to the queue. This is safe cross thread.
+   * @param callback supplies the callback to run.
+   * @return bool whether the queue was empty, in which case the consumer must be woken up.
+   */
+  bool push(PostCb&& callback);
+
+  /**
+   * Run the callbacks in the queue in the order they were pushed, until it is empty. Each callback
+   * is destroyed before the next one runs. This must only be called by the consumer.
+   * @return uint64_t the number of callbacks run.
+   */
+  uint64_t runAll();
+
+private:
+  struct Node {
+    Node* next_{};
+    PostCb callback_;
+  };
+
+  // Nodes taken from the queues a thread posted to, and not used yet.
+  struct NodeCache {
+    ~NodeCache();
+
+    Node* head_{};
+  };
+
+  // Bound on the nodes waiting to be taken by a producer. It is approximate, as producers reset
+  // the count while the consumer may be adding to it.
+  static constexpr uint32_t MaxFreeNodes = 1024;
+
+  static NodeCache& nodeCache();
+  static void deleteNodes(Node* node);
+  Node* allocateNode();
+  void recycleNodes(Node* first, Node* last, uint32_t count);
+
+  std::atomic<Node*> head_{};
+  std::atomic<Node*> free_nodes_{};
+  std::atomic<uint32_t> free_node_count_{};
+};
+
+} // namespace Event
+} // namespace Envoy
@@ -0,0 +1,218 @@
+#include "common/event/timer_wheel.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+
+#include "common/common/assert.h"
+
+namespace Envoy {
+namespace Event {
+
+TimerWheel::TimerWheel(TimeSource& time_source, Scheduler& scheduler,
+                       std::chrono::milliseconds tick)
+    : time_source_(time_source), tick_(tick), start_(time_source_.monotonicTime()),
+      tick_timer_(scheduler.createTimer([this]() -> void { onTick(); })) {
+  ASSERT(tick_.count() > 0);
+}
+
+TimerWheel::~TimerWheel() {
+  // Leave any timers which outlive the wheel disabled, so that they do not touch it again.
+  auto clear = [](Link& slot) {
+    while (!empty(slot)) {
+      WheelTimer& timer = static_cast<WheelTimer&>(*slot.next_);
+      unlink(timer);
+      timer.enabled_ = false;
+    }
+  };
+  for (Link& slot : level0_) {
+    clear(slot);
+  }
+  for (auto& level : levels_) {
+    for (Link& slot : level) {
+      clear(slot);
+    }
+  }
+}
+
+TimerPtr TimerWheel::createTimer(const TimerCb& cb) {
+  ASSERT(cb);
+  return std::make_unique<WheelTimer>(*this, cb);
+}
+
+void TimerWheel::unlink(Link& link) {
+  link.prev_->next_ = link.next_;
+  link.next_->prev_ = link.prev_;
+  link.prev_ = &link;
+  link.next_ = &link;
+}
+
+TimerWheel::Link& TimerWheel::slot(uint32_t level, uint64_t tick) {
+  if (level == 0) {
+    return level0_[tick & (Level0Slots - 1)];
+  }
+  return levels_[level - 1][(tick >> shift(level)) & (LevelSlots - 1)];
+}
+
+uint64_t TimerWheel::tickAt(MonotonicTime time) const {
+  return static_cast<uint64_t>((time - start_) / tick_);
+}
+
+void TimerWheel::enable(WheelTimer& timer, std::chrono::milliseconds d) {
+  disable(timer);
+  const MonotonicTime::duration due = time_source_.monotonicTime() - start_ + d;
+  if (enabled_timers_ == 0) {
+    // No timer is waiting for the ticks the wheel has not been advanced through, so skip them.
+    current_tick_ = now();
+  }
+
+  // Round up, so that the timer never fires early.
+  const uint64_t expiry = (due + tick_ - MonotonicTime::duration(1)) / tick_;
+  timer.expiry_ = std::max(expiry, current_tick_ + 1);
+  timer.enabled_ = true;
+  enabled_timers_++;
+  scheduleTick(insert(timer));
+}
+
+void TimerWheel::disable(WheelTimer& timer) {
+  if (!timer.enabled_) {
+    return;
+  }
+  unlink(timer);
+  timer.enabled_ = false;
+  enabled_timers_--;
+  if (timer.level_ == 0) {
+    level0_timers_--;
+  }
+}
+
+uint64_t TimerWheel::insert(WheelTimer& timer) {
+  const uint64_t delta = timer.expiry_ - current_tick_;
+  for (uint32_t level = 0; level < Levels; level++) {
+    const uint64_t span = uint64_t(1) << shift(level + 1);
+    if (delta < span || level == Levels - 1) {
+      // Timers due beyond the last level wait in its furthest slot, and are inserted again when
+      // it is cascaded.
+      const uint64_t tick = delta < span ? timer.expiry_ : current_tick_ + span - 1;
+      Link& to = slot(level, tick);
+      Link& link = timer;
+      link.prev_ = to.prev_;
+      link.next_ = &to;
+      to.prev_->next_ = &link;
+      to.prev_ = &link;
+      timer.level_ = level;
+      if (level == 0) {
+        level0_timers_++;
+      }
+      return (tick >> shift(level)) << shift(level);
+    }
+  }
+  NOT_REACHED_GCOVR_EXCL_LINE;
+}
+
+void TimerWheel::onTick() {
+  tick_scheduled_ = false;
+  const MonotonicTime time = time_source_.monotonicTime();
+  if (lag_cb_) {
+    lag_cb_(time - (start_ + tick_ * static_cast<MonotonicTime::rep>(scheduled_tick_)));
+  }
+  const uint64_t now_tick = tickAt(time);
+  while (current_tick_ < now_tick && enabled_timers_ > 0) {
+    if (level0_timers_ == 0) {
+      // No timer can fire before the next cascade.
+      const uint64_t next_cascade = ((current_tick_ >> Level0Bits) + 1) << Level0Bits;
+      if (next_cascade > now_tick) {
+        break;
+      }
+      current_tick_ = next_cascade;
+    } else {
+      current_tick_++;
+    }
+
+    cascade();
+    Link& due = level0_[current_tick_ & (Level0Slots - 1)];
+    while (!empty(due)) {
+      WheelTimer& timer = static_cast<WheelTimer&>(*due.next_);
+      disable(timer);
+      timer.cb_();
+    }
+  }
+  current_tick_ = std::max(current_tick_, now_tick);
+  scheduleNextTick();
+}
+
+void TimerWheel::cascade() {
+  for (uint32_t level = 1; level < Levels; level++) {
+    if ((current_tick_ & ((uint64_t(1) << shift(level)) - 1)) != 0) {
+      return;
+    }
+
+    // Take the timers out of the slot first, as those waiting beyond the last level go back into
+    // it.
+    Link& from = slot(level, current_tick_);
+    Link pending;
+    if (!empty(from)) {
+      pending.next_ = from.next_;
+      pending.prev_ = from.prev_;
+      pending.next_->prev_ = &pending;
+      pending.prev_->next_ = &pending;
+      from.next_ = &from;
+      from.prev_ = &from;
+    }
+    while (!empty(pending)) {
+      WheelTimer& timer = static_cast<WheelTimer&>(*pending.next_);
+      unlink(timer);
+      insert(timer);
+    }
+  }
+}
+
+void TimerWheel::scheduleTick(uint64_t tick) {
+  if (tick_scheduled_ && scheduled_tick_ <= tick) {
+    return;
+  }
+
+  tick_scheduled_ = true;
+  scheduled_tick_ = tick;
+  const MonotonicTime::duration remaining =
+      start_ + tick_ * static_cast<MonotonicTime::rep>(tick) - time_source_.monotonicTime();
+  auto delay = std::chrono::duration_cast<std::chrono::milliseconds>(remaining);
+  if (delay < remaining) {
+    delay += std::chrono::milliseconds(1);
+  }
+  tick_timer_->enableTimer(std::max(delay, std::chrono::milliseconds(0)));
+}
+
+void TimerWheel::scheduleNextTick() {
+  if (enabled_timers_ == 0) {
+    return;
+  }
+
+  // Wake up for the first tick at which a slot with timers in it is fired or cascaded. The slots of
+  // each level hold timers for the next lap of that level.
+  uint64_t next = UINT64_MAX;
+  for (uint32_t level = 0; level < Levels; level++) {
+    const uint64_t slots = level == 0 ? uint64_t(Level0Slots) : uint64_t(LevelSlots);
+    const uint64_t first = ((current_tick_ >> shift(level)) + 1) << shift(level);
+    const uint64_t last = current_tick_ + (slots << shift(level));
+    for (uint64_t tick = first; tick < next && tick <= last; tick += uint64_t(1) << shift(level)) {
+      if (!empty(slot(level, tick))) {
+        next = tick;
+        break;
+      }
+    }
+  }
+  ASSERT(next != UINT64_MAX);
+  scheduleTick(next);
+}
+
+TimerWheel::WheelTimer::~WheelTimer() { disableTimer(); }
+
+void TimerWheel::WheelTimer::disableTimer() { wheel_.disable(*this); }
+
+void TimerWheel::WheelTimer::enableTimer(const std::chrono::milliseconds& d) {
+  wheel_.enable(*this, d);
+}
+
+} // namespace Event
+} // namespace Envoy
@@ -0,0 +1,117 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+
+#include "envoy/common/time.h"
+#include "envoy/event/timer.h"
+
+#include "common/common/non_copyable.h"
+
+namespace Envoy {
+namespace Event {
+
+/**
+ * Hierarchical timer wheel for timers which may fire up to one tick late. Enabling and disabling a
+ * timer links it into or out of a slot list, so both are O(1) however many timers are enabled.
+ *
+ * The first level has a slot for each of the next 256 ticks. Each further level has 64 slots, each
+ * covering all of the slots of the level below it. Whenever the first level wraps around, the
+ * timers in the next slot of the second level are moved down to the first, and so on up the
+ * levels. Timers due beyond the last level wait in its furthest slot until they come back around.
+ *
+ * The wheel is advanced by a single timer from the dispatcher's scheduler, which is only enabled
+ * while the wheel has timers, and skips ticks in which no timer can fire.
+ */
+class TimerWheel : NonCopyable {
+public:
+  /**
+   * @param time_source supplies the monotonic clock timers are measured against.
+   * @param scheduler supplies the scheduler for the timer which advances the wheel.
+   * @param tick supplies the resolution of the wheel.
+   */
+  TimerWheel(TimeSource& time_source, Scheduler& scheduler, std::chrono::milliseconds tick);
+  ~TimerWheel();
+
+  /**
+   * Create a timer in the wheel. The timer must be destroyed before the wheel.
+   */
+  TimerPtr createTimer(const TimerCb& cb);
+
+  /**
+   * Set a callback to be told how late the wheel wakes up to fire timers, compared with the tick
+   * they are due at. It is called once per wake up rather than per timer.
+   */
+  void setLagCallback(std::function<void(MonotonicTime::duration lag)> cb) { lag_cb_ = cb; }
+
+private:
+  struct Link {
+    Link* prev_{this};
+    Link* next_{this};
+  };
+
+  class WheelTimer : public Timer, Link {
+  public:
+    WheelTimer(TimerWheel& wheel, const TimerCb& cb) : wheel_(wheel), cb_(cb) {}
+    ~WheelTimer();
+
+    // Timer
+    void disableTimer() override;
+    void enableTimer(const std::chrono::milliseconds& d) override;
+
+  private:
+    TimerWheel& wheel_;
+    const TimerCb cb_;
+    uint64_t expiry_{};
+    uint32_t level_{};
+    bool enabled_{};
+
+    friend class TimerWheel;
+  };
+
+  static constexpr uint32_t Level0Bits = 8;
+  static constexpr uint32_t LevelBits = 6;
+  static constexpr uint32_t Levels = 4;
+  static constexpr uint32_t Level0Slots = 1 << Level0Bits;
+  static constexpr uint32_t LevelSlots = 1 << LevelBits;
+
+  // The number of bits of a tick below the ones which pick a slot of the level.
+  static constexpr uint32_t shift(uint32_t level) {
+    return level == 0 ? 0 : Level0Bits + (level - 1) * LevelBits;
+  }
+
+  static bool empty(const Link& slot) { return slot.next_ == &slot; }
+  static void unlink(Link& link);
+
+  Link& slot(uint32_t level, uint64_t tick);
+  uint64_t now() const { return tickAt(time_source_.monotonicTime()); }
+  uint64_t tickAt(MonotonicTime time) const;
+  void enable(WheelTimer& timer, std::chrono::milliseconds d);
+  void disable(WheelTimer& timer);
+  // Links the timer into its slot, and returns the tick at which the slot is fired or cascaded.
+  uint64_t insert(WheelTimer& timer);
+  void onTick();
+  void cascade();
+  void scheduleTick(uint64_t tick);
+  void scheduleNextTick();
+
+  TimeSource& time_source_;
+  const MonotonicTime::duration tick_;
+  const MonotonicTime start_;
+  TimerPtr tick_timer_;
+  std::function<void(MonotonicTime::duration)> lag_cb_;
+  // The tick up to which the wheel has fired timers.
+  uint64_t current_tick_{};
+  // The tick the tick timer is enabled for, if tick_scheduled_.
+  uint64_t scheduled_tick_{};
+  bool tick_scheduled_{};
+  uint64_t enabled_timers_{};
+  uint64_t level0_timers_{};
+  std::array<Link, Level0Slots> level0_;
+  std::array<std::array<Link, LevelSlots>, Levels - 1> levels_;
+};
+
+} // namespace Event
+} // namespace Envoy
@@ -68,6 +68,16 @@ public:
    */
   void close();
 
+  /**
+   * Hand the socket of the underlying network connection over to the caller and close the
+   * connection without closing the socket. This is only valid when there are no active requests.
+   * @return Network::ConnectionSocketPtr the socket, or nullptr if it could not be handed over.
+   */
+  Network::ConnectionSocketPtr releaseSocket() {
+    ASSERT(active_requests_.empty());
+    return connection_->releaseSocket();
+  }
+
   /**
    * Send a codec level go away indication to the peer.
    */
@@ -83,6 +93,12 @@ public:
    */
   size_t numActiveRequests() { return active_requests_.size(); }
 
+  /**
+   * @return uint64_t the number of bytes the codec can send before the peer grants it more
+   *         connection-level flow-control window.
+   */
+  uint64_t sendWindow() { return codec_->sendWindow(); }
+
   /**
    * Create a new stream. Note: The CodecClient will NOT buffer multiple requests for HTTP1
    * connections. Thus, calling newStream() before the previous request has been fully encoded
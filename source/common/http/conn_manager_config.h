@@ -47,6 +47,8 @@ namespace Http {
   COUNTER  (downstream_rq_http1_total)                                                             \
   COUNTER  (downstream_rq_http2_total)                                                             \
   GAUGE    (downstream_rq_active)                                                                  \
+  COUNTER  (downstream_rq_arena_allocations)                                                       \
+  COUNTER  (downstream_rq_arena_overflow)                                                          \
   COUNTER  (downstream_rq_response_before_rq_complete)                                             \
   COUNTER  (downstream_rq_rx_reset)                                                                \
   COUNTER  (downstream_rq_tx_reset)                                                                \
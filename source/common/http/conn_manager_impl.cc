@@ -95,7 +95,7 @@ void ConnectionManagerImpl::initializeReadFilterCallbacks(Network::ReadFilterCal
 
   if (config_.idleTimeout()) {
     connection_idle_timer_ = read_callbacks_->connection().dispatcher().createTimer(
-        [this]() -> void { onIdleTimeout(); });
+        [this]() -> void { onIdleTimeout(); }, Event::TimerResolution::Coarse);
     connection_idle_timer_->enableTimer(config_.idleTimeout().value());
   }
 
@@ -357,6 +357,9 @@ ConnectionManagerImpl::ActiveStream::ActiveStream(ConnectionManagerImpl& connect
     : connection_manager_(connection_manager),
       snapped_route_config_(connection_manager.config_.routeConfigProvider().config()),
       stream_id_(connection_manager.random_generator_.random()),
+      decoder_filters_(ActiveStreamDecoderFilterList::allocator_type(arena_)),
+      encoder_filters_(ActiveStreamEncoderFilterList::allocator_type(arena_)),
+      access_log_handlers_(ArenaAllocator<AccessLog::InstanceSharedPtr>(arena_)),
       request_response_timespan_(new Stats::Timespan(
           connection_manager_.stats_.named_.downstream_rq_time_, connection_manager_.timeSystem())),
       stream_info_(connection_manager_.codec_->protocol(), connection_manager_.timeSystem()) {
@@ -379,14 +382,14 @@ ConnectionManagerImpl::ActiveStream::ActiveStream(ConnectionManagerImpl& connect
   if (connection_manager_.config_.streamIdleTimeout().count()) {
     idle_timeout_ms_ = connection_manager_.config_.streamIdleTimeout();
     stream_idle_timer_ = connection_manager_.read_callbacks_->connection().dispatcher().createTimer(
-        [this]() -> void { onIdleTimeout(); });
+        [this]() -> void { onIdleTimeout(); }, Event::TimerResolution::Coarse);
     resetIdleTimer();
   }
 
   if (connection_manager_.config_.requestTimeout().count()) {
     std::chrono::milliseconds request_timeout_ms_ = connection_manager_.config_.requestTimeout();
     request_timer_ = connection_manager.read_callbacks_->connection().dispatcher().createTimer(
-        [this]() -> void { onRequestTimeout(); });
+        [this]() -> void { onRequestTimeout(); }, Event::TimerResolution::Coarse);
     request_timer_->enableTimer(request_timeout_ms_);
   }
 
@@ -419,6 +422,14 @@ ConnectionManagerImpl::ActiveStream::~ActiveStream() {
     connection_manager_.stats_.named_.downstream_cx_upgrades_active_.dec();
   }
 
+  // Everything the arena will hold has been allocated by now, so its counts are final.
+  connection_manager_.stats_.named_.downstream_rq_arena_allocations_.add(arena_.allocations());
+  if (arena_.heapBlocks() > 0) {
+    connection_manager_.stats_.named_.downstream_rq_arena_overflow_.inc();
+  }
+  ENVOY_STREAM_LOG(trace, "arena: {} allocations, {} bytes, {} heap blocks", *this,
+                   arena_.allocations(), arena_.bytesAllocated(), arena_.heapBlocks());
+
   ASSERT(state_.filter_call_state_ == 0);
 }
 
@@ -454,14 +465,16 @@ void ConnectionManagerImpl::ActiveStream::onRequestTimeout() {
 
 void ConnectionManagerImpl::ActiveStream::addStreamDecoderFilterWorker(
     StreamDecoderFilterSharedPtr filter, bool dual_filter) {
-  ActiveStreamDecoderFilterPtr wrapper(new ActiveStreamDecoderFilter(*this, filter, dual_filter));
+  ActiveStreamDecoderFilterPtr wrapper =
+      makeArenaPtr<ActiveStreamDecoderFilter>(arena_, *this, filter, dual_filter);
   filter->setDecoderFilterCallbacks(*wrapper);
   wrapper->moveIntoListBack(std::move(wrapper), decoder_filters_);
 }
 
 void ConnectionManagerImpl::ActiveStream::addStreamEncoderFilterWorker(
     StreamEncoderFilterSharedPtr filter, bool dual_filter) {
-  ActiveStreamEncoderFilterPtr wrapper(new ActiveStreamEncoderFilter(*this, filter, dual_filter));
+  ActiveStreamEncoderFilterPtr wrapper =
+      makeArenaPtr<ActiveStreamEncoderFilter>(arena_, *this, filter, dual_filter);
   filter->setEncoderFilterCallbacks(*wrapper);
   if (connection_manager_.config_.reverseEncodeOrder()) {
     wrapper->moveIntoList(std::move(wrapper), encoder_filters_);
@@ -740,8 +753,8 @@ void ConnectionManagerImpl::ActiveStream::traceRequest() {
 
 void ConnectionManagerImpl::ActiveStream::decodeHeaders(ActiveStreamDecoderFilter* filter,
                                                         HeaderMap& headers, bool end_stream) {
-  std::list<ActiveStreamDecoderFilterPtr>::iterator entry;
-  std::list<ActiveStreamDecoderFilterPtr>::iterator continue_data_entry = decoder_filters_.end();
+  ActiveStreamDecoderFilterList::iterator entry;
+  ActiveStreamDecoderFilterList::iterator continue_data_entry = decoder_filters_.end();
   if (!filter) {
     entry = decoder_filters_.begin();
   } else {
@@ -801,7 +814,7 @@ void ConnectionManagerImpl::ActiveStream::decodeData(ActiveStreamDecoderFilter*
     return;
   }
 
-  std::list<ActiveStreamDecoderFilterPtr>::iterator entry;
+  ActiveStreamDecoderFilterList::iterator entry;
   auto trailers_added_entry = decoder_filters_.end();
   const bool trailers_exists_at_start = request_trailers_ != nullptr;
   if (!filter) {
@@ -899,7 +912,7 @@ void ConnectionManagerImpl::ActiveStream::decodeTrailers(ActiveStreamDecoderFilt
     return;
   }
 
-  std::list<ActiveStreamDecoderFilterPtr>::iterator entry;
+  ActiveStreamDecoderFilterList::iterator entry;
   if (!filter) {
     entry = decoder_filters_.begin();
   } else {
@@ -935,7 +948,7 @@ void ConnectionManagerImpl::ActiveStream::disarmRequestTimeout() {
   }
 }
 
-std::list<ConnectionManagerImpl::ActiveStreamEncoderFilterPtr>::iterator
+ConnectionManagerImpl::ActiveStreamEncoderFilterList::iterator
 ConnectionManagerImpl::ActiveStream::commonEncodePrefix(ActiveStreamEncoderFilter* filter,
                                                         bool end_stream) {
   // Only do base state setting on the initial call. Subsequent calls for filtering do not touch
@@ -1013,7 +1026,7 @@ void ConnectionManagerImpl::ActiveStream::encode100ContinueHeaders(
   // filter. This is simpler than that case because 100 continue implies no
   // end-stream, and because there are normal headers coming there's no need for
   // complex continuation logic.
-  std::list<ActiveStreamEncoderFilterPtr>::iterator entry = commonEncodePrefix(filter, false);
+  ActiveStreamEncoderFilterList::iterator entry = commonEncodePrefix(filter, false);
   for (; entry != encoder_filters_.end(); entry++) {
     ASSERT(!(state_.filter_call_state_ & FilterCallState::Encode100ContinueHeaders));
     state_.filter_call_state_ |= FilterCallState::Encode100ContinueHeaders;
@@ -1044,8 +1057,8 @@ void ConnectionManagerImpl::ActiveStream::encodeHeaders(ActiveStreamEncoderFilte
   resetIdleTimer();
   disarmRequestTimeout();
 
-  std::list<ActiveStreamEncoderFilterPtr>::iterator entry = commonEncodePrefix(filter, end_stream);
-  std::list<ActiveStreamEncoderFilterPtr>::iterator continue_data_entry = encoder_filters_.end();
+  ActiveStreamEncoderFilterList::iterator entry = commonEncodePrefix(filter, end_stream);
+  ActiveStreamEncoderFilterList::iterator continue_data_entry = encoder_filters_.end();
 
   for (; entry != encoder_filters_.end(); entry++) {
     ASSERT(!(state_.filter_call_state_ & FilterCallState::EncodeHeaders));
@@ -1200,7 +1213,7 @@ void ConnectionManagerImpl::ActiveStream::addEncodedData(ActiveStreamEncoderFilt
 void ConnectionManagerImpl::ActiveStream::encodeData(ActiveStreamEncoderFilter* filter,
                                                      Buffer::Instance& data, bool end_stream) {
   resetIdleTimer();
-  std::list<ActiveStreamEncoderFilterPtr>::iterator entry = commonEncodePrefix(filter, end_stream);
+  ActiveStreamEncoderFilterList::iterator entry = commonEncodePrefix(filter, end_stream);
   auto trailers_added_entry = encoder_filters_.end();
 
   const bool trailers_exists_at_start = response_trailers_ != nullptr;
@@ -1252,7 +1265,7 @@ void ConnectionManagerImpl::ActiveStream::encodeData(ActiveStreamEncoderFilter*
 void ConnectionManagerImpl::ActiveStream::encodeTrailers(ActiveStreamEncoderFilter* filter,
                                                          HeaderMap& trailers) {
   resetIdleTimer();
-  std::list<ActiveStreamEncoderFilterPtr>::iterator entry = commonEncodePrefix(filter, true);
+  ActiveStreamEncoderFilterList::iterator entry = commonEncodePrefix(filter, true);
   for (; entry != encoder_filters_.end(); entry++) {
     ASSERT(!(state_.filter_call_state_ & FilterCallState::EncodeTrailers));
     state_.filter_call_state_ |= FilterCallState::EncodeTrailers;
@@ -25,6 +25,7 @@
 #include "envoy/upstream/upstream.h"
 
 #include "common/buffer/watermark_buffer.h"
+#include "common/common/arena.h"
 #include "common/common/linked_object.h"
 #include "common/grpc/common.h"
 #include "common/http/conn_manager_config.h"
@@ -133,12 +134,19 @@ private:
     const bool dual_filter_ : 1;
   };
 
+  struct ActiveStreamDecoderFilter;
+  typedef ArenaPtr<ActiveStreamDecoderFilter> ActiveStreamDecoderFilterPtr;
+  typedef std::list<ActiveStreamDecoderFilterPtr, ArenaAllocator<ActiveStreamDecoderFilterPtr>>
+      ActiveStreamDecoderFilterList;
+
   /**
-   * Wrapper for a stream decoder filter.
+   * Wrapper for a stream decoder filter. Wrappers and the list holding them are allocated from the
+   * stream's arena.
    */
-  struct ActiveStreamDecoderFilter : public ActiveStreamFilterBase,
-                                     public StreamDecoderFilterCallbacks,
-                                     LinkedObject<ActiveStreamDecoderFilter> {
+  struct ActiveStreamDecoderFilter
+      : public ActiveStreamFilterBase,
+        public StreamDecoderFilterCallbacks,
+        LinkedObject<ActiveStreamDecoderFilter, ActiveStreamDecoderFilterList> {
     ActiveStreamDecoderFilter(ActiveStream& parent, StreamDecoderFilterSharedPtr filter,
                               bool dual_filter)
         : ActiveStreamFilterBase(parent, dual_filter), handle_(filter) {}
@@ -206,14 +214,19 @@ private:
     bool is_grpc_request_{};
   };
 
-  typedef std::unique_ptr<ActiveStreamDecoderFilter> ActiveStreamDecoderFilterPtr;
+  struct ActiveStreamEncoderFilter;
+  typedef ArenaPtr<ActiveStreamEncoderFilter> ActiveStreamEncoderFilterPtr;
+  typedef std::list<ActiveStreamEncoderFilterPtr, ArenaAllocator<ActiveStreamEncoderFilterPtr>>
+      ActiveStreamEncoderFilterList;
 
   /**
-   * Wrapper for a stream encoder filter.
+   * Wrapper for a stream encoder filter. Wrappers and the list holding them are allocated from the
+   * stream's arena.
    */
-  struct ActiveStreamEncoderFilter : public ActiveStreamFilterBase,
-                                     public StreamEncoderFilterCallbacks,
-                                     LinkedObject<ActiveStreamEncoderFilter> {
+  struct ActiveStreamEncoderFilter
+      : public ActiveStreamFilterBase,
+        public StreamEncoderFilterCallbacks,
+        LinkedObject<ActiveStreamEncoderFilter, ActiveStreamEncoderFilterList> {
     ActiveStreamEncoderFilter(ActiveStream& parent, StreamEncoderFilterSharedPtr filter,
                               bool dual_filter)
         : ActiveStreamFilterBase(parent, dual_filter), handle_(filter) {}
@@ -253,8 +266,6 @@ private:
     StreamEncoderFilterSharedPtr handle_;
   };
 
-  typedef std::unique_ptr<ActiveStreamEncoderFilter> ActiveStreamEncoderFilterPtr;
-
   /**
    * Wraps a single active stream on the connection. These are either full request/response pairs
    * or pushes.
@@ -265,14 +276,18 @@ private:
                         public StreamDecoder,
                         public FilterChainFactoryCallbacks,
                         public Tracing::Config {
+    // The size of the memory inside each stream for its arena, which is enough for the filter
+    // chains of most streams. Streams with longer chains spill over onto the heap.
+    static constexpr size_t ArenaSize = 1024;
+
     ActiveStream(ConnectionManagerImpl& connection_manager);
     ~ActiveStream();
 
     void addStreamDecoderFilterWorker(StreamDecoderFilterSharedPtr filter, bool dual_filter);
     void addStreamEncoderFilterWorker(StreamEncoderFilterSharedPtr filter, bool dual_filter);
     void chargeStats(const HeaderMap& headers);
-    std::list<ActiveStreamEncoderFilterPtr>::iterator
-    commonEncodePrefix(ActiveStreamEncoderFilter* filter, bool end_stream);
+    ActiveStreamEncoderFilterList::iterator commonEncodePrefix(ActiveStreamEncoderFilter* filter,
+                                                               bool end_stream);
     const Network::Connection* connection();
     void addDecodedData(ActiveStreamDecoderFilter& filter, Buffer::Instance& data, bool streaming);
     HeaderMap& addDecodedTrailers();
@@ -386,6 +401,10 @@ private:
     void onRequestTimeout();
 
     ConnectionManagerImpl& connection_manager_;
+    // Holds the filter wrappers and the lists of filters and access log handlers, which are all
+    // released together when the stream is destroyed. This must be declared before everything
+    // allocated from it so that it is destroyed after them.
+    InlineArena<ArenaSize> arena_;
     Router::ConfigConstSharedPtr snapped_route_config_;
     Tracing::SpanPtr active_span_;
     const uint64_t stream_id_;
@@ -397,9 +416,10 @@ private:
     HeaderMapPtr request_headers_;
     Buffer::WatermarkBufferPtr buffered_request_data_;
     HeaderMapPtr request_trailers_;
-    std::list<ActiveStreamDecoderFilterPtr> decoder_filters_;
-    std::list<ActiveStreamEncoderFilterPtr> encoder_filters_;
-    std::list<AccessLog::InstanceSharedPtr> access_log_handlers_;
+    ActiveStreamDecoderFilterList decoder_filters_;
+    ActiveStreamEncoderFilterList encoder_filters_;
+    std::list<AccessLog::InstanceSharedPtr, ArenaAllocator<AccessLog::InstanceSharedPtr>>
+        access_log_handlers_;
     Stats::TimespanPtr request_response_timespan_;
     // Per-stream idle timeout.
     Event::TimerPtr stream_idle_timer_;
@@ -20,14 +20,14 @@ ConnPoolImplBase::newPendingRequest(StreamDecoder& decoder, ConnectionPool::Call
   ENVOY_LOG(debug, "queueing request due to no available connections");
   PendingRequestPtr pending_request(new PendingRequest(*this, decoder, callbacks));
   pending_request->moveIntoList(std::move(pending_request), pending_requests_);
-  return pending_requests_.front().get();
+  return pending_requests_.front();
 }
 
 void ConnPoolImplBase::purgePendingRequests(
     const Upstream::HostDescriptionConstSharedPtr& host_description) {
   // NOTE: We move the existing pending requests to a temporary list. This is done so that
   //       if retry logic submits a new request to the pool, we don't fail it inline.
-  std::list<PendingRequestPtr> pending_requests_to_purge(std::move(pending_requests_));
+  IntrusiveList<PendingRequest> pending_requests_to_purge(std::move(pending_requests_));
   while (!pending_requests_to_purge.empty()) {
     PendingRequestPtr request =
         pending_requests_to_purge.front()->removeFromList(pending_requests_to_purge);
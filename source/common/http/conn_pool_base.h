@@ -2,7 +2,7 @@
 
 #include "envoy/http/conn_pool.h"
 
-#include "common/common/linked_object.h"
+#include "common/common/intrusive_list.h"
 
 namespace Envoy {
 namespace Http {
@@ -14,7 +14,7 @@ protected:
       : host_(host), priority_(priority) {}
   virtual ~ConnPoolImplBase() = default;
 
-  struct PendingRequest : LinkedObject<PendingRequest>, public ConnectionPool::Cancellable {
+  struct PendingRequest : IntrusiveListItem<PendingRequest>, public ConnectionPool::Cancellable {
     PendingRequest(ConnPoolImplBase& parent, StreamDecoder& decoder,
                    ConnectionPool::Callbacks& callbacks);
     ~PendingRequest();
@@ -44,7 +44,7 @@ protected:
 
   const Upstream::HostConstSharedPtr host_;
   const Upstream::ResourcePriority priority_;
-  std::list<PendingRequestPtr> pending_requests_;
+  IntrusiveList<PendingRequest> pending_requests_;
 };
 } // namespace Http
 } // namespace Envoy
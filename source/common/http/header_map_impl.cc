@@ -4,6 +4,7 @@
 #include <list>
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "common/common/assert.h"
 #include "common/common/empty_string.h"
@@ -244,6 +245,115 @@ template <> bool HeaderMapImpl::HeaderList::isPseudoHeader(const LowerCaseString
   return key.get().c_str()[0] == ':';
 }
 
+constexpr uint32_t HeaderMapImpl::HeaderList::FirstBlockCapacity;
+
+HeaderMapImpl::HeaderList::HeaderList(bool list_storage)
+    : list_storage_(list_storage), pseudo_headers_end_(headers_.end()) {}
+
+HeaderMapImpl::HeaderList::~HeaderList() {
+  for (HeaderEntryImpl* entry : entries_) {
+    if (entry != nullptr) {
+      entry->~HeaderEntryImpl();
+    }
+  }
+  while (blocks_ != nullptr) {
+    EntryBlock* block = blocks_;
+    blocks_ = block->next_;
+    ::operator delete(block);
+  }
+}
+
+void* HeaderMapImpl::HeaderList::allocateEntry() {
+  if (free_slots_ != nullptr) {
+    void* slot = free_slots_;
+    free_slots_ = *static_cast<void**>(slot);
+    return slot;
+  }
+
+  if (blocks_ == nullptr || blocks_->used_ == blocks_->capacity_) {
+    const uint32_t capacity = blocks_ == nullptr ? FirstBlockCapacity : 2 * blocks_->capacity_;
+    static_assert(sizeof(EntryBlock) % alignof(EntryStorage) == 0,
+                  "slots following the block header must be aligned");
+    EntryBlock* block = static_cast<EntryBlock*>(
+        ::operator new(sizeof(EntryBlock) + capacity * sizeof(EntryStorage)));
+    block->next_ = blocks_;
+    block->capacity_ = capacity;
+    block->used_ = 0;
+    blocks_ = block;
+  }
+  return &blocks_->slots()[blocks_->used_++];
+}
+
+void HeaderMapImpl::HeaderList::freeEntry(HeaderEntryImpl* entry) {
+  entry->~HeaderEntryImpl();
+  void* slot = entry;
+  *static_cast<void**>(slot) = free_slots_;
+  free_slots_ = slot;
+}
+
+void HeaderMapImpl::HeaderList::insertEntry(HeaderEntryImpl* entry, bool is_pseudo_header) {
+  if (entries_.empty()) {
+    entries_.reserve(FirstBlockCapacity);
+  }
+  if (!is_pseudo_header || pseudo_headers_index_ == entries_.size()) {
+    entry->index_ = entries_.size();
+    entries_.push_back(entry);
+    if (is_pseudo_header) {
+      pseudo_headers_index_++;
+    }
+    return;
+  }
+
+  // A pseudo header added after regular headers goes before them, which shifts them along.
+  entries_.insert(entries_.begin() + pseudo_headers_index_, entry);
+  for (uint32_t i = pseudo_headers_index_; i < entries_.size(); i++) {
+    if (entries_[i] != nullptr) {
+      entries_[i]->index_ = i;
+    }
+  }
+  pseudo_headers_index_++;
+}
+
+void HeaderMapImpl::HeaderList::erase(HeaderEntryImpl& entry) {
+  if (list_storage_) {
+    if (pseudo_headers_end_ == entry.entry_) {
+      pseudo_headers_end_++;
+    }
+    headers_.erase(entry.entry_);
+    return;
+  }
+
+  ASSERT(entries_[entry.index_] == &entry);
+  entries_[entry.index_] = nullptr;
+  tombstones_++;
+  freeEntry(&entry);
+  maybeCompact();
+}
+
+void HeaderMapImpl::HeaderList::maybeCompact() {
+  if (tombstones_ * 2 >= entries_.size()) {
+    compact();
+  }
+}
+
+void HeaderMapImpl::HeaderList::compact() {
+  uint32_t live = 0;
+  uint32_t live_pseudo_headers = 0;
+  for (uint32_t i = 0; i < entries_.size(); i++) {
+    if (entries_[i] == nullptr) {
+      continue;
+    }
+    if (i < pseudo_headers_index_) {
+      live_pseudo_headers++;
+    }
+    entries_[i]->index_ = live;
+    entries_[live++] = entries_[i];
+  }
+  entries_.resize(live);
+  pseudo_headers_index_ = live_pseudo_headers;
+  tombstones_ = 0;
+}
+
 HeaderMapImpl::HeaderEntryImpl::HeaderEntryImpl(const LowerCaseString& key) : key_(key) {}
 
 HeaderMapImpl::HeaderEntryImpl::HeaderEntryImpl(const LowerCaseString& key, HeaderString&& value)
@@ -267,46 +377,74 @@ void HeaderMapImpl::HeaderEntryImpl::value(const HeaderEntry& header) {
 }
 
 #define INLINE_HEADER_STATIC_MAP_ENTRY(name)                                                       \
-  add(Headers::get().name.get().c_str(), [](HeaderMapImpl& h) -> StaticLookupResponse {            \
-    return {&h.inline_headers_.name##_, &Headers::get().name};                                     \
-  });
+  add(Headers::get().name,                                                                         \
+      [](HeaderMapImpl& h) -> StaticLookupResponse {                                               \
+        return {&h.inline_headers_.name##_, &Headers::get().name};                                 \
+      },                                                                                           \
+      false);
 
 HeaderMapImpl::StaticLookupTable::StaticLookupTable() {
   ALL_INLINE_HEADERS(INLINE_HEADER_STATIC_MAP_ENTRY)
 
   // Special case where we map a legacy host header to :authority.
-  add(Headers::get().HostLegacy.get().c_str(), [](HeaderMapImpl& h) -> StaticLookupResponse {
-    return {&h.inline_headers_.Host_, &Headers::get().Host};
-  });
-}
+  add(Headers::get().HostLegacy,
+      [](HeaderMapImpl& h) -> StaticLookupResponse {
+        return {&h.inline_headers_.Host_, &Headers::get().Host};
+      },
+      true);
 
-void HeaderMapImpl::StaticLookupTable::add(const char* key, StaticLookupEntry::EntryCb cb) {
-  StaticLookupEntry* current = &root_;
-  while (uint8_t c = *key) {
-    if (!current->entries_[c]) {
-      current->entries_[c] = std::make_unique<StaticLookupEntry>();
+  size_t index_size = 1;
+  while (index_size < entries_.size() * 4) {
+    index_size *= 2;
+  }
+  index_.resize(index_size);
+  for (const StaticLookupEntry& entry : entries_) {
+    size_t i = entry.hash_ & (index_.size() - 1);
+    while (index_[i] != 0) {
+      i = (i + 1) & (index_.size() - 1);
     }
-
-    current = current->entries_[c].get();
-    key++;
+    index_[i] = id(entry);
   }
+}
 
-  current->cb_ = cb;
+void HeaderMapImpl::StaticLookupTable::add(const LowerCaseString& key,
+                                           StaticLookupEntry::EntryCb cb, bool alias) {
+  entries_.push_back({&key, hashKey(key.get()), cb, alias});
 }
 
-HeaderMapImpl::StaticLookupEntry::EntryCb
-HeaderMapImpl::StaticLookupTable::find(const char* key) const {
-  const StaticLookupEntry* current = &root_;
-  while (uint8_t c = *key) {
-    current = current->entries_[c].get();
-    if (current) {
-      key++;
-    } else {
-      return nullptr;
+const HeaderMapImpl::StaticLookupEntry*
+HeaderMapImpl::StaticLookupTable::find(absl::string_view key, uint64_t hash) const {
+  size_t i = hash & (index_.size() - 1);
+  while (index_[i] != 0) {
+    const StaticLookupEntry& entry = entries_[index_[i] - 1];
+    if (entry.hash_ == hash && entry.key_->get() == key) {
+      return &entry;
     }
+    i = (i + 1) & (index_.size() - 1);
   }
 
-  return current->cb_;
+  return nullptr;
+}
+
+const HeaderMapImpl::StaticLookupEntry*
+HeaderMapImpl::StaticLookupTable::find(const InternedHeaderName& key) const {
+  if (key.id() == 0 || key.id() > entries_.size()) {
+    return nullptr;
+  }
+
+  const StaticLookupEntry& entry = entries_[key.id() - 1];
+  ASSERT(*entry.key_ == key.name());
+  return &entry;
+}
+
+uint32_t HeaderMapImpl::inlineHeaderId(absl::string_view key, uint64_t hash) {
+  const StaticLookupTable& table = ConstSingleton<StaticLookupTable>::get();
+  const StaticLookupEntry* entry = table.find(key, hash);
+  return entry != nullptr ? table.id(*entry) : 0;
+}
+
+uint32_t HeaderMapImpl::inlineHeaderCount() {
+  return ConstSingleton<StaticLookupTable>::get().entries_.size();
 }
 
 void HeaderMapImpl::appendToHeader(HeaderString& header, absl::string_view data) {
@@ -319,7 +457,11 @@ void HeaderMapImpl::appendToHeader(HeaderString& header, absl::string_view data)
   header.append(data.data(), data.size());
 }
 
-HeaderMapImpl::HeaderMapImpl() { memset(&inline_headers_, 0, sizeof(inline_headers_)); }
+bool HeaderMapImpl::use_list_storage_ = false;
+
+HeaderMapImpl::HeaderMapImpl() : headers_(use_list_storage_) {
+  memset(&inline_headers_, 0, sizeof(inline_headers_));
+}
 
 HeaderMapImpl::HeaderMapImpl(
     const std::initializer_list<std::pair<LowerCaseString, std::string>>& values)
@@ -354,20 +496,35 @@ bool HeaderMapImpl::operator==(const HeaderMapImpl& rhs) const {
     return false;
   }
 
-  for (auto i = headers_.begin(), j = rhs.headers_.begin(); i != headers_.end(); ++i, ++j) {
-    if (i->key() != j->key().c_str() || i->value() != j->value().c_str()) {
-      return false;
-    }
-  }
+  std::vector<const HeaderEntryImpl*> rhs_entries;
+  rhs.headers_.forEach([&rhs_entries](const HeaderEntryImpl& entry) {
+    rhs_entries.push_back(&entry);
+    return true;
+  });
 
-  return true;
+  bool equal = true;
+  size_t j = 0;
+  headers_.forEach([&](const HeaderEntryImpl& entry) {
+    equal = entry.key() == rhs_entries[j]->key().c_str() &&
+            entry.value() == rhs_entries[j]->value().c_str();
+    j++;
+    return equal;
+  });
+  return equal;
 }
 
 void HeaderMapImpl::insertByKey(HeaderString&& key, HeaderString&& value) {
-  StaticLookupEntry::EntryCb cb = ConstSingleton<StaticLookupTable>::get().find(key.c_str());
-  if (cb) {
+  const uint64_t hash = hashKey(key.getStringView());
+  const StaticLookupEntry* static_entry =
+      ConstSingleton<StaticLookupTable>::get().find(key.getStringView(), hash);
+  insertByKey(std::move(key), hash, static_entry, std::move(value));
+}
+
+void HeaderMapImpl::insertByKey(HeaderString&& key, uint64_t hash,
+                                const StaticLookupEntry* static_entry, HeaderString&& value) {
+  if (static_entry) {
     key.clear();
-    StaticLookupResponse ref_lookup_response = cb(*this);
+    StaticLookupResponse ref_lookup_response = static_entry->cb_(*this);
     if (*ref_lookup_response.entry_ == nullptr) {
       maybeCreateInline(ref_lookup_response.entry_, *ref_lookup_response.key_, std::move(value));
     } else {
@@ -375,21 +532,23 @@ void HeaderMapImpl::insertByKey(HeaderString&& key, HeaderString&& value) {
       value.clear();
     }
   } else {
-    std::list<HeaderEntryImpl>::iterator i = headers_.insert(std::move(key), std::move(value));
-    i->entry_ = i;
+    headers_.insert(std::move(key), std::move(value)).key_hash_ = hash;
   }
 }
 
 void HeaderMapImpl::addViaMove(HeaderString&& key, HeaderString&& value) {
   // If this is an inline header, we can't addViaMove, because we'll overwrite
   // the existing value.
-  auto* entry = getExistingInline(key.c_str());
+  const uint64_t hash = hashKey(key.getStringView());
+  const StaticLookupEntry* static_entry =
+      ConstSingleton<StaticLookupTable>::get().find(key.getStringView(), hash);
+  auto* entry = getExistingInline(static_entry);
   if (entry != nullptr) {
     appendToHeader(entry->value(), value.c_str());
     key.clear();
     value.clear();
   } else {
-    insertByKey(std::move(key), std::move(value));
+    insertByKey(std::move(key), hash, static_entry, std::move(value));
   }
 }
 
@@ -415,8 +574,20 @@ void HeaderMapImpl::addReferenceKey(const LowerCaseString& key, const std::strin
   ASSERT(new_value.empty()); // NOLINT(bugprone-use-after-move)
 }
 
+void HeaderMapImpl::addReferenceKey(const InternedHeaderName& key, const std::string& value) {
+  HeaderString ref_key(key.name());
+  HeaderString new_value;
+  new_value.setCopy(value.c_str(), value.size());
+  insertByKey(std::move(ref_key), key.hash(), ConstSingleton<StaticLookupTable>::get().find(key),
+              std::move(new_value));
+  ASSERT(new_value.empty()); // NOLINT(bugprone-use-after-move)
+}
+
 void HeaderMapImpl::addCopy(const LowerCaseString& key, uint64_t value) {
-  auto* entry = getExistingInline(key.get().c_str());
+  const uint64_t hash = hashKey(key.get());
+  const StaticLookupEntry* static_entry =
+      ConstSingleton<StaticLookupTable>::get().find(key.get(), hash);
+  auto* entry = getExistingInline(static_entry);
   if (entry != nullptr) {
     char buf[32];
     StringUtil::itoa(buf, sizeof(buf), value);
@@ -427,13 +598,16 @@ void HeaderMapImpl::addCopy(const LowerCaseString& key, uint64_t value) {
   new_key.setCopy(key.get().c_str(), key.get().size());
   HeaderString new_value;
   new_value.setInteger(value);
-  insertByKey(std::move(new_key), std::move(new_value));
+  insertByKey(std::move(new_key), hash, static_entry, std::move(new_value));
   ASSERT(new_key.empty());   // NOLINT(bugprone-use-after-move)
   ASSERT(new_value.empty()); // NOLINT(bugprone-use-after-move)
 }
 
 void HeaderMapImpl::addCopy(const LowerCaseString& key, const std::string& value) {
-  auto* entry = getExistingInline(key.get().c_str());
+  const uint64_t hash = hashKey(key.get());
+  const StaticLookupEntry* static_entry =
+      ConstSingleton<StaticLookupTable>::get().find(key.get(), hash);
+  auto* entry = getExistingInline(static_entry);
   if (entry != nullptr) {
     appendToHeader(entry->value(), value);
     return;
@@ -442,7 +616,7 @@ void HeaderMapImpl::addCopy(const LowerCaseString& key, const std::string& value
   new_key.setCopy(key.get().c_str(), key.get().size());
   HeaderString new_value;
   new_value.setCopy(value.c_str(), value.size());
-  insertByKey(std::move(new_key), std::move(new_value));
+  insertByKey(std::move(new_key), hash, static_entry, std::move(new_value));
   ASSERT(new_key.empty());   // NOLINT(bugprone-use-after-move)
   ASSERT(new_value.empty()); // NOLINT(bugprone-use-after-move)
 }
@@ -450,76 +624,113 @@ void HeaderMapImpl::addCopy(const LowerCaseString& key, const std::string& value
 void HeaderMapImpl::setReference(const LowerCaseString& key, const std::string& value) {
   HeaderString ref_key(key);
   HeaderString ref_value(value);
-  remove(key);
-  insertByKey(std::move(ref_key), std::move(ref_value));
+  const uint64_t hash = hashKey(key.get());
+  const StaticLookupEntry* static_entry =
+      ConstSingleton<StaticLookupTable>::get().find(key.get(), hash);
+  removeByKey(key.get(), hash, static_entry);
+  insertByKey(std::move(ref_key), hash, static_entry, std::move(ref_value));
 }
 
 void HeaderMapImpl::setReferenceKey(const LowerCaseString& key, const std::string& value) {
   HeaderString ref_key(key);
   HeaderString new_value;
   new_value.setCopy(value.c_str(), value.size());
-  remove(key);
-  insertByKey(std::move(ref_key), std::move(new_value));
+  const uint64_t hash = hashKey(key.get());
+  const StaticLookupEntry* static_entry =
+      ConstSingleton<StaticLookupTable>::get().find(key.get(), hash);
+  removeByKey(key.get(), hash, static_entry);
+  insertByKey(std::move(ref_key), hash, static_entry, std::move(new_value));
+  ASSERT(new_value.empty()); // NOLINT(bugprone-use-after-move)
+}
+
+void HeaderMapImpl::setReferenceKey(const InternedHeaderName& key, const std::string& value) {
+  HeaderString ref_key(key.name());
+  HeaderString new_value;
+  new_value.setCopy(value.c_str(), value.size());
+  const StaticLookupEntry* static_entry = ConstSingleton<StaticLookupTable>::get().find(key);
+  removeByKey(key.name().get(), key.hash(), static_entry);
+  insertByKey(std::move(ref_key), key.hash(), static_entry, std::move(new_value));
   ASSERT(new_value.empty()); // NOLINT(bugprone-use-after-move)
 }
 
 uint64_t HeaderMapImpl::byteSize() const {
   uint64_t byte_size = 0;
-  for (const HeaderEntryImpl& header : headers_) {
+  headers_.forEach([&byte_size](const HeaderEntryImpl& header) {
     byte_size += header.key().size();
     byte_size += header.value().size();
-  }
+    return true;
+  });
 
   return byte_size;
 }
 
 const HeaderEntry* HeaderMapImpl::get(const LowerCaseString& key) const {
-  for (const HeaderEntryImpl& header : headers_) {
-    if (header.key() == key.get().c_str()) {
-      return &header;
-    }
-  }
-
-  return nullptr;
+  const uint64_t hash = hashKey(key.get());
+  return getByKey(key.get(), hash, ConstSingleton<StaticLookupTable>::get().find(key.get(), hash));
 }
 
 HeaderEntry* HeaderMapImpl::get(const LowerCaseString& key) {
-  for (HeaderEntryImpl& header : headers_) {
-    if (header.key() == key.get().c_str()) {
-      return &header;
+  const uint64_t hash = hashKey(key.get());
+  return getByKey(key.get(), hash, ConstSingleton<StaticLookupTable>::get().find(key.get(), hash));
+}
+
+const HeaderEntry* HeaderMapImpl::get(const InternedHeaderName& key) const {
+  return getByKey(key.name().get(), key.hash(), ConstSingleton<StaticLookupTable>::get().find(key));
+}
+
+HeaderEntry* HeaderMapImpl::get(const InternedHeaderName& key) {
+  return getByKey(key.name().get(), key.hash(), ConstSingleton<StaticLookupTable>::get().find(key));
+}
+
+HeaderMapImpl::HeaderEntryImpl*
+HeaderMapImpl::getByKey(absl::string_view key, uint64_t hash,
+                        const StaticLookupEntry* static_entry) const {
+  if (static_entry) {
+    // An O(1) header is only ever stored in the entry its inline pointer refers to. Headers added
+    // with an alias key are stored under another key, so there are none with the alias key.
+    if (static_entry->alias_) {
+      return nullptr;
     }
+    return *static_entry->cb_(const_cast<HeaderMapImpl&>(*this)).entry_;
   }
 
-  return nullptr;
+  HeaderEntryImpl* found = nullptr;
+  headers_.forEach([&](const HeaderEntryImpl& header) {
+    if (header.key_hash_ == hash && header.key().getStringView() == key) {
+      found = const_cast<HeaderEntryImpl*>(&header);
+      return false;
+    }
+    return true;
+  });
+
+  return found;
 }
 
 void HeaderMapImpl::iterate(ConstIterateCb cb, void* context) const {
-  for (const HeaderEntryImpl& header : headers_) {
-    if (cb(header, context) == HeaderMap::Iterate::Break) {
-      break;
-    }
-  }
+  headers_.forEach([cb, context](const HeaderEntryImpl& header) {
+    return cb(header, context) == HeaderMap::Iterate::Continue;
+  });
 }
 
 void HeaderMapImpl::iterateReverse(ConstIterateCb cb, void* context) const {
-  for (auto it = headers_.rbegin(); it != headers_.rend(); it++) {
-    if (cb(*it, context) == HeaderMap::Iterate::Break) {
-      break;
-    }
-  }
+  headers_.forEachReverse([cb, context](const HeaderEntryImpl& header) {
+    return cb(header, context) == HeaderMap::Iterate::Continue;
+  });
 }
 
 HeaderMap::Lookup HeaderMapImpl::lookup(const LowerCaseString& key,
                                         const HeaderEntry** entry) const {
-  StaticLookupEntry::EntryCb cb = ConstSingleton<StaticLookupTable>::get().find(key.get().c_str());
-  if (cb) {
+  const StaticLookupEntry* static_entry =
+      ConstSingleton<StaticLookupTable>::get().find(key.get(), hashKey(key.get()));
+  if (static_entry) {
     // The accessor callbacks for predefined inline headers take a HeaderMapImpl& as an argument;
     // even though we don't make any modifications, we need to cast_cast in order to use the
     // accessor.
     //
     // Making this work without const_cast would require managing an additional const accessor
     // callback for each predefined inline header and add to the complexity of the code.
-    StaticLookupResponse ref_lookup_response = cb(const_cast<HeaderMapImpl&>(*this));
+    StaticLookupResponse ref_lookup_response =
+        static_entry->cb_(const_cast<HeaderMapImpl&>(*this));
     *entry = *ref_lookup_response.entry_;
     if (*entry) {
       return Lookup::Found;
@@ -533,18 +744,23 @@ HeaderMap::Lookup HeaderMapImpl::lookup(const LowerCaseString& key,
 }
 
 void HeaderMapImpl::remove(const LowerCaseString& key) {
-  StaticLookupEntry::EntryCb cb = ConstSingleton<StaticLookupTable>::get().find(key.get().c_str());
-  if (cb) {
-    StaticLookupResponse ref_lookup_response = cb(*this);
+  const uint64_t hash = hashKey(key.get());
+  removeByKey(key.get(), hash, ConstSingleton<StaticLookupTable>::get().find(key.get(), hash));
+}
+
+void HeaderMapImpl::remove(const InternedHeaderName& key) {
+  removeByKey(key.name().get(), key.hash(), ConstSingleton<StaticLookupTable>::get().find(key));
+}
+
+void HeaderMapImpl::removeByKey(absl::string_view key, uint64_t hash,
+                                const StaticLookupEntry* static_entry) {
+  if (static_entry) {
+    StaticLookupResponse ref_lookup_response = static_entry->cb_(*this);
     removeInline(ref_lookup_response.entry_);
   } else {
-    for (auto i = headers_.begin(); i != headers_.end();) {
-      if (i->key() == key.get().c_str()) {
-        i = headers_.erase(i);
-      } else {
-        ++i;
-      }
-    }
+    headers_.remove_if([key, hash](const HeaderEntryImpl& entry) {
+      return entry.key_hash_ == hash && entry.key().getStringView() == key;
+    });
   }
 }
 
@@ -554,10 +770,10 @@ void HeaderMapImpl::removePrefix(const LowerCaseString& prefix) {
     if (to_remove) {
       // If this header should be removed, make sure any references in the
       // static lookup table are cleared as well.
-      StaticLookupEntry::EntryCb cb =
-          ConstSingleton<StaticLookupTable>::get().find(entry.key().c_str());
-      if (cb) {
-        StaticLookupResponse ref_lookup_response = cb(*this);
+      const StaticLookupEntry* static_entry = ConstSingleton<StaticLookupTable>::get().find(
+          entry.key().getStringView(), hashKey(entry.key().getStringView()));
+      if (static_entry) {
+        StaticLookupResponse ref_lookup_response = static_entry->cb_(*this);
         if (ref_lookup_response.entry_) {
           *ref_lookup_response.entry_ = nullptr;
         }
@@ -573,9 +789,7 @@ HeaderMapImpl::HeaderEntryImpl& HeaderMapImpl::maybeCreateInline(HeaderEntryImpl
     return **entry;
   }
 
-  std::list<HeaderEntryImpl>::iterator i = headers_.insert(key);
-  i->entry_ = i;
-  *entry = &(*i);
+  *entry = &headers_.insert(key);
   return **entry;
 }
 
@@ -587,16 +801,14 @@ HeaderMapImpl::HeaderEntryImpl& HeaderMapImpl::maybeCreateInline(HeaderEntryImpl
     return **entry;
   }
 
-  std::list<HeaderEntryImpl>::iterator i = headers_.insert(key, std::move(value));
-  i->entry_ = i;
-  *entry = &(*i);
+  *entry = &headers_.insert(key, std::move(value));
   return **entry;
 }
 
-HeaderMapImpl::HeaderEntryImpl* HeaderMapImpl::getExistingInline(const char* key) {
-  StaticLookupEntry::EntryCb cb = ConstSingleton<StaticLookupTable>::get().find(key);
-  if (cb) {
-    StaticLookupResponse ref_lookup_response = cb(*this);
+HeaderMapImpl::HeaderEntryImpl*
+HeaderMapImpl::getExistingInline(const StaticLookupEntry* static_entry) {
+  if (static_entry) {
+    StaticLookupResponse ref_lookup_response = static_entry->cb_(*this);
     return *ref_lookup_response.entry_;
   }
   return nullptr;
@@ -609,7 +821,7 @@ void HeaderMapImpl::removeInline(HeaderEntryImpl** ptr_to_entry) {
 
   HeaderEntryImpl* entry = *ptr_to_entry;
   *ptr_to_entry = nullptr;
-  headers_.erase(entry->entry_);
+  headers_.erase(*entry);
 }
 
 } // namespace Http
@@ -1,13 +1,16 @@
 #pragma once
 
-#include <array>
 #include <cstdint>
 #include <list>
 #include <memory>
+#include <new>
 #include <string>
+#include <type_traits>
+#include <vector>
 
 #include "envoy/http/header_map.h"
 
+#include "common/common/hash.h"
 #include "common/common/non_copyable.h"
 #include "common/http/headers.h"
 
@@ -62,21 +65,58 @@ public:
    */
   bool operator==(const HeaderMapImpl& rhs) const;
 
+  /**
+   * Select the storage used by header maps constructed after this call. This is intended to be
+   * called once at startup, before any header maps are created.
+   * @param use_list_storage supplies whether to keep entries in a std::list rather than in
+   *        contiguous blocks.
+   */
+  static void useListStorage(bool use_list_storage) { use_list_storage_ = use_list_storage; }
+
+  /**
+   * @return whether this map keeps its entries in a std::list.
+   */
+  bool usesListStorage() const { return headers_.listStorage(); }
+
+  /**
+   * @return uint64_t the hash header maps use for a header key.
+   */
+  static uint64_t hashKey(absl::string_view key) { return HashUtil::xxHash64(key); }
+
+  /**
+   * @param key supplies a header key.
+   * @param hash supplies the key's hash, from hashKey().
+   * @return uint32_t the ID of the key if it is one of the O(1) headers, between 1 and
+   *         inlineHeaderCount(), otherwise 0. This is used by HeaderNameRegistry to give O(1)
+   *         headers the IDs by which maps find their inline pointers.
+   */
+  static uint32_t inlineHeaderId(absl::string_view key, uint64_t hash);
+
+  /**
+   * @return uint32_t the number of keys which are O(1) headers.
+   */
+  static uint32_t inlineHeaderCount();
+
   // Http::HeaderMap
   void addReference(const LowerCaseString& key, const std::string& value) override;
   void addReferenceKey(const LowerCaseString& key, uint64_t value) override;
   void addReferenceKey(const LowerCaseString& key, const std::string& value) override;
+  void addReferenceKey(const InternedHeaderName& key, const std::string& value) override;
   void addCopy(const LowerCaseString& key, uint64_t value) override;
   void addCopy(const LowerCaseString& key, const std::string& value) override;
   void setReference(const LowerCaseString& key, const std::string& value) override;
   void setReferenceKey(const LowerCaseString& key, const std::string& value) override;
+  void setReferenceKey(const InternedHeaderName& key, const std::string& value) override;
   uint64_t byteSize() const override;
   const HeaderEntry* get(const LowerCaseString& key) const override;
   HeaderEntry* get(const LowerCaseString& key) override;
+  const HeaderEntry* get(const InternedHeaderName& key) const override;
+  HeaderEntry* get(const InternedHeaderName& key) override;
   void iterate(ConstIterateCb cb, void* context) const override;
   void iterateReverse(ConstIterateCb cb, void* context) const override;
   Lookup lookup(const LowerCaseString& key, const HeaderEntry** entry) const override;
   void remove(const LowerCaseString& key) override;
+  void remove(const InternedHeaderName& key) override;
   void removePrefix(const LowerCaseString& key) override;
   size_t size() const override { return headers_.size(); }
 
@@ -101,7 +141,12 @@ protected:
 
     HeaderString key_;
     HeaderString value_;
+    // The position of the entry in its HeaderList. Which one is set depends on the backend.
     std::list<HeaderEntryImpl>::iterator entry_;
+    uint32_t index_{};
+    // The hash of the key, from hashKey(). This is only set for headers which are not O(1)
+    // headers, since those are found through their inline pointers.
+    uint64_t key_hash_{};
   };
 
   struct StaticLookupResponse {
@@ -112,20 +157,29 @@ protected:
   struct StaticLookupEntry {
     typedef StaticLookupResponse (*EntryCb)(HeaderMapImpl&);
 
-    EntryCb cb_{};
-    std::array<std::unique_ptr<StaticLookupEntry>, 256> entries_;
+    const LowerCaseString* key_;
+    uint64_t hash_;
+    EntryCb cb_;
+    // Whether headers with this key are stored under another key, as the legacy host header is
+    // stored as :authority.
+    bool alias_;
   };
 
   /**
    * This is the static lookup table that is used to determine whether a header is one of the O(1)
-   * headers. This uses a trie for lookup time at most equal to the size of the incoming string.
+   * headers. Keys are found by their hash in an open addressed index, which holds each key's ID,
+   * and IDs index the entries.
    */
   struct StaticLookupTable {
     StaticLookupTable();
-    void add(const char* key, StaticLookupEntry::EntryCb cb);
-    StaticLookupEntry::EntryCb find(const char* key) const;
-
-    StaticLookupEntry root_;
+    void add(const LowerCaseString& key, StaticLookupEntry::EntryCb cb, bool alias);
+    const StaticLookupEntry* find(absl::string_view key, uint64_t hash) const;
+    const StaticLookupEntry* find(const InternedHeaderName& key) const;
+    uint32_t id(const StaticLookupEntry& entry) const { return &entry - entries_.data() + 1; }
+
+    std::vector<StaticLookupEntry> entries_;
+    // The size is a power of two, and at least four times the number of entries.
+    std::vector<uint32_t> index_;
   };
 
   struct AllInlineHeaders {
@@ -134,7 +188,18 @@ protected:
 
   /**
    * List of HeaderEntryImpl that keeps the pseudo headers (key starting with ':') in the front
-   * of the list (as required by nghttp2) and otherwise maintains insertion order.
+   * of the list (as required by nghttp2) and otherwise maintains insertion order. Entries never
+   * move once inserted, so that the inline header pointers and the HeaderEntry pointers handed out
+   * by the map stay valid until the entry is removed.
+   *
+   * There are two storage backends, chosen when the list is constructed:
+   * - The contiguous backend (the default) allocates entries from blocks, which hold a growing
+   *   number of entries, and keeps the order in a vector of entry pointers. Erasing an entry
+   *   leaves a tombstone (nullptr) in the vector, which is compacted once at least half of it is
+   *   tombstones. This takes a few allocations per map rather than one per header, and iteration
+   *   walks an array.
+   * - The list backend keeps each entry in a std::list node. It is kept so that the two can be
+   *   compared.
    *
    * Note: the internal iterators held in fields make this unsafe to copy and move, since the
    * reference to end() is not preserved across a move (see Notes in
@@ -145,62 +210,162 @@ protected:
    */
   class HeaderList : NonCopyable {
   public:
-    HeaderList() : pseudo_headers_end_(headers_.end()) {}
+    explicit HeaderList(bool list_storage);
+    ~HeaderList();
 
     template <class Key> bool isPseudoHeader(const Key& key) { return key.c_str()[0] == ':'; }
 
-    template <class Key, class... Value>
-    std::list<HeaderEntryImpl>::iterator insert(Key&& key, Value&&... value) {
+    template <class Key, class... Value> HeaderEntryImpl& insert(Key&& key, Value&&... value) {
       const bool is_pseudo_header = isPseudoHeader(key);
-      std::list<HeaderEntryImpl>::iterator i =
-          headers_.emplace(is_pseudo_header ? pseudo_headers_end_ : headers_.end(),
-                           std::forward<Key>(key), std::forward<Value>(value)...);
-      if (!is_pseudo_header && pseudo_headers_end_ == headers_.end()) {
-        pseudo_headers_end_ = i;
+      if (list_storage_) {
+        std::list<HeaderEntryImpl>::iterator i =
+            headers_.emplace(is_pseudo_header ? pseudo_headers_end_ : headers_.end(),
+                             std::forward<Key>(key), std::forward<Value>(value)...);
+        if (!is_pseudo_header && pseudo_headers_end_ == headers_.end()) {
+          pseudo_headers_end_ = i;
+        }
+        i->entry_ = i;
+        return *i;
+      }
+
+      HeaderEntryImpl* entry = new (allocateEntry())
+          HeaderEntryImpl(std::forward<Key>(key), std::forward<Value>(value)...);
+      insertEntry(entry, is_pseudo_header);
+      return *entry;
+    }
+
+    void erase(HeaderEntryImpl& entry);
+
+    template <class UnaryPredicate> void remove_if(UnaryPredicate p) {
+      if (list_storage_) {
+        headers_.remove_if([&](const HeaderEntryImpl& entry) {
+          const bool to_remove = p(entry);
+          if (to_remove) {
+            if (pseudo_headers_end_ == entry.entry_) {
+              pseudo_headers_end_++;
+            }
+          }
+          return to_remove;
+        });
+        return;
+      }
+
+      for (HeaderEntryImpl*& entry : entries_) {
+        if (entry != nullptr && p(*entry)) {
+          freeEntry(entry);
+          entry = nullptr;
+          tombstones_++;
+        }
       }
-      return i;
+      maybeCompact();
     }
 
-    std::list<HeaderEntryImpl>::iterator erase(std::list<HeaderEntryImpl>::iterator i) {
-      if (pseudo_headers_end_ == i) {
-        pseudo_headers_end_++;
+    /**
+     * Call a function for each entry in order, until it returns false.
+     * @param fn supplies the function, which is passed each HeaderEntryImpl.
+     */
+    template <class Fn> void forEach(Fn fn) const {
+      if (list_storage_) {
+        for (const HeaderEntryImpl& entry : headers_) {
+          if (!fn(entry)) {
+            return;
+          }
+        }
+        return;
+      }
+
+      for (const HeaderEntryImpl* entry : entries_) {
+        if (entry != nullptr && !fn(*entry)) {
+          return;
+        }
       }
-      return headers_.erase(i);
     }
 
-    template <class UnaryPredicate> void remove_if(UnaryPredicate p) {
-      headers_.remove_if([&](const HeaderEntryImpl& entry) {
-        const bool to_remove = p(entry);
-        if (to_remove) {
-          if (pseudo_headers_end_ == entry.entry_) {
-            pseudo_headers_end_++;
+    template <class Fn> void forEach(Fn fn) {
+      static_cast<const HeaderList*>(this)->forEach(
+          [&fn](const HeaderEntryImpl& entry) { return fn(const_cast<HeaderEntryImpl&>(entry)); });
+    }
+
+    /**
+     * Call a function for each entry in reverse order, until it returns false.
+     * @param fn supplies the function, which is passed each HeaderEntryImpl.
+     */
+    template <class Fn> void forEachReverse(Fn fn) const {
+      if (list_storage_) {
+        for (auto i = headers_.rbegin(); i != headers_.rend(); i++) {
+          if (!fn(*i)) {
+            return;
           }
         }
-        return to_remove;
-      });
+        return;
+      }
+
+      for (auto i = entries_.rbegin(); i != entries_.rend(); i++) {
+        if (*i != nullptr && !fn(**i)) {
+          return;
+        }
+      }
     }
 
-    std::list<HeaderEntryImpl>::iterator begin() { return headers_.begin(); }
-    std::list<HeaderEntryImpl>::iterator end() { return headers_.end(); }
-    std::list<HeaderEntryImpl>::const_iterator begin() const { return headers_.begin(); }
-    std::list<HeaderEntryImpl>::const_iterator end() const { return headers_.end(); }
-    std::list<HeaderEntryImpl>::const_reverse_iterator rbegin() const { return headers_.rbegin(); }
-    std::list<HeaderEntryImpl>::const_reverse_iterator rend() const { return headers_.rend(); }
-    size_t size() const { return headers_.size(); }
+    size_t size() const { return list_storage_ ? headers_.size() : entries_.size() - tombstones_; }
+
+    bool listStorage() const { return list_storage_; }
 
   private:
+    // Entries are constructed in place in these slots.
+    using EntryStorage =
+        std::aligned_storage<sizeof(HeaderEntryImpl), alignof(HeaderEntryImpl)>::type;
+
+    // A block of entry slots, which is followed in memory by its slots.
+    struct EntryBlock {
+      EntryBlock* next_;
+      uint32_t capacity_;
+      uint32_t used_;
+
+      EntryStorage* slots() { return reinterpret_cast<EntryStorage*>(this + 1); }
+    };
+
+    // The number of entries in the first block. Each further block is twice the size of the
+    // previous one.
+    static constexpr uint32_t FirstBlockCapacity = 16;
+
+    void* allocateEntry();
+    void freeEntry(HeaderEntryImpl* entry);
+    void insertEntry(HeaderEntryImpl* entry, bool is_pseudo_header);
+    void maybeCompact();
+    void compact();
+
+    const bool list_storage_;
+
+    // Used only by the list backend.
     std::list<HeaderEntryImpl> headers_;
     std::list<HeaderEntryImpl>::iterator pseudo_headers_end_;
+
+    // Used only by the contiguous backend. Blocks are linked newest first.
+    std::vector<HeaderEntryImpl*> entries_;
+    // The index in entries_ of the first regular header, or of the end if there are none.
+    uint32_t pseudo_headers_index_{};
+    uint32_t tombstones_{};
+    EntryBlock* blocks_{};
+    // Slots of erased entries, linked through their storage.
+    void* free_slots_{};
   };
 
   void insertByKey(HeaderString&& key, HeaderString&& value);
+  void insertByKey(HeaderString&& key, uint64_t hash, const StaticLookupEntry* static_entry,
+                   HeaderString&& value);
   HeaderEntryImpl& maybeCreateInline(HeaderEntryImpl** entry, const LowerCaseString& key);
   HeaderEntryImpl& maybeCreateInline(HeaderEntryImpl** entry, const LowerCaseString& key,
                                      HeaderString&& value);
-  HeaderEntryImpl* getExistingInline(const char* key);
+  HeaderEntryImpl* getExistingInline(const StaticLookupEntry* static_entry);
+  HeaderEntryImpl* getByKey(absl::string_view key, uint64_t hash,
+                            const StaticLookupEntry* static_entry) const;
+  void removeByKey(absl::string_view key, uint64_t hash, const StaticLookupEntry* static_entry);
 
   void removeInline(HeaderEntryImpl** entry);
 
+  static bool use_list_storage_;
+
   AllInlineHeaders inline_headers_;
   HeaderList headers_;
 
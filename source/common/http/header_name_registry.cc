@@ -0,0 +1,48 @@
+#include "common/http/header_name_registry.h"
+
+#include <string>
+#include <unordered_map>
+
+#include "common/common/lock_guard.h"
+#include "common/common/thread.h"
+#include "common/http/header_map_impl.h"
+
+namespace Envoy {
+namespace Http {
+
+namespace {
+
+struct Registry {
+  Thread::MutexBasicLockable lock_;
+  std::unordered_map<std::string, uint32_t> ids_ GUARDED_BY(lock_);
+  uint32_t next_id_ GUARDED_BY(lock_){HeaderMapImpl::inlineHeaderCount() + 1};
+};
+
+Registry& registry() {
+  // Leaked so that names can be interned during static destruction.
+  static Registry* registry = new Registry();
+  return *registry;
+}
+
+} // namespace
+
+InternedHeaderName HeaderNameRegistry::intern(const LowerCaseString& name) {
+  const uint64_t hash = HeaderMapImpl::hashKey(name.get());
+  uint32_t id = HeaderMapImpl::inlineHeaderId(name.get(), hash);
+  if (id == 0) {
+    Registry& names = registry();
+    Thread::LockGuard lock(names.lock_);
+    auto it = names.ids_.find(name.get());
+    if (it != names.ids_.end()) {
+      id = it->second;
+    } else if (names.ids_.size() < HeaderNameRegistry::MaxNames) {
+      id = names.next_id_++;
+      names.ids_.emplace(name.get(), id);
+    }
+  }
+
+  return InternedHeaderName(name, hash, id);
+}
+
+} // namespace Http
+} // namespace Envoy
@@ -0,0 +1,33 @@
+#pragma once
+
+#include "envoy/http/header_map.h"
+
+namespace Envoy {
+namespace Http {
+
+/**
+ * Interns header names, giving each distinct name a stable ID and working out its hash, so that
+ * header maps can look it up without hashing or comparing strings. The O(1) headers of
+ * HeaderMapImpl have the IDs from HeaderMapImpl::inlineHeaderId(), which is how maps find their
+ * inline pointers, and other names get the following IDs in the order they are first interned.
+ *
+ * Interning takes a lock and the registry never forgets a name, so names should be interned when
+ * configuration is loaded rather than per request. Names can come from configuration received over
+ * xDS, so the registry holds at most MaxNames names other than the O(1) headers. Names interned
+ * after that get ID 0. They still carry their hash, and header maps look them up like names which
+ * were not interned.
+ */
+class HeaderNameRegistry {
+public:
+  static const uint32_t MaxNames = 4096;
+
+  /**
+   * @param name supplies the header name.
+   * @return InternedHeaderName the interned name, which has the same ID every time a name is
+   *         interned, or ID 0 if it is not an O(1) header and the registry is full.
+   */
+  static InternedHeaderName intern(const LowerCaseString& name);
+};
+
+} // namespace Http
+} // namespace Envoy
@@ -1,8 +1,10 @@
 #include "common/http/header_utility.h"
 
+#include "common/common/regex.h"
 #include "common/common/utility.h"
 #include "common/config/rds_json.h"
 #include "common/http/header_map_impl.h"
+#include "common/http/header_name_registry.h"
 #include "common/protobuf/utility.h"
 
 #include "absl/strings/match.h"
@@ -23,7 +25,8 @@ namespace Http {
 //   f.prefix_match: Match will succeed if header value matches the prefix value specified here.
 //   g.suffix_match: Match will succeed if header value matches the suffix value specified here.
 HeaderUtility::HeaderData::HeaderData(const envoy::api::v2::route::HeaderMatcher& config)
-    : name_(config.name()), invert_match_(config.invert_match()) {
+    : name_(HeaderNameRegistry::intern(LowerCaseString(config.name()))),
+      invert_match_(config.invert_match()) {
   switch (config.header_match_specifier_case()) {
   case envoy::api::v2::route::HeaderMatcher::kExactMatch:
     header_match_type_ = HeaderMatchType::Value;
@@ -31,7 +34,7 @@ HeaderUtility::HeaderData::HeaderData(const envoy::api::v2::route::HeaderMatcher
     break;
   case envoy::api::v2::route::HeaderMatcher::kRegexMatch:
     header_match_type_ = HeaderMatchType::Regex;
-    regex_pattern_ = RegexUtil::parseRegex(config.regex_match());
+    regex_pattern_ = Regex::Utility::parseRegex(config.regex_match());
     break;
   case envoy::api::v2::route::HeaderMatcher::kRangeMatch:
     header_match_type_ = HeaderMatchType::Range;
@@ -92,7 +95,7 @@ bool HeaderUtility::matchHeaders(const Http::HeaderMap& request_headers,
     match = header_data.value_.empty() || header->value() == header_data.value_.c_str();
     break;
   case HeaderMatchType::Regex:
-    match = std::regex_match(header->value().c_str(), header_data.regex_pattern_);
+    match = header_data.regex_pattern_->match(header->value().getStringView());
     break;
   case HeaderMatchType::Range: {
     int64_t header_value = 0;
@@ -1,9 +1,9 @@
 #pragma once
 
-#include <regex>
 #include <vector>
 
 #include "envoy/api/v2/route/route.pb.h"
+#include "envoy/common/regex.h"
 #include "envoy/http/header_map.h"
 #include "envoy/json/json_object.h"
 #include "envoy/type/range.pb.h"
@@ -25,10 +25,10 @@ public:
     HeaderData(const envoy::api::v2::route::HeaderMatcher& config);
     HeaderData(const Json::Object& config);
 
-    const Http::LowerCaseString name_;
+    const Http::InternedHeaderName name_;
     HeaderMatchType header_match_type_;
     std::string value_;
-    std::regex regex_pattern_;
+    Regex::CompiledMatcherSharedPtr regex_pattern_;
     envoy::type::Int64Range range_;
     const bool invert_match_;
   };
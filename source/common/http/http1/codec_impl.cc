@@ -14,6 +14,8 @@
 #include "common/common/utility.h"
 #include "common/http/exception.h"
 #include "common/http/headers.h"
+#include "common/http/http1/legacy_parser_impl.h"
+#include "common/http/http1/simd_parser_impl.h"
 #include "common/http/utility.h"
 
 namespace Envoy {
@@ -265,38 +267,7 @@ void RequestStreamEncoderImpl::encodeHeaders(const HeaderMap& headers, bool end_
   StreamEncoderImpl::encodeHeaders(headers, end_stream);
 }
 
-http_parser_settings ConnectionImpl::settings_{
-    [](http_parser* parser) -> int {
-      static_cast<ConnectionImpl*>(parser->data)->onMessageBeginBase();
-      return 0;
-    },
-    [](http_parser* parser, const char* at, size_t length) -> int {
-      static_cast<ConnectionImpl*>(parser->data)->onUrl(at, length);
-      return 0;
-    },
-    nullptr, // on_status
-    [](http_parser* parser, const char* at, size_t length) -> int {
-      static_cast<ConnectionImpl*>(parser->data)->onHeaderField(at, length);
-      return 0;
-    },
-    [](http_parser* parser, const char* at, size_t length) -> int {
-      static_cast<ConnectionImpl*>(parser->data)->onHeaderValue(at, length);
-      return 0;
-    },
-    [](http_parser* parser) -> int {
-      return static_cast<ConnectionImpl*>(parser->data)->onHeadersCompleteBase();
-    },
-    [](http_parser* parser, const char* at, size_t length) -> int {
-      static_cast<ConnectionImpl*>(parser->data)->onBody(at, length);
-      return 0;
-    },
-    [](http_parser* parser) -> int {
-      static_cast<ConnectionImpl*>(parser->data)->onMessageCompleteBase();
-      return 0;
-    },
-    nullptr, // on_chunk_header
-    nullptr  // on_chunk_complete
-};
+bool ConnectionImpl::use_simd_parser_ = false;
 
 const ToLowerTable& ConnectionImpl::toLowerTable() {
   static ToLowerTable* table = new ToLowerTable();
@@ -307,15 +278,20 @@ ConnectionImpl::ConnectionImpl(Network::Connection& connection, http_parser_type
     : connection_(connection), output_buffer_([&]() -> void { this->onBelowLowWatermark(); },
                                               [&]() -> void { this->onAboveHighWatermark(); }) {
   output_buffer_.setWatermarks(connection.bufferLimit());
-  http_parser_init(&parser_, type);
-  parser_.data = this;
+  if (use_simd_parser_) {
+    parser_ = std::make_unique<SimdParserImpl>(type, parser_callbacks_);
+  } else {
+    parser_ = std::make_unique<LegacyParserImpl>(type, parser_callbacks_);
+  }
 }
 
 void ConnectionImpl::completeLastHeader() {
   ENVOY_CONN_LOG(trace, "completed header: key={} value={}", connection_,
                  current_header_field_.c_str(), current_header_value_.c_str());
   if (!current_header_field_.empty()) {
-    toLowerTable().toLowerCase(current_header_field_.buffer(), current_header_field_.size());
+    if (!parser_->lowerCasesHeaderNames()) {
+      toLowerTable().toLowerCase(current_header_field_.buffer(), current_header_field_.size());
+    }
     current_header_map_->addViaMove(std::move(current_header_field_),
                                     std::move(current_header_value_));
   }
@@ -352,7 +328,7 @@ void ConnectionImpl::dispatch(Buffer::Instance& data) {
   }
 
   // Always unpause before dispatch.
-  http_parser_pause(&parser_, 0);
+  parser_->pause(false);
 
   ssize_t total_parsed = 0;
   if (data.length() > 0) {
@@ -375,11 +351,11 @@ void ConnectionImpl::dispatch(Buffer::Instance& data) {
 }
 
 size_t ConnectionImpl::dispatchSlice(const char* slice, size_t len) {
-  ssize_t rc = http_parser_execute(&parser_, &settings_, slice, len);
-  if (HTTP_PARSER_ERRNO(&parser_) != HPE_OK && HTTP_PARSER_ERRNO(&parser_) != HPE_PAUSED) {
+  ssize_t rc = parser_->execute(slice, len);
+  if (parser_->error() != HPE_OK && parser_->error() != HPE_PAUSED) {
     sendProtocolError();
     throw CodecProtocolException("http/1.1 protocol error: " +
-                                 std::string(http_errno_name(HTTP_PARSER_ERRNO(&parser_))));
+                                 std::string(http_errno_name(parser_->error())));
   }
 
   return rc;
@@ -411,7 +387,7 @@ void ConnectionImpl::onHeaderValue(const char* data, size_t length) {
 int ConnectionImpl::onHeadersCompleteBase() {
   ENVOY_CONN_LOG(trace, "headers complete", connection_);
   completeLastHeader();
-  if (!(parser_.http_major == 1 && parser_.http_minor == 1)) {
+  if (!(parser_->httpMajor() == 1 && parser_->httpMinor() == 1)) {
     // This is not necessarily true, but it's good enough since higher layers only care if this is
     // HTTP/1.1 or not.
     protocol_ = Protocol::Http10;
@@ -436,7 +412,7 @@ void ConnectionImpl::onMessageCompleteBase() {
     // upgrade payload will be treated as stream body.
     ASSERT(!deferred_end_stream_headers_);
     ENVOY_CONN_LOG(trace, "Pausing parser due to upgrade.", connection_);
-    http_parser_pause(&parser_, 1);
+    parser_->pause(true);
     return;
   }
   onMessageComplete();
@@ -553,15 +529,15 @@ int ServerConnectionImpl::onHeadersComplete(HeaderMapImplPtr&& headers) {
   // to disconnect the connection but we shouldn't fire any more events since it doesn't make
   // sense.
   if (active_request_) {
-    const char* method_string = http_method_str(static_cast<http_method>(parser_.method));
+    const char* method_string = http_method_str(parser_->method());
 
     // Inform the response encoder about any HEAD method, so it can set content
     // length and transfer encoding headers correctly.
-    active_request_->response_encoder_.isResponseToHeadRequest(parser_.method == HTTP_HEAD);
+    active_request_->response_encoder_.isResponseToHeadRequest(parser_->method() == HTTP_HEAD);
 
     // Currently, CONNECT is not supported, however; http_parser_parse_url needs to know about
     // CONNECT
-    handlePath(*headers, parser_.method);
+    handlePath(*headers, parser_->method());
     ASSERT(active_request_->request_url_.empty());
 
     headers->insertMethod().value(method_string, strlen(method_string));
@@ -572,14 +548,15 @@ int ServerConnectionImpl::onHeadersComplete(HeaderMapImplPtr&& headers) {
     // with message complete. This allows upper layers to behave like HTTP/2 and prevents a proxy
     // scenario where the higher layers stream through and implicitly switch to chunked transfer
     // encoding because end stream with zero body length has not yet been indicated.
-    if (parser_.flags & F_CHUNKED ||
-        (parser_.content_length > 0 && parser_.content_length != ULLONG_MAX) || handling_upgrade_) {
+    if (parser_->chunked() ||
+        (parser_->contentLength() > 0 && parser_->contentLength() != ULLONG_MAX) ||
+        handling_upgrade_) {
       active_request_->request_decoder_->decodeHeaders(std::move(headers), false);
 
       // If the connection has been closed (or is closing) after decoding headers, pause the parser
       // so we return control to the caller.
       if (connection_.state() != Network::Connection::State::Open) {
-        http_parser_pause(&parser_, 1);
+        parser_->pause(true);
       }
 
     } else {
@@ -630,7 +607,7 @@ void ServerConnectionImpl::onMessageComplete() {
   // Always pause the parser so that the calling code can process 1 request at a time and apply
   // back pressure. However this means that the calling code needs to detect if there is more data
   // in the buffer and dispatch it again.
-  http_parser_pause(&parser_, 1);
+  parser_->pause(true);
 }
 
 void ServerConnectionImpl::onResetStream(StreamResetReason reason) {
@@ -669,7 +646,7 @@ ClientConnectionImpl::ClientConnectionImpl(Network::Connection& connection, Conn
 
 bool ClientConnectionImpl::cannotHaveBody() {
   if ((!pending_responses_.empty() && pending_responses_.front().head_request_) ||
-      parser_.status_code == 204 || parser_.status_code == 304) {
+      parser_->statusCode() == 204 || parser_->statusCode() == 304) {
     return true;
   } else {
     return false;
@@ -699,7 +676,7 @@ void ClientConnectionImpl::onEncodeHeaders(const HeaderMap& headers) {
 }
 
 int ClientConnectionImpl::onHeadersComplete(HeaderMapImplPtr&& headers) {
-  headers->insertStatus().value(parser_.status_code);
+  headers->insertStatus().value(parser_->statusCode());
 
   // Handle the case where the client is closing a kept alive connection (by sending a 408
   // with a 'Connection: close' header). In this case we just let response flush out followed
@@ -707,7 +684,7 @@ int ClientConnectionImpl::onHeadersComplete(HeaderMapImplPtr&& headers) {
   if (pending_responses_.empty() && !resetStreamCalled()) {
     throw PrematureResponseException(std::move(headers));
   } else if (!pending_responses_.empty()) {
-    if (parser_.status_code == 100) {
+    if (parser_->statusCode() == 100) {
       // http-parser treats 100 continue headers as their own complete response.
       // Swallow the spurious onMessageComplete and continue processing.
       ignore_message_complete_for_100_continue_ = true;
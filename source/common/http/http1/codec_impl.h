@@ -4,6 +4,7 @@
 
 #include <array>
 #include <cstdint>
+#include <limits>
 #include <list>
 #include <memory>
 #include <string>
@@ -17,6 +18,7 @@
 #include "common/http/codec_helper.h"
 #include "common/http/codes.h"
 #include "common/http/header_map_impl.h"
+#include "common/http/http1/parser.h"
 
 namespace Envoy {
 namespace Http {
@@ -162,13 +164,20 @@ public:
 
   bool maybeDirectDispatch(Buffer::Instance& data);
 
+  /**
+   * Select the parser engine used by connections constructed after this call. This is intended to
+   * be called once at startup.
+   * @param use_simd_parser supplies whether to use the SIMD parser rather than http_parser.
+   */
+  static void useSimdParser(bool use_simd_parser) { use_simd_parser_ = use_simd_parser; }
+
 protected:
   ConnectionImpl(Network::Connection& connection, http_parser_type type);
 
   bool resetStreamCalled() { return reset_stream_called_; }
 
   Network::Connection& connection_;
-  http_parser parser_;
+  ParserPtr parser_;
   HeaderMapPtr deferred_end_stream_headers_;
   Http::Code error_code_{Http::Code::BadRequest};
   bool handling_upgrade_{};
@@ -176,6 +185,30 @@ protected:
 private:
   enum class HeaderParsingState { Field, Value, Done };
 
+  /**
+   * Forwards parser callbacks to the connection.
+   */
+  class ParserCallbacksImpl : public ParserCallbacks {
+  public:
+    ParserCallbacksImpl(ConnectionImpl& parent) : parent_(parent) {}
+
+    // Http1::ParserCallbacks
+    void onMessageBegin() override { parent_.onMessageBeginBase(); }
+    void onUrl(const char* data, size_t length) override { parent_.onUrl(data, length); }
+    void onHeaderField(const char* data, size_t length) override {
+      parent_.onHeaderField(data, length);
+    }
+    void onHeaderValue(const char* data, size_t length) override {
+      parent_.onHeaderValue(data, length);
+    }
+    int onHeadersComplete() override { return parent_.onHeadersCompleteBase(); }
+    void onBody(const char* data, size_t length) override { parent_.onBody(data, length); }
+    void onMessageComplete() override { parent_.onMessageCompleteBase(); }
+
+  private:
+    ConnectionImpl& parent_;
+  };
+
   /**
    * Called in order to complete an in progress header decode.
    */
@@ -259,9 +292,11 @@ private:
    */
   virtual void onBelowLowWatermark() PURE;
 
-  static http_parser_settings settings_;
   static const ToLowerTable& toLowerTable();
 
+  static bool use_simd_parser_;
+
+  ParserCallbacksImpl parser_callbacks_{*this};
   HeaderMapImplPtr current_header_map_;
   HeaderParsingState header_parsing_state_{HeaderParsingState::Field};
   HeaderString current_header_field_;
@@ -333,6 +368,7 @@ public:
 
   // Http::ClientConnection
   StreamEncoder& newStream(StreamDecoder& response_decoder) override;
+  uint64_t sendWindow() override { return std::numeric_limits<uint64_t>::max(); }
 
 private:
   struct PendingResponse {
@@ -1,6 +1,9 @@
 #include "common/http/http1/conn_pool.h"
 
+#include <algorithm>
+#include <chrono>
 #include <cstdint>
+#include <limits>
 #include <list>
 #include <memory>
 
@@ -52,6 +55,24 @@ void ConnPoolImpl::drainConnections() {
   }
 }
 
+void ConnPoolImpl::preconnect(uint32_t connections) {
+  // Clients which are still connecting are on the busy list.
+  while (drained_callbacks_.empty() && ready_clients_.size() + busy_clients_.size() < connections &&
+         host_->cluster().resourceManager(priority_).connections().canCreate()) {
+    ENVOY_LOG(debug, "preconnecting");
+    host_->cluster().stats().upstream_cx_preconnect_.inc();
+    createNewConnection();
+  }
+}
+
+void ConnPoolImpl::preconnectForDemand() {
+  const uint64_t target =
+      preconnect_tracker_.targetConnections(num_active_requests_ + pending_requests_.size(),
+                                            host_->cluster().perUpstreamPreconnectRatio());
+  preconnect(static_cast<uint32_t>(
+      std::min<uint64_t>(target, std::numeric_limits<uint32_t>::max())));
+}
+
 void ConnPoolImpl::addDrainedCallback(DrainedCb cb) {
   drained_callbacks_.push_back(cb);
   checkForDrained();
@@ -77,35 +98,68 @@ void ConnPoolImpl::checkForDrained() {
 }
 
 void ConnPoolImpl::createNewConnection() {
+  if (takeParkedConnection()) {
+    return;
+  }
+
   ENVOY_LOG(debug, "creating a new connection");
   ActiveClientPtr client(new ActiveClient(*this));
   client->moveIntoList(std::move(client), busy_clients_);
 }
 
+bool ConnPoolImpl::takeParkedConnection() {
+  if (parkedConnections() == nullptr) {
+    return false;
+  }
+  bool other_worker = false;
+  Network::ConnectionSocketPtr socket =
+      parkedConnections()->take(other_worker, dispatcher_.timeSystem().monotonicTime());
+  if (socket == nullptr) {
+    return false;
+  }
+
+  ENVOY_LOG(debug, "taking a parked connection");
+  host_->cluster().stats().upstream_cx_idle_taken_.inc();
+  if (other_worker) {
+    host_->cluster().stats().upstream_cx_cross_worker_handoff_.inc();
+  }
+  ActiveClientPtr client(new ActiveClient(*this, std::move(socket)));
+  client->moveIntoList(std::move(client), busy_clients_);
+  return true;
+}
+
 ConnectionPool::Cancellable* ConnPoolImpl::newStream(StreamDecoder& response_decoder,
                                                      ConnectionPool::Callbacks& callbacks) {
   host_->cluster().stats().upstream_rq_total_.inc();
   host_->stats().rq_total_.inc();
+  preconnect_tracker_.onNewRequest(num_active_requests_ + pending_requests_.size() + 1);
   if (!ready_clients_.empty()) {
     ready_clients_.front()->moveBetweenLists(ready_clients_, busy_clients_);
     ENVOY_CONN_LOG(debug, "using existing connection", *busy_clients_.front()->codec_client_);
     attachRequestToClient(*busy_clients_.front(), response_decoder, callbacks);
+    preconnectForDemand();
     return nullptr;
   }
 
   if (host_->cluster().resourceManager(priority_).pendingRequests().canCreate()) {
-    bool can_create_connection =
+    // A parked connection is already counted by the connection circuit breaker, so one is taken
+    // even when the breaker has no room for a new connection.
+    const bool can_create_connection =
         host_->cluster().resourceManager(priority_).connections().canCreate();
-    if (!can_create_connection) {
+    if (can_create_connection) {
+      createNewConnection();
+    } else if (!takeParkedConnection()) {
       host_->cluster().stats().upstream_cx_overflow_.inc();
-    }
 
-    // If we have no connections at all, make one no matter what so we don't starve.
-    if ((ready_clients_.size() == 0 && busy_clients_.size() == 0) || can_create_connection) {
-      createNewConnection();
+      // If we have no connections at all, make one no matter what so we don't starve.
+      if (ready_clients_.size() == 0 && busy_clients_.size() == 0) {
+        createNewConnection();
+      }
     }
 
-    return newPendingRequest(response_decoder, callbacks);
+    ConnectionPool::Cancellable* pending_request = newPendingRequest(response_decoder, callbacks);
+    preconnectForDemand();
+    return pending_request;
   } else {
     ENVOY_LOG(debug, "max pending requests overflow");
     callbacks.onPoolFailure(ConnectionPool::PoolFailureReason::Overflow, nullptr);
@@ -177,7 +231,9 @@ void ConnPoolImpl::onConnectionEvent(ActiveClient& client, Network::ConnectionEv
   // drain/destruction event, we key off of the existence of the connect timer above to determine
   // whether the client is in the ready list (connected) or the busy list (failed to connect).
   if (event == Network::ConnectionEvent::Connected) {
-    conn_connect_ms_->complete();
+    if (!client.adopted_) {
+      conn_connect_ms_->complete();
+    }
     processIdleClient(client, false);
   }
 }
@@ -221,6 +277,39 @@ void ConnPoolImpl::onUpstreamReady() {
   }
 }
 
+void ConnPoolImpl::parkClient(ActiveClient& client) {
+  ENVOY_CONN_LOG(debug, "parking idle connection", *client.codec_client_);
+  // Releasing the socket closes the connection, which removes the client from the ready list. The
+  // socket is closed if there is no room to park it.
+  Network::ConnectionSocketPtr socket = client.codec_client_->releaseSocket();
+  if (socket != nullptr &&
+      parkedConnections()->park(socket, priority_, dispatcher_.timeSystem().monotonicTime())) {
+    host_->cluster().stats().upstream_cx_idle_parked_.inc();
+    client.parked_ = true;
+    closeIdleParkedConnections();
+  }
+}
+
+void ConnPoolImpl::closeIdleParkedConnections() {
+  // Any pool which parked a connection keeps a timer for the next parked connection of the host to
+  // reach its idle timeout, whichever worker parked it.
+  const absl::optional<std::chrono::milliseconds> next_timeout =
+      parkedConnections()->closeIdle(dispatcher_.timeSystem().monotonicTime());
+  if (next_timeout.has_value()) {
+    if (parked_idle_timer_ == nullptr) {
+      parked_idle_timer_ = dispatcher_.createTimer([this]() { closeIdleParkedConnections(); });
+    }
+    parked_idle_timer_->enableTimer(next_timeout.value());
+  }
+}
+
+Upstream::ParkedConnections* ConnPoolImpl::parkedConnections() const {
+  // The parked connections of a host are shared by all of its pools, but a socket keeps the options
+  // of the pool which opened it, such as a source address or mark taken from the downstream
+  // connection. Only pools without options, which all open the same kind of socket, share them.
+  return socket_options_ == nullptr ? host_->parkedConnections() : nullptr;
+}
+
 void ConnPoolImpl::processIdleClient(ActiveClient& client, bool delay) {
   client.stream_wrapper_.reset();
   if (pending_requests_.empty() || delay) {
@@ -228,6 +317,13 @@ void ConnPoolImpl::processIdleClient(ActiveClient& client, bool delay) {
     // into the ready list.
     ENVOY_CONN_LOG(debug, "moving to ready", *client.codec_client_);
     client.moveBetweenLists(busy_clients_, ready_clients_);
+
+    // Keep one idle connection for the next request, and park the others for any worker to take.
+    // Connections with a request limit are kept, as the limit would not follow them.
+    if (pending_requests_.empty() && ready_clients_.size() > 1 && drained_callbacks_.empty() &&
+        parkedConnections() != nullptr && client.remaining_requests_ == 0) {
+      parkClient(client);
+    }
   } else {
     // There is work to do immediately so bind a request to the client and move it to the busy list.
     // Pending requests are pushed onto the front, so pull from the back.
@@ -252,11 +348,13 @@ ConnPoolImpl::StreamWrapper::StreamWrapper(StreamDecoder& response_decoder, Acti
   StreamEncoderWrapper::inner_.getStream().addCallbacks(*this);
   parent_.parent_.host_->cluster().stats().upstream_rq_active_.inc();
   parent_.parent_.host_->stats().rq_active_.inc();
+  parent_.parent_.num_active_requests_++;
 }
 
 ConnPoolImpl::StreamWrapper::~StreamWrapper() {
   parent_.parent_.host_->cluster().stats().upstream_rq_active_.dec();
   parent_.parent_.host_->stats().rq_active_.dec();
+  parent_.parent_.num_active_requests_--;
 }
 
 void ConnPoolImpl::StreamWrapper::onEncodeComplete() { encode_complete_ = true; }
@@ -286,14 +384,33 @@ ConnPoolImpl::ActiveClient::ActiveClient(ConnPoolImpl& parent)
       parent_.host_->cluster().stats().upstream_cx_connect_ms_, parent_.dispatcher_.timeSystem());
   Upstream::Host::CreateConnectionData data =
       parent_.host_->createConnection(parent_.dispatcher_, parent_.socket_options_);
+  parent_.host_->cluster().stats().upstream_cx_total_.inc();
+  parent_.host_->cluster().stats().upstream_cx_http1_total_.inc();
+  parent_.host_->stats().cx_total_.inc();
+  initialize(data);
+}
+
+ConnPoolImpl::ActiveClient::ActiveClient(ConnPoolImpl& parent,
+                                         Network::ConnectionSocketPtr&& socket)
+    : parent_(parent),
+      connect_timer_(parent_.dispatcher_.createTimer([this]() -> void { onConnectTimeout(); })),
+      remaining_requests_(parent_.host_->cluster().maxRequestsPerConnection()), adopted_(true) {
+
+  const Upstream::ClusterInfo& cluster = parent_.host_->cluster();
+  Upstream::Host::CreateConnectionData data{
+      parent_.dispatcher_.adoptClientConnection(
+          std::move(socket), cluster.transportSocketFactory().createTransportSocket()),
+      parent_.host_};
+  data.connection_->setBufferLimits(cluster.perConnectionBufferLimitBytes());
+  initialize(data);
+}
+
+void ConnPoolImpl::ActiveClient::initialize(Upstream::Host::CreateConnectionData& data) {
   real_host_description_ = data.host_description_;
   codec_client_ = parent_.createCodecClient(data);
   codec_client_->addConnectionCallbacks(*this);
 
-  parent_.host_->cluster().stats().upstream_cx_total_.inc();
   parent_.host_->cluster().stats().upstream_cx_active_.inc();
-  parent_.host_->cluster().stats().upstream_cx_http1_total_.inc();
-  parent_.host_->stats().cx_total_.inc();
   parent_.host_->stats().cx_active_.inc();
   conn_length_ = std::make_unique<Stats::Timespan>(
       parent_.host_->cluster().stats().upstream_cx_length_ms_, parent_.dispatcher_.timeSystem());
@@ -311,7 +428,9 @@ ConnPoolImpl::ActiveClient::ActiveClient(ConnPoolImpl& parent)
 ConnPoolImpl::ActiveClient::~ActiveClient() {
   parent_.host_->cluster().stats().upstream_cx_active_.dec();
   parent_.host_->stats().cx_active_.dec();
-  conn_length_->complete();
+  if (!parked_) {
+    conn_length_->complete();
+  }
   parent_.host_->cluster().resourceManager(parent_.priority_).connections().dec();
 }
 
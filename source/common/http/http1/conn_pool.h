@@ -11,10 +11,11 @@
 #include "envoy/stats/timespan.h"
 #include "envoy/upstream/upstream.h"
 
-#include "common/common/linked_object.h"
+#include "common/common/intrusive_list.h"
 #include "common/http/codec_client.h"
 #include "common/http/codec_wrappers.h"
 #include "common/http/conn_pool_base.h"
+#include "common/upstream/preconnect_tracker.h"
 
 #include "absl/types/optional.h"
 
@@ -40,6 +41,7 @@ public:
   Http::Protocol protocol() const override { return Http::Protocol::Http11; }
   void addDrainedCallback(DrainedCb cb) override;
   void drainConnections() override;
+  void preconnect(uint32_t connections) override;
   ConnectionPool::Cancellable* newStream(StreamDecoder& response_decoder,
                                          ConnectionPool::Callbacks& callbacks) override;
 
@@ -76,12 +78,15 @@ protected:
 
   typedef std::unique_ptr<StreamWrapper> StreamWrapperPtr;
 
-  struct ActiveClient : LinkedObject<ActiveClient>,
+  struct ActiveClient : IntrusiveListItem<ActiveClient>,
                         public Network::ConnectionCallbacks,
                         public Event::DeferredDeletable {
     ActiveClient(ConnPoolImpl& parent);
+    // Continues a connection which another client parked.
+    ActiveClient(ConnPoolImpl& parent, Network::ConnectionSocketPtr&& socket);
     ~ActiveClient();
 
+    void initialize(Upstream::Host::CreateConnectionData& data);
     void onConnectTimeout();
 
     // Network::ConnectionCallbacks
@@ -98,28 +103,40 @@ protected:
     Event::TimerPtr connect_timer_;
     Stats::TimespanPtr conn_length_;
     uint64_t remaining_requests_;
+    const bool adopted_{};
+    bool parked_{};
   };
 
   typedef std::unique_ptr<ActiveClient> ActiveClientPtr;
 
   void attachRequestToClient(ActiveClient& client, StreamDecoder& response_decoder,
                              ConnectionPool::Callbacks& callbacks);
+  void closeIdleParkedConnections();
   virtual CodecClientPtr createCodecClient(Upstream::Host::CreateConnectionData& data) PURE;
   void createNewConnection();
   void onConnectionEvent(ActiveClient& client, Network::ConnectionEvent event);
   void onDownstreamReset(ActiveClient& client);
   void onResponseComplete(ActiveClient& client);
   void onUpstreamReady();
+  void parkClient(ActiveClient& client);
+  Upstream::ParkedConnections* parkedConnections() const;
+  void preconnectForDemand();
   void processIdleClient(ActiveClient& client, bool delay);
+  bool takeParkedConnection();
 
   Stats::TimespanPtr conn_connect_ms_;
   Event::Dispatcher& dispatcher_;
-  std::list<ActiveClientPtr> ready_clients_;
-  std::list<ActiveClientPtr> busy_clients_;
+  IntrusiveList<ActiveClient> ready_clients_;
+  IntrusiveList<ActiveClient> busy_clients_;
   std::list<DrainedCb> drained_callbacks_;
   const Network::ConnectionSocket::OptionsSharedPtr socket_options_;
   Event::TimerPtr upstream_ready_timer_;
   bool upstream_ready_enabled_{false};
+  // Created when the pool first parks a connection.
+  Event::TimerPtr parked_idle_timer_;
+  Upstream::PreconnectTracker preconnect_tracker_;
+  // The number of clients with a request attached.
+  uint64_t num_active_requests_{};
 };
 
 /**
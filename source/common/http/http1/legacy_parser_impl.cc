@@ -0,0 +1,51 @@
+#include "common/http/http1/legacy_parser_impl.h"
+
+namespace Envoy {
+namespace Http {
+namespace Http1 {
+
+http_parser_settings LegacyParserImpl::settings_{
+    [](http_parser* parser) -> int {
+      static_cast<ParserCallbacks*>(parser->data)->onMessageBegin();
+      return 0;
+    },
+    [](http_parser* parser, const char* at, size_t length) -> int {
+      static_cast<ParserCallbacks*>(parser->data)->onUrl(at, length);
+      return 0;
+    },
+    nullptr, // on_status
+    [](http_parser* parser, const char* at, size_t length) -> int {
+      static_cast<ParserCallbacks*>(parser->data)->onHeaderField(at, length);
+      return 0;
+    },
+    [](http_parser* parser, const char* at, size_t length) -> int {
+      static_cast<ParserCallbacks*>(parser->data)->onHeaderValue(at, length);
+      return 0;
+    },
+    [](http_parser* parser) -> int {
+      return static_cast<ParserCallbacks*>(parser->data)->onHeadersComplete();
+    },
+    [](http_parser* parser, const char* at, size_t length) -> int {
+      static_cast<ParserCallbacks*>(parser->data)->onBody(at, length);
+      return 0;
+    },
+    [](http_parser* parser) -> int {
+      static_cast<ParserCallbacks*>(parser->data)->onMessageComplete();
+      return 0;
+    },
+    nullptr, // on_chunk_header
+    nullptr  // on_chunk_complete
+};
+
+LegacyParserImpl::LegacyParserImpl(http_parser_type type, ParserCallbacks& callbacks) {
+  http_parser_init(&parser_, type);
+  parser_.data = &callbacks;
+}
+
+size_t LegacyParserImpl::execute(const char* data, size_t length) {
+  return http_parser_execute(&parser_, &settings_, data, length);
+}
+
+} // namespace Http1
+} // namespace Http
+} // namespace Envoy
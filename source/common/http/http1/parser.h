@@ -0,0 +1,141 @@
+#pragma once
+
+#include <http_parser.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+#include "envoy/common/pure.h"
+
+namespace Envoy {
+namespace Http {
+namespace Http1 {
+
+/**
+ * Callbacks raised by an HTTP/1 parser as it parses a stream of messages. Data passed to a
+ * callback points into the buffer being parsed, and may only be the part of a URL or header which
+ * was in that buffer.
+ */
+class ParserCallbacks {
+public:
+  virtual ~ParserCallbacks() {}
+
+  /**
+   * Called when a request or response begins.
+   */
+  virtual void onMessageBegin() PURE;
+
+  /**
+   * Called with part of the URL of a request.
+   * @param data supplies the start address.
+   * @param length supplies the length.
+   */
+  virtual void onUrl(const char* data, size_t length) PURE;
+
+  /**
+   * Called with part of a header name.
+   * @param data supplies the start address.
+   * @param length supplies the length.
+   */
+  virtual void onHeaderField(const char* data, size_t length) PURE;
+
+  /**
+   * Called with part of a header value. This is called at least once for every header, with a
+   * length of zero if the value is empty.
+   * @param data supplies the start address.
+   * @param length supplies the length.
+   */
+  virtual void onHeaderValue(const char* data, size_t length) PURE;
+
+  /**
+   * Called when the headers of a message are complete.
+   * @return 0 if the parser should work out whether there is a body, 1 if there is no body, or 2 if
+   *         there is no body and the rest of the connection is in a different protocol.
+   */
+  virtual int onHeadersComplete() PURE;
+
+  /**
+   * Called with part of the body of a message, after any chunked encoding has been removed.
+   * @param data supplies the start address.
+   * @param length supplies the length.
+   */
+  virtual void onBody(const char* data, size_t length) PURE;
+
+  /**
+   * Called when a request or response is complete.
+   */
+  virtual void onMessageComplete() PURE;
+};
+
+/**
+ * An HTTP/1 parser engine. Errors are reported with the http_parser error codes, so that they read
+ * the same whichever engine is used.
+ */
+class Parser {
+public:
+  virtual ~Parser() {}
+
+  /**
+   * Parse data, raising callbacks as messages are parsed. Parsing stops early if the parser is
+   * paused or an error occurs. Parsing no data indicates that the connection has been closed.
+   * @param data supplies the start address.
+   * @param length supplies the length.
+   * @return size_t the number of bytes parsed.
+   */
+  virtual size_t execute(const char* data, size_t length) PURE;
+
+  /**
+   * Pause or resume the parser. A parser paused during a callback stops parsing once the callback
+   * returns.
+   * @param paused supplies whether to pause.
+   */
+  virtual void pause(bool paused) PURE;
+
+  /**
+   * @return http_errno HPE_OK, HPE_PAUSED if the parser is paused, or the error which stopped it.
+   */
+  virtual http_errno error() const PURE;
+
+  /**
+   * @return bool whether header names are lower cased before they are passed to onHeaderField().
+   */
+  virtual bool lowerCasesHeaderNames() const PURE;
+
+  /**
+   * @return uint16_t the major HTTP version of the current message.
+   */
+  virtual uint16_t httpMajor() const PURE;
+
+  /**
+   * @return uint16_t the minor HTTP version of the current message.
+   */
+  virtual uint16_t httpMinor() const PURE;
+
+  /**
+   * @return http_method the method of the current request.
+   */
+  virtual http_method method() const PURE;
+
+  /**
+   * @return uint16_t the status code of the current response.
+   */
+  virtual uint16_t statusCode() const PURE;
+
+  /**
+   * @return uint64_t the content length of the current message, or ULLONG_MAX if it has none. This
+   *         is only valid until the body starts.
+   */
+  virtual uint64_t contentLength() const PURE;
+
+  /**
+   * @return bool whether the current message uses chunked transfer encoding.
+   */
+  virtual bool chunked() const PURE;
+};
+
+typedef std::unique_ptr<Parser> ParserPtr;
+
+} // namespace Http1
+} // namespace Http
+} // namespace Envoy
@@ -0,0 +1,1019 @@
+#include "common/http/http1/simd_parser_impl.h"
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+
+#include "common/common/assert.h"
+#include "common/common/macros.h"
+
+#include "absl/strings/match.h"
+#include "absl/strings/string_view.h"
+
+#if defined(__x86_64__)
+#include <immintrin.h>
+#endif
+
+namespace Envoy {
+namespace Http {
+namespace Http1 {
+
+namespace {
+
+// Maps token characters (RFC 7230 section 3.2.6) to their lower case form, and all other bytes
+// to 0.
+class TokenTable {
+public:
+  TokenTable() {
+    table_.fill(0);
+    for (int c = '0'; c <= '9'; c++) {
+      table_[c] = c;
+    }
+    for (int c = 'a'; c <= 'z'; c++) {
+      table_[c] = c;
+      table_[c - 'a' + 'A'] = c;
+    }
+    for (const char c : absl::string_view("!#$%&'*+-.^_`|~")) {
+      table_[static_cast<uint8_t>(c)] = c;
+    }
+  }
+
+  char lowerCase(char c) const { return table_[static_cast<uint8_t>(c)]; }
+
+private:
+  std::array<char, 256> table_;
+};
+
+const TokenTable& tokenTable() { CONSTRUCT_ON_FIRST_USE(TokenTable); }
+
+// The vector routines may write up to this many bytes past the end of the token they lower case.
+constexpr size_t ScanOverrun = 32;
+
+// Header names are scanned at most this many bytes at a time, so that the buffer they are lower
+// cased into only grows with the length of the name.
+constexpr size_t NameScanChunk = 256;
+
+struct MethodName {
+  const char* name_;
+  size_t length_;
+  http_method method_;
+};
+
+const MethodName Methods[] = {
+#define METHOD_NAME(num, name, string) {#string, sizeof(#string) - 1, HTTP_##name},
+    HTTP_METHOD_MAP(METHOD_NAME)
+#undef METHOD_NAME
+};
+
+// Find the method with the given name, or when prefix is true, one whose name starts with it.
+const MethodName* findMethod(const char* name, size_t length, bool prefix) {
+  for (const MethodName& method : Methods) {
+    if ((prefix ? method.length_ >= length : method.length_ == length) &&
+        memcmp(method.name_, name, length) == 0) {
+      return &method;
+    }
+  }
+  return nullptr;
+}
+
+bool isAlpha(char c) { return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z'); }
+
+int hexValue(char c) {
+  if (c >= '0' && c <= '9') {
+    return c - '0';
+  }
+  if (c >= 'a' && c <= 'f') {
+    return c - 'a' + 10;
+  }
+  if (c >= 'A' && c <= 'F') {
+    return c - 'A' + 10;
+  }
+  return -1;
+}
+
+// Each routine below returns the first byte at or after p which does not belong to the thing
+// being scanned, or end if they all do.
+
+// A URL ends at a space, and may not contain other control characters or DEL.
+const char* findUrlEndScalar(const char* p, const char* end) {
+  for (; p < end; p++) {
+    const uint8_t c = *p;
+    if (c <= ' ' || c == 0x7f) {
+      break;
+    }
+  }
+  return p;
+}
+
+// A header value ends at a CR or LF, and may not contain other control characters than HT, or DEL.
+const char* findValueEndScalar(const char* p, const char* end) {
+  for (; p < end; p++) {
+    const uint8_t c = *p;
+    if ((c < ' ' && c != '\t') || c == 0x7f) {
+      break;
+    }
+  }
+  return p;
+}
+
+// A header name is a token. It is copied to out, lower cased.
+const char* lowerCaseTokenScalar(const char* p, const char* end, char* out) {
+  const TokenTable& table = tokenTable();
+  for (; p < end; p++) {
+    const char c = table.lowerCase(*p);
+    if (c == 0) {
+      break;
+    }
+    *out++ = c;
+  }
+  return p;
+}
+
+#if defined(__x86_64__)
+
+// SSE 4.2 versions. PCMPESTRI finds the first byte in a set of ranges with one instruction.
+
+__attribute__((target("sse4.2"))) const char* findInRangesSse42(const char* p, const char* end,
+                                                                 const char* ranges,
+                                                                 int ranges_length) {
+  const __m128i ranges_vector = _mm_loadu_si128(reinterpret_cast<const __m128i*>(ranges));
+  while (end - p >= 16) {
+    const __m128i data = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+    const int index = _mm_cmpestri(ranges_vector, ranges_length, data, 16,
+                                   _SIDD_UBYTE_OPS | _SIDD_CMP_RANGES | _SIDD_LEAST_SIGNIFICANT);
+    if (index != 16) {
+      return p + index;
+    }
+    p += 16;
+  }
+  return p;
+}
+
+const char* findUrlEndSse42(const char* p, const char* end) {
+  alignas(16) static const char ranges[16] = "\x00\x20\x7f\x7f";
+  return findUrlEndScalar(findInRangesSse42(p, end, ranges, 4), end);
+}
+
+const char* findValueEndSse42(const char* p, const char* end) {
+  alignas(16) static const char ranges[16] = "\x00\x08\x0a\x1f\x7f\x7f";
+  return findValueEndScalar(findInRangesSse42(p, end, ranges, 6), end);
+}
+
+// Lower case letters, upper case letters, digits and '-' make up nearly all header names, so they
+// are picked out with range comparisons, and anything else is left to the scalar table.
+__attribute__((target("sse4.2"))) __m128i inRangeSse42(__m128i data, char low, char high) {
+  const __m128i offset = _mm_sub_epi8(data, _mm_set1_epi8(low));
+  return _mm_cmpeq_epi8(_mm_min_epu8(offset, _mm_set1_epi8(high - low)), offset);
+}
+
+__attribute__((target("sse4.2"))) const char* lowerCaseTokenSse42(const char* p, const char* end,
+                                                                   char* out) {
+  while (end - p >= 16) {
+    const __m128i data = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+    const __m128i upper = inRangeSse42(data, 'A', 'Z');
+    const __m128i token =
+        _mm_or_si128(_mm_or_si128(upper, inRangeSse42(data, 'a', 'z')),
+                     _mm_or_si128(inRangeSse42(data, '0', '9'),
+                                  _mm_cmpeq_epi8(data, _mm_set1_epi8('-'))));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(out),
+                     _mm_or_si128(data, _mm_and_si128(upper, _mm_set1_epi8(0x20))));
+    const uint32_t other = ~_mm_movemask_epi8(token) & 0xffff;
+    if (other == 0) {
+      p += 16;
+      out += 16;
+      continue;
+    }
+    const uint32_t length = __builtin_ctz(other);
+    p += length;
+    out += length;
+    const char c = tokenTable().lowerCase(*p);
+    if (c == 0) {
+      return p;
+    }
+    *out++ = c;
+    p++;
+  }
+  return lowerCaseTokenScalar(p, end, out);
+}
+
+// AVX2 versions, which look at 32 bytes at a time. Unsigned comparisons are made with min.
+
+__attribute__((target("avx2"))) const char* findUrlEndAvx2(const char* p, const char* end) {
+  while (end - p >= 32) {
+    const __m256i data = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+    const __m256i control =
+        _mm256_cmpeq_epi8(_mm256_min_epu8(data, _mm256_set1_epi8(' ')), data);
+    const __m256i del = _mm256_cmpeq_epi8(data, _mm256_set1_epi8(0x7f));
+    const uint32_t mask = _mm256_movemask_epi8(_mm256_or_si256(control, del));
+    if (mask != 0) {
+      return p + __builtin_ctz(mask);
+    }
+    p += 32;
+  }
+  return findUrlEndScalar(p, end);
+}
+
+__attribute__((target("avx2"))) const char* findValueEndAvx2(const char* p, const char* end) {
+  while (end - p >= 32) {
+    const __m256i data = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+    const __m256i control =
+        _mm256_cmpeq_epi8(_mm256_min_epu8(data, _mm256_set1_epi8(' ' - 1)), data);
+    const __m256i tab = _mm256_cmpeq_epi8(data, _mm256_set1_epi8('\t'));
+    const __m256i del = _mm256_cmpeq_epi8(data, _mm256_set1_epi8(0x7f));
+    const uint32_t mask =
+        _mm256_movemask_epi8(_mm256_or_si256(_mm256_andnot_si256(tab, control), del));
+    if (mask != 0) {
+      return p + __builtin_ctz(mask);
+    }
+    p += 32;
+  }
+  return findValueEndScalar(p, end);
+}
+
+__attribute__((target("avx2"))) __m256i inRangeAvx2(__m256i data, char low, char high) {
+  const __m256i offset = _mm256_sub_epi8(data, _mm256_set1_epi8(low));
+  return _mm256_cmpeq_epi8(_mm256_min_epu8(offset, _mm256_set1_epi8(high - low)), offset);
+}
+
+__attribute__((target("avx2"))) const char* lowerCaseTokenAvx2(const char* p, const char* end,
+                                                                char* out) {
+  while (end - p >= 32) {
+    const __m256i data = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+    const __m256i upper = inRangeAvx2(data, 'A', 'Z');
+    const __m256i token =
+        _mm256_or_si256(_mm256_or_si256(upper, inRangeAvx2(data, 'a', 'z')),
+                        _mm256_or_si256(inRangeAvx2(data, '0', '9'),
+                                        _mm256_cmpeq_epi8(data, _mm256_set1_epi8('-'))));
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(out),
+                        _mm256_or_si256(data, _mm256_and_si256(upper, _mm256_set1_epi8(0x20))));
+    const uint32_t other = ~static_cast<uint32_t>(_mm256_movemask_epi8(token));
+    if (other == 0) {
+      p += 32;
+      out += 32;
+      continue;
+    }
+    const uint32_t length = __builtin_ctz(other);
+    p += length;
+    out += length;
+    const char c = tokenTable().lowerCase(*p);
+    if (c == 0) {
+      return p;
+    }
+    *out++ = c;
+    p++;
+  }
+  return lowerCaseTokenSse42(p, end, out);
+}
+
+#endif
+
+} // namespace
+
+struct SimdParserImpl::Scanners {
+  const char* (*find_url_end_)(const char* p, const char* end);
+  const char* (*find_value_end_)(const char* p, const char* end);
+  const char* (*lower_case_token_)(const char* p, const char* end, char* out);
+};
+
+const SimdParserImpl::Scanners& SimdParserImpl::scannersForLevel(SimdLevel level) {
+  static const Scanners scalar{findUrlEndScalar, findValueEndScalar, lowerCaseTokenScalar};
+#if defined(__x86_64__)
+  static const Scanners sse42{findUrlEndSse42, findValueEndSse42, lowerCaseTokenSse42};
+  static const Scanners avx2{findUrlEndAvx2, findValueEndAvx2, lowerCaseTokenAvx2};
+  switch (level) {
+  case SimdLevel::Avx2:
+    return avx2;
+  case SimdLevel::Sse42:
+    return sse42;
+  case SimdLevel::Scalar:
+    break;
+  }
+#else
+  UNREFERENCED_PARAMETER(level);
+#endif
+  return scalar;
+}
+
+const SimdParserImpl::Scanners*& SimdParserImpl::activeScanners() {
+  static const Scanners* scanners = &scannersForLevel(supportedSimdLevel());
+  return scanners;
+}
+
+SimdParserImpl::SimdLevel SimdParserImpl::supportedSimdLevel() {
+#if defined(__x86_64__)
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx2")) {
+    return SimdLevel::Avx2;
+  }
+  if (__builtin_cpu_supports("sse4.2")) {
+    return SimdLevel::Sse42;
+  }
+#endif
+  return SimdLevel::Scalar;
+}
+
+void SimdParserImpl::setSimdLevel(SimdLevel level) {
+  activeScanners() = &scannersForLevel(std::min(level, supportedSimdLevel()));
+}
+
+SimdParserImpl::SimdParserImpl(http_parser_type type, ParserCallbacks& callbacks)
+    : type_(type), callbacks_(callbacks), scanners_(*activeScanners()) {
+  ASSERT(type == HTTP_REQUEST || type == HTTP_RESPONSE);
+}
+
+void SimdParserImpl::pause(bool paused) {
+  if (error_ == HPE_OK || error_ == HPE_PAUSED) {
+    error_ = paused ? HPE_PAUSED : HPE_OK;
+  }
+}
+
+size_t SimdParserImpl::execute(const char* data, size_t length) {
+  if (error_ != HPE_OK) {
+    return 0;
+  }
+
+  if (length == 0) {
+    // A pause in onHeadersComplete() or onBody() at the end of the last data leaves the transition
+    // after the headers or body pending, so it is made first. Otherwise a complete message would
+    // look unfinished.
+    if (state_ == State::HeadersDone && onHeadersDone()) {
+      return error_ == HPE_OK ? 0 : 1;
+    }
+    if (state_ == State::MessageDone) {
+      onMessageComplete();
+    }
+
+    // The connection has been closed, which is only expected between messages or when the body
+    // runs until the connection is closed.
+    if (state_ == State::BodyUntilEof) {
+      onMessageComplete();
+    } else if (state_ != State::MessageStart) {
+      error_ = HPE_INVALID_EOF_STATE;
+      return 1;
+    }
+    return 0;
+  }
+
+  const char* p = data;
+  const char* const end = data + length;
+  while (p < end || state_ == State::HeadersDone || state_ == State::MessageDone) {
+    const char* const start = p;
+    const bool parsing_headers = state_ <= State::HeadersLf;
+
+    switch (state_) {
+    case State::MessageStart:
+      p = parseMessageStart(p, end);
+      break;
+    case State::Method:
+      p = parseMethod(p, end);
+      break;
+    case State::UrlStart:
+      p = parseUrlStart(p, end);
+      break;
+    case State::Url:
+      p = parseUrl(p, end);
+      break;
+    case State::RequestVersionStart:
+      // Extra spaces between the URL and the version are allowed.
+      while (p < end && *p == ' ') {
+        p++;
+      }
+      if (p < end) {
+        state_ = State::Version;
+        token_length_ = 0;
+      }
+      break;
+    case State::Version:
+      p = parseVersion(p, end);
+      break;
+    case State::StatusCode:
+      p = parseStatusCode(p, end);
+      break;
+    case State::Reason:
+      p = scanners_.find_value_end_(p, end);
+      if (p < end) {
+        if (*p == '\r') {
+          state_ = State::StartLineLf;
+        } else if (*p == '\n') {
+          state_ = State::HeaderLineStart;
+        } else {
+          error_ = HPE_INVALID_STATUS;
+          return p - data;
+        }
+        p++;
+      }
+      break;
+    case State::StartLineLf:
+      p = expectLf(p, State::HeaderLineStart);
+      break;
+    case State::HeaderLineStart:
+      p = parseHeaderLineStart(p);
+      break;
+    case State::HeaderName:
+      p = parseHeaderName(p, end);
+      break;
+    case State::HeaderValueStart:
+      while (p < end && (*p == ' ' || *p == '\t')) {
+        p++;
+      }
+      if (p < end) {
+        state_ = State::HeaderValue;
+      }
+      break;
+    case State::HeaderValue:
+      p = parseHeaderValue(p, end);
+      break;
+    case State::HeaderValueLf:
+      p = expectLf(p, State::HeaderLineStart);
+      break;
+    case State::HeadersLf:
+      p = expectLf(p, State::HeadersLf);
+      if (error_ == HPE_OK) {
+        onHeadersEnd();
+      }
+      break;
+    case State::HeadersDone:
+      if (onHeadersDone()) {
+        return p - data;
+      }
+      break;
+    case State::MessageDone:
+      onMessageComplete();
+      break;
+    case State::Body:
+      p = parseBody(p, end, State::MessageDone);
+      break;
+    case State::BodyUntilEof:
+      callbacks_.onBody(p, end - p);
+      p = end;
+      break;
+    case State::ChunkSize:
+      p = parseChunkSize(p, end);
+      break;
+    case State::ChunkExtension:
+      // Chunk extensions are ignored.
+      p = scanners_.find_value_end_(p, end);
+      if (p < end) {
+        if (*p == '\r') {
+          state_ = State::ChunkSizeLf;
+        } else if (*p == '\n') {
+          onChunkSize();
+        } else {
+          error_ = HPE_INVALID_CHUNK_SIZE;
+          return p - data;
+        }
+        p++;
+      }
+      break;
+    case State::ChunkSizeLf:
+      p = expectLf(p, State::ChunkSizeLf);
+      if (error_ == HPE_OK) {
+        onChunkSize();
+      }
+      break;
+    case State::ChunkData:
+      p = parseBody(p, end, State::ChunkDataCr);
+      break;
+    case State::ChunkDataCr:
+      if (*p == '\r') {
+        state_ = State::ChunkDataLf;
+      } else if (*p == '\n') {
+        startChunk();
+      } else {
+        error_ = HPE_INVALID_CHUNK_SIZE;
+        return p - data;
+      }
+      p++;
+      break;
+    case State::ChunkDataLf:
+      p = expectLf(p, State::ChunkDataLf);
+      if (error_ == HPE_OK) {
+        startChunk();
+      }
+      break;
+    }
+
+    if (parsing_headers) {
+      header_bytes_ += p - start;
+      if (header_bytes_ > HTTP_MAX_HEADER_SIZE && error_ == HPE_OK) {
+        error_ = HPE_HEADER_OVERFLOW;
+      }
+    }
+    if (error_ != HPE_OK) {
+      return p - data;
+    }
+  }
+
+  return p - data;
+}
+
+const char* SimdParserImpl::parseMessageStart(const char* p, const char* end) {
+  // Empty lines between messages are ignored.
+  while (p < end && (*p == '\r' || *p == '\n')) {
+    p++;
+  }
+  if (p == end) {
+    return p;
+  }
+
+  if (type_ == HTTP_REQUEST) {
+    if (findMethod(p, 1, true) == nullptr) {
+      error_ = HPE_INVALID_METHOD;
+      return p;
+    }
+    state_ = State::Method;
+  } else {
+    if (*p != 'H') {
+      error_ = HPE_INVALID_CONSTANT;
+      return p;
+    }
+    state_ = State::Version;
+  }
+
+  http_major_ = 0;
+  http_minor_ = 0;
+  method_ = static_cast<http_method>(0);
+  status_code_ = 0;
+  content_length_ = ULLONG_MAX;
+  chunked_ = false;
+  in_trailers_ = false;
+  header_bytes_ = 0;
+  token_length_ = 0;
+  header_pending_ = false;
+  special_header_ = SpecialHeader::None;
+  callbacks_.onMessageBegin();
+  return p;
+}
+
+const char* SimdParserImpl::parseMethod(const char* p, const char* end) {
+  while (p < end && *p != ' ') {
+    if (token_length_ == sizeof(token_)) {
+      error_ = HPE_INVALID_METHOD;
+      return p;
+    }
+    token_[token_length_++] = *p++;
+  }
+
+  if (p == end) {
+    // Fail as soon as the method can not be a known one, rather than when the space arrives.
+    if (findMethod(token_, token_length_, true) == nullptr) {
+      error_ = HPE_INVALID_METHOD;
+    }
+    return p;
+  }
+
+  const MethodName* method = findMethod(token_, token_length_, false);
+  if (method == nullptr) {
+    error_ = HPE_INVALID_METHOD;
+    return p;
+  }
+  method_ = method->method_;
+  state_ = State::UrlStart;
+  return p + 1;
+}
+
+const char* SimdParserImpl::parseUrlStart(const char* p, const char* end) {
+  while (p < end && *p == ' ') {
+    p++;
+  }
+  if (p == end) {
+    return p;
+  }
+
+  // A URL is an absolute path, an absolute URL, '*', or for CONNECT, a host and port.
+  if (method_ == HTTP_CONNECT || *p == '/' || *p == '*') {
+    url_check_ = UrlCheck::Done;
+  } else if (isAlpha(*p)) {
+    url_check_ = UrlCheck::Scheme;
+  } else {
+    error_ = HPE_INVALID_URL;
+    return p;
+  }
+  state_ = State::Url;
+  return p;
+}
+
+const char* SimdParserImpl::parseUrl(const char* p, const char* end) {
+  const char* const start = p;
+
+  // The scheme of an absolute URL is short, so it is checked a byte at a time.
+  for (; url_check_ != UrlCheck::Done && p < end; p++) {
+    const char c = *p;
+    switch (url_check_) {
+    case UrlCheck::Scheme:
+      if (c == ':') {
+        url_check_ = UrlCheck::SchemeSlash;
+      } else if (!isAlpha(c)) {
+        error_ = HPE_INVALID_URL;
+        return p;
+      }
+      break;
+    case UrlCheck::SchemeSlash:
+    case UrlCheck::SchemeSlashSlash:
+      if (c != '/') {
+        error_ = HPE_INVALID_URL;
+        return p;
+      }
+      url_check_ = url_check_ == UrlCheck::SchemeSlash ? UrlCheck::SchemeSlashSlash
+                                                       : UrlCheck::Done;
+      break;
+    case UrlCheck::Done:
+      NOT_REACHED_GCOVR_EXCL_LINE;
+    }
+  }
+
+  p = scanners_.find_url_end_(p, end);
+  if (p > start) {
+    callbacks_.onUrl(start, p - start);
+  }
+  if (p == end) {
+    return p;
+  }
+
+  switch (*p) {
+  case ' ':
+    state_ = State::RequestVersionStart;
+    return p + 1;
+  case '\r':
+  case '\n':
+    // A request line without a version is HTTP/0.9.
+    http_major_ = 0;
+    http_minor_ = 9;
+    state_ = *p == '\r' ? State::StartLineLf : State::HeaderLineStart;
+    return p + 1;
+  default:
+    error_ = HPE_INVALID_URL;
+    return p;
+  }
+}
+
+const char* SimdParserImpl::parseVersion(const char* p, const char* end) {
+  static const char Prefix[] = "HTTP/";
+
+  // The version is parsed a byte at a time, with token_length_ as the position in "HTTP/x.y".
+  for (; p < end; p++, token_length_++) {
+    const char c = *p;
+    if (token_length_ < sizeof(Prefix) - 1) {
+      if (c != Prefix[token_length_]) {
+        error_ = HPE_INVALID_CONSTANT;
+        return p;
+      }
+    } else if (token_length_ == 6) {
+      if (c != '.') {
+        error_ = HPE_INVALID_VERSION;
+        return p;
+      }
+    } else if (token_length_ == 5 || token_length_ == 7) {
+      if (c < '0' || c > '9') {
+        error_ = HPE_INVALID_VERSION;
+        return p;
+      }
+      (token_length_ == 5 ? http_major_ : http_minor_) = c - '0';
+    } else {
+      // A request line ends after the version, and a status line goes on to the status code.
+      if (type_ == HTTP_REQUEST && c == '\r') {
+        state_ = State::StartLineLf;
+      } else if (type_ == HTTP_REQUEST && c == '\n') {
+        state_ = State::HeaderLineStart;
+      } else if (type_ == HTTP_RESPONSE && c == ' ') {
+        state_ = State::StatusCode;
+        token_length_ = 0;
+      } else {
+        error_ = HPE_INVALID_VERSION;
+        return p;
+      }
+      return p + 1;
+    }
+  }
+  return p;
+}
+
+const char* SimdParserImpl::parseStatusCode(const char* p, const char* end) {
+  for (; p < end; p++) {
+    const char c = *p;
+    if (c >= '0' && c <= '9') {
+      if (token_length_ == 3) {
+        error_ = HPE_INVALID_STATUS;
+        return p;
+      }
+      status_code_ = status_code_ * 10 + (c - '0');
+      token_length_++;
+      continue;
+    }
+
+    if (token_length_ == 0) {
+      error_ = HPE_INVALID_STATUS;
+      return p;
+    }
+    if (c == ' ') {
+      state_ = State::Reason;
+    } else if (c == '\r') {
+      state_ = State::StartLineLf;
+    } else if (c == '\n') {
+      state_ = State::HeaderLineStart;
+    } else {
+      error_ = HPE_INVALID_STATUS;
+      return p;
+    }
+    return p + 1;
+  }
+  return p;
+}
+
+const char* SimdParserImpl::expectLf(const char* p, State next) {
+  if (*p != '\n') {
+    error_ = HPE_LF_EXPECTED;
+    return p;
+  }
+  state_ = next;
+  return p + 1;
+}
+
+const char* SimdParserImpl::parseHeaderLineStart(const char* p) {
+  const char c = *p;
+
+  if (c == ' ' || c == '\t') {
+    // An obsolete line fold continues the value of the previous header.
+    if (!header_pending_) {
+      error_ = HPE_INVALID_HEADER_TOKEN;
+      return p;
+    }
+    onHeaderValue(" ", 1);
+    state_ = State::HeaderValueStart;
+    return p + 1;
+  }
+
+  if (header_pending_) {
+    onHeaderComplete();
+    if (error_ != HPE_OK) {
+      return p;
+    }
+  }
+
+  if (c == '\r') {
+    state_ = State::HeadersLf;
+    return p + 1;
+  }
+  if (c == '\n') {
+    onHeadersEnd();
+    return p + 1;
+  }
+  state_ = State::HeaderName;
+  header_name_length_ = 0;
+  return p;
+}
+
+const char* SimdParserImpl::parseHeaderName(const char* p, const char* end) {
+  const char* const chunk_end = std::min(end, p + NameScanChunk);
+  if (header_name_.size() < header_name_length_ + NameScanChunk + ScanOverrun) {
+    header_name_.resize(header_name_length_ + NameScanChunk + ScanOverrun);
+  }
+
+  const char* const name_end =
+      scanners_.lower_case_token_(p, chunk_end, header_name_.data() + header_name_length_);
+  header_name_length_ += name_end - p;
+  if (name_end == chunk_end) {
+    return name_end;
+  }
+
+  if (*name_end != ':' || header_name_length_ == 0) {
+    error_ = HPE_INVALID_HEADER_TOKEN;
+    return name_end;
+  }
+  onHeaderName();
+  state_ = State::HeaderValueStart;
+  return name_end + 1;
+}
+
+void SimdParserImpl::onHeaderName() {
+  header_pending_ = true;
+  if (in_trailers_) {
+    // Trailers are checked but not passed on.
+    return;
+  }
+
+  const absl::string_view name(header_name_.data(), header_name_length_);
+  if (name == "content-length") {
+    if (content_length_ != ULLONG_MAX) {
+      error_ = HPE_UNEXPECTED_CONTENT_LENGTH;
+      return;
+    }
+    special_header_ = SpecialHeader::ContentLength;
+    content_length_ = 0;
+    content_length_digits_ = false;
+    content_length_end_ = false;
+  } else if (name == "transfer-encoding") {
+    special_header_ = SpecialHeader::TransferEncoding;
+    transfer_encoding_length_ = 0;
+  }
+  callbacks_.onHeaderField(header_name_.data(), header_name_length_);
+}
+
+const char* SimdParserImpl::parseHeaderValue(const char* p, const char* end) {
+  const char* const value_end = scanners_.find_value_end_(p, end);
+  if (value_end == end) {
+    if (value_end > p) {
+      onHeaderValue(p, value_end - p);
+    }
+    return value_end;
+  }
+
+  if (*value_end != '\r' && *value_end != '\n') {
+    error_ = HPE_INVALID_HEADER_TOKEN;
+    return value_end;
+  }
+  // The value callback is made even for an empty value, so that every header has one.
+  onHeaderValue(p, value_end - p);
+  state_ = *value_end == '\r' ? State::HeaderValueLf : State::HeaderLineStart;
+  return value_end + 1;
+}
+
+void SimdParserImpl::onHeaderValue(const char* data, size_t length) {
+  if (in_trailers_) {
+    return;
+  }
+
+  switch (special_header_) {
+  case SpecialHeader::None:
+    break;
+  case SpecialHeader::ContentLength:
+    // Digits, optionally followed by whitespace.
+    for (size_t i = 0; i < length; i++) {
+      const char c = data[i];
+      if (c >= '0' && c <= '9' && !content_length_end_) {
+        if (content_length_ > (ULLONG_MAX - 10) / 10) {
+          error_ = HPE_INVALID_CONTENT_LENGTH;
+          return;
+        }
+        content_length_ = content_length_ * 10 + (c - '0');
+        content_length_digits_ = true;
+      } else if ((c == ' ' || c == '\t') && content_length_digits_) {
+        content_length_end_ = true;
+      } else {
+        error_ = HPE_INVALID_CONTENT_LENGTH;
+        return;
+      }
+    }
+    break;
+  case SpecialHeader::TransferEncoding:
+    // Only "chunked" matters, so only that much of the value is kept.
+    for (size_t i = 0; i < length; i++, transfer_encoding_length_++) {
+      if (transfer_encoding_length_ < sizeof(transfer_encoding_)) {
+        transfer_encoding_[transfer_encoding_length_] = data[i];
+      }
+    }
+    break;
+  }
+
+  callbacks_.onHeaderValue(data, length);
+}
+
+void SimdParserImpl::onHeaderComplete() {
+  header_pending_ = false;
+  switch (special_header_) {
+  case SpecialHeader::None:
+    break;
+  case SpecialHeader::ContentLength:
+    if (!content_length_digits_) {
+      error_ = HPE_INVALID_CONTENT_LENGTH;
+    }
+    break;
+  case SpecialHeader::TransferEncoding:
+    if (transfer_encoding_length_ <= sizeof(transfer_encoding_)) {
+      absl::string_view value(transfer_encoding_, transfer_encoding_length_);
+      while (!value.empty() && (value.back() == ' ' || value.back() == '\t')) {
+        value.remove_suffix(1);
+      }
+      if (absl::EqualsIgnoreCase(value, "chunked")) {
+        chunked_ = true;
+      }
+    }
+    break;
+  }
+  special_header_ = SpecialHeader::None;
+}
+
+void SimdParserImpl::onHeadersEnd() {
+  if (in_trailers_) {
+    onMessageComplete();
+    return;
+  }
+
+  // A message with both could be framed either way, which is a request smuggling risk.
+  if (chunked_ && content_length_ != ULLONG_MAX) {
+    error_ = HPE_UNEXPECTED_CONTENT_LENGTH;
+    return;
+  }
+
+  state_ = State::HeadersDone;
+  header_bytes_ = 0;
+  headers_complete_result_ = callbacks_.onHeadersComplete();
+}
+
+bool SimdParserImpl::onHeadersDone() {
+  switch (headers_complete_result_) {
+  case 0:
+  case 1:
+    break;
+  case 2:
+    // The rest of the connection is in a different protocol, so parsing stops here.
+    onMessageComplete();
+    return true;
+  default:
+    error_ = HPE_CB_headers_complete;
+    return true;
+  }
+
+  if (type_ == HTTP_REQUEST && method_ == HTTP_CONNECT) {
+    onMessageComplete();
+    return true;
+  }
+
+  if (headers_complete_result_ == 1 || content_length_ == 0) {
+    onMessageComplete();
+  } else if (chunked_) {
+    startChunk();
+  } else if (content_length_ != ULLONG_MAX) {
+    state_ = State::Body;
+    body_remaining_ = content_length_;
+  } else if (type_ == HTTP_REQUEST || status_code_ / 100 == 1 || status_code_ == 204 ||
+             status_code_ == 304) {
+    onMessageComplete();
+  } else {
+    // A response without a length runs until the connection is closed.
+    state_ = State::BodyUntilEof;
+  }
+  return false;
+}
+
+const char* SimdParserImpl::parseBody(const char* p, const char* end, State next) {
+  const uint64_t length = std::min<uint64_t>(end - p, body_remaining_);
+  callbacks_.onBody(p, length);
+  body_remaining_ -= length;
+  if (body_remaining_ == 0) {
+    state_ = next;
+  }
+  return p + length;
+}
+
+const char* SimdParserImpl::parseChunkSize(const char* p, const char* end) {
+  for (; p < end; p++) {
+    const char c = *p;
+    const int digit = hexValue(c);
+    if (digit >= 0) {
+      if (body_remaining_ > (ULLONG_MAX - 16) / 16) {
+        error_ = HPE_INVALID_CHUNK_SIZE;
+        return p;
+      }
+      body_remaining_ = body_remaining_ * 16 + digit;
+      token_length_++;
+      continue;
+    }
+
+    if (token_length_ == 0) {
+      error_ = HPE_INVALID_CHUNK_SIZE;
+      return p;
+    }
+    if (c == ';' || c == ' ' || c == '\t') {
+      state_ = State::ChunkExtension;
+    } else if (c == '\r') {
+      state_ = State::ChunkSizeLf;
+    } else if (c == '\n') {
+      onChunkSize();
+    } else {
+      error_ = HPE_INVALID_CHUNK_SIZE;
+      return p;
+    }
+    return p + 1;
+  }
+  return p;
+}
+
+void SimdParserImpl::startChunk() {
+  state_ = State::ChunkSize;
+  body_remaining_ = 0;
+  token_length_ = 0;
+}
+
+void SimdParserImpl::onChunkSize() {
+  if (body_remaining_ > 0) {
+    state_ = State::ChunkData;
+    return;
+  }
+
+  // The last chunk is followed by trailers, which end with an empty line.
+  state_ = State::HeaderLineStart;
+  in_trailers_ = true;
+  header_bytes_ = 0;
+}
+
+void SimdParserImpl::onMessageComplete() {
+  state_ = State::MessageStart;
+  in_trailers_ = false;
+  header_bytes_ = 0;
+  callbacks_.onMessageComplete();
+}
+
+} // namespace Http1
+} // namespace Http
+} // namespace Envoy
@@ -0,0 +1,159 @@
+#pragma once
+
+#include <http_parser.h>
+
+#include <climits>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "common/common/non_copyable.h"
+#include "common/http/http1/parser.h"
+
+namespace Envoy {
+namespace Http {
+namespace Http1 {
+
+/**
+ * Parser engine which finds the ends of URLs, header names and header values with SIMD
+ * instructions where the CPU has them, instead of running a state machine over every byte. Header
+ * names are validated and lower cased in the same pass that finds their end.
+ *
+ * It accepts the same messages as http_parser, except that it is strict about a few things which
+ * http_parser lets through: header names must be RFC 7230 tokens, a CR must be followed by a LF,
+ * and chunk data must be followed by a CRLF. An obsolete line fold in a header value is replaced
+ * with a space, as RFC 7230 allows, instead of being removed.
+ */
+class SimdParserImpl : public Parser, NonCopyable {
+public:
+  // The instruction sets the scanning routines can use.
+  enum class SimdLevel { Scalar, Sse42, Avx2 };
+
+  SimdParserImpl(http_parser_type type, ParserCallbacks& callbacks);
+
+  /**
+   * Select the instruction set used by all parsers. By default the best one the CPU supports is
+   * used, and a level the CPU does not support is lowered to one it does.
+   * @param level supplies the instruction set.
+   */
+  static void setSimdLevel(SimdLevel level);
+
+  /**
+   * @return SimdLevel the best instruction set the CPU supports.
+   */
+  static SimdLevel supportedSimdLevel();
+
+  // Http1::Parser
+  size_t execute(const char* data, size_t length) override;
+  void pause(bool paused) override;
+  http_errno error() const override { return error_; }
+  bool lowerCasesHeaderNames() const override { return true; }
+  uint16_t httpMajor() const override { return http_major_; }
+  uint16_t httpMinor() const override { return http_minor_; }
+  http_method method() const override { return method_; }
+  uint16_t statusCode() const override { return status_code_; }
+  uint64_t contentLength() const override { return content_length_; }
+  bool chunked() const override { return chunked_; }
+
+private:
+  enum class State {
+    // States up to and including HeadersLf are counted towards the header size limit.
+    MessageStart,
+    Method,
+    UrlStart,
+    Url,
+    RequestVersionStart,
+    Version,
+    StatusCode,
+    Reason,
+    StartLineLf,
+    HeaderLineStart,
+    HeaderName,
+    HeaderValueStart,
+    HeaderValue,
+    HeaderValueLf,
+    HeadersLf,
+    // States which consume no data.
+    HeadersDone,
+    MessageDone,
+    // Body states.
+    Body,
+    BodyUntilEof,
+    ChunkSize,
+    ChunkExtension,
+    ChunkSizeLf,
+    ChunkData,
+    ChunkDataCr,
+    ChunkDataLf,
+  };
+
+  // The headers which affect how a message is framed.
+  enum class SpecialHeader { None, ContentLength, TransferEncoding };
+
+  // The checks made on the start of a URL, before the rest of it is scanned in bulk.
+  enum class UrlCheck { Scheme, SchemeSlash, SchemeSlashSlash, Done };
+
+  // The scanning routines for one instruction set.
+  struct Scanners;
+
+  const char* parseMessageStart(const char* p, const char* end);
+  const char* parseMethod(const char* p, const char* end);
+  const char* parseUrlStart(const char* p, const char* end);
+  const char* parseUrl(const char* p, const char* end);
+  const char* parseVersion(const char* p, const char* end);
+  const char* parseStatusCode(const char* p, const char* end);
+  const char* parseHeaderLineStart(const char* p);
+  const char* parseHeaderName(const char* p, const char* end);
+  const char* parseHeaderValue(const char* p, const char* end);
+  const char* parseChunkSize(const char* p, const char* end);
+  const char* parseBody(const char* p, const char* end, State next);
+  const char* expectLf(const char* p, State next);
+  void onHeaderName();
+  void onHeaderValue(const char* data, size_t length);
+  void onHeaderComplete();
+  void onHeadersEnd();
+  bool onHeadersDone();
+  void onChunkSize();
+  void startChunk();
+  void onMessageComplete();
+
+  static const Scanners& scannersForLevel(SimdLevel level);
+  static const Scanners*& activeScanners();
+
+  const http_parser_type type_;
+  ParserCallbacks& callbacks_;
+  const Scanners& scanners_;
+  State state_{State::MessageStart};
+  http_errno error_{HPE_OK};
+
+  // The current message.
+  uint16_t http_major_{};
+  uint16_t http_minor_{};
+  http_method method_{};
+  uint16_t status_code_{};
+  uint64_t content_length_{ULLONG_MAX};
+  bool chunked_{};
+  int headers_complete_result_{};
+  bool in_trailers_{};
+  uint64_t header_bytes_{};
+  uint64_t body_remaining_{};
+
+  // The part of the start line being parsed, which may span calls to execute().
+  char token_[16];
+  uint32_t token_length_{};
+  UrlCheck url_check_{UrlCheck::Done};
+
+  // The header being parsed. The name is kept, lower cased, until its end is found.
+  std::vector<char> header_name_;
+  uint32_t header_name_length_{};
+  bool header_pending_{};
+  SpecialHeader special_header_{SpecialHeader::None};
+  bool content_length_digits_{};
+  bool content_length_end_{};
+  char transfer_encoding_[16];
+  uint32_t transfer_encoding_length_{};
+};
+
+} // namespace Http1
+} // namespace Http
+} // namespace Envoy
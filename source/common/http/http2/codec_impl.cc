@@ -1,5 +1,6 @@
 #include "common/http/http2/codec_impl.h"
 
+#include <algorithm>
 #include <cstdint>
 #include <memory>
 #include <vector>
@@ -23,6 +24,31 @@ namespace Envoy {
 namespace Http {
 namespace Http2 {
 
+namespace {
+
+/**
+ * A DATA frame payload which is referenced in the slice of received data it was parsed from. The
+ * slice is released once every payload referencing it has been drained.
+ */
+class ReceivedDataFragment : public Buffer::BufferFragment {
+public:
+  ReceivedDataFragment(const uint8_t* data, size_t size,
+                       std::shared_ptr<Buffer::OwnedImpl> received_slice)
+      : data_(data), size_(size), received_slice_(std::move(received_slice)) {}
+
+  // Buffer::BufferFragment
+  const void* data() const override { return data_; }
+  size_t size() const override { return size_; }
+  void done() override { delete this; }
+
+private:
+  const uint8_t* const data_;
+  const size_t size_;
+  const std::shared_ptr<Buffer::OwnedImpl> received_slice_;
+};
+
+} // namespace
+
 bool Utility::reconstituteCrumbledCookies(const HeaderString& key, const HeaderString& value,
                                           HeaderString& cookies) {
   if (key != Headers::get().Cookie.get().c_str()) {
@@ -58,11 +84,20 @@ ConnectionImpl::StreamImpl::StreamImpl(ConnectionImpl& parent, uint32_t buffer_l
   }
 }
 
+// Proxy credentials are sent as never indexed literals (RFC 7541, section 7.1.3), so that no HPACK
+// table on the path holds them. nghttp2 already does this for authorization and short cookies.
+static bool neverIndex(absl::string_view key) {
+  return key == Headers::get().ProxyAuthorization.get();
+}
+
 static void insertHeader(std::vector<nghttp2_nv>& headers, const HeaderEntry& header) {
   uint8_t flags = 0;
   if (header.key().type() == HeaderString::Type::Reference) {
     flags |= NGHTTP2_NV_FLAG_NO_COPY_NAME;
   }
+  if (neverIndex(header.key().getStringView())) {
+    flags |= NGHTTP2_NV_FLAG_NO_INDEX;
+  }
   if (header.value().type() == HeaderString::Type::Reference) {
     flags |= NGHTTP2_NV_FLAG_NO_COPY_VALUE;
   }
@@ -81,6 +116,12 @@ void ConnectionImpl::StreamImpl::buildHeaders(std::vector<nghttp2_nv>& final_hea
         return HeaderMap::Iterate::Continue;
       },
       &final_headers);
+
+  uint64_t field_bytes = 0;
+  for (const nghttp2_nv& header : final_headers) {
+    field_bytes += header.namelen + header.valuelen;
+  }
+  parent_.stats_.tx_header_field_bytes_.add(field_bytes);
 }
 
 void ConnectionImpl::StreamImpl::encode100ContinueHeaders(const HeaderMap& headers) {
@@ -249,9 +290,8 @@ int ConnectionImpl::StreamImpl::onDataSourceSend(const uint8_t* framehd, size_t
   // https://nghttp2.org/documentation/types.html#c.nghttp2_send_data_callback
   static const uint64_t FRAME_HEADER_SIZE = 9;
 
-  Buffer::OwnedImpl output(framehd, FRAME_HEADER_SIZE);
-  output.move(pending_send_data_, length);
-  parent_.connection_.write(output, false);
+  parent_.outbound_frames_.add(framehd, FRAME_HEADER_SIZE);
+  parent_.outbound_frames_.move(pending_send_data_, length);
   return 0;
 }
 
@@ -338,23 +378,44 @@ void ConnectionImpl::StreamImpl::onMetadataDecoded(std::unique_ptr<MetadataMap>
 ConnectionImpl::~ConnectionImpl() { nghttp2_session_del(session_); }
 
 void ConnectionImpl::dispatch(Buffer::Instance& data) {
-  ENVOY_CONN_LOG(trace, "dispatching {} bytes", connection_, data.length());
-  uint64_t num_slices = data.getRawSlices(nullptr, 0);
-  STACK_ARRAY(slices, Buffer::RawSlice, num_slices);
-  data.getRawSlices(slices.begin(), num_slices);
-  for (const Buffer::RawSlice& slice : slices) {
-    dispatching_ = true;
-    ssize_t rc =
-        nghttp2_session_mem_recv(session_, static_cast<const uint8_t*>(slice.mem_), slice.len_);
-    if (rc != static_cast<ssize_t>(slice.len_)) {
-      throw CodecProtocolException(fmt::format("{}", nghttp2_strerror(rc)));
+  const uint64_t length = data.length();
+  ENVOY_CONN_LOG(trace, "dispatching {} bytes", connection_, length);
+  // Each slice of data is moved into a buffer of its own before it is parsed, so that DATA payloads
+  // can reference the slice instead of being copied out of it. The buffer is reused unless a
+  // payload still references it.
+  while (data.length() > 0) {
+    if (received_slice_.use_count() == 1) {
+      received_slice_->drain(received_slice_->length());
+    } else {
+      received_slice_ = std::make_shared<Buffer::OwnedImpl>();
     }
+    Buffer::RawSlice first_slice;
+    data.getRawSlices(&first_slice, 1);
+    received_slice_->move(data, first_slice.len_);
+
+    uint64_t num_slices = received_slice_->getRawSlices(nullptr, 0);
+    STACK_ARRAY(slices, Buffer::RawSlice, num_slices);
+    received_slice_->getRawSlices(slices.begin(), num_slices);
+    for (const Buffer::RawSlice& slice : slices) {
+      dispatching_ = true;
+      received_raw_slice_ = slice;
+      ssize_t rc =
+          nghttp2_session_mem_recv(session_, static_cast<const uint8_t*>(slice.mem_), slice.len_);
+      if (rc != static_cast<ssize_t>(slice.len_)) {
+        throw CodecProtocolException(fmt::format("{}", nghttp2_strerror(rc)));
+      }
 
-    dispatching_ = false;
+      dispatching_ = false;
+    }
   }
 
-  ENVOY_CONN_LOG(trace, "dispatched {} bytes", connection_, data.length());
-  data.drain(data.length());
+  ENVOY_CONN_LOG(trace, "dispatched {} bytes", connection_, length);
+  if (received_slice_.use_count() == 1) {
+    received_slice_->drain(received_slice_->length());
+  } else {
+    received_slice_.reset();
+  }
+  received_raw_slice_ = {};
 
   // Decoding incoming frames can generate outbound frames so flush pending.
   sendPendingFrames();
@@ -368,7 +429,14 @@ int ConnectionImpl::onData(int32_t stream_id, const uint8_t* data, size_t len) {
   StreamImpl* stream = getStream(stream_id);
   // If this results in buffering too much data, the watermark buffer will call
   // pendingRecvBufferHighWatermark, resulting in ++read_disable_count_
-  stream->pending_recv_data_.add(data, len);
+  const uint8_t* received_begin = static_cast<const uint8_t*>(received_raw_slice_.mem_);
+  if (len >= MIN_REFERENCED_DATA_SIZE && data >= received_begin &&
+      data + len <= received_begin + received_raw_slice_.len_) {
+    stream->pending_recv_data_.addBufferFragment(
+        *new ReceivedDataFragment(data, len, received_slice_));
+  } else {
+    stream->pending_recv_data_.add(data, len);
+  }
   // Update the window to the peer unless some consumer of this stream's data has hit a flow control
   // limit and disabled reads on this stream
   if (!stream->buffers_overrun()) {
@@ -523,6 +591,10 @@ int ConnectionImpl::onFrameSend(const nghttp2_frame* frame) {
 
   case NGHTTP2_HEADERS:
   case NGHTTP2_DATA: {
+    if (frame->hd.type == NGHTTP2_HEADERS) {
+      // The length of the whole header block, including any CONTINUATION frames.
+      stats_.tx_header_block_bytes_.add(frame->hd.length);
+    }
     StreamImpl* stream = getStream(frame->hd.stream_id);
     stream->local_end_stream_sent_ = frame->hd.flags & NGHTTP2_FLAG_END_STREAM;
     break;
@@ -553,8 +625,7 @@ int ConnectionImpl::onInvalidFrame(int32_t stream_id, int error_code) {
 
 ssize_t ConnectionImpl::onSend(const uint8_t* data, size_t length) {
   ENVOY_CONN_LOG(trace, "send data: bytes={}", connection_, length);
-  Buffer::OwnedImpl buffer(data, length);
-  connection_.write(buffer, false);
+  outbound_frames_.add(data, length);
   return length;
 }
 
@@ -667,6 +738,13 @@ void ConnectionImpl::sendPendingFrames() {
   }
 
   int rc = nghttp2_session_send(session_);
+  if (outbound_frames_.length() > 0) {
+    // Writing can call back into the codec, for example through watermark callbacks, so the frames
+    // are moved out of outbound_frames_ before they are written.
+    Buffer::OwnedImpl output;
+    output.move(outbound_frames_);
+    connection_.write(output, false);
+  }
   if (rc != 0) {
     ASSERT(rc == NGHTTP2_ERR_CALLBACK_FAILURE);
     throw CodecProtocolException(fmt::format("{}", nghttp2_strerror(rc)));
@@ -910,6 +988,10 @@ Http::StreamEncoder& ClientConnectionImpl::newStream(StreamDecoder& decoder) {
   return *active_streams_.front();
 }
 
+uint64_t ClientConnectionImpl::sendWindow() {
+  return std::max(nghttp2_session_get_remote_window_size(session_), 0);
+}
+
 int ClientConnectionImpl::onBeginHeaders(const nghttp2_frame* frame) {
   // The client code explicitly does not currently support push promise.
   RELEASE_ASSERT(frame->hd.type == NGHTTP2_HEADERS, "");
@@ -47,6 +47,8 @@ const std::string CLIENT_MAGIC_PREFIX = "PRI * HTTP/2";
   COUNTER(rx_reset)                                                                                \
   COUNTER(too_many_header_frames)                                                                  \
   COUNTER(trailers)                                                                                \
+  COUNTER(tx_header_block_bytes)                                                                   \
+  COUNTER(tx_header_field_bytes)                                                                   \
   COUNTER(tx_reset)
 // clang-format on
 
@@ -310,6 +312,19 @@ private:
   int onMetadataFrameComplete(int32_t stream_id, bool end_metadata);
   ssize_t packMetadata(int32_t stream_id, uint8_t* buf, size_t len);
 
+  // DATA payloads of at least this many bytes are referenced by the stream instead of copied.
+  // Referencing a payload keeps its whole slice of received data alive until the payload is
+  // drained, so smaller payloads are copied to bound the memory they can hold on to.
+  static const uint64_t MIN_REFERENCED_DATA_SIZE = 4096;
+
+  // The slice of received data nghttp2 is currently parsing. DATA payloads which lie within it are
+  // added to the streams as fragments which share ownership of it.
+  std::shared_ptr<Buffer::OwnedImpl> received_slice_;
+  Buffer::RawSlice received_raw_slice_{};
+  // Frames serialized by nghttp2_session_send(), which are written to the connection together once
+  // nghttp2 has nothing more to send.
+  Buffer::OwnedImpl outbound_frames_;
+
   bool dispatching_ : 1;
   bool raised_goaway_ : 1;
   bool pending_deferred_reset_ : 1;
@@ -325,6 +340,7 @@ public:
 
   // Http::ClientConnection
   Http::StreamEncoder& newStream(StreamDecoder& response_decoder) override;
+  uint64_t sendWindow() override;
 
 private:
   // ConnectionImpl
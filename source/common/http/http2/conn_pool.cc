@@ -1,5 +1,6 @@
 #include "common/http/http2/conn_pool.h"
 
+#include <algorithm>
 #include <cstdint>
 #include <memory>
 
@@ -22,12 +23,12 @@ ConnPoolImpl::ConnPoolImpl(Event::Dispatcher& dispatcher, Upstream::HostConstSha
       socket_options_(options) {}
 
 ConnPoolImpl::~ConnPoolImpl() {
-  if (primary_client_) {
-    primary_client_->client_->close();
+  while (!active_clients_.empty()) {
+    active_clients_.front()->client_->close();
   }
 
-  if (draining_client_) {
-    draining_client_->client_->close();
+  while (!draining_clients_.empty()) {
+    draining_clients_.front()->client_->close();
   }
 
   // Make sure all clients are destroyed before we are destroyed.
@@ -35,8 +36,20 @@ ConnPoolImpl::~ConnPoolImpl() {
 }
 
 void ConnPoolImpl::ConnPoolImpl::drainConnections() {
-  if (primary_client_ != nullptr) {
-    movePrimaryClientToDraining();
+  while (!active_clients_.empty()) {
+    moveClientToDraining(*active_clients_.front());
+  }
+}
+
+void ConnPoolImpl::preconnect(uint32_t connections) {
+  const uint32_t limit =
+      std::min(connections, host_->cluster().http2Settings().connections_per_host_);
+  while (drained_callbacks_.empty() && active_clients_.size() < limit &&
+         host_->cluster().resourceManager(priority_).connections().canCreate()) {
+    ENVOY_LOG(debug, "preconnecting");
+    host_->cluster().stats().upstream_cx_preconnect_.inc();
+    ActiveClientPtr client = std::make_unique<ActiveClient>(*this);
+    client->moveIntoListBack(std::move(client), active_clients_);
   }
 }
 
@@ -51,17 +64,17 @@ void ConnPoolImpl::checkForDrained() {
   }
 
   bool drained = true;
-  if (primary_client_) {
-    if (primary_client_->client_->numActiveRequests() == 0) {
-      primary_client_->client_->close();
-      ASSERT(!primary_client_);
+  for (auto it = active_clients_.begin(); it != active_clients_.end();) {
+    ActiveClient& client = **it++;
+    if (client.client_->numActiveRequests() == 0) {
+      client.client_->close();
     } else {
       drained = false;
     }
   }
 
-  ASSERT(!draining_client_ || (draining_client_->client_->numActiveRequests() > 0));
-  if (draining_client_ && draining_client_->client_->numActiveRequests() > 0) {
+  // Draining clients are closed as soon as their last request completes.
+  if (!draining_clients_.empty()) {
     drained = false;
   }
 
@@ -73,22 +86,24 @@ void ConnPoolImpl::checkForDrained() {
   }
 }
 
-void ConnPoolImpl::newClientStream(Http::StreamDecoder& response_decoder,
+void ConnPoolImpl::newClientStream(ActiveClient& client, Http::StreamDecoder& response_decoder,
                                    ConnectionPool::Callbacks& callbacks) {
   if (!host_->cluster().resourceManager(priority_).requests().canCreate()) {
     ENVOY_LOG(debug, "max requests overflow");
     callbacks.onPoolFailure(ConnectionPool::PoolFailureReason::Overflow, nullptr);
     host_->cluster().stats().upstream_rq_pending_overflow_.inc();
   } else {
-    ENVOY_CONN_LOG(debug, "creating stream", *primary_client_->client_);
-    primary_client_->total_streams_++;
+    ENVOY_CONN_LOG(debug, "creating stream", *client.client_);
+    client.total_streams_++;
     host_->stats().rq_total_.inc();
     host_->stats().rq_active_.inc();
     host_->cluster().stats().upstream_rq_total_.inc();
     host_->cluster().stats().upstream_rq_active_.inc();
     host_->cluster().resourceManager(priority_).requests().inc();
-    callbacks.onPoolReady(primary_client_->client_->newStream(response_decoder),
-                          primary_client_->real_host_description_);
+    StreamEncoder& encoder = client.client_->newStream(response_decoder);
+    host_->cluster().stats().upstream_cx_http2_active_streams_.recordValue(
+        client.client_->numActiveRequests());
+    callbacks.onPoolReady(encoder, client.real_host_description_);
   }
 }
 
@@ -102,16 +117,23 @@ ConnectionPool::Cancellable* ConnPoolImpl::newStream(Http::StreamDecoder& respon
     max_streams = maxTotalStreams();
   }
 
-  if (primary_client_ && primary_client_->total_streams_ >= max_streams) {
-    movePrimaryClientToDraining();
+  for (auto it = active_clients_.begin(); it != active_clients_.end();) {
+    ActiveClient& client = **it++;
+    if (client.total_streams_ >= max_streams) {
+      moveClientToDraining(client);
+    }
   }
 
-  if (!primary_client_) {
-    primary_client_ = std::make_unique<ActiveClient>(*this);
+  // Open connections up to the configured number, one for each new stream, so that the number
+  // only grows with demand.
+  if (active_clients_.size() < host_->cluster().http2Settings().connections_per_host_) {
+    ActiveClientPtr client = std::make_unique<ActiveClient>(*this);
+    client->moveIntoListBack(std::move(client), active_clients_);
   }
 
-  // If the primary client is not connected yet, queue up the request.
-  if (!primary_client_->upstream_ready_) {
+  // If none of the clients are connected yet, queue up the request.
+  ActiveClient* client = pickReadyClient();
+  if (client == nullptr) {
     // If we're not allowed to enqueue more requests, fail fast.
     if (!host_->cluster().resourceManager(priority_).pendingRequests().canCreate()) {
       ENVOY_LOG(debug, "max pending requests overflow");
@@ -125,10 +147,31 @@ ConnectionPool::Cancellable* ConnPoolImpl::newStream(Http::StreamDecoder& respon
 
   // We already have an active client that's connected to upstream, so attempt to establish a
   // new stream.
-  newClientStream(response_decoder, callbacks);
+  newClientStream(*client, response_decoder, callbacks);
   return nullptr;
 }
 
+ConnPoolImpl::ActiveClient* ConnPoolImpl::pickReadyClient() {
+  const Http2Settings::ConnectionSelection selection =
+      host_->cluster().http2Settings().connection_selection_;
+  ActiveClient* picked = nullptr;
+  for (ActiveClient* client : active_clients_) {
+    if (!client->upstream_ready_) {
+      continue;
+    }
+    if (picked == nullptr) {
+      picked = client;
+    } else if (selection == Http2Settings::ConnectionSelection::MostSendWindow) {
+      if (client->client_->sendWindow() > picked->client_->sendWindow()) {
+        picked = client;
+      }
+    } else if (client->client_->numActiveRequests() < picked->client_->numActiveRequests()) {
+      picked = client;
+    }
+  }
+  return picked;
+}
+
 void ConnPoolImpl::onConnectionEvent(ActiveClient& client, Network::ConnectionEvent event) {
   if (event == Network::ConnectionEvent::RemoteClose ||
       event == Network::ConnectionEvent::LocalClose) {
@@ -156,12 +199,12 @@ void ConnPoolImpl::onConnectionEvent(ActiveClient& client, Network::ConnectionEv
       purgePendingRequests(client.real_host_description_);
     }
 
-    if (&client == primary_client_.get()) {
-      ENVOY_CONN_LOG(debug, "destroying primary client", *client.client_);
-      dispatcher_.deferredDelete(std::move(primary_client_));
-    } else {
+    if (client.draining_) {
       ENVOY_CONN_LOG(debug, "destroying draining client", *client.client_);
-      dispatcher_.deferredDelete(std::move(draining_client_));
+      dispatcher_.deferredDelete(client.removeFromList(draining_clients_));
+    } else {
+      ENVOY_CONN_LOG(debug, "destroying active client", *client.client_);
+      dispatcher_.deferredDelete(client.removeFromList(active_clients_));
     }
 
     if (client.closed_with_active_rq_) {
@@ -182,25 +225,16 @@ void ConnPoolImpl::onConnectionEvent(ActiveClient& client, Network::ConnectionEv
   }
 }
 
-void ConnPoolImpl::movePrimaryClientToDraining() {
-  ENVOY_CONN_LOG(debug, "moving primary to draining", *primary_client_->client_);
-  if (draining_client_) {
-    // This should pretty much never happen, but is possible if we start draining and then get
-    // a goaway for example. In this case just kill the current draining connection. It's not
-    // worth keeping a list.
-    draining_client_->client_->close();
-  }
-
-  ASSERT(!draining_client_);
-  if (primary_client_->client_->numActiveRequests() == 0) {
-    // If we are making a new connection and the primary does not have any active requests just
-    // close it now.
-    primary_client_->client_->close();
+void ConnPoolImpl::moveClientToDraining(ActiveClient& client) {
+  ENVOY_CONN_LOG(debug, "moving client to draining", *client.client_);
+  ASSERT(!client.draining_);
+  if (client.client_->numActiveRequests() == 0) {
+    // If the client does not have any active requests just close it now.
+    client.client_->close();
   } else {
-    draining_client_ = std::move(primary_client_);
+    client.draining_ = true;
+    client.moveBetweenLists(active_clients_, draining_clients_);
   }
-
-  ASSERT(!primary_client_);
 }
 
 void ConnPoolImpl::onConnectTimeout(ActiveClient& client) {
@@ -212,8 +246,8 @@ void ConnPoolImpl::onConnectTimeout(ActiveClient& client) {
 void ConnPoolImpl::onGoAway(ActiveClient& client) {
   ENVOY_CONN_LOG(debug, "remote goaway", *client.client_);
   host_->cluster().stats().upstream_cx_close_notify_.inc();
-  if (&client == primary_client_.get()) {
-    movePrimaryClientToDraining();
+  if (!client.draining_) {
+    moveClientToDraining(client);
   }
 }
 
@@ -223,7 +257,7 @@ void ConnPoolImpl::onStreamDestroy(ActiveClient& client) {
   host_->stats().rq_active_.dec();
   host_->cluster().stats().upstream_rq_active_.dec();
   host_->cluster().resourceManager(priority_).requests().dec();
-  if (&client == draining_client_.get() && client.client_->numActiveRequests() == 0) {
+  if (client.draining_ && client.client_->numActiveRequests() == 0) {
     // Close out the draining client if we no long have active requests.
     client.client_->close();
   }
@@ -249,9 +283,13 @@ void ConnPoolImpl::onStreamReset(ActiveClient& client, Http::StreamResetReason r
 }
 
 void ConnPoolImpl::onUpstreamReady() {
-  // Establishes new codec streams for each pending request.
+  // Establishes new codec streams for each pending request, on whichever connected clients the
+  // configured selection picks.
   while (!pending_requests_.empty()) {
-    newClientStream(pending_requests_.back()->decoder_, pending_requests_.back()->callbacks_);
+    ActiveClient* client = pickReadyClient();
+    ASSERT(client != nullptr);
+    newClientStream(*client, pending_requests_.back()->decoder_,
+                    pending_requests_.back()->callbacks_);
     pending_requests_.pop_back();
   }
 }
@@ -10,6 +10,7 @@
 #include "envoy/stats/timespan.h"
 #include "envoy/upstream/upstream.h"
 
+#include "common/common/intrusive_list.h"
 #include "common/http/codec_client.h"
 #include "common/http/conn_pool_base.h"
 
@@ -18,9 +19,10 @@ namespace Http {
 namespace Http2 {
 
 /**
- * Implementation of a "connection pool" for HTTP/2. This mainly handles stats as well as
- * shifting to a new connection if we reach max streams on the primary. This is a base class
- * used for both the prod implementation as well as the testing one.
+ * Implementation of a "connection pool" for HTTP/2. This mainly handles stats, spreading streams
+ * over the configured number of connections to the host, as well as shifting to a new connection
+ * if a connection reaches max streams. This is a base class used for both the prod implementation
+ * as well as the testing one.
  */
 class ConnPoolImpl : public ConnectionPool::Instance, public ConnPoolImplBase {
 public:
@@ -33,11 +35,13 @@ public:
   Http::Protocol protocol() const override { return Http::Protocol::Http2; }
   void addDrainedCallback(DrainedCb cb) override;
   void drainConnections() override;
+  void preconnect(uint32_t connections) override;
   ConnectionPool::Cancellable* newStream(Http::StreamDecoder& response_decoder,
                                          ConnectionPool::Callbacks& callbacks) override;
 
 protected:
-  struct ActiveClient : public Network::ConnectionCallbacks,
+  struct ActiveClient : IntrusiveListItem<ActiveClient>,
+                        public Network::ConnectionCallbacks,
                         public CodecClientCallbacks,
                         public Event::DeferredDeletable,
                         public Http::ConnectionCallbacks {
@@ -70,6 +74,7 @@ protected:
     bool upstream_ready_{};
     Stats::TimespanPtr conn_length_;
     bool closed_with_active_rq_{};
+    bool draining_{};
   };
 
   typedef std::unique_ptr<ActiveClient> ActiveClientPtr;
@@ -79,19 +84,23 @@ protected:
 
   virtual CodecClientPtr createCodecClient(Upstream::Host::CreateConnectionData& data) PURE;
   virtual uint32_t maxTotalStreams() PURE;
-  void movePrimaryClientToDraining();
+  ActiveClient* pickReadyClient();
+  void moveClientToDraining(ActiveClient& client);
   void onConnectionEvent(ActiveClient& client, Network::ConnectionEvent event);
   void onConnectTimeout(ActiveClient& client);
   void onGoAway(ActiveClient& client);
   void onStreamDestroy(ActiveClient& client);
   void onStreamReset(ActiveClient& client, Http::StreamResetReason reason);
-  void newClientStream(Http::StreamDecoder& response_decoder, ConnectionPool::Callbacks& callbacks);
+  void newClientStream(ActiveClient& client, Http::StreamDecoder& response_decoder,
+                       ConnectionPool::Callbacks& callbacks);
   void onUpstreamReady();
 
   Stats::TimespanPtr conn_connect_ms_;
   Event::Dispatcher& dispatcher_;
-  ActiveClientPtr primary_client_;
-  ActiveClientPtr draining_client_;
+  // Clients which new streams are assigned to, up to the configured number of connections per host.
+  IntrusiveList<ActiveClient> active_clients_;
+  // Clients which take no new streams and are closed once their last stream completes.
+  IntrusiveList<ActiveClient> draining_clients_;
   std::list<DrainedCb> drained_callbacks_;
   const Network::ConnectionSocket::OptionsSharedPtr socket_options_;
 };
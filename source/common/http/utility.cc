@@ -229,6 +229,18 @@ Utility::parseHttp2Settings(const envoy::api::v2::core::Http2ProtocolOptions& co
       PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, initial_connection_window_size,
                                       Http::Http2Settings::DEFAULT_INITIAL_CONNECTION_WINDOW_SIZE);
   ret.allow_connect_ = config.allow_connect();
+  ret.connections_per_host_ = PROTOBUF_GET_WRAPPED_OR_DEFAULT(
+      config, connections_per_host, Http::Http2Settings::DEFAULT_CONNECTIONS_PER_HOST);
+  switch (config.connection_selection()) {
+  case envoy::api::v2::core::Http2ProtocolOptions::LEAST_ACTIVE_STREAMS:
+    ret.connection_selection_ = Http2Settings::ConnectionSelection::LeastActiveStreams;
+    break;
+  case envoy::api::v2::core::Http2ProtocolOptions::MOST_SEND_WINDOW:
+    ret.connection_selection_ = Http2Settings::ConnectionSelection::MostSendWindow;
+    break;
+  default:
+    NOT_REACHED_GCOVR_EXCL_LINE;
+  }
   return ret;
 }
 
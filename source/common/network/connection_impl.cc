@@ -315,8 +315,9 @@ void ConnectionImpl::readDisable(bool disable) {
     file_event_->setEnabled(Event::FileReadyType::Read | Event::FileReadyType::Write);
     // If the connection has data buffered there's no guarantee there's also data in the kernel
     // which will kick off the filter chain. Instead fake an event to make sure the buffered data
-    // gets processed regardless.
-    if (read_buffer_.length() > 0) {
+    // gets processed regardless. A transport socket reading through io_uring may also hold data
+    // which a receive got while reads were disabled, and submits the next receive when read.
+    if (read_buffer_.length() > 0 || dispatcher_.ioUring() != nullptr) {
       file_event_->activate(Event::FileReadyType::Read);
     }
   }
@@ -630,7 +631,21 @@ ClientConnectionImpl::ClientConnectionImpl(
   }
 }
 
+ClientConnectionImpl::ClientConnectionImpl(Event::Dispatcher& dispatcher,
+                                           ConnectionSocketPtr&& socket,
+                                           Network::TransportSocketPtr&& transport_socket)
+    : ConnectionImpl(dispatcher, std::move(socket), std::move(transport_socket), false),
+      adopted_(true) {}
+
 void ClientConnectionImpl::connect() {
+  if (adopted_) {
+    // The socket is already connected, so the write event completes the connect.
+    ENVOY_CONN_LOG(debug, "adopting connection to {}", *this,
+                   socket_->remoteAddress()->asString());
+    file_event_->activate(Event::FileReadyType::Write);
+    return;
+  }
+
   ENVOY_CONN_LOG(debug, "connecting to {}", *this, socket_->remoteAddress()->asString());
   const Api::SysCallIntResult result = socket_->remoteAddress()->connect(fd());
   if (result.rc_ == 0) {
@@ -658,5 +673,23 @@ void ClientConnectionImpl::connect() {
   }
 }
 
+ConnectionSocketPtr ClientConnectionImpl::releaseSocket() {
+  ASSERT(state() == State::Open && !connecting_ && write_buffer_->length() == 0);
+  ENVOY_CONN_LOG(debug, "releasing socket", *this);
+
+  // Closing the connection stops watching its fd before closing it, which leaves the duplicate,
+  // and so the upstream connection, open.
+  const int fd = ::dup(this->fd());
+  if (fd == -1) {
+    ENVOY_CONN_LOG(debug, "failed to duplicate socket: {}", *this, strerror(errno));
+    closeSocket(ConnectionEvent::LocalClose);
+    return nullptr;
+  }
+  ConnectionSocketPtr socket =
+      std::make_unique<ConnectionSocketImpl>(fd, socket_->localAddress(), socket_->remoteAddress());
+  closeSocket(ConnectionEvent::LocalClose);
+  return socket;
+}
+
 } // namespace Network
 } // namespace Envoy
@@ -118,6 +118,8 @@ public:
   // fair sharing of CPU resources, the underlying event loop does not make any fairness guarantees.
   // Reconsider how to make fairness happen.
   void setReadBufferReady() override { file_event_->activate(Event::FileReadyType::Read); }
+  void setWriteBufferReady() override { file_event_->activate(Event::FileReadyType::Write); }
+  Event::IoUring* ioUring() override { return dispatcher_.ioUring(); }
 
   // Obtain global next connection ID. This should only be used in tests.
   static uint64_t nextGlobalIdForTest() { return next_global_id_; }
@@ -207,8 +209,18 @@ public:
                        Network::TransportSocketPtr&& transport_socket,
                        const Network::ConnectionSocket::OptionsSharedPtr& options);
 
+  /**
+   * Create a connection on a socket which is already connected.
+   */
+  ClientConnectionImpl(Event::Dispatcher& dispatcher, ConnectionSocketPtr&& socket,
+                       Network::TransportSocketPtr&& transport_socket);
+
   // Network::ClientConnection
   void connect() override;
+  ConnectionSocketPtr releaseSocket() override;
+
+private:
+  const bool adopted_{};
 };
 
 } // namespace Network
@@ -1,9 +1,11 @@
 #include "common/network/listener_impl.h"
 
+#include <sys/socket.h>
 #include <sys/un.h>
 
 #include "envoy/common/exception.h"
 
+#include "common/api/os_sys_calls_impl.h"
 #include "common/common/assert.h"
 #include "common/common/empty_string.h"
 #include "common/common/fmt.h"
@@ -20,13 +22,41 @@ Address::InstanceConstSharedPtr ListenerImpl::getLocalAddress(int fd) {
   return Address::addressFromFd(fd);
 }
 
+constexpr int ListenerImpl::ListenBacklog;
+
 void ListenerImpl::listenCallback(evconnlistener*, evutil_socket_t fd, sockaddr* remote_addr,
                                   int remote_addr_len, void* arg) {
   ListenerImpl* listener = static_cast<ListenerImpl*>(arg);
+  listener->newConnection(fd, remote_addr, remote_addr_len);
+}
+
+void ListenerImpl::onSocketReadable() {
+  for (uint32_t i = 0; i < max_accepts_per_wakeup_ && enabled_; i++) {
+    sockaddr_storage remote_addr;
+    socklen_t remote_addr_len = sizeof(remote_addr);
+    const Api::SysCallIntResult result = Api::OsSysCallsSingleton::get().accept(
+        fd_, reinterpret_cast<sockaddr*>(&remote_addr), &remote_addr_len);
+    if (result.rc_ == -1) {
+      if (result.errno_ == EAGAIN || result.errno_ == EWOULDBLOCK) {
+        return;
+      }
+      // These are the errors which libevent retries on.
+      if (result.errno_ == EINTR || result.errno_ == ECONNABORTED) {
+        continue;
+      }
+      PANIC(fmt::format("listener accept failure: {}", strerror(result.errno_)));
+    }
+    newConnection(result.rc_, reinterpret_cast<sockaddr*>(&remote_addr), remote_addr_len);
+  }
+  // There may be more pending connections. The event is level triggered, so the socket is still
+  // readable on the next iteration of the event loop if so.
+}
+
+void ListenerImpl::newConnection(int fd, const sockaddr* remote_addr, socklen_t remote_addr_len) {
   // Get the local address from the new socket if the listener is listening on IP ANY
   // (e.g., 0.0.0.0 for IPv4) (local_address_ is nullptr in this case).
   const Address::InstanceConstSharedPtr& local_address =
-      listener->local_address_ ? listener->local_address_ : listener->getLocalAddress(fd);
+      local_address_ ? local_address_ : getLocalAddress(fd);
   // The accept() call that filled in remote_addr doesn't fill in more than the sa_family field
   // for Unix domain sockets; apparently there isn't a mechanism in the kernel to get the
   // sockaddr_un associated with the client socket when starting from the server socket.
@@ -40,15 +70,16 @@ void ListenerImpl::listenCallback(evconnlistener*, evutil_socket_t fd, sockaddr*
           : Address::addressFromSockAddr(*reinterpret_cast<const sockaddr_storage*>(remote_addr),
                                          remote_addr_len,
                                          local_address->ip()->version() == Address::IpVersion::v6);
-  listener->cb_.onAccept(std::make_unique<AcceptedSocketImpl>(fd, local_address, remote_address),
-                         listener->hand_off_restored_destination_connections_);
+  cb_.onAccept(std::make_unique<AcceptedSocketImpl>(fd, local_address, remote_address),
+               hand_off_restored_destination_connections_);
 }
 
 ListenerImpl::ListenerImpl(Event::DispatcherImpl& dispatcher, Socket& socket, ListenerCallbacks& cb,
-                           bool bind_to_port, bool hand_off_restored_destination_connections)
+                           bool bind_to_port, bool hand_off_restored_destination_connections,
+                           uint32_t max_accepts_per_wakeup)
     : local_address_(nullptr), cb_(cb),
       hand_off_restored_destination_connections_(hand_off_restored_destination_connections),
-      listener_(nullptr) {
+      listener_(nullptr), fd_(socket.fd()), max_accepts_per_wakeup_(max_accepts_per_wakeup) {
   const auto ip = socket.localAddress()->ip();
 
   // Only use the listen socket's local address for new connections if it is not the all hosts
@@ -58,10 +89,23 @@ ListenerImpl::ListenerImpl(Event::DispatcherImpl& dispatcher, Socket& socket, Li
   }
 
   if (bind_to_port) {
-    listener_.reset(
-        evconnlistener_new(&dispatcher.base(), listenCallback, this, 0, -1, socket.fd()));
+    if (max_accepts_per_wakeup_ == 0) {
+      listener_.reset(
+          evconnlistener_new(&dispatcher.base(), listenCallback, this, 0, -1, socket.fd()));
+    } else {
+      const Api::SysCallIntResult result =
+          Api::OsSysCallsSingleton::get().listen(socket.fd(), ListenBacklog);
+      if (result.rc_ == -1) {
+        throw CreateListenerException(fmt::format("cannot listen on socket: {}: {}",
+                                                  socket.localAddress()->asString(),
+                                                  strerror(result.errno_)));
+      }
+      file_event_ = dispatcher.createFileEvent(
+          socket.fd(), [this](uint32_t) -> void { onSocketReadable(); },
+          Event::FileTriggerType::Level, Event::FileReadyType::Read);
+    }
 
-    if (!listener_) {
+    if (!listener_ && !file_event_) {
       throw CreateListenerException(
           fmt::format("cannot listen on socket: {}", socket.localAddress()->asString()));
     }
@@ -72,7 +116,9 @@ ListenerImpl::ListenerImpl(Event::DispatcherImpl& dispatcher, Socket& socket, Li
           "cannot set post-listen socket option on socket: {}", socket.localAddress()->asString()));
     }
 
-    evconnlistener_set_error_cb(listener_.get(), errorCallback);
+    if (listener_) {
+      evconnlistener_set_error_cb(listener_.get(), errorCallback);
+    }
   }
 }
 
@@ -83,14 +129,20 @@ void ListenerImpl::errorCallback(evconnlistener*, void*) {
 }
 
 void ListenerImpl::enable() {
+  enabled_ = true;
   if (listener_.get()) {
     evconnlistener_enable(listener_.get());
+  } else if (file_event_) {
+    file_event_->setEnabled(Event::FileReadyType::Read);
   }
 }
 
 void ListenerImpl::disable() {
+  enabled_ = false;
   if (listener_.get()) {
     evconnlistener_disable(listener_.get());
+  } else if (file_event_) {
+    file_event_->setEnabled(0);
   }
 }
 
@@ -1,5 +1,6 @@
 #pragma once
 
+#include "envoy/event/file_event.h"
 #include "envoy/network/listener.h"
 
 #include "common/event/dispatcher_impl.h"
@@ -13,15 +14,26 @@ namespace Network {
 
 /**
  * libevent implementation of Network::Listener.
+ *
+ * By default, connections are accepted by a libevent evconnlistener, which accepts every pending
+ * connection each time the socket becomes readable. If max_accepts_per_wakeup is set, the listener
+ * instead accepts connections itself, with accept4(), and returns to the event loop after that
+ * many. This bounds the time spent accepting when there are many pending connections, for example
+ * during a reconnect storm, so that existing connections on the worker keep being served.
  */
 class ListenerImpl : public Listener {
 public:
   ListenerImpl(Event::DispatcherImpl& dispatcher, Socket& socket, ListenerCallbacks& cb,
-               bool bind_to_port, bool hand_off_restored_destination_connections);
+               bool bind_to_port, bool hand_off_restored_destination_connections,
+               uint32_t max_accepts_per_wakeup);
 
   void disable();
   void enable();
 
+  // The listen() backlog used when accepting in batches. This is what libevent picks for an
+  // evconnlistener created with a backlog of -1.
+  static constexpr int ListenBacklog = 128;
+
 protected:
   virtual Address::InstanceConstSharedPtr getLocalAddress(int fd);
 
@@ -33,8 +45,15 @@ private:
   static void errorCallback(evconnlistener* listener, void* context);
   static void listenCallback(evconnlistener*, evutil_socket_t fd, sockaddr* remote_addr,
                              int remote_addr_len, void* arg);
+  void onSocketReadable();
+  void newConnection(int fd, const sockaddr* remote_addr, socklen_t remote_addr_len);
 
   Event::Libevent::ListenerPtr listener_;
+  // Only used if max_accepts_per_wakeup_ is set, in place of listener_.
+  Event::FileEventPtr file_event_;
+  const int fd_;
+  const uint32_t max_accepts_per_wakeup_;
+  bool enabled_{true};
 };
 
 } // namespace Network
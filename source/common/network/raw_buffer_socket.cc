@@ -1,17 +1,37 @@
 #include "common/network/raw_buffer_socket.h"
 
+#include <algorithm>
+
+#include "common/buffer/buffer_impl.h"
 #include "common/common/assert.h"
 #include "common/common/empty_string.h"
+#include "common/common/stack_array.h"
 #include "common/http/headers.h"
 
 namespace Envoy {
 namespace Network {
 
+namespace {
+
+// The most a single receive through an io_uring reads, as for each read() of the fd.
+constexpr uint32_t RecvSize = 16384;
+
+} // namespace
+
+RawBufferSocket::~RawBufferSocket() { detachRequests(); }
+
 void RawBufferSocket::setTransportSocketCallbacks(TransportSocketCallbacks& callbacks) {
   callbacks_ = &callbacks;
+  io_uring_ = callbacks.ioUring();
 }
 
+void RawBufferSocket::closeSocket(Network::ConnectionEvent) { detachRequests(); }
+
 IoResult RawBufferSocket::doRead(Buffer::Instance& buffer) {
+  if (io_uring_ != nullptr) {
+    return doReadCompleted(buffer);
+  }
+
   PostIoAction action = PostIoAction::KeepOpen;
   uint64_t bytes_read = 0;
   bool end_stream = false;
@@ -44,8 +64,16 @@ IoResult RawBufferSocket::doRead(Buffer::Instance& buffer) {
 }
 
 IoResult RawBufferSocket::doWrite(Buffer::Instance& buffer, bool end_stream) {
+  if (io_uring_ != nullptr) {
+    return doWriteCompleted(buffer, end_stream);
+  }
+
   PostIoAction action;
   uint64_t bytes_written = 0;
+  // Counting the slices walks the whole buffer, so it is only done once. Each write which doesn't
+  // fail takes the next MaxWriteSlices of them, unless the socket only took part of them, in which
+  // case the next write normally fails with EAGAIN.
+  uint64_t num_slices = stats_ != nullptr ? buffer.getRawSlices(nullptr, 0) : 0;
   ASSERT(!shutdown_ || buffer.length() == 0);
   do {
     if (buffer.length() == 0) {
@@ -58,6 +86,7 @@ IoResult RawBufferSocket::doWrite(Buffer::Instance& buffer, bool end_stream) {
       action = PostIoAction::KeepOpen;
       break;
     }
+    const uint64_t length = buffer.length();
     Api::SysCallIntResult result = buffer.write(callbacks_->fd());
     ENVOY_CONN_LOG(trace, "write returns: {}", callbacks_->connection(), result.rc_);
 
@@ -72,18 +101,200 @@ IoResult RawBufferSocket::doWrite(Buffer::Instance& buffer, bool end_stream) {
       break;
     } else {
       bytes_written += result.rc_;
+      if (stats_ != nullptr) {
+        recordWrite(result.rc_, num_slices, length);
+        num_slices -= std::min(num_slices, Buffer::OwnedImpl::MaxWriteSlices);
+      }
     }
   } while (true);
 
   return {action, bytes_written, false};
 }
 
+IoResult RawBufferSocket::doReadCompleted(Buffer::Instance& buffer) {
+  const uint64_t bytes_read = received_.length();
+  buffer.move(received_);
+  if (recv_failed_) {
+    return {PostIoAction::Close, bytes_read, false};
+  }
+
+  // Nothing more is received while the connection does not read, so that the kernel applies
+  // back pressure, as it does when the fd is not read.
+  if (recv_request_ == nullptr && !received_end_stream_ &&
+      callbacks_->connection().readEnabled()) {
+    submitRecv();
+  }
+  return {PostIoAction::KeepOpen, bytes_read, received_end_stream_};
+}
+
+IoResult RawBufferSocket::doWriteCompleted(Buffer::Instance& buffer, bool end_stream) {
+  if (send_failed_) {
+    return {PostIoAction::Close, 0, false};
+  }
+  // Sends go out in order, so what they sent is the start of the buffer.
+  const uint64_t bytes_written = bytes_sent_;
+  buffer.drain(bytes_sent_);
+  bytes_sent_ = 0;
+
+  // The rest of the buffer is written once the send in flight completes, so that sends never
+  // overtake each other.
+  if (send_request_ == nullptr) {
+    if (buffer.length() == 0) {
+      if (end_stream && !shutdown_) {
+        ::shutdown(callbacks_->fd(), SHUT_WR);
+        shutdown_ = true;
+      }
+    } else {
+      // The data stays in the buffer until it has been sent, so that the connection's watermarks
+      // and flushing close see it, and the request sends a copy of it.
+      auto request = std::make_unique<SendRequest>(*this);
+      request->buffer_.add(buffer);
+      submitSend(std::move(request));
+    }
+  }
+  return {PostIoAction::KeepOpen, bytes_written, false};
+}
+
+void RawBufferSocket::submitRecv() {
+  auto request = std::make_unique<RecvRequest>(*this);
+  request->buffer_.reserve(RecvSize, &request->slice_, 1);
+  void* memory = request->slice_.mem_;
+  const uint32_t length = std::min<uint64_t>(request->slice_.len_, RecvSize);
+  recv_request_ = request.get();
+  io_uring_->recv(callbacks_->fd(), memory, length, std::move(request));
+}
+
+void RawBufferSocket::submitSend(std::unique_ptr<SendRequest> request) {
+  // As with writev(), the slices beyond the most sendmsg() takes are sent once these have been.
+  const uint64_t num_slices = request->buffer_.getRawSlices(nullptr, 0);
+  const uint64_t num_slices_to_send = std::min(num_slices, Buffer::OwnedImpl::MaxWriteSlices);
+  STACK_ARRAY(slices, Buffer::RawSlice, num_slices_to_send);
+  request->buffer_.getRawSlices(slices.begin(), num_slices_to_send);
+  for (const Buffer::RawSlice& slice : slices) {
+    if (slice.mem_ != nullptr && slice.len_ != 0) {
+      request->iovecs_.push_back({slice.mem_, slice.len_});
+    }
+  }
+  request->message_.msg_iov = request->iovecs_.data();
+  request->message_.msg_iovlen = request->iovecs_.size();
+  request->num_slices_ = num_slices;
+
+  send_request_ = request.get();
+  const msghdr& message = request->message_;
+  io_uring_->sendmsg(callbacks_->fd(), message, std::move(request));
+}
+
+void RawBufferSocket::RecvRequest::onCompletion(int32_t result) {
+  if (socket_ != nullptr) {
+    socket_->onRecvCompleted(*this, result);
+  }
+}
+
+void RawBufferSocket::SendRequest::onCompletion(int32_t result) {
+  if (socket_ != nullptr) {
+    socket_->onSendCompleted(*this, result);
+  }
+}
+
+void RawBufferSocket::onRecvCompleted(RecvRequest& request, int32_t result) {
+  ENVOY_CONN_LOG(trace, "recv completes: {}", callbacks_->connection(), result);
+  recv_request_ = nullptr;
+  if (result > 0) {
+    request.slice_.len_ = result;
+    request.buffer_.commit(&request.slice_, 1);
+    received_.move(request.buffer_);
+  } else if (result == 0) {
+    received_end_stream_ = true;
+  } else if (result != -EAGAIN) {
+    ENVOY_CONN_LOG(trace, "recv error: {}", callbacks_->connection(), -result);
+    recv_failed_ = true;
+  }
+  // The connection reads what was received, and the next receive is submitted as it does. While
+  // the connection does not read, what was received is held until it does again, as the kernel
+  // would hold it otherwise.
+  if (callbacks_->connection().readEnabled()) {
+    callbacks_->setReadBufferReady();
+  }
+}
+
+void RawBufferSocket::onSendCompleted(SendRequest& request, int32_t result) {
+  ENVOY_CONN_LOG(trace, "send completes: {}", callbacks_->connection(), result);
+  send_request_ = nullptr;
+  if (result >= 0) {
+    const uint64_t length = request.buffer_.length();
+    if (stats_ != nullptr) {
+      recordWrite(result, request.num_slices_, length);
+    }
+    request.buffer_.drain(result);
+    bytes_sent_ += result;
+    if (request.buffer_.length() > 0) {
+      // The rest of the request's data goes before anything written since.
+      resubmitSend(request);
+    }
+  } else if (result == -EAGAIN) {
+    resubmitSend(request);
+    return;
+  } else {
+    ENVOY_CONN_LOG(trace, "send error: {} ({})", callbacks_->connection(), -result,
+                   strerror(-result));
+    send_failed_ = true;
+  }
+  // The connection drains what was sent and writes what was buffered since the send was submitted,
+  // or finds it failed.
+  callbacks_->setWriteBufferReady();
+}
+
+void RawBufferSocket::resubmitSend(SendRequest& request) {
+  auto next = std::make_unique<SendRequest>(*this);
+  next->buffer_.move(request.buffer_);
+  submitSend(std::move(next));
+}
+
+void RawBufferSocket::detachRequests() {
+  if (recv_request_ == nullptr && send_request_ == nullptr) {
+    return;
+  }
+  if (recv_request_ != nullptr) {
+    recv_request_->socket_ = nullptr;
+    io_uring_->cancel(*recv_request_);
+    recv_request_ = nullptr;
+  }
+  if (send_request_ != nullptr) {
+    // A flushing close waits for the sends to complete, so a send is only in flight here when the
+    // connection closed without flushing, or gave up on a peer which stopped reading. The send
+    // would otherwise keep the socket and the data alive for as long as the peer does not read.
+    send_request_->socket_ = nullptr;
+    io_uring_->cancel(*send_request_);
+    send_request_ = nullptr;
+    if (stats_ != nullptr) {
+      stats_->write_cancelled_.inc();
+    }
+  }
+  // The fd is about to be closed, so the kernel must look it up for queued operations first.
+  io_uring_->submit();
+}
+
+void RawBufferSocket::recordWrite(uint64_t bytes_written, uint64_t num_slices, uint64_t length) {
+  stats_->write_iovecs_.recordValue(std::min(num_slices, Buffer::OwnedImpl::MaxWriteSlices));
+  // When the buffer has more slices than a single write takes, the rest is written by the next
+  // iteration rather than being held back by the socket.
+  if (num_slices <= Buffer::OwnedImpl::MaxWriteSlices && bytes_written < length) {
+    stats_->write_partial_.inc();
+  }
+}
+
 std::string RawBufferSocket::protocol() const { return EMPTY_STRING; }
 
 void RawBufferSocket::onConnected() { callbacks_->raiseEvent(ConnectionEvent::Connected); }
 
+RawBufferSocketFactory::RawBufferSocketFactory(Stats::Scope& stats_scope)
+    : stats_(std::make_shared<RawBufferSocketStats>(
+          RawBufferSocketStats{ALL_RAW_BUFFER_SOCKET_STATS(
+              POOL_COUNTER_PREFIX(stats_scope, "raw_buffer_socket."),
+              POOL_HISTOGRAM_PREFIX(stats_scope, "raw_buffer_socket."))})) {}
+
 TransportSocketPtr RawBufferSocketFactory::createTransportSocket() const {
-  return std::make_unique<RawBufferSocket>();
+  return std::make_unique<RawBufferSocket>(stats_);
 }
 
 bool RawBufferSocketFactory::implementsSecureTransport() const { return false; }
@@ -1,36 +1,144 @@
 #pragma once
 
+#include <sys/uio.h>
+
+#include <cstdint>
+#include <vector>
+
 #include "envoy/buffer/buffer.h"
+#include "envoy/event/io_uring.h"
 #include "envoy/network/connection.h"
 #include "envoy/network/transport_socket.h"
+#include "envoy/stats/scope.h"
+#include "envoy/stats/stats_macros.h"
 
+#include "common/buffer/buffer_impl.h"
 #include "common/common/logger.h"
 
 namespace Envoy {
 namespace Network {
 
+/**
+ * All raw buffer socket stats. @see stats_macros.h
+ */
+// clang-format off
+#define ALL_RAW_BUFFER_SOCKET_STATS(COUNTER, HISTOGRAM)                                            \
+  COUNTER  (write_cancelled)                                                                       \
+  COUNTER  (write_partial)                                                                         \
+  HISTOGRAM(write_iovecs)
+// clang-format on
+
+/**
+ * Struct definition for all raw buffer socket stats. @see stats_macros.h
+ */
+struct RawBufferSocketStats {
+  ALL_RAW_BUFFER_SOCKET_STATS(GENERATE_COUNTER_STRUCT, GENERATE_HISTOGRAM_STRUCT)
+};
+
+typedef std::shared_ptr<RawBufferSocketStats> RawBufferSocketStatsSharedPtr;
+
+/**
+ * A transport socket which reads and writes the connection's buffers directly. Writes gather as
+ * many buffer slices as writev() accepts, so that a buffer built from many fragments is written
+ * with a single system call.
+ *
+ * When the connection offers an io_uring, the socket is read and written through it instead. A
+ * receive is kept outstanding while the connection reads, and what it received is handed to the
+ * connection by the next doRead(), which waits for the connection to read again if it has disabled
+ * reads. doWrite() sends a copy of the write buffer, and drains what completed sends sent, so the
+ * connection counts, flushes and applies watermarks to what the kernel has actually taken. A send
+ * still in flight when the socket is closed is cancelled. The operations of all of a dispatcher's
+ * connections are handed to the kernel together, rather than with a system call each.
+ */
 class RawBufferSocket : public TransportSocket, protected Logger::Loggable<Logger::Id::connection> {
 public:
+  RawBufferSocket() {}
+  explicit RawBufferSocket(RawBufferSocketStatsSharedPtr stats) : stats_(std::move(stats)) {}
+  ~RawBufferSocket();
+
   // Network::TransportSocket
   void setTransportSocketCallbacks(TransportSocketCallbacks& callbacks) override;
   std::string protocol() const override;
   bool canFlushClose() override { return true; }
-  void closeSocket(Network::ConnectionEvent) override {}
+  void closeSocket(Network::ConnectionEvent) override;
   void onConnected() override;
   IoResult doRead(Buffer::Instance& buffer) override;
   IoResult doWrite(Buffer::Instance& buffer, bool end_stream) override;
   const Ssl::Connection* ssl() const override { return nullptr; }
 
 private:
+  // A receive into a reservation of the request's own buffer. The request outlives the socket if
+  // the socket is closed first, so that the kernel never writes to freed memory.
+  struct RecvRequest : public Event::IoUringRequest {
+    explicit RecvRequest(RawBufferSocket& socket) : socket_(&socket) {}
+
+    // Event::IoUringRequest
+    void onCompletion(int32_t result) override;
+
+    // The socket, or nullptr once it no longer waits for the request.
+    RawBufferSocket* socket_;
+    Buffer::OwnedImpl buffer_;
+    Buffer::RawSlice slice_;
+  };
+
+  // A send of a copy of the start of the write buffer, which the request owns until it has been
+  // sent.
+  struct SendRequest : public Event::IoUringRequest {
+    explicit SendRequest(RawBufferSocket& socket) : socket_(&socket) {}
+
+    // Event::IoUringRequest
+    void onCompletion(int32_t result) override;
+
+    // The socket, or nullptr once it no longer waits for the request.
+    RawBufferSocket* socket_;
+    Buffer::OwnedImpl buffer_;
+    std::vector<iovec> iovecs_;
+    msghdr message_{};
+    uint64_t num_slices_{};
+  };
+
+  IoResult doReadCompleted(Buffer::Instance& buffer);
+  IoResult doWriteCompleted(Buffer::Instance& buffer, bool end_stream);
+  void submitRecv();
+  void submitSend(std::unique_ptr<SendRequest> request);
+  // Sends the rest of the request's data, before anything written since it was submitted.
+  void resubmitSend(SendRequest& request);
+  void onRecvCompleted(RecvRequest& request, int32_t result);
+  void onSendCompleted(SendRequest& request, int32_t result);
+  void detachRequests();
+  void recordWrite(uint64_t bytes_written, uint64_t num_slices, uint64_t length);
+
   TransportSocketCallbacks* callbacks_{};
   bool shutdown_{};
+  const RawBufferSocketStatsSharedPtr stats_;
+
+  Event::IoUring* io_uring_{};
+  RecvRequest* recv_request_{};
+  SendRequest* send_request_{};
+  // What completed receives got, which the connection has not read yet.
+  Buffer::OwnedImpl received_;
+  bool received_end_stream_{};
+  // What completed sends sent, which has not been drained from the write buffer yet.
+  uint64_t bytes_sent_{};
+  bool recv_failed_{};
+  bool send_failed_{};
 };
 
 class RawBufferSocketFactory : public TransportSocketFactory {
 public:
+  RawBufferSocketFactory() {}
+  /**
+   * @param stats_scope supplies the scope in which the stats of the created sockets are rooted, as
+   *        raw_buffer_socket.*.
+   */
+  explicit RawBufferSocketFactory(Stats::Scope& stats_scope);
+
   // Network::TransportSocketFactory
   TransportSocketPtr createTransportSocket() const override;
   bool implementsSecureTransport() const override;
+
+private:
+  const RawBufferSocketStatsSharedPtr stats_;
 };
 
 } // namespace Network
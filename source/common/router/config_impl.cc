@@ -5,7 +5,6 @@
 #include <cstdint>
 #include <map>
 #include <memory>
-#include <regex>
 #include <string>
 #include <vector>
 
@@ -25,6 +24,7 @@
 #include "common/config/rds_json.h"
 #include "common/config/utility.h"
 #include "common/config/well_known_names.h"
+#include "common/http/header_name_registry.h"
 #include "common/http/headers.h"
 #include "common/http/utility.h"
 #include "common/protobuf/protobuf.h"
@@ -106,7 +106,7 @@ CorsPolicyImpl::CorsPolicyImpl(const envoy::api::v2::route::CorsPolicy& config)
     allow_origin_.push_back(origin);
   }
   for (const auto& regex : config.allow_origin_regex()) {
-    allow_origin_regex_.push_back(RegexUtil::parseRegex(regex));
+    allow_origin_regex_.push_back(Regex::Utility::parseRegex(regex));
   }
   allow_methods_ = config.allow_methods();
   allow_headers_ = config.allow_headers();
@@ -140,7 +140,8 @@ private:
 class HeaderHashMethod : public HashMethodImplBase {
 public:
   HeaderHashMethod(const std::string& header_name, bool terminal)
-      : HashMethodImplBase(terminal), header_name_(header_name) {}
+      : HashMethodImplBase(terminal),
+        header_name_(Http::HeaderNameRegistry::intern(Http::LowerCaseString(header_name))) {}
 
   absl::optional<uint64_t> evaluate(const Network::Address::Instance*,
                                     const Http::HeaderMap& headers,
@@ -155,7 +156,7 @@ public:
   }
 
 private:
-  const Http::LowerCaseString header_name_;
+  const Http::InternedHeaderName header_name_;
 };
 
 class CookieHashMethod : public HashMethodImplBase {
@@ -281,7 +282,9 @@ RouteEntryImplBase::RouteEntryImplBase(const VirtualHostImpl& vhost,
       prefix_rewrite_(route.route().prefix_rewrite()), host_rewrite_(route.route().host_rewrite()),
       vhost_(vhost),
       auto_host_rewrite_(PROTOBUF_GET_WRAPPED_OR_DEFAULT(route.route(), auto_host_rewrite, false)),
-      cluster_name_(route.route().cluster()), cluster_header_name_(route.route().cluster_header()),
+      cluster_name_(route.route().cluster()),
+      cluster_header_name_(
+          Http::HeaderNameRegistry::intern(Http::LowerCaseString(route.route().cluster_header()))),
       cluster_not_found_response_code_(ConfigUtility::parseClusterNotFoundResponseCode(
           route.route().cluster_not_found_response_code())),
       timeout_(PROTOBUF_GET_MS_OR_DEFAULT(route.route(), timeout, DEFAULT_ROUTE_TIMEOUT_MS)),
@@ -379,6 +382,14 @@ bool RouteEntryImplBase::evaluateRuntimeMatch(const uint64_t random_value) const
                                                        random_value);
 }
 
+RouteConstSharedPtr RouteEntryImplBase::matchesIgnoringPath(const Http::HeaderMap& headers,
+                                                            uint64_t random_value) const {
+  if (matchRoute(headers, random_value)) {
+    return clusterEntry(headers, random_value);
+  }
+  return nullptr;
+}
+
 bool RouteEntryImplBase::matchRoute(const Http::HeaderMap& headers, uint64_t random_value) const {
   bool matches = true;
 
@@ -601,7 +612,7 @@ RouteConstSharedPtr RouteEntryImplBase::clusterEntry(const Http::HeaderMap& head
     if (!cluster_name_.empty() || isDirectResponse()) {
       return shared_from_this();
     } else {
-      ASSERT(!cluster_header_name_.get().empty());
+      ASSERT(!cluster_header_name_.name().get().empty());
       const Http::HeaderEntry* entry = headers.get(cluster_header_name_);
       std::string final_cluster_name;
       if (entry) {
@@ -743,7 +754,8 @@ RegexRouteEntryImpl::RegexRouteEntryImpl(const VirtualHostImpl& vhost,
                                          const envoy::api::v2::route::Route& route,
                                          Server::Configuration::FactoryContext& factory_context)
     : RouteEntryImplBase(vhost, route, factory_context),
-      regex_(RegexUtil::parseRegex(route.match().regex())), regex_str_(route.match().regex()) {}
+      regex_(Regex::Utility::parseRegex(route.match().regex())),
+      regex_str_(route.match().regex()) {}
 
 void RegexRouteEntryImpl::rewritePathHeader(Http::HeaderMap& headers,
                                             bool insert_envoy_original_path) const {
@@ -751,7 +763,7 @@ void RegexRouteEntryImpl::rewritePathHeader(Http::HeaderMap& headers,
   const char* query_string_start = Http::Utility::findQueryStringStart(path);
   // TODO(yuval-k): This ASSERT can happen if the path was changed by a filter without clearing the
   // route cache. We should consider if ASSERT-ing is the desired behavior in this case.
-  ASSERT(std::regex_match(path.c_str(), query_string_start, regex_));
+  ASSERT(regex_->match(absl::string_view(path.c_str(), query_string_start - path.c_str())));
   std::string matched_path(path.c_str(), query_string_start);
 
   finalizePathHeader(headers, matched_path, insert_envoy_original_path);
@@ -762,7 +774,7 @@ RouteConstSharedPtr RegexRouteEntryImpl::matches(const Http::HeaderMap& headers,
   if (RouteEntryImplBase::matchRoute(headers, random_value)) {
     const Http::HeaderString& path = headers.Path()->value();
     const char* query_string_start = Http::Utility::findQueryStringStart(path);
-    if (std::regex_match(path.c_str(), query_string_start, regex_)) {
+    if (regex_->match(absl::string_view(path.c_str(), query_string_start - path.c_str()))) {
       return clusterEntry(headers, random_value);
     }
   }
@@ -802,13 +814,17 @@ VirtualHostImpl::VirtualHostImpl(const envoy::api::v2::route::VirtualHost& virtu
         route.match().path_specifier_case() == envoy::api::v2::route::RouteMatch::kPath;
     const bool has_regex =
         route.match().path_specifier_case() == envoy::api::v2::route::RouteMatch::kRegex;
+    const uint32_t ordinal = routes_.size();
     if (has_prefix) {
       routes_.emplace_back(new PrefixRouteEntryImpl(*this, route, factory_context));
+      pathsFor(*routes_.back()).addPrefix(route.match().prefix(), ordinal);
     } else if (has_path) {
       routes_.emplace_back(new PathRouteEntryImpl(*this, route, factory_context));
+      pathsFor(*routes_.back()).addPath(route.match().path(), ordinal);
     } else {
       ASSERT(has_regex);
       routes_.emplace_back(new RegexRouteEntryImpl(*this, route, factory_context));
+      unindexed_routes_.push_back(ordinal);
     }
 
     if (validate_clusters) {
@@ -822,6 +838,14 @@ VirtualHostImpl::VirtualHostImpl(const envoy::api::v2::route::VirtualHost& virtu
     }
   }
 
+  if (unindexed_routes_.size() >= REGEX_SET_MIN_ROUTES) {
+    regex_set_ = std::make_unique<Regex::GoogleReSet>();
+    for (const uint32_t ordinal : unindexed_routes_) {
+      regex_set_->add(routes_[ordinal]->pathMatchCriterion().matcher());
+    }
+    regex_set_->compile();
+  }
+
   for (const auto& virtual_cluster : virtual_host.virtual_clusters()) {
     virtual_clusters_.push_back(VirtualClusterEntry(virtual_cluster));
   }
@@ -838,10 +862,14 @@ VirtualHostImpl::VirtualClusterEntry::VirtualClusterEntry(
   }
 
   const std::string pattern = virtual_cluster.pattern();
-  pattern_ = RegexUtil::parseRegex(pattern);
+  pattern_ = Regex::Utility::parseRegex(pattern);
   name_ = virtual_cluster.name();
 }
 
+PathRadixTree& VirtualHostImpl::pathsFor(const RouteEntryImplBase& route) {
+  return route.caseSensitive() ? case_sensitive_paths_ : case_insensitive_paths_;
+}
+
 const Config& VirtualHostImpl::routeConfig() const { return global_route_config_; }
 
 const RouteSpecificFilterConfig* VirtualHostImpl::perFilterConfig(const std::string& name) const {
@@ -906,9 +934,52 @@ RouteConstSharedPtr VirtualHostImpl::getRouteFromEntries(const Http::HeaderMap&
     return SSL_REDIRECT_ROUTE;
   }
 
-  // Check for a route that matches the request.
-  for (const RouteEntryImplBaseConstSharedPtr& route : routes_) {
-    RouteConstSharedPtr route_entry = route->matches(headers, random_value);
+  if (routes_.empty()) {
+    return nullptr;
+  }
+
+  // Check for a route that matches the request. The radix trees narrow the prefix and exact path
+  // routes down to those whose path matches the request. These candidates are merged with the
+  // routes that can't be indexed and evaluated in configuration order, so the first route that
+  // matches wins just as with a linear scan of routes_.
+  const Http::HeaderString& path = headers.Path()->value();
+  const size_t exact_length = Http::Utility::findQueryStringStart(path) - path.c_str();
+  std::vector<uint32_t> candidates;
+  case_sensitive_paths_.findCandidates(path.getStringView(), exact_length, candidates);
+  case_insensitive_paths_.findCandidates(path.getStringView(), exact_length, candidates);
+  std::sort(candidates.begin(), candidates.end());
+
+  // When the regex routes are compiled into a set, one pass over the path finds the regex routes
+  // whose path matches. Only the remaining constraints of those routes are then checked.
+  std::vector<int> regex_set_matches;
+  bool use_regex_set = false;
+  if (regex_set_ != nullptr) {
+    use_regex_set =
+        regex_set_->match(absl::string_view(path.c_str(), exact_length), regex_set_matches);
+    if (!use_regex_set) {
+      ENVOY_LOG(debug, "regex set for virtual host '{}' exceeded its memory budget", name_);
+    }
+  }
+  const size_t regex_count = use_regex_set ? regex_set_matches.size() : unindexed_routes_.size();
+
+  size_t indexed = 0;
+  size_t unindexed = 0;
+  while (indexed < candidates.size() || unindexed < regex_count) {
+    RouteConstSharedPtr route_entry;
+    const uint32_t unindexed_ordinal =
+        unindexed < regex_count
+            ? unindexed_routes_[use_regex_set ? regex_set_matches[unindexed] : unindexed]
+            : 0;
+    if (unindexed == regex_count ||
+        (indexed < candidates.size() && candidates[indexed] < unindexed_ordinal)) {
+      route_entry = routes_[candidates[indexed++]]->matches(headers, random_value);
+    } else {
+      unindexed++;
+      const RouteEntryImplBase& route = *routes_[unindexed_ordinal];
+      route_entry = use_regex_set ? route.matchesIgnoringPath(headers, random_value)
+                                  : route.matches(headers, random_value);
+    }
+
     if (nullptr != route_entry) {
       return route_entry;
     }
@@ -960,7 +1031,7 @@ VirtualHostImpl::virtualClusterFromEntries(const Http::HeaderMap& headers) const
     bool method_matches =
         !entry.method_ || headers.Method()->value().c_str() == entry.method_.value();
 
-    if (method_matches && std::regex_match(headers.Path()->value().c_str(), entry.pattern_)) {
+    if (method_matches && entry.pattern_->match(headers.Path()->value().getStringView())) {
       return &entry;
     }
   }
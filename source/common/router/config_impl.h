@@ -5,7 +5,6 @@
 #include <list>
 #include <map>
 #include <memory>
-#include <regex>
 #include <string>
 #include <unordered_map>
 #include <vector>
@@ -17,12 +16,14 @@
 #include "envoy/server/filter_config.h"
 #include "envoy/upstream/cluster_manager.h"
 
+#include "common/common/regex.h"
 #include "common/config/metadata.h"
 #include "common/http/header_utility.h"
 #include "common/router/config_utility.h"
 #include "common/router/header_formatter.h"
 #include "common/router/header_parser.h"
 #include "common/router/metadatamatchcriteria_impl.h"
+#include "common/router/path_radix_tree.h"
 #include "common/router/router_ratelimit.h"
 
 #include "absl/types/optional.h"
@@ -98,7 +99,9 @@ public:
 
   // Router::CorsPolicy
   const std::list<std::string>& allowOrigins() const override { return allow_origin_; };
-  const std::list<std::regex>& allowOriginRegexes() const override { return allow_origin_regex_; }
+  const std::list<Regex::CompiledMatcherPtr>& allowOriginRegexes() const override {
+    return allow_origin_regex_;
+  }
   const std::string& allowMethods() const override { return allow_methods_; };
   const std::string& allowHeaders() const override { return allow_headers_; };
   const std::string& exposeHeaders() const override { return expose_headers_; };
@@ -108,7 +111,7 @@ public:
 
 private:
   std::list<std::string> allow_origin_;
-  std::list<std::regex> allow_origin_regex_;
+  std::list<Regex::CompiledMatcherPtr> allow_origin_regex_;
   std::string allow_methods_;
   std::string allow_headers_;
   std::string expose_headers_;
@@ -121,7 +124,7 @@ class ConfigImpl;
 /**
  * Holds all routing configuration for an entire virtual host.
  */
-class VirtualHostImpl : public VirtualHost {
+class VirtualHostImpl : public VirtualHost, Logger::Loggable<Logger::Id::router> {
 public:
   VirtualHostImpl(const envoy::api::v2::route::VirtualHost& virtual_host,
                   const ConfigImpl& global_route_config,
@@ -151,7 +154,7 @@ private:
     // Router::VirtualCluster
     const std::string& name() const override { return name_; }
 
-    std::regex pattern_;
+    Regex::CompiledMatcherPtr pattern_;
     absl::optional<std::string> method_;
     std::string name_;
   };
@@ -163,11 +166,24 @@ private:
     std::string name_{"other"};
   };
 
+  PathRadixTree& pathsFor(const RouteEntryImplBase& route);
+
+  // Below this many regex routes, matching each regex on its own is cheaper than a regex set.
+  static const uint32_t REGEX_SET_MIN_ROUTES = 8;
+
   static const CatchAllVirtualCluster VIRTUAL_CLUSTER_CATCH_ALL;
   static const std::shared_ptr<const SslRedirectRoute> SSL_REDIRECT_ROUTE;
 
   const std::string name_;
   std::vector<RouteEntryImplBaseConstSharedPtr> routes_;
+  // Prefix and exact path routes indexed by their ordinal in routes_. See getRouteFromEntries().
+  PathRadixTree case_sensitive_paths_{true};
+  PathRadixTree case_insensitive_paths_{false};
+  // Ordinals of routes which can't be indexed by path and are evaluated for every request.
+  std::vector<uint32_t> unindexed_routes_;
+  // When there are at least REGEX_SET_MIN_ROUTES such routes, their regexes are compiled into a
+  // single set, in the order of unindexed_routes_.
+  std::unique_ptr<Regex::GoogleReSet> regex_set_;
   std::vector<VirtualClusterEntry> virtual_clusters_;
   SslRequirements ssl_requirements_;
   const RateLimitPolicyImpl rate_limit_policy_;
@@ -298,6 +314,7 @@ public:
                      Server::Configuration::FactoryContext& factory_context);
 
   bool isDirectResponse() const { return direct_response_code_.has_value(); }
+  bool caseSensitive() const { return case_sensitive_; }
 
   bool isRedirect() const {
     if (!isDirectResponse()) {
@@ -307,6 +324,12 @@ public:
   }
 
   bool matchRoute(const Http::HeaderMap& headers, uint64_t random_value) const;
+  /**
+   * Like matches(), but skips the path check. Used when the caller has already established that
+   * the request path matches this route's path specifier.
+   */
+  RouteConstSharedPtr matchesIgnoringPath(const Http::HeaderMap& headers,
+                                          uint64_t random_value) const;
   void validateClusters(Upstream::ClusterManager& cm) const;
 
   // Router::RouteEntry
@@ -525,7 +548,7 @@ private:
                                  // to virtual host is currently safe.
   const bool auto_host_rewrite_;
   const std::string cluster_name_;
-  const Http::LowerCaseString cluster_header_name_;
+  const Http::InternedHeaderName cluster_header_name_;
   const Http::Code cluster_not_found_response_code_;
   const std::chrono::milliseconds timeout_;
   const absl::optional<std::chrono::milliseconds> idle_timeout_;
@@ -630,7 +653,7 @@ public:
   void rewritePathHeader(Http::HeaderMap& headers, bool insert_envoy_original_path) const override;
 
 private:
-  const std::regex regex_;
+  const Regex::CompiledMatcherPtr regex_;
   const std::string regex_str_;
 };
 
@@ -2,16 +2,17 @@
 
 #include <inttypes.h>
 
-#include <regex>
 #include <string>
 #include <vector>
 
 #include "envoy/api/v2/route/route.pb.h"
+#include "envoy/common/regex.h"
 #include "envoy/http/codes.h"
 #include "envoy/json/json_object.h"
 #include "envoy/upstream/resource_manager.h"
 
 #include "common/common/empty_string.h"
+#include "common/common/regex.h"
 #include "common/common/utility.h"
 #include "common/config/rds_json.h"
 #include "common/http/headers.h"
@@ -36,7 +37,7 @@ public:
     QueryParameterMatcher(const envoy::api::v2::route::QueryParameterMatcher& config)
         : name_(config.name()), value_(config.value()),
           is_regex_(PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, regex, false)),
-          regex_pattern_(is_regex_ ? RegexUtil::parseRegex(value_) : std::regex()) {}
+          regex_pattern_(is_regex_ ? Regex::Utility::parseRegex(value_) : nullptr) {}
 
     /**
      * Check if the query parameters for a request contain a match for this
@@ -50,7 +51,7 @@ public:
     const std::string name_;
     const std::string value_;
     const bool is_regex_;
-    const std::regex regex_pattern_;
+    const Regex::CompiledMatcherSharedPtr regex_pattern_;
   };
 
   /**
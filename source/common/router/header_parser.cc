@@ -6,6 +6,7 @@
 #include <string>
 
 #include "common/common/assert.h"
+#include "common/http/header_name_registry.h"
 #include "common/http/headers.h"
 #include "common/protobuf/utility.h"
 
@@ -228,7 +229,8 @@ HeaderParserPtr HeaderParser::configure(
     HeaderFormatterPtr header_formatter = parseInternal(header_value_option);
 
     header_parser->headers_to_add_.emplace_back(
-        Http::LowerCaseString(header_value_option.header().key()), std::move(header_formatter));
+        Http::HeaderNameRegistry::intern(Http::LowerCaseString(header_value_option.header().key())),
+        std::move(header_formatter));
   }
 
   return header_parser;
@@ -246,7 +248,8 @@ HeaderParserPtr HeaderParser::configure(
     if (header[0] == ':' || Http::LowerCaseString(header).get() == "host") {
       throw EnvoyException(":-prefixed or host headers may not be removed");
     }
-    header_parser->headers_to_remove_.emplace_back(header);
+    header_parser->headers_to_remove_.emplace_back(
+        Http::HeaderNameRegistry::intern(Http::LowerCaseString(header)));
   }
 
   return header_parser;
@@ -45,8 +45,8 @@ protected:
   HeaderParser() {}
 
 private:
-  std::vector<std::pair<Http::LowerCaseString, HeaderFormatterPtr>> headers_to_add_;
-  std::vector<Http::LowerCaseString> headers_to_remove_;
+  std::vector<std::pair<Http::InternedHeaderName, HeaderFormatterPtr>> headers_to_add_;
+  std::vector<Http::InternedHeaderName> headers_to_remove_;
 };
 
 } // namespace Router
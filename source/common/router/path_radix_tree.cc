@@ -0,0 +1,107 @@
+#include "common/router/path_radix_tree.h"
+
+#include "common/common/assert.h"
+
+#include "absl/strings/ascii.h"
+
+namespace Envoy {
+namespace Router {
+
+PathRadixTree::PathRadixTree(bool case_sensitive)
+    : case_sensitive_(case_sensitive), root_(std::make_unique<Node>()) {}
+
+char PathRadixTree::normalize(char c) const {
+  return case_sensitive_ ? c : absl::ascii_tolower(c);
+}
+
+PathRadixTree::Node& PathRadixTree::findOrCreateNode(absl::string_view key) {
+  Node* node = root_.get();
+  size_t position = 0;
+  while (position < key.size()) {
+    const char first = normalize(key[position]);
+    auto child = node->children_.find(first);
+    if (child == node->children_.end()) {
+      NodePtr new_node = std::make_unique<Node>();
+      new_node->label_.reserve(key.size() - position);
+      for (size_t i = position; i < key.size(); i++) {
+        new_node->label_.push_back(normalize(key[i]));
+      }
+      node = (node->children_[first] = std::move(new_node)).get();
+      break;
+    }
+
+    const std::string& label = child->second->label_;
+    size_t common = 0;
+    while (common < label.size() && position + common < key.size() &&
+           label[common] == normalize(key[position + common])) {
+      common++;
+    }
+
+    if (common < label.size()) {
+      // The key diverges (or ends) in the middle of this edge, so split it in two.
+      NodePtr split = std::make_unique<Node>();
+      split->label_ = label.substr(0, common);
+      NodePtr existing = std::move(child->second);
+      existing->label_ = existing->label_.substr(common);
+      split->children_[existing->label_[0]] = std::move(existing);
+      child->second = std::move(split);
+    }
+
+    node = child->second.get();
+    position += common;
+  }
+
+  return *node;
+}
+
+void PathRadixTree::addPrefix(absl::string_view prefix, uint32_t ordinal) {
+  Node& node = findOrCreateNode(prefix);
+  ASSERT(node.prefix_ordinals_.empty() || node.prefix_ordinals_.back() < ordinal);
+  node.prefix_ordinals_.push_back(ordinal);
+  size_++;
+}
+
+void PathRadixTree::addPath(absl::string_view path, uint32_t ordinal) {
+  Node& node = findOrCreateNode(path);
+  ASSERT(node.path_ordinals_.empty() || node.path_ordinals_.back() < ordinal);
+  node.path_ordinals_.push_back(ordinal);
+  size_++;
+}
+
+void PathRadixTree::findCandidates(absl::string_view path, size_t exact_length,
+                                   std::vector<uint32_t>& ordinals) const {
+  ASSERT(exact_length <= path.size());
+  const Node* node = root_.get();
+  size_t position = 0;
+  while (true) {
+    ordinals.insert(ordinals.end(), node->prefix_ordinals_.begin(), node->prefix_ordinals_.end());
+    if (position == exact_length) {
+      ordinals.insert(ordinals.end(), node->path_ordinals_.begin(), node->path_ordinals_.end());
+    }
+
+    if (position == path.size()) {
+      return;
+    }
+
+    auto child = node->children_.find(normalize(path[position]));
+    if (child == node->children_.end()) {
+      return;
+    }
+
+    const std::string& label = child->second->label_;
+    if (label.size() > path.size() - position) {
+      return;
+    }
+    for (size_t i = 1; i < label.size(); i++) {
+      if (label[i] != normalize(path[position + i])) {
+        return;
+      }
+    }
+
+    node = child->second.get();
+    position += label.size();
+  }
+}
+
+} // namespace Router
+} // namespace Envoy
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "absl/strings/string_view.h"
+
+namespace Envoy {
+namespace Router {
+
+/**
+ * Radix tree over literal path strings. It is built once at config load time from the prefix and
+ * exact path routes of a virtual host and is used at request time to narrow the set of routes
+ * that can possibly match a request path. Routes are identified by their ordinal within the owning
+ * virtual host so that callers can preserve first-match semantics.
+ */
+class PathRadixTree {
+public:
+  /**
+   * @param case_sensitive supplies whether keys and looked up paths are compared byte for byte or
+   *        ignoring ASCII case.
+   */
+  PathRadixTree(bool case_sensitive);
+
+  /**
+   * Add a route that matches any path starting with prefix.
+   * @param prefix supplies the route prefix.
+   * @param ordinal supplies the route ordinal. Ordinals must be added in increasing order.
+   */
+  void addPrefix(absl::string_view prefix, uint32_t ordinal);
+
+  /**
+   * Add a route that matches a path (excluding the query string) equal to path.
+   * @param path supplies the route path.
+   * @param ordinal supplies the route ordinal. Ordinals must be added in increasing order.
+   */
+  void addPath(absl::string_view path, uint32_t ordinal);
+
+  /**
+   * Append the ordinals of all routes which may match a request path. The ordinals are appended
+   * in no particular order.
+   * @param path supplies the full request path, including any query string.
+   * @param exact_length supplies the length of the path without its query string. This is the
+   *        length used for exact path routes.
+   * @param ordinals supplies the vector to append candidate ordinals to.
+   */
+  void findCandidates(absl::string_view path, size_t exact_length,
+                      std::vector<uint32_t>& ordinals) const;
+
+  /**
+   * @return size_t the number of routes that have been added to the tree.
+   */
+  size_t size() const { return size_; }
+
+private:
+  struct Node;
+  typedef std::unique_ptr<Node> NodePtr;
+
+  struct Node {
+    // Bytes on the edge leading from the parent to this node. Empty only for the root.
+    std::string label_;
+    std::vector<uint32_t> prefix_ordinals_;
+    std::vector<uint32_t> path_ordinals_;
+    // Keyed by the first byte of the child label.
+    std::map<char, NodePtr> children_;
+  };
+
+  Node& findOrCreateNode(absl::string_view key);
+  char normalize(char c) const;
+
+  const bool case_sensitive_;
+  NodePtr root_;
+  size_t size_{};
+};
+
+} // namespace Router
+} // namespace Envoy
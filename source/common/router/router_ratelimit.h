@@ -9,6 +9,7 @@
 #include "envoy/router/router_ratelimit.h"
 
 #include "common/config/rds_json.h"
+#include "common/http/header_name_registry.h"
 #include "common/http/header_utility.h"
 
 namespace Envoy {
@@ -42,7 +43,8 @@ public:
 class RequestHeadersAction : public RateLimitAction {
 public:
   RequestHeadersAction(const envoy::api::v2::route::RateLimit::Action::RequestHeaders& action)
-      : header_name_(action.header_name()), descriptor_key_(action.descriptor_key()) {}
+      : header_name_(Http::HeaderNameRegistry::intern(Http::LowerCaseString(action.header_name()))),
+        descriptor_key_(action.descriptor_key()) {}
 
   // Router::RateLimitAction
   bool populateDescriptor(const Router::RouteEntry& route, RateLimit::Descriptor& descriptor,
@@ -50,7 +52,7 @@ public:
                           const Network::Address::Instance& remote_address) const override;
 
 private:
-  const Http::LowerCaseString header_name_;
+  const Http::InternedHeaderName header_name_;
   const std::string descriptor_key_;
 };
 
@@ -2,16 +2,17 @@
 
 #include "common/common/lock_guard.h"
 #include "common/common/thread.h"
-#include "common/common/utility.h"
 
 namespace Envoy {
 namespace Stats {
 
-HeapStatData::HeapStatData(absl::string_view key) {
-  StringUtil::strlcpy(name_, key.data(), key.size() + 1);
-}
+HeapStatData::HeapStatData(SymbolEncoding& encoding) { encoding.moveToStorage(symbol_storage_); }
+
+HeapStatDataAllocator::HeapStatDataAllocator()
+    : owned_symbol_table_(std::make_unique<SymbolTable>()), symbol_table_(*owned_symbol_table_) {}
 
-HeapStatDataAllocator::HeapStatDataAllocator() {}
+HeapStatDataAllocator::HeapStatDataAllocator(SymbolTable& symbol_table)
+    : symbol_table_(symbol_table) {}
 
 HeapStatDataAllocator::~HeapStatDataAllocator() { ASSERT(stats_.empty()); }
 
@@ -20,8 +21,9 @@ HeapStatData* HeapStatDataAllocator::alloc(absl::string_view name) {
   // required to use this allocator. Note that data must be freed by calling
   // its free() method, and not by destruction, thus the more complex use of
   // unique_ptr.
+  SymbolEncoding encoding = symbol_table_.encode(name);
   std::unique_ptr<HeapStatData, std::function<void(HeapStatData * d)>> data(
-      HeapStatData::alloc(name), [](HeapStatData* d) { d->free(); });
+      HeapStatData::alloc(encoding), [](HeapStatData* d) { d->free(); });
   Thread::ReleasableLockGuard lock(mutex_);
   auto ret = stats_.insert(data.get());
   HeapStatData* existing_data = *ret.first;
@@ -31,6 +33,8 @@ HeapStatData* HeapStatDataAllocator::alloc(absl::string_view name) {
     return data.release();
   }
   ++existing_data->ref_count_;
+  // The new block is discarded, so drop the symbol references taken when encoding its name.
+  symbol_table_.free(data->statName());
   return existing_data;
 }
 
@@ -46,13 +50,14 @@ void HeapStatDataAllocator::free(HeapStatData& data) {
     ASSERT(key_removed == 1);
   }
 
+  symbol_table_.free(data.statName());
   data.free();
 }
 
-HeapStatData* HeapStatData::alloc(absl::string_view name) {
-  void* memory = ::malloc(sizeof(HeapStatData) + name.size() + 1);
+HeapStatData* HeapStatData::alloc(SymbolEncoding& encoding) {
+  void* memory = ::malloc(sizeof(HeapStatData) + encoding.bytesRequired());
   ASSERT(memory);
-  return new (memory) HeapStatData(name);
+  return new (memory) HeapStatData(encoding);
 }
 
 void HeapStatData::free() {
@@ -1,13 +1,14 @@
 #pragma once
 
 #include <cstdint>
+#include <memory>
 #include <string>
 #include <unordered_set>
 
-#include "common/common/hash.h"
 #include "common/common/thread.h"
 #include "common/common/thread_annotations.h"
 #include "common/stats/stat_data_allocator_impl.h"
+#include "common/stats/symbol_table_impl.h"
 
 #include "absl/container/flat_hash_set.h"
 
@@ -16,34 +17,31 @@ namespace Stats {
 
 /**
  * This structure is an alternate backing store for both CounterImpl and GaugeImpl. It is designed
- * so that it can be allocated efficiently from the heap on demand.
+ * so that it can be allocated efficiently from the heap on demand. The name is stored inline as
+ * its symbolized encoding, so the tokens it shares with other stat names are only held once, in
+ * the allocator's SymbolTable.
  */
 struct HeapStatData {
   /**
-   * @returns absl::string_view the name as a string_view.
+   * @returns StatName the symbolized name, which references this object's storage.
    */
-  absl::string_view key() const { return name_; }
+  StatName statName() const { return StatName(symbol_storage_); }
 
-  /**
-   * @returns std::string the name as a const char*.
-   */
-  const char* name() const { return name_; }
-
-  static HeapStatData* alloc(absl::string_view name);
+  static HeapStatData* alloc(SymbolEncoding& encoding);
   void free();
 
   std::atomic<uint64_t> value_{0};
   std::atomic<uint64_t> pending_increment_{0};
   std::atomic<uint16_t> flags_{0};
   std::atomic<uint16_t> ref_count_{1};
-  char name_[];
+  uint8_t symbol_storage_[];
 
 private:
   /**
    * You cannot construct/destruct a HeapStatData directly with new/delete as
    * it's variable-size. Use alloc()/free() methods above.
    */
-  explicit HeapStatData(absl::string_view name);
+  explicit HeapStatData(SymbolEncoding& encoding);
   ~HeapStatData() {}
 };
 
@@ -53,33 +51,45 @@ private:
  */
 class HeapStatDataAllocator : public StatDataAllocatorImpl<HeapStatData> {
 public:
+  /**
+   * Constructs an allocator which owns its symbol table.
+   */
   HeapStatDataAllocator();
+
+  /**
+   * Constructs an allocator which encodes names in a table shared with other allocators, so that
+   * their stat names can be compared with each other.
+   * @param symbol_table supplies the table, which must outlive the allocator.
+   */
+  explicit HeapStatDataAllocator(SymbolTable& symbol_table);
   ~HeapStatDataAllocator();
 
   // StatDataAllocatorImpl
   HeapStatData* alloc(absl::string_view name) override;
   void free(HeapStatData& data) override;
+  StatName acquireStatName(HeapStatData& data) override { return data.statName(); }
+  void releaseStatName(HeapStatData&) override {}
 
   // StatDataAllocator
   bool requiresBoundedStatNameSize() const override { return false; }
+  SymbolTable& symbolTable() override { return symbol_table_; }
 
 private:
   struct HeapStatHash {
-    size_t operator()(const HeapStatData* a) const { return HashUtil::xxHash64(a->key()); }
+    size_t operator()(const HeapStatData* a) const { return a->statName().hash(); }
   };
   struct HeapStatCompare {
     bool operator()(const HeapStatData* a, const HeapStatData* b) const {
-      return (a->key() == b->key());
+      return (a->statName() == b->statName());
     }
   };
 
-  // TODO(jmarantz): See https://github.com/envoyproxy/envoy/pull/3927 and
-  //  https://github.com/envoyproxy/envoy/issues/3585, which can help reorganize
-  // the heap stats using a ref-counted symbol table to compress the stat strings.
   using StatSet = absl::flat_hash_set<HeapStatData*, HeapStatHash, HeapStatCompare>;
 
-  // An unordered set of HeapStatData pointers which keys off the key()
-  // field in each object. This necessitates a custom comparator and hasher.
+  std::unique_ptr<SymbolTable> owned_symbol_table_;
+  SymbolTable& symbol_table_;
+  // An unordered set of HeapStatData pointers which keys off the statName()
+  // of each object. This necessitates a custom comparator and hasher.
   StatSet stats_ GUARDED_BY(mutex_);
   // A mutex is needed here to protect the stats_ object from both alloc() and free() operations.
   // Although alloc() operations are called under existing locking, free() operations are made from
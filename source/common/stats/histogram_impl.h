@@ -9,6 +9,7 @@
 
 #include "common/common/non_copyable.h"
 #include "common/stats/metric_impl.h"
+#include "common/stats/symbol_table_impl.h"
 
 #include "circllhist.h"
 
@@ -44,13 +45,15 @@ private:
  */
 class HistogramImpl : public Histogram, public MetricImpl {
 public:
-  HistogramImpl(const std::string& name, Store& parent, std::string&& tag_extracted_name,
-                std::vector<Tag>&& tags)
-      : MetricImpl(std::move(tag_extracted_name), std::move(tags)), parent_(parent), name_(name) {}
+  HistogramImpl(const std::string& name, Store& parent, SymbolTable& symbol_table,
+                std::string&& tag_extracted_name, std::vector<Tag>&& tags)
+      : MetricImpl(std::move(tag_extracted_name), std::move(tags)), parent_(parent),
+        symbol_table_(symbol_table), name_(name, symbol_table) {}
+  ~HistogramImpl() { name_.free(symbol_table_); }
 
   // Stats:;Metric
-  std::string name() const override { return name_; }
-  const char* nameCStr() const override { return name_.c_str(); }
+  std::string name() const override { return name_.statName().toString(symbol_table_); }
+  StatName statName() const override { return name_.statName(); }
 
   // Stats::Histogram
   void recordValue(uint64_t value) override { parent_.deliverHistogramToSinks(*this, value); }
@@ -61,7 +64,8 @@ private:
   // This is used for delivering the histogram data to sinks.
   Store& parent_;
 
-  const std::string name_;
+  SymbolTable& symbol_table_;
+  StatNameStorage name_;
 };
 
 /**
@@ -73,7 +77,7 @@ public:
   NullHistogramImpl() {}
   ~NullHistogramImpl() {}
   std::string name() const override { return ""; }
-  const char* nameCStr() const override { return ""; }
+  StatName statName() const override { return StatName(); }
   const std::string& tagExtractedName() const override { CONSTRUCT_ON_FIRST_USE(std::string, ""); }
   const std::vector<Tag>& tags() const override { CONSTRUCT_ON_FIRST_USE(std::vector<Tag>, {}); }
   void recordValue(uint64_t) override {}
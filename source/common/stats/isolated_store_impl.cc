@@ -24,7 +24,8 @@ IsolatedStoreImpl::IsolatedStoreImpl()
         return alloc_.makeGauge(name, std::move(tag_extracted_name), std::move(tags));
       }),
       histograms_([this](const std::string& name) -> HistogramSharedPtr {
-        return std::make_shared<HistogramImpl>(name, *this, std::string(name), std::vector<Tag>());
+        return std::make_shared<HistogramImpl>(name, *this, alloc_.symbolTable(), std::string(name),
+                                               std::vector<Tag>());
       }) {}
 
 struct IsolatedScopeImpl : public Scope {
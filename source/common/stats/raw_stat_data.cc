@@ -5,6 +5,9 @@
 #include <algorithm>
 #include <chrono>
 #include <string>
+#include <tuple>
+
+#include "common/common/lock_guard.h"
 
 namespace Envoy {
 namespace Stats {
@@ -41,6 +44,31 @@ void RawStatData::initialize(absl::string_view key, const StatsOptions& stats_op
   name_[key.size()] = '\0';
 }
 
+RawStatDataAllocator::~RawStatDataAllocator() { ASSERT(names_.empty()); }
+
+StatName RawStatDataAllocator::acquireStatName(RawStatData& data) {
+  Thread::LockGuard lock(mutex_);
+  auto it = names_.find(&data);
+  if (it != names_.end()) {
+    ++it->second.ref_count_;
+  } else {
+    it = names_.emplace(std::piecewise_construct, std::forward_as_tuple(&data),
+                        std::forward_as_tuple(data.key(), symbol_table_))
+             .first;
+  }
+  return it->second.storage_.statName();
+}
+
+void RawStatDataAllocator::releaseStatName(RawStatData& data) {
+  Thread::LockGuard lock(mutex_);
+  auto it = names_.find(&data);
+  ASSERT(it != names_.end());
+  if (--it->second.ref_count_ == 0) {
+    it->second.storage_.free(symbol_table_);
+    names_.erase(it);
+  }
+}
+
 template class StatDataAllocatorImpl<RawStatData>;
 
 } // namespace Stats
@@ -16,7 +16,10 @@
 
 #include "common/common/assert.h"
 #include "common/common/hash.h"
+#include "common/common/thread.h"
+#include "common/common/thread_annotations.h"
 #include "common/stats/stat_data_allocator_impl.h"
+#include "common/stats/symbol_table_impl.h"
 
 #include "absl/strings/string_view.h"
 
@@ -90,10 +93,35 @@ struct RawStatData {
   char name_[];
 };
 
+/**
+ * Base for allocators of RawStatData. The data blocks hold their names as characters, since they
+ * may be shared with another process, so the symbolized names of the stats are held separately in
+ * this process, one per data block.
+ */
 class RawStatDataAllocator : public StatDataAllocatorImpl<RawStatData> {
 public:
+  ~RawStatDataAllocator();
+
+  // StatDataAllocatorImpl
+  StatName acquireStatName(RawStatData& data) override;
+  void releaseStatName(RawStatData& data) override;
+
   // StatDataAllocator
   bool requiresBoundedStatNameSize() const override { return true; }
+  SymbolTable& symbolTable() override { return symbol_table_; }
+
+private:
+  struct NameEntry {
+    NameEntry(absl::string_view name, SymbolTable& symbol_table)
+        : storage_(name, symbol_table), ref_count_(1) {}
+
+    StatNameStorage storage_;
+    uint32_t ref_count_;
+  };
+
+  SymbolTable symbol_table_;
+  Thread::MutexBasicLockable mutex_;
+  std::unordered_map<const RawStatData*, NameEntry> names_ GUARDED_BY(mutex_);
 };
 
 } // namespace Stats
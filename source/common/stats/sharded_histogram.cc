@@ -0,0 +1,134 @@
+#include "common/stats/sharded_histogram.h"
+
+#include <stdlib.h>
+
+#include <new>
+
+#include "common/common/assert.h"
+
+namespace Envoy {
+namespace Stats {
+
+constexpr uint32_t ShardedHistogram::SubBucketBits;
+constexpr uint32_t ShardedHistogram::SubBuckets;
+constexpr uint32_t ShardedHistogram::MaxValueBits;
+constexpr uint32_t ShardedHistogram::NumBuckets;
+constexpr uint32_t ShardedHistogram::MaxShards;
+
+ShardedHistogram::ShardedHistogram() {
+  for (std::atomic<Shard*>& shard : shards_) {
+    shard.store(nullptr, std::memory_order_relaxed);
+  }
+}
+
+ShardedHistogram::~ShardedHistogram() {
+  for (std::atomic<Shard*>& shard : shards_) {
+    Shard* memory = shard.load(std::memory_order_relaxed);
+    if (memory != nullptr) {
+      memory->~Shard();
+      ::free(memory);
+    }
+  }
+}
+
+uint32_t ShardedHistogram::bucketIndex(uint64_t value) {
+  if (value < SubBuckets) {
+    return value;
+  }
+  const uint32_t msb = 63 - __builtin_clzll(value);
+  if (msb >= MaxValueBits) {
+    return NumBuckets - 1;
+  }
+  const uint32_t shift = msb - SubBucketBits;
+  return (shift + 1) * SubBuckets + ((value >> shift) & (SubBuckets - 1));
+}
+
+uint64_t ShardedHistogram::bucketLowerBound(uint32_t index) {
+  const uint32_t group = index / SubBuckets;
+  const uint64_t sub_bucket = index % SubBuckets;
+  if (group == 0) {
+    return sub_bucket;
+  }
+  return (SubBuckets + sub_bucket) << (group - 1);
+}
+
+uint64_t ShardedHistogram::bucketWidth(uint32_t index) {
+  const uint32_t group = index / SubBuckets;
+  return group == 0 ? 1 : uint64_t(1) << (group - 1);
+}
+
+uint32_t ShardedHistogram::threadShard() {
+  static std::atomic<uint32_t> next_shard{0};
+  static thread_local const uint32_t shard = next_shard++ % MaxShards;
+  return shard;
+}
+
+ShardedHistogram::Shard& ShardedHistogram::shardForThread() {
+  std::atomic<Shard*>& slot = shards_[threadShard()];
+  Shard* shard = slot.load(std::memory_order_acquire);
+  if (shard != nullptr) {
+    return *shard;
+  }
+
+  // This thread's first value. Shards are over-aligned, which operator new does not honor before
+  // C++17, so they are allocated directly.
+  void* memory = nullptr;
+  RELEASE_ASSERT(::posix_memalign(&memory, alignof(Shard), sizeof(Shard)) == 0, "");
+  Shard* new_shard = new (memory) Shard();
+  // Another thread sharing the slot may have installed a shard first, in which case ours is
+  // discarded.
+  if (slot.compare_exchange_strong(shard, new_shard, std::memory_order_acq_rel)) {
+    return *new_shard;
+  }
+  new_shard->~Shard();
+  ::free(memory);
+  return *shard;
+}
+
+void ShardedHistogram::recordValue(uint64_t value) {
+  shardForThread().buckets_[bucketIndex(value)].fetch_add(1, std::memory_order_relaxed);
+}
+
+uint64_t ShardedHistogram::merge(Buckets& interval) {
+  Buckets totals{};
+  Buckets shard_counts;
+  for (std::atomic<Shard*>& slot : shards_) {
+    const Shard* shard = slot.load(std::memory_order_acquire);
+    if (shard == nullptr) {
+      continue;
+    }
+    // Take a snapshot, so that the sum is done on plain integers.
+    for (uint32_t i = 0; i < NumBuckets; i++) {
+      shard_counts[i] = shard->buckets_[i].load(std::memory_order_relaxed);
+    }
+    addBuckets(totals, shard_counts);
+  }
+
+  uint64_t count = 0;
+  for (uint32_t i = 0; i < NumBuckets; i++) {
+    interval[i] = totals[i] - merged_[i];
+    count += interval[i];
+  }
+  merged_ = totals;
+  return count;
+}
+
+void ShardedHistogram::addBuckets(Buckets& target, const Buckets& source) {
+  uint64_t* __restrict__ out = target.data();
+  const uint64_t* __restrict__ in = source.data();
+  for (uint32_t i = 0; i < NumBuckets; i++) {
+    out[i] += in[i];
+  }
+}
+
+void ShardedHistogram::insertInto(histogram_t* target, const Buckets& buckets) {
+  for (uint32_t i = 0; i < NumBuckets; i++) {
+    if (buckets[i] != 0) {
+      const uint64_t value = bucketLowerBound(i) + (bucketWidth(i) - 1) / 2;
+      hist_insert_intscale(target, value, 0, buckets[i]);
+    }
+  }
+}
+
+} // namespace Stats
+} // namespace Envoy
@@ -0,0 +1,99 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+#include "common/common/non_copyable.h"
+
+#include "circllhist.h"
+
+namespace Envoy {
+namespace Stats {
+
+/**
+ * A histogram which counts values in fixed log-linear buckets. Each recording thread has its own
+ * shard of buckets, which are updated with relaxed atomics, so recording never takes a lock or
+ * looks anything up. The shards are summed by merge() at flush time.
+ *
+ * Values below 8 have their own buckets. Above that, every power of two is split into 8 linear
+ * buckets, so a value is reported within 1/16 of its true value. Values of 2^36 or more are
+ * counted in the last bucket.
+ */
+class ShardedHistogram : NonCopyable {
+public:
+  static constexpr uint32_t SubBucketBits = 3;
+  static constexpr uint32_t SubBuckets = 1 << SubBucketBits;
+  static constexpr uint32_t MaxValueBits = 36;
+  static constexpr uint32_t NumBuckets = (MaxValueBits - SubBucketBits + 1) * SubBuckets;
+  // Threads are assigned shards round robin. Threads beyond this share shards, which is still
+  // correct, as the buckets are updated atomically.
+  static constexpr uint32_t MaxShards = 64;
+
+  using Buckets = std::array<uint64_t, NumBuckets>;
+
+  ShardedHistogram();
+  ~ShardedHistogram();
+
+  /**
+   * Count a value in the calling thread's shard. This may be called from any thread.
+   * @param value supplies the value.
+   */
+  void recordValue(uint64_t value);
+
+  /**
+   * Sum the shards. This must not be called concurrently with itself.
+   * @param interval receives the counts recorded since the previous call.
+   * @return uint64_t the number of values recorded since the previous call.
+   */
+  uint64_t merge(Buckets& interval);
+
+  /**
+   * Add the counts in one set of buckets to another. This is written so that it can be vectorized.
+   * @param target supplies the buckets to add to.
+   * @param source supplies the buckets to add.
+   */
+  static void addBuckets(Buckets& target, const Buckets& source);
+
+  /**
+   * Insert the counts in a set of buckets into a circllhist histogram, so that statistics can be
+   * computed from them. Each bucket's values are inserted as the middle of the bucket.
+   * @param target supplies the histogram.
+   * @param buckets supplies the counts.
+   */
+  static void insertInto(histogram_t* target, const Buckets& buckets);
+
+  /**
+   * @param value supplies a value.
+   * @return uint32_t the index of the bucket counting the value.
+   */
+  static uint32_t bucketIndex(uint64_t value);
+
+  /**
+   * @param index supplies a bucket index.
+   * @return uint64_t the smallest value counted in the bucket.
+   */
+  static uint64_t bucketLowerBound(uint32_t index);
+
+  /**
+   * @param index supplies a bucket index.
+   * @return uint64_t the number of values counted in the bucket.
+   */
+  static uint64_t bucketWidth(uint32_t index);
+
+private:
+  // Aligned to a cache line, so that threads recording into neighbouring shards don't contend.
+  struct alignas(64) Shard {
+    std::atomic<uint64_t> buckets_[NumBuckets];
+  };
+
+  static uint32_t threadShard();
+  Shard& shardForThread();
+
+  std::atomic<Shard*> shards_[MaxShards];
+  // The totals as of the previous merge(), which are only touched by the merging thread.
+  Buckets merged_{};
+};
+
+} // namespace Stats
+} // namespace Envoy
@@ -8,6 +8,7 @@
 
 #include "common/common/assert.h"
 #include "common/stats/metric_impl.h"
+#include "common/stats/symbol_table_impl.h"
 
 #include "absl/strings/string_view.h"
 
@@ -50,6 +51,20 @@ public:
    * @param data the data returned by alloc().
    */
   virtual void free(StatData& data) PURE;
+
+  /**
+   * Acquires the symbolized name of a data block, encoded in symbolTable(). This is called once
+   * for each stat made from the block, and must be balanced by a call to releaseStatName().
+   * @param data the data returned by alloc().
+   * @return StatName the name, which remains valid until releaseStatName() is called.
+   */
+  virtual StatName acquireStatName(StatData& data) PURE;
+
+  /**
+   * Releases a name returned by acquireStatName().
+   * @param data the data returned by alloc().
+   */
+  virtual void releaseStatName(StatData& data) PURE;
 };
 
 /**
@@ -63,12 +78,16 @@ template <class StatData> class CounterImpl : public Counter, public MetricImpl
 public:
   CounterImpl(StatData& data, StatDataAllocatorImpl<StatData>& alloc,
               std::string&& tag_extracted_name, std::vector<Tag>&& tags)
-      : MetricImpl(std::move(tag_extracted_name), std::move(tags)), data_(data), alloc_(alloc) {}
-  ~CounterImpl() { alloc_.free(data_); }
+      : MetricImpl(std::move(tag_extracted_name), std::move(tags)), data_(data), alloc_(alloc),
+        stat_name_(alloc.acquireStatName(data)) {}
+  ~CounterImpl() {
+    alloc_.releaseStatName(data_);
+    alloc_.free(data_);
+  }
 
   // Stats::Metric
-  std::string name() const override { return std::string(data_.name()); }
-  const char* nameCStr() const override { return data_.name(); }
+  std::string name() const override { return stat_name_.toString(alloc_.symbolTable()); }
+  StatName statName() const override { return stat_name_; }
 
   // Stats::Counter
   void add(uint64_t amount) override {
@@ -86,6 +105,7 @@ public:
 private:
   StatData& data_;
   StatDataAllocatorImpl<StatData>& alloc_;
+  const StatName stat_name_;
 };
 
 /**
@@ -97,7 +117,7 @@ public:
   NullCounterImpl() {}
   ~NullCounterImpl() {}
   std::string name() const override { return ""; }
-  const char* nameCStr() const override { return ""; }
+  StatName statName() const override { return StatName(); }
   const std::string& tagExtractedName() const override { CONSTRUCT_ON_FIRST_USE(std::string, ""); }
   const std::vector<Tag>& tags() const override { CONSTRUCT_ON_FIRST_USE(std::vector<Tag>, {}); }
   void add(uint64_t) override {}
@@ -115,12 +135,16 @@ template <class StatData> class GaugeImpl : public Gauge, public MetricImpl {
 public:
   GaugeImpl(StatData& data, StatDataAllocatorImpl<StatData>& alloc,
             std::string&& tag_extracted_name, std::vector<Tag>&& tags)
-      : MetricImpl(std::move(tag_extracted_name), std::move(tags)), data_(data), alloc_(alloc) {}
-  ~GaugeImpl() { alloc_.free(data_); }
+      : MetricImpl(std::move(tag_extracted_name), std::move(tags)), data_(data), alloc_(alloc),
+        stat_name_(alloc.acquireStatName(data)) {}
+  ~GaugeImpl() {
+    alloc_.releaseStatName(data_);
+    alloc_.free(data_);
+  }
 
   // Stats::Metric
-  std::string name() const override { return std::string(data_.name()); }
-  const char* nameCStr() const override { return data_.name(); }
+  std::string name() const override { return stat_name_.toString(alloc_.symbolTable()); }
+  StatName statName() const override { return stat_name_; }
 
   // Stats::Gauge
   virtual void add(uint64_t amount) override {
@@ -144,6 +168,7 @@ public:
 private:
   StatData& data_;
   StatDataAllocatorImpl<StatData>& alloc_;
+  const StatName stat_name_;
 };
 
 /**
@@ -155,7 +180,7 @@ public:
   NullGaugeImpl() {}
   ~NullGaugeImpl() {}
   std::string name() const override { return ""; }
-  const char* nameCStr() const override { return ""; }
+  StatName statName() const override { return StatName(); }
   const std::string& tagExtractedName() const override { CONSTRUCT_ON_FIRST_USE(std::string, ""); }
   const std::vector<Tag>& tags() const override { CONSTRUCT_ON_FIRST_USE(std::vector<Tag>, {}); }
   void add(uint64_t) override {}
@@ -235,6 +235,8 @@ void StatNameStorage::free(SymbolTable& table) {
   bytes_.reset();
 }
 
+const uint8_t StatName::EmptyStorage[] = {0, 0};
+
 StatNameJoiner::StatNameJoiner(StatName a, StatName b) {
   const uint64_t a_size = a.numBytes();
   const uint64_t b_size = b.numBytes();
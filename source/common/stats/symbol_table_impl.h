@@ -283,7 +283,8 @@ private:
 class StatName {
 public:
   explicit StatName(const SymbolStorage symbol_array) : symbol_array_(symbol_array) {}
-  StatName() : symbol_array_(nullptr) {}
+  // Constructs an empty name, which references static storage and holds no symbols.
+  StatName() : symbol_array_(EmptyStorage) {}
 
   std::string toString(const SymbolTable& table) const { return table.decode(data(), numBytes()); }
 
@@ -326,6 +327,9 @@ protected:
   const uint8_t* data() const { return symbol_array_ + 2; }
 
   const uint8_t* symbol_array_;
+
+private:
+  static const uint8_t EmptyStorage[];
 };
 
 StatName StatNameStorage::statName() const { return StatName(bytes_.get()); }
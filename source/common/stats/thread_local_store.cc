@@ -21,12 +21,34 @@
 namespace Envoy {
 namespace Stats {
 
+namespace {
+
+std::string histogramSummary(bool used, const HistogramStatistics& interval_statistics,
+                             const HistogramStatistics& cumulative_statistics) {
+  if (used) {
+    std::vector<std::string> summary;
+    const std::vector<double>& supported_quantiles_ref = interval_statistics.supportedQuantiles();
+    summary.reserve(supported_quantiles_ref.size());
+    for (size_t i = 0; i < supported_quantiles_ref.size(); ++i) {
+      summary.push_back(fmt::format("P{}({},{})", 100 * supported_quantiles_ref[i],
+                                    interval_statistics.computedQuantiles()[i],
+                                    cumulative_statistics.computedQuantiles()[i]));
+    }
+    return absl::StrJoin(summary, " ");
+  } else {
+    return std::string("No recorded values");
+  }
+}
+
+} // namespace
+
 ThreadLocalStoreImpl::ThreadLocalStoreImpl(const StatsOptions& stats_options,
                                            StatDataAllocator& alloc)
     : stats_options_(stats_options), alloc_(alloc), default_scope_(createScope("")),
       tag_producer_(std::make_unique<TagProducerImpl>()),
       stats_matcher_(std::make_unique<StatsMatcherImpl>()),
-      num_last_resort_stats_(default_scope_->counter("stats.overflow")), source_(*this) {}
+      num_last_resort_stats_(default_scope_->counter("stats.overflow")),
+      heap_allocator_(alloc.symbolTable()), source_(*this) {}
 
 ThreadLocalStoreImpl::~ThreadLocalStoreImpl() {
   ASSERT(shutting_down_);
@@ -37,7 +59,7 @@ ThreadLocalStoreImpl::~ThreadLocalStoreImpl() {
 std::vector<CounterSharedPtr> ThreadLocalStoreImpl::counters() const {
   // Handle de-dup due to overlapping scopes.
   std::vector<CounterSharedPtr> ret;
-  CharStarHashSet names;
+  StatNameSet names;
   Thread::LockGuard lock(lock_);
   for (ScopeImpl* scope : scopes_) {
     for (auto& counter : scope->central_cache_.counters_) {
@@ -60,7 +82,7 @@ ScopePtr ThreadLocalStoreImpl::createScope(const std::string& name) {
 std::vector<GaugeSharedPtr> ThreadLocalStoreImpl::gauges() const {
   // Handle de-dup due to overlapping scopes.
   std::vector<GaugeSharedPtr> ret;
-  CharStarHashSet names;
+  StatNameSet names;
   Thread::LockGuard lock(lock_);
   for (ScopeImpl* scope : scopes_) {
     for (auto& gauge : scope->central_cache_.gauges_) {
@@ -190,21 +212,14 @@ ThreadLocalStoreImpl::ScopeImpl::~ScopeImpl() { parent_.releaseScopeCrossThread(
 
 template <class StatType>
 StatType& ThreadLocalStoreImpl::ScopeImpl::safeMakeStat(
-    const std::string& name, StatMap<std::shared_ptr<StatType>>& central_cache_map,
-    MakeStatFn<StatType> make_stat, StatMap<std::shared_ptr<StatType>>* tls_cache) {
-
-  // If we have a valid cache entry, return it.
-  if (tls_cache) {
-    auto pos = tls_cache->find(name.c_str());
-    if (pos != tls_cache->end()) {
-      return *pos->second;
-    }
-  }
+    const std::string& name, StatName stat_name,
+    StatMap<std::shared_ptr<StatType>>& central_cache_map, MakeStatFn<StatType> make_stat,
+    TlsStatMap<std::shared_ptr<StatType>>* tls_cache) {
 
   // We must now look in the central store so we must be locked. We grab a reference to the
   // central store location. It might contain nothing. In this case, we allocate a new stat.
   Thread::LockGuard lock(parent_.lock_);
-  auto p = central_cache_map.find(name.c_str());
+  auto p = central_cache_map.find(stat_name);
   std::shared_ptr<StatType>* central_ref = nullptr;
   if (p != central_cache_map.end()) {
     central_ref = &(p->second);
@@ -227,29 +242,45 @@ StatType& ThreadLocalStoreImpl::ScopeImpl::safeMakeStat(
                        std::move(tags));              // NOLINT(bugprone-use-after-move)
       ASSERT(stat != nullptr);
     }
-    central_ref = &central_cache_map[stat->nameCStr()];
-    *central_ref = stat;
+    // The key references the stat's own storage. If the name was truncated, an entry for the
+    // truncated name may already exist, in which case it is kept and the new stat is dropped.
+    central_ref = &central_cache_map.insert(std::make_pair(stat->statName(), stat)).first->second;
   }
 
   // If we have a TLS cache, insert the stat.
   if (tls_cache) {
-    tls_cache->insert(std::make_pair((*central_ref)->nameCStr(), *central_ref));
+    insertTlsStat(name, *central_ref, *tls_cache);
   }
 
   // Finally we return the reference.
   return **central_ref;
 }
 
+template <class StatType>
+void ThreadLocalStoreImpl::ScopeImpl::insertTlsStat(
+    const std::string& name, const std::shared_ptr<StatType>& stat,
+    TlsStatMap<std::shared_ptr<StatType>>& tls_cache) {
+  auto p = central_cache_.names_.find(stat->statName());
+  if (p == central_cache_.names_.end()) {
+    p = central_cache_.names_.emplace(stat->statName(), std::make_shared<const std::string>(name))
+            .first;
+  }
+  // A truncated stat may be reached through several names. Only the first one is cached, and the
+  // others always go through the central cache.
+  if (*p->second == name) {
+    tls_cache.emplace(*p->second, TlsStatEntry<std::shared_ptr<StatType>>{p->second, stat});
+  }
+}
+
 Counter& ThreadLocalStoreImpl::ScopeImpl::counter(const std::string& name) {
   // Determine the final name based on the prefix and the passed name.
   //
-  // Note that we can do map.find(final_name.c_str()), but we cannot do
-  // map[final_name.c_str()] as the char*-keyed maps would then save the pointer
-  // to a temporary, and address sanitization errors would follow. Instead we
-  // must do a find() first, using the value if it succeeds. If it fails, then
-  // after we construct the stat we can insert it into the required maps. This
-  // strategy costs an extra hash lookup for each miss, but saves time
-  // re-copying the string and significant memory overhead.
+  // The TLS cache is keyed by the final name, so a hit neither encodes the name nor takes any lock.
+  // Only on a miss is the name encoded into temporary storage for the central cache, which is
+  // keyed by StatName. We cannot insert that temporary into the central map, as it is freed before
+  // returning. Instead we must do a find() first, using the value if it succeeds. If it fails, then
+  // after we construct the stat we insert it keyed by the name the stat owns. This strategy costs
+  // an extra hash lookup for each miss, but saves re-copying the name into the central map.
   std::string final_name = prefix_ + name;
 
   // TODO(ambuc): If stats_matcher_ depends on regexes, this operation (on the hot path) could
@@ -260,18 +291,25 @@ Counter& ThreadLocalStoreImpl::ScopeImpl::counter(const std::string& name) {
 
   // We now find the TLS cache. This might remain null if we don't have TLS
   // initialized currently.
-  StatMap<CounterSharedPtr>* tls_cache = nullptr;
+  TlsStatMap<CounterSharedPtr>* tls_cache = nullptr;
   if (!parent_.shutting_down_ && parent_.tls_) {
     tls_cache = &parent_.tls_->getTyped<TlsCache>().scope_cache_[this->scope_id_].counters_;
+    auto pos = tls_cache->find(final_name);
+    if (pos != tls_cache->end()) {
+      return *pos->second.stat_;
+    }
   }
 
-  return safeMakeStat<Counter>(
-      final_name, central_cache_.counters_,
+  StatNameStorage final_stat_name(final_name, parent_.symbolTable());
+  Counter& counter = safeMakeStat<Counter>(
+      final_name, final_stat_name.statName(), central_cache_.counters_,
       [](StatDataAllocator& allocator, absl::string_view name, std::string&& tag_extracted_name,
          std::vector<Tag>&& tags) -> CounterSharedPtr {
         return allocator.makeCounter(name, std::move(tag_extracted_name), std::move(tags));
       },
       tls_cache);
+  final_stat_name.free(parent_.symbolTable());
+  return counter;
 }
 
 void ThreadLocalStoreImpl::ScopeImpl::deliverHistogramToSinks(const Histogram& histogram,
@@ -293,12 +331,6 @@ void ThreadLocalStoreImpl::ScopeImpl::deliverHistogramToSinks(const Histogram& h
 Gauge& ThreadLocalStoreImpl::ScopeImpl::gauge(const std::string& name) {
   // See comments in counter(). There is no super clean way (via templates or otherwise) to
   // share this code so I'm leaving it largely duplicated for now.
-  //
-  // Note that we can do map.find(final_name.c_str()), but we cannot do
-  // map[final_name.c_str()] as the char*-keyed maps would then save the pointer to
-  // a temporary, and address sanitization errors would follow. Instead we must
-  // do a find() first, using tha if it succeeds. If it fails, then after we
-  // construct the stat we can insert it into the required maps.
   std::string final_name = prefix_ + name;
 
   // See warning/comments in counter().
@@ -306,29 +338,30 @@ Gauge& ThreadLocalStoreImpl::ScopeImpl::gauge(const std::string& name) {
     return null_gauge_;
   }
 
-  StatMap<GaugeSharedPtr>* tls_cache = nullptr;
+  TlsStatMap<GaugeSharedPtr>* tls_cache = nullptr;
   if (!parent_.shutting_down_ && parent_.tls_) {
     tls_cache = &parent_.tls_->getTyped<TlsCache>().scope_cache_[this->scope_id_].gauges_;
+    auto pos = tls_cache->find(final_name);
+    if (pos != tls_cache->end()) {
+      return *pos->second.stat_;
+    }
   }
 
-  return safeMakeStat<Gauge>(
-      final_name, central_cache_.gauges_,
+  StatNameStorage final_stat_name(final_name, parent_.symbolTable());
+  Gauge& gauge = safeMakeStat<Gauge>(
+      final_name, final_stat_name.statName(), central_cache_.gauges_,
       [](StatDataAllocator& allocator, absl::string_view name, std::string&& tag_extracted_name,
          std::vector<Tag>&& tags) -> GaugeSharedPtr {
         return allocator.makeGauge(name, std::move(tag_extracted_name), std::move(tags));
       },
       tls_cache);
+  final_stat_name.free(parent_.symbolTable());
+  return gauge;
 }
 
 Histogram& ThreadLocalStoreImpl::ScopeImpl::histogram(const std::string& name) {
   // See comments in counter(). There is no super clean way (via templates or otherwise) to
   // share this code so I'm leaving it largely duplicated for now.
-  //
-  // Note that we can do map.find(final_name.c_str()), but we cannot do
-  // map[final_name.c_str()] as the char*-keyed maps would then save the pointer to
-  // a temporary, and address sanitization errors would follow. Instead we must
-  // do a find() first, using tha if it succeeds. If it fails, then after we
-  // construct the stat we can insert it into the required maps.
   std::string final_name = prefix_ + name;
 
   // See warning/comments in counter().
@@ -336,71 +369,83 @@ Histogram& ThreadLocalStoreImpl::ScopeImpl::histogram(const std::string& name) {
     return null_histogram_;
   }
 
-  StatMap<ParentHistogramSharedPtr>* tls_cache = nullptr;
+  TlsStatMap<ParentHistogramSharedPtr>* tls_cache = nullptr;
   if (!parent_.shutting_down_ && parent_.tls_) {
     tls_cache =
         &parent_.tls_->getTyped<TlsCache>().scope_cache_[this->scope_id_].parent_histograms_;
-    auto p = tls_cache->find(final_name.c_str());
+    auto p = tls_cache->find(final_name);
     if (p != tls_cache->end()) {
-      return *p->second;
+      return *p->second.stat_;
     }
   }
 
+  StatNameStorage final_stat_name(final_name, parent_.symbolTable());
+  Histogram& histogram = findOrMakeHistogram(final_name, final_stat_name.statName(), tls_cache);
+  final_stat_name.free(parent_.symbolTable());
+  return histogram;
+}
+
+Histogram& ThreadLocalStoreImpl::ScopeImpl::findOrMakeHistogram(
+    const std::string& name, StatName stat_name, TlsStatMap<ParentHistogramSharedPtr>* tls_cache) {
   Thread::LockGuard lock(parent_.lock_);
-  auto p = central_cache_.histograms_.find(final_name.c_str());
-  ParentHistogramImplSharedPtr* central_ref = nullptr;
+  auto p = central_cache_.histograms_.find(stat_name);
+  ParentHistogramSharedPtr* central_ref = nullptr;
   if (p != central_cache_.histograms_.end()) {
     central_ref = &p->second;
   } else {
     std::vector<Tag> tags;
-    std::string tag_extracted_name = parent_.getTagsForName(final_name, tags);
-    auto stat = std::make_shared<ParentHistogramImpl>(
-        final_name, parent_, *this, std::move(tag_extracted_name), std::move(tags));
-    central_ref = &central_cache_.histograms_[stat->nameCStr()];
+    std::string tag_extracted_name = parent_.getTagsForName(name, tags);
+    ParentHistogramSharedPtr stat;
+    if (parent_.sharded_histograms_) {
+      stat = std::make_shared<ShardedParentHistogramImpl>(name, parent_, parent_.symbolTable(),
+                                                          std::move(tag_extracted_name),
+                                                          std::move(tags));
+    } else {
+      stat = std::make_shared<ParentHistogramImpl>(name, parent_, *this, parent_.symbolTable(),
+                                                   std::move(tag_extracted_name),
+                                                   std::move(tags));
+    }
+    central_ref = &central_cache_.histograms_[stat->statName()];
     *central_ref = stat;
   }
 
   if (tls_cache != nullptr) {
-    tls_cache->insert(std::make_pair((*central_ref)->nameCStr(), *central_ref));
+    insertTlsStat(name, *central_ref, *tls_cache);
   }
   return **central_ref;
 }
 
-Histogram& ThreadLocalStoreImpl::ScopeImpl::tlsHistogram(const std::string& name,
+Histogram& ThreadLocalStoreImpl::ScopeImpl::tlsHistogram(StatName name,
                                                          ParentHistogramImpl& parent) {
-  if (parent_.stats_matcher_->rejects(name)) {
-    return null_histogram_;
-  }
-
+  // The parent was only created if the stats matcher accepted the name, so it is not checked again.
   // See comments in counter() which explains the logic here.
 
   StatMap<TlsHistogramSharedPtr>* tls_cache = nullptr;
   if (!parent_.shutting_down_ && parent_.tls_) {
     tls_cache = &parent_.tls_->getTyped<TlsCache>().scope_cache_[this->scope_id_].histograms_;
-    auto p = tls_cache->find(name.c_str());
+    auto p = tls_cache->find(name);
     if (p != tls_cache->end()) {
       return *p->second;
     }
   }
 
-  std::vector<Tag> tags;
-  std::string tag_extracted_name = parent_.getTagsForName(name, tags);
   TlsHistogramSharedPtr hist_tls_ptr = std::make_shared<ThreadLocalHistogramImpl>(
-      name, std::move(tag_extracted_name), std::move(tags));
+      name, parent_.symbolTable(), std::string(parent.tagExtractedName()),
+      std::vector<Tag>(parent.tags()));
 
   parent.addTlsHistogram(hist_tls_ptr);
 
   if (tls_cache) {
-    tls_cache->insert(std::make_pair(hist_tls_ptr->nameCStr(), hist_tls_ptr));
+    tls_cache->insert(std::make_pair(hist_tls_ptr->statName(), hist_tls_ptr));
   }
   return *hist_tls_ptr;
 }
 
-ThreadLocalHistogramImpl::ThreadLocalHistogramImpl(const std::string& name,
+ThreadLocalHistogramImpl::ThreadLocalHistogramImpl(StatName name, SymbolTable& symbol_table,
                                                    std::string&& tag_extracted_name,
                                                    std::vector<Tag>&& tags)
     : MetricImpl(std::move(tag_extracted_name), std::move(tags)), current_active_(0), flags_(0),
-      created_thread_id_(std::this_thread::get_id()), name_(name) {
+      created_thread_id_(std::this_thread::get_id()), name_(name), symbol_table_(symbol_table) {
   histograms_[0] = hist_alloc();
   histograms_[1] = hist_alloc();
 }
@@ -423,20 +468,21 @@ void ThreadLocalHistogramImpl::merge(histogram_t* target) {
 }
 
 ParentHistogramImpl::ParentHistogramImpl(const std::string& name, Store& parent,
-                                         TlsScope& tls_scope, std::string&& tag_extracted_name,
-                                         std::vector<Tag>&& tags)
+                                         TlsScope& tls_scope, SymbolTable& symbol_table,
+                                         std::string&& tag_extracted_name, std::vector<Tag>&& tags)
     : MetricImpl(std::move(tag_extracted_name), std::move(tags)), parent_(parent),
       tls_scope_(tls_scope), interval_histogram_(hist_alloc()), cumulative_histogram_(hist_alloc()),
       interval_statistics_(interval_histogram_), cumulative_statistics_(cumulative_histogram_),
-      merged_(false), name_(name) {}
+      merged_(false), symbol_table_(symbol_table), name_(name, symbol_table) {}
 
 ParentHistogramImpl::~ParentHistogramImpl() {
   hist_free(interval_histogram_);
   hist_free(cumulative_histogram_);
+  name_.free(symbol_table_);
 }
 
 void ParentHistogramImpl::recordValue(uint64_t value) {
-  Histogram& tls_histogram = tls_scope_.tlsHistogram(name(), *this);
+  Histogram& tls_histogram = tls_scope_.tlsHistogram(statName(), *this);
   tls_histogram.recordValue(value);
   parent_.deliverHistogramToSinks(*this, value);
 }
@@ -467,19 +513,7 @@ void ParentHistogramImpl::merge() {
 }
 
 const std::string ParentHistogramImpl::summary() const {
-  if (used()) {
-    std::vector<std::string> summary;
-    const std::vector<double>& supported_quantiles_ref = interval_statistics_.supportedQuantiles();
-    summary.reserve(supported_quantiles_ref.size());
-    for (size_t i = 0; i < supported_quantiles_ref.size(); ++i) {
-      summary.push_back(fmt::format("P{}({},{})", 100 * supported_quantiles_ref[i],
-                                    interval_statistics_.computedQuantiles()[i],
-                                    cumulative_statistics_.computedQuantiles()[i]));
-    }
-    return absl::StrJoin(summary, " ");
-  } else {
-    return std::string("No recorded values");
-  }
+  return histogramSummary(used(), interval_statistics_, cumulative_statistics_);
 }
 
 void ParentHistogramImpl::addTlsHistogram(const TlsHistogramSharedPtr& hist_ptr) {
@@ -496,5 +530,44 @@ bool ParentHistogramImpl::usedLockHeld() const {
   return false;
 }
 
+ShardedParentHistogramImpl::ShardedParentHistogramImpl(const std::string& name, Store& parent,
+                                                       SymbolTable& symbol_table,
+                                                       std::string&& tag_extracted_name,
+                                                       std::vector<Tag>&& tags)
+    : MetricImpl(std::move(tag_extracted_name), std::move(tags)), parent_(parent),
+      interval_histogram_(hist_alloc()), cumulative_histogram_(hist_alloc()),
+      interval_statistics_(interval_histogram_), cumulative_statistics_(cumulative_histogram_),
+      merged_(false), symbol_table_(symbol_table), name_(name, symbol_table) {}
+
+ShardedParentHistogramImpl::~ShardedParentHistogramImpl() {
+  hist_free(interval_histogram_);
+  hist_free(cumulative_histogram_);
+  name_.free(symbol_table_);
+}
+
+void ShardedParentHistogramImpl::recordValue(uint64_t value) {
+  histogram_.recordValue(value);
+  parent_.deliverHistogramToSinks(*this, value);
+}
+
+void ShardedParentHistogramImpl::merge() {
+  ShardedHistogram::Buckets interval;
+  const uint64_t count = histogram_.merge(interval);
+  // As with ParentHistogramImpl, the histogram is only considered used once a merge has seen a
+  // recorded value.
+  if (merged_ || count > 0) {
+    hist_clear(interval_histogram_);
+    ShardedHistogram::insertInto(interval_histogram_, interval);
+    hist_accumulate(cumulative_histogram_, &interval_histogram_, 1);
+    cumulative_statistics_.refresh(cumulative_histogram_);
+    interval_statistics_.refresh(interval_histogram_);
+    merged_ = true;
+  }
+}
+
+const std::string ShardedParentHistogramImpl::summary() const {
+  return histogramSummary(used(), interval_statistics_, cumulative_statistics_);
+}
+
 } // namespace Stats
 } // namespace Envoy
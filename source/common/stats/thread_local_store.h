@@ -4,14 +4,16 @@
 #include <chrono>
 #include <cstdint>
 #include <list>
+#include <memory>
 #include <string>
 
 #include "envoy/thread_local/thread_local.h"
 
-#include "common/common/hash.h"
 #include "common/stats/heap_stat_data.h"
 #include "common/stats/histogram_impl.h"
+#include "common/stats/sharded_histogram.h"
 #include "common/stats/source_impl.h"
+#include "common/stats/symbol_table_impl.h"
 #include "common/stats/utility.h"
 
 #include "absl/container/flat_hash_map.h"
@@ -24,12 +26,13 @@ namespace Stats {
 /**
  * A histogram that is stored in TLS and used to record values per thread. This holds two
  * histograms, one to collect the values and other as backup that is used for merge process. The
- * swap happens during the merge process.
+ * swap happens during the merge process. The name references the storage of the parent histogram,
+ * so that it is not copied for every thread.
  */
 class ThreadLocalHistogramImpl : public Histogram, public MetricImpl {
 public:
-  ThreadLocalHistogramImpl(const std::string& name, std::string&& tag_extracted_name,
-                           std::vector<Tag>&& tags);
+  ThreadLocalHistogramImpl(StatName name, SymbolTable& symbol_table,
+                           std::string&& tag_extracted_name, std::vector<Tag>&& tags);
   ~ThreadLocalHistogramImpl();
 
   void merge(histogram_t* target);
@@ -49,8 +52,8 @@ public:
   bool used() const override { return flags_ & Flags::Used; }
 
   // Stats::Metric
-  std::string name() const override { return name_; }
-  const char* nameCStr() const override { return name_.c_str(); }
+  std::string name() const override { return name_.toString(symbol_table_); }
+  StatName statName() const override { return name_; }
 
 private:
   uint64_t otherHistogramIndex() const { return 1 - current_active_; }
@@ -58,7 +61,8 @@ private:
   histogram_t* histograms_[2];
   std::atomic<uint16_t> flags_;
   std::thread::id created_thread_id_;
-  const std::string name_;
+  const StatName name_;
+  SymbolTable& symbol_table_;
 };
 
 typedef std::shared_ptr<ThreadLocalHistogramImpl> TlsHistogramSharedPtr;
@@ -71,7 +75,8 @@ class TlsScope;
 class ParentHistogramImpl : public ParentHistogram, public MetricImpl {
 public:
   ParentHistogramImpl(const std::string& name, Store& parent, TlsScope& tlsScope,
-                      std::string&& tag_extracted_name, std::vector<Tag>&& tags);
+                      SymbolTable& symbol_table, std::string&& tag_extracted_name,
+                      std::vector<Tag>&& tags);
   ~ParentHistogramImpl();
 
   void addTlsHistogram(const TlsHistogramSharedPtr& hist_ptr);
@@ -93,8 +98,8 @@ public:
   const std::string summary() const override;
 
   // Stats::Metric
-  std::string name() const override { return name_; }
-  const char* nameCStr() const override { return name_.c_str(); }
+  std::string name() const override { return name_.statName().toString(symbol_table_); }
+  StatName statName() const override { return name_.statName(); }
 
 private:
   bool usedLockHeld() const EXCLUSIVE_LOCKS_REQUIRED(merge_lock_);
@@ -108,10 +113,48 @@ private:
   mutable Thread::MutexBasicLockable merge_lock_;
   std::list<TlsHistogramSharedPtr> tls_histograms_ GUARDED_BY(merge_lock_);
   bool merged_;
-  const std::string name_;
+  SymbolTable& symbol_table_;
+  StatNameStorage name_;
 };
 
-typedef std::shared_ptr<ParentHistogramImpl> ParentHistogramImplSharedPtr;
+/**
+ * Log Linear Histogram implementation which records into a ShardedHistogram, so that recording
+ * neither takes a lock nor looks up a thread local histogram. At merge time, the shards are summed
+ * and the interval's counts are inserted into circllhist histograms to compute statistics.
+ */
+class ShardedParentHistogramImpl : public ParentHistogram, public MetricImpl {
+public:
+  ShardedParentHistogramImpl(const std::string& name, Store& parent, SymbolTable& symbol_table,
+                             std::string&& tag_extracted_name, std::vector<Tag>&& tags);
+  ~ShardedParentHistogramImpl();
+
+  // Stats::Histogram
+  void recordValue(uint64_t value) override;
+  bool used() const override { return merged_; }
+
+  // Stats::ParentHistogram
+  void merge() override;
+  const HistogramStatistics& intervalStatistics() const override { return interval_statistics_; }
+  const HistogramStatistics& cumulativeStatistics() const override {
+    return cumulative_statistics_;
+  }
+  const std::string summary() const override;
+
+  // Stats::Metric
+  std::string name() const override { return name_.statName().toString(symbol_table_); }
+  StatName statName() const override { return name_.statName(); }
+
+private:
+  Store& parent_;
+  ShardedHistogram histogram_;
+  histogram_t* interval_histogram_;
+  histogram_t* cumulative_histogram_;
+  HistogramStatisticsImpl interval_statistics_;
+  HistogramStatisticsImpl cumulative_statistics_;
+  std::atomic<bool> merged_;
+  SymbolTable& symbol_table_;
+  StatNameStorage name_;
+};
 
 /**
  * Class used to create ThreadLocalHistogram in the scope.
@@ -124,8 +167,9 @@ public:
   /**
    * @return a ThreadLocalHistogram within the scope's namespace.
    * @param name name of the histogram with scope prefix attached.
+   * @param parent the parent histogram, which owns the storage for name.
    */
-  virtual Histogram& tlsHistogram(const std::string& name, ParentHistogramImpl& parent) PURE;
+  virtual Histogram& tlsHistogram(StatName name, ParentHistogramImpl& parent) PURE;
 };
 
 /**
@@ -161,6 +205,7 @@ public:
   void setStatsMatcher(StatsMatcherPtr&& stats_matcher) override {
     stats_matcher_ = std::move(stats_matcher);
   }
+  void setShardedHistograms(bool sharded) override { sharded_histograms_ = sharded; }
   void initializeThreading(Event::Dispatcher& main_thread_dispatcher,
                            ThreadLocal::Instance& tls) override;
   void shutdownThreading() override;
@@ -172,19 +217,36 @@ public:
   const Stats::StatsOptions& statsOptions() const override { return stats_options_; }
 
 private:
-  template <class Stat> using StatMap = CharStarHashMap<Stat>;
+  // Stats are keyed by their symbolized names. The storage for a key is owned by the stat it maps
+  // to, so the name is not copied into each map.
+  template <class Stat>
+  using StatMap = absl::flat_hash_map<StatName, Stat, StatNameHash, StatNameCompare>;
+  using StatNameSet = absl::flat_hash_set<StatName, StatNameHash, StatNameCompare>;
+  using SharedStatName = std::shared_ptr<const std::string>;
+  // The thread local caches of stats looked up by name are keyed by the name itself, so that a hit
+  // neither encodes the name nor takes the symbol table lock. The key views a name which is stored
+  // once per stat in the central cache and shared by every thread's entry, which holds a reference
+  // to it so that the key stays valid until the entry is removed.
+  template <class Stat> struct TlsStatEntry {
+    SharedStatName name_;
+    Stat stat_;
+  };
+  template <class Stat>
+  using TlsStatMap = absl::flat_hash_map<absl::string_view, TlsStatEntry<Stat>>;
 
   struct TlsCacheEntry {
-    StatMap<CounterSharedPtr> counters_;
-    StatMap<GaugeSharedPtr> gauges_;
+    TlsStatMap<CounterSharedPtr> counters_;
+    TlsStatMap<GaugeSharedPtr> gauges_;
     StatMap<TlsHistogramSharedPtr> histograms_;
-    StatMap<ParentHistogramSharedPtr> parent_histograms_;
+    TlsStatMap<ParentHistogramSharedPtr> parent_histograms_;
   };
 
   struct CentralCacheEntry {
     StatMap<CounterSharedPtr> counters_;
     StatMap<GaugeSharedPtr> gauges_;
-    StatMap<ParentHistogramImplSharedPtr> histograms_;
+    StatMap<ParentHistogramSharedPtr> histograms_;
+    // The full names of the stats above which are in thread local caches.
+    StatMap<SharedStatName> names_;
   };
 
   struct ScopeImpl : public TlsScope {
@@ -201,9 +263,12 @@ private:
     void deliverHistogramToSinks(const Histogram& histogram, uint64_t value) override;
     Gauge& gauge(const std::string& name) override;
     Histogram& histogram(const std::string& name) override;
-    Histogram& tlsHistogram(const std::string& name, ParentHistogramImpl& parent) override;
+    Histogram& tlsHistogram(StatName name, ParentHistogramImpl& parent) override;
     const Stats::StatsOptions& statsOptions() const override { return parent_.statsOptions(); }
 
+    Histogram& findOrMakeHistogram(const std::string& name, StatName stat_name,
+                                   TlsStatMap<ParentHistogramSharedPtr>* tls_cache);
+
     template <class StatType>
     using MakeStatFn =
         std::function<std::shared_ptr<StatType>(StatDataAllocator&, absl::string_view name,
@@ -216,15 +281,28 @@ private:
      * result, creating it with the heap allocator.
      *
      * @param name the full name of the stat (not tag extracted).
+     * @param stat_name the full name of the stat, encoded in the store's symbol table.
      * @param central_cache_map a map from name to the desired object in the central cache.
      * @param make_stat a function to generate the stat object, called if it's not in cache.
-     * @param tls_ref possibly null reference to a cache entry for this stat, which will be
-     *     used if non-empty, or filled in if empty (and non-null).
+     * @param tls_cache possibly null thread local cache, which the caller already looked the name
+     *     up in. If non-null, the stat is inserted into it.
      */
     template <class StatType>
     StatType&
-    safeMakeStat(const std::string& name, StatMap<std::shared_ptr<StatType>>& central_cache_map,
-                 MakeStatFn<StatType> make_stat, StatMap<std::shared_ptr<StatType>>* tls_cache);
+    safeMakeStat(const std::string& name, StatName stat_name,
+                 StatMap<std::shared_ptr<StatType>>& central_cache_map,
+                 MakeStatFn<StatType> make_stat, TlsStatMap<std::shared_ptr<StatType>>* tls_cache);
+
+    /**
+     * Inserts a stat into a thread local cache. Must be called with the parent's lock held.
+     *
+     * @param name the full name of the stat (not tag extracted).
+     * @param stat the stat, as held by the central cache.
+     * @param tls_cache the thread local cache to insert the stat into.
+     */
+    template <class StatType>
+    void insertTlsStat(const std::string& name, const std::shared_ptr<StatType>& stat,
+                       TlsStatMap<std::shared_ptr<StatType>>& tls_cache);
 
     static std::atomic<uint64_t> next_scope_id_;
 
@@ -254,6 +332,7 @@ private:
   void releaseScopeCrossThread(ScopeImpl* scope);
   void mergeInternal(PostMergeCb mergeCb);
   absl::string_view truncateStatNameIfNeeded(absl::string_view name);
+  SymbolTable& symbolTable() { return alloc_.symbolTable(); }
 
   const Stats::StatsOptions& stats_options_;
   StatDataAllocator& alloc_;
@@ -267,6 +346,7 @@ private:
   StatsMatcherPtr stats_matcher_;
   std::atomic<bool> shutting_down_{};
   std::atomic<bool> merge_in_progress_{};
+  bool sharded_histograms_{};
   Counter& num_last_resort_stats_;
   HeapStatDataAllocator heap_allocator_;
   SourceImpl source_;
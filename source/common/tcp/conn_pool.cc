@@ -1,5 +1,7 @@
 #include "common/tcp/conn_pool.h"
 
+#include <algorithm>
+#include <limits>
 #include <memory>
 
 #include "envoy/event/dispatcher.h"
@@ -48,6 +50,25 @@ void ConnPoolImpl::drainConnections() {
   }
 }
 
+void ConnPoolImpl::preconnect(uint32_t connections) {
+  while (drained_callbacks_.empty() &&
+         ready_conns_.size() + busy_conns_.size() + pending_conns_.size() < connections &&
+         host_->cluster().resourceManager(priority_).connections().canCreate()) {
+    ENVOY_LOG(debug, "preconnecting");
+    host_->cluster().stats().upstream_cx_preconnect_.inc();
+    createNewConnection();
+  }
+}
+
+void ConnPoolImpl::preconnectForDemand() {
+  // Busy connections each have a request assigned.
+  const uint64_t target =
+      preconnect_tracker_.targetConnections(busy_conns_.size() + pending_requests_.size(),
+                                            host_->cluster().perUpstreamPreconnectRatio());
+  preconnect(static_cast<uint32_t>(
+      std::min<uint64_t>(target, std::numeric_limits<uint32_t>::max())));
+}
+
 void ConnPoolImpl::addDrainedCallback(DrainedCb cb) {
   drained_callbacks_.push_back(cb);
   checkForDrained();
@@ -81,10 +102,12 @@ void ConnPoolImpl::createNewConnection() {
 }
 
 ConnectionPool::Cancellable* ConnPoolImpl::newConnection(ConnectionPool::Callbacks& callbacks) {
+  preconnect_tracker_.onNewRequest(busy_conns_.size() + pending_requests_.size() + 1);
   if (!ready_conns_.empty()) {
     ready_conns_.front()->moveBetweenLists(ready_conns_, busy_conns_);
     ENVOY_CONN_LOG(debug, "using existing connection", *busy_conns_.front()->conn_);
     assignConnection(*busy_conns_.front(), callbacks);
+    preconnectForDemand();
     return nullptr;
   }
 
@@ -104,7 +127,8 @@ ConnectionPool::Cancellable* ConnPoolImpl::newConnection(ConnectionPool::Callbac
     ENVOY_LOG(debug, "queueing request due to no available connections");
     PendingRequestPtr pending_request(new PendingRequest(*this, callbacks));
     pending_request->moveIntoList(std::move(pending_request), pending_requests_);
-    return pending_requests_.front().get();
+    preconnectForDemand();
+    return pending_requests_.front();
   } else {
     ENVOY_LOG(debug, "max pending requests overflow");
     callbacks.onPoolFailure(ConnectionPool::PoolFailureReason::Overflow, nullptr);
@@ -168,7 +192,7 @@ void ConnPoolImpl::onConnectionEvent(ActiveConn& conn, Network::ConnectionEvent
         reason = ConnectionPool::PoolFailureReason::LocalConnectionFailure;
       }
 
-      std::list<PendingRequestPtr> pending_requests_to_purge(std::move(pending_requests_));
+      IntrusiveList<PendingRequest> pending_requests_to_purge(std::move(pending_requests_));
       while (!pending_requests_to_purge.empty()) {
         PendingRequestPtr request =
             pending_requests_to_purge.front()->removeFromList(pending_requests_to_purge);
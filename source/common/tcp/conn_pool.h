@@ -11,9 +11,10 @@
 #include "envoy/tcp/conn_pool.h"
 #include "envoy/upstream/upstream.h"
 
-#include "common/common/linked_object.h"
+#include "common/common/intrusive_list.h"
 #include "common/common/logger.h"
 #include "common/network/filter_impl.h"
+#include "common/upstream/preconnect_tracker.h"
 
 namespace Envoy {
 namespace Tcp {
@@ -29,6 +30,7 @@ public:
   // ConnectionPool::Instance
   void addDrainedCallback(DrainedCb cb) override;
   void drainConnections() override;
+  void preconnect(uint32_t connections) override;
   ConnectionPool::Cancellable* newConnection(ConnectionPool::Callbacks& callbacks) override;
 
 protected:
@@ -87,7 +89,7 @@ protected:
     ActiveConn& parent_;
   };
 
-  struct ActiveConn : LinkedObject<ActiveConn>,
+  struct ActiveConn : IntrusiveListItem<ActiveConn>,
                       public Network::ConnectionCallbacks,
                       public Event::DeferredDeletable {
     ActiveConn(ConnPoolImpl& parent);
@@ -119,7 +121,7 @@ protected:
 
   typedef std::unique_ptr<ActiveConn> ActiveConnPtr;
 
-  struct PendingRequest : LinkedObject<PendingRequest>, public ConnectionPool::Cancellable {
+  struct PendingRequest : IntrusiveListItem<PendingRequest>, public ConnectionPool::Cancellable {
     PendingRequest(ConnPoolImpl& parent, ConnectionPool::Callbacks& callbacks);
     ~PendingRequest();
 
@@ -141,6 +143,7 @@ protected:
   virtual void onConnReleased(ActiveConn& conn);
   virtual void onConnDestroyed(ActiveConn& conn);
   void onUpstreamReady();
+  void preconnectForDemand();
   void processIdleConnection(ActiveConn& conn, bool new_connection, bool delay);
   void checkForDrained();
 
@@ -149,14 +152,15 @@ protected:
   Upstream::ResourcePriority priority_;
   const Network::ConnectionSocket::OptionsSharedPtr socket_options_;
 
-  std::list<ActiveConnPtr> pending_conns_; // conns awaiting connected event
-  std::list<ActiveConnPtr> ready_conns_;   // conns ready for assignment
-  std::list<ActiveConnPtr> busy_conns_;    // conns assigned
-  std::list<PendingRequestPtr> pending_requests_;
+  IntrusiveList<ActiveConn> pending_conns_; // conns awaiting connected event
+  IntrusiveList<ActiveConn> ready_conns_;   // conns ready for assignment
+  IntrusiveList<ActiveConn> busy_conns_;    // conns assigned
+  IntrusiveList<PendingRequest> pending_requests_;
   std::list<DrainedCb> drained_callbacks_;
   Stats::TimespanPtr conn_connect_ms_;
   Event::TimerPtr upstream_ready_timer_;
   bool upstream_ready_enabled_{false};
+  Upstream::PreconnectTracker preconnect_tracker_;
 };
 
 } // namespace Tcp
@@ -525,7 +525,8 @@ void Filter::onUpstreamEvent(Network::ConnectionEvent event) {
       // the UpstreamCallbacks, which has the same lifetime as the timer, and can dispatch
       // the call to either TcpProxy or to Drainer, depending on the current state.
       idle_timer_ = read_callbacks_->connection().dispatcher().createTimer(
-          [upstream_callbacks = upstream_callbacks_]() { upstream_callbacks->onIdleTimeout(); });
+          [upstream_callbacks = upstream_callbacks_]() { upstream_callbacks->onIdleTimeout(); },
+          Event::TimerResolution::Coarse);
       resetIdleTimer();
       read_callbacks_->connection().addBytesSentCallback([this](uint64_t) { resetIdleTimer(); });
       upstream_conn_data_->connection().addBytesSentCallback(
@@ -624,11 +624,12 @@ void ClusterManagerImpl::loadCluster(const envoy::api::v2::Cluster& cluster,
   if (cluster_reference.info()->lbType() == LoadBalancerType::RingHash) {
     cluster_entry_it->second->thread_aware_lb_ = std::make_unique<RingHashLoadBalancer>(
         cluster_reference.prioritySet(), cluster_reference.info()->stats(), runtime_, random_,
-        cluster_reference.info()->lbRingHashConfig(), cluster_reference.info()->lbConfig());
+        cluster_reference.info()->lbRingHashConfig(), cluster_reference.info()->lbConfig(),
+        &dispatcher_);
   } else if (cluster_reference.info()->lbType() == LoadBalancerType::Maglev) {
     cluster_entry_it->second->thread_aware_lb_ = std::make_unique<MaglevLoadBalancer>(
         cluster_reference.prioritySet(), cluster_reference.info()->stats(), runtime_, random_,
-        cluster_reference.info()->lbConfig());
+        cluster_reference.info()->lbConfig(), &dispatcher_);
   }
 
   updateGauges();
@@ -959,6 +960,14 @@ void ClusterManagerImpl::ThreadLocalClusterManagerImpl::updateClusterMembership(
     ENVOY_LOG(debug, "re-creating local LB for TLS cluster {}", name);
     cluster_entry->lb_ = cluster_entry->lb_factory_->create();
   }
+
+  // Start opening connections to new hosts. The load balancer can already pick them, so requests
+  // which arrive before these connections are ready still wait for a handshake.
+  if (cluster_entry->cluster_info_->warmConnections() > 0) {
+    for (const HostSharedPtr& host : hosts_added) {
+      cluster_entry->warmHost(host);
+    }
+  }
 }
 
 void ClusterManagerImpl::ThreadLocalClusterManagerImpl::onHostHealthFailure(
@@ -1117,14 +1126,38 @@ ClusterManagerImpl::ThreadLocalClusterManagerImpl::ClusterEntry::connPool(
     }
   }
 
+  Http::ConnectionPool::Instance& pool =
+      connPoolForHost(host, priority, protocol, hash_key,
+                      have_options ? context->downstreamConnection()->socketOptions() : nullptr);
+
+  // The first time this kind of pool is used, warm it on the other hosts of the cluster.
+  if (!have_options && cluster_info_->warmConnections() > 0 &&
+      warm_http_pools_.emplace(priority, protocol).second) {
+    for (const auto& host_set : priority_set_.hostSetsPerPriority()) {
+      for (const HostSharedPtr& other_host : host_set->hosts()) {
+        if (other_host != host) {
+          connPoolForHost(other_host, priority, protocol, hash_key, nullptr)
+              .preconnect(cluster_info_->warmConnections());
+        }
+      }
+    }
+  }
+
+  return &pool;
+}
+
+Http::ConnectionPool::Instance&
+ClusterManagerImpl::ThreadLocalClusterManagerImpl::ClusterEntry::connPoolForHost(
+    const HostConstSharedPtr& host, ResourcePriority priority, Http::Protocol protocol,
+    const std::vector<uint8_t>& hash_key,
+    const Network::ConnectionSocket::OptionsSharedPtr& options) {
   ConnPoolsContainer& container = parent_.host_http_conn_pool_map_[host];
   if (!container.pools_[hash_key]) {
     container.pools_[hash_key] = parent_.parent_.factory_.allocateConnPool(
-        parent_.thread_local_dispatcher_, host, priority, protocol,
-        have_options ? context->downstreamConnection()->socketOptions() : nullptr);
+        parent_.thread_local_dispatcher_, host, priority, protocol, options);
   }
 
-  return container.pools_[hash_key].get();
+  return *container.pools_[hash_key];
 }
 
 Tcp::ConnectionPool::Instance*
@@ -1155,14 +1188,51 @@ ClusterManagerImpl::ThreadLocalClusterManagerImpl::ClusterEntry::tcpConnPool(
     }
   }
 
+  Tcp::ConnectionPool::Instance& pool =
+      tcpConnPoolForHost(host, priority, hash_key,
+                         have_options ? context->downstreamConnection()->socketOptions() : nullptr);
+
+  // The first time this kind of pool is used, warm it on the other hosts of the cluster.
+  if (!have_options && cluster_info_->warmConnections() > 0 &&
+      warm_tcp_pools_.insert(priority).second) {
+    for (const auto& host_set : priority_set_.hostSetsPerPriority()) {
+      for (const HostSharedPtr& other_host : host_set->hosts()) {
+        if (other_host != host) {
+          tcpConnPoolForHost(other_host, priority, hash_key, nullptr)
+              .preconnect(cluster_info_->warmConnections());
+        }
+      }
+    }
+  }
+
+  return &pool;
+}
+
+Tcp::ConnectionPool::Instance&
+ClusterManagerImpl::ThreadLocalClusterManagerImpl::ClusterEntry::tcpConnPoolForHost(
+    const HostConstSharedPtr& host, ResourcePriority priority, const std::vector<uint8_t>& hash_key,
+    const Network::ConnectionSocket::OptionsSharedPtr& options) {
   TcpConnPoolsContainer& container = parent_.host_tcp_conn_pool_map_[host];
   if (!container.pools_[hash_key]) {
     container.pools_[hash_key] = parent_.parent_.factory_.allocateTcpConnPool(
-        parent_.thread_local_dispatcher_, host, priority,
-        have_options ? context->downstreamConnection()->socketOptions() : nullptr);
+        parent_.thread_local_dispatcher_, host, priority, options);
   }
 
-  return container.pools_[hash_key].get();
+  return *container.pools_[hash_key];
+}
+
+void ClusterManagerImpl::ThreadLocalClusterManagerImpl::ClusterEntry::warmHost(
+    const HostConstSharedPtr& host) {
+  for (const auto& pool : warm_http_pools_) {
+    const std::vector<uint8_t> hash_key = {uint8_t(pool.second), uint8_t(pool.first)};
+    connPoolForHost(host, pool.first, pool.second, hash_key, nullptr)
+        .preconnect(cluster_info_->warmConnections());
+  }
+  for (const ResourcePriority priority : warm_tcp_pools_) {
+    const std::vector<uint8_t> hash_key = {uint8_t(priority)};
+    tcpConnPoolForHost(host, priority, hash_key, nullptr)
+        .preconnect(cluster_info_->warmConnections());
+  }
 }
 
 ClusterManagerPtr ProdClusterManagerFactory::clusterManagerFromProto(
@@ -6,7 +6,9 @@
 #include <list>
 #include <map>
 #include <memory>
+#include <set>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "envoy/config/bootstrap/v2/bootstrap.pb.h"
@@ -276,6 +278,20 @@ private:
       Tcp::ConnectionPool::Instance* tcpConnPool(ResourcePriority priority,
                                                  LoadBalancerContext* context);
 
+      Http::ConnectionPool::Instance&
+      connPoolForHost(const HostConstSharedPtr& host, ResourcePriority priority,
+                      Http::Protocol protocol, const std::vector<uint8_t>& hash_key,
+                      const Network::ConnectionSocket::OptionsSharedPtr& options);
+
+      Tcp::ConnectionPool::Instance&
+      tcpConnPoolForHost(const HostConstSharedPtr& host, ResourcePriority priority,
+                         const std::vector<uint8_t>& hash_key,
+                         const Network::ConnectionSocket::OptionsSharedPtr& options);
+
+      // Opens the cluster's warm connections to the host in each kind of connection pool the
+      // cluster has used on this worker.
+      void warmHost(const HostConstSharedPtr& host);
+
       // Upstream::ThreadLocalCluster
       const PrioritySet& prioritySet() override { return priority_set_; }
       ClusterInfoConstSharedPtr info() override { return cluster_info_; }
@@ -291,6 +307,10 @@ private:
       LoadBalancerPtr lb_;
       ClusterInfoConstSharedPtr cluster_info_;
       Http::AsyncClientImpl http_async_client_;
+      // The kinds of connection pools without downstream socket options which have been used for
+      // the cluster on this worker, and which are warmed on hosts added to the cluster.
+      std::set<std::pair<ResourcePriority, Http::Protocol>> warm_http_pools_;
+      std::set<ResourcePriority> warm_tcp_pools_;
     };
 
     typedef std::unique_ptr<ClusterEntry> ClusterEntryPtr;
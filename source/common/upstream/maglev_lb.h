@@ -52,34 +52,27 @@ public:
   MaglevLoadBalancer(const PrioritySet& priority_set, ClusterStats& stats, Runtime::Loader& runtime,
                      Runtime::RandomGenerator& random,
                      const envoy::api::v2::Cluster::CommonLbConfig& common_config,
+                     Event::Dispatcher* main_thread_dispatcher,
                      uint64_t table_size = MaglevTable::DefaultTableSize)
-      : ThreadAwareLoadBalancerBase(priority_set, stats, runtime, random, common_config),
+      : ThreadAwareLoadBalancerBase(priority_set, stats, runtime, random, common_config,
+                                    main_thread_dispatcher),
         table_size_(table_size) {}
 
+  ~MaglevLoadBalancer() { stopBackgroundBuilds(); }
+
 private:
   // ThreadAwareLoadBalancerBase
-  HashingLoadBalancerSharedPtr createLoadBalancer(const HostSet& host_set, bool in_panic) override {
-    // Note that we only compute global panic on host set refresh. Given that the runtime setting
-    // will rarely change, this is a reasonable compromise to avoid creating extra LBs when we only
-    // need to create one per priority level.
-    const bool has_locality =
-        host_set.localityWeights() != nullptr && !host_set.localityWeights()->empty();
-    if (in_panic) {
-      if (!has_locality) {
-        return std::make_shared<MaglevTable>(HostsPerLocalityImpl(host_set.hosts(), false), nullptr,
-                                             table_size_);
-      } else {
-        return std::make_shared<MaglevTable>(host_set.hostsPerLocality(),
-                                             host_set.localityWeights(), table_size_);
-      }
+  HashingLoadBalancerSharedPtr createLoadBalancer(const PriorityHosts& hosts,
+                                                  const HashingLoadBalancerSharedPtr&) override {
+    // The table is always built from scratch. Where each host lands depends on the order in which
+    // all hosts claim entries, so patching the previous table would make it depend on the history
+    // of updates, and different Envoys with the same hosts would no longer agree on the table.
+    if (hosts.locality_weights_ == nullptr) {
+      return std::make_shared<MaglevTable>(HostsPerLocalityImpl(*hosts.hosts_, false), nullptr,
+                                           table_size_);
     } else {
-      if (!has_locality) {
-        return std::make_shared<MaglevTable>(HostsPerLocalityImpl(host_set.healthyHosts(), false),
-                                             nullptr, table_size_);
-      } else {
-        return std::make_shared<MaglevTable>(host_set.healthyHostsPerLocality(),
-                                             host_set.localityWeights(), table_size_);
-      }
+      return std::make_shared<MaglevTable>(*hosts.hosts_per_locality_, hosts.locality_weights_,
+                                           table_size_);
     }
   }
 
@@ -133,7 +133,8 @@ DetectorImpl::DetectorImpl(const Cluster& cluster,
                            TimeSource& time_source, EventLoggerSharedPtr event_logger)
     : config_(config), dispatcher_(dispatcher), runtime_(runtime), time_source_(time_source),
       stats_(generateStats(cluster.info()->statsScope())),
-      interval_timer_(dispatcher.createTimer([this]() -> void { onIntervalTimer(); })),
+      interval_timer_(dispatcher.createTimer([this]() -> void { onIntervalTimer(); },
+                                             Event::TimerResolution::Coarse)),
       event_logger_(event_logger), success_rate_average_(-1), success_rate_ejection_threshold_(-1) {
 }
 
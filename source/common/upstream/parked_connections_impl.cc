@@ -0,0 +1,156 @@
+#include "common/upstream/parked_connections_impl.h"
+
+#include <sys/socket.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdint>
+#include <memory>
+
+#include "common/common/assert.h"
+
+namespace Envoy {
+namespace Upstream {
+
+ParkedConnectionsImpl::ParkedConnectionsImpl(uint32_t capacity,
+                                             std::chrono::milliseconds idle_timeout,
+                                             const ClusterInfo& cluster,
+                                             const HostStats& host_stats)
+    : capacity_(capacity),
+      idle_timeout_ns_(std::chrono::duration_cast<std::chrono::nanoseconds>(idle_timeout).count()),
+      cluster_(cluster), host_stats_(host_stats), slots_(new Slot[capacity]) {
+  ASSERT(capacity > 0);
+  for (uint64_t i = 0; i < capacity_; i++) {
+    slots_[i].sequence_.store(i, std::memory_order_relaxed);
+    slots_[i].socket_ = nullptr;
+    slots_[i].expires_at_ns_.store(0, std::memory_order_relaxed);
+  }
+}
+
+ParkedConnectionsImpl::~ParkedConnectionsImpl() {
+  // Close the sockets which are still parked.
+  bool other_worker;
+  bool expired;
+  while (takeOne(0, false, other_worker, expired) != nullptr) {
+  }
+}
+
+bool ParkedConnectionsImpl::park(Network::ConnectionSocketPtr& socket, ResourcePriority priority,
+                                 MonotonicTime now) {
+  uint64_t position = park_position_.load(std::memory_order_relaxed);
+  while (true) {
+    Slot& slot = slots_[position % capacity_];
+    const uint64_t sequence = slot.sequence_.load(std::memory_order_acquire);
+    if (sequence == position) {
+      // The slot is free. Claim the position, or retry from the position another thread moved on
+      // to.
+      if (park_position_.compare_exchange_weak(position, position + 1,
+                                               std::memory_order_relaxed)) {
+        // The socket is counted before it can be taken, so that taking it never underflows.
+        cluster_.stats().upstream_cx_active_.inc();
+        cluster_.stats().upstream_cx_parked_active_.inc();
+        host_stats_.cx_active_.inc();
+        cluster_.resourceManager(priority).connections().inc();
+        slot.socket_ = socket.release();
+        slot.thread_ = Thread::Thread::currentThreadId();
+        slot.priority_ = priority;
+        slot.expires_at_ns_.store(toNs(now) + idle_timeout_ns_, std::memory_order_relaxed);
+        slot.sequence_.store(position + 1, std::memory_order_release);
+        return true;
+      }
+    } else if (sequence < position) {
+      // The slot still holds the socket parked a lap ago, so the queue is full.
+      return false;
+    } else {
+      position = park_position_.load(std::memory_order_relaxed);
+    }
+  }
+}
+
+Network::ConnectionSocketPtr ParkedConnectionsImpl::take(bool& other_worker, MonotonicTime now) {
+  const int64_t now_ns = toNs(now);
+  while (true) {
+    bool expired;
+    Network::ConnectionSocketPtr socket = takeOne(now_ns, false, other_worker, expired);
+    if (socket == nullptr) {
+      return nullptr;
+    }
+    if (expired) {
+      cluster_.stats().upstream_cx_idle_timeout_.inc();
+    } else if (usable(*socket)) {
+      return socket;
+    }
+  }
+}
+
+absl::optional<std::chrono::milliseconds> ParkedConnectionsImpl::closeIdle(MonotonicTime now) {
+  const int64_t now_ns = toNs(now);
+  bool other_worker;
+  bool expired;
+  while (takeOne(now_ns, true, other_worker, expired) != nullptr) {
+    cluster_.stats().upstream_cx_idle_timeout_.inc();
+  }
+
+  // The socket parked the longest is the next to expire.
+  const uint64_t position = take_position_.load(std::memory_order_relaxed);
+  const Slot& slot = slots_[position % capacity_];
+  if (slot.sequence_.load(std::memory_order_acquire) != position + 1) {
+    return absl::nullopt;
+  }
+  const int64_t remaining_ns =
+      std::max<int64_t>(slot.expires_at_ns_.load(std::memory_order_relaxed) - now_ns, 0);
+  return std::chrono::duration_cast<std::chrono::milliseconds>(
+      std::chrono::nanoseconds(remaining_ns + 999999));
+}
+
+Network::ConnectionSocketPtr ParkedConnectionsImpl::takeOne(int64_t now_ns, bool expired_only,
+                                                            bool& other_worker, bool& expired) {
+  uint64_t position = take_position_.load(std::memory_order_relaxed);
+  while (true) {
+    Slot& slot = slots_[position % capacity_];
+    const uint64_t sequence = slot.sequence_.load(std::memory_order_acquire);
+    if (sequence == position + 1) {
+      const int64_t expires_at_ns = slot.expires_at_ns_.load(std::memory_order_relaxed);
+      if (expired_only && expires_at_ns > now_ns) {
+        return nullptr;
+      }
+      // The slot holds a socket. Claim the position, or retry from the position another thread
+      // moved on to.
+      if (take_position_.compare_exchange_weak(position, position + 1,
+                                               std::memory_order_relaxed)) {
+        Network::ConnectionSocketPtr socket(slot.socket_);
+        other_worker = slot.thread_ != Thread::Thread::currentThreadId();
+        expired = expires_at_ns <= now_ns;
+        const ResourcePriority priority = slot.priority_;
+        slot.socket_ = nullptr;
+        // Free the slot for the park a lap later.
+        slot.sequence_.store(position + capacity_, std::memory_order_release);
+
+        cluster_.stats().upstream_cx_active_.dec();
+        cluster_.stats().upstream_cx_parked_active_.dec();
+        host_stats_.cx_active_.dec();
+        cluster_.resourceManager(priority).connections().dec();
+        return socket;
+      }
+    } else if (sequence < position + 1) {
+      // Nothing has been parked in the slot since it was last taken, so the queue is empty.
+      return nullptr;
+    } else {
+      position = take_position_.load(std::memory_order_relaxed);
+    }
+  }
+}
+
+bool ParkedConnectionsImpl::usable(const Network::ConnectionSocket& socket) {
+  // An idle connection has nothing to read unless its peer closed it.
+  char byte;
+  const ssize_t rc = ::recv(socket.fd(), &byte, 1, MSG_PEEK | MSG_DONTWAIT);
+  return rc == -1 && (errno == EAGAIN || errno == EWOULDBLOCK);
+}
+
+int64_t ParkedConnectionsImpl::toNs(MonotonicTime time) {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(time.time_since_epoch()).count();
+}
+
+} // namespace Upstream
+} // namespace Envoy
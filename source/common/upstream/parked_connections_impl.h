@@ -0,0 +1,78 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+
+#include "envoy/common/time.h"
+#include "envoy/network/listen_socket.h"
+#include "envoy/upstream/upstream.h"
+
+#include "common/common/non_copyable.h"
+#include "common/common/thread.h"
+
+namespace Envoy {
+namespace Upstream {
+
+/**
+ * Parked connections held in a bounded lock free queue, so that workers parking and taking
+ * sockets never wait for each other. Each slot has a sequence number which tells the thread
+ * claiming a position in the queue whether the slot is free to park in or holds a socket to take.
+ */
+class ParkedConnectionsImpl : public ParkedConnections, NonCopyable {
+public:
+  /**
+   * @param capacity supplies the number of sockets which can be parked at once.
+   * @param idle_timeout supplies how long a socket stays parked before it is closed.
+   * @param cluster supplies the cluster of the host, whose stats and connection circuit breakers
+   *        count the parked sockets.
+   * @param host_stats supplies the stats of the host, which count the parked sockets.
+   */
+  ParkedConnectionsImpl(uint32_t capacity, std::chrono::milliseconds idle_timeout,
+                        const ClusterInfo& cluster, const HostStats& host_stats);
+  ~ParkedConnectionsImpl();
+
+  // Upstream::ParkedConnections
+  bool park(Network::ConnectionSocketPtr& socket, ResourcePriority priority,
+            MonotonicTime now) override;
+  Network::ConnectionSocketPtr take(bool& other_worker, MonotonicTime now) override;
+  absl::optional<std::chrono::milliseconds> closeIdle(MonotonicTime now) override;
+
+private:
+  struct Slot {
+    std::atomic<uint64_t> sequence_;
+    Network::ConnectionSocket* socket_;
+    Thread::ThreadId thread_;
+    ResourcePriority priority_;
+    // Read before the slot is claimed, to only take expired sockets, so it is atomic.
+    std::atomic<int64_t> expires_at_ns_;
+  };
+
+  /**
+   * Takes the socket which has been parked the longest, and stops counting it.
+   * @param now_ns supplies the current time.
+   * @param expired_only supplies whether to only take the socket if it has reached its idle
+   *        timeout.
+   * @param other_worker is set to whether the socket was parked by another thread.
+   * @param expired is set to whether the socket has reached its idle timeout.
+   */
+  Network::ConnectionSocketPtr takeOne(int64_t now_ns, bool expired_only, bool& other_worker,
+                                       bool& expired);
+
+  // Whether an idle socket can still be used, i.e. its peer has not closed it or sent anything.
+  static bool usable(const Network::ConnectionSocket& socket);
+  static int64_t toNs(MonotonicTime time);
+
+  const uint64_t capacity_;
+  const int64_t idle_timeout_ns_;
+  const ClusterInfo& cluster_;
+  const HostStats host_stats_;
+  std::unique_ptr<Slot[]> slots_;
+  // The positions are on their own cache lines, so that parking and taking do not contend.
+  alignas(64) std::atomic<uint64_t> park_position_{};
+  alignas(64) std::atomic<uint64_t> take_position_{};
+};
+
+} // namespace Upstream
+} // namespace Envoy
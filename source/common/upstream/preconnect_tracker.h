@@ -0,0 +1,50 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+namespace Envoy {
+namespace Upstream {
+
+/**
+ * Tracks the demand on a connection pool as an exponentially weighted moving average of the
+ * requests in flight each time a new request starts, and works out how many connections the pool
+ * should keep open to its host ahead of that demand.
+ */
+class PreconnectTracker {
+public:
+  /**
+   * Record a new request.
+   * @param requests supplies the requests in flight, including the new one and those waiting for a
+   *        connection.
+   */
+  void onNewRequest(uint64_t requests) { average_ += (requests - average_) * AVERAGE_WEIGHT; }
+
+  /**
+   * @param requests supplies the requests in flight, including those waiting for a connection.
+   * @param ratio supplies the connections to keep open for each request expected to be in flight.
+   * @return uint64_t the number of connections the pool should have, counting those still
+   *         connecting. This is 0 if the ratio is 1 or less, which disables preconnecting.
+   */
+  uint64_t targetConnections(uint64_t requests, float ratio) const {
+    if (ratio <= 1) {
+      return 0;
+    }
+    return std::ceil(ratio * std::max(static_cast<double>(requests), average_));
+  }
+
+  /**
+   * @return double the moving average of the requests in flight.
+   */
+  double average() const { return average_; }
+
+private:
+  // The weight of each new sample, which makes the average follow roughly the last 8 requests.
+  static constexpr double AVERAGE_WEIGHT = 0.125;
+
+  double average_{};
+};
+
+} // namespace Upstream
+} // namespace Envoy
@@ -2,6 +2,7 @@
 
 #include <cstdint>
 #include <iostream>
+#include <iterator>
 #include <string>
 #include <vector>
 
@@ -17,10 +18,14 @@ RingHashLoadBalancer::RingHashLoadBalancer(
     PrioritySet& priority_set, ClusterStats& stats, Runtime::Loader& runtime,
     Runtime::RandomGenerator& random,
     const absl::optional<envoy::api::v2::Cluster::RingHashLbConfig>& config,
-    const envoy::api::v2::Cluster::CommonLbConfig& common_config)
-    : ThreadAwareLoadBalancerBase(priority_set, stats, runtime, random, common_config),
+    const envoy::api::v2::Cluster::CommonLbConfig& common_config,
+    Event::Dispatcher* main_thread_dispatcher)
+    : ThreadAwareLoadBalancerBase(priority_set, stats, runtime, random, common_config,
+                                  main_thread_dispatcher),
       config_(config) {}
 
+RingHashLoadBalancer::~RingHashLoadBalancer() { stopBackgroundBuilds(); }
+
 HostConstSharedPtr RingHashLoadBalancer::Ring::chooseHost(uint64_t h) const {
   if (ring_.empty()) {
     return nullptr;
@@ -60,7 +65,7 @@ HostConstSharedPtr RingHashLoadBalancer::Ring::chooseHost(uint64_t h) const {
 
 RingHashLoadBalancer::Ring::Ring(
     const absl::optional<envoy::api::v2::Cluster::RingHashLbConfig>& config,
-    const HostVector& hosts) {
+    const HostVector& hosts, const Ring* previous) {
   ENVOY_LOG(trace, "ring hash: building ring");
   if (hosts.empty()) {
     return;
@@ -77,55 +82,48 @@ RingHashLoadBalancer::Ring::Ring(
   const uint64_t min_ring_size =
       config ? PROTOBUF_GET_WRAPPED_OR_DEFAULT(config.value(), minimum_ring_size, 1024) : 1024;
 
-  uint64_t hashes_per_host = 1;
+  hashes_per_host_ = 1;
   if (hosts.size() < min_ring_size) {
-    hashes_per_host = min_ring_size / hosts.size();
+    hashes_per_host_ = min_ring_size / hosts.size();
     if ((min_ring_size % hosts.size()) != 0) {
-      hashes_per_host++;
+      hashes_per_host_++;
     }
   }
 
-  ENVOY_LOG(info, "ring hash: min_ring_size={} hashes_per_host={}", min_ring_size, hashes_per_host);
-  ring_.reserve(hosts.size() * hashes_per_host);
-
   const bool use_std_hash =
       config ? PROTOBUF_GET_WRAPPED_OR_DEFAULT(config.value().deprecated_v1(), use_std_hash, false)
              : false;
 
-  char hash_key_buffer[196];
+  hosts_.reserve(hosts.size());
   for (const auto& host : hosts) {
-    const std::string& address_string = host->address()->asString();
-    uint64_t offset_start = address_string.size();
-
-    // Currently, we support both IP and UDS addresses. The UDS max path length is ~108 on all Unix
-    // platforms that I know of. Given that, we can use a 196 char buffer which is plenty of room
-    // for UDS, '_', and up to 21 characters for the node ID. To be on the super safe side, there
-    // is a RELEASE_ASSERT here that checks this, in case someone in the future adds some type of
-    // new address that is larger, or runs on a platform where UDS is larger. I don't think it's
-    // worth the defensive coding to deal with the heap allocation case (e.g. via
-    // absl::InlinedVector) at the current time.
-    RELEASE_ASSERT(
-        address_string.size() + 1 + StringUtil::MIN_ITOA_OUT_LEN <= sizeof(hash_key_buffer), "");
-    memcpy(hash_key_buffer, address_string.c_str(), offset_start);
-    hash_key_buffer[offset_start++] = '_';
-    for (uint64_t i = 0; i < hashes_per_host; i++) {
-      const uint64_t total_hash_key_len =
-          offset_start +
-          StringUtil::itoa(hash_key_buffer + offset_start, StringUtil::MIN_ITOA_OUT_LEN, i);
-      absl::string_view hash_key(hash_key_buffer, total_hash_key_len);
-
-      // Sadly std::hash provides no mechanism for hashing arbitrary bytes so we must copy here.
-      // xxHash is done wihout copies.
-      const uint64_t hash = use_std_hash ? std::hash<std::string>()(std::string(hash_key))
-                                         : HashUtil::xxHash64(hash_key);
-      ENVOY_LOG(trace, "ring hash: hash_key={} hash={}", hash_key.data(), hash);
-      ring_.push_back({hash, host});
+    hosts_.insert(host.get());
+  }
+
+  // The previous ring can only be reused if each host has as many entries on it as on the new one.
+  // When most hosts are new, merging saves little over a full build.
+  HostVector hosts_added;
+  if (previous != nullptr && previous->hashes_per_host_ == hashes_per_host_) {
+    for (const auto& host : hosts) {
+      if (previous->hosts_.count(host.get()) == 0) {
+        hosts_added.push_back(host);
+      }
+    }
+    if (hosts_added.size() > hosts.size() / 2) {
+      previous = nullptr;
     }
+  } else {
+    previous = nullptr;
+  }
+
+  ring_.reserve(hosts.size() * hashes_per_host_);
+  if (previous != nullptr) {
+    buildIncremental(*previous, hosts_added, use_std_hash);
+  } else {
+    ENVOY_LOG(info, "ring hash: min_ring_size={} hashes_per_host={}", min_ring_size,
+              hashes_per_host_);
+    buildFull(hosts, use_std_hash);
   }
 
-  std::sort(ring_.begin(), ring_.end(), [](const RingEntry& lhs, const RingEntry& rhs) -> bool {
-    return lhs.hash_ < rhs.hash_;
-  });
   if (ENVOY_LOG_CHECK_LEVEL(trace)) {
     for (const auto& entry : ring_) {
       ENVOY_LOG(trace, "ring hash: host={} hash={}", entry.host_->address()->asString(),
@@ -134,5 +132,82 @@ RingHashLoadBalancer::Ring::Ring(
   }
 }
 
+void RingHashLoadBalancer::Ring::buildFull(const HostVector& hosts, bool use_std_hash) {
+  for (const auto& host : hosts) {
+    addHostEntries(ring_, host, use_std_hash);
+  }
+
+  sortByHash(ring_);
+}
+
+void RingHashLoadBalancer::Ring::buildIncremental(const Ring& previous,
+                                                  const HostVector& hosts_added,
+                                                  bool use_std_hash) {
+  std::vector<RingEntry> added_entries;
+  added_entries.reserve(hosts_added.size() * hashes_per_host_);
+  for (const auto& host : hosts_added) {
+    addHostEntries(added_entries, host, use_std_hash);
+  }
+  sortByHash(added_entries);
+
+  // Each host of the previous ring which is still present has been counted in hosts_ already.
+  const uint64_t hosts_kept = hosts_.size() - hosts_added.size();
+  const bool hosts_removed = hosts_kept != previous.hosts_.size();
+  ENVOY_LOG(debug, "ring hash: merging {} added hosts into a ring of {} hosts, {} of which remain",
+            hosts_added.size(), previous.hosts_.size(), hosts_kept);
+
+  auto added_it = added_entries.begin();
+  for (const RingEntry& entry : previous.ring_) {
+    if (hosts_removed && hosts_.count(entry.host_.get()) == 0) {
+      continue;
+    }
+    while (added_it != added_entries.end() && added_it->hash_ < entry.hash_) {
+      ring_.push_back(std::move(*added_it++));
+    }
+    ring_.push_back(entry);
+  }
+  ring_.insert(ring_.end(), std::make_move_iterator(added_it),
+               std::make_move_iterator(added_entries.end()));
+}
+
+void RingHashLoadBalancer::Ring::sortByHash(std::vector<RingEntry>& entries) {
+  std::sort(entries.begin(), entries.end(), [](const RingEntry& lhs, const RingEntry& rhs) -> bool {
+    return lhs.hash_ < rhs.hash_;
+  });
+}
+
+void RingHashLoadBalancer::Ring::addHostEntries(std::vector<RingEntry>& entries,
+                                                const HostConstSharedPtr& host,
+                                                bool use_std_hash) const {
+  char hash_key_buffer[196];
+  const std::string& address_string = host->address()->asString();
+  uint64_t offset_start = address_string.size();
+
+  // Currently, we support both IP and UDS addresses. The UDS max path length is ~108 on all Unix
+  // platforms that I know of. Given that, we can use a 196 char buffer which is plenty of room
+  // for UDS, '_', and up to 21 characters for the node ID. To be on the super safe side, there
+  // is a RELEASE_ASSERT here that checks this, in case someone in the future adds some type of
+  // new address that is larger, or runs on a platform where UDS is larger. I don't think it's
+  // worth the defensive coding to deal with the heap allocation case (e.g. via
+  // absl::InlinedVector) at the current time.
+  RELEASE_ASSERT(
+      address_string.size() + 1 + StringUtil::MIN_ITOA_OUT_LEN <= sizeof(hash_key_buffer), "");
+  memcpy(hash_key_buffer, address_string.c_str(), offset_start);
+  hash_key_buffer[offset_start++] = '_';
+  for (uint64_t i = 0; i < hashes_per_host_; i++) {
+    const uint64_t total_hash_key_len =
+        offset_start +
+        StringUtil::itoa(hash_key_buffer + offset_start, StringUtil::MIN_ITOA_OUT_LEN, i);
+    absl::string_view hash_key(hash_key_buffer, total_hash_key_len);
+
+    // Sadly std::hash provides no mechanism for hashing arbitrary bytes so we must copy here.
+    // xxHash is done wihout copies.
+    const uint64_t hash = use_std_hash ? std::hash<std::string>()(std::string(hash_key))
+                                       : HashUtil::xxHash64(hash_key);
+    ENVOY_LOG(trace, "ring hash: hash_key={} hash={}", hash_key.data(), hash);
+    entries.push_back({hash, host});
+  }
+}
+
 } // namespace Upstream
 } // namespace Envoy
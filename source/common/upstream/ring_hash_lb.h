@@ -1,5 +1,6 @@
 #pragma once
 
+#include <unordered_set>
 #include <vector>
 
 #include "envoy/runtime/runtime.h"
@@ -25,7 +26,9 @@ public:
   RingHashLoadBalancer(PrioritySet& priority_set, ClusterStats& stats, Runtime::Loader& runtime,
                        Runtime::RandomGenerator& random,
                        const absl::optional<envoy::api::v2::Cluster::RingHashLbConfig>& config,
-                       const envoy::api::v2::Cluster::CommonLbConfig& common_config);
+                       const envoy::api::v2::Cluster::CommonLbConfig& common_config,
+                       Event::Dispatcher* main_thread_dispatcher);
+  ~RingHashLoadBalancer();
 
 private:
   struct RingEntry {
@@ -33,27 +36,37 @@ private:
     HostConstSharedPtr host_;
   };
 
+  /**
+   * A ring may be built from the ring of the previous host set update. The entries of the hosts
+   * still present are kept in order, and only the entries of the added hosts are hashed, sorted and
+   * merged in, which avoids hashing and sorting the whole ring when a few hosts change.
+   */
   struct Ring : public HashingLoadBalancer {
     Ring(const absl::optional<envoy::api::v2::Cluster::RingHashLbConfig>& config,
-         const HostVector& hosts);
+         const HostVector& hosts, const Ring* previous);
 
     // ThreadAwareLoadBalancerBase::HashingLoadBalancer
     HostConstSharedPtr chooseHost(uint64_t hash) const override;
 
+    void buildFull(const HostVector& hosts, bool use_std_hash);
+    void buildIncremental(const Ring& previous, const HostVector& hosts_added, bool use_std_hash);
+    void addHostEntries(std::vector<RingEntry>& entries, const HostConstSharedPtr& host,
+                        bool use_std_hash) const;
+    static void sortByHash(std::vector<RingEntry>& entries);
+
     std::vector<RingEntry> ring_;
+    // The hosts on the ring. The entries of the ring keep them alive.
+    std::unordered_set<const Host*> hosts_;
+    uint64_t hashes_per_host_{};
   };
   typedef std::shared_ptr<const Ring> RingConstSharedPtr;
 
   // ThreadAwareLoadBalancerBase
-  HashingLoadBalancerSharedPtr createLoadBalancer(const HostSet& host_set, bool in_panic) override {
-    // Note that we only compute global panic on host set refresh. Given that the runtime setting
-    // will rarely change, this is a reasonable compromise to avoid creating extra LBs when we only
-    // need to create one per priority level.
-    if (in_panic) {
-      return std::make_shared<Ring>(config_, host_set.hosts());
-    } else {
-      return std::make_shared<Ring>(config_, host_set.healthyHosts());
-    }
+  HashingLoadBalancerSharedPtr
+  createLoadBalancer(const PriorityHosts& hosts,
+                     const HashingLoadBalancerSharedPtr& previous) override {
+    // The previous load balancer was built by this load balancer, so it is a ring.
+    return std::make_shared<Ring>(config_, *hosts.hosts_, static_cast<const Ring*>(previous.get()));
   }
 
   const absl::optional<envoy::api::v2::Cluster::RingHashLbConfig>& config_;
@@ -2,47 +2,130 @@
 
 #include <memory>
 
+#include "common/common/lock_guard.h"
+
 namespace Envoy {
 namespace Upstream {
 
+ThreadAwareLoadBalancerBase::~ThreadAwareLoadBalancerBase() {
+  // Subclasses must stop background builds before their part of the object is destroyed.
+  ASSERT(builder_ == nullptr);
+}
+
 void ThreadAwareLoadBalancerBase::initialize() {
-  // TODO(mattklein123): In the future, once initialized and the initial LB is built, it would be
-  // better to use a background thread for computing LB updates. This has the substantial benefit
-  // that if the LB computation thread falls behind, host set updates can be trivially collapsed.
-  // I will look into doing this in a follow up. Doing everything using a background thread heavily
-  // complicated initialization as the load balancer would need its own initialized callback. I
-  // think the synchronous/asynchronous split is probably the best option.
+  // The first tables are always built synchronously, so that the load balancer is usable as soon
+  // as it is initialized. If configured, later host set updates are built on a background thread,
+  // which collapses updates arriving faster than the tables can be built.
   priority_set_.addMemberUpdateCb(
       [this](uint32_t, const HostVector&, const HostVector&) -> void { refresh(); });
 
   refresh();
+  initialized_ = true;
+}
+
+void ThreadAwareLoadBalancerBase::waitForBackgroundBuilds() {
+  if (builder_ != nullptr) {
+    builder_->waitForIdle(*this);
+  }
+}
+
+void ThreadAwareLoadBalancerBase::stopBackgroundBuilds() {
+  if (builder_ != nullptr) {
+    builder_->cancel(*this);
+    builder_.reset();
+  }
 }
 
 void ThreadAwareLoadBalancerBase::refresh() {
-  auto per_priority_state_vector = std::make_shared<std::vector<PerPriorityStatePtr>>(
-      priority_set_.hostSetsPerPriority().size());
-  auto per_priority_load = std::make_shared<std::vector<uint32_t>>(per_priority_load_);
+  HostsSnapshotPtr hosts = snapshot();
+  if (!build_in_background_ || !initialized_) {
+    build(*hosts);
+    return;
+  }
+
+  if (builder_ == nullptr) {
+    builder_ = BackgroundBuilder::get();
+  }
+  builder_->post(*this, std::move(hosts));
+}
+
+ThreadAwareLoadBalancerBase::HostsSnapshotPtr ThreadAwareLoadBalancerBase::snapshot() {
+  auto hosts = std::make_unique<HostsSnapshot>();
+  hosts->per_priority_hosts_.resize(priority_set_.hostSetsPerPriority().size());
+  hosts->per_priority_load_ = std::make_shared<std::vector<uint32_t>>(per_priority_load_);
 
   for (const auto& host_set : priority_set_.hostSetsPerPriority()) {
     const uint32_t priority = host_set->priority();
-    (*per_priority_state_vector)[priority] = std::make_unique<PerPriorityState>();
-    const auto& per_priority_state = (*per_priority_state_vector)[priority];
+    PriorityHosts& priority_hosts = hosts->per_priority_hosts_[priority];
     // Copy panic flag from LoadBalancerBase. It is calculated when there is a change
     // in hosts set or hosts' health.
-    per_priority_state->global_panic_ = per_priority_panic_[priority];
-    per_priority_state->current_lb_ =
-        createLoadBalancer(*host_set, per_priority_state->global_panic_);
+    // Note that we only compute global panic on host set refresh. Given that the runtime setting
+    // will rarely change, this is a reasonable compromise to avoid creating extra LBs when we only
+    // need to create one per priority level.
+    priority_hosts.global_panic_ = per_priority_panic_[priority];
+    priority_hosts.hosts_ = std::make_shared<const HostVector>(
+        priority_hosts.global_panic_ ? host_set->hosts() : host_set->healthyHosts());
+    if (host_set->localityWeights() != nullptr && !host_set->localityWeights()->empty()) {
+      priority_hosts.hosts_per_locality_ = priority_hosts.global_panic_
+                                               ? host_set->hostsPerLocality().clone()
+                                               : host_set->healthyHostsPerLocality().clone();
+      priority_hosts.locality_weights_ = host_set->localityWeights();
+    }
+  }
+
+  return hosts;
+}
+
+std::shared_ptr<std::vector<ThreadAwareLoadBalancerBase::PerPriorityStatePtr>>
+ThreadAwareLoadBalancerBase::build(const HostsSnapshot& hosts) {
+  // Only builds publish tables, and builds never run concurrently, so these are the tables this
+  // build replaces.
+  std::shared_ptr<std::vector<PerPriorityStatePtr>> previous_state;
+  {
+    absl::ReaderMutexLock lock(&factory_->mutex_);
+    previous_state = factory_->per_priority_state_;
+  }
+
+  auto per_priority_state_vector =
+      std::make_shared<std::vector<PerPriorityStatePtr>>(hosts.per_priority_hosts_.size());
+  for (uint32_t priority = 0; priority < hosts.per_priority_hosts_.size(); priority++) {
+    const PriorityHosts& priority_hosts = hosts.per_priority_hosts_[priority];
+    (*per_priority_state_vector)[priority] = std::make_unique<PerPriorityState>();
+    const auto& per_priority_state = (*per_priority_state_vector)[priority];
+    per_priority_state->global_panic_ = priority_hosts.global_panic_;
+
+    const HashingLoadBalancerSharedPtr previous =
+        previous_state != nullptr && priority < previous_state->size()
+            ? (*previous_state)[priority]->current_lb_
+            : nullptr;
+    per_priority_state->current_lb_ = createLoadBalancer(priority_hosts, previous);
   }
 
   {
     absl::WriterMutexLock lock(&factory_->mutex_);
-    factory_->per_priority_load_ = per_priority_load;
+    factory_->per_priority_load_ = hosts.per_priority_load_;
     factory_->per_priority_state_ = per_priority_state_vector;
+    factory_->version_++;
   }
+
+  return previous_state;
+}
+
+void ThreadAwareLoadBalancerBase::buildInBackground(HostsSnapshotPtr&& snapshot) {
+  std::shared_ptr<std::vector<PerPriorityStatePtr>> previous_state = build(*snapshot);
+  // Unless workers still use them, the superseded tables and the snapshot hold the last references
+  // to removed hosts, which must not be destroyed on this thread.
+  main_thread_dispatcher_->post(
+      [previous_state, hosts = std::shared_ptr<HostsSnapshot>(std::move(snapshot))]() -> void {});
 }
 
 HostConstSharedPtr
 ThreadAwareLoadBalancerBase::LoadBalancerImpl::chooseHost(LoadBalancerContext* context) {
+  // Pick up tables which were built in the background since this load balancer was created.
+  if (factory_->version_.load(std::memory_order_relaxed) != version_) {
+    refresh();
+  }
+
   // Make sure we correctly return nullptr for any early chooseHost() calls.
   if (per_priority_state_ == nullptr) {
     return nullptr;
@@ -55,27 +138,140 @@ ThreadAwareLoadBalancerBase::LoadBalancerImpl::chooseHost(LoadBalancerContext* c
   if (context) {
     hash = context->computeHashKey();
   }
-  const uint64_t h = hash ? hash.value() : random_.random();
+  const uint64_t h = hash ? hash.value() : factory_->random_.random();
 
   const uint32_t priority = LoadBalancerBase::choosePriority(h, *per_priority_load_);
   const auto& per_priority_state = (*per_priority_state_)[priority];
   if (per_priority_state->global_panic_) {
-    stats_.lb_healthy_panic_.inc();
+    factory_->stats_.lb_healthy_panic_.inc();
   }
   return per_priority_state->current_lb_->chooseHost(h);
 }
 
-LoadBalancerPtr ThreadAwareLoadBalancerBase::LoadBalancerFactoryImpl::create() {
-  auto lb = std::make_unique<LoadBalancerImpl>(stats_, random_);
-
+void ThreadAwareLoadBalancerBase::LoadBalancerImpl::refresh() {
   // We must protect current_lb_ via a RW lock since it is accessed and written to by multiple
   // threads. All complex processing has already been precalculated however.
-  absl::ReaderMutexLock lock(&mutex_);
-  lb->per_priority_load_ = per_priority_load_;
-  lb->per_priority_state_ = per_priority_state_;
+  absl::ReaderMutexLock lock(&factory_->mutex_);
+  per_priority_load_ = factory_->per_priority_load_;
+  per_priority_state_ = factory_->per_priority_state_;
+  version_ = factory_->version_.load(std::memory_order_relaxed);
+}
+
+LoadBalancerPtr ThreadAwareLoadBalancerBase::LoadBalancerFactoryImpl::create() {
+  auto lb = std::make_unique<LoadBalancerImpl>(shared_from_this());
+  lb->refresh();
 
   return std::move(lb);
 }
 
+ThreadAwareLoadBalancerBase::BackgroundBuilder::BackgroundBuilder()
+    : thread_(std::make_unique<Thread::Thread>([this]() -> void { threadRoutine(); })) {}
+
+ThreadAwareLoadBalancerBase::BackgroundBuilder::~BackgroundBuilder() {
+  {
+    Thread::LockGuard guard(lock_);
+    // Load balancers cancel their builds before releasing the builder.
+    ASSERT(pending_.empty() && building_ == nullptr);
+    exit_ = true;
+    wakeup_.notifyAll();
+  }
+  thread_->join();
+}
+
+std::shared_ptr<ThreadAwareLoadBalancerBase::BackgroundBuilder>
+ThreadAwareLoadBalancerBase::BackgroundBuilder::get() {
+  // Load balancers are created and destroyed on the main thread, but the lock keeps tests which
+  // create them on several threads safe.
+  static Thread::MutexBasicLockable* lock = new Thread::MutexBasicLockable();
+  static std::weak_ptr<BackgroundBuilder>* builder = new std::weak_ptr<BackgroundBuilder>();
+
+  Thread::LockGuard guard(*lock);
+  std::shared_ptr<BackgroundBuilder> shared_builder = builder->lock();
+  if (shared_builder == nullptr) {
+    shared_builder = std::make_shared<BackgroundBuilder>();
+    *builder = shared_builder;
+  }
+  return shared_builder;
+}
+
+void ThreadAwareLoadBalancerBase::BackgroundBuilder::post(ThreadAwareLoadBalancerBase& lb,
+                                                          HostsSnapshotPtr&& snapshot) {
+  // Declared before the guard, so that a replaced snapshot is released after the lock.
+  HostsSnapshotPtr superseded;
+  Thread::LockGuard guard(lock_);
+  for (PendingBuild& pending : pending_) {
+    if (pending.first == &lb) {
+      superseded = std::move(pending.second);
+      pending.second = std::move(snapshot);
+      return;
+    }
+  }
+  pending_.emplace_back(&lb, std::move(snapshot));
+  wakeup_.notifyAll();
+}
+
+void ThreadAwareLoadBalancerBase::BackgroundBuilder::waitForIdle(
+    const ThreadAwareLoadBalancerBase& lb) {
+  Thread::LockGuard guard(lock_);
+  while (!idle(lb)) {
+    wakeup_.wait(lock_);
+  }
+}
+
+void ThreadAwareLoadBalancerBase::BackgroundBuilder::cancel(
+    const ThreadAwareLoadBalancerBase& lb) {
+  // Declared before the guard, so that a cancelled snapshot is released after the lock.
+  std::list<PendingBuild> cancelled;
+  Thread::LockGuard guard(lock_);
+  for (auto it = pending_.begin(); it != pending_.end(); ++it) {
+    if (it->first == &lb) {
+      cancelled.splice(cancelled.end(), pending_, it);
+      break;
+    }
+  }
+  while (building_ == &lb) {
+    wakeup_.wait(lock_);
+  }
+}
+
+bool ThreadAwareLoadBalancerBase::BackgroundBuilder::idle(const ThreadAwareLoadBalancerBase& lb) {
+  if (building_ == &lb) {
+    return false;
+  }
+  for (const PendingBuild& pending : pending_) {
+    if (pending.first == &lb) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void ThreadAwareLoadBalancerBase::BackgroundBuilder::threadRoutine() {
+  while (true) {
+    PendingBuild next;
+    {
+      Thread::LockGuard guard(lock_);
+      while (pending_.empty() && !exit_) {
+        wakeup_.wait(lock_);
+      }
+      if (exit_) {
+        return;
+      }
+      next = std::move(pending_.front());
+      pending_.pop_front();
+      building_ = next.first;
+    }
+
+    // The load balancer cannot be destroyed during the build, since cancel() waits for it.
+    next.first->buildInBackground(std::move(next.second));
+
+    {
+      Thread::LockGuard guard(lock_);
+      building_ = nullptr;
+      wakeup_.notifyAll();
+    }
+  }
+}
+
 } // namespace Upstream
 } // namespace Envoy
@@ -1,5 +1,14 @@
 #pragma once
 
+#include <atomic>
+#include <list>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "envoy/event/dispatcher.h"
+
+#include "common/common/thread.h"
 #include "common/upstream/load_balancer_impl.h"
 
 #include "absl/synchronization/mutex.h"
@@ -24,6 +33,21 @@ public:
   };
   typedef std::shared_ptr<HashingLoadBalancer> HashingLoadBalancerSharedPtr;
 
+  /**
+   * The hosts of a priority which a hashing load balancer is built from. They are copied out of the
+   * host set so that the load balancer can be built off the main thread.
+   */
+  struct PriorityHosts {
+    // All hosts in panic, otherwise the healthy hosts.
+    HostVectorConstSharedPtr hosts_;
+    // The same hosts per locality, only set if the host set has locality weights.
+    HostsPerLocalityConstSharedPtr hosts_per_locality_;
+    LocalityWeightsConstSharedPtr locality_weights_;
+    bool global_panic_{};
+  };
+
+  ~ThreadAwareLoadBalancerBase();
+
   // Upstream::ThreadAwareLoadBalancer
   LoadBalancerFactorySharedPtr factory() override { return factory_; }
   void initialize() override;
@@ -33,13 +57,30 @@ public:
     NOT_IMPLEMENTED_GCOVR_EXCL_LINE;
   }
 
+  /**
+   * Wait until the tables of all host set updates so far have been built in the background.
+   * Used by tests.
+   */
+  void waitForBackgroundBuilds();
+
 protected:
   ThreadAwareLoadBalancerBase(const PrioritySet& priority_set, ClusterStats& stats,
                               Runtime::Loader& runtime, Runtime::RandomGenerator& random,
-                              const envoy::api::v2::Cluster::CommonLbConfig& common_config)
+                              const envoy::api::v2::Cluster::CommonLbConfig& common_config,
+                              Event::Dispatcher* main_thread_dispatcher)
       : LoadBalancerBase(priority_set, stats, runtime, random, common_config),
+        main_thread_dispatcher_(main_thread_dispatcher),
+        build_in_background_(common_config.build_hash_tables_in_background() &&
+                             main_thread_dispatcher != nullptr),
         factory_(new LoadBalancerFactoryImpl(stats, random)) {}
 
+  /**
+   * Stop building tables in the background, waiting for a build of this load balancer in progress
+   * to finish. This must be called by the destructor of each subclass, since builds call
+   * createLoadBalancer().
+   */
+  void stopBackgroundBuilds();
+
 private:
   struct PerPriorityState {
     std::shared_ptr<HashingLoadBalancer> current_lb_;
@@ -47,20 +88,33 @@ private:
   };
   typedef std::unique_ptr<PerPriorityState> PerPriorityStatePtr;
 
+  // The hosts of every priority and the load of each priority at the time of a host set update.
+  struct HostsSnapshot {
+    std::vector<PriorityHosts> per_priority_hosts_;
+    std::shared_ptr<std::vector<uint32_t>> per_priority_load_;
+  };
+  typedef std::unique_ptr<HostsSnapshot> HostsSnapshotPtr;
+
+  struct LoadBalancerFactoryImpl;
+
   struct LoadBalancerImpl : public LoadBalancer {
-    LoadBalancerImpl(ClusterStats& stats, Runtime::RandomGenerator& random)
-        : stats_(stats), random_(random) {}
+    LoadBalancerImpl(std::shared_ptr<LoadBalancerFactoryImpl> factory)
+        : factory_(std::move(factory)) {}
 
     // Upstream::LoadBalancer
     HostConstSharedPtr chooseHost(LoadBalancerContext* context) override;
 
-    ClusterStats& stats_;
-    Runtime::RandomGenerator& random_;
+    // Take the latest tables from the factory.
+    void refresh();
+
+    const std::shared_ptr<LoadBalancerFactoryImpl> factory_;
     std::shared_ptr<std::vector<PerPriorityStatePtr>> per_priority_state_;
     std::shared_ptr<std::vector<uint32_t>> per_priority_load_;
+    uint64_t version_{};
   };
 
-  struct LoadBalancerFactoryImpl : public LoadBalancerFactory {
+  struct LoadBalancerFactoryImpl : public LoadBalancerFactory,
+                                   public std::enable_shared_from_this<LoadBalancerFactoryImpl> {
     LoadBalancerFactoryImpl(ClusterStats& stats, Runtime::RandomGenerator& random)
         : stats_(stats), random_(random) {}
 
@@ -73,13 +127,68 @@ private:
     std::shared_ptr<std::vector<PerPriorityStatePtr>> per_priority_state_ GUARDED_BY(mutex_);
     // This is split out of PerPriorityState so LoadBalancerBase::ChoosePriorirty can be reused.
     std::shared_ptr<std::vector<uint32_t>> per_priority_load_ GUARDED_BY(mutex_);
+    // Bumped each time new tables are published, so that worker load balancers created before
+    // tables which were built in the background can pick them up.
+    std::atomic<uint64_t> version_{};
   };
 
-  virtual HashingLoadBalancerSharedPtr createLoadBalancer(const HostSet& host_set,
-                                                          bool in_panic) PURE;
-  void refresh();
+  // Builds the tables of host set updates of all load balancers on a single thread, which is
+  // started by the first load balancer to build in the background and joined when the last one is
+  // destroyed. An update which arrives while a build is running replaces any update of the same
+  // load balancer still waiting, so a slow build skips stale updates. Load balancers with waiting
+  // updates are built in the order in which they were first posted.
+  class BackgroundBuilder {
+  public:
+    BackgroundBuilder();
+    ~BackgroundBuilder();
+
+    /**
+     * @return the builder shared by all load balancers, which is created if there is none.
+     */
+    static std::shared_ptr<BackgroundBuilder> get();
+
+    void post(ThreadAwareLoadBalancerBase& lb, HostsSnapshotPtr&& snapshot);
+    void waitForIdle(const ThreadAwareLoadBalancerBase& lb);
+    void cancel(const ThreadAwareLoadBalancerBase& lb);
+
+  private:
+    typedef std::pair<ThreadAwareLoadBalancerBase*, HostsSnapshotPtr> PendingBuild;
+
+    bool idle(const ThreadAwareLoadBalancerBase& lb) EXCLUSIVE_LOCKS_REQUIRED(lock_);
+    void threadRoutine();
+
+    Thread::MutexBasicLockable lock_;
+    Thread::CondVar wakeup_;
+    std::list<PendingBuild> pending_ GUARDED_BY(lock_);
+    // The load balancer whose tables are being built, if any.
+    const ThreadAwareLoadBalancerBase* building_ GUARDED_BY(lock_){};
+    bool exit_ GUARDED_BY(lock_){};
+    Thread::ThreadPtr thread_;
+  };
 
+  /**
+   * Build the hashing load balancer of a priority. This may run on a background thread, so it must
+   * only use the given hosts and the configuration of the load balancer.
+   * @param hosts supplies the hosts to balance between.
+   * @param previous supplies the load balancer previously built for the priority by this load
+   *        balancer, or nullptr. It may be reused to build the new one incrementally.
+   * @return HashingLoadBalancerSharedPtr the new load balancer.
+   */
+  virtual HashingLoadBalancerSharedPtr
+  createLoadBalancer(const PriorityHosts& hosts,
+                     const HashingLoadBalancerSharedPtr& previous) PURE;
+  void refresh();
+  HostsSnapshotPtr snapshot();
+  std::shared_ptr<std::vector<PerPriorityStatePtr>> build(const HostsSnapshot& snapshot);
+  void buildInBackground(HostsSnapshotPtr&& snapshot);
+
+  // Superseded tables and snapshots hold references to hosts, so the builder releases them on the
+  // main thread. Tables are only built in the background if this is set.
+  Event::Dispatcher* const main_thread_dispatcher_;
+  const bool build_in_background_;
+  bool initialized_{};
   std::shared_ptr<LoadBalancerFactoryImpl> factory_;
+  std::shared_ptr<BackgroundBuilder> builder_;
 };
 
 } // namespace Upstream
@@ -335,7 +335,19 @@ ClusterInfoImpl::ClusterInfoImpl(const envoy::api::v2::Cluster& config,
       metadata_(config.metadata()), typed_metadata_(config.metadata()),
       common_lb_config_(config.common_lb_config()),
       cluster_socket_options_(parseClusterSocketOptions(config, bind_config)),
-      drain_connections_on_host_removal_(config.drain_connections_on_host_removal()) {
+      drain_connections_on_host_removal_(config.drain_connections_on_host_removal()),
+      per_upstream_preconnect_ratio_(PROTOBUF_GET_WRAPPED_OR_DEFAULT(
+          config.preconnect_policy(), per_upstream_preconnect_ratio, 1.0)),
+      warm_connections_(
+          PROTOBUF_GET_WRAPPED_OR_DEFAULT(config.preconnect_policy(), warm_connections, 0)),
+      max_parked_connections_per_host_(
+          config.has_shared_idle_connections() &&
+                  !transport_socket_factory_->implementsSecureTransport()
+              ? PROTOBUF_GET_WRAPPED_OR_DEFAULT(config.shared_idle_connections(),
+                                                max_parked_per_host, 64)
+              : 0),
+      parked_connection_idle_timeout_(
+          PROTOBUF_GET_MS_OR_DEFAULT(config.shared_idle_connections(), idle_timeout, 60000)) {
 
   switch (config.lb_policy()) {
   case envoy::api::v2::Cluster::ROUND_ROBIN:
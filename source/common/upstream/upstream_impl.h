@@ -38,6 +38,7 @@
 #include "common/stats/isolated_store_impl.h"
 #include "common/upstream/load_balancer_impl.h"
 #include "common/upstream/outlier_detection_impl.h"
+#include "common/upstream/parked_connections_impl.h"
 #include "common/upstream/resource_manager_impl.h"
 
 #include "server/init_manager_impl.h"
@@ -167,6 +168,11 @@ public:
                             priority),
         used_(true) {
     weight(initial_weight);
+    if (cluster->maxParkedConnectionsPerHost() > 0) {
+      parked_connections_ = std::make_unique<ParkedConnectionsImpl>(
+          cluster->maxParkedConnectionsPerHost(), cluster->parkedConnectionIdleTimeout(),
+          *cluster, stats());
+    }
   }
 
   // Upstream::Host
@@ -175,6 +181,7 @@ public:
   createConnection(Event::Dispatcher& dispatcher,
                    const Network::ConnectionSocket::OptionsSharedPtr& options) const override;
   CreateConnectionData createHealthCheckConnection(Event::Dispatcher& dispatcher) const override;
+  ParkedConnections* parkedConnections() const override { return parked_connections_.get(); }
   std::vector<Stats::GaugeSharedPtr> gauges() const override { return stats_store_.gauges(); }
   void healthFlagClear(HealthFlag flag) override { health_flags_ &= ~enumToInt(flag); }
   bool healthFlagGet(HealthFlag flag) const override { return health_flags_ & enumToInt(flag); }
@@ -210,6 +217,7 @@ private:
   ActiveHealthFailureType active_health_failure_type_{};
   std::atomic<uint32_t> weight_;
   std::atomic<bool> used_;
+  std::unique_ptr<ParkedConnectionsImpl> parked_connections_;
 };
 
 class HostsPerLocalityImpl : public HostsPerLocality {
@@ -419,6 +427,14 @@ public:
   };
 
   bool drainConnectionsOnHostRemoval() const override { return drain_connections_on_host_removal_; }
+  float perUpstreamPreconnectRatio() const override { return per_upstream_preconnect_ratio_; }
+  uint32_t warmConnections() const override { return warm_connections_; }
+  uint32_t maxParkedConnectionsPerHost() const override {
+    return max_parked_connections_per_host_;
+  }
+  std::chrono::milliseconds parkedConnectionIdleTimeout() const override {
+    return parked_connection_idle_timeout_;
+  }
 
 private:
   struct ResourceManagers {
@@ -461,6 +477,10 @@ private:
   const envoy::api::v2::Cluster::CommonLbConfig common_lb_config_;
   const Network::ConnectionSocket::OptionsSharedPtr cluster_socket_options_;
   const bool drain_connections_on_host_removal_;
+  const float per_upstream_preconnect_ratio_;
+  const uint32_t warm_connections_;
+  const uint32_t max_parked_connections_per_host_;
+  const std::chrono::milliseconds parked_connection_idle_timeout_;
 };
 
 /**
@@ -3,9 +3,13 @@
 #include <iostream>
 #include <memory>
 
+#include "common/buffer/buffer_impl.h"
 #include "common/common/compiler_requirements.h"
 #include "common/common/perf_annotation.h"
+#include "common/event/dispatcher_impl.h"
 #include "common/event/libevent.h"
+#include "common/http/header_map_impl.h"
+#include "common/http/http1/codec_impl.h"
 #include "common/network/utility.h"
 #include "common/stats/thread_local_store.h"
 
@@ -46,6 +50,10 @@ MainCommonBase::MainCommonBase(OptionsImpl& options, Event::TimeSystem& time_sys
     : options_(options), component_factory_(component_factory) {
   ares_library_init(ARES_LIB_INIT_ALL);
   Event::Libevent::Global::initialize();
+  Buffer::OwnedImpl::useOldImpl(options_.libeventBuffersEnabled());
+  Http::HeaderMapImpl::useListStorage(options_.listHeaderMapsEnabled());
+  Http::Http1::ConnectionImpl::useSimdParser(options_.simdHttp1ParserEnabled());
+  Event::DispatcherImpl::useIoUring(options_.ioUringEnabled());
   RELEASE_ASSERT(Envoy::Server::validateProtoDescriptors(), "");
 
   switch (options_.mode()) {
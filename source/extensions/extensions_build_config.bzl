@@ -77,6 +77,7 @@ EXTENSIONS = {
     # Resource monitors
     #
 
+    "envoy.resource_monitors.buffer_memory":            "//source/extensions/resource_monitors/buffer_memory:config",
     "envoy.resource_monitors.fixed_heap":               "//source/extensions/resource_monitors/fixed_heap:config",
     "envoy.resource_monitors.injected_resource":        "//source/extensions/resource_monitors/injected_resource:config",
 
@@ -1,5 +1,7 @@
 #include "extensions/filters/http/jwt_authn/matcher.h"
 
+#include <regex>
+
 #include "common/router/config_impl.h"
 
 using ::envoy::api::v2::route::RouteMatch;
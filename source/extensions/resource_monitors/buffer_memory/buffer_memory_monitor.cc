@@ -0,0 +1,30 @@
+#include "extensions/resource_monitors/buffer_memory/buffer_memory_monitor.h"
+
+#include "common/buffer/slice_allocator.h"
+#include "common/common/assert.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace ResourceMonitors {
+namespace BufferMemoryMonitor {
+
+uint64_t BufferMemoryReader::bytesInUse() { return Buffer::SliceAllocator::totalBytesInUse(); }
+
+BufferMemoryMonitor::BufferMemoryMonitor(
+    const envoy::config::resource_monitor::buffer_memory::v2alpha::BufferMemoryConfig& config,
+    std::unique_ptr<BufferMemoryReader> reader)
+    : max_buffer_memory_(config.max_buffer_memory_bytes()), reader_(std::move(reader)) {
+  ASSERT(max_buffer_memory_ > 0);
+}
+
+void BufferMemoryMonitor::updateResourceUsage(Server::ResourceMonitor::Callbacks& callbacks) {
+  Server::ResourceUsage usage;
+  usage.resource_pressure_ = reader_->bytesInUse() / static_cast<double>(max_buffer_memory_);
+
+  callbacks.onSuccess(usage);
+}
+
+} // namespace BufferMemoryMonitor
+} // namespace ResourceMonitors
+} // namespace Extensions
+} // namespace Envoy
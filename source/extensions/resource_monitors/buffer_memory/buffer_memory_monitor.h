@@ -0,0 +1,42 @@
+#pragma once
+
+#include "envoy/config/resource_monitor/buffer_memory/v2alpha/buffer_memory.pb.validate.h"
+#include "envoy/server/resource_monitor.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace ResourceMonitors {
+namespace BufferMemoryMonitor {
+
+/**
+ * Helper class for getting buffer memory usage.
+ */
+class BufferMemoryReader {
+public:
+  BufferMemoryReader() {}
+  virtual ~BufferMemoryReader() {}
+
+  // Memory in use by buffer slices across all threads.
+  virtual uint64_t bytesInUse();
+};
+
+/**
+ * Buffer memory monitor with a statically configured maximum.
+ */
+class BufferMemoryMonitor : public Server::ResourceMonitor {
+public:
+  BufferMemoryMonitor(
+      const envoy::config::resource_monitor::buffer_memory::v2alpha::BufferMemoryConfig& config,
+      std::unique_ptr<BufferMemoryReader> reader = std::make_unique<BufferMemoryReader>());
+
+  void updateResourceUsage(Server::ResourceMonitor::Callbacks& callbacks) override;
+
+private:
+  const uint64_t max_buffer_memory_;
+  std::unique_ptr<BufferMemoryReader> reader_;
+};
+
+} // namespace BufferMemoryMonitor
+} // namespace ResourceMonitors
+} // namespace Extensions
+} // namespace Envoy
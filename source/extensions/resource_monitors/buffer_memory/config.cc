@@ -0,0 +1,30 @@
+#include "extensions/resource_monitors/buffer_memory/config.h"
+
+#include "envoy/registry/registry.h"
+
+#include "common/protobuf/utility.h"
+
+#include "extensions/resource_monitors/buffer_memory/buffer_memory_monitor.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace ResourceMonitors {
+namespace BufferMemoryMonitor {
+
+Server::ResourceMonitorPtr BufferMemoryMonitorFactory::createResourceMonitorFromProtoTyped(
+    const envoy::config::resource_monitor::buffer_memory::v2alpha::BufferMemoryConfig& config,
+    Server::Configuration::ResourceMonitorFactoryContext& /*unused_context*/) {
+  return std::make_unique<BufferMemoryMonitor>(config);
+}
+
+/**
+ * Static registration for the buffer memory resource monitor factory. @see RegistryFactory.
+ */
+static Registry::RegisterFactory<BufferMemoryMonitorFactory,
+                                 Server::Configuration::ResourceMonitorFactory>
+    registered_;
+
+} // namespace BufferMemoryMonitor
+} // namespace ResourceMonitors
+} // namespace Extensions
+} // namespace Envoy
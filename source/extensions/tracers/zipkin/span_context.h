@@ -1,7 +1,5 @@
 #pragma once
 
-#include <regex>
-
 #include "extensions/tracers/zipkin/util.h"
 #include "extensions/tracers/zipkin/zipkin_core_constants.h"
 #include "extensions/tracers/zipkin/zipkin_core_types.h"
@@ -24,7 +24,10 @@ public:
    * No-op for these two methods to hold back the callbacks.
    */
   void setReadBufferReady() override {}
+  void setWriteBufferReady() override {}
   void raiseEvent(Network::ConnectionEvent) override {}
+  // The wrapped socket is read and written synchronously by the wrapping one.
+  Event::IoUring* ioUring() override { return nullptr; }
 
 private:
   Network::TransportSocketCallbacks& parent_;
@@ -26,7 +26,8 @@ public:
       const std::vector<Network::Address::InstanceConstSharedPtr>& resolvers) override;
   Network::ListenerPtr createListener(Network::Socket&, Network::ListenerCallbacks&,
                                       bool bind_to_port,
-                                      bool hand_off_restored_destination_connections) override;
+                                      bool hand_off_restored_destination_connections,
+                                      uint32_t max_accepts_per_wakeup) override;
 
 protected:
   std::shared_ptr<Network::ValidationDnsResolver> dns_resolver_{
@@ -5,6 +5,7 @@
 #include "envoy/config/bootstrap/v2/bootstrap.pb.h"
 #include "envoy/config/bootstrap/v2/bootstrap.pb.validate.h"
 
+#include "common/common/regex.h"
 #include "common/common/utility.h"
 #include "common/common/version.h"
 #include "common/config/bootstrap_json.h"
@@ -73,6 +74,8 @@ void ValidationInstance::initialize(Options& options,
   InstanceUtil::loadBootstrapConfig(bootstrap, options);
 
   Config::Utility::createTagProducer(bootstrap);
+  Regex::Utility::setMaxProgramSize(PROTOBUF_GET_WRAPPED_OR_DEFAULT(
+      bootstrap, max_regex_program_size, Regex::Utility::DefaultMaxProgramSize));
 
   bootstrap.mutable_node()->set_build_version(VersionInfo::version());
 
@@ -14,8 +14,10 @@
 namespace Envoy {
 namespace Server {
 
-ConnectionHandlerImpl::ConnectionHandlerImpl(spdlog::logger& logger, Event::Dispatcher& dispatcher)
-    : logger_(logger), dispatcher_(dispatcher), disable_listeners_(false) {}
+ConnectionHandlerImpl::ConnectionHandlerImpl(spdlog::logger& logger, Event::Dispatcher& dispatcher,
+                                             absl::optional<uint32_t> worker_index)
+    : logger_(logger), dispatcher_(dispatcher), worker_index_(worker_index),
+      disable_listeners_(false) {}
 
 void ConnectionHandlerImpl::addListener(Network::ListenerConfig& config) {
   ActiveListenerPtr l(new ActiveListener(*this, config));
@@ -76,8 +78,11 @@ ConnectionHandlerImpl::ActiveListener::ActiveListener(ConnectionHandlerImpl& par
                                                       Network::ListenerConfig& config)
     : ActiveListener(
           parent,
-          parent.dispatcher_.createListener(config.socket(), *this, config.bindToPort(),
-                                            config.handOffRestoredDestinationConnections()),
+          parent.dispatcher_.createListener(
+              parent.worker_index_ ? config.workerSocket(parent.worker_index_.value())
+                                   : config.socket(),
+              *this, config.bindToPort(), config.handOffRestoredDestinationConnections(),
+              config.maxAcceptsPerWakeup()),
           config) {}
 
 ConnectionHandlerImpl::ActiveListener::ActiveListener(ConnectionHandlerImpl& parent,
@@ -85,7 +90,12 @@ ConnectionHandlerImpl::ActiveListener::ActiveListener(ConnectionHandlerImpl& par
                                                       Network::ListenerConfig& config)
     : parent_(parent), listener_(std::move(listener)),
       stats_(generateStats(config.listenerScope())), listener_tag_(config.listenerTag()),
-      config_(config) {}
+      config_(config) {
+  if (parent_.worker_index_) {
+    per_worker_stats_ = std::make_unique<PerWorkerListenerStats>(
+        generatePerWorkerStats(config.listenerScope(), parent_.worker_index_.value()));
+  }
+}
 
 ConnectionHandlerImpl::ActiveListener::~ActiveListener() {
   // Purge sockets that have not progressed to connections. This should only happen when
@@ -187,6 +197,14 @@ void ConnectionHandlerImpl::ActiveSocket::continueFilterChain(bool success) {
 
 void ConnectionHandlerImpl::ActiveListener::onAccept(
     Network::ConnectionSocketPtr&& socket, bool hand_off_restored_destination_connections) {
+  TokenBucket* rate_limiter = config_.connectionRateLimiter();
+  if (rate_limiter != nullptr && !rate_limiter->consume()) {
+    ENVOY_LOG_TO_LOGGER(parent_.logger_, debug, "closing connection: connection rate limited");
+    stats_.downstream_cx_rate_limited_.inc();
+    socket->close();
+    return;
+  }
+
   Network::Address::InstanceConstSharedPtr local_address = socket->localAddress();
   auto active_socket = std::make_unique<ActiveSocket>(*this, std::move(socket),
                                                       hand_off_restored_destination_connections);
@@ -255,11 +273,18 @@ ConnectionHandlerImpl::ActiveConnection::ActiveConnection(ActiveListener& listen
   connection_->addConnectionCallbacks(*this);
   listener_.stats_.downstream_cx_total_.inc();
   listener_.stats_.downstream_cx_active_.inc();
+  if (listener_.per_worker_stats_) {
+    listener_.per_worker_stats_->downstream_cx_total_.inc();
+    listener_.per_worker_stats_->downstream_cx_active_.inc();
+  }
 }
 
 ConnectionHandlerImpl::ActiveConnection::~ActiveConnection() {
   listener_.stats_.downstream_cx_active_.dec();
   listener_.stats_.downstream_cx_destroy_.inc();
+  if (listener_.per_worker_stats_) {
+    listener_.per_worker_stats_->downstream_cx_active_.dec();
+  }
   conn_length_->complete();
 }
 
@@ -267,5 +292,12 @@ ListenerStats ConnectionHandlerImpl::generateStats(Stats::Scope& scope) {
   return {ALL_LISTENER_STATS(POOL_COUNTER(scope), POOL_GAUGE(scope), POOL_HISTOGRAM(scope))};
 }
 
+PerWorkerListenerStats ConnectionHandlerImpl::generatePerWorkerStats(Stats::Scope& scope,
+                                                                     uint32_t worker_index) {
+  const std::string prefix = fmt::format("worker_{}.", worker_index);
+  return {ALL_PER_WORKER_LISTENER_STATS(POOL_COUNTER_PREFIX(scope, prefix),
+                                        POOL_GAUGE_PREFIX(scope, prefix))};
+}
+
 } // namespace Server
 } // namespace Envoy
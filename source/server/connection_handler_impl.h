@@ -19,6 +19,7 @@
 #include "common/common/linked_object.h"
 #include "common/common/non_copyable.h"
 
+#include "absl/types/optional.h"
 #include "spdlog/spdlog.h"
 
 namespace Envoy {
@@ -30,7 +31,8 @@ namespace Server {
   COUNTER  (downstream_cx_destroy)                                                                 \
   GAUGE    (downstream_cx_active)                                                                  \
   HISTOGRAM(downstream_cx_length_ms)                                                               \
-  COUNTER  (no_filter_chain_match)
+  COUNTER  (no_filter_chain_match)                                                                 \
+  COUNTER  (downstream_cx_rate_limited)
 // clang-format on
 
 /**
@@ -40,13 +42,34 @@ struct ListenerStats {
   ALL_LISTENER_STATS(GENERATE_COUNTER_STRUCT, GENERATE_GAUGE_STRUCT, GENERATE_HISTOGRAM_STRUCT)
 };
 
+// clang-format off
+#define ALL_PER_WORKER_LISTENER_STATS(COUNTER, GAUGE)                                              \
+  COUNTER(downstream_cx_total)                                                                     \
+  GAUGE  (downstream_cx_active)
+// clang-format on
+
+/**
+ * Wrapper struct for the stats of a listener on a single worker. @see stats_macros.h
+ */
+struct PerWorkerListenerStats {
+  ALL_PER_WORKER_LISTENER_STATS(GENERATE_COUNTER_STRUCT, GENERATE_GAUGE_STRUCT)
+};
+
 /**
  * Server side connection handler. This is used both by workers as well as the
  * main thread for non-threaded listeners.
  */
 class ConnectionHandlerImpl : public Network::ConnectionHandler, NonCopyable {
 public:
-  ConnectionHandlerImpl(spdlog::logger& logger, Event::Dispatcher& dispatcher);
+  /**
+   * @param logger supplies the logger to log connection events to.
+   * @param dispatcher supplies the dispatcher that listeners and connections run on.
+   * @param worker_index supplies the index of the worker which owns this handler, if any. Workers
+   *        accept from their own socket of listeners with a socket per worker, and keep per-worker
+   *        listener stats.
+   */
+  ConnectionHandlerImpl(spdlog::logger& logger, Event::Dispatcher& dispatcher,
+                        absl::optional<uint32_t> worker_index);
 
   // Network::ConnectionHandler
   uint64_t numConnections() override { return num_connections_; }
@@ -98,6 +121,7 @@ private:
     ConnectionHandlerImpl& parent_;
     Network::ListenerPtr listener_;
     ListenerStats stats_;
+    std::unique_ptr<PerWorkerListenerStats> per_worker_stats_;
     std::list<ActiveSocketPtr> sockets_;
     std::list<ActiveConnectionPtr> connections_;
     const uint64_t listener_tag_;
@@ -164,9 +188,11 @@ private:
   };
 
   static ListenerStats generateStats(Stats::Scope& scope);
+  static PerWorkerListenerStats generatePerWorkerStats(Stats::Scope& scope, uint32_t worker_index);
 
   spdlog::logger& logger_;
   Event::Dispatcher& dispatcher_;
+  const absl::optional<uint32_t> worker_index_;
   std::list<std::pair<Network::Address::InstanceConstSharedPtr, ActiveListenerPtr>> listeners_;
   std::atomic<uint64_t> num_connections_{};
   bool disable_listeners_;
@@ -123,7 +123,7 @@ public:
 
   // Server::HotRestart
   void drainParentListeners() override;
-  int duplicateParentListenSocket(const std::string& address) override;
+  int duplicateParentListenSocket(const std::string& address, uint32_t worker_index) override;
   void getParentStats(GetParentStatsInfo& info) override;
   void initialize(Event::Dispatcher& dispatcher, Server::Instance& server) override;
   void shutdownParentAdmin(ShutdownParentAdminInfo& info) override;
@@ -171,6 +171,7 @@ private:
                       : RpcBase(RpcMessageType::GetListenSocketRequest, sizeof(*this)) {}
 
                   char address_[256]{0};
+                  uint32_t worker_index_{0};
                 });
 
   PACKED_STRUCT(struct RpcGetListenSocketReply
@@ -3,6 +3,7 @@
 #include <algorithm>
 #include <cstdint>
 #include <fstream>
+#include <map>
 #include <regex>
 #include <string>
 #include <unordered_map>
@@ -33,6 +34,7 @@
 #include "common/common/enum_to_int.h"
 #include "common/common/fmt.h"
 #include "common/common/mutex_tracer_impl.h"
+#include "common/common/regex.h"
 #include "common/common/utility.h"
 #include "common/common/version.h"
 #include "common/html/utility.h"
@@ -51,9 +53,13 @@
 
 #include "extensions/access_loggers/file/file_access_log_impl.h"
 
+#include "absl/strings/ascii.h"
+#include "absl/strings/match.h"
 #include "absl/strings/str_join.h"
 #include "absl/strings/str_replace.h"
+#include "absl/strings/str_split.h"
 #include "absl/strings/string_view.h"
+#include "absl/strings/strip.h"
 
 // TODO(mattklein123): Switch to JSON interface methods and remove rapidjson dependency.
 #include "rapidjson/document.h"
@@ -138,6 +144,32 @@ const char AdminHtmlEnd[] = R"(
 
 const std::regex PromRegex("[^a-zA-Z0-9_]");
 
+// Splits the name of a dispatcher stat into the name of its thread and of the stat. The stats of
+// dispatchers are "server.dispatcher.<stat>" for the main thread, and
+// "server.worker_<index>.dispatcher.<stat>" for each worker. Returns false for other stats.
+bool parseDispatcherStatName(absl::string_view name, absl::string_view& thread,
+                             absl::string_view& stat) {
+  if (!absl::ConsumePrefix(&name, "server.")) {
+    return false;
+  }
+  thread = "main_thread";
+  if (absl::StartsWith(name, "worker_")) {
+    const std::pair<absl::string_view, absl::string_view> parts =
+        absl::StrSplit(name, absl::MaxSplits('.', 1));
+    const absl::string_view index = parts.first.substr(strlen("worker_"));
+    if (index.empty() || !std::all_of(index.begin(), index.end(), absl::ascii_isdigit)) {
+      return false;
+    }
+    thread = parts.first;
+    name = parts.second;
+  }
+  if (!absl::ConsumePrefix(&name, "dispatcher.") || name.empty()) {
+    return false;
+  }
+  stat = name;
+  return true;
+}
+
 void populateFallbackResponseHeaders(Http::Code code, Http::HeaderMap& header_map) {
   header_map.insertStatus().value(std::to_string(enumToInt(code)));
   const auto& headers = Http::Headers::get();
@@ -536,6 +568,33 @@ Http::Code AdminImpl::handlerMemory(absl::string_view, Http::HeaderMap& response
   return Http::Code::OK;
 }
 
+Http::Code AdminImpl::handlerWorkers(absl::string_view, Http::HeaderMap&,
+                                     Buffer::Instance& response, AdminStream&) {
+  // The dispatcher stats of each thread, by the name of the thread and then of the stat.
+  std::map<std::string, std::map<std::string, std::string>> threads;
+  auto add_stat = [&threads](const std::string& name, const std::string& value) -> void {
+    absl::string_view thread;
+    absl::string_view stat;
+    if (parseDispatcherStatName(name, thread, stat)) {
+      threads[std::string(thread)][std::string(stat)] = value;
+    }
+  };
+  for (const Stats::CounterSharedPtr& counter : server_.stats().counters()) {
+    add_stat(counter->name(), std::to_string(counter->value()));
+  }
+  for (const Stats::ParentHistogramSharedPtr& histogram : server_.stats().histograms()) {
+    add_stat(histogram->name(), histogram->summary());
+  }
+
+  for (const auto& thread : threads) {
+    response.add(fmt::format("{}:\n", thread.first));
+    for (const auto& stat : thread.second) {
+      response.add(fmt::format("  {}: {}\n", stat.first, stat.second));
+    }
+  }
+  return Http::Code::OK;
+}
+
 Http::Code AdminImpl::handlerResetCounters(absl::string_view, Http::HeaderMap&,
                                            Buffer::Instance& response, AdminStream&) {
   for (const Stats::CounterSharedPtr& counter : server_.stats().counters()) {
@@ -570,20 +629,25 @@ Http::Code AdminImpl::handlerStats(absl::string_view url, Http::HeaderMap& respo
 
   const bool used_only = params.find("usedonly") != params.end();
   const bool has_format = !(params.find("format") == params.end());
-  const absl::optional<std::regex> regex =
-      (params.find("filter") != params.end())
-          ? absl::optional<std::regex>{std::regex(params.at("filter"))}
-          : absl::nullopt;
+  Regex::CompiledMatcherPtr regex;
+  if (params.find("filter") != params.end()) {
+    try {
+      regex = Regex::Utility::parseRegex(params.at("filter"));
+    } catch (const EnvoyException& e) {
+      response.add(fmt::format("{}\n", e.what()));
+      return Http::Code::BadRequest;
+    }
+  }
 
   std::map<std::string, uint64_t> all_stats;
   for (const Stats::CounterSharedPtr& counter : server_.stats().counters()) {
-    if (shouldShowMetric(counter, used_only, regex)) {
+    if (shouldShowMetric(counter, used_only, regex.get())) {
       all_stats.emplace(counter->name(), counter->value());
     }
   }
 
   for (const Stats::GaugeSharedPtr& gauge : server_.stats().gauges()) {
-    if (shouldShowMetric(gauge, used_only, regex)) {
+    if (shouldShowMetric(gauge, used_only, regex.get())) {
       all_stats.emplace(gauge->name(), gauge->value());
     }
   }
@@ -593,8 +657,8 @@ Http::Code AdminImpl::handlerStats(absl::string_view url, Http::HeaderMap& respo
     if (format_value == "json") {
       response_headers.insertContentType().value().setReference(
           Http::Headers::get().ContentTypeValues.Json);
-      response.add(
-          AdminImpl::statsAsJson(all_stats, server_.stats().histograms(), used_only, regex));
+      response.add(AdminImpl::statsAsJson(all_stats, server_.stats().histograms(), used_only,
+                                          regex.get()));
     } else if (format_value == "prometheus") {
       return handlerPrometheusStats(url, response_headers, response, admin_stream);
     } else {
@@ -611,7 +675,7 @@ Http::Code AdminImpl::handlerStats(absl::string_view url, Http::HeaderMap& respo
     // implemented this can be switched back to a normal map.
     std::multimap<std::string, std::string> all_histograms;
     for (const Stats::ParentHistogramSharedPtr& histogram : server_.stats().histograms()) {
-      if (shouldShowMetric(histogram, used_only, regex)) {
+      if (shouldShowMetric(histogram, used_only, regex.get())) {
         all_histograms.emplace(histogram->name(), histogram->summary());
       }
     }
@@ -686,7 +750,7 @@ PrometheusStatsFormatter::statsAsPrometheus(const std::vector<Stats::CounterShar
 std::string
 AdminImpl::statsAsJson(const std::map<std::string, uint64_t>& all_stats,
                        const std::vector<Stats::ParentHistogramSharedPtr>& all_histograms,
-                       const bool used_only, const absl::optional<std::regex> regex,
+                       const bool used_only, const Regex::CompiledMatcher* regex,
                        const bool pretty_print) {
   rapidjson::Document document;
   document.SetObject();
@@ -1005,6 +1069,8 @@ AdminImpl::AdminImpl(const std::string& profile_path, Server::Instance& server)
           {"/runtime", "print runtime values", MAKE_ADMIN_HANDLER(handlerRuntime), false, false},
           {"/runtime_modify", "modify runtime values", MAKE_ADMIN_HANDLER(handlerRuntimeModify),
            false, true},
+          {"/workers", "print event loop stats of the main thread and each worker",
+           MAKE_ADMIN_HANDLER(handlerWorkers), false, false},
       },
       date_provider_(server.dispatcher().timeSystem()),
       admin_filter_chain_(std::make_shared<AdminFilterChain>()) {}
@@ -8,6 +8,7 @@
 #include <vector>
 
 #include "envoy/admin/v2alpha/clusters.pb.h"
+#include "envoy/common/regex.h"
 #include "envoy/http/filter.h"
 #include "envoy/network/filter.h"
 #include "envoy/network/listen_socket.h"
@@ -178,14 +179,12 @@ private:
   void writeClustersAsText(Buffer::Instance& response);
 
   static bool shouldShowMetric(const std::shared_ptr<Stats::Metric>& metric, const bool used_only,
-                               const absl::optional<std::regex>& regex) {
-    return ((!used_only || metric->used()) &&
-            (!regex.has_value() || std::regex_search(metric->name(), regex.value())));
+                               const Regex::CompiledMatcher* regex) {
+    return ((!used_only || metric->used()) && (regex == nullptr || regex->search(metric->name())));
   }
   static std::string statsAsJson(const std::map<std::string, uint64_t>& all_stats,
                                  const std::vector<Stats::ParentHistogramSharedPtr>& all_histograms,
-                                 bool used_only,
-                                 const absl::optional<std::regex> regex = absl::nullopt,
+                                 bool used_only, const Regex::CompiledMatcher* regex = nullptr,
                                  bool pretty_print = false);
   static std::string
   runtimeAsJson(const std::vector<std::pair<std::string, Runtime::Snapshot::Entry>>& entries);
@@ -245,6 +244,8 @@ private:
   Http::Code handlerRuntimeModify(absl::string_view path_and_query,
                                   Http::HeaderMap& response_headers, Buffer::Instance& response,
                                   AdminStream&);
+  Http::Code handlerWorkers(absl::string_view path_and_query, Http::HeaderMap& response_headers,
+                            Buffer::Instance& response, AdminStream&);
 
   class AdminListener : public Network::ListenerConfig {
   public:
@@ -256,9 +257,12 @@ private:
     Network::FilterChainManager& filterChainManager() override { return parent_; }
     Network::FilterChainFactory& filterChainFactory() override { return parent_; }
     Network::Socket& socket() override { return parent_.mutable_socket(); }
+    Network::Socket& workerSocket(uint32_t) override { return socket(); }
     bool bindToPort() override { return true; }
     bool handOffRestoredDestinationConnections() const override { return false; }
     uint32_t perConnectionBufferLimitBytes() override { return 0; }
+    uint32_t maxAcceptsPerWakeup() const override { return 0; }
+    TokenBucket* connectionRateLimiter() override { return nullptr; }
     Stats::Scope& listenerScope() override { return *scope_; }
     uint64_t listenerTag() const override { return 0; }
     const std::string& name() const override { return name_; }
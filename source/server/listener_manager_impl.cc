@@ -9,10 +9,12 @@
 #include "common/common/assert.h"
 #include "common/common/empty_string.h"
 #include "common/common/fmt.h"
+#include "common/common/shared_token_bucket_impl.h"
 #include "common/config/utility.h"
 #include "common/network/listen_socket_impl.h"
 #include "common/network/resolver_impl.h"
 #include "common/network/socket_option_factory.h"
+#include "common/network/socket_option_impl.h"
 #include "common/network/utility.h"
 #include "common/protobuf/utility.h"
 
@@ -86,15 +88,15 @@ ProdListenerComponentFactory::createListenerFilterFactoryList_(
 Network::SocketSharedPtr
 ProdListenerComponentFactory::createListenSocket(Network::Address::InstanceConstSharedPtr address,
                                                  const Network::Socket::OptionsSharedPtr& options,
-                                                 bool bind_to_port) {
+                                                 bool bind_to_port, uint32_t worker_index) {
   ASSERT(address->type() == Network::Address::Type::Ip ||
          address->type() == Network::Address::Type::Pipe);
 
-  // For each listener config we share a single socket among all threaded listeners.
-  // First we try to get the socket from our parent if applicable.
+  // Unless the listener has a socket per worker, we share a single socket among all threaded
+  // listeners. First we try to get the socket from our parent if applicable.
   if (address->type() == Network::Address::Type::Pipe) {
     const std::string addr = fmt::format("unix://{}", address->asString());
-    const int fd = server_.hotRestart().duplicateParentListenSocket(addr);
+    const int fd = server_.hotRestart().duplicateParentListenSocket(addr, worker_index);
     if (fd != -1) {
       ENVOY_LOG(debug, "obtained socket for address {} from parent", addr);
       return std::make_shared<Network::UdsListenSocket>(fd, address);
@@ -103,14 +105,28 @@ ProdListenerComponentFactory::createListenSocket(Network::Address::InstanceConst
   }
 
   const std::string addr = fmt::format("tcp://{}", address->asString());
-  const int fd = server_.hotRestart().duplicateParentListenSocket(addr);
+  const int fd = server_.hotRestart().duplicateParentListenSocket(addr, worker_index);
   if (fd != -1) {
-    ENVOY_LOG(debug, "obtained socket for address {} from parent", addr);
+    ENVOY_LOG(debug, "obtained socket {} for address {} from parent", worker_index, addr);
     return std::make_shared<Network::TcpListenSocket>(fd, address, options);
   }
   return std::make_shared<Network::TcpListenSocket>(address, options, bind_to_port);
 }
 
+bool ProdListenerComponentFactory::hasParentListenSocket(
+    Network::Address::InstanceConstSharedPtr address, uint32_t worker_index) {
+  const std::string addr = address->type() == Network::Address::Type::Pipe
+                               ? fmt::format("unix://{}", address->asString())
+                               : fmt::format("tcp://{}", address->asString());
+  const int fd = server_.hotRestart().duplicateParentListenSocket(addr, worker_index);
+  if (fd == -1) {
+    return false;
+  }
+  // Only the answer is needed. Closing the duplicate leaves the parent's socket open.
+  Api::OsSysCallsSingleton::get().close(fd);
+  return true;
+}
+
 DrainManagerPtr
 ProdListenerComponentFactory::createDrainManager(envoy::api::v2::Listener::DrainType drain_type) {
   return DrainManagerPtr{new DrainManagerImpl(server_, drain_type)};
@@ -124,10 +140,13 @@ ListenerImpl::ListenerImpl(const envoy::api::v2::Listener& config, const std::st
       listener_scope_(
           parent_.server_.stats().createScope(fmt::format("listener.{}.", address_->asString()))),
       bind_to_port_(PROTOBUF_GET_WRAPPED_OR_DEFAULT(config.deprecated_v1(), bind_to_port, true)),
+      reuse_port_(config.reuse_port() && bind_to_port_ &&
+                  address_->type() == Network::Address::Type::Ip),
       hand_off_restored_destination_connections_(
           PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, use_original_dst, false)),
       per_connection_buffer_limit_bytes_(
           PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, per_connection_buffer_limit_bytes, 1024 * 1024)),
+      max_accepts_per_wakeup_(PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, max_accepts_per_wakeup, 0)),
       listener_tag_(parent_.factory_.nextListenerTag()), name_(name),
       reverse_write_filter_order_(
           PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, bugfix_reverse_write_filter_order, true)),
@@ -144,6 +163,16 @@ ListenerImpl::ListenerImpl(const envoy::api::v2::Listener& config, const std::st
     addListenSocketOptions(Network::SocketOptionFactory::buildTcpFastOpenOptions(
         config.tcp_fast_open_queue_length().value()));
   }
+  if (reuse_port_) {
+    addListenSocketOptions(Network::SocketOptionFactory::buildReusePortOptions());
+  }
+  if (config.has_connection_rate_limit()) {
+    const auto& rate_limit = config.connection_rate_limit();
+    const uint32_t max_burst = rate_limit.max_burst() > 0 ? rate_limit.max_burst()
+                                                          : rate_limit.connections_per_second();
+    connection_rate_limiter_ = std::make_unique<SharedTokenBucketImpl>(
+        max_burst, parent_.time_source_, rate_limit.connections_per_second());
+  }
 
   if (config.socket_options().size() > 0) {
     addListenSocketOptions(
@@ -550,13 +579,17 @@ Init::Manager& ListenerImpl::initManager() {
   }
 }
 
-void ListenerImpl::setSocket(const Network::SocketSharedPtr& socket) {
-  ASSERT(!socket_);
-  socket_ = socket;
-  // Server config validation sets nullptr sockets.
-  if (socket_ && listen_socket_options_) {
+void ListenerImpl::setSockets(const std::vector<Network::SocketSharedPtr>& sockets) {
+  ASSERT(sockets_.empty());
+  ASSERT(!sockets.empty());
+  sockets_ = sockets;
+  for (const Network::SocketSharedPtr& socket : sockets_) {
+    // Server config validation sets nullptr sockets.
+    if (!socket || !listen_socket_options_) {
+      continue;
+    }
     // 'pre_bind = false' as bind() is never done after this.
-    bool ok = Network::Socket::applyOptions(listen_socket_options_, *socket_,
+    bool ok = Network::Socket::applyOptions(listen_socket_options_, *socket,
                                             envoy::api::v2::core::SocketOption::STATE_BOUND);
     const std::string message =
         fmt::format("{}: Setting socket options {}", name_, ok ? "succeeded" : "failed");
@@ -567,9 +600,9 @@ void ListenerImpl::setSocket(const Network::SocketSharedPtr& socket) {
       ENVOY_LOG(debug, "{}", message);
     }
 
-    // Add the options to the socket_ so that STATE_LISTENING options can be
+    // Add the options to the socket so that STATE_LISTENING options can be
     // set in the worker after listen()/evconnlistener_new() is called.
-    socket_->addOptions(listen_socket_options_);
+    socket->addOptions(listen_socket_options_);
   }
 }
 
@@ -581,7 +614,7 @@ ListenerManagerImpl::ListenerManagerImpl(Instance& server,
       config_tracker_entry_(server.admin().getConfigTracker().add(
           "listeners", [this] { return dumpListenerConfigs(); })) {
   for (uint32_t i = 0; i < server.options().concurrency(); i++) {
-    workers_.emplace_back(worker_factory.createWorker(server.overloadManager()));
+    workers_.emplace_back(worker_factory.createWorker(i, server.overloadManager()));
   }
 }
 
@@ -671,17 +704,30 @@ bool ListenerManagerImpl::addOrUpdateListener(const envoy::api::v2::Listener& co
     throw EnvoyException(message);
   }
 
+  // Likewise, the existing sockets are either shared by all workers or per worker, and can only be
+  // reused by a listener which uses them the same way.
+  if ((existing_warming_listener != warming_listeners_.end() &&
+       (*existing_warming_listener)->reusePort() != new_listener->reusePort()) ||
+      (existing_active_listener != active_listeners_.end() &&
+       (*existing_active_listener)->reusePort() != new_listener->reusePort())) {
+    const std::string message = fmt::format(
+        "error updating listener: '{}' has a different reuse_port setting from existing listener",
+        name);
+    ENVOY_LOG(warn, "{}", message);
+    throw EnvoyException(message);
+  }
+
   bool added = false;
   if (existing_warming_listener != warming_listeners_.end()) {
     // In this case we can just replace inline.
     ASSERT(workers_started_);
     new_listener->debugLog("update warming listener");
-    new_listener->setSocket((*existing_warming_listener)->getSocket());
+    new_listener->setSockets((*existing_warming_listener)->getSockets());
     *existing_warming_listener = std::move(new_listener);
   } else if (existing_active_listener != active_listeners_.end()) {
     // In this case we have no warming listener, so what we do depends on whether workers
     // have been started or not. Either way we get the socket from the existing listener.
-    new_listener->setSocket((*existing_active_listener)->getSocket());
+    new_listener->setSockets((*existing_active_listener)->getSockets());
     if (workers_started_) {
       new_listener->debugLog("add warming listener");
       warming_listeners_.emplace_back(std::move(new_listener));
@@ -710,21 +756,16 @@ bool ListenerManagerImpl::addOrUpdateListener(const envoy::api::v2::Listener& co
     // to see if there is a listener that has a socket bound to the address we are configured for.
     // This is an edge case, but may happen if a listener is removed and then added back with a same
     // or different name and intended to listen on the same address. This should work and not fail.
-    Network::SocketSharedPtr draining_listener_socket;
     auto existing_draining_listener = std::find_if(
         draining_listeners_.cbegin(), draining_listeners_.cend(),
         [&new_listener](const DrainingListener& listener) {
-          return *new_listener->address() == *listener.listener_->socket().localAddress();
+          return *new_listener->address() == *listener.listener_->socket().localAddress() &&
+                 new_listener->reusePort() == listener.listener_->reusePort();
         });
-    if (existing_draining_listener != draining_listeners_.cend()) {
-      draining_listener_socket = existing_draining_listener->listener_->getSocket();
-    }
 
-    new_listener->setSocket(draining_listener_socket
-                                ? draining_listener_socket
-                                : factory_.createListenSocket(new_listener->address(),
-                                                              new_listener->listenSocketOptions(),
-                                                              new_listener->bindToPort()));
+    new_listener->setSockets(existing_draining_listener != draining_listeners_.cend()
+                                 ? existing_draining_listener->listener_->getSockets()
+                                 : createListenSockets(*new_listener));
     if (workers_started_) {
       new_listener->debugLog("add warming listener");
       warming_listeners_.emplace_back(std::move(new_listener));
@@ -747,6 +788,54 @@ bool ListenerManagerImpl::addOrUpdateListener(const envoy::api::v2::Listener& co
   return true;
 }
 
+std::vector<Network::SocketSharedPtr>
+ListenerManagerImpl::createListenSockets(ListenerImpl& listener) {
+  std::vector<Network::SocketSharedPtr> sockets;
+  sockets.push_back(factory_.createListenSocket(
+      listener.address(), listener.listenSocketOptions(), listener.bindToPort(), 0));
+  if (!listener.reusePort() || sockets[0] == nullptr) {
+    return sockets;
+  }
+
+  // A hot restart parent whose listener doesn't use reuse_port hands over a socket without
+  // SO_REUSEPORT, and the sockets of the other workers couldn't be bound to its address.
+  if (workers_.size() > 1 && !hasReusePort(*sockets[0])) {
+    throw EnvoyException(fmt::format("error adding listener '{}': reuse_port can't be enabled "
+                                     "while the parent process listens on {} without it",
+                                     listener.name(), sockets[0]->localAddress()->asString()));
+  }
+
+  // The remaining sockets are bound to the address of the first, so that they share the port the
+  // kernel picked if the listener is configured with port 0.
+  for (uint32_t i = 1; i < workers_.size(); i++) {
+    sockets.push_back(factory_.createListenSocket(sockets[0]->localAddress(),
+                                                  listener.listenSocketOptions(), true, i));
+  }
+
+  // The kernel keeps spreading connections across every socket bound with SO_REUSEPORT. If a hot
+  // restart parent has reuse_port sockets for more workers than we take over, nothing would accept
+  // from the extra ones once it drains, and the connections queued on them would be lost.
+  if (factory_.hasParentListenSocket(sockets[0]->localAddress(), sockets.size())) {
+    throw EnvoyException(fmt::format("error adding listener '{}': the parent process has more "
+                                     "reuse_port sockets than the {} this process takes over",
+                                     listener.name(), sockets.size()));
+  }
+  return sockets;
+}
+
+bool ListenerManagerImpl::hasReusePort(const Network::Socket& socket) {
+  if (!ENVOY_SOCKET_SO_REUSEPORT.has_value()) {
+    // Setting the option has already failed in this case.
+    return false;
+  }
+  int value = 0;
+  socklen_t size = sizeof(value);
+  const Api::SysCallIntResult result = Api::OsSysCallsSingleton::get().getsockopt(
+      socket.fd(), ENVOY_SOCKET_SO_REUSEPORT.value().first,
+      ENVOY_SOCKET_SO_REUSEPORT.value().second, &value, &size);
+  return result.rc_ == 0 && value != 0;
+}
+
 bool ListenerManagerImpl::hasListenerWithAddress(const ListenerList& list,
                                                  const Network::Address::Instance& address) {
   for (const auto& listener : list) {
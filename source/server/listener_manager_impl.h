@@ -62,7 +62,9 @@ public:
   }
   Network::SocketSharedPtr createListenSocket(Network::Address::InstanceConstSharedPtr address,
                                               const Network::Socket::OptionsSharedPtr& options,
-                                              bool bind_to_port) override;
+                                              bool bind_to_port, uint32_t worker_index) override;
+  bool hasParentListenSocket(Network::Address::InstanceConstSharedPtr address,
+                             uint32_t worker_index) override;
   DrainManagerPtr createDrainManager(envoy::api::v2::Listener::DrainType drain_type) override;
   uint64_t nextListenerTag() override { return next_listener_tag_++; }
 
@@ -138,6 +140,8 @@ private:
   void addListenerToWorker(Worker& worker, ListenerImpl& listener);
   ProtobufTypes::MessagePtr dumpListenerConfigs();
   static ListenerManagerStats generateStats(Stats::Scope& scope);
+  std::vector<Network::SocketSharedPtr> createListenSockets(ListenerImpl& listener);
+  static bool hasReusePort(const Network::Socket& socket);
   static bool hasListenerWithAddress(const ListenerList& list,
                                      const Network::Address::Instance& address);
   void updateWarmingActiveGauges() {
@@ -227,11 +231,16 @@ public:
 
   Network::Address::InstanceConstSharedPtr address() const { return address_; }
   const envoy::api::v2::Listener& config() { return config_; }
-  const Network::SocketSharedPtr& getSocket() const { return socket_; }
+  const std::vector<Network::SocketSharedPtr>& getSockets() const { return sockets_; }
   void debugLog(const std::string& message);
   void initialize();
   DrainManager& localDrainManager() const { return *local_drain_manager_; }
-  void setSocket(const Network::SocketSharedPtr& socket);
+  bool reusePort() const { return reuse_port_; }
+  /**
+   * Set the listen sockets. There is a single socket shared by all workers, unless reusePort() is
+   * set, in which case there is one socket per worker, in worker order.
+   */
+  void setSockets(const std::vector<Network::SocketSharedPtr>& sockets);
   void setSocketAndOptions(const Network::SocketSharedPtr& socket);
   const Network::Socket::OptionsSharedPtr& listenSocketOptions() { return listen_socket_options_; }
   const std::string& versionInfo() { return version_info_; }
@@ -239,12 +248,17 @@ public:
   // Network::ListenerConfig
   Network::FilterChainManager& filterChainManager() override { return *this; }
   Network::FilterChainFactory& filterChainFactory() override { return *this; }
-  Network::Socket& socket() override { return *socket_; }
+  Network::Socket& socket() override { return *sockets_[0]; }
+  Network::Socket& workerSocket(uint32_t worker_index) override {
+    return *sockets_[worker_index < sockets_.size() ? worker_index : 0];
+  }
   bool bindToPort() override { return bind_to_port_; }
   bool handOffRestoredDestinationConnections() const override {
     return hand_off_restored_destination_connections_;
   }
   uint32_t perConnectionBufferLimitBytes() override { return per_connection_buffer_limit_bytes_; }
+  uint32_t maxAcceptsPerWakeup() const override { return max_accepts_per_wakeup_; }
+  TokenBucket* connectionRateLimiter() override { return connection_rate_limiter_.get(); }
   Stats::Scope& listenerScope() override { return *listener_scope_; }
   uint64_t listenerTag() const override { return listener_tag_; }
   const std::string& name() const override { return name_; }
@@ -370,12 +384,16 @@ private:
 
   ListenerManagerImpl& parent_;
   Network::Address::InstanceConstSharedPtr address_;
-  Network::SocketSharedPtr socket_;
+  std::vector<Network::SocketSharedPtr> sockets_;
   Stats::ScopePtr global_scope_;   // Stats with global named scope, but needed for LDS cleanup.
   Stats::ScopePtr listener_scope_; // Stats with listener named scope.
   const bool bind_to_port_;
+  const bool reuse_port_;
   const bool hand_off_restored_destination_connections_;
   const uint32_t per_connection_buffer_limit_bytes_;
+  const uint32_t max_accepts_per_wakeup_;
+  // Shared by the workers, so it must be thread safe.
+  TokenBucketPtr connection_rate_limiter_;
   const uint64_t listener_tag_;
   const std::string name_;
   const bool reverse_write_filter_order_;
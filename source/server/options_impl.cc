@@ -120,6 +120,18 @@ OptionsImpl::OptionsImpl(int argc, const char* const* argv,
                                        "Disable hot restart functionality", cmd, false);
   TCLAP::SwitchArg enable_mutex_tracing(
       "", "enable-mutex-tracing", "Enable mutex contention tracing functionality", cmd, false);
+  TCLAP::SwitchArg use_libevent_buffers(
+      "", "use-libevent-buffers", "Use the libevent evbuffer implementation for buffers", cmd,
+      false);
+  TCLAP::SwitchArg use_list_header_maps(
+      "", "use-list-header-maps", "Use std::list storage for the entries of HTTP header maps", cmd,
+      false);
+  TCLAP::SwitchArg use_simd_http1_parser(
+      "", "use-simd-http1-parser", "Parse HTTP/1 with the SIMD parser instead of http_parser", cmd,
+      false);
+  TCLAP::SwitchArg use_io_uring("", "use-io-uring",
+                                "Read and write sockets through io_uring where the kernel has it",
+                                cmd, false);
 
   cmd.setExceptionHandling(false);
   try {
@@ -157,6 +169,14 @@ OptionsImpl::OptionsImpl(int argc, const char* const* argv,
 
   mutex_tracing_enabled_ = enable_mutex_tracing.getValue();
 
+  libevent_buffers_enabled_ = use_libevent_buffers.getValue();
+
+  list_header_maps_enabled_ = use_list_header_maps.getValue();
+
+  simd_http1_parser_enabled_ = use_simd_http1_parser.getValue();
+
+  io_uring_enabled_ = use_io_uring.getValue();
+
   log_level_ = default_log_level;
   for (size_t i = 0; i < ARRAY_SIZE(spdlog::level::level_names); i++) {
     if (log_level.getValue() == spdlog::level::level_names[i]) {
@@ -262,6 +282,8 @@ OptionsImpl::OptionsImpl(const std::string& service_cluster, const std::string&
       service_cluster_(service_cluster), service_node_(service_node), service_zone_(service_zone),
       file_flush_interval_msec_(10000), drain_time_(600), parent_shutdown_time_(900),
       mode_(Server::Mode::Serve), max_stats_(ENVOY_DEFAULT_MAX_STATS), hot_restart_disabled_(false),
-      signal_handling_enabled_(true), mutex_tracing_enabled_(false) {}
+      signal_handling_enabled_(true), mutex_tracing_enabled_(false),
+      libevent_buffers_enabled_(false), list_header_maps_enabled_(false),
+      simd_http1_parser_enabled_(false), io_uring_enabled_(false) {}
 
 } // namespace Envoy
@@ -74,6 +74,16 @@ public:
   void setSignalHandling(bool signal_handling_enabled) {
     signal_handling_enabled_ = signal_handling_enabled;
   }
+  void setLibeventBuffersEnabled(bool libevent_buffers_enabled) {
+    libevent_buffers_enabled_ = libevent_buffers_enabled;
+  }
+  void setListHeaderMapsEnabled(bool list_header_maps_enabled) {
+    list_header_maps_enabled_ = list_header_maps_enabled;
+  }
+  void setSimdHttp1ParserEnabled(bool simd_http1_parser_enabled) {
+    simd_http1_parser_enabled_ = simd_http1_parser_enabled;
+  }
+  void setIoUringEnabled(bool io_uring_enabled) { io_uring_enabled_ = io_uring_enabled; }
 
   // Server::Options
   uint64_t baseId() const override { return base_id_; }
@@ -107,6 +117,10 @@ public:
   bool hotRestartDisabled() const override { return hot_restart_disabled_; }
   bool signalHandlingEnabled() const override { return signal_handling_enabled_; }
   bool mutexTracingEnabled() const override { return mutex_tracing_enabled_; }
+  bool libeventBuffersEnabled() const override { return libevent_buffers_enabled_; }
+  bool listHeaderMapsEnabled() const override { return list_header_maps_enabled_; }
+  bool simdHttp1ParserEnabled() const override { return simd_http1_parser_enabled_; }
+  bool ioUringEnabled() const override { return io_uring_enabled_; }
 
 private:
   void parseComponentLogLevels(const std::string& component_log_levels);
@@ -136,6 +150,10 @@ private:
   bool hot_restart_disabled_;
   bool signal_handling_enabled_;
   bool mutex_tracing_enabled_;
+  bool libevent_buffers_enabled_;
+  bool list_header_maps_enabled_;
+  bool simd_http1_parser_enabled_;
+  bool io_uring_enabled_;
 
   friend class OptionsImplTest;
 };
@@ -21,6 +21,7 @@
 #include "common/api/api_impl.h"
 #include "common/api/os_sys_calls_impl.h"
 #include "common/common/mutex_tracer_impl.h"
+#include "common/common/regex.h"
 #include "common/common/utility.h"
 #include "common/common/version.h"
 #include "common/config/bootstrap_json.h"
@@ -57,9 +58,9 @@ InstanceImpl::InstanceImpl(Options& options, Event::TimeSystem& time_system,
       secret_manager_(std::make_unique<Secret::SecretManagerImpl>()),
       dispatcher_(api_->allocateDispatcher(time_system)),
       singleton_manager_(new Singleton::ManagerImpl()),
-      handler_(new ConnectionHandlerImpl(ENVOY_LOGGER(), *dispatcher_)),
+      handler_(new ConnectionHandlerImpl(ENVOY_LOGGER(), *dispatcher_, absl::nullopt)),
       random_generator_(std::move(random_generator)), listener_component_factory_(*this),
-      worker_factory_(thread_local_, *api_, hooks, time_system),
+      worker_factory_(thread_local_, *api_, hooks, time_system, store),
       dns_resolver_(dispatcher_->createDnsResolver({})),
       access_log_manager_(*api_, *dispatcher_, access_log_lock, store), terminated_(false),
       mutex_tracer_(options.mutexTracingEnabled() ? &Envoy::MutexTracerImpl::getOrCreateTracer()
@@ -236,6 +237,11 @@ void InstanceImpl::initialize(Options& options,
   // stats.
   stats_store_.setTagProducer(Config::Utility::createTagProducer(bootstrap_));
   stats_store_.setStatsMatcher(Config::Utility::createStatsMatcher(bootstrap_));
+  stats_store_.setShardedHistograms(bootstrap_.stats_config().sharded_histograms());
+
+  // Regexes are compiled as configuration is loaded, so their limit must be set before that.
+  Regex::Utility::setMaxProgramSize(PROTOBUF_GET_WRAPPED_OR_DEFAULT(
+      bootstrap_, max_regex_program_size, Regex::Utility::DefaultMaxProgramSize));
 
   server_stats_ = std::make_unique<ServerStats>(
       ServerStats{ALL_SERVER_STATS(POOL_GAUGE_PREFIX(stats_store_, "server."))});
@@ -297,6 +303,7 @@ void InstanceImpl::initialize(Options& options,
 
   // We can now initialize stats for threading.
   stats_store_.initializeThreading(*dispatcher_, thread_local_);
+  dispatcher_->initializeStats(stats_store_, "server.");
 
   // Runtime gets initialized before the main configuration since during main configuration
   // load things may grab a reference to the loader for later use.
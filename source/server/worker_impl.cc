@@ -1,5 +1,6 @@
 #include "server/worker_impl.h"
 
+#include <chrono>
 #include <functional>
 #include <memory>
 
@@ -8,6 +9,7 @@
 #include "envoy/server/configuration.h"
 #include "envoy/thread_local/thread_local.h"
 
+#include "common/common/fmt.h"
 #include "common/common/thread.h"
 
 #include "server/connection_handler_impl.h"
@@ -15,18 +17,34 @@
 namespace Envoy {
 namespace Server {
 
-WorkerPtr ProdWorkerFactory::createWorker(OverloadManager& overload_manager) {
+namespace {
+
+// How often each worker publishes its buffer stats. Publishing is kept off the allocation path.
+constexpr std::chrono::milliseconds BufferStatsInterval{1000};
+
+Buffer::SliceAllocatorStats generateBufferStats(Stats::Scope& scope, uint32_t index) {
+  const std::string prefix = fmt::format("server.worker_{}.buffer.", index);
+  return {ALL_SLICE_ALLOCATOR_STATS(POOL_COUNTER_PREFIX(scope, prefix),
+                                    POOL_GAUGE_PREFIX(scope, prefix))};
+}
+
+} // namespace
+
+WorkerPtr ProdWorkerFactory::createWorker(uint32_t index, OverloadManager& overload_manager) {
   Event::DispatcherPtr dispatcher(api_.allocateDispatcher(time_system_));
   return WorkerPtr{new WorkerImpl(
       tls_, hooks_, std::move(dispatcher),
-      Network::ConnectionHandlerPtr{new ConnectionHandlerImpl(ENVOY_LOGGER(), *dispatcher)},
-      overload_manager)};
+      Network::ConnectionHandlerPtr{new ConnectionHandlerImpl(ENVOY_LOGGER(), *dispatcher, index)},
+      overload_manager, stats_scope_, index)};
 }
 
 WorkerImpl::WorkerImpl(ThreadLocal::Instance& tls, TestHooks& hooks,
                        Event::DispatcherPtr&& dispatcher, Network::ConnectionHandlerPtr handler,
-                       OverloadManager& overload_manager)
-    : tls_(tls), hooks_(hooks), dispatcher_(std::move(dispatcher)), handler_(std::move(handler)) {
+                       OverloadManager& overload_manager, Stats::Scope& stats_scope,
+                       uint32_t index)
+    : tls_(tls), hooks_(hooks), dispatcher_(std::move(dispatcher)), handler_(std::move(handler)),
+      buffer_stats_(generateBufferStats(stats_scope, index)) {
+  dispatcher_->initializeStats(stats_scope, fmt::format("server.worker_{}.", index));
   tls_.registerThread(*dispatcher_, false);
   overload_manager.registerForAction(
       OverloadActionNames::get().StopAcceptingConnections, *dispatcher_,
@@ -96,6 +114,15 @@ void WorkerImpl::stopListeners() {
 
 void WorkerImpl::threadRoutine(GuardDog& guard_dog) {
   ENVOY_LOG(debug, "worker entering dispatch loop");
+  Buffer::SliceAllocator& allocator = Buffer::SliceAllocator::threadLocal();
+  allocator.setStats(&buffer_stats_);
+  buffer_stats_timer_ = dispatcher_->createTimer(
+      [this, &allocator]() -> void {
+        allocator.publishStats();
+        buffer_stats_timer_->enableTimer(BufferStatsInterval);
+      },
+      Event::TimerResolution::Coarse);
+  buffer_stats_timer_->enableTimer(BufferStatsInterval);
   auto watchdog = guard_dog.createWatchDog(Thread::Thread::currentThreadId());
   watchdog->startWatchdog(*dispatcher_);
   dispatcher_->run(Event::Dispatcher::RunType::Block);
@@ -109,6 +136,8 @@ void WorkerImpl::threadRoutine(GuardDog& guard_dog) {
   handler_.reset();
   tls_.shutdownThread();
   watchdog.reset();
+  buffer_stats_timer_.reset();
+  allocator.setStats(nullptr);
 }
 
 void WorkerImpl::stopAcceptingConnectionsCb(OverloadActionState state) {
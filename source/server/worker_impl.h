@@ -4,12 +4,15 @@
 #include <memory>
 
 #include "envoy/api/api.h"
+#include "envoy/event/timer.h"
 #include "envoy/network/connection_handler.h"
 #include "envoy/server/guarddog.h"
 #include "envoy/server/listener_manager.h"
 #include "envoy/server/worker.h"
+#include "envoy/stats/scope.h"
 #include "envoy/thread_local/thread_local.h"
 
+#include "common/buffer/slice_allocator.h"
 #include "common/common/logger.h"
 #include "common/common/thread.h"
 
@@ -21,17 +24,19 @@ namespace Server {
 class ProdWorkerFactory : public WorkerFactory, Logger::Loggable<Logger::Id::main> {
 public:
   ProdWorkerFactory(ThreadLocal::Instance& tls, Api::Api& api, TestHooks& hooks,
-                    Event::TimeSystem& time_system)
-      : tls_(tls), api_(api), hooks_(hooks), time_system_(time_system) {}
+                    Event::TimeSystem& time_system, Stats::Scope& stats_scope)
+      : tls_(tls), api_(api), hooks_(hooks), time_system_(time_system), stats_scope_(stats_scope) {
+  }
 
   // Server::WorkerFactory
-  WorkerPtr createWorker(OverloadManager& overload_manager) override;
+  WorkerPtr createWorker(uint32_t index, OverloadManager& overload_manager) override;
 
 private:
   ThreadLocal::Instance& tls_;
   Api::Api& api_;
   TestHooks& hooks_;
   Event::TimeSystem& time_system_;
+  Stats::Scope& stats_scope_;
 };
 
 /**
@@ -40,7 +45,8 @@ private:
 class WorkerImpl : public Worker, Logger::Loggable<Logger::Id::main> {
 public:
   WorkerImpl(ThreadLocal::Instance& tls, TestHooks& hooks, Event::DispatcherPtr&& dispatcher,
-             Network::ConnectionHandlerPtr handler, OverloadManager& overload_manager);
+             Network::ConnectionHandlerPtr handler, OverloadManager& overload_manager,
+             Stats::Scope& stats_scope, uint32_t index);
 
   // Server::Worker
   void addListener(Network::ListenerConfig& listener, AddListenerCompletion completion) override;
@@ -60,6 +66,9 @@ private:
   Event::DispatcherPtr dispatcher_;
   Network::ConnectionHandlerPtr handler_;
   Thread::ThreadPtr thread_;
+  // Published by the worker thread's slice allocator while the thread runs.
+  Buffer::SliceAllocatorStats buffer_stats_;
+  Event::TimerPtr buffer_stats_timer_;
 };
 
 } // namespace Server
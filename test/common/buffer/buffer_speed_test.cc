@@ -0,0 +1,140 @@
+// Note: this should be run with --compilation_mode=opt, and would benefit from a
+// quiescent system with disabled cstate power management.
+//
+// Every benchmark takes the implementation as its first argument: 0 for the native slice
+// implementation and 1 for the libevent evbuffer implementation.
+
+#include <string>
+
+#include "common/buffer/buffer_impl.h"
+
+#include "testing/base/public/benchmark.h"
+
+namespace Envoy {
+namespace Buffer {
+
+// Appends small fragments, similar to the HTTP/1 codec encoding a header block.
+static void BM_AddSmallFragments(benchmark::State& state) {
+  OwnedImpl::useOldImpl(state.range(0));
+  const std::string header_line = "x-forwarded-for: 10.0.0.1\r\n";
+  uint64_t length = 0;
+  for (auto _ : state) {
+    OwnedImpl buffer;
+    for (uint64_t i = 0; i < 32; i++) {
+      buffer.add(header_line);
+    }
+    length += buffer.length();
+  }
+  benchmark::DoNotOptimize(length);
+}
+BENCHMARK(BM_AddSmallFragments)->Arg(0)->Arg(1);
+
+// Moves a body in frames of the given size from one buffer to another, similar to the HTTP/2
+// codec turning DATA frames into a body and the connection manager passing it downstream.
+static void BM_MoveFrames(benchmark::State& state) {
+  OwnedImpl::useOldImpl(state.range(0));
+  const uint64_t frame_size = state.range(1);
+  const std::string frame(frame_size, 'a');
+  OwnedImpl source;
+  OwnedImpl destination;
+  for (auto _ : state) {
+    for (uint64_t i = 0; i < 16; i++) {
+      source.add(frame);
+      destination.move(source);
+    }
+    destination.drain(destination.length());
+  }
+  state.SetBytesProcessed(state.iterations() * 16 * frame_size);
+}
+BENCHMARK(BM_MoveFrames)
+    ->Args({0, 128})
+    ->Args({1, 128})
+    ->Args({0, 16384})
+    ->Args({1, 16384});
+
+// Moves part of a buffer at a time, similar to a codec splitting a body into frames.
+static void BM_MovePartial(benchmark::State& state) {
+  OwnedImpl::useOldImpl(state.range(0));
+  const uint64_t chunk_size = state.range(1);
+  const std::string body(64 * 1024, 'a');
+  for (auto _ : state) {
+    OwnedImpl source(body);
+    OwnedImpl destination;
+    while (source.length() != 0) {
+      destination.move(source, std::min(chunk_size, source.length()));
+    }
+    benchmark::DoNotOptimize(destination.length());
+  }
+  state.SetBytesProcessed(state.iterations() * body.size());
+}
+BENCHMARK(BM_MovePartial)->Args({0, 1000})->Args({1, 1000})->Args({0, 16384})->Args({1, 16384});
+
+// Linearizes the start of a buffer, as codecs do to parse a frame header. The data is already
+// contiguous, so this should not copy.
+static void BM_LinearizeContiguous(benchmark::State& state) {
+  OwnedImpl::useOldImpl(state.range(0));
+  OwnedImpl buffer(std::string(16384, 'a'));
+  uint64_t sum = 0;
+  for (auto _ : state) {
+    sum += *static_cast<uint8_t*>(buffer.linearize(9));
+  }
+  benchmark::DoNotOptimize(sum);
+}
+BENCHMARK(BM_LinearizeContiguous)->Arg(0)->Arg(1);
+
+// Linearizes data that is split across two slices.
+static void BM_LinearizeSplit(benchmark::State& state) {
+  OwnedImpl::useOldImpl(state.range(0));
+  const std::string data(4096, 'a');
+  uint64_t sum = 0;
+  for (auto _ : state) {
+    OwnedImpl buffer;
+    BufferFragmentImpl first(data.data(), data.size(), nullptr);
+    BufferFragmentImpl second(data.data(), data.size(), nullptr);
+    buffer.addBufferFragment(first);
+    buffer.addBufferFragment(second);
+    sum += *static_cast<uint8_t*>(buffer.linearize(6000));
+  }
+  benchmark::DoNotOptimize(sum);
+}
+BENCHMARK(BM_LinearizeSplit)->Arg(0)->Arg(1);
+
+// Reserves and commits space, and then drains it, as a connection does for each read.
+static void BM_ReserveCommitDrain(benchmark::State& state) {
+  OwnedImpl::useOldImpl(state.range(0));
+  const uint64_t read_size = state.range(1);
+  OwnedImpl buffer;
+  for (auto _ : state) {
+    RawSlice slices[2];
+    const uint64_t num_slices = buffer.reserve(16384, slices, 2);
+    slices[0].len_ = std::min(slices[0].len_, static_cast<size_t>(read_size));
+    buffer.commit(slices, std::min<uint64_t>(num_slices, 1));
+    buffer.drain(buffer.length());
+  }
+}
+BENCHMARK(BM_ReserveCommitDrain)->Args({0, 1000})->Args({1, 1000});
+
+// Searches for the end of an HTTP/1 header block.
+static void BM_Search(benchmark::State& state) {
+  OwnedImpl::useOldImpl(state.range(0));
+  OwnedImpl buffer(std::string(4000, 'a') + "\r\n\r\n");
+  ssize_t position = 0;
+  for (auto _ : state) {
+    position += buffer.search("\r\n\r\n", 4, 0);
+  }
+  benchmark::DoNotOptimize(position);
+}
+BENCHMARK(BM_Search)->Arg(0)->Arg(1);
+
+} // namespace Buffer
+} // namespace Envoy
+
+// Boilerplate main(), which discovers benchmarks in the same file and runs them.
+int main(int argc, char** argv) {
+  benchmark::Initialize(&argc, argv);
+
+  if (benchmark::ReportUnrecognizedArguments(argc, argv)) {
+    return 1;
+  }
+  benchmark::RunSpecifiedBenchmarks();
+}
@@ -15,14 +15,17 @@ namespace Envoy {
 namespace Buffer {
 namespace {
 
-class OwnedImplTest : public testing::Test {
+class OwnedImplTest : public testing::TestWithParam<bool> {
 public:
-  OwnedImplTest() {}
+  OwnedImplTest() { OwnedImpl::useOldImpl(GetParam()); }
+  ~OwnedImplTest() { OwnedImpl::useOldImpl(false); }
 
   bool release_callback_called_ = false;
 };
 
-TEST_F(OwnedImplTest, AddBufferFragmentNoCleanup) {
+INSTANTIATE_TEST_CASE_P(OwnedImplTest, OwnedImplTest, testing::Bool());
+
+TEST_P(OwnedImplTest, AddBufferFragmentNoCleanup) {
   char input[] = "hello world";
   BufferFragmentImpl frag(input, 11, nullptr);
   Buffer::OwnedImpl buffer;
@@ -33,7 +36,7 @@ TEST_F(OwnedImplTest, AddBufferFragmentNoCleanup) {
   EXPECT_EQ(0, buffer.length());
 }
 
-TEST_F(OwnedImplTest, AddBufferFragmentWithCleanup) {
+TEST_P(OwnedImplTest, AddBufferFragmentWithCleanup) {
   char input[] = "hello world";
   BufferFragmentImpl frag(input, 11, [this](const void*, size_t, const BufferFragmentImpl*) {
     release_callback_called_ = true;
@@ -51,7 +54,7 @@ TEST_F(OwnedImplTest, AddBufferFragmentWithCleanup) {
   EXPECT_TRUE(release_callback_called_);
 }
 
-TEST_F(OwnedImplTest, AddBufferFragmentDynamicAllocation) {
+TEST_P(OwnedImplTest, AddBufferFragmentDynamicAllocation) {
   char input_stack[] = "hello world";
   char* input = new char[11];
   std::copy(input_stack, input_stack + 11, input);
@@ -76,7 +79,7 @@ TEST_F(OwnedImplTest, AddBufferFragmentDynamicAllocation) {
   EXPECT_TRUE(release_callback_called_);
 }
 
-TEST_F(OwnedImplTest, Prepend) {
+TEST_P(OwnedImplTest, Prepend) {
   std::string suffix = "World!", prefix = "Hello, ";
   Buffer::OwnedImpl buffer;
   buffer.add(suffix);
@@ -86,7 +89,7 @@ TEST_F(OwnedImplTest, Prepend) {
   EXPECT_EQ(prefix + suffix, buffer.toString());
 }
 
-TEST_F(OwnedImplTest, PrependToEmptyBuffer) {
+TEST_P(OwnedImplTest, PrependToEmptyBuffer) {
   std::string data = "Hello, World!";
   Buffer::OwnedImpl buffer;
   buffer.prepend(data);
@@ -100,7 +103,7 @@ TEST_F(OwnedImplTest, PrependToEmptyBuffer) {
   EXPECT_EQ(data, buffer.toString());
 }
 
-TEST_F(OwnedImplTest, PrependBuffer) {
+TEST_P(OwnedImplTest, PrependBuffer) {
   std::string suffix = "World!", prefix = "Hello, ";
   Buffer::OwnedImpl buffer;
   buffer.add(suffix);
@@ -114,7 +117,7 @@ TEST_F(OwnedImplTest, PrependBuffer) {
   EXPECT_EQ(0, prefixBuffer.length());
 }
 
-TEST_F(OwnedImplTest, Write) {
+TEST_P(OwnedImplTest, Write) {
   Api::MockOsSysCalls os_sys_calls;
   TestThreadsafeSingletonInjector<Api::OsSysCallsImpl> os_calls(&os_sys_calls);
 
@@ -152,7 +155,27 @@ TEST_F(OwnedImplTest, Write) {
   EXPECT_EQ(0, buffer.length());
 }
 
-TEST_F(OwnedImplTest, Read) {
+// A buffer made of many fragments is written with a single writev().
+TEST_P(OwnedImplTest, WriteGathersSlices) {
+  Api::MockOsSysCalls os_sys_calls;
+  TestThreadsafeSingletonInjector<Api::OsSysCallsImpl> os_calls(&os_sys_calls);
+
+  const std::string data = "fragment";
+  std::vector<std::unique_ptr<BufferFragmentImpl>> fragments;
+  Buffer::OwnedImpl buffer;
+  for (uint64_t i = 0; i < 64; i++) {
+    fragments.emplace_back(new BufferFragmentImpl(data.data(), data.size(), nullptr));
+    buffer.addBufferFragment(*fragments.back());
+  }
+
+  EXPECT_CALL(os_sys_calls, writev(_, _, 64))
+      .WillOnce(Return(Api::SysCallSizeResult{static_cast<ssize_t>(64 * data.size()), 0}));
+  Api::SysCallIntResult result = buffer.write(-1);
+  EXPECT_EQ(64 * data.size(), result.rc_);
+  EXPECT_EQ(0, buffer.length());
+}
+
+TEST_P(OwnedImplTest, Read) {
   Api::MockOsSysCalls os_sys_calls;
   TestThreadsafeSingletonInjector<Api::OsSysCallsImpl> os_calls(&os_sys_calls);
 
@@ -173,7 +196,7 @@ TEST_F(OwnedImplTest, Read) {
   EXPECT_EQ(0, buffer.length());
 }
 
-TEST_F(OwnedImplTest, ToString) {
+TEST_P(OwnedImplTest, ToString) {
   Buffer::OwnedImpl buffer;
   EXPECT_EQ("", buffer.toString());
   auto append = [&buffer](absl::string_view str) { buffer.add(str.data(), str.size()); };
@@ -188,6 +211,168 @@ TEST_F(OwnedImplTest, ToString) {
   EXPECT_EQ(absl::StrCat("Hello, world!" + long_string), buffer.toString());
 }
 
+TEST_P(OwnedImplTest, UsesSelectedImpl) {
+  Buffer::OwnedImpl buffer;
+  EXPECT_EQ(GetParam(), buffer.usesOldImpl());
+}
+
+TEST_P(OwnedImplTest, AddLargerThanSlice) {
+  Buffer::OwnedImpl buffer;
+  std::string data(3 * SliceAllocator::SmallCapacity, 'a');
+  buffer.add("b");
+  buffer.add(data);
+  buffer.add("c");
+  EXPECT_EQ(data.size() + 2, buffer.length());
+  EXPECT_EQ("b" + data + "c", buffer.toString());
+
+  buffer.drain(SliceAllocator::SmallCapacity);
+  EXPECT_EQ(2 * SliceAllocator::SmallCapacity + 2, buffer.length());
+  EXPECT_EQ(data.substr(SliceAllocator::SmallCapacity - 1) + "c", buffer.toString());
+}
+
+TEST_P(OwnedImplTest, PrependLargerThanSlice) {
+  Buffer::OwnedImpl buffer;
+  std::string data(2 * SliceAllocator::SmallCapacity, 'a');
+  data.back() = 'b';
+  buffer.add("c");
+  buffer.prepend(data);
+  buffer.prepend("d");
+  EXPECT_EQ("d" + data + "c", buffer.toString());
+}
+
+TEST_P(OwnedImplTest, PrependAfterDrain) {
+  Buffer::OwnedImpl buffer;
+  buffer.add("hello world");
+  buffer.drain(6);
+  buffer.prepend("brave new ");
+  EXPECT_EQ("brave new world", buffer.toString());
+}
+
+TEST_P(OwnedImplTest, PrependBufferFragment) {
+  char input[] = "world";
+  BufferFragmentImpl frag(input, 5, nullptr);
+  Buffer::OwnedImpl buffer;
+  buffer.addBufferFragment(frag);
+  buffer.drain(1);
+  buffer.prepend("hello w");
+  EXPECT_EQ("hello world", buffer.toString());
+  EXPECT_STREQ("world", input);
+}
+
+TEST_P(OwnedImplTest, Move) {
+  Buffer::OwnedImpl buffer("hello ");
+  Buffer::OwnedImpl other("world");
+  std::string large(2 * SliceAllocator::SmallCapacity, 'a');
+  other.add(large);
+  buffer.move(other);
+  EXPECT_EQ(0, other.length());
+  EXPECT_EQ("hello world" + large, buffer.toString());
+
+  // The source buffer can still be used after the move.
+  other.add("!");
+  buffer.move(other);
+  EXPECT_EQ("hello world" + large + "!", buffer.toString());
+}
+
+TEST_P(OwnedImplTest, MoveLength) {
+  Buffer::OwnedImpl buffer;
+  Buffer::OwnedImpl other("hello");
+  std::string large(2 * SliceAllocator::SmallCapacity, 'a');
+  other.add(large);
+
+  buffer.move(other, 3);
+  EXPECT_EQ("hel", buffer.toString());
+  EXPECT_EQ("lo" + large, other.toString());
+
+  buffer.move(other, 2 + SliceAllocator::SmallCapacity);
+  EXPECT_EQ("hello" + large.substr(SliceAllocator::SmallCapacity), buffer.toString());
+  EXPECT_EQ(large.substr(SliceAllocator::SmallCapacity), other.toString());
+
+  buffer.move(other, other.length());
+  EXPECT_EQ("hello" + large, buffer.toString());
+  EXPECT_EQ(0, other.length());
+}
+
+TEST_P(OwnedImplTest, MoveBufferFragment) {
+  char input[] = "hello world";
+  BufferFragmentImpl frag(input, 11, [this](const void*, size_t, const BufferFragmentImpl*) {
+    release_callback_called_ = true;
+  });
+  {
+    Buffer::OwnedImpl buffer;
+    {
+      Buffer::OwnedImpl other;
+      other.addBufferFragment(frag);
+      buffer.move(other);
+    }
+    EXPECT_FALSE(release_callback_called_);
+    EXPECT_EQ("hello world", buffer.toString());
+  }
+  EXPECT_TRUE(release_callback_called_);
+}
+
+TEST_P(OwnedImplTest, Linearize) {
+  Buffer::OwnedImpl buffer;
+  std::string large(2 * SliceAllocator::SmallCapacity, 'a');
+  buffer.add("hello");
+  buffer.add(large);
+  EXPECT_EQ(nullptr, buffer.linearize(0));
+  EXPECT_EQ("helloaa", std::string(static_cast<char*>(buffer.linearize(7)), 7));
+  const std::string expected = "hello" + large;
+  EXPECT_EQ(expected, std::string(static_cast<char*>(buffer.linearize(expected.size())),
+                                  expected.size()));
+  EXPECT_EQ(expected, buffer.toString());
+}
+
+TEST_P(OwnedImplTest, LinearizeContiguous) {
+  Buffer::OwnedImpl buffer("hello world");
+  RawSlice slice;
+  EXPECT_EQ(1, buffer.getRawSlices(&slice, 1));
+  // The data is already in one slice, so it must not be copied.
+  EXPECT_EQ(slice.mem_, buffer.linearize(5));
+  EXPECT_EQ(slice.mem_, buffer.linearize(11));
+}
+
+TEST_P(OwnedImplTest, ReserveCommit) {
+  Buffer::OwnedImpl buffer("hello");
+  RawSlice iovecs[2];
+  const uint64_t num_iovecs = buffer.reserve(2 * SliceAllocator::SmallCapacity, iovecs, 2);
+  ASSERT_GE(num_iovecs, 1);
+  uint64_t reserved = 0;
+  for (uint64_t i = 0; i < num_iovecs; i++) {
+    memset(iovecs[i].mem_, 'a', iovecs[i].len_);
+    reserved += iovecs[i].len_;
+  }
+  EXPECT_GE(reserved, 2 * SliceAllocator::SmallCapacity);
+  EXPECT_EQ(5, buffer.length());
+
+  iovecs[0].len_ = 1;
+  buffer.commit(iovecs, 1);
+  EXPECT_EQ("helloa", buffer.toString());
+
+  buffer.add(" world");
+  EXPECT_EQ("helloa world", buffer.toString());
+}
+
+TEST_P(OwnedImplTest, Search) {
+  char input[] = "lo wo";
+  BufferFragmentImpl frag(input, 5, nullptr);
+  Buffer::OwnedImpl buffer;
+  EXPECT_EQ(-1, buffer.search("a", 1, 0));
+
+  buffer.add("hel");
+  buffer.addBufferFragment(frag);
+  buffer.add("rld");
+  EXPECT_EQ(0, buffer.search("hello", 5, 0));
+  EXPECT_EQ(3, buffer.search("lo w", 4, 0));
+  EXPECT_EQ(6, buffer.search("world", 5, 0));
+  EXPECT_EQ(6, buffer.search("world", 5, 6));
+  EXPECT_EQ(-1, buffer.search("world", 5, 7));
+  EXPECT_EQ(9, buffer.search("l", 1, 4));
+  EXPECT_EQ(-1, buffer.search("worlds", 6, 0));
+  EXPECT_EQ(-1, buffer.search("h", 1, 100));
+}
+
 } // namespace
 } // namespace Buffer
 } // namespace Envoy
@@ -0,0 +1,131 @@
+#include <functional>
+#include <vector>
+
+#include "common/buffer/slice_allocator.h"
+#include "common/common/thread.h"
+#include "common/stats/isolated_store_impl.h"
+
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Buffer {
+namespace {
+
+// The size of the slice object passed to allocate(). Any value works, as long as it's consistent.
+constexpr uint64_t HeaderSize = 64;
+
+TEST(SliceAllocatorTest, CapacityFor) {
+  EXPECT_EQ(SliceAllocator::SmallCapacity, SliceAllocator::capacityFor(0));
+  EXPECT_EQ(SliceAllocator::SmallCapacity, SliceAllocator::capacityFor(4096));
+  EXPECT_EQ(SliceAllocator::LargeCapacity, SliceAllocator::capacityFor(4097));
+  EXPECT_EQ(SliceAllocator::LargeCapacity, SliceAllocator::capacityFor(16384));
+  EXPECT_EQ(2 * SliceAllocator::LargeCapacity, SliceAllocator::capacityFor(16385));
+}
+
+// Each allocator belongs to a thread, so tests which check its state run on a new thread to start
+// with an empty allocator.
+void runOnNewThread(std::function<void()> test) {
+  Thread::Thread thread(test);
+  thread.join();
+}
+
+TEST(SliceAllocatorTest, ReusesFreedSlices) {
+  runOnNewThread([]() {
+    SliceAllocator& allocator = SliceAllocator::threadLocal();
+    void* small = SliceAllocator::allocate(HeaderSize, SliceAllocator::SmallCapacity);
+    void* large = SliceAllocator::allocate(HeaderSize, SliceAllocator::LargeCapacity);
+    EXPECT_EQ(2, allocator.slicesInUse());
+    SliceAllocator::free(small);
+    SliceAllocator::free(large);
+    EXPECT_EQ(0, allocator.slicesInUse());
+    EXPECT_EQ(2, allocator.slicesPooled());
+
+    // Freed slices are handed out again for the same capacity.
+    EXPECT_EQ(large, SliceAllocator::allocate(HeaderSize, SliceAllocator::LargeCapacity));
+    EXPECT_EQ(small, SliceAllocator::allocate(HeaderSize, SliceAllocator::SmallCapacity));
+    EXPECT_EQ(0, allocator.slicesPooled());
+    SliceAllocator::free(small);
+    SliceAllocator::free(large);
+  });
+}
+
+TEST(SliceAllocatorTest, DoesNotPoolOtherCapacities) {
+  runOnNewThread([]() {
+    SliceAllocator& allocator = SliceAllocator::threadLocal();
+    const uint64_t in_use_bytes = SliceAllocator::totalBytesInUse();
+    void* huge = SliceAllocator::allocate(HeaderSize, 4 * SliceAllocator::LargeCapacity);
+    EXPECT_LT(in_use_bytes + 4 * SliceAllocator::LargeCapacity, SliceAllocator::totalBytesInUse());
+    SliceAllocator::free(huge);
+    EXPECT_EQ(in_use_bytes, SliceAllocator::totalBytesInUse());
+    EXPECT_EQ(0, allocator.slicesPooled());
+  });
+}
+
+TEST(SliceAllocatorTest, PoolIsBounded) {
+  runOnNewThread([]() {
+    SliceAllocator& allocator = SliceAllocator::threadLocal();
+    std::vector<void*> slices;
+    for (uint32_t i = 0; i < SliceAllocator::MaxPooledSmall + 10; i++) {
+      slices.push_back(SliceAllocator::allocate(HeaderSize, SliceAllocator::SmallCapacity));
+    }
+    for (void* slice : slices) {
+      SliceAllocator::free(slice);
+    }
+    EXPECT_EQ(0, allocator.slicesInUse());
+    EXPECT_EQ(SliceAllocator::MaxPooledSmall, allocator.slicesPooled());
+  });
+}
+
+TEST(SliceAllocatorTest, Stats) {
+  Stats::IsolatedStoreImpl store;
+  SliceAllocatorStats stats{ALL_SLICE_ALLOCATOR_STATS(POOL_COUNTER_PREFIX(store, "buffer."),
+                                                      POOL_GAUGE_PREFIX(store, "buffer."))};
+  runOnNewThread([&stats]() {
+    SliceAllocator& allocator = SliceAllocator::threadLocal();
+    allocator.setStats(&stats);
+
+    void* slice = SliceAllocator::allocate(HeaderSize, SliceAllocator::SmallCapacity);
+    // Stats are only updated when published.
+    EXPECT_EQ(0, stats.slices_in_use_.value());
+    allocator.publishStats();
+    EXPECT_EQ(1, stats.slices_in_use_.value());
+    EXPECT_LT(SliceAllocator::SmallCapacity, stats.bytes_in_use_.value());
+    EXPECT_EQ(0, stats.slices_pooled_.value());
+    SliceAllocator::free(slice);
+    EXPECT_EQ(0, stats.slices_returned_.value());
+    allocator.publishStats();
+    EXPECT_EQ(0, stats.slices_in_use_.value());
+    EXPECT_EQ(0, stats.bytes_in_use_.value());
+    EXPECT_EQ(1, stats.slices_pooled_.value());
+    EXPECT_LT(SliceAllocator::SmallCapacity, stats.bytes_pooled_.value());
+    EXPECT_EQ(1, stats.slices_returned_.value());
+    // Publishing again doesn't count the same slices twice.
+    allocator.publishStats();
+    EXPECT_EQ(1, stats.slices_returned_.value());
+
+    allocator.setStats(nullptr);
+    slice = SliceAllocator::allocate(HeaderSize, SliceAllocator::SmallCapacity);
+    allocator.publishStats();
+    EXPECT_EQ(1, stats.slices_pooled_.value());
+    SliceAllocator::free(slice);
+  });
+}
+
+// Slices can be freed by another thread, including after the allocating thread has exited. The
+// totals must still add up.
+TEST(SliceAllocatorTest, FreeOnAnotherThread) {
+  const uint64_t in_use_bytes = SliceAllocator::totalBytesInUse();
+
+  void* slice = nullptr;
+  Thread::Thread thread(
+      [&slice]() { slice = SliceAllocator::allocate(HeaderSize, SliceAllocator::SmallCapacity); });
+  thread.join();
+  EXPECT_LT(in_use_bytes, SliceAllocator::totalBytesInUse());
+
+  SliceAllocator::free(slice);
+  EXPECT_EQ(in_use_bytes, SliceAllocator::totalBytesInUse());
+}
+
+} // namespace
+} // namespace Buffer
+} // namespace Envoy
@@ -62,6 +62,22 @@ TEST_F(WatermarkBufferTest, AddBuffer) {
   EXPECT_EQ(11, buffer_.length());
 }
 
+TEST_F(WatermarkBufferTest, AddBufferFragment) {
+  bool done = false;
+  BufferFragmentImpl fragment(TEN_BYTES, 10, [&](const void*, size_t, const BufferFragmentImpl*) {
+    done = true;
+  });
+  buffer_.add("a", 1);
+  EXPECT_EQ(0, times_high_watermark_called_);
+  buffer_.addBufferFragment(fragment);
+  EXPECT_EQ(1, times_high_watermark_called_);
+  EXPECT_EQ(11, buffer_.length());
+
+  buffer_.drain(11);
+  EXPECT_EQ(1, times_low_watermark_called_);
+  EXPECT_TRUE(done);
+}
+
 TEST_F(WatermarkBufferTest, Prepend) {
   std::string suffix = "World!", prefix = "Hello, ";
 
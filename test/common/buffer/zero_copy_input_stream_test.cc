@@ -35,7 +35,9 @@ TEST_F(ZeroCopyInputStreamTest, Next) {
 }
 
 TEST_F(ZeroCopyInputStreamTest, TwoSlices) {
-  Buffer::OwnedImpl buffer("efgh");
+  // Small slices are coalesced by move(), so use one that is large enough to be moved as is.
+  const std::string second_slice_data(Buffer::OwnedImpl::CopyThreshold + 1, 'e');
+  Buffer::OwnedImpl buffer(second_slice_data);
 
   stream_.move(buffer);
 
@@ -43,8 +45,8 @@ TEST_F(ZeroCopyInputStreamTest, TwoSlices) {
   EXPECT_EQ(4, size_);
   EXPECT_EQ(0, memcmp(slice_data_.data(), data_, size_));
   EXPECT_TRUE(stream_.Next(&data_, &size_));
-  EXPECT_EQ(4, size_);
-  EXPECT_EQ(0, memcmp("efgh", data_, size_));
+  EXPECT_EQ(static_cast<int>(second_slice_data.size()), size_);
+  EXPECT_EQ(0, memcmp(second_slice_data.data(), data_, size_));
 }
 
 TEST_F(ZeroCopyInputStreamTest, BackUp) {
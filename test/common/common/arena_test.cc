@@ -0,0 +1,107 @@
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "common/common/arena.h"
+
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace {
+
+bool isAligned(const void* pointer, size_t alignment) {
+  return reinterpret_cast<uintptr_t>(pointer) % alignment == 0;
+}
+
+TEST(ArenaTest, InlineAllocation) {
+  InlineArena<256> arena;
+  void* first = arena.allocate(3, 1);
+  void* second = arena.allocate(8, 8);
+  EXPECT_NE(first, second);
+  EXPECT_TRUE(isAligned(second, 8));
+  void* third = arena.allocate(16, alignof(std::max_align_t));
+  EXPECT_TRUE(isAligned(third, alignof(std::max_align_t)));
+
+  // Inline allocations are inside the arena itself.
+  for (void* pointer : {first, second, third}) {
+    EXPECT_GE(static_cast<char*>(pointer), reinterpret_cast<char*>(&arena));
+    EXPECT_LT(static_cast<char*>(pointer), reinterpret_cast<char*>(&arena) + sizeof(arena));
+  }
+  EXPECT_EQ(3, arena.allocations());
+  EXPECT_EQ(27, arena.bytesAllocated());
+  EXPECT_EQ(0, arena.heapBlocks());
+}
+
+TEST(ArenaTest, HeapBlocks) {
+  InlineArena<64> arena;
+  arena.allocate(64, 8);
+  EXPECT_EQ(0, arena.heapBlocks());
+
+  // The inline storage is full, so the arena moves on to a heap block and allocates from that.
+  void* first = arena.allocate(100, 8);
+  void* second = arena.allocate(100, 8);
+  EXPECT_EQ(1, arena.heapBlocks());
+  EXPECT_EQ(static_cast<char*>(first) + 104, static_cast<char*>(second));
+
+  // Large allocations get a block of their own, and smaller ones carry on in the current block.
+  void* large = arena.allocate(Arena::HeapBlockSize + 1, 8);
+  EXPECT_TRUE(isAligned(large, alignof(std::max_align_t)));
+  EXPECT_EQ(2, arena.heapBlocks());
+  void* third = arena.allocate(8, 8);
+  EXPECT_EQ(static_cast<char*>(second) + 104, static_cast<char*>(third));
+
+  // Allocating more than a block's worth of small objects fills up further blocks.
+  for (uint64_t i = 0; i < Arena::HeapBlockSize / 64; i++) {
+    arena.allocate(64, 8);
+  }
+  EXPECT_EQ(3, arena.heapBlocks());
+  EXPECT_EQ(5 + Arena::HeapBlockSize / 64, arena.allocations());
+}
+
+TEST(ArenaTest, NoInlineStorage) {
+  Arena arena;
+  void* pointer = arena.allocate(1, 1);
+  EXPECT_NE(nullptr, pointer);
+  EXPECT_EQ(1, arena.heapBlocks());
+  EXPECT_EQ(1, arena.allocations());
+}
+
+TEST(ArenaTest, ArenaPtrRunsDestructor) {
+  InlineArena<128> arena;
+  std::shared_ptr<int> count = std::make_shared<int>(0);
+  {
+    ArenaPtr<std::shared_ptr<int>> object = makeArenaPtr<std::shared_ptr<int>>(arena, count);
+    EXPECT_EQ(2, count.use_count());
+  }
+  EXPECT_EQ(1, count.use_count());
+  EXPECT_EQ(1, arena.allocations());
+}
+
+TEST(ArenaTest, Containers) {
+  InlineArena<1024> arena;
+  std::list<std::string, ArenaAllocator<std::string>> list{ArenaAllocator<std::string>(arena)};
+  list.push_back("hello");
+  list.push_back("world");
+  list.pop_front();
+  list.push_back("again");
+  EXPECT_EQ(3, arena.allocations());
+  EXPECT_EQ((std::list<std::string>{"world", "again"}),
+            (std::list<std::string>(list.begin(), list.end())));
+
+  std::vector<uint64_t, ArenaAllocator<uint64_t>> vector{ArenaAllocator<uint64_t>(arena)};
+  for (uint64_t i = 0; i < 100; i++) {
+    vector.push_back(i);
+  }
+  // Memory released by the vector as it grows is not reused, so it overflows the inline storage.
+  EXPECT_EQ(99, vector.back());
+  EXPECT_EQ(1, arena.heapBlocks());
+
+  InlineArena<16> other;
+  EXPECT_EQ(ArenaAllocator<int>(arena), ArenaAllocator<std::string>(arena));
+  EXPECT_NE(ArenaAllocator<int>(arena), ArenaAllocator<int>(other));
+}
+
+} // namespace
+} // namespace Envoy
@@ -0,0 +1,119 @@
+// Note: this should be run with --compilation_mode=opt, and would benefit from a
+// quiescent system with disabled cstate power management.
+//
+// Simulates the churn in the connection pools of a worker with 10k requests in flight to 1k hosts:
+// each iteration completes a request, which moves its connection from the busy list to the ready
+// list, and starts a new one on a random host, which takes a ready connection or opens a new one.
+// A small share of connections are closed when their request completes. The pools either keep
+// their connections in std::list<std::unique_ptr> with LinkedObject, or in IntrusiveList.
+
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include "common/common/assert.h"
+#include "common/common/intrusive_list.h"
+#include "common/common/linked_object.h"
+
+#include "testing/base/public/benchmark.h"
+
+namespace Envoy {
+namespace {
+
+constexpr uint32_t NumHosts = 1000;
+constexpr uint32_t NumRequests = 10000;
+// One in this many connections is closed when its request completes.
+constexpr uint32_t CloseEvery = 64;
+
+struct LinkedConnection : LinkedObject<LinkedConnection> {
+  uint64_t requests_{};
+};
+
+struct IntrusiveConnection : IntrusiveListItem<IntrusiveConnection> {
+  uint64_t requests_{};
+};
+
+template <class Connection> class PoolChurn {
+public:
+  typedef typename Connection::ListType ListType;
+
+  PoolChurn() : pools_(NumHosts) {
+    for (uint32_t i = 0; i < NumRequests; i++) {
+      requests_.push_back(newRequest());
+    }
+  }
+
+  // Completes a random request in flight and starts a new one in its place.
+  void churn() {
+    Request& request = requests_[random_() % requests_.size()];
+    Pool& pool = pools_[request.host_];
+    if (++completed_ % CloseEvery == 0) {
+      request.connection_->removeFromList(pool.busy_);
+    } else {
+      request.connection_->moveBetweenLists(pool.busy_, pool.ready_);
+    }
+    request = newRequest();
+  }
+
+  uint64_t connections() const {
+    uint64_t connections = 0;
+    for (const Pool& pool : pools_) {
+      connections += pool.ready_.size() + pool.busy_.size();
+    }
+    return connections;
+  }
+
+private:
+  struct Pool {
+    ListType ready_;
+    ListType busy_;
+  };
+
+  struct Request {
+    uint32_t host_;
+    Connection* connection_;
+  };
+
+  Request newRequest() {
+    const uint32_t host = random_() % NumHosts;
+    Pool& pool = pools_[host];
+    if (pool.ready_.empty()) {
+      std::unique_ptr<Connection> connection(new Connection());
+      connection->moveIntoList(std::move(connection), pool.busy_);
+    } else {
+      pool.ready_.front()->moveBetweenLists(pool.ready_, pool.busy_);
+    }
+    Connection& connection = *pool.busy_.front();
+    connection.requests_++;
+    return {host, &connection};
+  }
+
+  std::vector<Pool> pools_;
+  std::vector<Request> requests_;
+  std::minstd_rand random_;
+  uint64_t completed_{};
+};
+
+template <class Connection> void BM_PoolChurn(benchmark::State& state) {
+  PoolChurn<Connection> churn;
+  for (auto _ : state) {
+    churn.churn();
+  }
+  RELEASE_ASSERT(churn.connections() >= NumRequests, "");
+}
+BENCHMARK_TEMPLATE(BM_PoolChurn, LinkedConnection);
+BENCHMARK_TEMPLATE(BM_PoolChurn, IntrusiveConnection);
+
+} // namespace
+} // namespace Envoy
+
+// Boilerplate main(), which discovers benchmarks in the same file and runs them.
+int main(int argc, char** argv) {
+  benchmark::Initialize(&argc, argv);
+
+  if (benchmark::ReportUnrecognizedArguments(argc, argv)) {
+    return 1;
+  }
+  benchmark::RunSpecifiedBenchmarks();
+}
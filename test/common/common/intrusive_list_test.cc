@@ -0,0 +1,133 @@
+#include <memory>
+#include <vector>
+
+#include "common/common/intrusive_list.h"
+
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace {
+
+class TestItem : public IntrusiveListItem<TestItem> {
+public:
+  TestItem(int value, int& destroyed) : value_(value), destroyed_(destroyed) {}
+  ~TestItem() { destroyed_++; }
+
+  const int value_;
+  int& destroyed_;
+};
+
+typedef std::unique_ptr<TestItem> TestItemPtr;
+
+std::vector<int> values(const IntrusiveList<TestItem>& list) {
+  std::vector<int> values;
+  for (const TestItem* item : list) {
+    values.push_back(item->value_);
+  }
+  return values;
+}
+
+TEST(IntrusiveListTest, MoveIntoList) {
+  int destroyed = 0;
+  IntrusiveList<TestItem> list;
+  EXPECT_TRUE(list.empty());
+
+  for (int value : {1, 2}) {
+    TestItemPtr item(new TestItem(value, destroyed));
+    item->moveIntoList(std::move(item), list);
+  }
+  TestItemPtr item(new TestItem(3, destroyed));
+  EXPECT_FALSE(item->inserted());
+  item->moveIntoListBack(std::move(item), list);
+
+  EXPECT_EQ(3U, list.size());
+  EXPECT_EQ((std::vector<int>{2, 1, 3}), values(list));
+  EXPECT_EQ(2, list.front()->value_);
+  EXPECT_EQ(3, list.back()->value_);
+  EXPECT_TRUE(list.front()->inserted());
+
+  list.pop_front();
+  EXPECT_EQ(1, destroyed);
+  list.pop_back();
+  EXPECT_EQ(2, destroyed);
+  EXPECT_EQ((std::vector<int>{1}), values(list));
+}
+
+TEST(IntrusiveListTest, MoveBetweenLists) {
+  int destroyed = 0;
+  IntrusiveList<TestItem> ready;
+  IntrusiveList<TestItem> busy;
+  for (int value : {1, 2, 3}) {
+    TestItemPtr item(new TestItem(value, destroyed));
+    item->moveIntoListBack(std::move(item), ready);
+  }
+
+  ready.front()->moveBetweenLists(ready, busy);
+  ready.back()->moveBetweenLists(ready, busy);
+  EXPECT_EQ((std::vector<int>{2}), values(ready));
+  EXPECT_EQ((std::vector<int>{3, 1}), values(busy));
+
+  // Removing an item gives it back to the caller.
+  TestItem* item = busy.back();
+  TestItemPtr removed = item->removeFromList(busy);
+  EXPECT_EQ(item, removed.get());
+  EXPECT_FALSE(removed->inserted());
+  EXPECT_EQ(1U, busy.size());
+  removed.reset();
+  EXPECT_EQ(1, destroyed);
+}
+
+TEST(IntrusiveListTest, RemoveWhileIterating) {
+  int destroyed = 0;
+  IntrusiveList<TestItem> list;
+  for (int value : {1, 2, 3, 4}) {
+    TestItemPtr item(new TestItem(value, destroyed));
+    item->moveIntoListBack(std::move(item), list);
+  }
+
+  for (auto it = list.begin(); it != list.end();) {
+    TestItem* item = *it++;
+    if (item->value_ % 2 == 0) {
+      item->removeFromList(list);
+    }
+  }
+  EXPECT_EQ(2, destroyed);
+  EXPECT_EQ((std::vector<int>{1, 3}), values(list));
+}
+
+TEST(IntrusiveListTest, MoveList) {
+  int destroyed = 0;
+  IntrusiveList<TestItem> list;
+  for (int value : {1, 2}) {
+    TestItemPtr item(new TestItem(value, destroyed));
+    item->moveIntoListBack(std::move(item), list);
+  }
+
+  IntrusiveList<TestItem> moved(std::move(list));
+  EXPECT_TRUE(list.empty());
+  EXPECT_EQ((std::vector<int>{1, 2}), values(moved));
+
+  // Items in the new list can be removed from it.
+  moved.front()->removeFromList(moved);
+  EXPECT_EQ(1, destroyed);
+
+  // The old list can still be used.
+  TestItemPtr item(new TestItem(3, destroyed));
+  item->moveIntoList(std::move(item), list);
+  EXPECT_EQ((std::vector<int>{3}), values(list));
+}
+
+TEST(IntrusiveListTest, DestroyDeletesItems) {
+  int destroyed = 0;
+  {
+    IntrusiveList<TestItem> list;
+    for (int value : {1, 2, 3}) {
+      TestItemPtr item(new TestItem(value, destroyed));
+      item->moveIntoList(std::move(item), list);
+    }
+  }
+  EXPECT_EQ(3, destroyed);
+}
+
+} // namespace
+} // namespace Envoy
@@ -0,0 +1,118 @@
+#include <vector>
+
+#include "envoy/common/exception.h"
+
+#include "common/common/regex.h"
+
+#include "test/test_common/utility.h"
+
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Regex {
+namespace {
+
+TEST(RegexUtilityTest, Match) {
+  CompiledMatcherPtr regex = Utility::parseRegex("/b[io]t");
+  EXPECT_TRUE(regex->match("/bit"));
+  EXPECT_TRUE(regex->match("/bot"));
+  EXPECT_FALSE(regex->match("/bite"));
+  EXPECT_FALSE(regex->match("/bit/bot"));
+  EXPECT_FALSE(regex->match(""));
+}
+
+TEST(RegexUtilityTest, Search) {
+  CompiledMatcherPtr regex = Utility::parseRegex("b[io]t");
+  EXPECT_TRUE(regex->search("/bit"));
+  EXPECT_TRUE(regex->search("/bite"));
+  EXPECT_TRUE(regex->search("/foo/bot/bar"));
+  EXPECT_FALSE(regex->search("/bat"));
+
+  CompiledMatcherPtr anchored = Utility::parseRegex("^server\\.version$");
+  EXPECT_TRUE(anchored->search("server.version"));
+  EXPECT_FALSE(anchored->search("server.version2"));
+}
+
+TEST(RegexUtilityTest, EmbeddedNul) {
+  CompiledMatcherPtr regex = Utility::parseRegex("a.b");
+  EXPECT_TRUE(regex->match(absl::string_view("a\0b", 3)));
+}
+
+TEST(RegexUtilityTest, InvalidRegex) {
+  EXPECT_THROW_WITH_REGEX(Utility::parseRegex("(+invalid)"), EnvoyException,
+                          "Invalid regex '\\(\\+invalid\\)':");
+  // Backreferences can't be evaluated in linear time and are not supported.
+  EXPECT_THROW_WITH_REGEX(Utility::parseRegex("(a)\\1"), EnvoyException, "Invalid regex");
+}
+
+TEST(RegexUtilityTest, ProgramSizeBudget) {
+  EXPECT_THROW_WITH_REGEX(Utility::parseRegex("[a-z]{1000}[0-9]{1000}"), EnvoyException,
+                          "Regex '\\[a-z\\]\\{1000\\}\\[0-9\\]\\{1000\\}' is too complex: "
+                          "program size [0-9]+ exceeds 1000");
+  EXPECT_NO_THROW(Utility::parseRegex("[a-z]{1000}[0-9]{1000}", 10000));
+  EXPECT_THROW_WITH_REGEX(Utility::parseRegex("[a-z]{100}", 10), EnvoyException,
+                          "is too complex: program size [0-9]+ exceeds 10");
+}
+
+// Ordinary route patterns are accepted by the default budget.
+TEST(RegexUtilityTest, RealisticPattern) {
+  CompiledMatcherPtr regex = Utility::parseRegex("(GET|POST|PUT)/[a-zA-Z0-9_]{1,32}");
+  EXPECT_TRUE(regex->match("GET/users_1"));
+  EXPECT_FALSE(regex->match("DELETE/users_1"));
+  EXPECT_FALSE(regex->match("PUT/"));
+}
+
+TEST(RegexUtilityTest, ConfiguredProgramSize) {
+  EXPECT_EQ(Utility::DefaultMaxProgramSize, Utility::maxProgramSize());
+
+  {
+    ScopedMaxRegexProgramSize max_program_size(30);
+    EXPECT_EQ(30, Utility::maxProgramSize());
+    EXPECT_THROW_WITH_REGEX(Utility::parseRegex("(GET|POST|PUT)/[a-zA-Z0-9_]{1,32}"),
+                            EnvoyException, "is too complex: program size [0-9]+ exceeds 30");
+    EXPECT_NO_THROW(Utility::parseRegex("/b[io]t"));
+  }
+
+  EXPECT_EQ(Utility::DefaultMaxProgramSize, Utility::maxProgramSize());
+  EXPECT_NO_THROW(Utility::parseRegex("(GET|POST|PUT)/[a-zA-Z0-9_]{1,32}"));
+}
+
+TEST(GoogleReSetTest, Match) {
+  GoogleReSet set;
+  EXPECT_EQ(0, set.add("/foo/.*"));
+  EXPECT_EQ(1, set.add("/bar"));
+  EXPECT_EQ(2, set.add("/foo/b[a-z]+"));
+  EXPECT_EQ(3, set.add(".*"));
+  EXPECT_EQ(4, set.size());
+  set.compile();
+
+  std::vector<int> matches;
+  EXPECT_TRUE(set.match("/foo/bar", matches));
+  EXPECT_EQ(std::vector<int>({0, 2, 3}), matches);
+  EXPECT_TRUE(set.match("/bar", matches));
+  EXPECT_EQ(std::vector<int>({1, 3}), matches);
+  // Regexes must match the entire value.
+  EXPECT_TRUE(set.match("/bar/", matches));
+  EXPECT_EQ(std::vector<int>({3}), matches);
+}
+
+TEST(GoogleReSetTest, NoMatch) {
+  GoogleReSet set;
+  set.add("/foo");
+  set.add("/bar");
+  set.compile();
+
+  std::vector<int> matches{5};
+  EXPECT_TRUE(set.match("/baz", matches));
+  EXPECT_TRUE(matches.empty());
+}
+
+TEST(GoogleReSetTest, InvalidRegex) {
+  GoogleReSet set;
+  EXPECT_THROW_WITH_REGEX(set.add("(+invalid)"), EnvoyException,
+                          "Invalid regex '\\(\\+invalid\\)':");
+}
+
+} // namespace
+} // namespace Regex
+} // namespace Envoy
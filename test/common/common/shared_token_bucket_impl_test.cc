@@ -0,0 +1,74 @@
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <vector>
+
+#include "common/common/shared_token_bucket_impl.h"
+#include "common/common/thread.h"
+
+#include "test/test_common/simulated_time_system.h"
+
+#include "gtest/gtest.h"
+
+namespace Envoy {
+
+class SharedTokenBucketImplTest : public testing::Test {
+protected:
+  Event::SimulatedTimeSystem time_system_;
+};
+
+TEST_F(SharedTokenBucketImplTest, Consume) {
+  SharedTokenBucketImpl token_bucket{2, time_system_, 1};
+
+  EXPECT_TRUE(token_bucket.consume(2));
+  EXPECT_FALSE(token_bucket.consume());
+  EXPECT_EQ(1000, token_bucket.nextTokenAvailableMs());
+
+  time_system_.setMonotonicTime(std::chrono::seconds(1));
+  EXPECT_TRUE(token_bucket.consume());
+}
+
+// Tokens are refilled continuously, including fractions of a token.
+TEST_F(SharedTokenBucketImplTest, PartialRefill) {
+  SharedTokenBucketImpl token_bucket{10, time_system_, 10};
+
+  EXPECT_TRUE(token_bucket.consume(10));
+  EXPECT_FALSE(token_bucket.consume());
+  EXPECT_EQ(100, token_bucket.nextTokenAvailableMs());
+
+  time_system_.setMonotonicTime(std::chrono::milliseconds(250));
+  EXPECT_TRUE(token_bucket.consume(2));
+  EXPECT_FALSE(token_bucket.consume());
+  EXPECT_EQ(50, token_bucket.nextTokenAvailableMs());
+
+  // The bucket doesn't fill beyond its size.
+  time_system_.setMonotonicTime(std::chrono::seconds(10));
+  EXPECT_EQ(0, token_bucket.nextTokenAvailableMs());
+  EXPECT_TRUE(token_bucket.consume(10));
+  EXPECT_FALSE(token_bucket.consume());
+}
+
+// Threads consuming from the same bucket get exactly the tokens in it between them.
+TEST_F(SharedTokenBucketImplTest, ConsumeFromManyThreads) {
+  SharedTokenBucketImpl token_bucket{1000, time_system_, 1};
+  std::atomic<uint64_t> consumed{0};
+
+  std::vector<std::unique_ptr<Thread::Thread>> threads;
+  for (uint32_t i = 0; i < 4; i++) {
+    threads.emplace_back(new Thread::Thread([&token_bucket, &consumed]() {
+      for (uint32_t j = 0; j < 500; j++) {
+        if (token_bucket.consume()) {
+          consumed++;
+        }
+      }
+    }));
+  }
+  for (auto& thread : threads) {
+    thread->join();
+  }
+
+  EXPECT_EQ(1000, consumed);
+  EXPECT_FALSE(token_bucket.consume());
+}
+
+} // namespace Envoy
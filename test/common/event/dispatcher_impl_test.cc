@@ -5,12 +5,17 @@
 #include "common/event/dispatcher_impl.h"
 
 #include "test/mocks/common.h"
+#include "test/mocks/stats/mocks.h"
 #include "test/test_common/test_time.h"
 
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
 
+using testing::_;
+using testing::AnyNumber;
 using testing::InSequence;
+using testing::NiceMock;
+using testing::Property;
 
 namespace Envoy {
 namespace Event {
@@ -119,7 +124,7 @@ TEST_F(DispatcherImplTest, RunPostCallbacksLocking) {
     // Block dispatcher first to ensure that both posted events below are handled
     // by a single call to runPostCallbacks().
     //
-    // This also ensures that the post_lock_ is not held while callbacks are called,
+    // This also ensures that no lock is held while callbacks are called,
     // or else this would deadlock.
     Thread::LockGuard lock(mu_);
     dispatcher_->post([this]() { Thread::LockGuard lock(mu_); });
@@ -168,5 +173,60 @@ TEST_F(DispatcherImplTest, Timer) {
   }
 }
 
+TEST_F(DispatcherImplTest, CoarseTimer) {
+  TimerPtr timer;
+  dispatcher_->post([this, &timer]() {
+    timer = dispatcher_->createTimer(
+        [this]() {
+          {
+            Thread::LockGuard lock(mu_);
+            work_finished_ = true;
+          }
+          cv_.notifyOne();
+        },
+        TimerResolution::Coarse);
+    timer->enableTimer(std::chrono::milliseconds(50));
+  });
+
+  Thread::LockGuard lock(mu_);
+  while (!work_finished_) {
+    cv_.wait(mu_);
+  }
+}
+
+// With stats initialized the loop is run an iteration at a time, which must still stop on exit().
+TEST(DispatcherStatsTest, RecordIterations) {
+  NiceMock<Stats::MockIsolatedStatsStore> store;
+  DangerousDeprecatedTestTime test_time;
+  DispatcherImpl dispatcher(test_time.timeSystem());
+  dispatcher.initializeStats(store, "test.");
+
+  EXPECT_CALL(store, deliverHistogramToSinks(_, _)).Times(AnyNumber());
+  EXPECT_CALL(store, deliverHistogramToSinks(
+                         Property(&Stats::Metric::name, "test.dispatcher.post_queue_depth"), 2));
+  dispatcher.post([]() {});
+  dispatcher.post([]() {});
+  dispatcher.run(Dispatcher::RunType::NonBlock);
+  testing::Mock::VerifyAndClearExpectations(&store);
+
+  // Each timer fires in an iteration of its own.
+  uint32_t fired = 0;
+  TimerPtr timer;
+  timer = dispatcher.createTimer([&]() -> void {
+    if (++fired == 3) {
+      dispatcher.exit();
+    } else {
+      timer->enableTimer(std::chrono::milliseconds(1));
+    }
+  });
+  EXPECT_CALL(store, deliverHistogramToSinks(_, _)).Times(AnyNumber());
+  EXPECT_CALL(store, deliverHistogramToSinks(
+                         Property(&Stats::Metric::name, "test.dispatcher.loop_events"), 1))
+      .Times(3);
+  timer->enableTimer(std::chrono::milliseconds(1));
+  dispatcher.run(Dispatcher::RunType::Block);
+  EXPECT_EQ(3, fired);
+}
+
 } // namespace Event
 } // namespace Envoy
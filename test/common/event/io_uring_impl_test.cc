@@ -0,0 +1,175 @@
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "common/event/dispatcher_impl.h"
+#include "common/event/io_uring_impl.h"
+
+#include "test/test_common/test_time.h"
+
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Event {
+namespace {
+
+class TestRequest : public IoUringRequest {
+public:
+  TestRequest(std::function<void(int32_t)> on_completion) : on_completion_(on_completion) {}
+
+  // Event::IoUringRequest
+  void onCompletion(int32_t result) override { on_completion_(result); }
+
+private:
+  std::function<void(int32_t)> on_completion_;
+};
+
+IoUringRequestPtr request(std::function<void(int32_t)> on_completion) {
+  return IoUringRequestPtr{new TestRequest(on_completion)};
+}
+
+class IoUringImplTest : public testing::Test {
+public:
+  IoUringImplTest() : dispatcher_(test_time_.timeSystem()) {}
+
+  void SetUp() override {
+    if (!IoUringImpl::isSupported()) {
+      return;
+    }
+    ring_ = IoUringImpl::create(dispatcher_, 4);
+    ASSERT_NE(nullptr, ring_);
+    ASSERT_EQ(0, socketpair(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK, 0, fds_));
+  }
+
+  void TearDown() override {
+    ring_.reset();
+    if (fds_[0] != -1) {
+      close(fds_[0]);
+      close(fds_[1]);
+    }
+  }
+
+  // Runs the dispatcher until result has been set by a completion.
+  void waitFor(const int32_t& result) {
+    while (result == NoResult) {
+      dispatcher_.run(Dispatcher::RunType::NonBlock);
+    }
+  }
+
+  static constexpr int32_t NoResult = 1 << 30;
+
+  DangerousDeprecatedTestTime test_time_;
+  DispatcherImpl dispatcher_;
+  IoUringImplPtr ring_;
+  int fds_[2]{-1, -1};
+};
+
+constexpr int32_t IoUringImplTest::NoResult;
+
+// A receive waits for data, rather than completing with EAGAIN like recv() on the non-blocking
+// socket.
+TEST_F(IoUringImplTest, RecvWaitsForData) {
+  if (ring_ == nullptr) {
+    return;
+  }
+  char buffer[64];
+  int32_t result = NoResult;
+  ring_->recv(fds_[0], buffer, sizeof(buffer), request([&](int32_t r) { result = r; }));
+  for (uint32_t i = 0; i < 5; i++) {
+    dispatcher_.run(Dispatcher::RunType::NonBlock);
+  }
+  EXPECT_EQ(NoResult, result);
+  EXPECT_EQ(1, ring_->pendingRequests());
+
+  ASSERT_EQ(5, write(fds_[1], "hello", 5));
+  waitFor(result);
+  EXPECT_EQ(5, result);
+  EXPECT_EQ("hello", std::string(buffer, 5));
+  EXPECT_EQ(0, ring_->pendingRequests());
+}
+
+TEST_F(IoUringImplTest, Sendmsg) {
+  if (ring_ == nullptr) {
+    return;
+  }
+  char first[] = "ab";
+  char second[] = "cde";
+  iovec iovecs[2] = {{first, 2}, {second, 3}};
+  msghdr message{};
+  message.msg_iov = iovecs;
+  message.msg_iovlen = 2;
+  int32_t result = NoResult;
+  ring_->sendmsg(fds_[0], message, request([&](int32_t r) { result = r; }));
+  waitFor(result);
+  EXPECT_EQ(5, result);
+
+  char buffer[64];
+  ASSERT_EQ(5, read(fds_[1], buffer, sizeof(buffer)));
+  EXPECT_EQ("abcde", std::string(buffer, 5));
+}
+
+// A cancelled request still completes, with -ECANCELED.
+TEST_F(IoUringImplTest, Cancel) {
+  if (ring_ == nullptr) {
+    return;
+  }
+  char buffer[64];
+  int32_t result = NoResult;
+  IoUringRequest& recv =
+      ring_->recv(fds_[0], buffer, sizeof(buffer), request([&](int32_t r) { result = r; }));
+  dispatcher_.run(Dispatcher::RunType::NonBlock);
+  ring_->cancel(recv);
+  waitFor(result);
+  EXPECT_EQ(-ECANCELED, result);
+  EXPECT_EQ(0, ring_->pendingRequests());
+}
+
+// More operations than the submission ring has entries may be queued between submissions.
+TEST_F(IoUringImplTest, MoreRequestsThanEntries) {
+  if (ring_ == nullptr) {
+    return;
+  }
+  const uint32_t sockets = 50;
+  std::vector<int> fds(2 * sockets);
+  std::vector<int32_t> results(sockets, NoResult);
+  std::vector<char> buffers(sockets);
+  for (uint32_t i = 0; i < sockets; i++) {
+    ASSERT_EQ(0, socketpair(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK, 0, &fds[2 * i]));
+    ring_->recv(fds[2 * i], &buffers[i], 1, request([&results, i](int32_t r) { results[i] = r; }));
+  }
+  for (uint32_t i = 0; i < sockets; i++) {
+    ASSERT_EQ(1, write(fds[2 * i + 1], "x", 1));
+  }
+  for (uint32_t i = 0; i < sockets; i++) {
+    waitFor(results[i]);
+    EXPECT_EQ(1, results[i]);
+    EXPECT_EQ('x', buffers[i]);
+  }
+  EXPECT_EQ(0, ring_->pendingRequests());
+  for (const int fd : fds) {
+    close(fd);
+  }
+}
+
+// Requests which have not completed when the ring is destroyed are cancelled and completed, so
+// the memory they refer to is not written to afterwards.
+TEST_F(IoUringImplTest, DestroyWithPendingRequest) {
+  if (ring_ == nullptr) {
+    return;
+  }
+  char buffer[64];
+  int32_t result = NoResult;
+  ring_->recv(fds_[0], buffer, sizeof(buffer), request([&](int32_t r) { result = r; }));
+  dispatcher_.run(Dispatcher::RunType::NonBlock);
+  ring_.reset();
+  EXPECT_EQ(-ECANCELED, result);
+}
+
+} // namespace
+} // namespace Event
+} // namespace Envoy
@@ -0,0 +1,95 @@
+#include <chrono>
+
+#include "common/event/loop_stats.h"
+
+#include "test/mocks/stats/mocks.h"
+#include "test/test_common/simulated_time_system.h"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+using testing::_;
+using testing::NiceMock;
+using testing::Property;
+
+namespace Envoy {
+namespace Event {
+namespace {
+
+class LoopStatsTest : public testing::Test {
+protected:
+  LoopStatsTest()
+      : loop_stats_(time_system_,
+                    DispatcherStats{ALL_DISPATCHER_STATS(POOL_COUNTER_PREFIX(store_, "test."),
+                                                         POOL_HISTOGRAM_PREFIX(store_, "test."))}) {
+    time_system_.setMonotonicTime(std::chrono::seconds(1));
+  }
+
+  // Runs an event of the given type which takes the given time.
+  void event(LoopStats::EventType type, std::chrono::nanoseconds duration) {
+    LoopStats::EventScope scope(&loop_stats_, type);
+    time_system_.sleep(duration);
+  }
+
+  void expectHistogram(const std::string& name, uint64_t value) {
+    EXPECT_CALL(store_, deliverHistogramToSinks(Property(&Stats::Metric::name, name), value));
+  }
+
+  SimulatedTimeSystem time_system_;
+  NiceMock<Stats::MockIsolatedStatsStore> store_;
+  LoopStats loop_stats_;
+};
+
+// An iteration is timed from the start of its first event to the end of its last one, and the time
+// of each event is added to the counter of its type.
+TEST_F(LoopStatsTest, Iteration) {
+  // Waiting for events is not part of the iteration.
+  time_system_.sleep(std::chrono::milliseconds(5));
+  event(LoopStats::EventType::FileEvent, std::chrono::microseconds(10));
+  event(LoopStats::EventType::Timer, std::chrono::microseconds(5));
+  event(LoopStats::EventType::FileEvent, std::chrono::microseconds(20));
+
+  expectHistogram("test.loop_duration_us", 35);
+  expectHistogram("test.loop_events", 3);
+  loop_stats_.onIterationEnd();
+  EXPECT_EQ(30, store_.counter("test.file_event_time_us").value());
+  EXPECT_EQ(5, store_.counter("test.timer_time_us").value());
+  EXPECT_EQ(0, store_.counter("test.post_time_us").value());
+
+  // An iteration without events is not recorded.
+  EXPECT_CALL(store_, deliverHistogramToSinks(_, _)).Times(0);
+  loop_stats_.onIterationEnd();
+}
+
+// Time below a microsecond is carried over to the next iteration rather than dropped.
+TEST_F(LoopStatsTest, SubMicrosecondEvents) {
+  for (uint32_t i = 0; i < 5; i++) {
+    event(LoopStats::EventType::Post, std::chrono::nanoseconds(400));
+    loop_stats_.onIterationEnd();
+  }
+  EXPECT_EQ(2, store_.counter("test.post_time_us").value());
+}
+
+// The wait of the post queue is measured from when a callback is posted to the empty queue.
+TEST_F(LoopStatsTest, PostWait) {
+  loop_stats_.onPostQueued();
+  time_system_.sleep(std::chrono::microseconds(30));
+  expectHistogram("test.post_wait_us", 30);
+  loop_stats_.onPostRun();
+
+  // The queue was run already.
+  EXPECT_CALL(store_, deliverHistogramToSinks(_, _)).Times(0);
+  loop_stats_.onPostRun();
+}
+
+// Timers which fire early, as far as the clock is concerned, are recorded as on time.
+TEST_F(LoopStatsTest, TimerLag) {
+  expectHistogram("test.timer_lag_us", 1500);
+  loop_stats_.onTimerLag(std::chrono::microseconds(1500));
+  expectHistogram("test.timer_lag_us", 0);
+  loop_stats_.onTimerLag(-std::chrono::microseconds(10));
+}
+
+} // namespace
+} // namespace Event
+} // namespace Envoy
@@ -0,0 +1,98 @@
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "common/common/thread.h"
+#include "common/event/post_queue.h"
+
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Event {
+namespace {
+
+TEST(PostQueueTest, RunInOrder) {
+  PostQueue queue;
+  std::vector<int> ran;
+  EXPECT_TRUE(queue.push([&]() { ran.push_back(1); }));
+  EXPECT_FALSE(queue.push([&]() { ran.push_back(2); }));
+  EXPECT_FALSE(queue.push([&]() { ran.push_back(3); }));
+
+  queue.runAll();
+  EXPECT_EQ((std::vector<int>{1, 2, 3}), ran);
+
+  // The queue is empty again, and recycled nodes are reused.
+  EXPECT_TRUE(queue.push([&]() { ran.push_back(4); }));
+  queue.runAll();
+  EXPECT_EQ((std::vector<int>{1, 2, 3, 4}), ran);
+}
+
+TEST(PostQueueTest, PushFromCallback) {
+  PostQueue queue;
+  std::vector<int> ran;
+  queue.push([&]() {
+    ran.push_back(1);
+    queue.push([&]() { ran.push_back(3); });
+  });
+  queue.push([&]() { ran.push_back(2); });
+
+  queue.runAll();
+  EXPECT_EQ((std::vector<int>{1, 2, 3}), ran);
+}
+
+TEST(PostQueueTest, DestroyCallbackBeforeNextRuns) {
+  PostQueue queue;
+  auto captured = std::make_shared<int>(1);
+  std::weak_ptr<int> weak = captured;
+  queue.push([captured]() {});
+  captured.reset();
+  queue.push([&]() { EXPECT_TRUE(weak.expired()); });
+  queue.runAll();
+}
+
+TEST(PostQueueTest, DestroyDropsCallbacks) {
+  auto captured = std::make_shared<int>(1);
+  std::weak_ptr<int> weak = captured;
+  {
+    PostQueue queue;
+    queue.push([captured]() { FAIL(); });
+    captured.reset();
+  }
+  EXPECT_TRUE(weak.expired());
+}
+
+// Callbacks pushed by several threads at once all run once, in the order each thread pushed them.
+TEST(PostQueueTest, ConcurrentPush) {
+  constexpr uint32_t Producers = 4;
+  constexpr uint32_t PushesPerProducer = 10000;
+  PostQueue queue;
+  std::vector<uint32_t> ran(Producers);
+
+  std::vector<std::unique_ptr<Thread::Thread>> threads;
+  for (uint32_t producer = 0; producer < Producers; producer++) {
+    threads.push_back(std::make_unique<Thread::Thread>([&queue, &ran, producer]() {
+      for (uint32_t i = 0; i < PushesPerProducer; i++) {
+        queue.push([&ran, producer, i]() { EXPECT_EQ(i, ran[producer]++); });
+      }
+    }));
+  }
+
+  uint32_t total;
+  do {
+    queue.runAll();
+    total = 0;
+    for (uint32_t count : ran) {
+      total += count;
+    }
+  } while (total < Producers * PushesPerProducer);
+
+  for (auto& thread : threads) {
+    thread->join();
+  }
+  queue.runAll();
+  EXPECT_EQ(std::vector<uint32_t>(Producers, PushesPerProducer), ran);
+}
+
+} // namespace
+} // namespace Event
+} // namespace Envoy
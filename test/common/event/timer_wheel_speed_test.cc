@@ -0,0 +1,64 @@
+// Note: this should be run with --compilation_mode=opt, and would benefit from a
+// quiescent system with disabled cstate power management.
+//
+// Simulates the timer churn of a worker with many connections and streams, each of which has an
+// idle timeout that is pushed back whenever there is activity, and is usually disabled before it
+// fires. Each iteration enables one of the timers again with a new timeout, or disables it. The
+// timers are either libevent timers, or timers in a TimerWheel.
+
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include "common/event/libevent.h"
+#include "common/event/real_time_system.h"
+#include "common/event/timer_wheel.h"
+
+#include "event2/event.h"
+#include "testing/base/public/benchmark.h"
+
+namespace Envoy {
+namespace Event {
+namespace {
+
+template <TimerResolution resolution> void BM_TimerChurn(benchmark::State& state) {
+  RealTimeSystem time_system;
+  Libevent::BasePtr base(event_base_new());
+  SchedulerPtr scheduler = time_system.createScheduler(base);
+  TimerWheel wheel(time_system, *scheduler, CoarseTimerResolution);
+  std::minstd_rand random;
+
+  std::vector<TimerPtr> timers;
+  for (int64_t i = 0; i < state.range(0); i++) {
+    timers.push_back(resolution == TimerResolution::Coarse ? wheel.createTimer([]() {})
+                                                           : scheduler->createTimer([]() {}));
+    timers.back()->enableTimer(std::chrono::milliseconds(60000 + random() % 60000));
+  }
+
+  for (auto _ : state) {
+    Timer& timer = *timers[random() % timers.size()];
+    if (random() % 8 == 0) {
+      timer.disableTimer();
+    } else {
+      timer.enableTimer(std::chrono::milliseconds(60000 + random() % 60000));
+    }
+  }
+}
+BENCHMARK_TEMPLATE(BM_TimerChurn, TimerResolution::Precise)->Arg(1000)->Arg(100000)->Arg(500000);
+BENCHMARK_TEMPLATE(BM_TimerChurn, TimerResolution::Coarse)->Arg(1000)->Arg(100000)->Arg(500000);
+
+} // namespace
+} // namespace Event
+} // namespace Envoy
+
+// Boilerplate main(), which discovers benchmarks in the same file and runs them.
+int main(int argc, char** argv) {
+  benchmark::Initialize(&argc, argv);
+
+  if (benchmark::ReportUnrecognizedArguments(argc, argv)) {
+    return 1;
+  }
+  benchmark::RunSpecifiedBenchmarks();
+}
@@ -0,0 +1,107 @@
+#include <chrono>
+#include <vector>
+
+#include "common/event/libevent.h"
+#include "common/event/timer_wheel.h"
+
+#include "test/test_common/simulated_time_system.h"
+
+#include "event2/event.h"
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Event {
+namespace {
+
+class TimerWheelTest : public testing::Test {
+protected:
+  TimerWheelTest()
+      : event_system_(event_base_new()), scheduler_(time_system_.createScheduler(event_system_)),
+        wheel_(time_system_, *scheduler_, CoarseTimerResolution) {}
+
+  void sleepAndLoop(std::chrono::milliseconds duration) {
+    time_system_.sleep(duration);
+    event_base_loop(event_system_.get(), EVLOOP_NONBLOCK);
+  }
+
+  SimulatedTimeSystem time_system_;
+  Libevent::BasePtr event_system_;
+  SchedulerPtr scheduler_;
+  TimerWheel wheel_;
+};
+
+// Timers fire after their timeout and at most one tick later, whichever level of the wheel they
+// start in.
+TEST_F(TimerWheelTest, FireWithinResolution) {
+  // The extra millisecond is for the wheel's own timer, which has millisecond resolution.
+  const std::chrono::milliseconds slack = CoarseTimerResolution + std::chrono::milliseconds(1);
+  for (const std::chrono::milliseconds timeout :
+       {std::chrono::milliseconds(1), std::chrono::milliseconds(100),
+        std::chrono::milliseconds(5000), std::chrono::milliseconds(600000),
+        std::chrono::milliseconds(7200000), std::chrono::milliseconds(30LL * 24 * 3600 * 1000)}) {
+    const MonotonicTime enabled = time_system_.monotonicTime();
+    MonotonicTime fired;
+    uint32_t fire_count = 0;
+    TimerPtr timer = wheel_.createTimer([&]() {
+      fired = time_system_.monotonicTime();
+      fire_count++;
+    });
+    timer->enableTimer(timeout);
+
+    sleepAndLoop(timeout - std::chrono::milliseconds(1));
+    EXPECT_EQ(0U, fire_count) << timeout.count();
+    sleepAndLoop(slack);
+    EXPECT_EQ(1U, fire_count) << timeout.count();
+    EXPECT_GE(fired, enabled + timeout);
+  }
+}
+
+TEST_F(TimerWheelTest, DisableTimer) {
+  bool fired = false;
+  TimerPtr timer = wheel_.createTimer([&]() { fired = true; });
+  timer->enableTimer(std::chrono::milliseconds(100));
+  timer->disableTimer();
+  sleepAndLoop(std::chrono::milliseconds(1000));
+  EXPECT_FALSE(fired);
+
+  // Destroying an enabled timer disables it.
+  timer->enableTimer(std::chrono::milliseconds(100));
+  timer.reset();
+  sleepAndLoop(std::chrono::milliseconds(1000));
+  EXPECT_FALSE(fired);
+}
+
+TEST_F(TimerWheelTest, EnableAgainResetsTimeout) {
+  bool fired = false;
+  TimerPtr timer = wheel_.createTimer([&]() { fired = true; });
+  timer->enableTimer(std::chrono::milliseconds(100));
+  sleepAndLoop(std::chrono::milliseconds(50));
+  timer->enableTimer(std::chrono::milliseconds(100));
+  sleepAndLoop(std::chrono::milliseconds(90));
+  EXPECT_FALSE(fired);
+  sleepAndLoop(std::chrono::milliseconds(30));
+  EXPECT_TRUE(fired);
+}
+
+// Timers which fire in the same tick all fire, including ones enabled by their callbacks.
+TEST_F(TimerWheelTest, ManyTimers) {
+  std::vector<uint32_t> fired(100);
+  std::vector<TimerPtr> timers;
+  for (uint32_t i = 0; i < fired.size(); i++) {
+    timers.push_back(wheel_.createTimer([&, i]() {
+      if (fired[i]++ == 0) {
+        timers[i]->enableTimer(std::chrono::milliseconds(1000));
+      }
+    }));
+    timers.back()->enableTimer(std::chrono::milliseconds(500 + i % 2));
+  }
+
+  sleepAndLoop(std::chrono::milliseconds(520));
+  EXPECT_EQ(std::vector<uint32_t>(fired.size(), 1), fired);
+  sleepAndLoop(std::chrono::milliseconds(1000));
+  EXPECT_EQ(std::vector<uint32_t>(fired.size(), 2), fired);
+}
+
+} // namespace
+} // namespace Event
+} // namespace Envoy
@@ -976,6 +976,48 @@ TEST_F(HttpConnectionManagerImplTest, TestAccessLog) {
   conn_manager_->onData(fake_input, false);
 }
 
+TEST_F(HttpConnectionManagerImplTest, ArenaStats) {
+  setup(false, "");
+
+  std::shared_ptr<MockStreamDecoderFilter> filter(new NiceMock<MockStreamDecoderFilter>());
+  std::shared_ptr<AccessLog::MockInstance> handler(new NiceMock<AccessLog::MockInstance>());
+  uint32_t num_filters = 1;
+  EXPECT_CALL(filter_factory_, createFilterChain(_))
+      .WillRepeatedly(Invoke([&](FilterChainFactoryCallbacks& callbacks) -> void {
+        for (uint32_t i = 0; i < num_filters; i++) {
+          callbacks.addStreamDecoderFilter(filter);
+        }
+        callbacks.addAccessLogHandler(handler);
+      }));
+
+  NiceMock<MockStreamEncoder> encoder;
+  EXPECT_CALL(*codec_, dispatch(_)).WillRepeatedly(Invoke([&](Buffer::Instance& data) -> void {
+    StreamDecoder* decoder = &conn_manager_->newStream(encoder);
+    HeaderMapPtr headers{
+        new TestHeaderMapImpl{{":authority", "host"}, {":path", "/"}, {":method", "GET"}}};
+    decoder->decodeHeaders(std::move(headers), true);
+
+    HeaderMapPtr response_headers{new TestHeaderMapImpl{{":status", "200"}}};
+    filter->callbacks_->encodeHeaders(std::move(response_headers), true);
+    data.drain(4);
+  }));
+
+  // The filter wrapper, its list node and the access log handler's list node fit in the arena.
+  Buffer::OwnedImpl fake_input("1234");
+  conn_manager_->onData(fake_input, false);
+  filter_callbacks_.connection_.dispatcher_.clearDeferredDeleteList();
+  EXPECT_EQ(3U, stats_.named_.downstream_rq_arena_allocations_.value());
+  EXPECT_EQ(0U, stats_.named_.downstream_rq_arena_overflow_.value());
+
+  // A long filter chain spills over onto the heap.
+  num_filters = 32;
+  fake_input.add("1234");
+  conn_manager_->onData(fake_input, false);
+  filter_callbacks_.connection_.dispatcher_.clearDeferredDeleteList();
+  EXPECT_EQ(3U + 2 * 32 + 1, stats_.named_.downstream_rq_arena_allocations_.value());
+  EXPECT_EQ(1U, stats_.named_.downstream_rq_arena_overflow_.value());
+}
+
 TEST_F(HttpConnectionManagerImplTest, TestAccessLogWithTrailers) {
   setup(false, "");
 
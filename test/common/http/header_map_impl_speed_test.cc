@@ -0,0 +1,193 @@
+// Note: this should be run with --compilation_mode=opt, and would benefit from a
+// quiescent system with disabled cstate power management.
+//
+// Every benchmark takes the storage as its first argument: 0 for contiguous storage and 1 for
+// std::list storage. The second argument is the number of headers in the request.
+
+#include <string>
+#include <vector>
+
+#include "common/http/header_map_impl.h"
+#include "common/http/header_name_registry.h"
+
+#include "testing/base/public/benchmark.h"
+
+namespace Envoy {
+namespace Http {
+
+namespace {
+
+// The pseudo headers and common headers of a typical request, followed by custom headers up to the
+// requested count.
+class RequestHeaders {
+public:
+  explicit RequestHeaders(uint64_t count) {
+    const std::vector<std::pair<std::string, std::string>> common = {
+        {":method", "GET"},
+        {":path", "/api/v1/items?page=2"},
+        {":scheme", "https"},
+        {":authority", "api.example.com"},
+        {"user-agent", "Mozilla/5.0 (X11; Linux x86_64)"},
+        {"accept", "application/json"},
+        {"accept-encoding", "gzip, deflate, br"},
+        {"accept-language", "en-US,en;q=0.9"},
+        {"cache-control", "no-cache"},
+        {"x-forwarded-for", "10.0.0.1"},
+        {"x-forwarded-proto", "https"},
+        {"x-request-id", "8f6d5d4c-5d0c-4a4e-9d36-2d5a8c8f0e77"},
+    };
+    for (uint64_t i = 0; i < count; i++) {
+      if (i < common.size()) {
+        keys_.emplace_back(common[i].first);
+        values_.push_back(common[i].second);
+      } else {
+        keys_.emplace_back("x-custom-header-" + std::to_string(i));
+        values_.push_back("custom-value-" + std::to_string(i));
+      }
+    }
+  }
+
+  // Adds the headers by copy, as the HTTP/1 codec does.
+  void addTo(HeaderMapImpl& headers) const {
+    for (size_t i = 0; i < keys_.size(); i++) {
+      HeaderString key;
+      key.setCopy(keys_[i].get().c_str(), keys_[i].get().size());
+      HeaderString value;
+      value.setCopy(values_[i].c_str(), values_[i].size());
+      headers.addViaMove(std::move(key), std::move(value));
+    }
+  }
+
+  const LowerCaseString& key(size_t i) const { return keys_[i]; }
+  size_t size() const { return keys_.size(); }
+
+private:
+  std::vector<LowerCaseString> keys_;
+  std::vector<std::string> values_;
+};
+
+// Runs a benchmark for each storage with 20, 30 and 40 request headers.
+void storageAndHeaderCounts(benchmark::internal::Benchmark* b) {
+  for (int storage : {0, 1}) {
+    for (int headers : {20, 30, 40}) {
+      b->Args({storage, headers});
+    }
+  }
+}
+
+} // namespace
+
+// Builds and destroys a header map, as a codec does for each request.
+static void BM_HeaderMapPopulate(benchmark::State& state) {
+  HeaderMapImpl::useListStorage(state.range(0));
+  const RequestHeaders request(state.range(1));
+  uint64_t size = 0;
+  for (auto _ : state) {
+    HeaderMapImpl headers;
+    request.addTo(headers);
+    size += headers.size();
+  }
+  benchmark::DoNotOptimize(size);
+}
+BENCHMARK(BM_HeaderMapPopulate)->Apply(storageAndHeaderCounts);
+
+// Iterates all headers, as the codecs do when encoding and access logs do when formatting.
+static void BM_HeaderMapIterate(benchmark::State& state) {
+  HeaderMapImpl::useListStorage(state.range(0));
+  const RequestHeaders request(state.range(1));
+  HeaderMapImpl headers;
+  request.addTo(headers);
+  uint64_t bytes = 0;
+  for (auto _ : state) {
+    headers.iterate(
+        [](const HeaderEntry& header, void* context) -> HeaderMap::Iterate {
+          *static_cast<uint64_t*>(context) += header.key().size() + header.value().size();
+          return HeaderMap::Iterate::Continue;
+        },
+        &bytes);
+  }
+  benchmark::DoNotOptimize(bytes);
+}
+BENCHMARK(BM_HeaderMapIterate)->Apply(storageAndHeaderCounts);
+
+// Looks up headers which are not inline, which scans the map, as route matching on custom headers
+// does.
+static void BM_HeaderMapGet(benchmark::State& state) {
+  HeaderMapImpl::useListStorage(state.range(0));
+  const RequestHeaders request(state.range(1));
+  HeaderMapImpl headers;
+  request.addTo(headers);
+  const LowerCaseString& last = request.key(request.size() - 1);
+  const LowerCaseString missing("x-not-present");
+  uint64_t found = 0;
+  for (auto _ : state) {
+    found += headers.get(last) != nullptr;
+    found += headers.get(missing) != nullptr;
+  }
+  benchmark::DoNotOptimize(found);
+}
+BENCHMARK(BM_HeaderMapGet)->Apply(storageAndHeaderCounts);
+
+// Looks up the same headers as BM_HeaderMapGet by interned key, as route header matchers do.
+static void BM_HeaderMapGetInterned(benchmark::State& state) {
+  HeaderMapImpl::useListStorage(state.range(0));
+  const RequestHeaders request(state.range(1));
+  HeaderMapImpl headers;
+  request.addTo(headers);
+  const InternedHeaderName last = HeaderNameRegistry::intern(request.key(request.size() - 1));
+  const InternedHeaderName missing = HeaderNameRegistry::intern(LowerCaseString("x-not-present"));
+  uint64_t found = 0;
+  for (auto _ : state) {
+    found += headers.get(last) != nullptr;
+    found += headers.get(missing) != nullptr;
+  }
+  benchmark::DoNotOptimize(found);
+}
+BENCHMARK(BM_HeaderMapGetInterned)->Apply(storageAndHeaderCounts);
+
+// Looks up inline headers, which does not depend on the storage.
+static void BM_HeaderMapLookupInline(benchmark::State& state) {
+  HeaderMapImpl::useListStorage(state.range(0));
+  const RequestHeaders request(state.range(1));
+  HeaderMapImpl headers;
+  request.addTo(headers);
+  uint64_t found = 0;
+  for (auto _ : state) {
+    const HeaderEntry* entry;
+    found += headers.lookup(Headers::get().Path, &entry) == HeaderMap::Lookup::Found;
+    found += headers.Host() != nullptr;
+  }
+  benchmark::DoNotOptimize(found);
+}
+BENCHMARK(BM_HeaderMapLookupInline)->Apply(storageAndHeaderCounts);
+
+// Removes and re-adds headers, as filters which rewrite headers do, which exercises erasing and
+// compaction.
+static void BM_HeaderMapRemoveAndAdd(benchmark::State& state) {
+  HeaderMapImpl::useListStorage(state.range(0));
+  const RequestHeaders request(state.range(1));
+  HeaderMapImpl headers;
+  request.addTo(headers);
+  const std::string value("rewritten");
+  for (auto _ : state) {
+    for (size_t i = request.size() / 2; i < request.size(); i++) {
+      headers.remove(request.key(i));
+      headers.addReferenceKey(request.key(i), value);
+    }
+  }
+  benchmark::DoNotOptimize(headers.size());
+}
+BENCHMARK(BM_HeaderMapRemoveAndAdd)->Apply(storageAndHeaderCounts);
+
+} // namespace Http
+} // namespace Envoy
+
+// Boilerplate main(), which discovers benchmarks in the same file and runs them.
+int main(int argc, char** argv) {
+  benchmark::Initialize(&argc, argv);
+
+  if (benchmark::ReportUnrecognizedArguments(argc, argv)) {
+    return 1;
+  }
+  benchmark::RunSpecifiedBenchmarks();
+}
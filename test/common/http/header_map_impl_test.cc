@@ -1,7 +1,9 @@
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "common/http/header_map_impl.h"
+#include "common/http/header_name_registry.h"
 
 #include "test/test_common/printers.h"
 #include "test/test_common/utility.h"
@@ -276,7 +278,16 @@ TEST(HeaderStringTest, All) {
   }
 }
 
-TEST(HeaderMapImplTest, InlineInsert) {
+// Runs each test with both the contiguous and the std::list storage.
+class HeaderMapImplTest : public testing::TestWithParam<bool> {
+public:
+  HeaderMapImplTest() { HeaderMapImpl::useListStorage(GetParam()); }
+  ~HeaderMapImplTest() { HeaderMapImpl::useListStorage(false); }
+};
+
+INSTANTIATE_TEST_CASE_P(HeaderMapImplTest, HeaderMapImplTest, testing::Bool());
+
+TEST_P(HeaderMapImplTest, InlineInsert) {
   HeaderMapImpl headers;
   EXPECT_EQ(nullptr, headers.Host());
   headers.insertHost().value(std::string("hello"));
@@ -285,7 +296,7 @@ TEST(HeaderMapImplTest, InlineInsert) {
   EXPECT_STREQ("hello", headers.get(Headers::get().Host)->value().c_str());
 }
 
-TEST(HeaderMapImplTest, MoveIntoInline) {
+TEST_P(HeaderMapImplTest, MoveIntoInline) {
   HeaderMapImpl headers;
   HeaderString key;
   key.setCopy(Headers::get().CacheControl.get().c_str(), Headers::get().CacheControl.get().size());
@@ -304,7 +315,7 @@ TEST(HeaderMapImplTest, MoveIntoInline) {
   EXPECT_STREQ("hello,there", headers.CacheControl()->value().c_str());
 }
 
-TEST(HeaderMapImplTest, Remove) {
+TEST_P(HeaderMapImplTest, Remove) {
   HeaderMapImpl headers;
 
   // Add random header and then remove by name.
@@ -335,7 +346,7 @@ TEST(HeaderMapImplTest, Remove) {
   EXPECT_EQ(0UL, headers.size());
 }
 
-TEST(HeaderMapImplTest, RemoveRegex) {
+TEST_P(HeaderMapImplTest, RemoveRegex) {
   // These will match.
   LowerCaseString key1 = LowerCaseString("X-prefix-foo");
   LowerCaseString key3 = LowerCaseString("X-Prefix-");
@@ -372,7 +383,7 @@ TEST(HeaderMapImplTest, RemoveRegex) {
   EXPECT_EQ(nullptr, headers.ContentLength());
 }
 
-TEST(HeaderMapImplTest, SetRemovesAllValues) {
+TEST_P(HeaderMapImplTest, SetRemovesAllValues) {
   HeaderMapImpl headers;
 
   LowerCaseString key1("hello");
@@ -425,7 +436,7 @@ TEST(HeaderMapImplTest, SetRemovesAllValues) {
   }
 }
 
-TEST(HeaderMapImplTest, DoubleInlineAdd) {
+TEST_P(HeaderMapImplTest, DoubleInlineAdd) {
   {
     HeaderMapImpl headers;
     const std::string foo("foo");
@@ -459,7 +470,7 @@ TEST(HeaderMapImplTest, DoubleInlineAdd) {
   }
 }
 
-TEST(HeaderMapImplTest, DoubleInlineSet) {
+TEST_P(HeaderMapImplTest, DoubleInlineSet) {
   HeaderMapImpl headers;
   headers.setReferenceKey(Headers::get().ContentType, "blah");
   headers.setReferenceKey(Headers::get().ContentType, "text/html");
@@ -467,7 +478,7 @@ TEST(HeaderMapImplTest, DoubleInlineSet) {
   EXPECT_EQ(1UL, headers.size());
 }
 
-TEST(HeaderMapImplTest, AddReferenceKey) {
+TEST_P(HeaderMapImplTest, AddReferenceKey) {
   HeaderMapImpl headers;
   LowerCaseString foo("hello");
   headers.addReferenceKey(foo, "world");
@@ -475,7 +486,7 @@ TEST(HeaderMapImplTest, AddReferenceKey) {
   EXPECT_STREQ("world", headers.get(foo)->value().c_str());
 }
 
-TEST(HeaderMapImplTest, SetReferenceKey) {
+TEST_P(HeaderMapImplTest, SetReferenceKey) {
   HeaderMapImpl headers;
   LowerCaseString foo("hello");
   headers.setReferenceKey(foo, "world");
@@ -487,7 +498,7 @@ TEST(HeaderMapImplTest, SetReferenceKey) {
   EXPECT_STREQ("monde", headers.get(foo)->value().c_str());
 }
 
-TEST(HeaderMapImplTest, AddCopy) {
+TEST_P(HeaderMapImplTest, AddCopy) {
   HeaderMapImpl headers;
 
   // Start with a string value.
@@ -556,7 +567,7 @@ TEST(HeaderMapImplTest, AddCopy) {
                headers.get(cache_control)->value().c_str());
 }
 
-TEST(HeaderMapImplTest, Equality) {
+TEST_P(HeaderMapImplTest, Equality) {
   TestHeaderMapImpl headers1;
   TestHeaderMapImpl headers2;
   EXPECT_EQ(headers1, headers2);
@@ -568,7 +579,7 @@ TEST(HeaderMapImplTest, Equality) {
   EXPECT_FALSE(headers1 == headers2);
 }
 
-TEST(HeaderMapImplTest, LargeCharInHeader) {
+TEST_P(HeaderMapImplTest, LargeCharInHeader) {
   HeaderMapImpl headers;
   LowerCaseString static_key("\x90hello");
   std::string ref_value("value");
@@ -576,7 +587,7 @@ TEST(HeaderMapImplTest, LargeCharInHeader) {
   EXPECT_STREQ("value", headers.get(static_key)->value().c_str());
 }
 
-TEST(HeaderMapImplTest, Iterate) {
+TEST_P(HeaderMapImplTest, Iterate) {
   TestHeaderMapImpl headers;
   headers.addCopy("hello", "world");
   headers.addCopy("foo", "xxx");
@@ -599,7 +610,7 @@ TEST(HeaderMapImplTest, Iterate) {
       &cb);
 }
 
-TEST(HeaderMapImplTest, IterateReverse) {
+TEST_P(HeaderMapImplTest, IterateReverse) {
   TestHeaderMapImpl headers;
   headers.addCopy("hello", "world");
   headers.addCopy("foo", "bar");
@@ -625,7 +636,7 @@ TEST(HeaderMapImplTest, IterateReverse) {
       &cb);
 }
 
-TEST(HeaderMapImplTest, Lookup) {
+TEST_P(HeaderMapImplTest, Lookup) {
   TestHeaderMapImpl headers;
   headers.addCopy("hello", "world");
   headers.insertContentLength().value(5);
@@ -652,7 +663,7 @@ TEST(HeaderMapImplTest, Lookup) {
   }
 }
 
-TEST(HeaderMapImplTest, Get) {
+TEST_P(HeaderMapImplTest, Get) {
   {
     const TestHeaderMapImpl headers{{":path", "/"}, {"hello", "world"}};
     EXPECT_STREQ("/", headers.get(LowerCaseString(":path"))->value().c_str());
@@ -670,7 +681,71 @@ TEST(HeaderMapImplTest, Get) {
   }
 }
 
-TEST(HeaderMapImplTest, TestAppendHeader) {
+// Interned keys find the same headers as the equivalent LowerCaseString keys.
+TEST_P(HeaderMapImplTest, InternedKeys) {
+  const InternedHeaderName path = HeaderNameRegistry::intern(Headers::get().Path);
+  const InternedHeaderName host_legacy = HeaderNameRegistry::intern(Headers::get().HostLegacy);
+  const InternedHeaderName hello = HeaderNameRegistry::intern(LowerCaseString("hello"));
+  const InternedHeaderName foo = HeaderNameRegistry::intern(LowerCaseString("foo"));
+
+  TestHeaderMapImpl headers{{":path", "/"}, {"hello", "world"}, {"host", "example.com"}};
+  EXPECT_STREQ("/", headers.get(path)->value().c_str());
+  EXPECT_STREQ("world", headers.get(hello)->value().c_str());
+  EXPECT_EQ(nullptr, headers.get(foo));
+  // The legacy host header is stored as :authority, so there is no header with its key.
+  EXPECT_STREQ("example.com", headers.Host()->value().c_str());
+  EXPECT_EQ(nullptr, headers.get(host_legacy));
+  EXPECT_EQ(nullptr, headers.get(Headers::get().HostLegacy));
+
+  headers.setReferenceKey(hello, "again");
+  headers.addReferenceKey(foo, "bar");
+  headers.addReferenceKey(foo, "baz");
+  headers.setReferenceKey(path, "/new");
+  EXPECT_STREQ("again", headers.get(LowerCaseString("hello"))->value().c_str());
+  EXPECT_STREQ("bar", headers.get(LowerCaseString("foo"))->value().c_str());
+  EXPECT_STREQ("/new", headers.Path()->value().c_str());
+  EXPECT_EQ(5UL, headers.size());
+
+  headers.remove(foo);
+  EXPECT_EQ(nullptr, headers.get(foo));
+  headers.remove(host_legacy);
+  EXPECT_EQ(nullptr, headers.Host());
+  headers.remove(path);
+  EXPECT_EQ(nullptr, headers.Path());
+  EXPECT_EQ((TestHeaderMapImpl{{"hello", "again"}}), headers);
+}
+
+// Once the registry is full, names get ID 0 and are still found by their hash.
+TEST_P(HeaderMapImplTest, InternedKeysPastRegistryCap) {
+  const InternedHeaderName kept = HeaderNameRegistry::intern(LowerCaseString("kept"));
+  EXPECT_NE(0U, kept.id());
+
+  const uint32_t max_names = HeaderNameRegistry::MaxNames;
+  uint32_t i = 0;
+  while (HeaderNameRegistry::intern(LowerCaseString("name-" + std::to_string(i))).id() != 0) {
+    ASSERT_LE(++i, max_names);
+  }
+
+  const InternedHeaderName dropped = HeaderNameRegistry::intern(LowerCaseString("dropped"));
+  const InternedHeaderName dropped_again = HeaderNameRegistry::intern(LowerCaseString("dropped"));
+  const InternedHeaderName other = HeaderNameRegistry::intern(LowerCaseString("other"));
+  EXPECT_EQ(0U, dropped.id());
+  EXPECT_EQ(dropped, dropped_again);
+  EXPECT_NE(dropped, other);
+  EXPECT_EQ(kept.id(), HeaderNameRegistry::intern(LowerCaseString("kept")).id());
+  EXPECT_NE(0U, HeaderNameRegistry::intern(Headers::get().Path).id());
+
+  TestHeaderMapImpl headers{{"dropped", "value"}, {"kept", "value"}};
+  EXPECT_STREQ("value", headers.get(dropped)->value().c_str());
+  EXPECT_EQ(nullptr, headers.get(other));
+  headers.setReferenceKey(other, "set");
+  EXPECT_STREQ("set", headers.get(LowerCaseString("other"))->value().c_str());
+  headers.remove(dropped);
+  EXPECT_EQ(nullptr, headers.get(LowerCaseString("dropped")));
+  EXPECT_EQ((TestHeaderMapImpl{{"kept", "value"}, {"other", "set"}}), headers);
+}
+
+TEST_P(HeaderMapImplTest, TestAppendHeader) {
   // Test appending to a string with a value.
   {
     HeaderString value1;
@@ -705,7 +780,7 @@ TEST(HeaderMapImplTest, TestAppendHeader) {
   }
 }
 
-TEST(HeaderMapImplTest, TestHeaderLengthChecks) {
+TEST_P(HeaderMapImplTest, TestHeaderLengthChecks) {
   HeaderString value;
   value.setCopy("some;", 5);
   EXPECT_DEATH_LOG_TO_STDERR(value.append(nullptr, std::numeric_limits<uint32_t>::max()),
@@ -718,7 +793,7 @@ TEST(HeaderMapImplTest, TestHeaderLengthChecks) {
                              "Trying to allocate overly large headers.");
 }
 
-TEST(HeaderMapImplTest, PseudoHeaderOrder) {
+TEST_P(HeaderMapImplTest, PseudoHeaderOrder) {
   typedef testing::MockFunction<void(const std::string&, const std::string&)> MockCb;
   MockCb cb;
 
@@ -906,7 +981,7 @@ TEST(HeaderMapImplTest, PseudoHeaderOrder) {
 // Validate that TestHeaderMapImpl copy construction and assignment works. This is a
 // regression for where we were missing a valid copy constructor and had the
 // default (dangerous) move semantics takeover.
-TEST(HeaderMapImplTest, TestHeaderMapImplyCopy) {
+TEST_P(HeaderMapImplTest, TestHeaderMapImplyCopy) {
   TestHeaderMapImpl foo;
   foo.addCopy(LowerCaseString("foo"), "bar");
   auto headers = std::make_unique<TestHeaderMapImpl>(foo);
@@ -919,5 +994,77 @@ TEST(HeaderMapImplTest, TestHeaderMapImplyCopy) {
   EXPECT_STREQ("bar", baz.get(LowerCaseString("foo"))->value().c_str());
 }
 
+TEST_P(HeaderMapImplTest, StorageSelection) {
+  HeaderMapImpl headers;
+  EXPECT_EQ(GetParam(), headers.usesListStorage());
+}
+
+// Entry pointers, including the inline ones, stay valid while other headers are added and removed.
+TEST_P(HeaderMapImplTest, EntriesDoNotMove) {
+  HeaderMapImpl headers;
+  HeaderEntry& host = headers.insertHost();
+  host.value(std::string("host"));
+  LowerCaseString first("first");
+  headers.addCopy(first, "1");
+  const HeaderEntry* first_entry = headers.get(first);
+
+  std::vector<LowerCaseString> keys;
+  for (int i = 0; i < 100; i++) {
+    keys.emplace_back("key-" + std::to_string(i));
+  }
+  for (const LowerCaseString& key : keys) {
+    headers.addCopy(key, "value");
+  }
+  for (size_t i = 0; i < keys.size(); i += 2) {
+    headers.remove(keys[i]);
+  }
+  headers.insertMethod().value(std::string("GET"));
+
+  EXPECT_EQ(&host, headers.Host());
+  EXPECT_STREQ("host", host.value().c_str());
+  EXPECT_EQ(first_entry, headers.get(first));
+  EXPECT_STREQ("1", first_entry->value().c_str());
+  EXPECT_EQ(keys.size() / 2 + 3, headers.size());
+}
+
+// Removing headers leaves them out of iteration in either direction, and the remaining headers
+// keep their order, including once removed entries have been compacted away and reused.
+TEST_P(HeaderMapImplTest, RemoveAndReinsertKeepsOrder) {
+  TestHeaderMapImpl headers{{":method", "GET"}, {"a", "1"}, {"b", "2"}, {"c", "3"}, {"d", "4"}};
+  headers.remove(LowerCaseString("b"));
+  headers.remove(LowerCaseString("c"));
+  headers.remove(LowerCaseString("a"));
+  headers.addCopy(LowerCaseString("e"), "5");
+  headers.addCopy(LowerCaseString(":path"), "/");
+
+  std::vector<std::string> keys;
+  headers.iterate(
+      [](const HeaderEntry& header, void* context) -> HeaderMap::Iterate {
+        static_cast<std::vector<std::string>*>(context)->push_back(header.key().c_str());
+        return HeaderMap::Iterate::Continue;
+      },
+      &keys);
+  EXPECT_EQ((std::vector<std::string>{":method", ":path", "d", "e"}), keys);
+
+  keys.clear();
+  headers.iterateReverse(
+      [](const HeaderEntry& header, void* context) -> HeaderMap::Iterate {
+        static_cast<std::vector<std::string>*>(context)->push_back(header.key().c_str());
+        return HeaderMap::Iterate::Continue;
+      },
+      &keys);
+  EXPECT_EQ((std::vector<std::string>{"e", "d", ":path", ":method"}), keys);
+
+  EXPECT_EQ(4UL, headers.size());
+  EXPECT_EQ((TestHeaderMapImpl{{":method", "GET"}, {":path", "/"}, {"d", "4"}, {"e", "5"}}),
+            headers);
+
+  headers.removePrefix(LowerCaseString(""));
+  EXPECT_EQ(0UL, headers.size());
+  headers.addCopy(LowerCaseString("f"), "6");
+  EXPECT_STREQ("6", headers.get(LowerCaseString("f"))->value().c_str());
+  EXPECT_EQ(1UL, headers.size());
+}
+
 } // namespace Http
 } // namespace Envoy
@@ -0,0 +1,66 @@
+#include <string>
+#include <vector>
+
+#include "common/common/thread.h"
+#include "common/http/header_map_impl.h"
+#include "common/http/header_name_registry.h"
+#include "common/http/headers.h"
+
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Http {
+namespace {
+
+TEST(HeaderNameRegistryTest, InlineHeaders) {
+  // O(1) headers have the IDs header maps use to find their inline pointers.
+  const InternedHeaderName path = HeaderNameRegistry::intern(Headers::get().Path);
+  EXPECT_EQ(":path", path.name().get());
+  EXPECT_EQ(HeaderMapImpl::hashKey(":path"), path.hash());
+  EXPECT_EQ(HeaderMapImpl::inlineHeaderId(":path", path.hash()), path.id());
+  EXPECT_GE(path.id(), 1);
+  EXPECT_LE(path.id(), HeaderMapImpl::inlineHeaderCount());
+
+  EXPECT_NE(path, HeaderNameRegistry::intern(Headers::get().Method));
+  EXPECT_EQ(0,
+            HeaderMapImpl::inlineHeaderId("x-not-inline", HeaderMapImpl::hashKey("x-not-inline")));
+}
+
+TEST(HeaderNameRegistryTest, OtherHeaders) {
+  const InternedHeaderName a = HeaderNameRegistry::intern(LowerCaseString("x-registry-a"));
+  const InternedHeaderName b = HeaderNameRegistry::intern(LowerCaseString("X-Registry-B"));
+  EXPECT_EQ("x-registry-b", b.name().get());
+  EXPECT_GT(a.id(), HeaderMapImpl::inlineHeaderCount());
+  EXPECT_GT(b.id(), HeaderMapImpl::inlineHeaderCount());
+  EXPECT_NE(a, b);
+
+  // Interning a name again gives it the same ID.
+  EXPECT_EQ(a.id(), HeaderNameRegistry::intern(LowerCaseString("x-registry-a")).id());
+  EXPECT_EQ(b.id(), HeaderNameRegistry::intern(LowerCaseString("x-registry-b")).id());
+}
+
+TEST(HeaderNameRegistryTest, InternFromManyThreads) {
+  const uint32_t num_threads = 8;
+  const uint32_t num_names = 100;
+  std::vector<std::vector<uint32_t>> ids(num_threads);
+  std::vector<Thread::ThreadPtr> threads;
+  for (uint32_t i = 0; i < num_threads; i++) {
+    threads.emplace_back(std::make_unique<Thread::Thread>([&ids, i]() {
+      for (uint32_t name = 0; name < num_names; name++) {
+        ids[i].push_back(
+            HeaderNameRegistry::intern(LowerCaseString("x-thread-" + std::to_string(name))).id());
+      }
+    }));
+  }
+  for (Thread::ThreadPtr& thread : threads) {
+    thread->join();
+  }
+
+  for (uint32_t i = 1; i < num_threads; i++) {
+    EXPECT_EQ(ids[0], ids[i]);
+  }
+}
+
+} // namespace
+} // namespace Http
+} // namespace Envoy
@@ -26,7 +26,7 @@ TEST(HeaderDataConstructorTest, JsonConstructor) {
 
   HeaderUtility::HeaderData header_data = HeaderUtility::HeaderData(*json);
 
-  EXPECT_EQ("test-header", header_data.name_.get());
+  EXPECT_EQ("test-header", header_data.name_.name().get());
   EXPECT_EQ(HeaderUtility::HeaderMatchType::Value, header_data.header_match_type_);
   EXPECT_EQ("value", header_data.value_);
 }
@@ -39,7 +39,7 @@ name: test-header
   HeaderUtility::HeaderData header_data =
       HeaderUtility::HeaderData(parseHeaderMatcherFromYaml(yaml));
 
-  EXPECT_EQ("test-header", header_data.name_.get());
+  EXPECT_EQ("test-header", header_data.name_.name().get());
   EXPECT_EQ(HeaderUtility::HeaderMatchType::Present, header_data.header_match_type_);
 }
 
@@ -52,7 +52,7 @@ exact_match: value
   HeaderUtility::HeaderData header_data =
       HeaderUtility::HeaderData(parseHeaderMatcherFromYaml(yaml));
 
-  EXPECT_EQ("test-header", header_data.name_.get());
+  EXPECT_EQ("test-header", header_data.name_.name().get());
   EXPECT_EQ(HeaderUtility::HeaderMatchType::Value, header_data.header_match_type_);
   EXPECT_EQ("value", header_data.value_);
 }
@@ -66,7 +66,7 @@ regex_match: value
   HeaderUtility::HeaderData header_data =
       HeaderUtility::HeaderData(parseHeaderMatcherFromYaml(yaml));
 
-  EXPECT_EQ("test-header", header_data.name_.get());
+  EXPECT_EQ("test-header", header_data.name_.name().get());
   EXPECT_EQ(HeaderUtility::HeaderMatchType::Regex, header_data.header_match_type_);
   EXPECT_EQ("", header_data.value_);
 }
@@ -82,7 +82,7 @@ range_match:
   HeaderUtility::HeaderData header_data =
       HeaderUtility::HeaderData(parseHeaderMatcherFromYaml(yaml));
 
-  EXPECT_EQ("test-header", header_data.name_.get());
+  EXPECT_EQ("test-header", header_data.name_.name().get());
   EXPECT_EQ(HeaderUtility::HeaderMatchType::Range, header_data.header_match_type_);
   EXPECT_EQ("", header_data.value_);
   EXPECT_EQ(0, header_data.range_.start());
@@ -98,7 +98,7 @@ present_match: true
   HeaderUtility::HeaderData header_data =
       HeaderUtility::HeaderData(parseHeaderMatcherFromYaml(yaml));
 
-  EXPECT_EQ("test-header", header_data.name_.get());
+  EXPECT_EQ("test-header", header_data.name_.name().get());
   EXPECT_EQ(HeaderUtility::HeaderMatchType::Present, header_data.header_match_type_);
   EXPECT_EQ("", header_data.value_);
 }
@@ -112,7 +112,7 @@ prefix_match: value
   HeaderUtility::HeaderData header_data =
       HeaderUtility::HeaderData(parseHeaderMatcherFromYaml(yaml));
 
-  EXPECT_EQ("test-header", header_data.name_.get());
+  EXPECT_EQ("test-header", header_data.name_.name().get());
   EXPECT_EQ(HeaderUtility::HeaderMatchType::Prefix, header_data.header_match_type_);
   EXPECT_EQ("value", header_data.value_);
 }
@@ -126,7 +126,7 @@ suffix_match: value
   HeaderUtility::HeaderData header_data =
       HeaderUtility::HeaderData(parseHeaderMatcherFromYaml(yaml));
 
-  EXPECT_EQ("test-header", header_data.name_.get());
+  EXPECT_EQ("test-header", header_data.name_.name().get());
   EXPECT_EQ(HeaderUtility::HeaderMatchType::Suffix, header_data.header_match_type_);
   EXPECT_EQ("value", header_data.value_);
 }
@@ -141,7 +141,7 @@ invert_match: true
   HeaderUtility::HeaderData header_data =
       HeaderUtility::HeaderData(parseHeaderMatcherFromYaml(yaml));
 
-  EXPECT_EQ("test-header", header_data.name_.get());
+  EXPECT_EQ("test-header", header_data.name_.name().get());
   EXPECT_EQ(HeaderUtility::HeaderMatchType::Value, header_data.header_match_type_);
   EXPECT_EQ("value", header_data.value_);
   EXPECT_EQ(true, header_data.invert_match_);
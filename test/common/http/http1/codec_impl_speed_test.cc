@@ -0,0 +1,168 @@
+// Note: this should be run with --compilation_mode=opt, and would benefit from a
+// quiescent system with disabled cstate power management.
+//
+// Every benchmark takes the parser engine as its first argument: 0 for http_parser, and 1, 2 and 3
+// for the SIMD parser limited to scalar code, SSE 4.2 and AVX2 respectively. The second argument
+// is the number of headers in the request.
+
+#include <string>
+#include <vector>
+
+#include "common/buffer/buffer_impl.h"
+#include "common/common/assert.h"
+#include "common/http/http1/codec_impl.h"
+#include "common/http/http1/legacy_parser_impl.h"
+#include "common/http/http1/simd_parser_impl.h"
+
+#include "test/mocks/network/mocks.h"
+
+#include "testing/base/public/benchmark.h"
+
+using testing::NiceMock;
+
+namespace Envoy {
+namespace Http {
+namespace Http1 {
+
+namespace {
+
+// A typical browser request, followed by custom headers up to the requested count.
+std::string requestWithHeaders(uint64_t count) {
+  const std::vector<std::string> common = {
+      "Host: api.example.com",
+      "User-Agent: Mozilla/5.0 (X11; Linux x86_64) AppleWebKit/537.36 (KHTML, like Gecko)",
+      "Accept: text/html,application/xhtml+xml,application/xml;q=0.9,*/*;q=0.8",
+      "Accept-Encoding: gzip, deflate, br",
+      "Accept-Language: en-US,en;q=0.9",
+      "Cache-Control: no-cache",
+      "Connection: keep-alive",
+      "Cookie: session=6f1c0d1e2a3b4c5d6e7f8091a2b3c4d5; theme=dark; tz=Europe%2FLondon",
+      "Referer: https://www.example.com/catalog/items?category=books&sort=price",
+      "X-Forwarded-For: 10.0.0.1, 192.168.1.17",
+      "X-Forwarded-Proto: https",
+      "X-Request-Id: 8f6d5d4c-5d0c-4a4e-9d36-2d5a8c8f0e77",
+  };
+  std::string request = "GET /api/v1/items?page=2&per_page=50 HTTP/1.1\r\n";
+  for (uint64_t i = 0; i < count; i++) {
+    if (i < common.size()) {
+      request += common[i];
+    } else {
+      request += "X-Custom-Header-" + std::to_string(i) + ": custom-value-" + std::to_string(i);
+    }
+    request += "\r\n";
+  }
+  return request + "\r\n";
+}
+
+// Selects the engine given by the first benchmark argument.
+bool useSimdEngine(int64_t engine) {
+  if (engine > 0) {
+    SimdParserImpl::setSimdLevel(static_cast<SimdParserImpl::SimdLevel>(engine - 1));
+  }
+  return engine > 0;
+}
+
+// Runs a benchmark for each engine the CPU supports with 20, 30 and 40 request headers.
+void enginesAndHeaderCounts(benchmark::internal::Benchmark* b) {
+  const int engines = 2 + static_cast<int>(SimdParserImpl::supportedSimdLevel());
+  for (int engine = 0; engine < engines; engine++) {
+    for (int headers : {20, 30, 40}) {
+      b->Args({engine, headers});
+    }
+  }
+}
+
+// Parser callbacks which only count what they are given.
+class CountingParserCallbacks : public ParserCallbacks {
+public:
+  // Http1::ParserCallbacks
+  void onMessageBegin() override {}
+  void onUrl(const char*, size_t length) override { bytes_ += length; }
+  void onHeaderField(const char*, size_t length) override { bytes_ += length; }
+  void onHeaderValue(const char*, size_t length) override { bytes_ += length; }
+  int onHeadersComplete() override { return 0; }
+  void onBody(const char*, size_t length) override { bytes_ += length; }
+  void onMessageComplete() override { messages_++; }
+
+  uint64_t bytes_{};
+  uint64_t messages_{};
+};
+
+// Connection callbacks and a request decoder which keep the headers of the last request, without
+// the overhead of mocks.
+class CountingServerCallbacks : public ServerConnectionCallbacks, public StreamDecoder {
+public:
+  // Http::ServerConnectionCallbacks
+  StreamDecoder& newStream(StreamEncoder&) override { return *this; }
+  void onGoAway() override {}
+
+  // Http::StreamDecoder
+  void decode100ContinueHeaders(HeaderMapPtr&&) override {}
+  void decodeHeaders(HeaderMapPtr&& headers, bool) override { headers_ = std::move(headers); }
+  void decodeData(Buffer::Instance&, bool) override {}
+  void decodeTrailers(HeaderMapPtr&&) override {}
+  void decodeMetadata(MetadataMapPtr&&) override {}
+
+  HeaderMapPtr headers_;
+};
+
+} // namespace
+
+// Parses a pipeline of requests with each engine on its own, which isolates the cost of finding
+// the ends of the start line, header names and header values.
+static void BM_ParserExecute(benchmark::State& state) {
+  const bool simd = useSimdEngine(state.range(0));
+  std::string pipeline;
+  for (int i = 0; i < 16; i++) {
+    pipeline += requestWithHeaders(state.range(1));
+  }
+
+  CountingParserCallbacks callbacks;
+  ParserPtr parser;
+  if (simd) {
+    parser = std::make_unique<SimdParserImpl>(HTTP_REQUEST, callbacks);
+  } else {
+    parser = std::make_unique<LegacyParserImpl>(HTTP_REQUEST, callbacks);
+  }
+  for (auto _ : state) {
+    parser->execute(pipeline.data(), pipeline.size());
+  }
+  RELEASE_ASSERT(parser->error() == HPE_OK, "");
+  state.SetBytesProcessed(state.iterations() * pipeline.size());
+  benchmark::DoNotOptimize(callbacks.bytes_);
+}
+BENCHMARK(BM_ParserExecute)->Apply(enginesAndHeaderCounts);
+
+// Dispatches a request to a new server connection, which includes building the header map and the
+// lower casing of header names which http_parser leaves to the codec.
+static void BM_ServerConnectionDispatch(benchmark::State& state) {
+  ConnectionImpl::useSimdParser(useSimdEngine(state.range(0)));
+  const std::string request = requestWithHeaders(state.range(1));
+
+  NiceMock<Network::MockConnection> connection;
+  CountingServerCallbacks callbacks;
+  Http1Settings settings;
+  for (auto _ : state) {
+    ServerConnectionImpl codec(connection, callbacks, settings);
+    Buffer::OwnedImpl buffer(request);
+    codec.dispatch(buffer);
+  }
+  RELEASE_ASSERT(callbacks.headers_->size() >= static_cast<size_t>(state.range(1)), "");
+  state.SetBytesProcessed(state.iterations() * request.size());
+  ConnectionImpl::useSimdParser(false);
+}
+BENCHMARK(BM_ServerConnectionDispatch)->Apply(enginesAndHeaderCounts);
+
+} // namespace Http1
+} // namespace Http
+} // namespace Envoy
+
+// Boilerplate main(), which discovers benchmarks in the same file and runs them.
+int main(int argc, char** argv) {
+  benchmark::Initialize(&argc, argv);
+
+  if (benchmark::ReportUnrecognizedArguments(argc, argv)) {
+    return 1;
+  }
+  benchmark::RunSpecifiedBenchmarks();
+}
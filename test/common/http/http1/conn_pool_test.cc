@@ -1,3 +1,6 @@
+#include <sys/socket.h>
+#include <unistd.h>
+
 #include <memory>
 #include <vector>
 
@@ -5,6 +8,7 @@
 #include "common/event/dispatcher_impl.h"
 #include "common/http/codec_client.h"
 #include "common/http/http1/conn_pool.h"
+#include "common/network/listen_socket_impl.h"
 #include "common/network/utility.h"
 #include "common/upstream/upstream_impl.h"
 
@@ -45,8 +49,13 @@ public:
   ConnPoolImplForTest(Event::MockDispatcher& dispatcher,
                       Upstream::ClusterInfoConstSharedPtr cluster,
                       NiceMock<Event::MockTimer>* upstream_ready_timer)
-      : ConnPoolImpl(dispatcher, Upstream::makeTestHost(cluster, "tcp://127.0.0.1:9000"),
-                     Upstream::ResourcePriority::Default, nullptr),
+      : ConnPoolImplForTest(dispatcher, Upstream::makeTestHost(cluster, "tcp://127.0.0.1:9000"),
+                            upstream_ready_timer) {}
+
+  ConnPoolImplForTest(Event::MockDispatcher& dispatcher, Upstream::HostSharedPtr host,
+                      NiceMock<Event::MockTimer>* upstream_ready_timer,
+                      const Network::ConnectionSocket::OptionsSharedPtr& options = nullptr)
+      : ConnPoolImpl(dispatcher, host, Upstream::ResourcePriority::Default, options),
         mock_dispatcher_(dispatcher), mock_upstream_ready_timer_(upstream_ready_timer) {}
 
   ~ConnPoolImplForTest() {
@@ -73,7 +82,8 @@ public:
   MOCK_METHOD0(createCodecClient_, CodecClient*());
   MOCK_METHOD0(onClientDestroy, void());
 
-  void expectClientCreate() {
+  // Expects a new connection, or one adopted from a parked socket.
+  void expectClientCreate(bool adopted = false) {
     test_clients_.emplace_back();
     TestCodecClient& test_client = test_clients_.back();
     test_client.connection_ = new NiceMock<Network::MockClientConnection>();
@@ -95,8 +105,13 @@ public:
           }
         },
         Upstream::makeTestHost(cluster, "tcp://127.0.0.1:9000"), *test_client.client_dispatcher_);
-    EXPECT_CALL(mock_dispatcher_, createClientConnection_(_, _, _, _))
-        .WillOnce(Return(test_client.connection_));
+    if (adopted) {
+      EXPECT_CALL(mock_dispatcher_, adoptClientConnection_(_, _))
+          .WillOnce(Return(test_client.connection_));
+    } else {
+      EXPECT_CALL(mock_dispatcher_, createClientConnection_(_, _, _, _))
+          .WillOnce(Return(test_client.connection_));
+    }
     EXPECT_CALL(*this, createCodecClient_()).WillOnce(Return(test_client.codec_client_));
     EXPECT_CALL(*test_client.connect_timer_, enableTimer(_));
   }
@@ -145,20 +160,25 @@ public:
  * Helper for dealing with an active test request.
  */
 struct ActiveTestRequest {
-  enum class Type { Pending, CreateConnection, Immediate };
+  enum class Type { Pending, CreateConnection, AdoptConnection, Immediate };
 
   ActiveTestRequest(Http1ConnPoolImplTest& parent, size_t client_index, Type type)
-      : parent_(parent), client_index_(client_index) {
+      : ActiveTestRequest(parent, parent.conn_pool_, client_index, type) {}
+
+  ActiveTestRequest(Http1ConnPoolImplTest& parent, ConnPoolImplForTest& conn_pool,
+                    size_t client_index, Type type)
+      : parent_(parent), conn_pool_(conn_pool), client_index_(client_index) {
     uint64_t current_rq_total = parent_.cluster_->stats_.upstream_rq_total_.value();
-    if (type == Type::CreateConnection) {
-      parent.conn_pool_.expectClientCreate();
+    const bool connect = type == Type::CreateConnection || type == Type::AdoptConnection;
+    if (connect) {
+      conn_pool_.expectClientCreate(type == Type::AdoptConnection);
     }
 
     if (type == Type::Immediate) {
       expectNewStream();
     }
 
-    handle_ = parent.conn_pool_.newStream(outer_decoder_, callbacks_);
+    handle_ = conn_pool_.newStream(outer_decoder_, callbacks_);
 
     if (type == Type::Immediate) {
       EXPECT_EQ(nullptr, handle_);
@@ -166,10 +186,10 @@ struct ActiveTestRequest {
       EXPECT_NE(nullptr, handle_);
     }
 
-    if (type == Type::CreateConnection) {
-      EXPECT_CALL(*parent_.conn_pool_.test_clients_[client_index_].connect_timer_, disableTimer());
+    if (connect) {
+      EXPECT_CALL(*conn_pool_.test_clients_[client_index_].connect_timer_, disableTimer());
       expectNewStream();
-      parent.conn_pool_.test_clients_[client_index_].connection_->raiseEvent(
+      conn_pool_.test_clients_[client_index_].connection_->raiseEvent(
           Network::ConnectionEvent::Connected);
     }
     EXPECT_EQ(current_rq_total + 1, parent_.cluster_->stats_.upstream_rq_total_.value());
@@ -188,7 +208,7 @@ struct ActiveTestRequest {
   }
 
   void expectNewStream() {
-    EXPECT_CALL(*parent_.conn_pool_.test_clients_[client_index_].codec_, newStream(_))
+    EXPECT_CALL(*conn_pool_.test_clients_[client_index_].codec_, newStream(_))
         .WillOnce(DoAll(SaveArgAddress(&inner_decoder_), ReturnRef(request_encoder_)));
     EXPECT_CALL(callbacks_.pool_ready_, ready());
   }
@@ -196,6 +216,7 @@ struct ActiveTestRequest {
   void startRequest() { callbacks_.outer_encoder_->encodeHeaders(TestHeaderMapImpl{}, true); }
 
   Http1ConnPoolImplTest& parent_;
+  ConnPoolImplForTest& conn_pool_;
   size_t client_index_;
   NiceMock<Http::MockStreamDecoder> outer_decoder_;
   Http::ConnectionPool::Cancellable* handle_{};
@@ -644,6 +665,233 @@ TEST_F(Http1ConnPoolImplTest, ConcurrentConnections) {
   dispatcher_.clearDeferredDeleteList();
 }
 
+/**
+ * Test that preconnecting opens connections up to the given number, but not beyond the connection
+ * circuit breaker.
+ */
+TEST_F(Http1ConnPoolImplTest, Preconnect) {
+  cluster_->resetResourceManager(2, 1024, 1024, 1);
+  InSequence s;
+
+  conn_pool_.expectClientCreate();
+  conn_pool_.expectClientCreate();
+  conn_pool_.preconnect(3);
+  EXPECT_EQ(2U, cluster_->stats_.upstream_cx_preconnect_.value());
+
+  // A preconnected connection takes requests once it is connected.
+  EXPECT_CALL(*conn_pool_.test_clients_[0].connect_timer_, disableTimer());
+  conn_pool_.test_clients_[0].connection_->raiseEvent(Network::ConnectionEvent::Connected);
+  ActiveTestRequest r1(*this, 0, ActiveTestRequest::Type::Immediate);
+  r1.startRequest();
+  r1.completeResponse(false);
+
+  EXPECT_CALL(conn_pool_, onClientDestroy()).Times(2);
+  conn_pool_.test_clients_[1].connection_->raiseEvent(Network::ConnectionEvent::RemoteClose);
+  conn_pool_.test_clients_[0].connection_->raiseEvent(Network::ConnectionEvent::RemoteClose);
+  dispatcher_.clearDeferredDeleteList();
+}
+
+/**
+ * Test that a preconnect ratio keeps connections open ahead of the requests in flight.
+ */
+TEST_F(Http1ConnPoolImplTest, PreconnectForDemand) {
+  cluster_->per_upstream_preconnect_ratio_ = 1.5;
+  InSequence s;
+
+  // Request 1 kicks off a connection for itself and one ahead of it.
+  NiceMock<Http::MockStreamDecoder> outer_decoder1;
+  ConnPoolCallbacks callbacks1;
+  conn_pool_.expectClientCreate();
+  conn_pool_.expectClientCreate();
+  EXPECT_NE(nullptr, conn_pool_.newStream(outer_decoder1, callbacks1));
+  EXPECT_EQ(1U, cluster_->stats_.upstream_cx_preconnect_.value());
+
+  NiceMock<Http::MockStreamEncoder> request_encoder;
+  Http::StreamDecoder* inner_decoder1;
+  EXPECT_CALL(*conn_pool_.test_clients_[0].codec_, newStream(_))
+      .WillOnce(DoAll(SaveArgAddress(&inner_decoder1), ReturnRef(request_encoder)));
+  EXPECT_CALL(callbacks1.pool_ready_, ready());
+  conn_pool_.test_clients_[0].connection_->raiseEvent(Network::ConnectionEvent::Connected);
+  conn_pool_.test_clients_[1].connection_->raiseEvent(Network::ConnectionEvent::Connected);
+
+  // Request 2 uses the preconnected connection, and another one is opened ahead of both requests.
+  NiceMock<Http::MockStreamDecoder> outer_decoder2;
+  ConnPoolCallbacks callbacks2;
+  Http::StreamDecoder* inner_decoder2;
+  EXPECT_CALL(*conn_pool_.test_clients_[1].codec_, newStream(_))
+      .WillOnce(DoAll(SaveArgAddress(&inner_decoder2), ReturnRef(request_encoder)));
+  EXPECT_CALL(callbacks2.pool_ready_, ready());
+  conn_pool_.expectClientCreate();
+  EXPECT_EQ(nullptr, conn_pool_.newStream(outer_decoder2, callbacks2));
+  EXPECT_EQ(2U, cluster_->stats_.upstream_cx_preconnect_.value());
+
+  callbacks1.outer_encoder_->encodeHeaders(TestHeaderMapImpl{}, true);
+  inner_decoder1->decodeHeaders(HeaderMapPtr{new TestHeaderMapImpl{{":status", "200"}}}, true);
+  callbacks2.outer_encoder_->encodeHeaders(TestHeaderMapImpl{}, true);
+  inner_decoder2->decodeHeaders(HeaderMapPtr{new TestHeaderMapImpl{{":status", "200"}}}, true);
+
+  EXPECT_CALL(conn_pool_, onClientDestroy()).Times(3);
+  conn_pool_.test_clients_[2].connection_->raiseEvent(Network::ConnectionEvent::RemoteClose);
+  conn_pool_.test_clients_[1].connection_->raiseEvent(Network::ConnectionEvent::RemoteClose);
+  conn_pool_.test_clients_[0].connection_->raiseEvent(Network::ConnectionEvent::RemoteClose);
+  dispatcher_.clearDeferredDeleteList();
+}
+
+/**
+ * Test that idle connections beyond the first are parked, and that another pool for the same host
+ * takes a parked connection instead of opening a new one.
+ */
+TEST_F(Http1ConnPoolImplTest, ParkIdleConnections) {
+  cluster_->resetResourceManager(3, 1024, 1024, 1);
+  cluster_->max_parked_connections_per_host_ = 2;
+  Upstream::HostSharedPtr host = Upstream::makeTestHost(cluster_, "tcp://127.0.0.1:9000");
+  ConnPoolImplForTest pool1(dispatcher_, host, new NiceMock<Event::MockTimer>(&dispatcher_));
+  ConnPoolImplForTest pool2(dispatcher_, host, new NiceMock<Event::MockTimer>(&dispatcher_));
+
+  ActiveTestRequest r1(*this, pool1, 0, ActiveTestRequest::Type::CreateConnection);
+  r1.startRequest();
+  ActiveTestRequest r2(*this, pool1, 1, ActiveTestRequest::Type::CreateConnection);
+  r2.startRequest();
+
+  // The first idle connection is kept for the next request.
+  r1.completeResponse(false);
+  EXPECT_EQ(0U, cluster_->stats_.upstream_cx_idle_parked_.value());
+
+  // The second is parked, which closes it in the pool.
+  int fds[2];
+  ASSERT_EQ(0, ::socketpair(AF_UNIX, SOCK_STREAM, 0, fds));
+  Network::MockClientConnection& connection = *pool1.test_clients_[1].connection_;
+  EXPECT_CALL(connection, releaseSocket_()).WillOnce(Invoke([&]() -> Network::ConnectionSocket* {
+    connection.raiseEvent(Network::ConnectionEvent::LocalClose);
+    return new Network::ConnectionSocketImpl(fds[0], nullptr, nullptr);
+  }));
+  r2.completeResponse(false);
+  EXPECT_EQ(1U, cluster_->stats_.upstream_cx_idle_parked_.value());
+  EXPECT_CALL(pool1, onClientDestroy());
+  dispatcher_.clearDeferredDeleteList();
+
+  // The parked connection is still counted as an active connection.
+  EXPECT_EQ(1U, cluster_->stats_.upstream_cx_parked_active_.value());
+  EXPECT_EQ(2U, cluster_->stats_.upstream_cx_active_.value());
+  EXPECT_EQ(2U, host->stats().cx_active_.value());
+
+  // The other pool continues the parked connection.
+  ActiveTestRequest r3(*this, pool2, 0, ActiveTestRequest::Type::AdoptConnection);
+  EXPECT_EQ(1U, cluster_->stats_.upstream_cx_idle_taken_.value());
+  EXPECT_EQ(0U, cluster_->stats_.upstream_cx_cross_worker_handoff_.value());
+  EXPECT_EQ(2U, cluster_->stats_.upstream_cx_total_.value());
+  EXPECT_EQ(0U, cluster_->stats_.upstream_cx_parked_active_.value());
+  EXPECT_EQ(2U, cluster_->stats_.upstream_cx_active_.value());
+  r3.startRequest();
+  r3.completeResponse(false);
+
+  EXPECT_CALL(pool1, onClientDestroy());
+  pool1.test_clients_[0].connection_->raiseEvent(Network::ConnectionEvent::RemoteClose);
+  EXPECT_CALL(pool2, onClientDestroy());
+  pool2.test_clients_[0].connection_->raiseEvent(Network::ConnectionEvent::RemoteClose);
+  dispatcher_.clearDeferredDeleteList();
+  ::close(fds[1]);
+}
+
+/**
+ * Test that parked connections count against the connection circuit breaker, and that a pool
+ * takes a parked connection when the breaker has no room for a new one.
+ */
+TEST_F(Http1ConnPoolImplTest, ParkedConnectionsCountAgainstCircuitBreaker) {
+  cluster_->resetResourceManager(2, 1024, 1024, 1);
+  cluster_->max_parked_connections_per_host_ = 2;
+  Upstream::HostSharedPtr host = Upstream::makeTestHost(cluster_, "tcp://127.0.0.1:9000");
+  ConnPoolImplForTest pool1(dispatcher_, host, new NiceMock<Event::MockTimer>(&dispatcher_));
+  ConnPoolImplForTest pool2(dispatcher_, host, new NiceMock<Event::MockTimer>(&dispatcher_));
+
+  ActiveTestRequest r1(*this, pool1, 0, ActiveTestRequest::Type::CreateConnection);
+  r1.startRequest();
+  ActiveTestRequest r2(*this, pool1, 1, ActiveTestRequest::Type::CreateConnection);
+  r2.startRequest();
+  r1.completeResponse(false);
+  int fds[2];
+  ASSERT_EQ(0, ::socketpair(AF_UNIX, SOCK_STREAM, 0, fds));
+  Network::MockClientConnection& connection = *pool1.test_clients_[1].connection_;
+  EXPECT_CALL(connection, releaseSocket_()).WillOnce(Invoke([&]() -> Network::ConnectionSocket* {
+    connection.raiseEvent(Network::ConnectionEvent::LocalClose);
+    return new Network::ConnectionSocketImpl(fds[0], nullptr, nullptr);
+  }));
+  r2.completeResponse(false);
+  EXPECT_CALL(pool1, onClientDestroy());
+  dispatcher_.clearDeferredDeleteList();
+
+  // The idle connection and the parked one fill the circuit breaker.
+  EXPECT_FALSE(cluster_->resourceManager(Upstream::ResourcePriority::Default)
+                   .connections()
+                   .canCreate());
+
+  // The other pool still takes the parked connection, without overflowing.
+  ActiveTestRequest r3(*this, pool2, 0, ActiveTestRequest::Type::AdoptConnection);
+  EXPECT_EQ(1U, cluster_->stats_.upstream_cx_idle_taken_.value());
+  EXPECT_EQ(0U, cluster_->stats_.upstream_cx_overflow_.value());
+  r3.startRequest();
+  r3.completeResponse(false);
+
+  EXPECT_CALL(pool1, onClientDestroy());
+  pool1.test_clients_[0].connection_->raiseEvent(Network::ConnectionEvent::RemoteClose);
+  EXPECT_CALL(pool2, onClientDestroy());
+  pool2.test_clients_[0].connection_->raiseEvent(Network::ConnectionEvent::RemoteClose);
+  dispatcher_.clearDeferredDeleteList();
+  ::close(fds[1]);
+}
+
+/**
+ * Test that a pool whose connections have socket options neither takes a connection which a pool
+ * without them parked, nor parks its own connections, as their sockets differ.
+ */
+TEST_F(Http1ConnPoolImplTest, NoParkingWithSocketOptions) {
+  cluster_->resetResourceManager(4, 1024, 1024, 1);
+  cluster_->max_parked_connections_per_host_ = 2;
+  Upstream::HostSharedPtr host = Upstream::makeTestHost(cluster_, "tcp://127.0.0.1:9000");
+  ConnPoolImplForTest pool1(dispatcher_, host, new NiceMock<Event::MockTimer>(&dispatcher_));
+  ConnPoolImplForTest pool2(dispatcher_, host, new NiceMock<Event::MockTimer>(&dispatcher_),
+                            std::make_shared<Network::Socket::Options>());
+
+  // The pool without options parks its second idle connection.
+  ActiveTestRequest r1(*this, pool1, 0, ActiveTestRequest::Type::CreateConnection);
+  r1.startRequest();
+  ActiveTestRequest r2(*this, pool1, 1, ActiveTestRequest::Type::CreateConnection);
+  r2.startRequest();
+  r1.completeResponse(false);
+  int fds[2];
+  ASSERT_EQ(0, ::socketpair(AF_UNIX, SOCK_STREAM, 0, fds));
+  Network::MockClientConnection& connection = *pool1.test_clients_[1].connection_;
+  EXPECT_CALL(connection, releaseSocket_()).WillOnce(Invoke([&]() -> Network::ConnectionSocket* {
+    connection.raiseEvent(Network::ConnectionEvent::LocalClose);
+    return new Network::ConnectionSocketImpl(fds[0], nullptr, nullptr);
+  }));
+  r2.completeResponse(false);
+  EXPECT_EQ(1U, cluster_->stats_.upstream_cx_idle_parked_.value());
+  EXPECT_CALL(pool1, onClientDestroy());
+  dispatcher_.clearDeferredDeleteList();
+
+  // The pool with options opens new connections instead of taking the parked one, and keeps all
+  // of them when they are idle.
+  ActiveTestRequest r3(*this, pool2, 0, ActiveTestRequest::Type::CreateConnection);
+  r3.startRequest();
+  ActiveTestRequest r4(*this, pool2, 1, ActiveTestRequest::Type::CreateConnection);
+  r4.startRequest();
+  EXPECT_CALL(*pool2.test_clients_[1].connection_, releaseSocket_()).Times(0);
+  r3.completeResponse(false);
+  r4.completeResponse(false);
+  EXPECT_EQ(1U, cluster_->stats_.upstream_cx_idle_parked_.value());
+  EXPECT_EQ(0U, cluster_->stats_.upstream_cx_idle_taken_.value());
+  EXPECT_EQ(4U, cluster_->stats_.upstream_cx_total_.value());
+
+  EXPECT_CALL(pool1, onClientDestroy());
+  pool1.test_clients_[0].connection_->raiseEvent(Network::ConnectionEvent::RemoteClose);
+  EXPECT_CALL(pool2, onClientDestroy()).Times(2);
+  pool2.test_clients_[0].connection_->raiseEvent(Network::ConnectionEvent::RemoteClose);
+  pool2.test_clients_[1].connection_->raiseEvent(Network::ConnectionEvent::RemoteClose);
+  dispatcher_.clearDeferredDeleteList();
+  ::close(fds[1]);
+}
+
 TEST_F(Http1ConnPoolImplTest, DrainCallback) {
   InSequence s;
   ReadyWatcher drained;
@@ -0,0 +1,370 @@
+#include <string>
+#include <vector>
+
+#include "common/http/http1/simd_parser_impl.h"
+
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Http {
+namespace Http1 {
+namespace {
+
+// Records the callbacks made by a parser as a string. Consecutive fragments of the same URL,
+// header value or body are joined, so that the record does not depend on how the input is split.
+class RecordingCallbacks : public ParserCallbacks {
+public:
+  // Http1::ParserCallbacks
+  void onMessageBegin() override { record("begin"); }
+  void onUrl(const char* data, size_t length) override { append("url", data, length); }
+  void onHeaderField(const char* data, size_t length) override {
+    append("field", data, length);
+  }
+  void onHeaderValue(const char* data, size_t length) override {
+    append("value", data, length);
+  }
+  int onHeadersComplete() override {
+    record("headers");
+    if (pause_on_headers_) {
+      parser_->pause(true);
+    }
+    return headers_complete_result_;
+  }
+  void onBody(const char* data, size_t length) override { append("body", data, length); }
+  void onMessageComplete() override { record("complete"); }
+
+  void record(const std::string& event) {
+    log_ += event + ";";
+    last_ = "";
+  }
+
+  void append(const std::string& event, const char* data, size_t length) {
+    if (last_ != event) {
+      log_ += event + "=";
+      last_ = event;
+    } else {
+      log_.pop_back();
+    }
+    log_ += std::string(data, length) + ";";
+  }
+
+  Parser* parser_{};
+  std::string log_;
+  std::string last_;
+  int headers_complete_result_{};
+  bool pause_on_headers_{};
+};
+
+class SimdParserImplTest : public testing::TestWithParam<SimdParserImpl::SimdLevel> {
+public:
+  SimdParserImplTest() { SimdParserImpl::setSimdLevel(GetParam()); }
+  ~SimdParserImplTest() { SimdParserImpl::setSimdLevel(SimdParserImpl::supportedSimdLevel()); }
+
+  // Parse input in one call, and then split at every point, checking that the error is the same
+  // each way, and if there is none, that the callbacks are too. Returns the callbacks.
+  std::string parse(http_parser_type type, const std::string& input,
+                    http_errno expected_error = HPE_OK, bool eof = false) {
+    const std::string log = parseSplit(type, input, input.size(), expected_error, eof);
+    for (size_t split = 1; split < input.size(); split++) {
+      const std::string split_log = parseSplit(type, input, split, expected_error, eof);
+      if (expected_error == HPE_OK) {
+        EXPECT_EQ(log, split_log) << "split " << split;
+      }
+    }
+    return log;
+  }
+
+  std::string parseSplit(http_parser_type type, const std::string& input, size_t split,
+                         http_errno expected_error, bool eof) {
+    RecordingCallbacks callbacks;
+    SimdParserImpl parser(type, callbacks);
+    callbacks.parser_ = &parser;
+
+    // Copy each part so that reading past its end is caught by the address sanitizer.
+    const std::vector<std::string> parts{input.substr(0, split), input.substr(split)};
+    for (const std::string& part : parts) {
+      if (part.empty()) {
+        continue;
+      }
+      std::vector<char> buffer(part.begin(), part.end());
+      const size_t parsed = parser.execute(buffer.data(), buffer.size());
+      if (parser.error() != HPE_OK) {
+        break;
+      }
+      EXPECT_EQ(buffer.size(), parsed);
+    }
+    if (eof && parser.error() == HPE_OK) {
+      parser.execute(nullptr, 0);
+    }
+    EXPECT_EQ(expected_error, parser.error())
+        << http_errno_name(parser.error()) << " split " << split;
+    return callbacks.log_;
+  }
+};
+
+INSTANTIATE_TEST_CASE_P(SimdLevels, SimdParserImplTest,
+                        testing::Values(SimdParserImpl::SimdLevel::Scalar,
+                                        SimdParserImpl::SimdLevel::Sse42,
+                                        SimdParserImpl::SimdLevel::Avx2));
+
+TEST_P(SimdParserImplTest, Request) {
+  EXPECT_EQ("begin;url=/path?query;field=host;value=example.com;field=x-mixed-case;value=Value "
+            "With Spaces;headers;complete;",
+            parse(HTTP_REQUEST, "GET /path?query HTTP/1.1\r\nHost: example.com\r\n"
+                                "X-Mixed-CASE:  Value With Spaces\r\n\r\n"));
+}
+
+TEST_P(SimdParserImplTest, RequestFields) {
+  RecordingCallbacks callbacks;
+  SimdParserImpl parser(HTTP_REQUEST, callbacks);
+  const std::string input = "PATCH / HTTP/1.0\r\ncontent-length: 3\r\n\r\nabc";
+  EXPECT_EQ(input.size(), parser.execute(input.data(), input.size()));
+  EXPECT_EQ(HTTP_PATCH, parser.method());
+  EXPECT_EQ(1, parser.httpMajor());
+  EXPECT_EQ(0, parser.httpMinor());
+  EXPECT_EQ(3, parser.contentLength());
+  EXPECT_FALSE(parser.chunked());
+  EXPECT_TRUE(parser.lowerCasesHeaderNames());
+}
+
+TEST_P(SimdParserImplTest, ResponseFields) {
+  RecordingCallbacks callbacks;
+  SimdParserImpl parser(HTTP_RESPONSE, callbacks);
+  const std::string input = "HTTP/1.1 404 Not Found\r\ntransfer-encoding: chunked\r\n\r\n";
+  EXPECT_EQ(input.size(), parser.execute(input.data(), input.size()));
+  EXPECT_EQ(404, parser.statusCode());
+  EXPECT_EQ(ULLONG_MAX, parser.contentLength());
+  EXPECT_TRUE(parser.chunked());
+}
+
+TEST_P(SimdParserImplTest, EmptyValue) {
+  EXPECT_EQ("begin;url=/;field=a;value=;field=b;value=;headers;complete;",
+            parse(HTTP_REQUEST, "GET / HTTP/1.1\r\na:\r\nb: \r\n\r\n"));
+}
+
+TEST_P(SimdParserImplTest, BareLineFeeds) {
+  EXPECT_EQ("begin;url=/;field=a;value=b;headers;complete;",
+            parse(HTTP_REQUEST, "GET / HTTP/1.1\na: b\n\n"));
+}
+
+TEST_P(SimdParserImplTest, AbsoluteUrl) {
+  EXPECT_EQ("begin;url=http://example.com/a;headers;complete;",
+            parse(HTTP_REQUEST, "GET http://example.com/a HTTP/1.1\r\n\r\n"));
+  parse(HTTP_REQUEST, "GET http:/example.com/a HTTP/1.1\r\n\r\n", HPE_INVALID_URL);
+  parse(HTTP_REQUEST, "GET ht2p://example.com/a HTTP/1.1\r\n\r\n", HPE_INVALID_URL);
+}
+
+TEST_P(SimdParserImplTest, Connect) {
+  RecordingCallbacks callbacks;
+  SimdParserImpl parser(HTTP_REQUEST, callbacks);
+  const std::string input = "CONNECT example.com:443 HTTP/1.1\r\n\r\ntunnel";
+  EXPECT_EQ(input.size() - 6, parser.execute(input.data(), input.size()));
+  EXPECT_EQ("begin;url=example.com:443;headers;complete;", callbacks.log_);
+}
+
+TEST_P(SimdParserImplTest, Http09) {
+  RecordingCallbacks callbacks;
+  SimdParserImpl parser(HTTP_REQUEST, callbacks);
+  const std::string input = "GET /\r\n\r\n";
+  EXPECT_EQ(input.size(), parser.execute(input.data(), input.size()));
+  EXPECT_EQ(0, parser.httpMajor());
+  EXPECT_EQ(9, parser.httpMinor());
+}
+
+TEST_P(SimdParserImplTest, ContentLengthBody) {
+  EXPECT_EQ("begin;url=/;field=content-length;value=5 ;headers;body=hello;complete;"
+            "begin;url=/b;headers;complete;",
+            parse(HTTP_REQUEST, "POST / HTTP/1.1\r\nContent-Length: 5 \r\n\r\nhello"
+                                "\r\nGET /b HTTP/1.1\r\n\r\n"));
+}
+
+TEST_P(SimdParserImplTest, ChunkedBody) {
+  EXPECT_EQ("begin;url=/;field=transfer-encoding;value=Chunked;headers;body=helloworld!;complete;",
+            parse(HTTP_REQUEST, "POST / HTTP/1.1\r\nTransfer-Encoding: Chunked\r\n\r\n"
+                                "5\r\nhello\r\n6;name=value\r\nworld!\r\n0\r\n"
+                                "Trailer: value\r\n\r\n"));
+}
+
+TEST_P(SimdParserImplTest, ResponseUntilEof) {
+  EXPECT_EQ("begin;headers;body=all of it;complete;",
+            parse(HTTP_RESPONSE, "HTTP/1.0 200 OK\r\n\r\nall of it", HPE_OK, true));
+}
+
+TEST_P(SimdParserImplTest, ResponseWithoutBody) {
+  EXPECT_EQ("begin;headers;complete;begin;headers;complete;",
+            parse(HTTP_RESPONSE, "HTTP/1.1 204 No Content\r\n\r\nHTTP/1.1 304\r\n\r\n"));
+}
+
+TEST_P(SimdParserImplTest, NoBodyFromCallback) {
+  RecordingCallbacks callbacks;
+  callbacks.headers_complete_result_ = 1;
+  SimdParserImpl parser(HTTP_RESPONSE, callbacks);
+  const std::string input = "HTTP/1.1 200 OK\r\ncontent-length: 10\r\n\r\n";
+  EXPECT_EQ(input.size(), parser.execute(input.data(), input.size()));
+  EXPECT_EQ("begin;field=content-length;value=10;headers;complete;", callbacks.log_);
+}
+
+TEST_P(SimdParserImplTest, Upgrade) {
+  RecordingCallbacks callbacks;
+  callbacks.headers_complete_result_ = 2;
+  SimdParserImpl parser(HTTP_REQUEST, callbacks);
+  const std::string input = "GET / HTTP/1.1\r\nupgrade: websocket\r\n\r\nframes";
+  EXPECT_EQ(input.size() - 6, parser.execute(input.data(), input.size()));
+  EXPECT_EQ(HPE_OK, parser.error());
+}
+
+TEST_P(SimdParserImplTest, Pause) {
+  RecordingCallbacks callbacks;
+  SimdParserImpl parser(HTTP_REQUEST, callbacks);
+  callbacks.parser_ = &parser;
+  callbacks.pause_on_headers_ = true;
+  const std::string input = "POST / HTTP/1.1\r\ncontent-length: 2\r\n\r\nab";
+  const size_t parsed = parser.execute(input.data(), input.size());
+  EXPECT_EQ(input.size() - 2, parsed);
+  EXPECT_EQ(HPE_PAUSED, parser.error());
+  EXPECT_EQ(0, parser.execute(input.data() + parsed, input.size() - parsed));
+
+  parser.pause(false);
+  EXPECT_EQ(2, parser.execute(input.data() + parsed, input.size() - parsed));
+  EXPECT_EQ("begin;url=/;field=content-length;value=2;headers;body=ab;complete;", callbacks.log_);
+}
+
+// A pause in onHeadersComplete() at the end of the data must not make a later end of stream look
+// like it cuts the message short.
+TEST_P(SimdParserImplTest, PauseAtEndThenEof) {
+  RecordingCallbacks callbacks;
+  SimdParserImpl parser(HTTP_REQUEST, callbacks);
+  callbacks.parser_ = &parser;
+  callbacks.pause_on_headers_ = true;
+  const std::string input = "GET / HTTP/1.1\r\nhost: a\r\n\r\n";
+  EXPECT_EQ(input.size(), parser.execute(input.data(), input.size()));
+  EXPECT_EQ(HPE_PAUSED, parser.error());
+
+  parser.pause(false);
+  EXPECT_EQ(0, parser.execute(nullptr, 0));
+  EXPECT_EQ(HPE_OK, parser.error());
+  EXPECT_EQ("begin;url=/;field=host;value=a;headers;complete;", callbacks.log_);
+}
+
+// The same for a response whose body runs until the end of stream.
+TEST_P(SimdParserImplTest, PauseAtEndThenEofUntilEof) {
+  RecordingCallbacks callbacks;
+  SimdParserImpl parser(HTTP_RESPONSE, callbacks);
+  callbacks.parser_ = &parser;
+  callbacks.pause_on_headers_ = true;
+  const std::string input = "HTTP/1.1 200 OK\r\n\r\n";
+  EXPECT_EQ(input.size(), parser.execute(input.data(), input.size()));
+  EXPECT_EQ(HPE_PAUSED, parser.error());
+
+  parser.pause(false);
+  EXPECT_EQ(0, parser.execute(nullptr, 0));
+  EXPECT_EQ(HPE_OK, parser.error());
+  EXPECT_EQ("begin;headers;complete;", callbacks.log_);
+}
+
+TEST_P(SimdParserImplTest, ObsFold) {
+  EXPECT_EQ("begin;url=/;field=a;value=b c;headers;complete;",
+            parse(HTTP_REQUEST, "GET / HTTP/1.1\r\na: b\r\n  c\r\n\r\n"));
+}
+
+// Names and values long enough to go through every path of the vector routines, including the
+// table fallback for token characters which are not letters, digits or '-'.
+TEST_P(SimdParserImplTest, LongHeaders) {
+  std::string name;
+  std::string value;
+  for (int i = 0; i < 300; i++) {
+    name += "Ab-9_.~"[i % 7];
+    value += "aZ 9\t\x80!"[i % 7];
+  }
+  std::string lower_name = name;
+  for (char& c : lower_name) {
+    c = tolower(c);
+  }
+  const std::string url = "/" + std::string(100, 'u') + "\x80";
+  EXPECT_EQ("begin;url=" + url + ";field=" + lower_name + ";value=" + value + ";headers;complete;",
+            parse(HTTP_REQUEST, "GET " + url + " HTTP/1.1\r\n" + name + ": " + value + "\r\n\r\n"));
+}
+
+TEST_P(SimdParserImplTest, InvalidCharacters) {
+  const std::string padding(40, 'a');
+  parse(HTTP_REQUEST, "GET / HTTP/1.1\r\n" + padding + " b: c\r\n\r\n", HPE_INVALID_HEADER_TOKEN);
+  parse(HTTP_REQUEST, "GET / HTTP/1.1\r\n" + padding + "\x80: c\r\n\r\n",
+        HPE_INVALID_HEADER_TOKEN);
+  parse(HTTP_REQUEST, "GET / HTTP/1.1\r\n: c\r\n\r\n", HPE_INVALID_HEADER_TOKEN);
+  parse(HTTP_REQUEST, "GET / HTTP/1.1\r\na: " + padding + "\x01\r\n\r\n",
+        HPE_INVALID_HEADER_TOKEN);
+  parse(HTTP_REQUEST, "GET / HTTP/1.1\r\na: " + padding + "\x7f\r\n\r\n",
+        HPE_INVALID_HEADER_TOKEN);
+  parse(HTTP_REQUEST, "GET /" + padding + "\x01 HTTP/1.1\r\n\r\n", HPE_INVALID_URL);
+  parse(HTTP_REQUEST, "GET / HTTP/1.1\r\n a: b\r\n\r\n", HPE_INVALID_HEADER_TOKEN);
+}
+
+TEST_P(SimdParserImplTest, InvalidStartLine) {
+  parse(HTTP_REQUEST, "get / HTTP/1.1\r\n\r\n", HPE_INVALID_METHOD);
+  parse(HTTP_REQUEST, "GETS / HTTP/1.1\r\n\r\n", HPE_INVALID_METHOD);
+  parse(HTTP_REQUEST, "GET ? HTTP/1.1\r\n\r\n", HPE_INVALID_URL);
+  parse(HTTP_REQUEST, "GET / HTTX/1.1\r\n\r\n", HPE_INVALID_CONSTANT);
+  parse(HTTP_REQUEST, "GET / HTTP/1,1\r\n\r\n", HPE_INVALID_VERSION);
+  parse(HTTP_REQUEST, "GET / HTTP/1.1 \r\n\r\n", HPE_INVALID_VERSION);
+  parse(HTTP_REQUEST, "GET / HTTP/1.1\rX\n\r\n", HPE_LF_EXPECTED);
+  parse(HTTP_RESPONSE, "XTTP/1.1 200 OK\r\n\r\n", HPE_INVALID_CONSTANT);
+  parse(HTTP_RESPONSE, "HTTP/1.1 2000 OK\r\n\r\n", HPE_INVALID_STATUS);
+  parse(HTTP_RESPONSE, "HTTP/1.1 OK\r\n\r\n", HPE_INVALID_STATUS);
+  parse(HTTP_RESPONSE, "HTTP/1.1 200 O\x01K\r\n\r\n", HPE_INVALID_STATUS);
+}
+
+TEST_P(SimdParserImplTest, InvalidFraming) {
+  parse(HTTP_REQUEST, "POST / HTTP/1.1\r\ncontent-length: 1\r\ncontent-length: 1\r\n\r\n",
+        HPE_UNEXPECTED_CONTENT_LENGTH);
+  parse(HTTP_REQUEST, "POST / HTTP/1.1\r\ncontent-length: 1\r\ntransfer-encoding: chunked\r\n\r\n",
+        HPE_UNEXPECTED_CONTENT_LENGTH);
+  parse(HTTP_REQUEST, "POST / HTTP/1.1\r\ncontent-length: 1x\r\n\r\n", HPE_INVALID_CONTENT_LENGTH);
+  parse(HTTP_REQUEST, "POST / HTTP/1.1\r\ncontent-length: 1 2\r\n\r\n",
+        HPE_INVALID_CONTENT_LENGTH);
+  parse(HTTP_REQUEST, "POST / HTTP/1.1\r\ncontent-length:\r\n\r\n", HPE_INVALID_CONTENT_LENGTH);
+  parse(HTTP_REQUEST, "POST / HTTP/1.1\r\ncontent-length: 99999999999999999999\r\n\r\n",
+        HPE_INVALID_CONTENT_LENGTH);
+  parse(HTTP_REQUEST, "POST / HTTP/1.1\r\ntransfer-encoding: chunked\r\n\r\nx\r\n",
+        HPE_INVALID_CHUNK_SIZE);
+  parse(HTTP_REQUEST, "POST / HTTP/1.1\r\ntransfer-encoding: chunked\r\n\r\n1\r\nab\r\n",
+        HPE_INVALID_CHUNK_SIZE);
+  parse(HTTP_REQUEST, "POST / HTTP/1.1\r\ntransfer-encoding: chunked\r\n\r\n11111111111111111\r\n",
+        HPE_INVALID_CHUNK_SIZE);
+}
+
+TEST_P(SimdParserImplTest, HeaderOverflow) {
+  const std::string value(HTTP_MAX_HEADER_SIZE, 'a');
+  RecordingCallbacks callbacks;
+  SimdParserImpl parser(HTTP_REQUEST, callbacks);
+  const std::string input = "GET / HTTP/1.1\r\na: " + value + "\r\n\r\n";
+  parser.execute(input.data(), input.size());
+  EXPECT_EQ(HPE_HEADER_OVERFLOW, parser.error());
+
+  // The limit applies to each message, and not to the body.
+  RecordingCallbacks body_callbacks;
+  SimdParserImpl body_parser(HTTP_REQUEST, body_callbacks);
+  const std::string half_value(HTTP_MAX_HEADER_SIZE / 2, 'a');
+  const std::string message = "POST / HTTP/1.1\r\ncontent-length: " +
+                              std::to_string(value.size()) + "\r\na: " + half_value + "\r\n\r\n" +
+                              value;
+  const std::string body_input = message + message + message;
+  EXPECT_EQ(body_input.size(), body_parser.execute(body_input.data(), body_input.size()));
+  EXPECT_EQ(HPE_OK, body_parser.error());
+}
+
+TEST_P(SimdParserImplTest, Eof) {
+  RecordingCallbacks callbacks;
+  SimdParserImpl parser(HTTP_REQUEST, callbacks);
+  EXPECT_EQ(0, parser.execute(nullptr, 0));
+  EXPECT_EQ(HPE_OK, parser.error());
+
+  const std::string input = "GET / HTTP/1.1\r\n";
+  parser.execute(input.data(), input.size());
+  parser.execute(nullptr, 0);
+  EXPECT_EQ(HPE_INVALID_EOF_STATE, parser.error());
+}
+
+} // namespace
+} // namespace Http1
+} // namespace Http
+} // namespace Envoy
@@ -1,3 +1,4 @@
+#include <algorithm>
 #include <cstdint>
 #include <string>
 
@@ -380,6 +381,50 @@ TEST_P(Http2CodecImplTest, TrailingHeadersLargeBody) {
   response_encoder_->encodeTrailers(TestHeaderMapImpl{{"trailing", "header"}});
 }
 
+// Verify that a large DATA payload reaches the decoder in the slice it was received in, rather than
+// being copied, and that a small one is copied.
+TEST_P(Http2CodecImplTest, ReceivedDataNotCopied) {
+  initialize();
+
+  TestHeaderMapImpl request_headers;
+  HttpTestUtility::addDefaultHeaders(request_headers);
+  EXPECT_CALL(request_decoder_, decodeHeaders_(_, false));
+  request_encoder_->encodeHeaders(request_headers, false);
+
+  // Move the frames out of the written buffer, as the connection does, so that the payload slices
+  // which are dispatched to the server are the ones the client encoded.
+  Buffer::OwnedImpl written;
+  ON_CALL(client_connection_, write(_, _))
+      .WillByDefault(Invoke([&](Buffer::Instance& data, bool) -> void { written.move(data); }));
+  Buffer::OwnedImpl large_body(std::string(8192, 'a'));
+  Buffer::RawSlice large_slice;
+  large_body.getRawSlices(&large_slice, 1);
+  request_encoder_->encodeData(large_body, false);
+
+  EXPECT_CALL(request_decoder_, decodeData(_, false))
+      .WillOnce(Invoke([&](Buffer::Instance& data, bool) -> void {
+        Buffer::RawSlice slice;
+        EXPECT_EQ(1, data.getRawSlices(&slice, 1));
+        EXPECT_EQ(large_slice.mem_, slice.mem_);
+        EXPECT_EQ(8192, slice.len_);
+      }));
+  server_->dispatch(written);
+
+  Buffer::OwnedImpl small_body(std::string(1024, 'a'));
+  Buffer::RawSlice small_slice;
+  small_body.getRawSlices(&small_slice, 1);
+  request_encoder_->encodeData(small_body, true);
+
+  EXPECT_CALL(request_decoder_, decodeData(_, true))
+      .WillOnce(Invoke([&](Buffer::Instance& data, bool) -> void {
+        Buffer::RawSlice slice;
+        EXPECT_EQ(1, data.getRawSlices(&slice, 1));
+        EXPECT_NE(small_slice.mem_, slice.mem_);
+        EXPECT_EQ(1024, slice.len_);
+      }));
+  server_->dispatch(written);
+}
+
 TEST_P(Http2CodecImplTest, SmallMetadataTest) {
   allow_metadata_ = true;
   initialize();
@@ -782,6 +827,81 @@ TEST_P(Http2CodecImplStreamLimitTest, MaxClientStreams) {
   }
 }
 
+class Http2CodecImplHeaderIndexingTest : public Http2CodecImplTest {
+public:
+  void initialize() {
+    Http2SettingsFromTuple(client_http2settings_, ::testing::get<0>(GetParam()));
+    Http2SettingsFromTuple(server_http2settings_, ::testing::get<1>(GetParam()));
+    client_ = std::make_unique<TestClientConnectionImpl>(client_connection_, client_callbacks_,
+                                                         stats_store_, client_http2settings_);
+    server_ = std::make_unique<TestServerConnectionImpl>(server_connection_, server_callbacks_,
+                                                         stats_store_, server_http2settings_);
+    setupDefaultConnectionMocks();
+  }
+
+  // Sends a request with the given headers, returning the size of its encoded header block.
+  uint64_t sendRequest(TestHeaderMapImpl& request_headers) {
+    request_encoder_ = &client_->newStream(response_decoder_);
+    EXPECT_CALL(server_callbacks_, newStream(_))
+        .WillOnce(Invoke([&](StreamEncoder& encoder) -> StreamDecoder& {
+          response_encoder_ = &encoder;
+          return request_decoder_;
+        }));
+    HttpTestUtility::addDefaultHeaders(request_headers);
+    EXPECT_CALL(request_decoder_, decodeHeaders_(_, true));
+    Stats::Counter& block_bytes = stats_store_.counter("http2.tx_header_block_bytes");
+    const uint64_t previous_block_bytes = block_bytes.value();
+    request_encoder_->encodeHeaders(request_headers, true);
+    return block_bytes.value() - previous_block_bytes;
+  }
+
+  const std::string long_value_ =
+      "0123456789abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789abcdefghijklmnopqr";
+};
+
+// Verify that ordinary headers are indexed, so that repeating them costs a table reference.
+TEST_P(Http2CodecImplHeaderIndexingTest, RepeatedHeadersIndexed) {
+  initialize();
+  uint64_t max_block_bytes = 0;
+  for (int i = 0; i < 20; ++i) {
+    const std::string request_id = std::to_string(i);
+    TestHeaderMapImpl request_headers{
+        {"x-route", long_value_},
+        {"x-request-id", std::string(36 - request_id.size(), '0') + request_id}};
+    const uint64_t request_block_bytes = sendRequest(request_headers);
+    if (i > 0) {
+      max_block_bytes = std::max(max_block_bytes, request_block_bytes);
+    }
+  }
+
+  // After the first request, only the value of the request ID is sent as a literal.
+  EXPECT_LT(max_block_bytes, 40);
+  EXPECT_LT(stats_store_.counter("http2.tx_header_block_bytes").value(),
+            stats_store_.counter("http2.tx_header_field_bytes").value() / 4);
+}
+
+// Verify that headers which carry credentials are never indexed, so each request sends them in
+// full.
+TEST_P(Http2CodecImplHeaderIndexingTest, CredentialsNeverIndexed) {
+  initialize();
+  for (const std::string name : {"authorization", "proxy-authorization"}) {
+    TestHeaderMapImpl first_headers{{name, long_value_}};
+    sendRequest(first_headers);
+    TestHeaderMapImpl second_headers{{name, long_value_}};
+    // Even Huffman coded, the value takes more than half its length.
+    EXPECT_GT(sendRequest(second_headers), long_value_.size() / 2) << name;
+  }
+}
+
+// Verify that a long cookie which repeats is indexed rather than sent in full on every request.
+TEST_P(Http2CodecImplHeaderIndexingTest, LongCookieIndexed) {
+  initialize();
+  TestHeaderMapImpl first_headers{{"cookie", long_value_}};
+  const uint64_t first_block_bytes = sendRequest(first_headers);
+  TestHeaderMapImpl second_headers{{"cookie", long_value_}};
+  EXPECT_LT(sendRequest(second_headers), first_block_bytes - long_value_.size() / 2);
+}
+
 #define HTTP2SETTINGS_SMALL_WINDOW_COMBINE                                                         \
   ::testing::Combine(::testing::Values(Http2Settings::DEFAULT_HPACK_TABLE_SIZE),                   \
                      ::testing::Values(Http2Settings::DEFAULT_MAX_CONCURRENT_STREAMS),             \
@@ -811,6 +931,10 @@ INSTANTIATE_TEST_CASE_P(Http2CodecImplStreamLimitTest, Http2CodecImplStreamLimit
                         ::testing::Combine(HTTP2SETTINGS_DEFAULT_COMBINE,
                                            HTTP2SETTINGS_DEFAULT_COMBINE));
 
+INSTANTIATE_TEST_CASE_P(Http2CodecImplHeaderIndexingTest, Http2CodecImplHeaderIndexingTest,
+                        ::testing::Combine(HTTP2SETTINGS_DEFAULT_COMBINE,
+                                           HTTP2SETTINGS_DEFAULT_COMBINE));
+
 INSTANTIATE_TEST_CASE_P(Http2CodecImplTestDefaultSettings, Http2CodecImplTest,
                         ::testing::Combine(HTTP2SETTINGS_DEFAULT_COMBINE,
                                            HTTP2SETTINGS_DEFAULT_COMBINE));
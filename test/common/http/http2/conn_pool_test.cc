@@ -189,14 +189,13 @@ TEST_F(Http2ConnPoolImplTest, DrainConnections) {
   EXPECT_CALL(r2.inner_encoder_, encodeHeaders(_, true));
   r2.callbacks_.outer_encoder_->encodeHeaders(HeaderMapImpl{}, true);
 
-  // This will move primary to draining and destroy draining.
+  // This will move primary to draining, alongside the client which is already draining.
   pool_.drainConnections();
-  EXPECT_CALL(*this, onClientDestroy());
-  dispatcher_.clearDeferredDeleteList();
 
-  // This will destroy draining.
+  // This will destroy both draining clients.
   test_clients_[1].connection_->raiseEvent(Network::ConnectionEvent::RemoteClose);
-  EXPECT_CALL(*this, onClientDestroy());
+  test_clients_[0].connection_->raiseEvent(Network::ConnectionEvent::RemoteClose);
+  EXPECT_CALL(*this, onClientDestroy()).Times(2);
   dispatcher_.clearDeferredDeleteList();
 }
 
@@ -338,6 +337,9 @@ TEST_F(Http2ConnPoolImplTest, VerifyConnectionTimingStats) {
   ActiveTestRequest r1(*this, 0, false);
   EXPECT_CALL(cluster_->stats_store_,
               deliverHistogramToSinks(Property(&Stats::Metric::name, "upstream_cx_connect_ms"), _));
+  EXPECT_CALL(cluster_->stats_store_,
+              deliverHistogramToSinks(
+                  Property(&Stats::Metric::name, "upstream_cx_http2_active_streams"), 1));
   expectClientConnect(0, r1);
   EXPECT_CALL(r1.inner_encoder_, encodeHeaders(_, true));
   r1.callbacks_.outer_encoder_->encodeHeaders(HeaderMapImpl{}, true);
@@ -626,6 +628,102 @@ TEST_F(Http2ConnPoolImplTest, GoAway) {
   EXPECT_EQ(1U, cluster_->stats_.upstream_cx_close_notify_.value());
 }
 
+// Verifies that streams are spread over the configured number of connections, picking the one
+// with the fewest active streams.
+TEST_F(Http2ConnPoolImplTest, MultipleConnectionsLeastActiveStreams) {
+  InSequence s;
+  cluster_->http2_settings_.connections_per_host_ = 2;
+
+  expectClientCreate();
+  ActiveTestRequest r1(*this, 0, false);
+  expectClientConnect(0, r1);
+
+  // A second connection is opened for the next stream, which uses the connected one meanwhile.
+  expectClientCreate();
+  ActiveTestRequest r2(*this, 0, true);
+  EXPECT_CALL(*test_clients_[1].connect_timer_, disableTimer());
+  test_clients_[1].connection_->raiseEvent(Network::ConnectionEvent::Connected);
+
+  ActiveTestRequest r3(*this, 1, true);
+  ActiveTestRequest r4(*this, 1, true);
+  ActiveTestRequest r5(*this, 0, true);
+  EXPECT_EQ(2U, cluster_->stats_.upstream_cx_total_.value());
+
+  // Completing streams makes their connection the least loaded one.
+  EXPECT_CALL(r1.decoder_, decodeHeaders_(_, true));
+  r1.inner_decoder_->decodeHeaders(HeaderMapPtr{new HeaderMapImpl{}}, true);
+  EXPECT_CALL(r2.decoder_, decodeHeaders_(_, true));
+  r2.inner_decoder_->decodeHeaders(HeaderMapPtr{new HeaderMapImpl{}}, true);
+  ActiveTestRequest r6(*this, 0, true);
+
+  test_clients_[0].connection_->raiseEvent(Network::ConnectionEvent::RemoteClose);
+  test_clients_[1].connection_->raiseEvent(Network::ConnectionEvent::RemoteClose);
+  EXPECT_CALL(*this, onClientDestroy()).Times(2);
+  dispatcher_.clearDeferredDeleteList();
+}
+
+// Verifies that streams can be sent on the connection with the most flow-control window.
+TEST_F(Http2ConnPoolImplTest, MultipleConnectionsMostSendWindow) {
+  InSequence s;
+  cluster_->http2_settings_.connections_per_host_ = 2;
+  cluster_->http2_settings_.connection_selection_ =
+      Http2Settings::ConnectionSelection::MostSendWindow;
+
+  expectClientCreate();
+  ActiveTestRequest r1(*this, 0, false);
+  expectClientConnect(0, r1);
+  expectClientCreate();
+  ActiveTestRequest r2(*this, 0, true);
+  EXPECT_CALL(*test_clients_[1].connect_timer_, disableTimer());
+  test_clients_[1].connection_->raiseEvent(Network::ConnectionEvent::Connected);
+
+  ON_CALL(*test_clients_[0].codec_, sendWindow()).WillByDefault(Return(1024));
+  ON_CALL(*test_clients_[1].codec_, sendWindow()).WillByDefault(Return(65535));
+  ActiveTestRequest r3(*this, 1, true);
+  ActiveTestRequest r4(*this, 1, true);
+
+  ON_CALL(*test_clients_[1].codec_, sendWindow()).WillByDefault(Return(0));
+  ActiveTestRequest r5(*this, 0, true);
+
+  test_clients_[0].connection_->raiseEvent(Network::ConnectionEvent::RemoteClose);
+  test_clients_[1].connection_->raiseEvent(Network::ConnectionEvent::RemoteClose);
+  EXPECT_CALL(*this, onClientDestroy()).Times(2);
+  dispatcher_.clearDeferredDeleteList();
+}
+
+// Verifies that a connection which reaches max streams drains while the others keep taking streams.
+TEST_F(Http2ConnPoolImplTest, MultipleConnectionsMaxStreams) {
+  InSequence s;
+  cluster_->http2_settings_.connections_per_host_ = 2;
+  pool_.max_streams_ = 2;
+
+  expectClientCreate();
+  ActiveTestRequest r1(*this, 0, false);
+  expectClientConnect(0, r1);
+  expectClientCreate();
+  ActiveTestRequest r2(*this, 0, true);
+  EXPECT_CALL(*test_clients_[1].connect_timer_, disableTimer());
+  test_clients_[1].connection_->raiseEvent(Network::ConnectionEvent::Connected);
+
+  // The first connection has had its two streams, so it drains and a third one is opened.
+  expectClientCreate();
+  ActiveTestRequest r3(*this, 1, true);
+
+  // The first connection is closed once its streams complete.
+  EXPECT_CALL(r1.decoder_, decodeHeaders_(_, true));
+  r1.inner_decoder_->decodeHeaders(HeaderMapPtr{new HeaderMapImpl{}}, true);
+  EXPECT_CALL(dispatcher_, deferredDelete_(_));
+  EXPECT_CALL(r2.decoder_, decodeHeaders_(_, true));
+  r2.inner_decoder_->decodeHeaders(HeaderMapPtr{new HeaderMapImpl{}}, true);
+  EXPECT_CALL(*this, onClientDestroy());
+  dispatcher_.clearDeferredDeleteList();
+
+  test_clients_[1].connection_->raiseEvent(Network::ConnectionEvent::RemoteClose);
+  test_clients_[2].connection_->raiseEvent(Network::ConnectionEvent::RemoteClose);
+  EXPECT_CALL(*this, onClientDestroy()).Times(2);
+  dispatcher_.clearDeferredDeleteList();
+}
+
 } // namespace Http2
 } // namespace Http
 } // namespace Envoy
@@ -264,6 +264,9 @@ TEST(HttpUtility, parseHttp2Settings) {
               http2_settings.initial_stream_window_size_);
     EXPECT_EQ(Http2Settings::DEFAULT_INITIAL_CONNECTION_WINDOW_SIZE,
               http2_settings.initial_connection_window_size_);
+    EXPECT_EQ(Http2Settings::DEFAULT_CONNECTIONS_PER_HOST, http2_settings.connections_per_host_);
+    EXPECT_EQ(Http2Settings::ConnectionSelection::LeastActiveStreams,
+              http2_settings.connection_selection_);
   }
 
   {
@@ -280,6 +283,17 @@ TEST(HttpUtility, parseHttp2Settings) {
     EXPECT_EQ(3U, http2_settings.initial_stream_window_size_);
     EXPECT_EQ(4U, http2_settings.initial_connection_window_size_);
   }
+
+  {
+    envoy::api::v2::core::Http2ProtocolOptions http2_protocol_options;
+    http2_protocol_options.mutable_connections_per_host()->set_value(4);
+    http2_protocol_options.set_connection_selection(
+        envoy::api::v2::core::Http2ProtocolOptions::MOST_SEND_WINDOW);
+    auto http2_settings = Utility::parseHttp2Settings(http2_protocol_options);
+    EXPECT_EQ(4U, http2_settings.connections_per_host_);
+    EXPECT_EQ(Http2Settings::ConnectionSelection::MostSendWindow,
+              http2_settings.connection_selection_);
+  }
 }
 
 TEST(HttpUtility, getLastAddressFromXFF) {
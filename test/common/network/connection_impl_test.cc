@@ -1,14 +1,27 @@
+#include <fcntl.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <cerrno>
 #include <cstdint>
+#include <deque>
 #include <memory>
 #include <string>
+#include <thread>
+#include <vector>
+
+#include "envoy/event/io_uring.h"
 
 #include "common/buffer/buffer_impl.h"
 #include "common/common/empty_string.h"
 #include "common/common/fmt.h"
 #include "common/event/dispatcher_impl.h"
+#include "common/event/io_uring_impl.h"
 #include "common/network/address_impl.h"
 #include "common/network/connection_impl.h"
 #include "common/network/listen_socket_impl.h"
+#include "common/network/raw_buffer_socket.h"
 #include "common/network/utility.h"
 #include "common/runtime/runtime_impl.h"
 
@@ -32,6 +45,8 @@ using testing::DoAll;
 using testing::InSequence;
 using testing::Invoke;
 using testing::InvokeWithoutArgs;
+using testing::NiceMock;
+using testing::Property;
 using testing::Return;
 using testing::SaveArg;
 using testing::Sequence;
@@ -48,6 +63,192 @@ TEST(RawBufferSocket, TestBasics) {
   EXPECT_EQ("", raw_buffer_socket->protocol());
 }
 
+TEST(RawBufferSocket, WriteStats) {
+  int fds[2];
+  ASSERT_EQ(0, socketpair(AF_UNIX, SOCK_STREAM, 0, fds));
+  ASSERT_EQ(0, fcntl(fds[0], F_SETFL, O_NONBLOCK));
+  NiceMock<Stats::MockIsolatedStatsStore> store;
+  RawBufferSocketFactory factory(store);
+  TransportSocketPtr raw_buffer_socket = factory.createTransportSocket();
+  NiceMock<MockTransportSocketCallbacks> callbacks;
+  ON_CALL(callbacks, fd()).WillByDefault(Return(fds[0]));
+  raw_buffer_socket->setTransportSocketCallbacks(callbacks);
+
+  // Every fragment is written by a single writev().
+  const std::string header_block = "HTTP/1.1 200 OK\r\ncontent-length: 5\r\n\r\n";
+  const std::string body = "hello";
+  BufferFragmentImpl header_fragment(header_block.data(), header_block.size(), nullptr);
+  BufferFragmentImpl body_fragment(body.data(), body.size(), nullptr);
+  Buffer::OwnedImpl response;
+  response.addBufferFragment(header_fragment);
+  response.addBufferFragment(body_fragment);
+  EXPECT_CALL(store, deliverHistogramToSinks(
+                         Property(&Stats::Metric::name, "raw_buffer_socket.write_iovecs"), 2));
+  IoResult result = raw_buffer_socket->doWrite(response, false);
+  EXPECT_EQ(PostIoAction::KeepOpen, result.action_);
+  EXPECT_EQ(header_block.size() + body.size(), result.bytes_processed_);
+  EXPECT_EQ(0, response.length());
+  EXPECT_EQ(0, store.counter("raw_buffer_socket.write_partial").value());
+
+  // A write which fills the socket is partial, and the remainder stays buffered.
+  Buffer::OwnedImpl large(std::string(4 * 1024 * 1024, 'a'));
+  result = raw_buffer_socket->doWrite(large, false);
+  EXPECT_EQ(PostIoAction::KeepOpen, result.action_);
+  EXPECT_NE(0, large.length());
+  EXPECT_EQ(1, store.counter("raw_buffer_socket.write_partial").value());
+
+  close(fds[0]);
+  close(fds[1]);
+}
+
+// A buffer with more slices than a single writev() takes is written by several writes, each of
+// which records the number of slices it was given.
+TEST(RawBufferSocket, WriteStatsManySlices) {
+  int fds[2];
+  ASSERT_EQ(0, socketpair(AF_UNIX, SOCK_STREAM, 0, fds));
+  ASSERT_EQ(0, fcntl(fds[0], F_SETFL, O_NONBLOCK));
+  NiceMock<Stats::MockIsolatedStatsStore> store;
+  RawBufferSocketFactory factory(store);
+  TransportSocketPtr raw_buffer_socket = factory.createTransportSocket();
+  NiceMock<MockTransportSocketCallbacks> callbacks;
+  ON_CALL(callbacks, fd()).WillByDefault(Return(fds[0]));
+  raw_buffer_socket->setTransportSocketCallbacks(callbacks);
+
+  const uint64_t extra_slices = 10;
+  const std::string data = "a";
+  std::vector<std::unique_ptr<BufferFragmentImpl>> fragments;
+  Buffer::OwnedImpl buffer;
+  for (uint64_t i = 0; i < Buffer::OwnedImpl::MaxWriteSlices + extra_slices; i++) {
+    fragments.push_back(std::make_unique<BufferFragmentImpl>(data.data(), data.size(), nullptr));
+    buffer.addBufferFragment(*fragments.back());
+  }
+  EXPECT_CALL(store, deliverHistogramToSinks(
+                         Property(&Stats::Metric::name, "raw_buffer_socket.write_iovecs"),
+                         Buffer::OwnedImpl::MaxWriteSlices));
+  EXPECT_CALL(store, deliverHistogramToSinks(
+                         Property(&Stats::Metric::name, "raw_buffer_socket.write_iovecs"),
+                         extra_slices));
+  IoResult result = raw_buffer_socket->doWrite(buffer, false);
+  EXPECT_EQ(PostIoAction::KeepOpen, result.action_);
+  EXPECT_EQ(Buffer::OwnedImpl::MaxWriteSlices + extra_slices, result.bytes_processed_);
+  EXPECT_EQ(0, buffer.length());
+  EXPECT_EQ(0, store.counter("raw_buffer_socket.write_partial").value());
+
+  close(fds[0]);
+  close(fds[1]);
+}
+
+// An io_uring which holds the requests submitted to it, for the test to complete.
+class FakeIoUring : public Event::IoUring {
+public:
+  // Event::IoUring
+  Event::IoUringRequest& recv(int, void*, uint32_t, Event::IoUringRequestPtr&& request) override {
+    recvs_.push_back(std::move(request));
+    return *recvs_.back();
+  }
+  Event::IoUringRequest& sendmsg(int, const msghdr& message,
+                                 Event::IoUringRequestPtr&& request) override {
+    std::string data;
+    for (size_t i = 0; i < message.msg_iovlen; i++) {
+      data.append(static_cast<const char*>(message.msg_iov[i].iov_base),
+                  message.msg_iov[i].iov_len);
+    }
+    sent_data_.push_back(data);
+    sends_.push_back(std::move(request));
+    return *sends_.back();
+  }
+  void cancel(Event::IoUringRequest& request) override { cancelled_.push_back(&request); }
+  void submit() override {}
+
+  // Completes the oldest send which has not completed.
+  void completeSend(int32_t result) {
+    Event::IoUringRequestPtr request = std::move(sends_.front());
+    sends_.pop_front();
+    request->onCompletion(result);
+  }
+
+  std::deque<Event::IoUringRequestPtr> recvs_;
+  std::deque<Event::IoUringRequestPtr> sends_;
+  std::vector<std::string> sent_data_;
+  std::vector<Event::IoUringRequest*> cancelled_;
+};
+
+// With an io_uring, written data stays in the buffer until a send completes, and only what
+// completed sends sent is reported as written.
+TEST(RawBufferSocket, IoUringWriteReportsSentBytes) {
+  FakeIoUring ring;
+  NiceMock<MockTransportSocketCallbacks> callbacks;
+  ON_CALL(callbacks, ioUring()).WillByDefault(Return(&ring));
+  RawBufferSocket raw_buffer_socket;
+  raw_buffer_socket.setTransportSocketCallbacks(callbacks);
+
+  Buffer::OwnedImpl buffer("hello world");
+  IoResult result = raw_buffer_socket.doWrite(buffer, false);
+  EXPECT_EQ(PostIoAction::KeepOpen, result.action_);
+  EXPECT_EQ(0, result.bytes_processed_);
+  EXPECT_EQ("hello world", buffer.toString());
+  ASSERT_EQ(1, ring.sends_.size());
+  EXPECT_EQ("hello world", ring.sent_data_.back());
+
+  // What is written while a send is in flight waits for it to complete.
+  buffer.add("!");
+  result = raw_buffer_socket.doWrite(buffer, false);
+  EXPECT_EQ(0, result.bytes_processed_);
+  EXPECT_EQ(1, ring.sends_.size());
+
+  // A partial send is drained and reported, and the rest of its data is sent before the new data.
+  EXPECT_CALL(callbacks, setWriteBufferReady());
+  ring.completeSend(6);
+  ASSERT_EQ(1, ring.sends_.size());
+  EXPECT_EQ("world", ring.sent_data_.back());
+  result = raw_buffer_socket.doWrite(buffer, false);
+  EXPECT_EQ(6, result.bytes_processed_);
+  EXPECT_EQ("world!", buffer.toString());
+
+  EXPECT_CALL(callbacks, setWriteBufferReady());
+  ring.completeSend(5);
+  result = raw_buffer_socket.doWrite(buffer, false);
+  EXPECT_EQ(5, result.bytes_processed_);
+  EXPECT_EQ("!", buffer.toString());
+  ASSERT_EQ(1, ring.sends_.size());
+  EXPECT_EQ("!", ring.sent_data_.back());
+
+  EXPECT_CALL(callbacks, setWriteBufferReady());
+  ring.completeSend(1);
+  result = raw_buffer_socket.doWrite(buffer, false);
+  EXPECT_EQ(1, result.bytes_processed_);
+  EXPECT_EQ(0, buffer.length());
+  EXPECT_EQ(0, ring.sends_.size());
+
+  raw_buffer_socket.closeSocket(ConnectionEvent::LocalClose);
+  EXPECT_EQ(0, ring.cancelled_.size());
+}
+
+// With an io_uring, a send still in flight when the socket is closed is cancelled, so that a peer
+// which stopped reading does not keep the socket and the data alive.
+TEST(RawBufferSocket, IoUringCloseCancelsSend) {
+  FakeIoUring ring;
+  NiceMock<MockTransportSocketCallbacks> callbacks;
+  ON_CALL(callbacks, ioUring()).WillByDefault(Return(&ring));
+  NiceMock<Stats::MockIsolatedStatsStore> store;
+  RawBufferSocketFactory factory(store);
+  TransportSocketPtr raw_buffer_socket = factory.createTransportSocket();
+  raw_buffer_socket->setTransportSocketCallbacks(callbacks);
+
+  Buffer::OwnedImpl buffer("hello");
+  raw_buffer_socket->doWrite(buffer, false);
+  ASSERT_EQ(1, ring.sends_.size());
+
+  raw_buffer_socket->closeSocket(ConnectionEvent::LocalClose);
+  ASSERT_EQ(1, ring.cancelled_.size());
+  EXPECT_EQ(ring.sends_.front().get(), ring.cancelled_.front());
+  EXPECT_EQ(1, store.counter("raw_buffer_socket.write_cancelled").value());
+
+  // The cancelled send completes without calling back into the socket.
+  EXPECT_CALL(callbacks, setWriteBufferReady()).Times(0);
+  ring.completeSend(-ECANCELED);
+}
+
 TEST(ConnectionImplUtility, updateBufferStats) {
   StrictMock<Stats::MockCounter> counter;
   StrictMock<Stats::MockGauge> gauge;
@@ -91,7 +292,7 @@ public:
     if (dispatcher_.get() == nullptr) {
       dispatcher_ = std::make_unique<Event::DispatcherImpl>(time_system_);
     }
-    listener_ = dispatcher_->createListener(socket_, listener_callbacks_, true, false);
+    listener_ = dispatcher_->createListener(socket_, listener_callbacks_, true, false, 0);
 
     client_connection_ = dispatcher_->createClientConnection(
         socket_.localAddress(), source_address_, Network::Test::createRawBufferSocket(), nullptr);
@@ -851,7 +1052,7 @@ TEST_P(ConnectionImplTest, BindFailureTest) {
         new Network::Address::Ipv6Instance(address_string, 0)};
   }
   dispatcher_ = std::make_unique<Event::DispatcherImpl>(time_system_);
-  listener_ = dispatcher_->createListener(socket_, listener_callbacks_, true, false);
+  listener_ = dispatcher_->createListener(socket_, listener_callbacks_, true, false, 0);
 
   client_connection_ = dispatcher_->createClientConnection(
       socket_.localAddress(), source_address_, Network::Test::createRawBufferSocket(), nullptr);
@@ -915,6 +1116,140 @@ TEST_P(ConnectionImplTest, EmptyReadOnCloseTest) {
   disconnect(true);
 }
 
+// Test that data larger than a single receive or send crosses a connection intact when the
+// dispatcher reads and writes sockets through io_uring.
+TEST_P(ConnectionImplTest, IoUring) {
+  if (!Event::DispatcherImpl::useIoUring(true)) {
+    return;
+  }
+  dispatcher_ = std::make_unique<Event::DispatcherImpl>(time_system_);
+  Event::DispatcherImpl::useIoUring(false);
+  ASSERT_NE(nullptr, dispatcher_->ioUring());
+
+  setUpBasicConnection();
+  connect();
+
+  std::string data;
+  for (uint32_t i = 0; i < 1024 * 1024; i++) {
+    data.push_back('a' + i % 26);
+  }
+  std::string received;
+  EXPECT_CALL(*read_filter_, onData(_, false))
+      .WillRepeatedly(Invoke([&](Buffer::Instance& buffer, bool) -> FilterStatus {
+        received.append(buffer.toString());
+        buffer.drain(buffer.length());
+        if (received.size() == data.size()) {
+          dispatcher_->exit();
+        }
+        return FilterStatus::StopIteration;
+      }));
+  Buffer::OwnedImpl buffer(data);
+  client_connection_->write(buffer, false);
+  dispatcher_->run(Event::Dispatcher::RunType::Block);
+  EXPECT_EQ(data, received);
+
+  disconnect(true);
+}
+
+// Test that when the dispatcher reads sockets through io_uring, what a receive in flight gets while
+// reads are disabled is not read by the connection until reads are enabled again.
+TEST_P(ConnectionImplTest, IoUringReadDisable) {
+  if (!Event::DispatcherImpl::useIoUring(true)) {
+    return;
+  }
+  dispatcher_ = std::make_unique<Event::DispatcherImpl>(time_system_);
+  Event::DispatcherImpl::useIoUring(false);
+  ASSERT_NE(nullptr, dispatcher_->ioUring());
+
+  setUpBasicConnection();
+  connect();
+  NiceMockConnectionStats server_connection_stats;
+  uint64_t bytes_read = 0;
+  ON_CALL(server_connection_stats.rx_total_, add(_))
+      .WillByDefault(Invoke([&](uint64_t amount) -> void { bytes_read += amount; }));
+  server_connection_->setConnectionStats(server_connection_stats.toBufferStats());
+
+  // Reads are disabled once the first data is read, when the next receive is already in flight.
+  EXPECT_CALL(*read_filter_, onData(_, false))
+      .WillOnce(Invoke([&](Buffer::Instance& buffer, bool) -> FilterStatus {
+        EXPECT_EQ("hello", buffer.toString());
+        buffer.drain(buffer.length());
+        server_connection_->readDisable(true);
+        dispatcher_->exit();
+        return FilterStatus::StopIteration;
+      }));
+  Buffer::OwnedImpl first("hello");
+  client_connection_->write(first, false);
+  dispatcher_->run(Event::Dispatcher::RunType::Block);
+  EXPECT_EQ(5, bytes_read);
+
+  // Give the receive time to complete. What it got is held rather than read into the connection.
+  Buffer::OwnedImpl second("world");
+  client_connection_->write(second, false);
+  for (int i = 0; i < 50; i++) {
+    dispatcher_->run(Event::Dispatcher::RunType::NonBlock);
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  EXPECT_EQ(5, bytes_read);
+
+  EXPECT_CALL(*read_filter_, onData(_, false))
+      .WillOnce(Invoke([&](Buffer::Instance& buffer, bool) -> FilterStatus {
+        EXPECT_EQ("world", buffer.toString());
+        buffer.drain(buffer.length());
+        dispatcher_->exit();
+        return FilterStatus::StopIteration;
+      }));
+  server_connection_->readDisable(false);
+  dispatcher_->run(Event::Dispatcher::RunType::Block);
+  EXPECT_EQ(10, bytes_read);
+
+  disconnect(true);
+}
+
+// Test that when the dispatcher writes sockets through io_uring, what the peer has not read stays
+// in the write buffer, and closing without flushing cancels the send rather than leaving it in
+// flight.
+TEST_P(ConnectionImplTest, IoUringCloseCancelsSend) {
+  if (!Event::DispatcherImpl::useIoUring(true)) {
+    return;
+  }
+  dispatcher_ = std::make_unique<Event::DispatcherImpl>(time_system_);
+  Event::DispatcherImpl::useIoUring(false);
+  Event::IoUringImpl* ring = dynamic_cast<Event::IoUringImpl*>(dispatcher_->ioUring());
+  ASSERT_NE(nullptr, ring);
+
+  setUpBasicConnection();
+  connect();
+  NiceMockConnectionStats client_connection_stats;
+  uint64_t bytes_written = 0;
+  ON_CALL(client_connection_stats.tx_total_, add(_))
+      .WillByDefault(Invoke([&](uint64_t amount) -> void { bytes_written += amount; }));
+  client_connection_->setConnectionStats(client_connection_stats.toBufferStats());
+
+  // The server does not read, so the send cannot complete once the socket buffers are full.
+  server_connection_->readDisable(true);
+  const uint64_t size = 64 * 1024 * 1024;
+  Buffer::OwnedImpl data(std::string(size, 'a'));
+  client_connection_->write(data, false);
+  for (int i = 0; i < 50; i++) {
+    dispatcher_->run(Event::Dispatcher::RunType::NonBlock);
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  EXPECT_LT(bytes_written, size);
+
+  EXPECT_CALL(client_callbacks_, onEvent(ConnectionEvent::LocalClose));
+  client_connection_->close(ConnectionCloseType::NoFlush);
+  for (int i = 0; i < 50 && ring->pendingRequests() > 0; i++) {
+    dispatcher_->run(Event::Dispatcher::RunType::NonBlock);
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  EXPECT_EQ(0, ring->pendingRequests());
+
+  EXPECT_CALL(server_callbacks_, onEvent(ConnectionEvent::LocalClose));
+  server_connection_->close(ConnectionCloseType::NoFlush);
+  dispatcher_->run(Event::Dispatcher::RunType::NonBlock);
+}
+
 // Test that a FlushWrite close immediately triggers a close after the write buffer is flushed.
 TEST_P(ConnectionImplTest, FlushWriteCloseTest) {
   setUpBasicConnection();
@@ -1494,7 +1829,7 @@ public:
   void readBufferLimitTest(uint32_t read_buffer_limit, uint32_t expected_chunk_size) {
     const uint32_t buffer_size = 256 * 1024;
     dispatcher_ = std::make_unique<Event::DispatcherImpl>(time_system_);
-    listener_ = dispatcher_->createListener(socket_, listener_callbacks_, true, false);
+    listener_ = dispatcher_->createListener(socket_, listener_callbacks_, true, false, 0);
 
     client_connection_ = dispatcher_->createClientConnection(
         socket_.localAddress(), Network::Address::InstanceConstSharedPtr(),
@@ -2,11 +2,13 @@
 #include "common/network/listener_impl.h"
 #include "common/network/utility.h"
 
+#include "test/mocks/api/mocks.h"
 #include "test/mocks/network/mocks.h"
 #include "test/mocks/server/mocks.h"
 #include "test/test_common/environment.h"
 #include "test/test_common/network_utility.h"
 #include "test/test_common/test_time.h"
+#include "test/test_common/threadsafe_singleton_injector.h"
 #include "test/test_common/utility.h"
 
 #include "gmock/gmock.h"
@@ -14,6 +16,7 @@
 
 using testing::_;
 using testing::Invoke;
+using testing::NiceMock;
 using testing::Return;
 
 namespace Envoy {
@@ -31,7 +34,7 @@ static void errorCallbackTest(Address::IpVersion version) {
   Network::MockListenerCallbacks listener_callbacks;
   Network::MockConnectionHandler connection_handler;
   Network::ListenerPtr listener =
-      dispatcher.createListener(socket, listener_callbacks, true, false);
+      dispatcher.createListener(socket, listener_callbacks, true, false, 0);
 
   Network::ClientConnectionPtr client_connection = dispatcher.createClientConnection(
       socket.localAddress(), Network::Address::InstanceConstSharedPtr(),
@@ -66,9 +69,10 @@ TEST_P(ListenerImplDeathTest, ErrorCallback) {
 class TestListenerImpl : public ListenerImpl {
 public:
   TestListenerImpl(Event::DispatcherImpl& dispatcher, Socket& socket, ListenerCallbacks& cb,
-                   bool bind_to_port, bool hand_off_restored_destination_connections)
+                   bool bind_to_port, bool hand_off_restored_destination_connections,
+                   uint32_t max_accepts_per_wakeup = 0)
       : ListenerImpl(dispatcher, socket, cb, bind_to_port,
-                     hand_off_restored_destination_connections) {}
+                     hand_off_restored_destination_connections, max_accepts_per_wakeup) {}
 
   MOCK_METHOD1(getLocalAddress, Address::InstanceConstSharedPtr(int fd));
 };
@@ -283,5 +287,87 @@ TEST_P(ListenerImplTest, DisableAndEnableListener) {
   dispatcher_.run(Event::Dispatcher::RunType::Block);
 }
 
+// Test that no more than max_accepts_per_wakeup connections are accepted on each iteration of the
+// event loop, and that the remaining connections are accepted on later iterations.
+TEST_P(ListenerImplTest, BatchAccept) {
+  TcpListenSocket socket(Network::Test::getCanonicalLoopbackAddress(version_), nullptr, true);
+  MockListenerCallbacks listener_callbacks;
+  TestListenerImpl listener(dispatcher_, socket, listener_callbacks, true, false, 2);
+
+  std::vector<ClientConnectionPtr> client_connections;
+  for (int i = 0; i < 3; i++) {
+    client_connections.push_back(dispatcher_.createClientConnection(
+        socket.localAddress(), Address::InstanceConstSharedPtr(),
+        Network::Test::createRawBufferSocket(), nullptr));
+    client_connections.back()->connect();
+  }
+
+  uint32_t accepted = 0;
+  EXPECT_CALL(listener, getLocalAddress(_)).Times(0);
+  EXPECT_CALL(listener_callbacks, onAccept_(_, _))
+      .Times(3)
+      .WillRepeatedly(Invoke([&](ConnectionSocketPtr& accepted_socket, bool) -> void {
+        EXPECT_EQ(*accepted_socket->localAddress(), *socket.localAddress());
+        accepted++;
+      }));
+
+  while (accepted < 3) {
+    const uint32_t accepted_before = accepted;
+    dispatcher_.run(Event::Dispatcher::RunType::NonBlock);
+    EXPECT_LE(accepted - accepted_before, 2);
+  }
+
+  for (auto& client_connection : client_connections) {
+    client_connection->close(ConnectionCloseType::NoFlush);
+  }
+}
+
+// Test that an exception is thrown if a listener which accepts in batches can't listen.
+TEST_P(ListenerImplTest, BatchAcceptListenError) {
+  TcpListenSocket socket(Network::Test::getCanonicalLoopbackAddress(version_), nullptr, true);
+  MockListenerCallbacks listener_callbacks;
+  NiceMock<Api::MockOsSysCalls> os_sys_calls;
+  TestThreadsafeSingletonInjector<Api::OsSysCallsImpl> os_calls(&os_sys_calls);
+  EXPECT_CALL(os_sys_calls, listen(socket.fd(), _))
+      .WillOnce(Return(Api::SysCallIntResult{-1, EADDRINUSE}));
+  EXPECT_THROW_WITH_MESSAGE(
+      TestListenerImpl(dispatcher_, socket, listener_callbacks, true, false, 2),
+      CreateListenerException,
+      fmt::format("cannot listen on socket: {}: {}", socket.localAddress()->asString(),
+                  strerror(EADDRINUSE)));
+}
+
+// Test that disabling the listener while accepting in batches stops further accepts.
+TEST_P(ListenerImplTest, BatchAcceptDisable) {
+  TcpListenSocket socket(Network::Test::getCanonicalLoopbackAddress(version_), nullptr, true);
+  MockListenerCallbacks listener_callbacks;
+  TestListenerImpl listener(dispatcher_, socket, listener_callbacks, true, false, 16);
+
+  std::vector<ClientConnectionPtr> client_connections;
+  for (int i = 0; i < 2; i++) {
+    client_connections.push_back(dispatcher_.createClientConnection(
+        socket.localAddress(), Address::InstanceConstSharedPtr(),
+        Network::Test::createRawBufferSocket(), nullptr));
+    client_connections.back()->connect();
+  }
+
+  // The first accepted connection disables the listener, so the second one is left pending until
+  // it is enabled again.
+  EXPECT_CALL(listener_callbacks, onAccept_(_, _))
+      .WillOnce(Invoke([&](ConnectionSocketPtr&, bool) -> void { listener.disable(); }));
+  Event::TimerPtr timer = dispatcher_.createTimer([&] { dispatcher_.exit(); });
+  timer->enableTimer(std::chrono::milliseconds(500));
+  dispatcher_.run(Event::Dispatcher::RunType::Block);
+
+  listener.enable();
+  EXPECT_CALL(listener_callbacks, onAccept_(_, _))
+      .WillOnce(Invoke([&](ConnectionSocketPtr&, bool) -> void { dispatcher_.exit(); }));
+  dispatcher_.run(Event::Dispatcher::RunType::Block);
+
+  for (auto& client_connection : client_connections) {
+    client_connection->close(ConnectionCloseType::NoFlush);
+  }
+}
+
 } // namespace Network
 } // namespace Envoy
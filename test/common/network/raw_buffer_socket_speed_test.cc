@@ -0,0 +1,165 @@
+// Note: this should be run with --compilation_mode=opt, and would benefit from a
+// quiescent system with disabled cstate power management.
+//
+// Measures request/response round trips between a client and a server connection over loopback,
+// on a dispatcher which reads and writes the sockets either when libevent reports them ready, or
+// through io_uring. The server answers each request once all of it has arrived, with a response of
+// the given size. The io_uring benchmarks are skipped where the kernel does not have it.
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+
+#include "common/buffer/buffer_impl.h"
+#include "common/common/assert.h"
+#include "common/event/dispatcher_impl.h"
+#include "common/event/real_time_system.h"
+#include "common/network/filter_impl.h"
+#include "common/network/listen_socket_impl.h"
+#include "common/network/raw_buffer_socket.h"
+#include "common/network/utility.h"
+
+#include "testing/base/public/benchmark.h"
+
+namespace Envoy {
+namespace Network {
+namespace {
+
+// Waits for the given number of bytes, and calls on_complete once they have all arrived.
+class CountingFilter : public ReadFilterBaseImpl {
+public:
+  CountingFilter(std::function<void()> on_complete) : on_complete_(on_complete) {}
+
+  void expect(uint64_t bytes) { remaining_ = bytes; }
+
+  // Network::ReadFilter
+  FilterStatus onData(Buffer::Instance& data, bool) override {
+    RELEASE_ASSERT(data.length() <= remaining_, "");
+    remaining_ -= data.length();
+    data.drain(data.length());
+    if (remaining_ == 0) {
+      on_complete_();
+    }
+    return FilterStatus::StopIteration;
+  }
+
+private:
+  const std::function<void()> on_complete_;
+  uint64_t remaining_{};
+};
+
+class ConnectedCallbacks : public ConnectionCallbacks {
+public:
+  ConnectedCallbacks(std::function<void()> on_connected) : on_connected_(on_connected) {}
+
+  // Network::ConnectionCallbacks
+  void onEvent(ConnectionEvent event) override {
+    if (event == ConnectionEvent::Connected) {
+      on_connected_();
+    }
+  }
+  void onAboveWriteBufferHighWatermark() override {}
+  void onBelowWriteBufferLowWatermark() override {}
+
+private:
+  const std::function<void()> on_connected_;
+};
+
+class Server : public ListenerCallbacks {
+public:
+  Server(Event::Dispatcher& dispatcher, std::function<void()> on_connected)
+      : dispatcher_(dispatcher), on_connected_(on_connected) {}
+
+  // Network::ListenerCallbacks
+  void onAccept(ConnectionSocketPtr&& socket, bool) override {
+    onNewConnection(
+        dispatcher_.createServerConnection(std::move(socket), std::make_unique<RawBufferSocket>()));
+  }
+  void onNewConnection(ConnectionPtr&& new_connection) override {
+    connection_ = std::move(new_connection);
+    on_connected_();
+  }
+
+  Event::Dispatcher& dispatcher_;
+  const std::function<void()> on_connected_;
+  ConnectionPtr connection_;
+};
+
+void BM_RequestResponse(benchmark::State& state, bool use_io_uring) {
+  if (use_io_uring && !Event::DispatcherImpl::useIoUring(true)) {
+    state.SkipWithError("io_uring is not supported");
+    return;
+  }
+  Event::RealTimeSystem time_system;
+  Event::DispatcherImpl dispatcher(time_system);
+  Event::DispatcherImpl::useIoUring(false);
+
+  const uint64_t request_size = state.range(0);
+  const uint64_t response_size = state.range(1);
+  const std::string request(request_size, 'q');
+  const std::string response(response_size, 'r');
+
+  uint32_t connected = 0;
+  auto on_connected = [&]() {
+    if (++connected == 2) {
+      dispatcher.exit();
+    }
+  };
+  TcpListenSocket socket(Utility::parseInternetAddress("127.0.0.1", 0), nullptr, true);
+  Server server(dispatcher, on_connected);
+  ListenerPtr listener = dispatcher.createListener(socket, server, true, false, 1);
+  ClientConnectionPtr client = dispatcher.createClientConnection(
+      socket.localAddress(), nullptr, std::make_unique<RawBufferSocket>(), nullptr);
+  ConnectedCallbacks client_callbacks(on_connected);
+  client->addConnectionCallbacks(client_callbacks);
+  client->connect();
+  dispatcher.run(Event::Dispatcher::RunType::Block);
+
+  std::shared_ptr<CountingFilter> server_filter;
+  server_filter = std::make_shared<CountingFilter>([&]() {
+    Buffer::OwnedImpl data(response);
+    server.connection_->write(data, false);
+    server_filter->expect(request_size);
+  });
+  server_filter->expect(request_size);
+  server.connection_->addReadFilter(server_filter);
+  auto client_filter = std::make_shared<CountingFilter>([&]() { dispatcher.exit(); });
+  client->addReadFilter(client_filter);
+
+  for (auto _ : state) {
+    client_filter->expect(response_size);
+    Buffer::OwnedImpl data(request);
+    client->write(data, false);
+    dispatcher.run(Event::Dispatcher::RunType::Block);
+  }
+  state.SetBytesProcessed(state.iterations() * (request_size + response_size));
+
+  client->close(ConnectionCloseType::NoFlush);
+  server.connection_->close(ConnectionCloseType::NoFlush);
+  dispatcher.run(Event::Dispatcher::RunType::NonBlock);
+}
+
+// Echo of small messages, an HTTP/1.1 request with a body-sized response, and bulk transfer.
+BENCHMARK_CAPTURE(BM_RequestResponse, libevent, false)
+    ->Args({64, 64})
+    ->Args({512, 16384})
+    ->Args({262144, 262144});
+BENCHMARK_CAPTURE(BM_RequestResponse, io_uring, true)
+    ->Args({64, 64})
+    ->Args({512, 16384})
+    ->Args({262144, 262144});
+
+} // namespace
+} // namespace Network
+} // namespace Envoy
+
+// Boilerplate main(), which discovers benchmarks in the same file and runs them.
+int main(int argc, char** argv) {
+  benchmark::Initialize(&argc, argv);
+
+  if (benchmark::ReportUnrecognizedArguments(argc, argv)) {
+    return 1;
+  }
+  benchmark::RunSpecifiedBenchmarks();
+}
@@ -7,6 +7,7 @@
 
 #include "envoy/server/filter_config.h"
 
+#include "common/common/regex.h"
 #include "common/config/metadata.h"
 #include "common/config/rds_json.h"
 #include "common/config/well_known_names.h"
@@ -257,7 +258,7 @@ TEST(RouteMatcherTest, TestRoutes) {
         {"pattern": "^/rides$", "method": "POST", "name": "ride_request"},
         {"pattern": "^/rides/\\d+$", "method": "PUT", "name": "update_ride"},
         {"pattern": "^/users/\\d+/chargeaccounts$", "method": "POST", "name": "cc_add"},
-        {"pattern": "^/users/\\d+/chargeaccounts/(?!validate)\\w+$", "method": "PUT",
+        {"pattern": "^/users/\\d+/chargeaccounts/[a-z]+\\d+$", "method": "PUT",
          "name": "cc_add"},
         {"pattern": "^/users$", "method": "POST", "name": "create_user_login"},
         {"pattern": "^/users/\\d+$", "method": "PUT", "name": "update_user"},
@@ -564,6 +565,119 @@ virtual_hosts:
             config.route(genHeaders("example.com", "/", "GET"), 0)->routeEntry()->clusterName());
 }
 
+// Routes are indexed by path at config load time; verify that the first matching route in
+// configuration order still wins when prefix, exact path and regex routes are interleaved.
+TEST(RouteMatcherTest, FirstMatchAcrossRouteTypes) {
+  const std::string yaml = R"EOF(
+virtual_hosts:
+  - name: default
+    domains: ["*"]
+    routes:
+      - match: { prefix: "/foo/bar", headers: [{ name: "x-bar", exact_match: "true" }] }
+        route: { cluster: "foo_bar_header" }
+      - match: { regex: "/foo/b.*" }
+        route: { cluster: "foo_b_regex" }
+      - match: { path: "/foo/bar" }
+        route: { cluster: "foo_bar_path" }
+      - match: { prefix: "/FOO", case_sensitive: false }
+        route: { cluster: "foo_insensitive" }
+      - match: { prefix: "/foo" }
+        route: { cluster: "foo" }
+      - match: { regex: "/b.*" }
+        route: { cluster: "b_regex" }
+      - match: { prefix: "/" }
+        route: { cluster: "default" }
+  )EOF";
+
+  NiceMock<Server::Configuration::MockFactoryContext> factory_context;
+  TestConfigImpl config(parseRouteConfigurationFromV2Yaml(yaml), factory_context, true);
+
+  {
+    Http::TestHeaderMapImpl headers = genHeaders("example.com", "/foo/bar", "GET");
+    headers.addCopy("x-bar", "true");
+    EXPECT_EQ("foo_bar_header", config.route(headers, 0)->routeEntry()->clusterName());
+  }
+  EXPECT_EQ("foo_b_regex", config.route(genHeaders("example.com", "/foo/bar", "GET"), 0)
+                               ->routeEntry()
+                               ->clusterName());
+  EXPECT_EQ("foo_b_regex", config.route(genHeaders("example.com", "/foo/bar?a=b", "GET"), 0)
+                               ->routeEntry()
+                               ->clusterName());
+  EXPECT_EQ("foo_insensitive",
+            config.route(genHeaders("example.com", "/fOo/baz", "GET"), 0)
+                ->routeEntry()
+                ->clusterName());
+  EXPECT_EQ("b_regex",
+            config.route(genHeaders("example.com", "/bar", "GET"), 0)->routeEntry()->clusterName());
+  EXPECT_EQ("default",
+            config.route(genHeaders("example.com", "/fo", "GET"), 0)->routeEntry()->clusterName());
+}
+
+// With enough regex routes they are compiled into a single regex set. Verify that header
+// constraints are still applied and that the first matching route wins.
+TEST(RouteMatcherTest, RegexSet) {
+  const std::string yaml = R"EOF(
+virtual_hosts:
+  - name: default
+    domains: ["*"]
+    routes:
+      - match: { regex: "/a/.*", headers: [{ name: "x-a", exact_match: "true" }] }
+        route: { cluster: "a_header" }
+      - match: { regex: "/b/[0-9]+" }
+        route: { cluster: "b_digits" }
+      - match: { prefix: "/a/prefix" }
+        route: { cluster: "a_prefix" }
+      - match: { regex: "/a/.*" }
+        route: { cluster: "a" }
+      - match: { regex: "/b/.*" }
+        route: { cluster: "b" }
+      - match: { regex: "/c" }
+        route: { cluster: "c" }
+      - match: { regex: "/d" }
+        route: { cluster: "d" }
+      - match: { regex: "/e" }
+        route: { cluster: "e" }
+      - match: { regex: "/f" }
+        route: { cluster: "f" }
+      - match: { regex: "/g" }
+        route: { cluster: "g" }
+      - match:
+          regex: "/[c-g]"
+          runtime_fraction: { runtime_key: "bogus_key", default_value: { numerator: 0 } }
+        route: { cluster: "never" }
+      - match: { regex: "/[c-h]" }
+        route: { cluster: "c_to_h" }
+  )EOF";
+
+  NiceMock<Server::Configuration::MockFactoryContext> factory_context;
+  TestConfigImpl config(parseRouteConfigurationFromV2Yaml(yaml), factory_context, true);
+
+  {
+    Http::TestHeaderMapImpl headers = genHeaders("example.com", "/a/prefix", "GET");
+    headers.addCopy("x-a", "true");
+    EXPECT_EQ("a_header", config.route(headers, 0)->routeEntry()->clusterName());
+  }
+  EXPECT_EQ("a_prefix",
+            config.route(genHeaders("example.com", "/a/prefix", "GET"), 0)
+                ->routeEntry()
+                ->clusterName());
+  EXPECT_EQ("a", config.route(genHeaders("example.com", "/a/foo", "GET"), 0)
+                     ->routeEntry()
+                     ->clusterName());
+  EXPECT_EQ("b_digits", config.route(genHeaders("example.com", "/b/123?x=y", "GET"), 0)
+                            ->routeEntry()
+                            ->clusterName());
+  EXPECT_EQ("b", config.route(genHeaders("example.com", "/b/12a", "GET"), 0)
+                     ->routeEntry()
+                     ->clusterName());
+  EXPECT_EQ("g",
+            config.route(genHeaders("example.com", "/g", "GET"), 0)->routeEntry()->clusterName());
+  EXPECT_EQ("c_to_h",
+            config.route(genHeaders("example.com", "/h", "GET"), 0)->routeEntry()->clusterName());
+  EXPECT_EQ(nullptr, config.route(genHeaders("example.com", "/i", "GET"), 0));
+  EXPECT_EQ(nullptr, config.route(genHeaders("example.com", "/c/", "GET"), 0));
+}
+
 TEST(RouteMatcherTest, TestRoutesWithInvalidRegex) {
   std::string invalid_route = R"EOF(
 virtual_hosts:
@@ -598,6 +712,25 @@ virtual_hosts:
                           EnvoyException, "Invalid regex '\\^/\\(\\+invalid\\)':");
 }
 
+TEST(RouteMatcherTest, TestRoutesWithTooComplexRegex) {
+  const std::string yaml = R"EOF(
+virtual_hosts:
+  - name: regex
+    domains: ["*"]
+    routes:
+      - match: { regex: "/(GET|POST|PUT)/[a-zA-Z0-9_]{1,32}" }
+        route: { cluster: "regex" }
+  )EOF";
+
+  NiceMock<Server::Configuration::MockFactoryContext> factory_context;
+  EXPECT_NO_THROW(TestConfigImpl(parseRouteConfigurationFromV2Yaml(yaml), factory_context, true));
+
+  ScopedMaxRegexProgramSize max_program_size(50);
+  EXPECT_THROW_WITH_REGEX(
+      TestConfigImpl(parseRouteConfigurationFromV2Yaml(yaml), factory_context, true),
+      EnvoyException, "Regex '/\\(GET\\|POST\\|PUT\\)/.*' is too complex");
+}
+
 // Validates behavior of request_headers_to_add at router, vhost, and route action levels.
 TEST(RouteMatcherTest, TestAddRemoveRequestHeaders) {
   const std::string json = R"EOF(
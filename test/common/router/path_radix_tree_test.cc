@@ -0,0 +1,88 @@
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "common/router/path_radix_tree.h"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+using testing::ElementsAre;
+using testing::IsEmpty;
+
+namespace Envoy {
+namespace Router {
+namespace {
+
+std::vector<uint32_t> findCandidates(const PathRadixTree& tree, const std::string& path) {
+  std::vector<uint32_t> ordinals;
+  tree.findCandidates(path, std::min(path.find('?'), path.size()), ordinals);
+  std::sort(ordinals.begin(), ordinals.end());
+  return ordinals;
+}
+
+TEST(PathRadixTreeTest, Empty) {
+  PathRadixTree tree(true);
+  EXPECT_EQ(0, tree.size());
+  EXPECT_THAT(findCandidates(tree, "/foo"), IsEmpty());
+}
+
+TEST(PathRadixTreeTest, Prefixes) {
+  PathRadixTree tree(true);
+  tree.addPrefix("/foo/bar", 0);
+  tree.addPrefix("/foo", 1);
+  tree.addPrefix("/fob", 2);
+  tree.addPrefix("/", 3);
+  tree.addPrefix("", 4);
+  tree.addPrefix("/foo", 5);
+  EXPECT_EQ(6, tree.size());
+
+  EXPECT_THAT(findCandidates(tree, "/foo/bar/baz"), ElementsAre(0, 1, 3, 4, 5));
+  EXPECT_THAT(findCandidates(tree, "/foo/ba"), ElementsAre(1, 3, 4, 5));
+  EXPECT_THAT(findCandidates(tree, "/fob"), ElementsAre(2, 3, 4));
+  EXPECT_THAT(findCandidates(tree, "/fo"), ElementsAre(3, 4));
+  EXPECT_THAT(findCandidates(tree, "/FOO"), ElementsAre(3, 4));
+  EXPECT_THAT(findCandidates(tree, ""), ElementsAre(4));
+  // Prefixes are matched against the full path, including the query string.
+  EXPECT_THAT(findCandidates(tree, "/fo?o/bar"), ElementsAre(3, 4));
+}
+
+TEST(PathRadixTreeTest, Paths) {
+  PathRadixTree tree(true);
+  tree.addPath("/foo", 0);
+  tree.addPath("/foo/bar", 1);
+  tree.addPath("/", 2);
+
+  EXPECT_THAT(findCandidates(tree, "/foo"), ElementsAre(0));
+  EXPECT_THAT(findCandidates(tree, "/foo?bar=baz"), ElementsAre(0));
+  EXPECT_THAT(findCandidates(tree, "/foo/bar"), ElementsAre(1));
+  EXPECT_THAT(findCandidates(tree, "/foo/"), IsEmpty());
+  EXPECT_THAT(findCandidates(tree, "/fo"), IsEmpty());
+  EXPECT_THAT(findCandidates(tree, "/?foo"), ElementsAre(2));
+}
+
+TEST(PathRadixTreeTest, PrefixesAndPaths) {
+  PathRadixTree tree(true);
+  tree.addPath("/foo", 0);
+  tree.addPrefix("/foo", 1);
+  tree.addPrefix("/f", 2);
+  tree.addPath("/foobar", 3);
+
+  EXPECT_THAT(findCandidates(tree, "/foo"), ElementsAre(0, 1, 2));
+  EXPECT_THAT(findCandidates(tree, "/foobar"), ElementsAre(1, 2, 3));
+  EXPECT_THAT(findCandidates(tree, "/foob"), ElementsAre(1, 2));
+}
+
+TEST(PathRadixTreeTest, CaseInsensitive) {
+  PathRadixTree tree(false);
+  tree.addPrefix("/Foo", 0);
+  tree.addPath("/FOO/bar", 1);
+
+  EXPECT_THAT(findCandidates(tree, "/foo"), ElementsAre(0));
+  EXPECT_THAT(findCandidates(tree, "/fOO/BAR"), ElementsAre(0, 1));
+  EXPECT_THAT(findCandidates(tree, "/fo"), IsEmpty());
+}
+
+} // namespace
+} // namespace Router
+} // namespace Envoy
@@ -0,0 +1,102 @@
+// Usage: bazel run //test/common/router:route_matcher_benchmark
+
+#include <memory>
+#include <vector>
+
+#include "common/common/fmt.h"
+#include "common/router/config_impl.h"
+
+#include "test/mocks/server/mocks.h"
+#include "test/test_common/utility.h"
+
+#include "testing/base/public/benchmark.h"
+
+using testing::NiceMock;
+
+namespace Envoy {
+namespace Router {
+namespace {
+
+// Builds a single virtual host with num_routes routes. Every third route is an exact path route
+// and the remainder are prefix routes. When regex_percent is non-zero, that percentage of the
+// routes are regex routes instead, which can't be indexed and are evaluated for every request.
+envoy::api::v2::RouteConfiguration makeRouteConfig(uint64_t num_routes, uint64_t regex_percent) {
+  envoy::api::v2::RouteConfiguration route_config;
+  auto* virtual_host = route_config.add_virtual_hosts();
+  virtual_host->set_name("default");
+  virtual_host->add_domains("*");
+  for (uint64_t i = 0; i < num_routes; i++) {
+    auto* route = virtual_host->add_routes();
+    if (i < num_routes * (regex_percent / 100.0)) {
+      route->mutable_match()->set_regex(fmt::format("/regex_{}/[a-z]+", i));
+    } else if (i % 3 == 0) {
+      route->mutable_match()->set_path(fmt::format("/service_{}/method", i));
+    } else {
+      route->mutable_match()->set_prefix(fmt::format("/service_{}/", i));
+    }
+    route->mutable_route()->set_cluster(fmt::format("cluster_{}", i));
+  }
+  return route_config;
+}
+
+void BM_RouteMatcherLookup(benchmark::State& state) {
+  const uint64_t num_routes = state.range(0);
+  const uint64_t regex_percent = state.range(1);
+  NiceMock<Server::Configuration::MockFactoryContext> factory_context;
+  ConfigImpl config(makeRouteConfig(num_routes, regex_percent), factory_context, false);
+
+  // Spread lookups across the whole route table, including the last route, so that the cost of a
+  // linear scan would show up in the results.
+  std::vector<Http::TestHeaderMapImpl> requests;
+  for (uint64_t i = num_routes - 1; requests.size() < 100; i = (i + 7919) % num_routes) {
+    requests.push_back(Http::TestHeaderMapImpl{
+        {":authority", "www.example.com"},
+        {":path", fmt::format("/service_{}/{}", i, i % 3 == 0 ? "method" : "method?a=b")},
+        {":method", "GET"}});
+  }
+
+  uint64_t found = 0;
+  for (auto _ : state) {
+    for (const auto& request : requests) {
+      found += config.route(request, 0) != nullptr;
+    }
+  }
+  benchmark::DoNotOptimize(found);
+  state.SetItemsProcessed(state.iterations() * requests.size());
+}
+BENCHMARK(BM_RouteMatcherLookup)
+    ->Args({10, 0})
+    ->Args({100, 0})
+    ->Args({1000, 0})
+    ->Args({4000, 0})
+    ->Args({4000, 1})
+    ->Args({4000, 10});
+
+void BM_RouteMatcherBuild(benchmark::State& state) {
+  const uint64_t num_routes = state.range(0);
+  NiceMock<Server::Configuration::MockFactoryContext> factory_context;
+  const envoy::api::v2::RouteConfiguration route_config = makeRouteConfig(num_routes, 0);
+
+  for (auto _ : state) {
+    ConfigImpl config(route_config, factory_context, false);
+    benchmark::DoNotOptimize(config);
+  }
+}
+BENCHMARK(BM_RouteMatcherBuild)->Arg(100)->Arg(1000)->Arg(4000)->Unit(benchmark::kMillisecond);
+
+} // namespace
+} // namespace Router
+} // namespace Envoy
+
+// Boilerplate main(), which discovers benchmarks in the same file and runs them.
+int main(int argc, char** argv) {
+  Envoy::Thread::MutexBasicLockable lock;
+  Envoy::Logger::Context logging_context(spdlog::level::warn,
+                                         Envoy::Logger::Logger::DEFAULT_LOG_FORMAT, lock);
+
+  benchmark::Initialize(&argc, argv);
+  if (benchmark::ReportUnrecognizedArguments(argc, argv)) {
+    return 1;
+  }
+  benchmark::RunSpecifiedBenchmarks();
+}
@@ -17,7 +17,7 @@ TEST(HeapStatDataTest, HeapNoTruncate) {
   const std::string long_string(stats_options.maxNameLength() + 1, 'A');
   HeapStatData* stat{};
   EXPECT_NO_LOGS(stat = alloc.alloc(long_string));
-  EXPECT_EQ(stat->key(), long_string);
+  EXPECT_EQ(stat->statName().toString(alloc.symbolTable()), long_string);
   alloc.free(*stat);
 }
 
@@ -38,5 +38,28 @@ TEST(HeapStatDataTest, HeapAlloc) {
   alloc.free(*stat_3);
 }
 
+// Names are symbolized in the allocator's table, so tokens shared by several stats are held once,
+// and are released when the last stat using them is freed.
+TEST(HeapStatDataTest, HeapSharedSymbols) {
+  SymbolTable symbol_table;
+  HeapStatDataAllocator alloc(symbol_table);
+  HeapStatData* stat_1 = alloc.alloc("cluster.foo.upstream_rq");
+  HeapStatData* stat_2 = alloc.alloc("cluster.foo.upstream_cx");
+  EXPECT_EQ(4, symbol_table.numSymbols());
+  EXPECT_EQ("cluster.foo.upstream_rq", stat_1->statName().toString(symbol_table));
+  EXPECT_EQ("cluster.foo.upstream_cx", stat_2->statName().toString(symbol_table));
+
+  // Allocating an existing name takes a reference without holding the symbols again.
+  HeapStatData* stat_3 = alloc.alloc("cluster.foo.upstream_rq");
+  EXPECT_EQ(stat_1, stat_3);
+  alloc.free(*stat_3);
+  EXPECT_EQ(4, symbol_table.numSymbols());
+
+  alloc.free(*stat_1);
+  EXPECT_EQ(3, symbol_table.numSymbols());
+  alloc.free(*stat_2);
+  EXPECT_EQ(0, symbol_table.numSymbols());
+}
+
 } // namespace Stats
 } // namespace Envoy
@@ -0,0 +1,156 @@
+// Note: this should be run with --compilation_mode=opt, and would benefit from a
+// quiescent system with disabled cstate power management.
+//
+// Compares the thread local histograms used by ThreadLocalStoreImpl with ShardedHistogram, both
+// for the cost of recording a value on a worker, and for the cost of merging 64 workers' values on
+// the main thread.
+
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "common/stats/heap_stat_data.h"
+#include "common/stats/sharded_histogram.h"
+#include "common/stats/thread_local_store.h"
+
+#include "testing/base/public/benchmark.h"
+
+namespace Envoy {
+namespace {
+
+constexpr uint32_t NumWorkers = 64;
+
+// Values spread over a few orders of magnitude, like request latencies in microseconds.
+uint64_t sampleValue(uint64_t i) { return (i * 2654435761) % 100000; }
+
+// Holds the histograms of NumWorkers simulated workers. The merge benchmarks run on a single
+// thread, so the thread local histograms are created by it.
+class ThreadLocalHistograms {
+public:
+  ThreadLocalHistograms() : name_("histogram", alloc_.symbolTable()) {
+    for (uint32_t i = 0; i < NumWorkers; i++) {
+      histograms_.push_back(std::make_unique<Stats::ThreadLocalHistogramImpl>(
+          name_.statName(), alloc_.symbolTable(), "", std::vector<Stats::Tag>()));
+    }
+  }
+
+  ~ThreadLocalHistograms() {
+    histograms_.clear();
+    name_.free(alloc_.symbolTable());
+  }
+
+  Stats::ThreadLocalHistogramImpl& histogram(uint32_t worker) { return *histograms_[worker]; }
+
+private:
+  Stats::HeapStatDataAllocator alloc_;
+  Stats::StatNameStorage name_;
+  std::vector<std::unique_ptr<Stats::ThreadLocalHistogramImpl>> histograms_;
+};
+
+} // namespace
+} // namespace Envoy
+
+// The cost of recording into a worker's own circllhist histogram, which is what each worker does
+// today once the histogram has been looked up in its thread local cache.
+static void BM_ThreadLocalRecord(benchmark::State& state) {
+  Envoy::Stats::HeapStatDataAllocator alloc;
+  Envoy::Stats::StatNameStorage name("histogram", alloc.symbolTable());
+  {
+    Envoy::Stats::ThreadLocalHistogramImpl histogram(name.statName(), alloc.symbolTable(), "",
+                                                     std::vector<Envoy::Stats::Tag>());
+    uint64_t i = 0;
+    for (auto _ : state) {
+      histogram.recordValue(Envoy::sampleValue(i++));
+    }
+  }
+  name.free(alloc.symbolTable());
+}
+BENCHMARK(BM_ThreadLocalRecord)->Threads(1)->Threads(Envoy::NumWorkers);
+
+// The cost of recording into a histogram shared by all workers.
+static void BM_ShardedRecord(benchmark::State& state) {
+  static Envoy::Stats::ShardedHistogram* histogram = nullptr;
+  if (state.thread_index == 0) {
+    histogram = new Envoy::Stats::ShardedHistogram();
+  }
+  uint64_t i = 0;
+  for (auto _ : state) {
+    histogram->recordValue(Envoy::sampleValue(i++));
+  }
+  if (state.thread_index == 0) {
+    delete histogram;
+    histogram = nullptr;
+  }
+}
+BENCHMARK(BM_ShardedRecord)->Threads(1)->Threads(Envoy::NumWorkers);
+
+// The cost of merging NumWorkers thread local histograms into an interval histogram, and that into
+// the cumulative one, as ParentHistogramImpl::merge() does.
+static void BM_ThreadLocalMerge(benchmark::State& state) {
+  Envoy::ThreadLocalHistograms histograms;
+  histogram_t* interval = hist_alloc();
+  histogram_t* cumulative = hist_alloc();
+  for (auto _ : state) {
+    state.PauseTiming();
+    for (uint32_t worker = 0; worker < Envoy::NumWorkers; worker++) {
+      for (uint64_t i = 0; i < static_cast<uint64_t>(state.range(0)); i++) {
+        histograms.histogram(worker).recordValue(Envoy::sampleValue(worker * 1000 + i));
+      }
+    }
+    state.ResumeTiming();
+
+    hist_clear(interval);
+    for (uint32_t worker = 0; worker < Envoy::NumWorkers; worker++) {
+      histograms.histogram(worker).beginMerge();
+      histograms.histogram(worker).merge(interval);
+    }
+    hist_accumulate(cumulative, &interval, 1);
+  }
+  hist_free(interval);
+  hist_free(cumulative);
+}
+BENCHMARK(BM_ThreadLocalMerge)->Arg(10)->Arg(1000);
+
+// The cost of summing NumWorkers shards and converting the interval's buckets, as
+// ShardedParentHistogramImpl::merge() does.
+static void BM_ShardedMerge(benchmark::State& state) {
+  Envoy::Stats::ShardedHistogram histogram;
+  histogram_t* interval_histogram = hist_alloc();
+  histogram_t* cumulative = hist_alloc();
+  Envoy::Stats::ShardedHistogram::Buckets interval;
+
+  // Populate every shard by recording from NumWorkers threads.
+  std::vector<std::thread> threads;
+  for (uint32_t worker = 0; worker < Envoy::NumWorkers; worker++) {
+    threads.emplace_back([&histogram]() { histogram.recordValue(0); });
+  }
+  for (std::thread& thread : threads) {
+    thread.join();
+  }
+
+  for (auto _ : state) {
+    state.PauseTiming();
+    for (uint64_t i = 0; i < static_cast<uint64_t>(state.range(0)) * Envoy::NumWorkers; i++) {
+      histogram.recordValue(Envoy::sampleValue(i));
+    }
+    state.ResumeTiming();
+
+    histogram.merge(interval);
+    hist_clear(interval_histogram);
+    Envoy::Stats::ShardedHistogram::insertInto(interval_histogram, interval);
+    hist_accumulate(cumulative, &interval_histogram, 1);
+  }
+  hist_free(interval_histogram);
+  hist_free(cumulative);
+}
+BENCHMARK(BM_ShardedMerge)->Arg(10)->Arg(1000);
+
+// Boilerplate main(), which discovers benchmarks in the same file and runs them.
+int main(int argc, char** argv) {
+  benchmark::Initialize(&argc, argv);
+
+  if (benchmark::ReportUnrecognizedArguments(argc, argv)) {
+    return 1;
+  }
+  benchmark::RunSpecifiedBenchmarks();
+}
@@ -0,0 +1,111 @@
+#include <algorithm>
+#include <vector>
+
+#include "common/common/thread.h"
+#include "common/stats/sharded_histogram.h"
+
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Stats {
+namespace {
+
+TEST(ShardedHistogramTest, BucketBounds) {
+  // Small values each have their own bucket.
+  for (uint64_t value = 0; value < ShardedHistogram::SubBuckets; value++) {
+    EXPECT_EQ(value, ShardedHistogram::bucketIndex(value));
+    EXPECT_EQ(value, ShardedHistogram::bucketLowerBound(value));
+    EXPECT_EQ(1, ShardedHistogram::bucketWidth(value));
+  }
+
+  // Every bucket follows on from the previous one.
+  for (uint32_t index = 1; index < ShardedHistogram::NumBuckets; index++) {
+    EXPECT_EQ(ShardedHistogram::bucketLowerBound(index - 1) +
+                  ShardedHistogram::bucketWidth(index - 1),
+              ShardedHistogram::bucketLowerBound(index));
+  }
+
+  // Values map to the bucket containing them.
+  for (uint64_t value : {8, 9, 15, 16, 17, 100, 1000, 123456, 999999999}) {
+    const uint32_t index = ShardedHistogram::bucketIndex(value);
+    EXPECT_LE(ShardedHistogram::bucketLowerBound(index), value);
+    EXPECT_GT(ShardedHistogram::bucketLowerBound(index) + ShardedHistogram::bucketWidth(index),
+              value);
+    // Buckets are at most 1/8 of their lower bound wide.
+    EXPECT_LE(ShardedHistogram::bucketWidth(index) * 8, std::max<uint64_t>(value, 8));
+  }
+
+  // Very large values go in the last bucket.
+  EXPECT_EQ(ShardedHistogram::NumBuckets - 1, ShardedHistogram::bucketIndex(uint64_t(1) << 36));
+  EXPECT_EQ(ShardedHistogram::NumBuckets - 1, ShardedHistogram::bucketIndex(UINT64_MAX));
+}
+
+TEST(ShardedHistogramTest, MergeReturnsInterval) {
+  ShardedHistogram histogram;
+  ShardedHistogram::Buckets interval;
+  EXPECT_EQ(0, histogram.merge(interval));
+
+  histogram.recordValue(1);
+  histogram.recordValue(1);
+  histogram.recordValue(100);
+  EXPECT_EQ(3, histogram.merge(interval));
+  EXPECT_EQ(2, interval[ShardedHistogram::bucketIndex(1)]);
+  EXPECT_EQ(1, interval[ShardedHistogram::bucketIndex(100)]);
+
+  // Only values recorded since the previous merge are returned.
+  histogram.recordValue(100);
+  EXPECT_EQ(1, histogram.merge(interval));
+  EXPECT_EQ(0, interval[ShardedHistogram::bucketIndex(1)]);
+  EXPECT_EQ(1, interval[ShardedHistogram::bucketIndex(100)]);
+
+  EXPECT_EQ(0, histogram.merge(interval));
+}
+
+TEST(ShardedHistogramTest, RecordFromManyThreads) {
+  // More threads than shards, so that some threads share a shard.
+  const uint32_t num_threads = ShardedHistogram::MaxShards + 8;
+  const uint64_t values_per_thread = 1000;
+  ShardedHistogram histogram;
+
+  std::vector<Thread::ThreadPtr> threads;
+  for (uint32_t i = 0; i < num_threads; i++) {
+    threads.emplace_back(std::make_unique<Thread::Thread>([&histogram, i]() {
+      for (uint64_t value = 0; value < values_per_thread; value++) {
+        histogram.recordValue(value * i);
+      }
+    }));
+  }
+  for (Thread::ThreadPtr& thread : threads) {
+    thread->join();
+  }
+
+  ShardedHistogram::Buckets interval;
+  EXPECT_EQ(num_threads * values_per_thread, histogram.merge(interval));
+  // Every thread recorded 0 once, and thread 0 recorded only 0.
+  EXPECT_EQ(num_threads + values_per_thread - 1, interval[0]);
+}
+
+TEST(ShardedHistogramTest, AddBuckets) {
+  ShardedHistogram::Buckets target{};
+  ShardedHistogram::Buckets source{};
+  target[0] = 1;
+  source[0] = 2;
+  source[ShardedHistogram::NumBuckets - 1] = 3;
+  ShardedHistogram::addBuckets(target, source);
+  EXPECT_EQ(3, target[0]);
+  EXPECT_EQ(3, target[ShardedHistogram::NumBuckets - 1]);
+}
+
+TEST(ShardedHistogramTest, InsertInto) {
+  ShardedHistogram::Buckets buckets{};
+  buckets[ShardedHistogram::bucketIndex(3)] = 2;
+  buckets[ShardedHistogram::bucketIndex(1000)] = 5;
+  histogram_t* target = hist_alloc();
+  ShardedHistogram::insertInto(target, buckets);
+  EXPECT_EQ(7, hist_sample_count(target));
+  hist_free(target);
+}
+
+} // namespace
+} // namespace Stats
+} // namespace Envoy
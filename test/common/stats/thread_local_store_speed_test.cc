@@ -1,9 +1,21 @@
 // Note: this should be run with --compilation_mode=opt, and would benefit from a
 // quiescent system with disabled cstate power management.
+//
+// Each benchmark also reports the bytes allocated per stat, including the caches of the store, as
+// the bytes_per_stat counter. This requires tcmalloc, and is reported as 0 otherwise.
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <thread>
+#include <vector>
 
 #include "common/common/logger.h"
+#include "common/common/mutex_tracer_impl.h"
 #include "common/common/thread.h"
 #include "common/event/dispatcher_impl.h"
+#include "common/event/real_time_system.h"
+#include "common/memory/stats.h"
 #include "common/stats/heap_stat_data.h"
 #include "common/stats/stats_options_impl.h"
 #include "common/stats/tag_producer_impl.h"
@@ -28,6 +40,10 @@ public:
     if (tls_) {
       tls_->shutdownGlobalThreading();
     }
+    for (auto& worker : workers_) {
+      worker->dispatcher_->exit();
+      worker->thread_->join();
+    }
   }
 
   void accessCounters() {
@@ -35,13 +51,77 @@ public:
         1000, [this](absl::string_view name) { store_.counter(std::string(name)); });
   }
 
-  void initThreading() {
+  /**
+   * Creates the sample stats, so that benchmark iterations only look them up.
+   * @return uint64_t the number of bytes allocated per stat created, or 0 if memory usage can't be
+   *         measured on this platform.
+   */
+  uint64_t createCounters() {
+    const uint64_t start_mem = Memory::Stats::totalCurrentlyAllocated();
+    accessCounters();
+    const uint64_t end_mem = Memory::Stats::totalCurrentlyAllocated();
+    const uint64_t num_stats = store_.counters().size();
+    if (start_mem == 0 || end_mem < start_mem || num_stats == 0) {
+      return 0;
+    }
+    return (end_mem - start_mem) / num_stats;
+  }
+
+  /**
+   * Initializes threading, starting worker threads which each have their own replica of the tls
+   * cache.
+   * @param num_workers supplies the number of worker threads to start.
+   */
+  void initThreading(uint32_t num_workers = 0) {
     dispatcher_ = std::make_unique<Event::DispatcherImpl>(time_system_);
     tls_ = std::make_unique<ThreadLocal::InstanceImpl>();
+    tls_->registerThread(*dispatcher_, true);
+    for (uint32_t i = 0; i < num_workers; i++) {
+      workers_.emplace_back(std::make_unique<Worker>(real_time_system_));
+      tls_->registerThread(*workers_.back()->dispatcher_, false);
+    }
     store_.initializeThreading(*dispatcher_, *tls_);
+    for (auto& worker : workers_) {
+      Worker* raw_worker = worker.get();
+      worker->thread_ = std::make_unique<Thread::Thread>([this, raw_worker]() -> void {
+        raw_worker->dispatcher_->run(Event::Dispatcher::RunType::Block);
+        tls_->shutdownThread();
+      });
+    }
+  }
+
+  /**
+   * Looks up the sample stats on all worker threads at once, returning once all have finished.
+   * Completion is awaited by spinning on an atomic, so that the only mutexes which can be contended
+   * are those taken by the lookups.
+   */
+  void accessCountersOnWorkers() {
+    std::atomic<uint32_t> remaining{static_cast<uint32_t>(workers_.size())};
+    for (auto& worker : workers_) {
+      worker->dispatcher_->post([this, &remaining]() -> void {
+        accessCounters();
+        remaining--;
+      });
+    }
+    while (remaining.load() != 0) {
+      std::this_thread::yield();
+    }
   }
 
 private:
+  struct Worker {
+    Worker(Event::TimeSystem& time_system)
+        : dispatcher_(std::make_unique<Event::DispatcherImpl>(time_system)),
+          no_exit_timer_(dispatcher_->createTimer([]() -> void {})) {
+      // Keeps the event loop running while there is no work posted.
+      no_exit_timer_->enableTimer(std::chrono::hours(1));
+    }
+
+    std::unique_ptr<Event::DispatcherImpl> dispatcher_;
+    Event::TimerPtr no_exit_timer_;
+    Thread::ThreadPtr thread_;
+  };
+
   Stats::StatsOptionsImpl options_;
   Event::SimulatedTimeSystem time_system_;
   Stats::HeapStatDataAllocator heap_alloc_;
@@ -49,6 +129,8 @@ private:
   std::unique_ptr<ThreadLocal::InstanceImpl> tls_;
   Stats::ThreadLocalStoreImpl store_;
   envoy::config::metrics::v2::StatsConfig stats_config_;
+  Event::RealTimeSystem real_time_system_;
+  std::vector<std::unique_ptr<Worker>> workers_;
 };
 
 } // namespace Envoy
@@ -57,10 +139,12 @@ private:
 // without having initialized tls.
 static void BM_StatsNoTls(benchmark::State& state) {
   Envoy::ThreadLocalStorePerf context;
+  const uint64_t bytes_per_stat = context.createCounters();
 
   for (auto _ : state) {
     context.accessCounters();
   }
+  state.counters["bytes_per_stat"] = bytes_per_stat;
 }
 BENCHMARK(BM_StatsNoTls);
 
@@ -70,15 +154,36 @@ BENCHMARK(BM_StatsNoTls);
 static void BM_StatsWithTls(benchmark::State& state) {
   Envoy::ThreadLocalStorePerf context;
   context.initThreading();
+  const uint64_t bytes_per_stat = context.createCounters();
 
   for (auto _ : state) {
     context.accessCounters();
   }
+  state.counters["bytes_per_stat"] = bytes_per_stat;
 }
 BENCHMARK(BM_StatsWithTls);
 
-// TODO(jmarantz): add multi-threaded variant of this test, that aggressively
-// looks up stats in multiple threads to try to trigger contention issues.
+// Tests the multi-threaded performance of looking up existing stats, with the
+// given number of worker threads looking up the same stats at once. Once each
+// worker's tls cache holds the stats, a lookup takes no lock at all, so the
+// time per iteration should not grow with the number of workers, and the
+// contentions counter, which counts every contended mutex in the process while
+// the benchmark runs, should be 0.
+static void BM_StatsMultiThreadedHits(benchmark::State& state) {
+  Envoy::MutexTracerImpl& tracer = Envoy::MutexTracerImpl::getOrCreateTracer();
+  Envoy::ThreadLocalStorePerf context;
+  context.initThreading(state.range(0));
+  context.createCounters();
+  // Fill the tls cache of each worker, which takes the locks of the store.
+  context.accessCountersOnWorkers();
+  tracer.reset();
+
+  for (auto _ : state) {
+    context.accessCountersOnWorkers();
+  }
+  state.counters["contentions"] = tracer.numContentions();
+}
+BENCHMARK(BM_StatsMultiThreadedHits)->Arg(1)->Arg(2)->Arg(4)->Arg(8)->UseRealTime();
 
 // TODO(jmarantz): add version using the RawStatDataAllocator, or better yet,
 // the full hot-restart mechanism so that actual shared-memory is used.
@@ -645,6 +645,24 @@ TEST_F(HeapStatsThreadLocalStoreTest, NonHotRestartNoTruncation) {
   EXPECT_NE(nullptr, TestUtility::findCounter(*store_, name_1).get());
 }
 
+// Stat names are symbolized in the allocator's table, and the symbols are released when the
+// scope holding the stats is deleted.
+TEST_F(HeapStatsThreadLocalStoreTest, ScopeReleasesSymbols) {
+  const uint64_t initial_symbols = heap_alloc_.symbolTable().numSymbols();
+  ScopePtr scope = store_->createScope("scope.");
+  Counter& counter = scope->counter("upstream_rq");
+  EXPECT_EQ(&counter, &scope->counter("upstream_rq"));
+  EXPECT_EQ("scope.upstream_rq", counter.name());
+  scope->gauge("upstream_cx").set(1);
+  Histogram& histogram = scope->histogram("upstream_rq_time");
+  EXPECT_EQ("scope.upstream_rq_time", histogram.name());
+  histogram.recordValue(1);
+  EXPECT_EQ(initial_symbols + 4, heap_alloc_.symbolTable().numSymbols());
+
+  scope.reset();
+  EXPECT_EQ(initial_symbols, heap_alloc_.symbolTable().numSymbols());
+}
+
 // Tests how much memory is consumed allocating 100k stats.
 TEST_F(HeapStatsThreadLocalStoreTest, MemoryWithoutTls) {
   if (!TestUtil::hasDeterministicMallocStats()) {
@@ -886,5 +904,41 @@ TEST_F(HistogramTest, BasicHistogramUsed) {
   }
 }
 
+// Values below 8 have exact buckets in sharded histograms, so their statistics match those of
+// thread local histograms.
+TEST_F(HistogramTest, ShardedHistogramMerge) {
+  store_->setShardedHistograms(true);
+  ScopePtr scope1 = store_->createScope("scope1.");
+
+  Histogram& h1 = store_->histogram("h1");
+  Histogram& h2 = scope1->histogram("h2");
+  EXPECT_NE(nullptr, dynamic_cast<ShardedParentHistogramImpl*>(&h1));
+
+  expectCallAndAccumulate(h1, 1);
+  expectCallAndAccumulate(h1, 3);
+  expectCallAndAccumulate(h2, 2);
+  EXPECT_EQ(2, validateMerge());
+
+  expectCallAndAccumulate(h1, 7);
+  EXPECT_EQ(2, validateMerge());
+
+  // No values were recorded, so the interval is empty and the cumulative values are unchanged.
+  EXPECT_EQ(2, validateMerge());
+}
+
+TEST_F(HistogramTest, ShardedHistogramUsed) {
+  store_->setShardedHistograms(true);
+  Histogram& h1 = store_->histogram("h1");
+
+  EXPECT_CALL(sink_, onHistogramComplete(Ref(h1), 1));
+  h1.recordValue(1);
+  NameHistogramMap name_histogram_map = makeHistogramMap(store_->histograms());
+  EXPECT_FALSE(name_histogram_map["h1"]->used());
+
+  store_->mergeHistograms([]() -> void {});
+  EXPECT_TRUE(name_histogram_map["h1"]->used());
+  EXPECT_NE("No recorded values", name_histogram_map["h1"]->summary());
+}
+
 } // namespace Stats
 } // namespace Envoy
@@ -795,6 +795,41 @@ TEST_F(TcpConnPoolImplTest, ConcurrentConnections) {
   dispatcher_.clearDeferredDeleteList();
 }
 
+/**
+ * Test that a preconnect ratio keeps connections open ahead of the requests in flight.
+ */
+TEST_F(TcpConnPoolImplTest, PreconnectForDemand) {
+  cluster_->per_upstream_preconnect_ratio_ = 1.5;
+  InSequence s;
+
+  // The first request kicks off a connection for itself and one ahead of it.
+  conn_pool_.expectConnCreate();
+  ActiveTestConn c1(*this, 0, ActiveTestConn::Type::CreateConnection);
+  EXPECT_EQ(1U, cluster_->stats_.upstream_cx_preconnect_.value());
+
+  EXPECT_CALL(*conn_pool_.test_conns_[1].connect_timer_, disableTimer());
+  conn_pool_.test_conns_[1].connection_->raiseEvent(Network::ConnectionEvent::Connected);
+
+  // The second request uses the preconnected connection, and another one is opened ahead of both
+  // requests.
+  ConnPoolCallbacks callbacks2;
+  EXPECT_CALL(callbacks2.pool_ready_, ready());
+  conn_pool_.expectConnCreate();
+  EXPECT_EQ(nullptr, conn_pool_.newConnection(callbacks2));
+  EXPECT_EQ(&callbacks2.conn_data_->connection(), conn_pool_.test_conns_[1].connection_);
+  EXPECT_EQ(2U, cluster_->stats_.upstream_cx_preconnect_.value());
+
+  EXPECT_CALL(conn_pool_, onConnReleasedForTest()).Times(2);
+  c1.releaseConn();
+  callbacks2.conn_data_.reset();
+
+  EXPECT_CALL(conn_pool_, onConnDestroyedForTest()).Times(3);
+  conn_pool_.test_conns_[2].connection_->raiseEvent(Network::ConnectionEvent::RemoteClose);
+  conn_pool_.test_conns_[1].connection_->raiseEvent(Network::ConnectionEvent::RemoteClose);
+  conn_pool_.test_conns_[0].connection_->raiseEvent(Network::ConnectionEvent::RemoteClose);
+  dispatcher_.clearDeferredDeleteList();
+}
+
 /**
  * Tests ConnectionState lifecycle with multiple concurrent connections.
  */
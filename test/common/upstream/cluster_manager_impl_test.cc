@@ -1545,6 +1545,74 @@ TEST_F(ClusterManagerImplTest, DynamicHostRemove) {
   factory_.tls_.shutdownThread();
 }
 
+// Test that the first use of a kind of connection pool warms it on the other hosts of the
+// cluster, and that hosts added later are warmed in the kinds of pools used so far.
+TEST_F(ClusterManagerImplTest, WarmConnections) {
+  const std::string yaml = R"EOF(
+  static_resources:
+    clusters:
+    - name: cluster_1
+      connect_timeout: 0.250s
+      type: STRICT_DNS
+      dns_resolvers:
+      - socket_address:
+          address: 1.2.3.4
+          port_value: 80
+      lb_policy: ROUND_ROBIN
+      hosts:
+      - socket_address:
+          address: localhost
+          port_value: 11001
+      preconnect_policy:
+        warm_connections: 2
+  )EOF";
+
+  std::shared_ptr<Network::MockDnsResolver> dns_resolver(new Network::MockDnsResolver());
+  EXPECT_CALL(factory_.dispatcher_, createDnsResolver(_)).WillOnce(Return(dns_resolver));
+
+  Network::DnsResolver::ResolveCb dns_callback;
+  Event::MockTimer* dns_timer_ = new NiceMock<Event::MockTimer>(&factory_.dispatcher_);
+  Network::MockActiveDnsQuery active_dns_query;
+  EXPECT_CALL(*dns_resolver, resolve(_, _, _))
+      .WillRepeatedly(DoAll(SaveArg<2>(&dns_callback), Return(&active_dns_query)));
+  create(parseBootstrapFromV2Yaml(yaml));
+  EXPECT_EQ(2U, cluster_manager_->get("cluster_1")->info()->warmConnections());
+
+  // No pools have been used yet, so the initial hosts are not warmed.
+  dns_callback(TestUtility::makeDnsResponse({"127.0.0.1", "127.0.0.2"}));
+
+  // The pool for the chosen host serves the request, and the other host's pool is warmed.
+  Http::ConnectionPool::MockInstance* cp1 = new Http::ConnectionPool::MockInstance();
+  Http::ConnectionPool::MockInstance* cp2 = new Http::ConnectionPool::MockInstance();
+  EXPECT_CALL(factory_, allocateConnPool_(_)).WillOnce(Return(cp1)).WillOnce(Return(cp2));
+  EXPECT_CALL(*cp2, preconnect(2));
+  EXPECT_EQ(cp1, cluster_manager_->httpConnPoolForCluster("cluster_1", ResourcePriority::Default,
+                                                          Http::Protocol::Http11, nullptr));
+
+  // Using the same kind of pool again does not warm anything.
+  EXPECT_EQ(cp2, cluster_manager_->httpConnPoolForCluster("cluster_1", ResourcePriority::Default,
+                                                          Http::Protocol::Http11, nullptr));
+
+  Tcp::ConnectionPool::MockInstance* tcp1 = new Tcp::ConnectionPool::MockInstance();
+  Tcp::ConnectionPool::MockInstance* tcp2 = new Tcp::ConnectionPool::MockInstance();
+  EXPECT_CALL(factory_, allocateTcpConnPool_(_)).WillOnce(Return(tcp1)).WillOnce(Return(tcp2));
+  EXPECT_CALL(*tcp2, preconnect(2));
+  EXPECT_EQ(tcp1, cluster_manager_->tcpConnPoolForCluster("cluster_1", ResourcePriority::Default,
+                                                          nullptr));
+
+  // A new host is warmed in both kinds of pools before it receives any requests.
+  Http::ConnectionPool::MockInstance* cp3 = new Http::ConnectionPool::MockInstance();
+  Tcp::ConnectionPool::MockInstance* tcp3 = new Tcp::ConnectionPool::MockInstance();
+  EXPECT_CALL(factory_, allocateConnPool_(_)).WillOnce(Return(cp3));
+  EXPECT_CALL(*cp3, preconnect(2));
+  EXPECT_CALL(factory_, allocateTcpConnPool_(_)).WillOnce(Return(tcp3));
+  EXPECT_CALL(*tcp3, preconnect(2));
+  dns_timer_->callback_();
+  dns_callback(TestUtility::makeDnsResponse({"127.0.0.1", "127.0.0.2", "127.0.0.3"}));
+
+  factory_.tls_.shutdownThread();
+}
+
 // This is a regression test for a use-after-free in
 // ClusterManagerImpl::ThreadLocalClusterManagerImpl::drainConnPools(), where a removal at one
 // priority from the ConnPoolsContainer would delete the ConnPoolsContainer mid-iteration over the
@@ -1,6 +1,7 @@
 // Usage: bazel run //test/common/upstream:load_balancer_benchmark
 
 #include <memory>
+#include <string>
 
 #include "common/runtime/runtime_impl.h"
 #include "common/upstream/maglev_lb.h"
@@ -8,6 +9,7 @@
 #include "common/upstream/upstream_impl.h"
 
 #include "test/common/upstream/utility.h"
+#include "test/mocks/event/mocks.h"
 #include "test/mocks/upstream/mocks.h"
 
 #include "testing/base/public/benchmark.h"
@@ -28,25 +30,54 @@ public:
     ASSERT(num_hosts < 65536);
     for (uint64_t i = 0; i < num_hosts; i++) {
       const bool should_weight = i < num_hosts * (weighted_subset_percent / 100.0);
-      hosts.push_back(makeTestHost(info_, fmt::format("tcp://10.0.{}.{}:6379", i / 256, i % 256),
-                                   should_weight ? weight : 1));
+      hosts.push_back(makeTestHost(info_, hostUrl(i), should_weight ? weight : 1));
     }
+    next_host_ = num_hosts;
     HostVectorConstSharedPtr updated_hosts{new HostVector(hosts)};
     host_set.updateHosts(updated_hosts, updated_hosts, nullptr, nullptr, {}, hosts, {},
                          absl::nullopt);
   }
 
+  // Make hosts which have not been in the host set before.
+  HostVector newHosts(uint64_t num_hosts) {
+    HostVector hosts;
+    for (uint64_t i = 0; i < num_hosts; i++) {
+      hosts.push_back(makeTestHost(info_, hostUrl(next_host_++)));
+    }
+    return hosts;
+  }
+
+  // Replace the oldest hosts of the host set with the given ones.
+  void replaceHosts(const HostVector& hosts_added) {
+    HostSet& host_set = priority_set_.getOrCreateHostSet(0);
+    const auto first_kept = host_set.hosts().begin() + hosts_added.size();
+    const HostVector hosts_removed(host_set.hosts().begin(), first_kept);
+    HostVectorSharedPtr hosts{new HostVector(first_kept, host_set.hosts().end())};
+    hosts->insert(hosts->end(), hosts_added.begin(), hosts_added.end());
+    host_set.updateHosts(hosts, hosts, nullptr, nullptr, {}, hosts_added, hosts_removed,
+                         absl::nullopt);
+  }
+
+  static std::string hostUrl(uint64_t i) {
+    return fmt::format("tcp://10.{}.{}.{}:6379", i / 65536, (i / 256) % 256, i % 256);
+  }
+
   PrioritySetImpl priority_set_;
   std::shared_ptr<MockClusterInfo> info_{new NiceMock<MockClusterInfo>()};
+  // Releases superseded tables built in the background inline.
+  NiceMock<Event::MockDispatcher> dispatcher_;
+  uint64_t next_host_{};
 };
 
 class RingHashTester : public BaseTester {
 public:
-  RingHashTester(uint64_t num_hosts, uint64_t min_ring_size) : BaseTester(num_hosts) {
+  RingHashTester(uint64_t num_hosts, uint64_t min_ring_size, bool build_in_background = false)
+      : BaseTester(num_hosts) {
     config_ = (envoy::api::v2::Cluster::RingHashLbConfig());
     config_.value().mutable_minimum_ring_size()->set_value(min_ring_size);
+    common_config_.set_build_hash_tables_in_background(build_in_background);
     ring_hash_lb_ = std::make_unique<RingHashLoadBalancer>(priority_set_, stats_, runtime_, random_,
-                                                           config_, common_config_);
+                                                           config_, common_config_, &dispatcher_);
   }
 
   Stats::IsolatedStoreImpl stats_store_;
@@ -58,6 +89,22 @@ public:
   envoy::api::v2::Cluster::CommonLbConfig common_config_;
 };
 
+class MaglevTester : public BaseTester {
+public:
+  MaglevTester(uint64_t num_hosts, bool build_in_background = false) : BaseTester(num_hosts) {
+    common_config_.set_build_hash_tables_in_background(build_in_background);
+    maglev_lb_ = std::make_unique<MaglevLoadBalancer>(priority_set_, stats_, runtime_, random_,
+                                                      common_config_, &dispatcher_);
+  }
+
+  Stats::IsolatedStoreImpl stats_store_;
+  ClusterStats stats_{ClusterInfoImpl::generateStats(stats_store_)};
+  NiceMock<Runtime::MockLoader> runtime_;
+  Runtime::RandomGeneratorImpl random_;
+  envoy::api::v2::Cluster::CommonLbConfig common_config_;
+  std::unique_ptr<MaglevLoadBalancer> maglev_lb_;
+};
+
 uint64_t hashInt(uint64_t i) {
   // Hack to hash an integer.
   return HashUtil::xxHash64(absl::string_view(reinterpret_cast<const char*>(&i), sizeof(i)));
@@ -100,6 +147,56 @@ BENCHMARK(BM_MaglevLoadBalancerBuildTable)
     ->Arg(500)
     ->Unit(benchmark::kMillisecond);
 
+// Times the host set update which replaces the given number of hosts, including rebuilding the
+// table. With background builds only the time spent on the main thread is measured.
+void BM_RingHashLoadBalancerChurn(benchmark::State& state) {
+  const uint64_t num_hosts = state.range(0);
+  const uint64_t min_ring_size = state.range(1);
+  const uint64_t hosts_to_replace = state.range(2);
+  RingHashTester tester(num_hosts, min_ring_size, state.range(3) != 0);
+  tester.ring_hash_lb_->initialize();
+
+  for (auto _ : state) {
+    state.PauseTiming();
+    const HostVector hosts_added = tester.newHosts(hosts_to_replace);
+    state.ResumeTiming();
+
+    tester.replaceHosts(hosts_added);
+  }
+  tester.ring_hash_lb_->waitForBackgroundBuilds();
+}
+BENCHMARK(BM_RingHashLoadBalancerChurn)
+    ->Args({5000, 1048576, 1, 0})
+    ->Args({5000, 1048576, 10, 0})
+    ->Args({5000, 1048576, 100, 0})
+    ->Args({5000, 1048576, 1000, 0})
+    ->Args({5000, 1048576, 5000, 0})
+    ->Args({5000, 1048576, 1, 1})
+    ->Args({5000, 1048576, 5000, 1})
+    ->Unit(benchmark::kMillisecond);
+
+void BM_MaglevLoadBalancerChurn(benchmark::State& state) {
+  const uint64_t num_hosts = state.range(0);
+  const uint64_t hosts_to_replace = state.range(1);
+  MaglevTester tester(num_hosts, state.range(2) != 0);
+  tester.maglev_lb_->initialize();
+
+  for (auto _ : state) {
+    state.PauseTiming();
+    const HostVector hosts_added = tester.newHosts(hosts_to_replace);
+    state.ResumeTiming();
+
+    tester.replaceHosts(hosts_added);
+  }
+  tester.maglev_lb_->waitForBackgroundBuilds();
+}
+BENCHMARK(BM_MaglevLoadBalancerChurn)
+    ->Args({5000, 1, 0})
+    ->Args({5000, 100, 0})
+    ->Args({5000, 5000, 0})
+    ->Args({5000, 1, 1})
+    ->Unit(benchmark::kMillisecond);
+
 class TestLoadBalancerContext : public LoadBalancerContextBase {
 public:
   // Upstream::LoadBalancerContext
@@ -3,6 +3,7 @@
 #include "common/upstream/maglev_lb.h"
 
 #include "test/common/upstream/utility.h"
+#include "test/mocks/event/mocks.h"
 #include "test/mocks/upstream/mocks.h"
 
 namespace Envoy {
@@ -26,7 +27,7 @@ public:
 
   void init(uint32_t table_size) {
     lb_ = std::make_unique<MaglevLoadBalancer>(priority_set_, stats_, runtime_, random_,
-                                               common_config_, table_size);
+                                               common_config_, &dispatcher_, table_size);
     lb_->initialize();
   }
 
@@ -38,6 +39,7 @@ public:
   envoy::api::v2::Cluster::CommonLbConfig common_config_;
   NiceMock<Runtime::MockLoader> runtime_;
   NiceMock<Runtime::MockRandomGenerator> random_;
+  NiceMock<Event::MockDispatcher> dispatcher_;
   std::unique_ptr<MaglevLoadBalancer> lb_;
 };
 
@@ -227,5 +229,24 @@ TEST_F(MaglevLoadBalancerTest, LocalityWeightedGlobalPanic) {
   }
 }
 
+// Tables built in the background are picked up by load balancers created before the build.
+TEST_F(MaglevLoadBalancerTest, BackgroundBuild) {
+  host_set_.hosts_ = {makeTestHost(info_, "tcp://127.0.0.1:90")};
+  host_set_.healthy_hosts_ = host_set_.hosts_;
+  host_set_.runCallbacks({}, {});
+  common_config_.set_build_hash_tables_in_background(true);
+  init(7);
+
+  LoadBalancerPtr lb = lb_->factory()->create();
+  TestLoadBalancerContext context(0);
+  EXPECT_EQ(host_set_.hosts_[0], lb->chooseHost(&context));
+
+  host_set_.hosts_ = {makeTestHost(info_, "tcp://127.0.0.1:91")};
+  host_set_.healthy_hosts_ = host_set_.hosts_;
+  host_set_.runCallbacks({}, {});
+  lb_->waitForBackgroundBuilds();
+  EXPECT_EQ(host_set_.hosts_[0], lb->chooseHost(&context));
+}
+
 } // namespace Upstream
 } // namespace Envoy
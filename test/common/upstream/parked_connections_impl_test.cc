@@ -0,0 +1,238 @@
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+#include "common/common/thread.h"
+#include "common/network/listen_socket_impl.h"
+#include "common/stats/isolated_store_impl.h"
+#include "common/upstream/parked_connections_impl.h"
+
+#include "test/mocks/upstream/cluster_info.h"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Upstream {
+namespace {
+
+class ParkedConnectionsImplTest : public testing::Test {
+public:
+  ~ParkedConnectionsImplTest() {
+    for (int fd : peers_) {
+      ::close(fd);
+    }
+  }
+
+  std::unique_ptr<ParkedConnectionsImpl> makeParked(uint32_t capacity) {
+    return std::make_unique<ParkedConnectionsImpl>(capacity, std::chrono::seconds(60), cluster_,
+                                                   host_stats_);
+  }
+
+  // Returns a socket connected to a peer which the test keeps open.
+  Network::ConnectionSocketPtr newSocket() {
+    int fds[2];
+    EXPECT_EQ(0, ::socketpair(AF_UNIX, SOCK_STREAM, 0, fds));
+    peers_.push_back(fds[1]);
+    return std::make_unique<Network::ConnectionSocketImpl>(fds[0], nullptr, nullptr);
+  }
+
+  testing::NiceMock<MockClusterInfo> cluster_;
+  Stats::IsolatedStoreImpl host_stats_store_;
+  HostStats host_stats_{
+      ALL_HOST_STATS(POOL_COUNTER(host_stats_store_), POOL_GAUGE(host_stats_store_))};
+  const MonotonicTime now_{std::chrono::seconds(1000)};
+  std::vector<int> peers_;
+};
+
+TEST_F(ParkedConnectionsImplTest, ParkAndTake) {
+  std::unique_ptr<ParkedConnectionsImpl> parked = makeParked(2);
+  bool other_worker = true;
+  EXPECT_EQ(nullptr, parked->take(other_worker, now_));
+
+  Network::ConnectionSocketPtr socket1 = newSocket();
+  Network::ConnectionSocketPtr socket2 = newSocket();
+  const int fd1 = socket1->fd();
+  const int fd2 = socket2->fd();
+  EXPECT_TRUE(parked->park(socket1, ResourcePriority::Default, now_));
+  EXPECT_TRUE(parked->park(socket2, ResourcePriority::Default, now_));
+  EXPECT_EQ(nullptr, socket1);
+
+  // There is no room for a third socket, which is left with the caller.
+  Network::ConnectionSocketPtr socket3 = newSocket();
+  EXPECT_FALSE(parked->park(socket3, ResourcePriority::Default, now_));
+  EXPECT_NE(nullptr, socket3);
+
+  // Sockets are taken in the order they were parked.
+  Network::ConnectionSocketPtr taken = parked->take(other_worker, now_);
+  EXPECT_EQ(fd1, taken->fd());
+  EXPECT_FALSE(other_worker);
+  EXPECT_TRUE(parked->park(socket3, ResourcePriority::Default, now_));
+  EXPECT_EQ(fd2, parked->take(other_worker, now_)->fd());
+  EXPECT_NE(nullptr, parked->take(other_worker, now_));
+  EXPECT_EQ(nullptr, parked->take(other_worker, now_));
+}
+
+TEST_F(ParkedConnectionsImplTest, TakeFromOtherWorker) {
+  std::unique_ptr<ParkedConnectionsImpl> parked = makeParked(4);
+  Network::ConnectionSocketPtr socket = newSocket();
+  Thread::Thread thread(
+      [&]() { EXPECT_TRUE(parked->park(socket, ResourcePriority::Default, now_)); });
+  thread.join();
+
+  bool other_worker = false;
+  EXPECT_NE(nullptr, parked->take(other_worker, now_));
+  EXPECT_TRUE(other_worker);
+}
+
+// Sockets whose peer closed them, or sent something on them, are closed instead of being taken.
+TEST_F(ParkedConnectionsImplTest, SkipUnusableSockets) {
+  std::unique_ptr<ParkedConnectionsImpl> parked = makeParked(4);
+  Network::ConnectionSocketPtr closed = newSocket();
+  Network::ConnectionSocketPtr readable = newSocket();
+  Network::ConnectionSocketPtr idle = newSocket();
+  const int idle_fd = idle->fd();
+  EXPECT_TRUE(parked->park(closed, ResourcePriority::Default, now_));
+  EXPECT_TRUE(parked->park(readable, ResourcePriority::Default, now_));
+  EXPECT_TRUE(parked->park(idle, ResourcePriority::Default, now_));
+
+  ::close(peers_[0]);
+  peers_[0] = -1;
+  EXPECT_EQ(1, ::write(peers_[1], "x", 1));
+
+  bool other_worker;
+  EXPECT_EQ(idle_fd, parked->take(other_worker, now_)->fd());
+  EXPECT_EQ(nullptr, parked->take(other_worker, now_));
+}
+
+TEST_F(ParkedConnectionsImplTest, DestroyClosesSockets) {
+  {
+    std::unique_ptr<ParkedConnectionsImpl> parked = makeParked(4);
+    Network::ConnectionSocketPtr socket = newSocket();
+    EXPECT_TRUE(parked->park(socket, ResourcePriority::Default, now_));
+  }
+
+  char byte;
+  EXPECT_EQ(0, ::read(peers_[0], &byte, 1));
+}
+
+// Parked sockets count as active connections of the host and cluster, and against the circuit
+// breaker of the priority they were parked at, until they are taken or closed.
+TEST_F(ParkedConnectionsImplTest, CountParkedSockets) {
+  // The mock cluster has one resource manager for all priorities.
+  cluster_.resetResourceManager(3, 1024, 1024, 1);
+  std::unique_ptr<ParkedConnectionsImpl> parked = makeParked(4);
+  Network::ConnectionSocketPtr socket1 = newSocket();
+  Network::ConnectionSocketPtr socket2 = newSocket();
+  Network::ConnectionSocketPtr socket3 = newSocket();
+  EXPECT_TRUE(parked->park(socket1, ResourcePriority::Default, now_));
+  EXPECT_TRUE(parked->park(socket2, ResourcePriority::High, now_));
+  EXPECT_TRUE(parked->park(socket3, ResourcePriority::Default, now_));
+  EXPECT_EQ(3U, cluster_.stats_.upstream_cx_parked_active_.value());
+  EXPECT_EQ(3U, cluster_.stats_.upstream_cx_active_.value());
+  EXPECT_EQ(3U, host_stats_.cx_active_.value());
+  ResourceManager& resources = cluster_.resourceManager(ResourcePriority::Default);
+  EXPECT_FALSE(resources.connections().canCreate());
+
+  bool other_worker;
+  EXPECT_NE(nullptr, parked->take(other_worker, now_));
+  EXPECT_TRUE(resources.connections().canCreate());
+  EXPECT_EQ(2U, cluster_.stats_.upstream_cx_parked_active_.value());
+  EXPECT_EQ(2U, cluster_.stats_.upstream_cx_active_.value());
+  EXPECT_EQ(2U, host_stats_.cx_active_.value());
+
+  parked.reset();
+  EXPECT_EQ(0U, cluster_.stats_.upstream_cx_parked_active_.value());
+  EXPECT_EQ(0U, cluster_.stats_.upstream_cx_active_.value());
+  EXPECT_EQ(0U, host_stats_.cx_active_.value());
+}
+
+// Sockets which stay parked for the idle timeout are closed.
+TEST_F(ParkedConnectionsImplTest, IdleTimeout) {
+  std::unique_ptr<ParkedConnectionsImpl> parked = makeParked(4);
+  EXPECT_EQ(absl::nullopt, parked->closeIdle(now_));
+
+  Network::ConnectionSocketPtr socket1 = newSocket();
+  Network::ConnectionSocketPtr socket2 = newSocket();
+  Network::ConnectionSocketPtr socket3 = newSocket();
+  const int fd3 = socket3->fd();
+  EXPECT_TRUE(parked->park(socket1, ResourcePriority::Default, now_));
+  EXPECT_TRUE(parked->park(socket2, ResourcePriority::Default, now_ + std::chrono::seconds(10)));
+  EXPECT_TRUE(parked->park(socket3, ResourcePriority::Default, now_ + std::chrono::seconds(20)));
+  EXPECT_EQ(std::chrono::milliseconds(60000), parked->closeIdle(now_));
+
+  // The first socket reaches its timeout, and the next reaches it 10 seconds later.
+  EXPECT_EQ(std::chrono::milliseconds(10000),
+            parked->closeIdle(now_ + std::chrono::seconds(60)));
+  EXPECT_EQ(1U, cluster_.stats_.upstream_cx_idle_timeout_.value());
+  EXPECT_EQ(2U, cluster_.stats_.upstream_cx_parked_active_.value());
+  char byte;
+  EXPECT_EQ(0, ::read(peers_[0], &byte, 1));
+
+  // Taking a socket closes the expired ones in front of it.
+  bool other_worker;
+  EXPECT_EQ(fd3, parked->take(other_worker, now_ + std::chrono::seconds(75))->fd());
+  EXPECT_EQ(2U, cluster_.stats_.upstream_cx_idle_timeout_.value());
+  EXPECT_EQ(0U, cluster_.stats_.upstream_cx_parked_active_.value());
+  EXPECT_EQ(0, ::read(peers_[1], &byte, 1));
+  EXPECT_EQ(absl::nullopt, parked->closeIdle(now_ + std::chrono::seconds(75)));
+}
+
+// Workers parking and taking at the same time neither lose nor duplicate sockets.
+TEST_F(ParkedConnectionsImplTest, ConcurrentParkAndTake) {
+  constexpr uint32_t Workers = 4;
+  constexpr uint32_t SocketsPerWorker = 64;
+  std::unique_ptr<ParkedConnectionsImpl> parked = makeParked(16);
+  std::vector<std::vector<Network::ConnectionSocketPtr>> sockets(Workers);
+  for (auto& worker_sockets : sockets) {
+    for (uint32_t i = 0; i < SocketsPerWorker; i++) {
+      worker_sockets.push_back(newSocket());
+    }
+  }
+
+  std::vector<std::unique_ptr<Thread::Thread>> threads;
+  for (uint32_t i = 0; i < Workers; i++) {
+    threads.push_back(std::make_unique<Thread::Thread>([&, &worker_sockets = sockets[i]]() {
+      // Each socket is parked and taken back many times, by whichever worker finds it.
+      for (uint32_t round = 0; round < 1000; round++) {
+        for (Network::ConnectionSocketPtr& socket : worker_sockets) {
+          if (socket != nullptr) {
+            parked->park(socket, ResourcePriority::Default, now_);
+          }
+        }
+        for (Network::ConnectionSocketPtr& socket : worker_sockets) {
+          if (socket == nullptr) {
+            bool other_worker;
+            socket = parked->take(other_worker, now_);
+          }
+        }
+      }
+    }));
+  }
+  for (auto& thread : threads) {
+    thread->join();
+  }
+
+  bool other_worker;
+  while (Network::ConnectionSocketPtr socket = parked->take(other_worker, now_)) {
+    sockets[0].push_back(std::move(socket));
+  }
+  std::vector<int> fds;
+  for (auto& worker_sockets : sockets) {
+    for (Network::ConnectionSocketPtr& socket : worker_sockets) {
+      if (socket != nullptr) {
+        fds.push_back(socket->fd());
+      }
+    }
+  }
+  std::sort(fds.begin(), fds.end());
+  EXPECT_EQ(Workers * SocketsPerWorker, fds.size());
+  EXPECT_EQ(fds.end(), std::adjacent_find(fds.begin(), fds.end()));
+}
+
+} // namespace
+} // namespace Upstream
+} // namespace Envoy
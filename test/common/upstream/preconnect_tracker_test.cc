@@ -0,0 +1,43 @@
+#include "common/upstream/preconnect_tracker.h"
+
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Upstream {
+namespace {
+
+TEST(PreconnectTrackerTest, Disabled) {
+  PreconnectTracker tracker;
+  tracker.onNewRequest(10);
+  EXPECT_EQ(0, tracker.targetConnections(10, 1.0));
+}
+
+// The target follows the requests in flight when they are above the average.
+TEST(PreconnectTrackerTest, CurrentRequests) {
+  PreconnectTracker tracker;
+  EXPECT_EQ(0, tracker.targetConnections(0, 1.5));
+  tracker.onNewRequest(1);
+  EXPECT_EQ(2, tracker.targetConnections(1, 1.5));
+  EXPECT_EQ(15, tracker.targetConnections(10, 1.5));
+}
+
+// The target stays up while the average of recent demand is above the requests in flight, and
+// decays as new requests see less demand.
+TEST(PreconnectTrackerTest, Average) {
+  PreconnectTracker tracker;
+  for (uint32_t i = 0; i < 100; i++) {
+    tracker.onNewRequest(10);
+  }
+  EXPECT_NEAR(10, tracker.average(), 0.01);
+  EXPECT_EQ(20, tracker.targetConnections(0, 2.0));
+
+  for (uint32_t i = 0; i < 100; i++) {
+    tracker.onNewRequest(1);
+  }
+  EXPECT_NEAR(1, tracker.average(), 0.01);
+  EXPECT_EQ(4, tracker.targetConnections(2, 2.0));
+}
+
+} // namespace
+} // namespace Upstream
+} // namespace Envoy
@@ -1,15 +1,19 @@
+#include <atomic>
 #include <cstdint>
 #include <memory>
 #include <string>
 #include <unordered_map>
+#include <vector>
 
 #include "envoy/router/router.h"
 
+#include "common/common/thread.h"
 #include "common/network/utility.h"
 #include "common/upstream/ring_hash_lb.h"
 #include "common/upstream/upstream_impl.h"
 
 #include "test/common/upstream/utility.h"
+#include "test/mocks/event/mocks.h"
 #include "test/mocks/runtime/mocks.h"
 #include "test/mocks/upstream/mocks.h"
 
@@ -19,6 +23,7 @@
 using testing::_;
 using testing::NiceMock;
 using testing::Return;
+using testing::SaveArg;
 
 namespace Envoy {
 namespace Upstream {
@@ -39,7 +44,7 @@ public:
 
   void init() {
     lb_ = std::make_unique<RingHashLoadBalancer>(priority_set_, stats_, runtime_, random_, config_,
-                                                 common_config_);
+                                                 common_config_, &dispatcher_);
     lb_->initialize();
   }
 
@@ -57,6 +62,7 @@ public:
   envoy::api::v2::Cluster::CommonLbConfig common_config_;
   NiceMock<Runtime::MockLoader> runtime_;
   NiceMock<Runtime::MockRandomGenerator> random_;
+  NiceMock<Event::MockDispatcher> dispatcher_;
   std::unique_ptr<RingHashLoadBalancer> lb_;
 };
 
@@ -276,5 +282,155 @@ TEST_P(RingHashLoadBalancerTest, UnevenHosts) {
   }
 }
 
+// A ring built from the previous ring when a few hosts change balances like a ring built from
+// scratch.
+TEST_P(RingHashLoadBalancerTest, IncrementalUpdate) {
+  for (uint32_t port = 90; port < 98; port++) {
+    hostSet().hosts_.push_back(makeTestHost(info_, fmt::format("tcp://127.0.0.1:{}", port)));
+  }
+  hostSet().healthy_hosts_ = hostSet().hosts_;
+  hostSet().runCallbacks({}, {});
+
+  config_ = (envoy::api::v2::Cluster::RingHashLbConfig());
+  config_.value().mutable_minimum_ring_size()->set_value(64);
+  init();
+
+  // Replace the first host, which keeps 8 entries per host.
+  const HostSharedPtr removed = hostSet().hosts_[0];
+  const HostSharedPtr added = makeTestHost(info_, "tcp://127.0.0.1:98");
+  hostSet().hosts_.erase(hostSet().hosts_.begin());
+  hostSet().hosts_.push_back(added);
+  hostSet().healthy_hosts_ = hostSet().hosts_;
+  hostSet().runCallbacks({added}, {removed});
+
+  NiceMock<MockPrioritySet> priority_set;
+  MockHostSet& host_set = *priority_set.getMockHostSet(GetParam() ? 0 : 1);
+  host_set.hosts_ = hostSet().hosts_;
+  host_set.healthy_hosts_ = hostSet().hosts_;
+  RingHashLoadBalancer full_lb(priority_set, stats_, runtime_, random_, config_, common_config_,
+                               nullptr);
+  full_lb.initialize();
+
+  LoadBalancerPtr lb = lb_->factory()->create();
+  LoadBalancerPtr expected_lb = full_lb.factory()->create();
+  for (uint64_t i = 0; i < 1000; i++) {
+    TestLoadBalancerContext context(i * 18446744073709551ULL);
+    EXPECT_EQ(expected_lb->chooseHost(&context), lb->chooseHost(&context));
+  }
+}
+
+// Rings built in the background are picked up by load balancers created before the build.
+TEST_P(RingHashLoadBalancerTest, BackgroundBuild) {
+  hostSet().hosts_ = {makeTestHost(info_, "tcp://127.0.0.1:90")};
+  hostSet().healthy_hosts_ = hostSet().hosts_;
+  hostSet().runCallbacks({}, {});
+
+  common_config_.set_build_hash_tables_in_background(true);
+  init();
+
+  // The first ring is built synchronously.
+  LoadBalancerPtr lb = lb_->factory()->create();
+  TestLoadBalancerContext context(0);
+  EXPECT_EQ(hostSet().hosts_[0], lb->chooseHost(&context));
+
+  // The superseded ring is released on the main thread.
+  Event::PostCb release;
+  EXPECT_CALL(dispatcher_, post(_)).WillOnce(SaveArg<0>(&release));
+  hostSet().hosts_ = {makeTestHost(info_, "tcp://127.0.0.1:91")};
+  hostSet().healthy_hosts_ = hostSet().hosts_;
+  hostSet().runCallbacks({}, {});
+  lb_->waitForBackgroundBuilds();
+  EXPECT_EQ(hostSet().hosts_[0], lb->chooseHost(&context));
+  release();
+}
+
+// Without a main thread dispatcher tables are always built synchronously.
+TEST_P(RingHashLoadBalancerTest, BackgroundBuildWithoutDispatcher) {
+  hostSet().hosts_ = {makeTestHost(info_, "tcp://127.0.0.1:90")};
+  hostSet().healthy_hosts_ = hostSet().hosts_;
+  hostSet().runCallbacks({}, {});
+
+  common_config_.set_build_hash_tables_in_background(true);
+  lb_ = std::make_unique<RingHashLoadBalancer>(priority_set_, stats_, runtime_, random_, config_,
+                                               common_config_, nullptr);
+  lb_->initialize();
+
+  LoadBalancerPtr lb = lb_->factory()->create();
+  hostSet().hosts_ = {makeTestHost(info_, "tcp://127.0.0.1:91")};
+  hostSet().healthy_hosts_ = hostSet().hosts_;
+  hostSet().runCallbacks({}, {});
+  TestLoadBalancerContext context(0);
+  EXPECT_EQ(hostSet().hosts_[0], lb->chooseHost(&context));
+}
+
+// Load balancers building in the background share the builder thread.
+TEST_P(RingHashLoadBalancerTest, BackgroundBuildSharedBuilder) {
+  hostSet().hosts_ = {makeTestHost(info_, "tcp://127.0.0.1:90")};
+  hostSet().healthy_hosts_ = hostSet().hosts_;
+  hostSet().runCallbacks({}, {});
+
+  common_config_.set_build_hash_tables_in_background(true);
+  init();
+  RingHashLoadBalancer other_lb(priority_set_, stats_, runtime_, random_, config_, common_config_,
+                                &dispatcher_);
+  other_lb.initialize();
+
+  LoadBalancerPtr lb = lb_->factory()->create();
+  LoadBalancerPtr other = other_lb.factory()->create();
+  for (uint32_t port = 91; port < 95; port++) {
+    hostSet().hosts_ = {makeTestHost(info_, fmt::format("tcp://127.0.0.1:{}", port))};
+    hostSet().healthy_hosts_ = hostSet().hosts_;
+    hostSet().runCallbacks({}, {});
+  }
+  lb_->waitForBackgroundBuilds();
+  other_lb.waitForBackgroundBuilds();
+
+  TestLoadBalancerContext context(0);
+  EXPECT_EQ(hostSet().hosts_[0], lb->chooseHost(&context));
+  EXPECT_EQ(hostSet().hosts_[0], other->chooseHost(&context));
+}
+
+// Worker load balancers keep choosing hosts while the tables they use are replaced by tables
+// built in the background.
+TEST_P(RingHashLoadBalancerTest, BackgroundBuildConcurrentChooseHost) {
+  hostSet().hosts_ = {makeTestHost(info_, "tcp://127.0.0.1:90")};
+  hostSet().healthy_hosts_ = hostSet().hosts_;
+  hostSet().runCallbacks({}, {});
+
+  common_config_.set_build_hash_tables_in_background(true);
+  init();
+
+  LoadBalancerFactorySharedPtr factory = lb_->factory();
+  std::atomic<bool> done{false};
+  std::vector<Thread::ThreadPtr> workers;
+  for (uint32_t i = 0; i < 4; i++) {
+    workers.push_back(std::make_unique<Thread::Thread>([factory, &done]() -> void {
+      LoadBalancerPtr lb = factory->create();
+      for (uint64_t hash = 0; !done; hash++) {
+        TestLoadBalancerContext context(hash);
+        HostConstSharedPtr host = lb->chooseHost(&context);
+        ASSERT_NE(nullptr, host);
+        EXPECT_FALSE(host->address()->asString().empty());
+      }
+    }));
+  }
+
+  for (uint32_t port = 91; port < 191; port++) {
+    hostSet().hosts_ = {makeTestHost(info_, fmt::format("tcp://127.0.0.1:{}", port)),
+                        makeTestHost(info_, fmt::format("tcp://127.0.0.2:{}", port))};
+    hostSet().healthy_hosts_ = hostSet().hosts_;
+    hostSet().runCallbacks({}, {});
+  }
+  lb_->waitForBackgroundBuilds();
+  done = true;
+  for (Thread::ThreadPtr& worker : workers) {
+    worker->join();
+  }
+
+  TestLoadBalancerContext context(0);
+  const HostConstSharedPtr host = lb_->factory()->create()->chooseHost(&context);
+  EXPECT_TRUE(host == hostSet().hosts_[0] || host == hostSet().hosts_[1]);
+}
+
 } // namespace Upstream
 } // namespace Envoy
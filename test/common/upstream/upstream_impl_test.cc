@@ -1580,6 +1580,57 @@ TEST_F(ClusterInfoImplTest, Metadata) {
   EXPECT_EQ(LoadBalancerType::Maglev, cluster->info()->lbType());
 }
 
+TEST_F(ClusterInfoImplTest, PreconnectPolicy) {
+  const std::string yaml = R"EOF(
+    name: name
+    connect_timeout: 0.25s
+    type: STRICT_DNS
+    lb_policy: ROUND_ROBIN
+    hosts: [{ socket_address: { address: foo.bar.com, port_value: 443 }}]
+  )EOF";
+
+  auto cluster = makeCluster(yaml);
+  EXPECT_EQ(1.0, cluster->info()->perUpstreamPreconnectRatio());
+  EXPECT_EQ(0U, cluster->info()->warmConnections());
+
+  const std::string preconnect_yaml = yaml + R"EOF(
+    preconnect_policy:
+      per_upstream_preconnect_ratio: 1.5
+      warm_connections: 4
+  )EOF";
+
+  cluster.reset();
+  cluster = makeCluster(preconnect_yaml);
+  EXPECT_EQ(1.5, cluster->info()->perUpstreamPreconnectRatio());
+  EXPECT_EQ(4U, cluster->info()->warmConnections());
+}
+
+TEST_F(ClusterInfoImplTest, SharedIdleConnections) {
+  const std::string yaml = R"EOF(
+    name: name
+    connect_timeout: 0.25s
+    type: STRICT_DNS
+    lb_policy: ROUND_ROBIN
+    hosts: [{ socket_address: { address: foo.bar.com, port_value: 443 }}]
+  )EOF";
+
+  auto cluster = makeCluster(yaml);
+  EXPECT_EQ(0U, cluster->info()->maxParkedConnectionsPerHost());
+
+  cluster.reset();
+  cluster = makeCluster(yaml + R"EOF(
+    shared_idle_connections: {}
+  )EOF");
+  EXPECT_EQ(64U, cluster->info()->maxParkedConnectionsPerHost());
+
+  cluster.reset();
+  cluster = makeCluster(yaml + R"EOF(
+    shared_idle_connections:
+      max_parked_per_host: 8
+  )EOF");
+  EXPECT_EQ(8U, cluster->info()->maxParkedConnectionsPerHost());
+}
+
 // Typed metadata loading throws exception.
 TEST_F(ClusterInfoImplTest, BrokenTypedMetadata) {
   const std::string yaml = R"EOF(
@@ -0,0 +1,77 @@
+#include <string>
+
+#include "common/buffer/buffer_impl.h"
+
+#include "extensions/resource_monitors/buffer_memory/buffer_memory_monitor.h"
+
+#include "absl/types/optional.h"
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace ResourceMonitors {
+namespace BufferMemoryMonitor {
+
+class MockBufferMemoryReader : public BufferMemoryReader {
+public:
+  MockBufferMemoryReader() {}
+
+  MOCK_METHOD0(bytesInUse, uint64_t());
+};
+
+class ResourcePressure : public Server::ResourceMonitor::Callbacks {
+public:
+  void onSuccess(const Server::ResourceUsage& usage) override {
+    pressure_ = usage.resource_pressure_;
+  }
+
+  void onFailure(const EnvoyException& error) override { error_ = error; }
+
+  bool hasPressure() const { return pressure_.has_value(); }
+  bool hasError() const { return error_.has_value(); }
+
+  double pressure() const { return *pressure_; }
+
+private:
+  absl::optional<double> pressure_;
+  absl::optional<EnvoyException> error_;
+};
+
+TEST(BufferMemoryMonitorTest, ComputesCorrectUsage) {
+  envoy::config::resource_monitor::buffer_memory::v2alpha::BufferMemoryConfig config;
+  config.set_max_buffer_memory_bytes(1000);
+  auto reader = std::make_unique<MockBufferMemoryReader>();
+  EXPECT_CALL(*reader, bytesInUse()).WillOnce(testing::Return(700));
+  std::unique_ptr<BufferMemoryMonitor> monitor(new BufferMemoryMonitor(config, std::move(reader)));
+
+  ResourcePressure resource;
+  monitor->updateResourceUsage(resource);
+  EXPECT_TRUE(resource.hasPressure());
+  EXPECT_FALSE(resource.hasError());
+  EXPECT_EQ(resource.pressure(), 0.7);
+}
+
+TEST(BufferMemoryMonitorTest, TracksBuffers) {
+  Buffer::OwnedImpl::useOldImpl(false);
+  envoy::config::resource_monitor::buffer_memory::v2alpha::BufferMemoryConfig config;
+  config.set_max_buffer_memory_bytes(1024 * 1024);
+  BufferMemoryMonitor monitor(config);
+
+  ResourcePressure before;
+  monitor.updateResourceUsage(before);
+  {
+    Buffer::OwnedImpl buffer(std::string(64 * 1024, 'a'));
+    ResourcePressure during;
+    monitor.updateResourceUsage(during);
+    EXPECT_LE(before.pressure() + 0.0625, during.pressure());
+  }
+  ResourcePressure after;
+  monitor.updateResourceUsage(after);
+  EXPECT_EQ(before.pressure(), after.pressure());
+}
+
+} // namespace BufferMemoryMonitor
+} // namespace ResourceMonitors
+} // namespace Extensions
+} // namespace Envoy
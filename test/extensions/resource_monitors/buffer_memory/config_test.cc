@@ -0,0 +1,34 @@
+#include "envoy/config/resource_monitor/buffer_memory/v2alpha/buffer_memory.pb.validate.h"
+#include "envoy/registry/registry.h"
+
+#include "server/resource_monitor_config_impl.h"
+
+#include "extensions/resource_monitors/buffer_memory/config.h"
+
+#include "test/mocks/event/mocks.h"
+
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace ResourceMonitors {
+namespace BufferMemoryMonitor {
+
+TEST(BufferMemoryMonitorFactoryTest, CreateMonitor) {
+  auto factory =
+      Registry::FactoryRegistry<Server::Configuration::ResourceMonitorFactory>::getFactory(
+          "envoy.resource_monitors.buffer_memory");
+  EXPECT_NE(factory, nullptr);
+
+  envoy::config::resource_monitor::buffer_memory::v2alpha::BufferMemoryConfig config;
+  config.set_max_buffer_memory_bytes(std::numeric_limits<uint64_t>::max());
+  Event::MockDispatcher dispatcher;
+  Server::Configuration::ResourceMonitorFactoryContextImpl context(dispatcher);
+  auto monitor = factory->createResourceMonitor(config, context);
+  EXPECT_NE(monitor, nullptr);
+}
+
+} // namespace BufferMemoryMonitor
+} // namespace ResourceMonitors
+} // namespace Extensions
+} // namespace Envoy
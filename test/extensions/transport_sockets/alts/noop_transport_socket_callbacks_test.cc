@@ -19,6 +19,8 @@ public:
   Network::Connection& connection() override { return connection_; }
   bool shouldDrainReadBuffer() override { return false; }
   void setReadBufferReady() override { set_read_buffer_ready_ = true; }
+  void setWriteBufferReady() override {}
+  Event::IoUring* ioUring() override { return nullptr; }
   void raiseEvent(Network::ConnectionEvent) override { event_raised_ = true; }
 
   bool event_raised() const { return event_raised_; }
@@ -72,6 +72,8 @@ public:
   MOCK_METHOD5(getsockopt_,
                int(int sockfd, int level, int optname, void* optval, socklen_t* optlen));
   MOCK_METHOD3(socket, SysCallIntResult(int domain, int type, int protocol));
+  MOCK_METHOD3(accept, SysCallIntResult(int sockfd, sockaddr* addr, socklen_t* addrlen));
+  MOCK_METHOD2(listen, SysCallIntResult(int sockfd, int backlog));
 
   size_t num_writes_;
   size_t num_open_;
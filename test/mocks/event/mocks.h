@@ -4,6 +4,7 @@
 #include <cstdint>
 #include <functional>
 #include <list>
+#include <string>
 
 #include "envoy/common/time.h"
 #include "envoy/event/deferred_deletable.h"
@@ -49,6 +50,12 @@ public:
         createClientConnection_(address, source_address, transport_socket, options)};
   }
 
+  Network::ClientConnectionPtr
+  adoptClientConnection(Network::ConnectionSocketPtr&& socket,
+                        Network::TransportSocketPtr&& transport_socket) override {
+    return Network::ClientConnectionPtr{adoptClientConnection_(socket, transport_socket)};
+  }
+
   FileEventPtr createFileEvent(int fd, FileReadyCb cb, FileTriggerType trigger,
                                uint32_t events) override {
     return FileEventPtr{createFileEvent_(fd, cb, trigger, events)};
@@ -60,15 +67,21 @@ public:
 
   Network::ListenerPtr createListener(Network::Socket& socket, Network::ListenerCallbacks& cb,
                                       bool bind_to_port,
-                                      bool hand_off_restored_destination_connections) override {
-    return Network::ListenerPtr{
-        createListener_(socket, cb, bind_to_port, hand_off_restored_destination_connections)};
+                                      bool hand_off_restored_destination_connections,
+                                      uint32_t max_accepts_per_wakeup) override {
+    return Network::ListenerPtr{createListener_(socket, cb, bind_to_port,
+                                                hand_off_restored_destination_connections,
+                                                max_accepts_per_wakeup)};
   }
 
   Event::TimerPtr createTimer(Event::TimerCb cb) override {
     return Event::TimerPtr{createTimer_(cb)};
   }
 
+  Event::TimerPtr createTimer(Event::TimerCb cb, Event::TimerResolution) override {
+    return Event::TimerPtr{createTimer_(cb)};
+  }
+
   void deferredDelete(DeferredDeletablePtr&& to_delete) override {
     deferredDelete_(to_delete.get());
     if (to_delete) {
@@ -82,6 +95,7 @@ public:
 
   // Event::Dispatcher
   MOCK_METHOD0(clearDeferredDeleteList, void());
+  MOCK_METHOD2(initializeStats, void(Stats::Scope& scope, const std::string& prefix));
   MOCK_METHOD2(createServerConnection_,
                Network::Connection*(Network::ConnectionSocket* socket,
                                     Network::TransportSocket* transport_socket));
@@ -91,16 +105,19 @@ public:
                                  Network::Address::InstanceConstSharedPtr source_address,
                                  Network::TransportSocketPtr& transport_socket,
                                  const Network::ConnectionSocket::OptionsSharedPtr& options));
+  MOCK_METHOD2(adoptClientConnection_,
+               Network::ClientConnection*(Network::ConnectionSocketPtr& socket,
+                                          Network::TransportSocketPtr& transport_socket));
   MOCK_METHOD1(createDnsResolver,
                Network::DnsResolverSharedPtr(
                    const std::vector<Network::Address::InstanceConstSharedPtr>& resolvers));
   MOCK_METHOD4(createFileEvent_,
                FileEvent*(int fd, FileReadyCb cb, FileTriggerType trigger, uint32_t events));
   MOCK_METHOD0(createFilesystemWatcher_, Filesystem::Watcher*());
-  MOCK_METHOD4(createListener_,
+  MOCK_METHOD5(createListener_,
                Network::Listener*(Network::Socket& socket, Network::ListenerCallbacks& cb,
-                                  bool bind_to_port,
-                                  bool hand_off_restored_destination_connections));
+                                  bool bind_to_port, bool hand_off_restored_destination_connections,
+                                  uint32_t max_accepts_per_wakeup));
   MOCK_METHOD1(createTimer_, Timer*(Event::TimerCb cb));
   MOCK_METHOD1(deferredDelete_, void(DeferredDeletable* to_delete));
   MOCK_METHOD0(exit, void());
@@ -108,6 +125,7 @@ public:
   MOCK_METHOD1(post, void(std::function<void()> callback));
   MOCK_METHOD1(run, void(RunType type));
   Buffer::WatermarkFactory& getWatermarkFactory() override { return buffer_factory_; }
+  MOCK_METHOD0(ioUring, IoUring*());
 
   // TODO(jmarantz): Switch these to using mock-time.
   DangerousDeprecatedTestTime test_time_;
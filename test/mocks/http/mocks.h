@@ -164,6 +164,7 @@ public:
 
   // Http::ClientConnection
   MOCK_METHOD1(newStream, StreamEncoder&(StreamDecoder& response_decoder));
+  MOCK_METHOD0(sendWindow, uint64_t());
 };
 
 class MockFilterChainFactory : public FilterChainFactory {
@@ -457,6 +458,7 @@ public:
   MOCK_CONST_METHOD0(protocol, Http::Protocol());
   MOCK_METHOD1(addDrainedCallback, void(DrainedCb cb));
   MOCK_METHOD0(drainConnections, void());
+  MOCK_METHOD1(preconnect, void(uint32_t connections));
   MOCK_METHOD2(newStream, Cancellable*(Http::StreamDecoder& response_decoder,
                                        Http::ConnectionPool::Callbacks& callbacks));
 
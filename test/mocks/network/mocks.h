@@ -146,6 +146,9 @@ public:
 
   // Network::ClientConnection
   MOCK_METHOD0(connect, void());
+  ConnectionSocketPtr releaseSocket() override { return ConnectionSocketPtr{releaseSocket_()}; }
+
+  MOCK_METHOD0(releaseSocket_, ConnectionSocket*());
 };
 
 class MockActiveDnsQuery : public ActiveDnsQuery {
@@ -371,9 +374,12 @@ public:
   MOCK_METHOD0(filterChainManager, FilterChainManager&());
   MOCK_METHOD0(filterChainFactory, FilterChainFactory&());
   MOCK_METHOD0(socket, Socket&());
+  MOCK_METHOD1(workerSocket, Socket&(uint32_t worker_index));
   MOCK_METHOD0(bindToPort, bool());
   MOCK_CONST_METHOD0(handOffRestoredDestinationConnections, bool());
   MOCK_METHOD0(perConnectionBufferLimitBytes, uint32_t());
+  MOCK_CONST_METHOD0(maxAcceptsPerWakeup, uint32_t());
+  MOCK_METHOD0(connectionRateLimiter, TokenBucket*());
   MOCK_METHOD0(listenerScope, Stats::Scope&());
   MOCK_CONST_METHOD0(listenerTag, uint64_t());
   MOCK_CONST_METHOD0(name, const std::string&());
@@ -483,6 +489,8 @@ public:
   MOCK_METHOD0(connection, Connection&());
   MOCK_METHOD0(shouldDrainReadBuffer, bool());
   MOCK_METHOD0(setReadBufferReady, void());
+  MOCK_METHOD0(setWriteBufferReady, void());
+  MOCK_METHOD0(ioUring, Event::IoUring*());
   MOCK_METHOD1(raiseEvent, void(ConnectionEvent));
 
   testing::NiceMock<MockConnection> connection_;
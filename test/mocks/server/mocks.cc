@@ -35,6 +35,11 @@ MockOptions::MockOptions(const std::string& config_path) : config_path_(config_p
   ON_CALL(*this, hotRestartDisabled()).WillByDefault(ReturnPointee(&hot_restart_disabled_));
   ON_CALL(*this, signalHandlingEnabled()).WillByDefault(ReturnPointee(&signal_handling_enabled_));
   ON_CALL(*this, mutexTracingEnabled()).WillByDefault(ReturnPointee(&mutex_tracing_enabled_));
+  ON_CALL(*this, libeventBuffersEnabled()).WillByDefault(ReturnPointee(&libevent_buffers_enabled_));
+  ON_CALL(*this, listHeaderMapsEnabled()).WillByDefault(ReturnPointee(&list_header_maps_enabled_));
+  ON_CALL(*this, simdHttp1ParserEnabled())
+      .WillByDefault(ReturnPointee(&simd_http1_parser_enabled_));
+  ON_CALL(*this, ioUringEnabled()).WillByDefault(ReturnPointee(&io_uring_enabled_));
 }
 MockOptions::~MockOptions() {}
 
@@ -80,10 +85,10 @@ MockOverloadManager::~MockOverloadManager() {}
 
 MockListenerComponentFactory::MockListenerComponentFactory()
     : socket_(std::make_shared<NiceMock<Network::MockListenSocket>>()) {
-  ON_CALL(*this, createListenSocket(_, _, _))
+  ON_CALL(*this, createListenSocket(_, _, _, _))
       .WillByDefault(Invoke([&](Network::Address::InstanceConstSharedPtr,
-                                const Network::Socket::OptionsSharedPtr& options,
-                                bool) -> Network::SocketSharedPtr {
+                                const Network::Socket::OptionsSharedPtr& options, bool,
+                                uint32_t) -> Network::SocketSharedPtr {
         if (!Network::Socket::applyOptions(options, *socket_,
                                            envoy::api::v2::core::SocketOption::STATE_PREBIND)) {
           throw EnvoyException("MockListenerComponentFactory: Setting socket options failed");
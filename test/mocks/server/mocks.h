@@ -78,6 +78,10 @@ public:
   MOCK_CONST_METHOD0(hotRestartDisabled, bool());
   MOCK_CONST_METHOD0(signalHandlingEnabled, bool());
   MOCK_CONST_METHOD0(mutexTracingEnabled, bool());
+  MOCK_CONST_METHOD0(libeventBuffersEnabled, bool());
+  MOCK_CONST_METHOD0(listHeaderMapsEnabled, bool());
+  MOCK_CONST_METHOD0(simdHttp1ParserEnabled, bool());
+  MOCK_CONST_METHOD0(ioUringEnabled, bool());
 
   std::string config_path_;
   std::string config_yaml_;
@@ -94,6 +98,10 @@ public:
   bool hot_restart_disabled_{};
   bool signal_handling_enabled_{true};
   bool mutex_tracing_enabled_{};
+  bool libevent_buffers_enabled_{};
+  bool list_header_maps_enabled_{};
+  bool simd_http1_parser_enabled_{};
+  bool io_uring_enabled_{};
 };
 
 class MockConfigTracker : public ConfigTracker {
@@ -180,7 +188,8 @@ public:
 
   // Server::HotRestart
   MOCK_METHOD0(drainParentListeners, void());
-  MOCK_METHOD1(duplicateParentListenSocket, int(const std::string& address));
+  MOCK_METHOD2(duplicateParentListenSocket,
+               int(const std::string& address, uint32_t worker_index));
   MOCK_METHOD1(getParentStats, void(GetParentStatsInfo& info));
   MOCK_METHOD2(initialize, void(Event::Dispatcher& dispatcher, Server::Instance& server));
   MOCK_METHOD1(shutdownParentAdmin, void(ShutdownParentAdminInfo& info));
@@ -218,10 +227,12 @@ public:
                std::vector<Network::ListenerFilterFactoryCb>(
                    const Protobuf::RepeatedPtrField<envoy::api::v2::listener::ListenerFilter>&,
                    Configuration::ListenerFactoryContext& context));
-  MOCK_METHOD3(createListenSocket,
+  MOCK_METHOD4(createListenSocket,
                Network::SocketSharedPtr(Network::Address::InstanceConstSharedPtr address,
                                         const Network::Socket::OptionsSharedPtr& options,
-                                        bool bind_to_port));
+                                        bool bind_to_port, uint32_t worker_index));
+  MOCK_METHOD2(hasParentListenSocket, bool(Network::Address::InstanceConstSharedPtr address,
+                                           uint32_t worker_index));
   MOCK_METHOD1(createDrainManager_, DrainManager*(envoy::api::v2::Listener::DrainType drain_type));
   MOCK_METHOD0(nextListenerTag, uint64_t());
 
@@ -250,7 +261,9 @@ public:
   ~MockWorkerFactory();
 
   // Server::WorkerFactory
-  WorkerPtr createWorker(OverloadManager&) override { return WorkerPtr{createWorker_()}; }
+  WorkerPtr createWorker(uint32_t, OverloadManager&) override {
+    return WorkerPtr{createWorker_()};
+  }
 
   MOCK_METHOD0(createWorker_, Worker*());
 };
@@ -16,6 +16,7 @@
 
 #include "common/stats/histogram_impl.h"
 #include "common/stats/isolated_store_impl.h"
+#include "common/stats/symbol_table_impl.h"
 
 #include "gmock/gmock.h"
 
@@ -30,7 +31,7 @@ public:
   // Note: cannot be mocked because it is accessed as a Property in a gmock EXPECT_CALL. This
   // creates a deadlock in gmock and is an unintended use of mock functions.
   std::string name() const override { return name_; };
-  const char* nameCStr() const override { return name_.c_str(); };
+  StatName statName() const override { return StatName(); };
 
   MOCK_METHOD1(add, void(uint64_t amount));
   MOCK_METHOD0(inc, void());
@@ -56,7 +57,7 @@ public:
   // Note: cannot be mocked because it is accessed as a Property in a gmock EXPECT_CALL. This
   // creates a deadlock in gmock and is an unintended use of mock functions.
   std::string name() const override { return name_; };
-  const char* nameCStr() const override { return name_.c_str(); };
+  StatName statName() const override { return StatName(); };
 
   MOCK_METHOD1(add, void(uint64_t amount));
   MOCK_METHOD0(dec, void());
@@ -82,7 +83,7 @@ public:
   // Note: cannot be mocked because it is accessed as a Property in a gmock EXPECT_CALL. This
   // creates a deadlock in gmock and is an unintended use of mock functions.
   std::string name() const override { return name_; };
-  const char* nameCStr() const override { return name_.c_str(); };
+  StatName statName() const override { return StatName(); };
 
   MOCK_CONST_METHOD0(tagExtractedName, const std::string&());
   MOCK_CONST_METHOD0(tags, const std::vector<Tag>&());
@@ -102,7 +103,7 @@ public:
   // Note: cannot be mocked because it is accessed as a Property in a gmock EXPECT_CALL. This
   // creates a deadlock in gmock and is an unintended use of mock functions.
   std::string name() const override { return name_; };
-  const char* nameCStr() const override { return name_.c_str(); };
+  StatName statName() const override { return StatName(); };
   void merge() override {}
   const std::string summary() const override { return ""; };
 
@@ -62,6 +62,7 @@ public:
   // Tcp::ConnectionPool::Instance
   MOCK_METHOD1(addDrainedCallback, void(DrainedCb cb));
   MOCK_METHOD0(drainConnections, void());
+  MOCK_METHOD1(preconnect, void(uint32_t connections));
   MOCK_METHOD1(newConnection, Cancellable*(Tcp::ConnectionPool::Callbacks& callbacks));
 
   MockCancellable* newConnectionImpl(Callbacks& cb);
@@ -58,6 +58,13 @@ MockClusterInfo::MockClusterInfo()
   ON_CALL(*this, lbOriginalDstConfig()).WillByDefault(ReturnRef(lb_original_dst_config_));
   ON_CALL(*this, lbConfig()).WillByDefault(ReturnRef(lb_config_));
   ON_CALL(*this, clusterSocketOptions()).WillByDefault(ReturnRef(cluster_socket_options_));
+  ON_CALL(*this, perUpstreamPreconnectRatio())
+      .WillByDefault(ReturnPointee(&per_upstream_preconnect_ratio_));
+  ON_CALL(*this, warmConnections()).WillByDefault(ReturnPointee(&warm_connections_));
+  ON_CALL(*this, maxParkedConnectionsPerHost())
+      .WillByDefault(ReturnPointee(&max_parked_connections_per_host_));
+  ON_CALL(*this, parkedConnectionIdleTimeout())
+      .WillByDefault(ReturnPointee(&parked_connection_idle_timeout_));
 }
 
 MockClusterInfo::~MockClusterInfo() {}
@@ -79,6 +79,10 @@ public:
   MOCK_CONST_METHOD0(typedMetadata, const Envoy::Config::TypedMetadata&());
   MOCK_CONST_METHOD0(clusterSocketOptions, const Network::ConnectionSocket::OptionsSharedPtr&());
   MOCK_CONST_METHOD0(drainConnectionsOnHostRemoval, bool());
+  MOCK_CONST_METHOD0(perUpstreamPreconnectRatio, float());
+  MOCK_CONST_METHOD0(warmConnections, uint32_t());
+  MOCK_CONST_METHOD0(maxParkedConnectionsPerHost, uint32_t());
+  MOCK_CONST_METHOD0(parkedConnectionIdleTimeout, std::chrono::milliseconds());
 
   std::string name_{"fake_cluster"};
   Http::Http2Settings http2_settings_{};
@@ -100,6 +104,10 @@ public:
   absl::optional<envoy::api::v2::Cluster::OriginalDstLbConfig> lb_original_dst_config_;
   Network::ConnectionSocket::OptionsSharedPtr cluster_socket_options_;
   envoy::api::v2::Cluster::CommonLbConfig lb_config_;
+  float per_upstream_preconnect_ratio_{1.0};
+  uint32_t warm_connections_{};
+  uint32_t max_parked_connections_per_host_{};
+  std::chrono::milliseconds parked_connection_idle_timeout_{60000};
 };
 
 class MockIdleTimeEnabledClusterInfo : public MockClusterInfo {
@@ -7,6 +7,7 @@
 
 #include "server/connection_handler_impl.h"
 
+#include "test/mocks/common.h"
 #include "test/mocks/network/mocks.h"
 #include "test/mocks/server/mocks.h"
 #include "test/test_common/network_utility.h"
@@ -19,6 +20,7 @@ using testing::ByRef;
 using testing::InSequence;
 using testing::Invoke;
 using testing::NiceMock;
+using testing::Ref;
 using testing::Return;
 using testing::ReturnRef;
 
@@ -28,7 +30,7 @@ namespace Server {
 class ConnectionHandlerTest : public testing::Test, protected Logger::Loggable<Logger::Id::main> {
 public:
   ConnectionHandlerTest()
-      : handler_(new ConnectionHandlerImpl(ENVOY_LOGGER(), dispatcher_)),
+      : handler_(new ConnectionHandlerImpl(ENVOY_LOGGER(), dispatcher_, absl::nullopt)),
         filter_chain_(Network::Test::createEmptyFilterChainWithRawBufferSockets()) {}
 
   // Listener
@@ -43,11 +45,14 @@ public:
     Network::FilterChainManager& filterChainManager() override { return parent_.manager_; }
     Network::FilterChainFactory& filterChainFactory() override { return parent_.factory_; }
     Network::Socket& socket() override { return socket_; }
+    Network::Socket& workerSocket(uint32_t) override { return worker_socket_; }
     bool bindToPort() override { return bind_to_port_; }
     bool handOffRestoredDestinationConnections() const override {
       return hand_off_restored_destination_connections_;
     }
     uint32_t perConnectionBufferLimitBytes() override { return 0; }
+    uint32_t maxAcceptsPerWakeup() const override { return 0; }
+    TokenBucket* connectionRateLimiter() override { return rate_limiter_; }
     Stats::Scope& listenerScope() override { return parent_.stats_store_; }
     uint64_t listenerTag() const override { return tag_; }
     const std::string& name() const override { return name_; }
@@ -55,6 +60,8 @@ public:
 
     ConnectionHandlerTest& parent_;
     Network::MockListenSocket socket_;
+    Network::MockListenSocket worker_socket_;
+    TokenBucket* rate_limiter_{};
     uint64_t tag_;
     bool bind_to_port_;
     const bool hand_off_restored_destination_connections_;
@@ -86,12 +93,12 @@ TEST_F(ConnectionHandlerTest, RemoveListener) {
 
   Network::MockListener* listener = new NiceMock<Network::MockListener>();
   Network::ListenerCallbacks* listener_callbacks;
-  EXPECT_CALL(dispatcher_, createListener_(_, _, _, false))
-      .WillOnce(Invoke(
-          [&](Network::Socket&, Network::ListenerCallbacks& cb, bool, bool) -> Network::Listener* {
-            listener_callbacks = &cb;
-            return listener;
-          }));
+  EXPECT_CALL(dispatcher_, createListener_(_, _, _, false, _))
+      .WillOnce(Invoke([&](Network::Socket&, Network::ListenerCallbacks& cb, bool, bool,
+                           uint32_t) -> Network::Listener* {
+        listener_callbacks = &cb;
+        return listener;
+      }));
   TestListener* test_listener = addListener(1, true, false, "test_listener");
   EXPECT_CALL(test_listener->socket_, localAddress());
   handler_->addListener(*test_listener);
@@ -117,17 +124,50 @@ TEST_F(ConnectionHandlerTest, RemoveListener) {
   handler_->removeListeners(0);
 }
 
+// A worker's handler accepts from the worker's own socket, and keeps per-worker stats.
+TEST_F(ConnectionHandlerTest, WorkerSocketAndStats) {
+  InSequence s;
+
+  handler_.reset(new ConnectionHandlerImpl(ENVOY_LOGGER(), dispatcher_, 2));
+  TestListener* test_listener = addListener(1, true, false, "test_listener");
+  Network::MockListener* listener = new NiceMock<Network::MockListener>();
+  Network::ListenerCallbacks* listener_callbacks;
+  EXPECT_CALL(dispatcher_, createListener_(Ref(test_listener->worker_socket_), _, _, false, _))
+      .WillOnce(Invoke([&](Network::Socket&, Network::ListenerCallbacks& cb, bool, bool,
+                           uint32_t) -> Network::Listener* {
+        listener_callbacks = &cb;
+        return listener;
+      }));
+  EXPECT_CALL(test_listener->socket_, localAddress());
+  handler_->addListener(*test_listener);
+
+  Network::MockConnection* connection = new NiceMock<Network::MockConnection>();
+  listener_callbacks->onNewConnection(Network::ConnectionPtr{connection});
+  EXPECT_EQ(1UL, stats_store_.counter("downstream_cx_total").value());
+  EXPECT_EQ(1UL, stats_store_.counter("worker_2.downstream_cx_total").value());
+  EXPECT_EQ(1UL, stats_store_.gauge("worker_2.downstream_cx_active").value());
+
+  connection->raiseEvent(Network::ConnectionEvent::RemoteClose);
+  dispatcher_.to_delete_.clear();
+  EXPECT_EQ(0UL, stats_store_.gauge("worker_2.downstream_cx_active").value());
+  EXPECT_EQ(0UL, handler_->numConnections());
+
+  EXPECT_CALL(dispatcher_, clearDeferredDeleteList());
+  EXPECT_CALL(*listener, onDestroy());
+  handler_.reset();
+}
+
 TEST_F(ConnectionHandlerTest, DisableListener) {
   InSequence s;
 
   Network::MockListener* listener = new NiceMock<Network::MockListener>();
   Network::ListenerCallbacks* listener_callbacks;
-  EXPECT_CALL(dispatcher_, createListener_(_, _, _, _))
-      .WillOnce(Invoke(
-          [&](Network::Socket&, Network::ListenerCallbacks& cb, bool, bool) -> Network::Listener* {
-            listener_callbacks = &cb;
-            return listener;
-          }));
+  EXPECT_CALL(dispatcher_, createListener_(_, _, _, _, _))
+      .WillOnce(Invoke([&](Network::Socket&, Network::ListenerCallbacks& cb, bool, bool,
+                           uint32_t) -> Network::Listener* {
+        listener_callbacks = &cb;
+        return listener;
+      }));
   TestListener* test_listener = addListener(1, false, false, "test_listener");
   EXPECT_CALL(test_listener->socket_, localAddress());
   handler_->addListener(*test_listener);
@@ -143,12 +183,12 @@ TEST_F(ConnectionHandlerTest, AddDisabledListener) {
 
   Network::MockListener* listener = new NiceMock<Network::MockListener>();
   Network::ListenerCallbacks* listener_callbacks;
-  EXPECT_CALL(dispatcher_, createListener_(_, _, _, _))
-      .WillOnce(Invoke(
-          [&](Network::Socket&, Network::ListenerCallbacks& cb, bool, bool) -> Network::Listener* {
-            listener_callbacks = &cb;
-            return listener;
-          }));
+  EXPECT_CALL(dispatcher_, createListener_(_, _, _, _, _))
+      .WillOnce(Invoke([&](Network::Socket&, Network::ListenerCallbacks& cb, bool, bool,
+                           uint32_t) -> Network::Listener* {
+        listener_callbacks = &cb;
+        return listener;
+      }));
   TestListener* test_listener = addListener(1, false, false, "test_listener");
 
   EXPECT_CALL(*listener, disable());
@@ -164,12 +204,12 @@ TEST_F(ConnectionHandlerTest, DestroyCloseConnections) {
 
   Network::MockListener* listener = new NiceMock<Network::MockListener>();
   Network::ListenerCallbacks* listener_callbacks;
-  EXPECT_CALL(dispatcher_, createListener_(_, _, _, _))
-      .WillOnce(Invoke(
-          [&](Network::Socket&, Network::ListenerCallbacks& cb, bool, bool) -> Network::Listener* {
-            listener_callbacks = &cb;
-            return listener;
-          }));
+  EXPECT_CALL(dispatcher_, createListener_(_, _, _, _, _))
+      .WillOnce(Invoke([&](Network::Socket&, Network::ListenerCallbacks& cb, bool, bool,
+                           uint32_t) -> Network::Listener* {
+        listener_callbacks = &cb;
+        return listener;
+      }));
   TestListener* test_listener = addListener(1, true, false, "test_listener");
   EXPECT_CALL(test_listener->socket_, localAddress());
   handler_->addListener(*test_listener);
@@ -189,12 +229,12 @@ TEST_F(ConnectionHandlerTest, CloseDuringFilterChainCreate) {
 
   Network::MockListener* listener = new Network::MockListener();
   Network::ListenerCallbacks* listener_callbacks;
-  EXPECT_CALL(dispatcher_, createListener_(_, _, _, _))
-      .WillOnce(Invoke(
-          [&](Network::Socket&, Network::ListenerCallbacks& cb, bool, bool) -> Network::Listener* {
-            listener_callbacks = &cb;
-            return listener;
-          }));
+  EXPECT_CALL(dispatcher_, createListener_(_, _, _, _, _))
+      .WillOnce(Invoke([&](Network::Socket&, Network::ListenerCallbacks& cb, bool, bool,
+                           uint32_t) -> Network::Listener* {
+        listener_callbacks = &cb;
+        return listener;
+      }));
   TestListener* test_listener = addListener(1, true, false, "test_listener");
   EXPECT_CALL(test_listener->socket_, localAddress());
   handler_->addListener(*test_listener);
@@ -217,12 +257,12 @@ TEST_F(ConnectionHandlerTest, CloseConnectionOnEmptyFilterChain) {
 
   Network::MockListener* listener = new Network::MockListener();
   Network::ListenerCallbacks* listener_callbacks;
-  EXPECT_CALL(dispatcher_, createListener_(_, _, _, _))
-      .WillOnce(Invoke(
-          [&](Network::Socket&, Network::ListenerCallbacks& cb, bool, bool) -> Network::Listener* {
-            listener_callbacks = &cb;
-            return listener;
-          }));
+  EXPECT_CALL(dispatcher_, createListener_(_, _, _, _, _))
+      .WillOnce(Invoke([&](Network::Socket&, Network::ListenerCallbacks& cb, bool, bool,
+                           uint32_t) -> Network::Listener* {
+        listener_callbacks = &cb;
+        return listener;
+      }));
   TestListener* test_listener = addListener(1, true, false, "test_listener");
   EXPECT_CALL(test_listener->socket_, localAddress());
   handler_->addListener(*test_listener);
@@ -240,13 +280,55 @@ TEST_F(ConnectionHandlerTest, CloseConnectionOnEmptyFilterChain) {
   EXPECT_CALL(*listener, onDestroy());
 }
 
+TEST_F(ConnectionHandlerTest, ConnectionRateLimited) {
+  InSequence s;
+
+  Network::MockListener* listener = new Network::MockListener();
+  Network::ListenerCallbacks* listener_callbacks;
+  EXPECT_CALL(dispatcher_, createListener_(_, _, _, _, _))
+      .WillOnce(Invoke([&](Network::Socket&, Network::ListenerCallbacks& cb, bool, bool,
+                           uint32_t) -> Network::Listener* {
+        listener_callbacks = &cb;
+        return listener;
+      }));
+  TestListener* test_listener = addListener(1, true, false, "test_listener");
+  MockTokenBucket rate_limiter;
+  test_listener->rate_limiter_ = &rate_limiter;
+  EXPECT_CALL(test_listener->socket_, localAddress());
+  handler_->addListener(*test_listener);
+
+  EXPECT_CALL(rate_limiter, consume(1)).WillOnce(Return(false));
+  EXPECT_CALL(factory_, createListenerFilterChain(_)).Times(0);
+  Network::MockConnectionSocket* accepted_socket = new NiceMock<Network::MockConnectionSocket>();
+  EXPECT_CALL(*accepted_socket, close());
+  listener_callbacks->onAccept(Network::ConnectionSocketPtr{accepted_socket}, true);
+  EXPECT_EQ(1UL, stats_store_.counter("downstream_cx_rate_limited").value());
+  EXPECT_EQ(0UL, handler_->numConnections());
+
+  EXPECT_CALL(rate_limiter, consume(1)).WillOnce(Return(true));
+  EXPECT_CALL(factory_, createListenerFilterChain(_)).WillOnce(Return(true));
+  EXPECT_CALL(manager_, findFilterChain(_)).WillOnce(Return(filter_chain_.get()));
+  Network::MockConnection* connection = new NiceMock<Network::MockConnection>();
+  EXPECT_CALL(dispatcher_, createServerConnection_(_, _)).WillOnce(Return(connection));
+  EXPECT_CALL(factory_, createNetworkFilterChain(_, _)).WillOnce(Return(true));
+  listener_callbacks->onAccept(
+      Network::ConnectionSocketPtr{new NiceMock<Network::MockConnectionSocket>()}, true);
+  EXPECT_EQ(1UL, stats_store_.counter("downstream_cx_rate_limited").value());
+  EXPECT_EQ(1UL, handler_->numConnections());
+
+  EXPECT_CALL(*connection, close(Network::ConnectionCloseType::NoFlush));
+  EXPECT_CALL(dispatcher_, clearDeferredDeleteList());
+  EXPECT_CALL(*listener, onDestroy());
+  handler_.reset();
+}
+
 TEST_F(ConnectionHandlerTest, FindListenerByAddress) {
   TestListener* test_listener1 = addListener(1, true, true, "test_listener1");
   Network::Address::InstanceConstSharedPtr alt_address(
       new Network::Address::Ipv4Instance("127.0.0.1", 10001));
 
   Network::MockListener* listener = new Network::MockListener();
-  EXPECT_CALL(dispatcher_, createListener_(_, _, _, true))
+  EXPECT_CALL(dispatcher_, createListener_(_, _, _, true, _))
       .WillOnce(Invoke([&](Network::Socket&, Network::ListenerCallbacks&, bool,
                            bool) -> Network::Listener* { return listener; }));
   EXPECT_CALL(test_listener1->socket_, localAddress()).WillRepeatedly(ReturnRef(alt_address));
@@ -261,7 +343,7 @@ TEST_F(ConnectionHandlerTest, FindListenerByAddress) {
       new Network::Address::Ipv4Instance("127.0.0.2", 10001));
 
   Network::MockListener* listener2 = new Network::MockListener();
-  EXPECT_CALL(dispatcher_, createListener_(_, _, _, false))
+  EXPECT_CALL(dispatcher_, createListener_(_, _, _, false, _))
       .WillOnce(Invoke([&](Network::Socket&, Network::ListenerCallbacks&, bool,
                            bool) -> Network::Listener* { return listener2; }));
   EXPECT_CALL(test_listener2->socket_, localAddress()).WillRepeatedly(ReturnRef(alt_address2));
@@ -279,7 +361,7 @@ TEST_F(ConnectionHandlerTest, FindListenerByAddress) {
   handler_->stopListeners(2);
 
   Network::MockListener* listener3 = new Network::MockListener();
-  EXPECT_CALL(dispatcher_, createListener_(_, _, _, _))
+  EXPECT_CALL(dispatcher_, createListener_(_, _, _, _, _))
       .WillOnce(Invoke([&](Network::Socket&, Network::ListenerCallbacks&, bool,
                            bool) -> Network::Listener* { return listener3; }));
   handler_->addListener(*test_listener2);
@@ -294,12 +376,12 @@ TEST_F(ConnectionHandlerTest, NormalRedirect) {
   TestListener* test_listener1 = addListener(1, true, true, "test_listener1");
   Network::MockListener* listener1 = new Network::MockListener();
   Network::ListenerCallbacks* listener_callbacks1;
-  EXPECT_CALL(dispatcher_, createListener_(_, _, _, true))
-      .WillOnce(Invoke(
-          [&](Network::Socket&, Network::ListenerCallbacks& cb, bool, bool) -> Network::Listener* {
-            listener_callbacks1 = &cb;
-            return listener1;
-          }));
+  EXPECT_CALL(dispatcher_, createListener_(_, _, _, true, _))
+      .WillOnce(Invoke([&](Network::Socket&, Network::ListenerCallbacks& cb, bool, bool,
+                           uint32_t) -> Network::Listener* {
+        listener_callbacks1 = &cb;
+        return listener1;
+      }));
   Network::Address::InstanceConstSharedPtr normal_address(
       new Network::Address::Ipv4Instance("127.0.0.1", 10001));
   EXPECT_CALL(test_listener1->socket_, localAddress()).WillRepeatedly(ReturnRef(normal_address));
@@ -308,12 +390,12 @@ TEST_F(ConnectionHandlerTest, NormalRedirect) {
   TestListener* test_listener2 = addListener(1, false, false, "test_listener2");
   Network::MockListener* listener2 = new Network::MockListener();
   Network::ListenerCallbacks* listener_callbacks2;
-  EXPECT_CALL(dispatcher_, createListener_(_, _, _, false))
-      .WillOnce(Invoke(
-          [&](Network::Socket&, Network::ListenerCallbacks& cb, bool, bool) -> Network::Listener* {
-            listener_callbacks2 = &cb;
-            return listener2;
-          }));
+  EXPECT_CALL(dispatcher_, createListener_(_, _, _, false, _))
+      .WillOnce(Invoke([&](Network::Socket&, Network::ListenerCallbacks& cb, bool, bool,
+                           uint32_t) -> Network::Listener* {
+        listener_callbacks2 = &cb;
+        return listener2;
+      }));
   Network::Address::InstanceConstSharedPtr alt_address(
       new Network::Address::Ipv4Instance("127.0.0.2", 20002));
   EXPECT_CALL(test_listener2->socket_, localAddress()).WillRepeatedly(ReturnRef(alt_address));
@@ -354,12 +436,12 @@ TEST_F(ConnectionHandlerTest, FallbackToWildcardListener) {
   TestListener* test_listener1 = addListener(1, true, true, "test_listener1");
   Network::MockListener* listener1 = new Network::MockListener();
   Network::ListenerCallbacks* listener_callbacks1;
-  EXPECT_CALL(dispatcher_, createListener_(_, _, _, true))
-      .WillOnce(Invoke(
-          [&](Network::Socket&, Network::ListenerCallbacks& cb, bool, bool) -> Network::Listener* {
-            listener_callbacks1 = &cb;
-            return listener1;
-          }));
+  EXPECT_CALL(dispatcher_, createListener_(_, _, _, true, _))
+      .WillOnce(Invoke([&](Network::Socket&, Network::ListenerCallbacks& cb, bool, bool,
+                           uint32_t) -> Network::Listener* {
+        listener_callbacks1 = &cb;
+        return listener1;
+      }));
   Network::Address::InstanceConstSharedPtr normal_address(
       new Network::Address::Ipv4Instance("127.0.0.1", 10001));
   EXPECT_CALL(test_listener1->socket_, localAddress()).WillRepeatedly(ReturnRef(normal_address));
@@ -368,12 +450,12 @@ TEST_F(ConnectionHandlerTest, FallbackToWildcardListener) {
   TestListener* test_listener2 = addListener(1, false, false, "test_listener2");
   Network::MockListener* listener2 = new Network::MockListener();
   Network::ListenerCallbacks* listener_callbacks2;
-  EXPECT_CALL(dispatcher_, createListener_(_, _, _, false))
-      .WillOnce(Invoke(
-          [&](Network::Socket&, Network::ListenerCallbacks& cb, bool, bool) -> Network::Listener* {
-            listener_callbacks2 = &cb;
-            return listener2;
-          }));
+  EXPECT_CALL(dispatcher_, createListener_(_, _, _, false, _))
+      .WillOnce(Invoke([&](Network::Socket&, Network::ListenerCallbacks& cb, bool, bool,
+                           uint32_t) -> Network::Listener* {
+        listener_callbacks2 = &cb;
+        return listener2;
+      }));
   Network::Address::InstanceConstSharedPtr any_address = Network::Utility::getIpv4AnyAddress();
   EXPECT_CALL(test_listener2->socket_, localAddress()).WillRepeatedly(ReturnRef(any_address));
   handler_->addListener(*test_listener2);
@@ -416,12 +498,12 @@ TEST_F(ConnectionHandlerTest, WildcardListenerWithOriginalDst) {
   TestListener* test_listener1 = addListener(1, true, true, "test_listener1");
   Network::MockListener* listener1 = new Network::MockListener();
   Network::ListenerCallbacks* listener_callbacks1;
-  EXPECT_CALL(dispatcher_, createListener_(_, _, _, true))
-      .WillOnce(Invoke(
-          [&](Network::Socket&, Network::ListenerCallbacks& cb, bool, bool) -> Network::Listener* {
-            listener_callbacks1 = &cb;
-            return listener1;
-          }));
+  EXPECT_CALL(dispatcher_, createListener_(_, _, _, true, _))
+      .WillOnce(Invoke([&](Network::Socket&, Network::ListenerCallbacks& cb, bool, bool,
+                           uint32_t) -> Network::Listener* {
+        listener_callbacks1 = &cb;
+        return listener1;
+      }));
   Network::Address::InstanceConstSharedPtr normal_address(
       new Network::Address::Ipv4Instance("127.0.0.1", 80));
   // Original dst address nor port number match that of the listener's address.
@@ -462,12 +544,12 @@ TEST_F(ConnectionHandlerTest, WildcardListenerWithNoOriginalDst) {
   TestListener* test_listener1 = addListener(1, true, true, "test_listener1");
   Network::MockListener* listener1 = new Network::MockListener();
   Network::ListenerCallbacks* listener_callbacks1;
-  EXPECT_CALL(dispatcher_, createListener_(_, _, _, true))
-      .WillOnce(Invoke(
-          [&](Network::Socket&, Network::ListenerCallbacks& cb, bool, bool) -> Network::Listener* {
-            listener_callbacks1 = &cb;
-            return listener1;
-          }));
+  EXPECT_CALL(dispatcher_, createListener_(_, _, _, true, _))
+      .WillOnce(Invoke([&](Network::Socket&, Network::ListenerCallbacks& cb, bool, bool,
+                           uint32_t) -> Network::Listener* {
+        listener_callbacks1 = &cb;
+        return listener1;
+      }));
   Network::Address::InstanceConstSharedPtr normal_address(
       new Network::Address::Ipv4Instance("127.0.0.1", 80));
   Network::Address::InstanceConstSharedPtr any_address = Network::Utility::getAddressWithPort(
@@ -500,12 +582,12 @@ TEST_F(ConnectionHandlerTest, TransportProtocolDefault) {
   TestListener* test_listener = addListener(1, true, false, "test_listener");
   Network::MockListener* listener = new Network::MockListener();
   Network::ListenerCallbacks* listener_callbacks;
-  EXPECT_CALL(dispatcher_, createListener_(_, _, _, false))
-      .WillOnce(Invoke(
-          [&](Network::Socket&, Network::ListenerCallbacks& cb, bool, bool) -> Network::Listener* {
-            listener_callbacks = &cb;
-            return listener;
-          }));
+  EXPECT_CALL(dispatcher_, createListener_(_, _, _, false, _))
+      .WillOnce(Invoke([&](Network::Socket&, Network::ListenerCallbacks& cb, bool, bool,
+                           uint32_t) -> Network::Listener* {
+        listener_callbacks = &cb;
+        return listener;
+      }));
   EXPECT_CALL(test_listener->socket_, localAddress());
   handler_->addListener(*test_listener);
 
@@ -523,12 +605,12 @@ TEST_F(ConnectionHandlerTest, TransportProtocolCustom) {
   TestListener* test_listener = addListener(1, true, false, "test_listener");
   Network::MockListener* listener = new Network::MockListener();
   Network::ListenerCallbacks* listener_callbacks;
-  EXPECT_CALL(dispatcher_, createListener_(_, _, _, false))
-      .WillOnce(Invoke(
-          [&](Network::Socket&, Network::ListenerCallbacks& cb, bool, bool) -> Network::Listener* {
-            listener_callbacks = &cb;
-            return listener;
-          }));
+  EXPECT_CALL(dispatcher_, createListener_(_, _, _, false, _))
+      .WillOnce(Invoke([&](Network::Socket&, Network::ListenerCallbacks& cb, bool, bool,
+                           uint32_t) -> Network::Listener* {
+        listener_callbacks = &cb;
+        return listener;
+      }));
   EXPECT_CALL(test_listener->socket_, localAddress());
   handler_->addListener(*test_listener);
 
@@ -1,6 +1,5 @@
 #include <algorithm>
 #include <fstream>
-#include <regex>
 #include <unordered_map>
 
 #include "envoy/admin/v2alpha/memory.pb.h"
@@ -9,6 +8,7 @@
 #include "envoy/runtime/runtime.h"
 #include "envoy/stats/stats.h"
 
+#include "common/common/regex.h"
 #include "common/http/message_impl.h"
 #include "common/json/json_loader.h"
 #include "common/profiler/profiler.h"
@@ -57,7 +57,7 @@ public:
   static std::string
   statsAsJsonHandler(std::map<std::string, uint64_t>& all_stats,
                      const std::vector<Stats::ParentHistogramSharedPtr>& all_histograms,
-                     const bool used_only, const absl::optional<std::regex> regex = absl::nullopt) {
+                     const bool used_only, const Regex::CompiledMatcher* regex = nullptr) {
     return AdminImpl::statsAsJson(all_stats, all_histograms, used_only, regex,
                                   true /*pretty_print*/);
   }
@@ -366,8 +366,9 @@ TEST_P(AdminStatsTest, StatsAsJsonFilterString) {
 
   std::map<std::string, uint64_t> all_stats;
 
-  std::string actual_json = statsAsJsonHandler(all_stats, store_->histograms(), false,
-                                               absl::optional<std::regex>{std::regex("[a-z]1")});
+  Regex::CompiledMatcherPtr regex = Regex::Utility::parseRegex("[a-z]1");
+  std::string actual_json =
+      statsAsJsonHandler(all_stats, store_->histograms(), false, regex.get());
 
   // Because this is a filter case, we don't expect to see any stats except for those containing
   // "h1" in their name.
@@ -475,8 +476,8 @@ TEST_P(AdminStatsTest, UsedOnlyStatsAsJsonFilterString) {
 
   std::map<std::string, uint64_t> all_stats;
 
-  std::string actual_json = statsAsJsonHandler(all_stats, store_->histograms(), true,
-                                               absl::optional<std::regex>{std::regex("h[12]")});
+  Regex::CompiledMatcherPtr regex = Regex::Utility::parseRegex("h[12]");
+  std::string actual_json = statsAsJsonHandler(all_stats, store_->histograms(), true, regex.get());
 
   // Expected JSON should not have h2 values as it is not used, and should not have h3 values as
   // they are used but do not match.
@@ -965,6 +966,28 @@ TEST_P(AdminInstanceTest, RuntimeModifyNoArguments) {
   EXPECT_TRUE(absl::StartsWith(response.toString(), "usage:"));
 }
 
+// The dispatcher stats are grouped by the thread whose event loop they are about.
+TEST_P(AdminInstanceTest, Workers) {
+  server_.stats().counter("server.dispatcher.post_time_us").add(3);
+  server_.stats().counter("server.worker_0.dispatcher.file_event_time_us").add(10);
+  server_.stats().counter("server.worker_0.dispatcher.timer_time_us").add(2);
+  server_.stats().counter("server.worker_1.dispatcher.file_event_time_us").add(20);
+  server_.stats().counter("server.worker_0.buffer.slices_allocated").inc();
+  server_.stats().counter("cluster.dispatcher.file_event_time_us").inc();
+
+  Http::HeaderMapImpl header_map;
+  Buffer::OwnedImpl response;
+  EXPECT_EQ(Http::Code::OK, getCallback("/workers", header_map, response));
+  EXPECT_EQ("main_thread:\n"
+            "  post_time_us: 3\n"
+            "worker_0:\n"
+            "  file_event_time_us: 10\n"
+            "  timer_time_us: 2\n"
+            "worker_1:\n"
+            "  file_event_time_us: 20\n",
+            response.toString());
+}
+
 TEST_P(AdminInstanceTest, TracingStatsDisabled) {
   const std::string& name = admin_.tracingStats().service_forced_.name();
   for (Stats::CounterSharedPtr counter : server_.stats().counters()) {
@@ -1124,6 +1147,14 @@ TEST_P(AdminInstanceTest, GetRequestJson) {
               HasSubstr("application/json"));
 }
 
+TEST_P(AdminInstanceTest, GetRequestInvalidFilter) {
+  Http::HeaderMapImpl response_headers;
+  std::string body;
+  EXPECT_EQ(Http::Code::BadRequest,
+            admin_.request("/stats?filter=(server", "GET", response_headers, body));
+  EXPECT_THAT(body, HasSubstr("Invalid regex '(server'"));
+}
+
 TEST_P(AdminInstanceTest, PostRequest) {
   Http::HeaderMapImpl response_headers;
   std::string body;
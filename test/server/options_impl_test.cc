@@ -74,7 +74,8 @@ TEST_F(OptionsImplTest, All) {
       "--service-cluster cluster --service-node node --service-zone zone "
       "--file-flush-interval-msec 9000 "
       "--drain-time-s 60 --log-format [%v] --parent-shutdown-time-s 90 --log-path /foo/bar "
-      "--v2-config-only --disable-hot-restart");
+      "--v2-config-only --disable-hot-restart --use-libevent-buffers --use-list-header-maps "
+      "--use-simd-http1-parser --use-io-uring");
   EXPECT_EQ(Server::Mode::Validate, options->mode());
   EXPECT_EQ(2U, options->concurrency());
   EXPECT_EQ("hello", options->configPath());
@@ -93,6 +94,10 @@ TEST_F(OptionsImplTest, All) {
   EXPECT_EQ(std::chrono::seconds(60), options->drainTime());
   EXPECT_EQ(std::chrono::seconds(90), options->parentShutdownTime());
   EXPECT_EQ(true, options->hotRestartDisabled());
+  EXPECT_EQ(true, options->libeventBuffersEnabled());
+  EXPECT_EQ(true, options->listHeaderMapsEnabled());
+  EXPECT_EQ(true, options->simdHttp1ParserEnabled());
+  EXPECT_EQ(true, options->ioUringEnabled());
 
   options = createOptionsImpl("envoy --mode init_only");
   EXPECT_EQ(Server::Mode::InitOnly, options->mode());
@@ -102,6 +107,10 @@ TEST_F(OptionsImplTest, SetAll) {
   std::unique_ptr<OptionsImpl> options = createOptionsImpl("envoy -c hello");
   bool hot_restart_disabled = options->hotRestartDisabled();
   bool signal_handling_enabled = options->signalHandlingEnabled();
+  bool libevent_buffers_enabled = options->libeventBuffersEnabled();
+  bool list_header_maps_enabled = options->listHeaderMapsEnabled();
+  bool simd_http1_parser_enabled = options->simdHttp1ParserEnabled();
+  bool io_uring_enabled = options->ioUringEnabled();
   Stats::StatsOptionsImpl stats_options;
   stats_options.max_obj_name_length_ = 54321;
   stats_options.max_stat_suffix_length_ = 1234;
@@ -127,6 +136,10 @@ TEST_F(OptionsImplTest, SetAll) {
   options->setStatsOptions(stats_options);
   options->setHotRestartDisabled(!options->hotRestartDisabled());
   options->setSignalHandling(!options->signalHandlingEnabled());
+  options->setLibeventBuffersEnabled(!options->libeventBuffersEnabled());
+  options->setListHeaderMapsEnabled(!options->listHeaderMapsEnabled());
+  options->setSimdHttp1ParserEnabled(!options->simdHttp1ParserEnabled());
+  options->setIoUringEnabled(!options->ioUringEnabled());
 
   EXPECT_EQ(109876, options->baseId());
   EXPECT_EQ(42U, options->concurrency());
@@ -150,6 +163,10 @@ TEST_F(OptionsImplTest, SetAll) {
   EXPECT_EQ(stats_options.max_stat_suffix_length_, options->statsOptions().maxStatSuffixLength());
   EXPECT_EQ(!hot_restart_disabled, options->hotRestartDisabled());
   EXPECT_EQ(!signal_handling_enabled, options->signalHandlingEnabled());
+  EXPECT_EQ(!libevent_buffers_enabled, options->libeventBuffersEnabled());
+  EXPECT_EQ(!list_header_maps_enabled, options->listHeaderMapsEnabled());
+  EXPECT_EQ(!simd_http1_parser_enabled, options->simdHttp1ParserEnabled());
+  EXPECT_EQ(!io_uring_enabled, options->ioUringEnabled());
 }
 
 TEST_F(OptionsImplTest, DefaultParams) {
@@ -160,6 +177,10 @@ TEST_F(OptionsImplTest, DefaultParams) {
   EXPECT_EQ(Network::Address::IpVersion::v4, options->localAddressIpVersion());
   EXPECT_EQ(Server::Mode::Serve, options->mode());
   EXPECT_EQ(false, options->hotRestartDisabled());
+  EXPECT_EQ(false, options->libeventBuffersEnabled());
+  EXPECT_EQ(false, options->listHeaderMapsEnabled());
+  EXPECT_EQ(false, options->simdHttp1ParserEnabled());
+  EXPECT_EQ(false, options->ioUringEnabled());
 }
 
 TEST_F(OptionsImplTest, BadCliOption) {
@@ -1,4 +1,5 @@
 #include "common/event/dispatcher_impl.h"
+#include "common/stats/isolated_store_impl.h"
 
 #include "server/worker_impl.h"
 
@@ -36,8 +37,9 @@ public:
   NiceMock<MockGuardDog> guard_dog_;
   NiceMock<MockOverloadManager> overload_manager_;
   DefaultTestHooks hooks_;
+  Stats::IsolatedStoreImpl stats_store_;
   WorkerImpl worker_{tls_, hooks_, Event::DispatcherPtr{dispatcher_},
-                     Network::ConnectionHandlerPtr{handler_}, overload_manager_};
+                     Network::ConnectionHandlerPtr{handler_}, overload_manager_, stats_store_, 0};
   Event::TimerPtr no_exit_timer_ = dispatcher_->createTimer([]() -> void {});
 };
 
@@ -340,6 +340,20 @@ private:
   int fd_;
 };
 
+/**
+ * Sets the largest regex program size accepted by Regex::Utility::parseRegex() for the lifetime
+ * of the object, and restores the previous limit when destroyed, so that a failing test doesn't
+ * leak its limit into other tests.
+ */
+class ScopedMaxRegexProgramSize {
+public:
+  ScopedMaxRegexProgramSize(uint32_t max_program_size);
+  ~ScopedMaxRegexProgramSize();
+
+private:
+  const uint32_t previous_max_program_size_;
+};
+
 /**
  * A utility class for atomically updating a file using symbolic link swap.
  */